@@ -15,6 +15,7 @@
 # pragma once
 #endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
 
+#include "asio/aligned_buffer_pool.hpp"
 #include "asio/append.hpp"
 #include "asio/as_tuple.hpp"
 #include "asio/associated_allocator.hpp"
@@ -26,6 +27,7 @@
 //#include "asio/basic_datagram_socket.hpp"
 //#include "asio/basic_deadline_timer.hpp"
 #include "asio/basic_io_object.hpp"
+#include "asio/basic_mapped_file.hpp"
 //#include "asio/basic_raw_socket.hpp"
 //#include "asio/basic_seq_packet_socket.hpp"
 //#include "asio/basic_serial_port.hpp"
@@ -53,6 +55,7 @@
 #include "asio/completion_condition.hpp"
 #include "asio/compose.hpp"
 //#include "asio/connect.hpp"
+//#include "asio/copy_file.hpp"
 #include "asio/coroutine.hpp"
 #include "asio/deadline_timer.hpp"
 #include "asio/defer.hpp"
@@ -140,8 +143,10 @@
 //#include "asio/local/connect_pair.hpp"
 //#include "asio/local/datagram_protocol.hpp"
 //#include "asio/local/stream_protocol.hpp"
+#include "asio/mapped_file.hpp"
 #include "asio/multiple_exceptions.hpp"
 #include "asio/packaged_task.hpp"
+#include "asio/pattern_matcher.hpp"
 #include "asio/placeholders.hpp"
 //#include "asio/posix/basic_descriptor.hpp"
 //#include "asio/posix/basic_stream_descriptor.hpp"
@@ -162,8 +167,10 @@
 //#include "asio/registered_buffer.hpp"
 #include "asio/require.hpp"
 #include "asio/require_concept.hpp"
+#include "asio/ring_buffer.hpp"
 //#include "asio/serial_port.hpp"
 //#include "asio/serial_port_base.hpp"
+#include "asio/shared_buffer.hpp"
 //#include "asio/signal_set.hpp"
 //#include "asio/socket_base.hpp"
 //#include "asio/static_thread_pool.hpp"
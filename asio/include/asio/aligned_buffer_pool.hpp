@@ -0,0 +1,280 @@
+//
+// aligned_buffer_pool.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_ALIGNED_BUFFER_POOL_HPP
+#define ASIO_ALIGNED_BUFFER_POOL_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+#include <cstddef>
+#include <vector>
+#include "asio/buffer.hpp"
+#include "asio/buffer_registration.hpp"
+#include "asio/detail/cstdint.hpp"
+#include "asio/detail/memory.hpp"
+#include "asio/detail/mutex.hpp"
+#include "asio/detail/noncopyable.hpp"
+#include "asio/detail/throw_error.hpp"
+#include "asio/detail/type_traits.hpp"
+#include "asio/error.hpp"
+#include "asio/execution/executor.hpp"
+#include "asio/execution_context.hpp"
+#include "asio/is_executor.hpp"
+#include "asio/registered_buffer.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace ASIO_LIBNS {
+
+/// A pool of equally sized, aligned buffers that are registered with an
+/// execution context.
+/**
+ * The aligned_buffer_pool class owns a single block of memory that is divided
+ * into a fixed number of buffers. Each buffer starts on, and has a size that
+ * is a multiple of, the requested alignment, and so may be used for direct
+ * I/O on files opened with file_base::direct_io.
+ *
+ * The buffers are registered with the execution context for the lifetime of
+ * the pool. When io_uring is used, reads and writes on an acquired buffer are
+ * submitted as fixed-buffer operations. Since only one buffer registration is
+ * permitted per execution context, the pool occupies that registration.
+ *
+ * @par Thread Safety
+ * @e Distinct @e objects: Safe.@n
+ * @e Shared @e objects: Safe.
+ */
+class aligned_buffer_pool
+  : private detail::noncopyable
+{
+public:
+  /// Create a pool registered with an executor's execution context.
+  /**
+   * @param ex The executor whose execution context the buffers are
+   * registered with.
+   *
+   * @param buffer_size The size of each buffer, in bytes. It is rounded up to
+   * a multiple of @c alignment.
+   *
+   * @param buffer_count The number of buffers in the pool.
+   *
+   * @param alignment The alignment of each buffer. Must be a power of two.
+   * Typically the value returned by a file's @c alignment() function.
+   *
+   * @throws ASIO_LIBNS::system_error Thrown with
+   * ASIO_LIBNS::error::invalid_argument if @c alignment is not a power of two.
+   */
+  template <typename Executor>
+  aligned_buffer_pool(const Executor& ex, std::size_t buffer_size,
+      std::size_t buffer_count, std::size_t alignment = 4096,
+      typename constraint<
+        is_executor<Executor>::value || execution::is_executor<Executor>::value
+      >::type = 0)
+    : alignment_(checked_alignment(alignment)),
+      buffer_size_(round_up(buffer_size, alignment_)),
+      storage_(buffer_size_ * buffer_count, alignment_),
+      registration_(ex, make_buffers(buffer_count))
+  {
+    init_free_list();
+  }
+
+  /// Create a pool registered with an execution context.
+  /**
+   * @param ctx The execution context that the buffers are registered with.
+   *
+   * @param buffer_size The size of each buffer, in bytes. It is rounded up to
+   * a multiple of @c alignment.
+   *
+   * @param buffer_count The number of buffers in the pool.
+   *
+   * @param alignment The alignment of each buffer. Must be a power of two.
+   * Typically the value returned by a file's @c alignment() function.
+   *
+   * @throws ASIO_LIBNS::system_error Thrown with
+   * ASIO_LIBNS::error::invalid_argument if @c alignment is not a power of two.
+   */
+  template <typename ExecutionContext>
+  aligned_buffer_pool(ExecutionContext& ctx, std::size_t buffer_size,
+      std::size_t buffer_count, std::size_t alignment = 4096,
+      typename constraint<
+        is_convertible<ExecutionContext&, execution_context&>::value
+      >::type = 0)
+    : alignment_(checked_alignment(alignment)),
+      buffer_size_(round_up(buffer_size, alignment_)),
+      storage_(buffer_size_ * buffer_count, alignment_),
+      registration_(ctx, make_buffers(buffer_count))
+  {
+    init_free_list();
+  }
+
+  /// Get the alignment of the buffers.
+  std::size_t alignment() const ASIO_NOEXCEPT
+  {
+    return alignment_;
+  }
+
+  /// Get the size of each buffer.
+  std::size_t buffer_size() const ASIO_NOEXCEPT
+  {
+    return buffer_size_;
+  }
+
+  /// Get the total number of buffers in the pool.
+  std::size_t size() const ASIO_NOEXCEPT
+  {
+    return registration_.size();
+  }
+
+  /// Get the number of buffers that are not in use.
+  std::size_t available() const
+  {
+    detail::mutex::scoped_lock lock(mutex_);
+    return free_list_.size();
+  }
+
+  /// Take a buffer from the pool.
+  /**
+   * @returns A registered buffer of size @c buffer_size(), or an invalid,
+   * empty buffer if every buffer in the pool is in use.
+   */
+  mutable_registered_buffer acquire()
+  {
+    detail::mutex::scoped_lock lock(mutex_);
+    if (free_list_.empty())
+      return mutable_registered_buffer();
+    std::size_t index = free_list_.back();
+    free_list_.pop_back();
+    in_use_[index] = true;
+    return registration_.at(index);
+  }
+
+  /// Return a buffer to the pool.
+  /**
+   * @param b A buffer previously returned by @c acquire(). The buffer may have
+   * been shrunk or advanced since it was acquired. Buffers that do not belong
+   * to the pool, and buffers that have already been returned, are ignored.
+   */
+  void release(const mutable_registered_buffer& b)
+  {
+    int index = b.id().native_handle();
+    if (index < 0 || static_cast<std::size_t>(index) >= size()
+        || b.id() != registration_.at(index).id())
+      return;
+
+    detail::mutex::scoped_lock lock(mutex_);
+    if (!in_use_[index])
+      return;
+    in_use_[index] = false;
+    free_list_.push_back(static_cast<std::size_t>(index));
+  }
+
+private:
+  // Uninitialised memory from which the buffers are taken.
+  class storage
+    : private detail::noncopyable
+  {
+  public:
+    storage(std::size_t size, std::size_t alignment)
+      : data_(ASIO_LIBNS::aligned_new(alignment, size > 0 ? size : 1))
+    {
+      // Where aligned allocation is not available, allocate enough extra
+      // memory for the buffers to be aligned within it.
+      if ((reinterpret_cast<uintptr_t>(data_) & (alignment - 1)) != 0)
+      {
+        ASIO_LIBNS::aligned_delete(data_);
+        data_ = ASIO_LIBNS::aligned_new(alignment, size + alignment);
+      }
+    }
+
+    ~storage()
+    {
+      ASIO_LIBNS::aligned_delete(data_);
+    }
+
+    char* data() const ASIO_NOEXCEPT
+    {
+      return static_cast<char*>(data_);
+    }
+
+  private:
+    void* data_;
+  };
+
+  // Validate an alignment, which must be a non-zero power of two.
+  static std::size_t checked_alignment(std::size_t alignment)
+  {
+    if (alignment == 0 || (alignment & (alignment - 1)) != 0)
+    {
+      ASIO_LIBNS::error_code ec(ASIO_LIBNS::error::invalid_argument);
+      ASIO_LIBNS::detail::throw_error(ec, "aligned_buffer_pool");
+    }
+    return alignment;
+  }
+
+  // Round a size up to a multiple of the alignment.
+  static std::size_t round_up(std::size_t n, std::size_t alignment)
+  {
+    n = n > 0 ? n : 1;
+    return (n + alignment - 1) & ~(alignment - 1);
+  }
+
+  // Divide the storage into aligned buffers.
+  std::vector<mutable_buffer> make_buffers(std::size_t buffer_count)
+  {
+    uintptr_t base = reinterpret_cast<uintptr_t>(storage_.data());
+    std::size_t skip = static_cast<std::size_t>(
+        (alignment_ - (base & (alignment_ - 1))) & (alignment_ - 1));
+
+    std::vector<mutable_buffer> buffers;
+    buffers.reserve(buffer_count);
+    for (std::size_t i = 0; i < buffer_count; ++i)
+    {
+      buffers.push_back(ASIO_LIBNS::buffer(
+            storage_.data() + skip + i * buffer_size_, buffer_size_));
+    }
+    return buffers;
+  }
+
+  // Mark every buffer as available, with the lowest addresses used first.
+  void init_free_list()
+  {
+    in_use_.resize(registration_.size());
+    free_list_.reserve(registration_.size());
+    for (std::size_t i = registration_.size(); i > 0; --i)
+      free_list_.push_back(i - 1);
+  }
+
+  // The alignment and size of each buffer.
+  std::size_t alignment_;
+  std::size_t buffer_size_;
+
+  // The memory that is divided into buffers.
+  storage storage_;
+
+  // The registration of the buffers with the execution context.
+  buffer_registration<std::vector<mutable_buffer> > registration_;
+
+  // Mutex to protect access to the free list and the in-use flags.
+  mutable detail::mutex mutex_;
+
+  // The indexes of the buffers that are not in use.
+  std::vector<std::size_t> free_list_;
+
+  // Whether each buffer has been acquired and not yet returned.
+  std::vector<bool> in_use_;
+};
+
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // ASIO_ALIGNED_BUFFER_POOL_HPP
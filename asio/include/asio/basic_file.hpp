@@ -20,6 +20,7 @@
 #if defined(ASIO_HAS_FILE) \
   || defined(GENERATING_DOCUMENTATION)
 
+#include <cstddef>
 #include <string>
 #include "asio/any_io_executor.hpp"
 #include "asio/async_result.hpp"
@@ -37,6 +38,8 @@
 # include "asio/detail/win_iocp_file_service.hpp"
 #elif defined(ASIO_HAS_IO_URING)
 # include "asio/detail/io_uring_file_service.hpp"
+#else
+# include "asio/detail/reactive_file_service.hpp"
 #endif
 
 #if defined(ASIO_HAS_MOVE)
@@ -69,6 +72,15 @@ template <typename Executor>
 class basic_file
   : public file_base
 {
+private:
+  class initiate_async_open;
+  class initiate_async_close;
+  class initiate_async_size;
+  class initiate_async_resize;
+  class initiate_async_allocate;
+  class initiate_async_sync_all;
+  class initiate_async_sync_data;
+
 public:
   /// The type of the executor associated with the object.
   typedef Executor executor_type;
@@ -88,6 +100,8 @@ public:
   typedef detail::win_iocp_file_service::native_handle_type native_handle_type;
 #elif defined(ASIO_HAS_IO_URING)
   typedef detail::io_uring_file_service::native_handle_type native_handle_type;
+#else
+  typedef detail::reactive_file_service::native_handle_type native_handle_type;
 #endif
 
   /// Construct a basic_file without opening it.
@@ -456,6 +470,60 @@ public:
     ASIO_SYNC_OP_VOID_RETURN(ec);
   }
 
+  /// Start an asynchronous open of the file using the specified path.
+  /**
+   * This function is used to asynchronously open the file. It is an
+   * initiating function for an @ref asynchronous_operation, and always returns
+   * immediately. The file is open once the completion handler is called
+   * without error. The operation fails with ASIO_LIBNS::error::already_open
+   * if the file is already open or being opened.
+   *
+   * @param path The path name identifying the file to be opened. A copy is
+   * made as necessary.
+   *
+   * @param open_flags A set of flags that determine how the file should be
+   * opened.
+   *
+   * @param token The @ref completion_token that will be used to produce a
+   * completion handler, which will be called when the open completes.
+   * Potential completion tokens include @ref use_future, @ref use_awaitable,
+   * @ref yield_context, or a function object with the correct completion
+   * signature. The function signature of the completion handler must be:
+   * @code void handler(
+   *   const ASIO_LIBNS::error_code& error // Result of operation.
+   * ); @endcode
+   * Regardless of whether the asynchronous operation completes immediately or
+   * not, the completion handler will not be invoked from within this function.
+   * On immediate completion, invocation of the handler will be performed in a
+   * manner equivalent to using ASIO_LIBNS::post().
+   *
+   * @par Completion Signature
+   * @code void(ASIO_LIBNS::error_code) @endcode
+   *
+   * On io_uring the operation is submitted as an @c IORING_OP_OPENAT request.
+   * Elsewhere it is performed by the pool of threads used for file
+   * operations.
+   * If the file is closed or destroyed before the operation completes, the
+   * new file is closed and the operation fails with
+   * ASIO_LIBNS::error::operation_aborted.
+   */
+  template <
+      ASIO_COMPLETION_TOKEN_FOR(void (ASIO_LIBNS::error_code))
+        OpenToken ASIO_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  ASIO_INITFN_AUTO_RESULT_TYPE_PREFIX(OpenToken,
+      void (ASIO_LIBNS::error_code))
+  async_open(const std::string& path,
+      file_base::flags open_flags,
+      ASIO_MOVE_ARG(OpenToken) token
+        ASIO_DEFAULT_COMPLETION_TOKEN(executor_type))
+    ASIO_INITFN_AUTO_RESULT_TYPE_SUFFIX((
+      async_initiate<OpenToken, void (ASIO_LIBNS::error_code)>(
+          declval<initiate_async_open>(), token, path, open_flags)))
+  {
+    return async_initiate<OpenToken, void (ASIO_LIBNS::error_code)>(
+        initiate_async_open(this), token, path, open_flags);
+  }
+
   /// Assign an existing native file to the file.
   /*
    * This function opens the file to hold an existing native file.
@@ -537,6 +605,51 @@ public:
     ASIO_SYNC_OP_VOID_RETURN(ec);
   }
 
+  /// Start an asynchronous close of the file.
+  /**
+   * This function is used to asynchronously close the file. It is an
+   * initiating function for an @ref asynchronous_operation, and always returns
+   * immediately. The file is closed to further operations immediately, and any
+   * asynchronous read or write operations are cancelled as if by @c close.
+   * The completion handler receives the result of closing the underlying
+   * descriptor.
+   *
+   * @param token The @ref completion_token that will be used to produce a
+   * completion handler, which will be called when the close completes.
+   * Potential completion tokens include @ref use_future, @ref use_awaitable,
+   * @ref yield_context, or a function object with the correct completion
+   * signature. The function signature of the completion handler must be:
+   * @code void handler(
+   *   const ASIO_LIBNS::error_code& error // Result of operation.
+   * ); @endcode
+   * Regardless of whether the asynchronous operation completes immediately or
+   * not, the completion handler will not be invoked from within this function.
+   * On immediate completion, invocation of the handler will be performed in a
+   * manner equivalent to using ASIO_LIBNS::post().
+   *
+   * @par Completion Signature
+   * @code void(ASIO_LIBNS::error_code) @endcode
+   *
+   * On io_uring the operation is submitted as an @c IORING_OP_CLOSE request.
+   * Elsewhere it is performed by the pool of threads used for file
+   * operations.
+   */
+  template <
+      ASIO_COMPLETION_TOKEN_FOR(void (ASIO_LIBNS::error_code))
+        CloseToken ASIO_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  ASIO_INITFN_AUTO_RESULT_TYPE_PREFIX(CloseToken,
+      void (ASIO_LIBNS::error_code))
+  async_close(
+      ASIO_MOVE_ARG(CloseToken) token
+        ASIO_DEFAULT_COMPLETION_TOKEN(executor_type))
+    ASIO_INITFN_AUTO_RESULT_TYPE_SUFFIX((
+      async_initiate<CloseToken, void (ASIO_LIBNS::error_code)>(
+          declval<initiate_async_close>(), token)))
+  {
+    return async_initiate<CloseToken, void (ASIO_LIBNS::error_code)>(
+        initiate_async_close(this), token);
+  }
+
   /// Release ownership of the underlying native file.
   /**
    * This function causes all outstanding asynchronous read and write
@@ -708,6 +821,79 @@ public:
     return impl_.get_service().size(impl_.get_implementation(), ec);
   }
 
+  /// Get the alignment required for direct I/O on the file.
+  /**
+   * This function determines the alignment, in bytes, that file offsets,
+   * transfer lengths and buffer addresses must satisfy when the file is
+   * opened with file_base::direct_io.
+   *
+   * @throws ASIO_LIBNS::system_error Thrown on failure.
+   */
+  std::size_t alignment() const
+  {
+    ASIO_LIBNS::error_code ec;
+    std::size_t a = impl_.get_service().alignment(
+        impl_.get_implementation(), ec);
+    ASIO_LIBNS::detail::throw_error(ec, "alignment");
+    return a;
+  }
+
+  /// Get the alignment required for direct I/O on the file.
+  /**
+   * This function determines the alignment, in bytes, that file offsets,
+   * transfer lengths and buffer addresses must satisfy when the file is
+   * opened with file_base::direct_io.
+   *
+   * @param ec Set to indicate what error occurred, if any.
+   */
+  std::size_t alignment(ASIO_LIBNS::error_code& ec) const
+  {
+    return impl_.get_service().alignment(impl_.get_implementation(), ec);
+  }
+
+  /// Start an asynchronous operation to get the size of the file.
+  /**
+   * This function is used to asynchronously determine the size of the file,
+   * in bytes. It is an initiating function for an @ref asynchronous_operation,
+   * and always returns immediately.
+   *
+   * @param token The @ref completion_token that will be used to produce a
+   * completion handler, which will be called when the operation completes.
+   * Potential completion tokens include @ref use_future, @ref use_awaitable,
+   * @ref yield_context, or a function object with the correct completion
+   * signature. The function signature of the completion handler must be:
+   * @code void handler(
+   *   const ASIO_LIBNS::error_code& error, // Result of operation.
+   *   uint64_t size // The size of the file, in bytes.
+   * ); @endcode
+   * Regardless of whether the asynchronous operation completes immediately or
+   * not, the completion handler will not be invoked from within this function.
+   * On immediate completion, invocation of the handler will be performed in a
+   * manner equivalent to using ASIO_LIBNS::post().
+   *
+   * @par Completion Signature
+   * @code void(ASIO_LIBNS::error_code, uint64_t) @endcode
+   *
+   * On io_uring the operation is submitted as an @c IORING_OP_STATX request.
+   * Elsewhere it is performed by the pool of threads used for file
+   * operations.
+   */
+  template <
+      ASIO_COMPLETION_TOKEN_FOR(void (ASIO_LIBNS::error_code, uint64_t))
+        SizeToken ASIO_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  ASIO_INITFN_AUTO_RESULT_TYPE_PREFIX(SizeToken,
+      void (ASIO_LIBNS::error_code, uint64_t))
+  async_size(
+      ASIO_MOVE_ARG(SizeToken) token
+        ASIO_DEFAULT_COMPLETION_TOKEN(executor_type))
+    ASIO_INITFN_AUTO_RESULT_TYPE_SUFFIX((
+      async_initiate<SizeToken, void (ASIO_LIBNS::error_code, uint64_t)>(
+          declval<initiate_async_size>(), token)))
+  {
+    return async_initiate<SizeToken, void (ASIO_LIBNS::error_code, uint64_t)>(
+        initiate_async_size(this), token);
+  }
+
   /// Alter the size of the file.
   /**
    * This function resizes the file to the specified size, in bytes. If the
@@ -743,6 +929,138 @@ public:
     ASIO_SYNC_OP_VOID_RETURN(ec);
   }
 
+  /// Start an asynchronous operation to alter the size of the file.
+  /**
+   * This function is used to asynchronously resize the file to the specified
+   * size, in bytes. It is an initiating function for an
+   * @ref asynchronous_operation, and always returns immediately.
+   *
+   * @param n The new size for the file.
+   *
+   * @param token The @ref completion_token that will be used to produce a
+   * completion handler, which will be called when the operation completes.
+   * Potential completion tokens include @ref use_future, @ref use_awaitable,
+   * @ref yield_context, or a function object with the correct completion
+   * signature. The function signature of the completion handler must be:
+   * @code void handler(
+   *   const ASIO_LIBNS::error_code& error // Result of operation.
+   * ); @endcode
+   * Regardless of whether the asynchronous operation completes immediately or
+   * not, the completion handler will not be invoked from within this function.
+   * On immediate completion, invocation of the handler will be performed in a
+   * manner equivalent to using ASIO_LIBNS::post().
+   *
+   * @par Completion Signature
+   * @code void(ASIO_LIBNS::error_code) @endcode
+   *
+   * On io_uring the operation is submitted as an @c IORING_OP_FTRUNCATE
+   * request. Elsewhere it is performed by the pool of threads used for file
+   * operations.
+   * When the io_uring library does not provide @c IORING_OP_FTRUNCATE the
+   * file is resized when the operation is initiated.
+   */
+  template <
+      ASIO_COMPLETION_TOKEN_FOR(void (ASIO_LIBNS::error_code))
+        ResizeToken ASIO_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  ASIO_INITFN_AUTO_RESULT_TYPE_PREFIX(ResizeToken,
+      void (ASIO_LIBNS::error_code))
+  async_resize(uint64_t n,
+      ASIO_MOVE_ARG(ResizeToken) token
+        ASIO_DEFAULT_COMPLETION_TOKEN(executor_type))
+    ASIO_INITFN_AUTO_RESULT_TYPE_SUFFIX((
+      async_initiate<ResizeToken, void (ASIO_LIBNS::error_code)>(
+          declval<initiate_async_resize>(), token, n)))
+  {
+    return async_initiate<ResizeToken, void (ASIO_LIBNS::error_code)>(
+        initiate_async_resize(this), token, n);
+  }
+
+  /// Allocate disk space for a range of the file.
+  /**
+   * This function ensures that disk space is allocated for the specified
+   * range, in bytes. If the range extends beyond the end of the file then the
+   * file is extended and filled with zeroes.
+   *
+   * @param offset The start of the range.
+   *
+   * @param length The length of the range.
+   *
+   * @throws ASIO_LIBNS::system_error Thrown on failure.
+   */
+  void allocate(uint64_t offset, uint64_t length)
+  {
+    ASIO_LIBNS::error_code ec;
+    impl_.get_service().allocate(
+        impl_.get_implementation(), offset, length, ec);
+    ASIO_LIBNS::detail::throw_error(ec, "allocate");
+  }
+
+  /// Allocate disk space for a range of the file.
+  /**
+   * This function ensures that disk space is allocated for the specified
+   * range, in bytes. If the range extends beyond the end of the file then the
+   * file is extended and filled with zeroes.
+   *
+   * @param offset The start of the range.
+   *
+   * @param length The length of the range.
+   *
+   * @param ec Set to indicate what error occurred, if any.
+   */
+  ASIO_SYNC_OP_VOID allocate(uint64_t offset, uint64_t length,
+      ASIO_LIBNS::error_code& ec)
+  {
+    impl_.get_service().allocate(
+        impl_.get_implementation(), offset, length, ec);
+    ASIO_SYNC_OP_VOID_RETURN(ec);
+  }
+
+  /// Start an asynchronous allocation of disk space for a range of the file.
+  /**
+   * This function is used to asynchronously ensure that disk space is
+   * allocated for the specified range, in bytes. It is an initiating function
+   * for an @ref asynchronous_operation, and always returns immediately.
+   *
+   * @param offset The start of the range.
+   *
+   * @param length The length of the range.
+   *
+   * @param token The @ref completion_token that will be used to produce a
+   * completion handler, which will be called when the operation completes.
+   * Potential completion tokens include @ref use_future, @ref use_awaitable,
+   * @ref yield_context, or a function object with the correct completion
+   * signature. The function signature of the completion handler must be:
+   * @code void handler(
+   *   const ASIO_LIBNS::error_code& error // Result of operation.
+   * ); @endcode
+   * Regardless of whether the asynchronous operation completes immediately or
+   * not, the completion handler will not be invoked from within this function.
+   * On immediate completion, invocation of the handler will be performed in a
+   * manner equivalent to using ASIO_LIBNS::post().
+   *
+   * @par Completion Signature
+   * @code void(ASIO_LIBNS::error_code) @endcode
+   *
+   * On io_uring the operation is submitted as an @c IORING_OP_FALLOCATE
+   * request. Elsewhere it is performed by the pool of threads used for file
+   * operations.
+   */
+  template <
+      ASIO_COMPLETION_TOKEN_FOR(void (ASIO_LIBNS::error_code))
+        AllocateToken ASIO_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  ASIO_INITFN_AUTO_RESULT_TYPE_PREFIX(AllocateToken,
+      void (ASIO_LIBNS::error_code))
+  async_allocate(uint64_t offset, uint64_t length,
+      ASIO_MOVE_ARG(AllocateToken) token
+        ASIO_DEFAULT_COMPLETION_TOKEN(executor_type))
+    ASIO_INITFN_AUTO_RESULT_TYPE_SUFFIX((
+      async_initiate<AllocateToken, void (ASIO_LIBNS::error_code)>(
+          declval<initiate_async_allocate>(), token, offset, length)))
+  {
+    return async_initiate<AllocateToken, void (ASIO_LIBNS::error_code)>(
+        initiate_async_allocate(this), token, offset, length);
+  }
+
   /// Synchronise the file to disk.
   /**
    * This function synchronises the file data and metadata to disk. Note that
@@ -770,6 +1088,48 @@ public:
     ASIO_SYNC_OP_VOID_RETURN(ec);
   }
 
+  /// Start an asynchronous synchronisation of the file to disk.
+  /**
+   * This function is used to asynchronously synchronise the file data and
+   * metadata to disk. It is an initiating function for an
+   * @ref asynchronous_operation, and always returns immediately.
+   *
+   * @param token The @ref completion_token that will be used to produce a
+   * completion handler, which will be called when the operation completes.
+   * Potential completion tokens include @ref use_future, @ref use_awaitable,
+   * @ref yield_context, or a function object with the correct completion
+   * signature. The function signature of the completion handler must be:
+   * @code void handler(
+   *   const ASIO_LIBNS::error_code& error // Result of operation.
+   * ); @endcode
+   * Regardless of whether the asynchronous operation completes immediately or
+   * not, the completion handler will not be invoked from within this function.
+   * On immediate completion, invocation of the handler will be performed in a
+   * manner equivalent to using ASIO_LIBNS::post().
+   *
+   * @par Completion Signature
+   * @code void(ASIO_LIBNS::error_code) @endcode
+   *
+   * On io_uring the operation is submitted as an @c IORING_OP_FSYNC request.
+   * Elsewhere it is performed by the pool of threads used for file
+   * operations.
+   */
+  template <
+      ASIO_COMPLETION_TOKEN_FOR(void (ASIO_LIBNS::error_code))
+        SyncToken ASIO_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  ASIO_INITFN_AUTO_RESULT_TYPE_PREFIX(SyncToken,
+      void (ASIO_LIBNS::error_code))
+  async_sync_all(
+      ASIO_MOVE_ARG(SyncToken) token
+        ASIO_DEFAULT_COMPLETION_TOKEN(executor_type))
+    ASIO_INITFN_AUTO_RESULT_TYPE_SUFFIX((
+      async_initiate<SyncToken, void (ASIO_LIBNS::error_code)>(
+          declval<initiate_async_sync_all>(), token)))
+  {
+    return async_initiate<SyncToken, void (ASIO_LIBNS::error_code)>(
+        initiate_async_sync_all(this), token);
+  }
+
   /// Synchronise the file data to disk.
   /**
    * This function synchronises the file data to disk. Note that the semantics
@@ -797,6 +1157,69 @@ public:
     ASIO_SYNC_OP_VOID_RETURN(ec);
   }
 
+  /// Start an asynchronous synchronisation of the file data to disk.
+  /**
+   * This function is used to asynchronously synchronise the file data to
+   * disk. It is an initiating function for an @ref asynchronous_operation, and
+   * always returns immediately.
+   *
+   * @param token The @ref completion_token that will be used to produce a
+   * completion handler, which will be called when the operation completes.
+   * Potential completion tokens include @ref use_future, @ref use_awaitable,
+   * @ref yield_context, or a function object with the correct completion
+   * signature. The function signature of the completion handler must be:
+   * @code void handler(
+   *   const ASIO_LIBNS::error_code& error // Result of operation.
+   * ); @endcode
+   * Regardless of whether the asynchronous operation completes immediately or
+   * not, the completion handler will not be invoked from within this function.
+   * On immediate completion, invocation of the handler will be performed in a
+   * manner equivalent to using ASIO_LIBNS::post().
+   *
+   * @par Completion Signature
+   * @code void(ASIO_LIBNS::error_code) @endcode
+   *
+   * On io_uring the operation is submitted as an @c IORING_OP_FSYNC request.
+   * Elsewhere it is performed by the pool of threads used for file
+   * operations.
+   */
+  template <
+      ASIO_COMPLETION_TOKEN_FOR(void (ASIO_LIBNS::error_code))
+        SyncToken ASIO_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  ASIO_INITFN_AUTO_RESULT_TYPE_PREFIX(SyncToken,
+      void (ASIO_LIBNS::error_code))
+  async_sync_data(
+      ASIO_MOVE_ARG(SyncToken) token
+        ASIO_DEFAULT_COMPLETION_TOKEN(executor_type))
+    ASIO_INITFN_AUTO_RESULT_TYPE_SUFFIX((
+      async_initiate<SyncToken, void (ASIO_LIBNS::error_code)>(
+          declval<initiate_async_sync_data>(), token)))
+  {
+    return async_initiate<SyncToken, void (ASIO_LIBNS::error_code)>(
+        initiate_async_sync_data(this), token);
+  }
+
+#if !defined(ASIO_HAS_IOCP) && !defined(ASIO_HAS_IO_URING) \
+  || defined(GENERATING_DOCUMENTATION)
+  /// Set the maximum number of threads used for asynchronous operations.
+  /**
+   * When neither IOCP nor io_uring is available, asynchronous operations that
+   * cannot complete immediately are performed by a pool of threads shared by
+   * all files in the execution context. Threads are started as needed, up to
+   * the specified maximum, which defaults to the number of processors.
+   * Reads of data that is already in the page cache complete without using
+   * the pool.
+   *
+   * @param max_threads The maximum number of threads. A value of zero is
+   * treated as one. Lowering the maximum does not stop running threads.
+   */
+  void set_thread_pool(std::size_t max_threads)
+  {
+    impl_.get_service().set_thread_pool(max_threads);
+  }
+#endif // !defined(ASIO_HAS_IOCP) && !defined(ASIO_HAS_IO_URING)
+       //   || defined(GENERATING_DOCUMENTATION)
+
 protected:
   /// Protected destructor to prevent deletion through this type.
   /**
@@ -811,12 +1234,236 @@ protected:
   detail::io_object_impl<detail::win_iocp_file_service, Executor> impl_;
 #elif defined(ASIO_HAS_IO_URING)
   detail::io_object_impl<detail::io_uring_file_service, Executor> impl_;
+#else
+  detail::io_object_impl<detail::reactive_file_service, Executor> impl_;
 #endif
 
 private:
   // Disallow copying and assignment.
   basic_file(const basic_file&) ASIO_DELETED;
   basic_file& operator=(const basic_file&) ASIO_DELETED;
+
+  class initiate_async_open
+  {
+  public:
+    typedef Executor executor_type;
+
+    explicit initiate_async_open(basic_file* self)
+      : self_(self)
+    {
+    }
+
+    executor_type get_executor() const ASIO_NOEXCEPT
+    {
+      return self_->get_executor();
+    }
+
+    template <typename Handler>
+    void operator()(ASIO_MOVE_ARG(Handler) handler,
+        const std::string& path, file_base::flags open_flags) const
+    {
+      // If you get an error on the following line it means that your handler
+      // does not meet the documented type requirements for a WaitHandler.
+      ASIO_WAIT_HANDLER_CHECK(Handler, handler) type_check;
+
+      detail::non_const_lvalue<Handler> handler2(handler);
+      self_->impl_.get_service().async_open(
+          self_->impl_.get_implementation(), path.c_str(), open_flags,
+          handler2.value, self_->impl_.get_executor());
+    }
+
+  private:
+    basic_file* self_;
+  };
+
+  class initiate_async_close
+  {
+  public:
+    typedef Executor executor_type;
+
+    explicit initiate_async_close(basic_file* self)
+      : self_(self)
+    {
+    }
+
+    executor_type get_executor() const ASIO_NOEXCEPT
+    {
+      return self_->get_executor();
+    }
+
+    template <typename Handler>
+    void operator()(ASIO_MOVE_ARG(Handler) handler) const
+    {
+      // If you get an error on the following line it means that your handler
+      // does not meet the documented type requirements for a WaitHandler.
+      ASIO_WAIT_HANDLER_CHECK(Handler, handler) type_check;
+
+      detail::non_const_lvalue<Handler> handler2(handler);
+      self_->impl_.get_service().async_close(
+          self_->impl_.get_implementation(),
+          handler2.value, self_->impl_.get_executor());
+    }
+
+  private:
+    basic_file* self_;
+  };
+
+  class initiate_async_size
+  {
+  public:
+    typedef Executor executor_type;
+
+    explicit initiate_async_size(basic_file* self)
+      : self_(self)
+    {
+    }
+
+    executor_type get_executor() const ASIO_NOEXCEPT
+    {
+      return self_->get_executor();
+    }
+
+    template <typename Handler>
+    void operator()(ASIO_MOVE_ARG(Handler) handler) const
+    {
+      detail::non_const_lvalue<Handler> handler2(handler);
+      self_->impl_.get_service().async_size(
+          self_->impl_.get_implementation(),
+          handler2.value, self_->impl_.get_executor());
+    }
+
+  private:
+    basic_file* self_;
+  };
+
+  class initiate_async_resize
+  {
+  public:
+    typedef Executor executor_type;
+
+    explicit initiate_async_resize(basic_file* self)
+      : self_(self)
+    {
+    }
+
+    executor_type get_executor() const ASIO_NOEXCEPT
+    {
+      return self_->get_executor();
+    }
+
+    template <typename Handler>
+    void operator()(ASIO_MOVE_ARG(Handler) handler, uint64_t n) const
+    {
+      // If you get an error on the following line it means that your handler
+      // does not meet the documented type requirements for a WaitHandler.
+      ASIO_WAIT_HANDLER_CHECK(Handler, handler) type_check;
+
+      detail::non_const_lvalue<Handler> handler2(handler);
+      self_->impl_.get_service().async_resize(
+          self_->impl_.get_implementation(), n,
+          handler2.value, self_->impl_.get_executor());
+    }
+
+  private:
+    basic_file* self_;
+  };
+
+  class initiate_async_allocate
+  {
+  public:
+    typedef Executor executor_type;
+
+    explicit initiate_async_allocate(basic_file* self)
+      : self_(self)
+    {
+    }
+
+    executor_type get_executor() const ASIO_NOEXCEPT
+    {
+      return self_->get_executor();
+    }
+
+    template <typename Handler>
+    void operator()(ASIO_MOVE_ARG(Handler) handler,
+        uint64_t offset, uint64_t length) const
+    {
+      // If you get an error on the following line it means that your handler
+      // does not meet the documented type requirements for a WaitHandler.
+      ASIO_WAIT_HANDLER_CHECK(Handler, handler) type_check;
+
+      detail::non_const_lvalue<Handler> handler2(handler);
+      self_->impl_.get_service().async_allocate(
+          self_->impl_.get_implementation(), offset, length,
+          handler2.value, self_->impl_.get_executor());
+    }
+
+  private:
+    basic_file* self_;
+  };
+
+  class initiate_async_sync_all
+  {
+  public:
+    typedef Executor executor_type;
+
+    explicit initiate_async_sync_all(basic_file* self)
+      : self_(self)
+    {
+    }
+
+    executor_type get_executor() const ASIO_NOEXCEPT
+    {
+      return self_->get_executor();
+    }
+
+    template <typename Handler>
+    void operator()(ASIO_MOVE_ARG(Handler) handler) const
+    {
+      // If you get an error on the following line it means that your handler
+      // does not meet the documented type requirements for a WaitHandler.
+      ASIO_WAIT_HANDLER_CHECK(Handler, handler) type_check;
+
+      detail::non_const_lvalue<Handler> handler2(handler);
+      self_->impl_.get_service().async_sync_all(
+          self_->impl_.get_implementation(),
+          handler2.value, self_->impl_.get_executor());
+    }
+
+  private:
+    basic_file* self_;
+  };
+
+  class initiate_async_sync_data
+  {
+  public:
+    typedef Executor executor_type;
+
+    explicit initiate_async_sync_data(basic_file* self)
+      : self_(self)
+    {
+    }
+
+    executor_type get_executor() const ASIO_NOEXCEPT
+    {
+      return self_->get_executor();
+    }
+
+    template <typename Handler>
+    void operator()(ASIO_MOVE_ARG(Handler) handler) const
+    {
+      // If you get an error on the following line it means that your handler
+      // does not meet the documented type requirements for a WaitHandler.
+      ASIO_WAIT_HANDLER_CHECK(Handler, handler) type_check;
+
+      detail::non_const_lvalue<Handler> handler2(handler);
+      self_->impl_.get_service().async_sync_data(
+          self_->impl_.get_implementation(),
+          handler2.value, self_->impl_.get_executor());
+    }
+
+  private:
+    basic_file* self_;
+  };
 };
 
 } // namespace asio
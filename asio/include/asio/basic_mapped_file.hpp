@@ -0,0 +1,691 @@
+//
+// basic_mapped_file.hpp
+// ~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_BASIC_MAPPED_FILE_HPP
+#define ASIO_BASIC_MAPPED_FILE_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+
+#if defined(ASIO_HAS_MAPPED_FILE) \
+  || defined(GENERATING_DOCUMENTATION)
+
+#include <cstddef>
+#include <string>
+#include "asio/any_io_executor.hpp"
+#include "asio/async_result.hpp"
+#include "asio/buffer.hpp"
+#include "asio/detail/handler_type_requirements.hpp"
+#include "asio/detail/io_object_impl.hpp"
+#include "asio/detail/mapped_file_service.hpp"
+#include "asio/detail/non_const_lvalue.hpp"
+#include "asio/detail/throw_error.hpp"
+#include "asio/detail/type_traits.hpp"
+#include "asio/error.hpp"
+#include "asio/execution_context.hpp"
+#include "asio/file_base.hpp"
+
+#if defined(ASIO_HAS_MOVE)
+# include <utility>
+#endif // defined(ASIO_HAS_MOVE)
+
+#include "asio/detail/push_options.hpp"
+
+namespace ASIO_LIBNS {
+
+#if !defined(ASIO_BASIC_MAPPED_FILE_FWD_DECL)
+#define ASIO_BASIC_MAPPED_FILE_FWD_DECL
+
+// Forward declaration with defaulted arguments.
+template <typename Executor = any_io_executor>
+class basic_mapped_file;
+
+#endif // !defined(ASIO_BASIC_MAPPED_FILE_FWD_DECL)
+
+/// Provides access to a file through a memory mapping.
+/**
+ * The basic_mapped_file class template maps the whole of a file into memory,
+ * so that its contents may be used as buffers without first being read. The
+ * buffers may be passed directly to operations such as asio::async_write.
+ *
+ * Pages that are not yet resident are read when they are first accessed,
+ * blocking the accessing thread. Use async_prefetch() to bring a range into
+ * memory in the background before it is used.
+ *
+ * @par Thread Safety
+ * @e Distinct @e objects: Safe.@n
+ * @e Shared @e objects: Unsafe.
+ */
+template <typename Executor>
+class basic_mapped_file
+  : public file_base
+{
+private:
+  class initiate_async_prefetch;
+  class initiate_async_sync;
+
+public:
+  /// The type of the executor associated with the object.
+  typedef Executor executor_type;
+
+  /// Rebinds the mapped file type to another executor.
+  template <typename Executor1>
+  struct rebind_executor
+  {
+    /// The mapped file type when rebound to the specified executor.
+    typedef basic_mapped_file<Executor1> other;
+  };
+
+  /// Construct a basic_mapped_file without opening it.
+  /**
+   * This constructor initialises a mapped file without opening it.
+   *
+   * @param ex The I/O executor that the file will use, by default, to
+   * dispatch handlers for any asynchronous operations performed on the file.
+   */
+  explicit basic_mapped_file(const executor_type& ex)
+    : impl_(0, ex)
+  {
+  }
+
+  /// Construct a basic_mapped_file without opening it.
+  /**
+   * This constructor initialises a mapped file without opening it.
+   *
+   * @param context An execution context which provides the I/O executor that
+   * the file will use, by default, to dispatch handlers for any asynchronous
+   * operations performed on the file.
+   */
+  template <typename ExecutionContext>
+  explicit basic_mapped_file(ExecutionContext& context,
+      typename constraint<
+        is_convertible<ExecutionContext&, execution_context&>::value,
+        defaulted_constraint
+      >::type = defaulted_constraint())
+    : impl_(0, 0, context)
+  {
+  }
+
+  /// Construct and open a basic_mapped_file.
+  /**
+   * This constructor maps the file at the specified path.
+   *
+   * @param ex The I/O executor that the file will use, by default, to
+   * dispatch handlers for any asynchronous operations performed on the file.
+   *
+   * @param path The path name identifying the file to be mapped.
+   *
+   * @param open_flags A set of flags that determine how the file should be
+   * opened. The mapping may be written only if the file is opened with
+   * file_base::write_only or file_base::read_write.
+   *
+   * @throws ASIO_LIBNS::system_error Thrown on failure.
+   */
+  basic_mapped_file(const executor_type& ex,
+      const char* path, file_base::flags open_flags)
+    : impl_(0, ex)
+  {
+    ASIO_LIBNS::error_code ec;
+    impl_.get_service().open(impl_.get_implementation(), path, open_flags, ec);
+    ASIO_LIBNS::detail::throw_error(ec, "open");
+  }
+
+  /// Construct and open a basic_mapped_file.
+  /**
+   * This constructor maps the file at the specified path.
+   *
+   * @param context An execution context which provides the I/O executor that
+   * the file will use, by default, to dispatch handlers for any asynchronous
+   * operations performed on the file.
+   *
+   * @param path The path name identifying the file to be mapped.
+   *
+   * @param open_flags A set of flags that determine how the file should be
+   * opened. The mapping may be written only if the file is opened with
+   * file_base::write_only or file_base::read_write.
+   *
+   * @throws ASIO_LIBNS::system_error Thrown on failure.
+   */
+  template <typename ExecutionContext>
+  basic_mapped_file(ExecutionContext& context,
+      const char* path, file_base::flags open_flags,
+      typename constraint<
+        is_convertible<ExecutionContext&, execution_context&>::value,
+        defaulted_constraint
+      >::type = defaulted_constraint())
+    : impl_(0, 0, context)
+  {
+    ASIO_LIBNS::error_code ec;
+    impl_.get_service().open(impl_.get_implementation(), path, open_flags, ec);
+    ASIO_LIBNS::detail::throw_error(ec, "open");
+  }
+
+  /// Construct and open a basic_mapped_file.
+  /**
+   * This constructor maps the file at the specified path.
+   *
+   * @param ex The I/O executor that the file will use, by default, to
+   * dispatch handlers for any asynchronous operations performed on the file.
+   *
+   * @param path The path name identifying the file to be mapped.
+   *
+   * @param open_flags A set of flags that determine how the file should be
+   * opened. The mapping may be written only if the file is opened with
+   * file_base::write_only or file_base::read_write.
+   *
+   * @throws ASIO_LIBNS::system_error Thrown on failure.
+   */
+  basic_mapped_file(const executor_type& ex,
+      const std::string& path, file_base::flags open_flags)
+    : impl_(0, ex)
+  {
+    ASIO_LIBNS::error_code ec;
+    impl_.get_service().open(impl_.get_implementation(),
+        path.c_str(), open_flags, ec);
+    ASIO_LIBNS::detail::throw_error(ec, "open");
+  }
+
+  /// Construct and open a basic_mapped_file.
+  /**
+   * This constructor maps the file at the specified path.
+   *
+   * @param context An execution context which provides the I/O executor that
+   * the file will use, by default, to dispatch handlers for any asynchronous
+   * operations performed on the file.
+   *
+   * @param path The path name identifying the file to be mapped.
+   *
+   * @param open_flags A set of flags that determine how the file should be
+   * opened. The mapping may be written only if the file is opened with
+   * file_base::write_only or file_base::read_write.
+   *
+   * @throws ASIO_LIBNS::system_error Thrown on failure.
+   */
+  template <typename ExecutionContext>
+  basic_mapped_file(ExecutionContext& context,
+      const std::string& path, file_base::flags open_flags,
+      typename constraint<
+        is_convertible<ExecutionContext&, execution_context&>::value,
+        defaulted_constraint
+      >::type = defaulted_constraint())
+    : impl_(0, 0, context)
+  {
+    ASIO_LIBNS::error_code ec;
+    impl_.get_service().open(impl_.get_implementation(),
+        path.c_str(), open_flags, ec);
+    ASIO_LIBNS::detail::throw_error(ec, "open");
+  }
+
+#if defined(ASIO_HAS_MOVE) || defined(GENERATING_DOCUMENTATION)
+  /// Move-construct a basic_mapped_file from another.
+  /**
+   * This constructor moves a mapped file from one object to another. Buffers
+   * obtained from @c other remain valid.
+   *
+   * @param other The other basic_mapped_file object from which the move will
+   * occur.
+   *
+   * @note Following the move, the moved-from object is in the same state as if
+   * constructed using the @c basic_mapped_file(const executor_type&)
+   * constructor.
+   */
+  basic_mapped_file(basic_mapped_file&& other) ASIO_NOEXCEPT
+    : impl_(std::move(other.impl_))
+  {
+  }
+
+  /// Move-assign a basic_mapped_file from another.
+  /**
+   * This assignment operator moves a mapped file from one object to another.
+   *
+   * @param other The other basic_mapped_file object from which the move will
+   * occur.
+   *
+   * @note Following the move, the moved-from object is in the same state as if
+   * constructed using the @c basic_mapped_file(const executor_type&)
+   * constructor.
+   */
+  basic_mapped_file& operator=(basic_mapped_file&& other)
+  {
+    impl_ = std::move(other.impl_);
+    return *this;
+  }
+
+  // All mapped files have access to each other's implementations.
+  template <typename Executor1>
+  friend class basic_mapped_file;
+
+  /// Move-construct a basic_mapped_file from one with another executor type.
+  /**
+   * This constructor moves a mapped file from one object to another.
+   *
+   * @param other The other basic_mapped_file object from which the move will
+   * occur.
+   *
+   * @note Following the move, the moved-from object is in the same state as if
+   * constructed using the @c basic_mapped_file(const executor_type&)
+   * constructor.
+   */
+  template <typename Executor1>
+  basic_mapped_file(basic_mapped_file<Executor1>&& other,
+      typename constraint<
+        is_convertible<Executor1, Executor>::value,
+        defaulted_constraint
+      >::type = defaulted_constraint())
+    : impl_(std::move(other.impl_))
+  {
+  }
+
+  /// Move-assign a basic_mapped_file from one with another executor type.
+  /**
+   * This assignment operator moves a mapped file from one object to another.
+   *
+   * @param other The other basic_mapped_file object from which the move will
+   * occur.
+   *
+   * @note Following the move, the moved-from object is in the same state as if
+   * constructed using the @c basic_mapped_file(const executor_type&)
+   * constructor.
+   */
+  template <typename Executor1>
+  typename constraint<
+    is_convertible<Executor1, Executor>::value,
+    basic_mapped_file&
+  >::type operator=(basic_mapped_file<Executor1>&& other)
+  {
+    impl_ = std::move(other.impl_);
+    return *this;
+  }
+#endif // defined(ASIO_HAS_MOVE) || defined(GENERATING_DOCUMENTATION)
+
+  /// Destroys the mapped file.
+  /**
+   * This function unmaps the file once any outstanding asynchronous
+   * operations are complete. Their handlers are invoked as normal.
+   */
+  ~basic_mapped_file()
+  {
+  }
+
+  /// Get the executor associated with the object.
+  const executor_type& get_executor() ASIO_NOEXCEPT
+  {
+    return impl_.get_executor();
+  }
+
+  /// Map the file using the specified path.
+  /**
+   * This function maps the whole of the file at the specified path. An empty
+   * file is mapped as a region of size zero.
+   *
+   * @param path The path name identifying the file to be mapped.
+   *
+   * @param open_flags A set of flags that determine how the file should be
+   * opened. The mapping may be written only if the file is opened with
+   * file_base::write_only or file_base::read_write.
+   *
+   * @throws ASIO_LIBNS::system_error Thrown on failure.
+   */
+  void open(const char* path, file_base::flags open_flags)
+  {
+    ASIO_LIBNS::error_code ec;
+    impl_.get_service().open(impl_.get_implementation(), path, open_flags, ec);
+    ASIO_LIBNS::detail::throw_error(ec, "open");
+  }
+
+  /// Map the file using the specified path.
+  /**
+   * This function maps the whole of the file at the specified path. An empty
+   * file is mapped as a region of size zero.
+   *
+   * @param path The path name identifying the file to be mapped.
+   *
+   * @param open_flags A set of flags that determine how the file should be
+   * opened. The mapping may be written only if the file is opened with
+   * file_base::write_only or file_base::read_write.
+   *
+   * @param ec Set to indicate what error occurred, if any.
+   */
+  ASIO_SYNC_OP_VOID open(const char* path,
+      file_base::flags open_flags, ASIO_LIBNS::error_code& ec)
+  {
+    impl_.get_service().open(impl_.get_implementation(), path, open_flags, ec);
+    ASIO_SYNC_OP_VOID_RETURN(ec);
+  }
+
+  /// Map the file using the specified path.
+  /**
+   * This function maps the whole of the file at the specified path. An empty
+   * file is mapped as a region of size zero.
+   *
+   * @param path The path name identifying the file to be mapped.
+   *
+   * @param open_flags A set of flags that determine how the file should be
+   * opened. The mapping may be written only if the file is opened with
+   * file_base::write_only or file_base::read_write.
+   *
+   * @throws ASIO_LIBNS::system_error Thrown on failure.
+   */
+  void open(const std::string& path, file_base::flags open_flags)
+  {
+    ASIO_LIBNS::error_code ec;
+    impl_.get_service().open(impl_.get_implementation(),
+        path.c_str(), open_flags, ec);
+    ASIO_LIBNS::detail::throw_error(ec, "open");
+  }
+
+  /// Map the file using the specified path.
+  /**
+   * This function maps the whole of the file at the specified path. An empty
+   * file is mapped as a region of size zero.
+   *
+   * @param path The path name identifying the file to be mapped.
+   *
+   * @param open_flags A set of flags that determine how the file should be
+   * opened. The mapping may be written only if the file is opened with
+   * file_base::write_only or file_base::read_write.
+   *
+   * @param ec Set to indicate what error occurred, if any.
+   */
+  ASIO_SYNC_OP_VOID open(const std::string& path,
+      file_base::flags open_flags, ASIO_LIBNS::error_code& ec)
+  {
+    impl_.get_service().open(impl_.get_implementation(),
+        path.c_str(), open_flags, ec);
+    ASIO_SYNC_OP_VOID_RETURN(ec);
+  }
+
+  /// Determine whether the file is mapped.
+  bool is_open() const
+  {
+    return impl_.get_service().is_open(impl_.get_implementation());
+  }
+
+  /// Unmap the file.
+  /**
+   * This function unmaps the file. Buffers obtained from the file are no
+   * longer valid once any outstanding asynchronous operations are complete,
+   * at which point the region is unmapped.
+   *
+   * @throws ASIO_LIBNS::system_error Thrown on failure.
+   */
+  void close()
+  {
+    ASIO_LIBNS::error_code ec;
+    impl_.get_service().close(impl_.get_implementation(), ec);
+    ASIO_LIBNS::detail::throw_error(ec, "close");
+  }
+
+  /// Unmap the file.
+  /**
+   * This function unmaps the file. Buffers obtained from the file are no
+   * longer valid once any outstanding asynchronous operations are complete,
+   * at which point the region is unmapped.
+   *
+   * @param ec Set to indicate what error occurred, if any.
+   */
+  ASIO_SYNC_OP_VOID close(ASIO_LIBNS::error_code& ec)
+  {
+    impl_.get_service().close(impl_.get_implementation(), ec);
+    ASIO_SYNC_OP_VOID_RETURN(ec);
+  }
+
+  /// Get the size of the mapped region.
+  /**
+   * @returns The size of the file when it was mapped, or zero if the file is
+   * not open.
+   */
+  std::size_t size() const
+  {
+    return impl_.get_service().size(impl_.get_implementation());
+  }
+
+  /// Get a buffer over the whole of the mapped region.
+  /**
+   * @returns A buffer that remains valid until the file is closed or
+   * destroyed.
+   */
+  const_buffer data() const
+  {
+    return const_buffer(
+        impl_.get_service().data(impl_.get_implementation()),
+        impl_.get_service().size(impl_.get_implementation()));
+  }
+
+  /// Get a buffer over part of the mapped region.
+  /**
+   * @param offset The offset of the start of the buffer within the file.
+   *
+   * @param length The size of the buffer. It is reduced so that the buffer
+   * does not extend beyond the end of the region.
+   *
+   * @returns A buffer that remains valid until the file is closed or
+   * destroyed.
+   */
+  const_buffer data(std::size_t offset, std::size_t length) const
+  {
+    return ASIO_LIBNS::buffer(data() + offset, length);
+  }
+
+  /// Get a modifiable buffer over the whole of the mapped region.
+  /**
+   * @returns A buffer that remains valid until the file is closed or
+   * destroyed, or an empty buffer if the file was not opened for writing.
+   * Changes are written back to the file by the operating system, or when
+   * sync() or async_sync() is called.
+   */
+  mutable_buffer mutable_data()
+  {
+    if (!impl_.get_service().writable(impl_.get_implementation()))
+      return mutable_buffer();
+    return mutable_buffer(
+        impl_.get_service().data(impl_.get_implementation()),
+        impl_.get_service().size(impl_.get_implementation()));
+  }
+
+  /// Synchronise modifications to the mapped region to disk.
+  /**
+   * This function writes modified pages back to the file, and waits for the
+   * file to reach the disk. It has no effect if the file was not opened for
+   * writing.
+   *
+   * @throws ASIO_LIBNS::system_error Thrown on failure.
+   */
+  void sync()
+  {
+    ASIO_LIBNS::error_code ec;
+    impl_.get_service().sync(impl_.get_implementation(), ec);
+    ASIO_LIBNS::detail::throw_error(ec, "sync");
+  }
+
+  /// Synchronise modifications to the mapped region to disk.
+  /**
+   * This function writes modified pages back to the file, and waits for the
+   * file to reach the disk. It has no effect if the file was not opened for
+   * writing.
+   *
+   * @param ec Set to indicate what error occurred, if any.
+   */
+  ASIO_SYNC_OP_VOID sync(ASIO_LIBNS::error_code& ec)
+  {
+    impl_.get_service().sync(impl_.get_implementation(), ec);
+    ASIO_SYNC_OP_VOID_RETURN(ec);
+  }
+
+  /// Start an asynchronous operation to bring part of the file into memory.
+  /**
+   * This function is used to asynchronously read a range of the mapped region
+   * into memory, so that later accesses do not block. The pages are read by a
+   * background thread, using @c madvise with @c MADV_POPULATE_READ where
+   * available and otherwise by touching each page after hinting the kernel
+   * with @c MADV_WILLNEED. It is an initiating function for an @ref
+   * asynchronous_operation, and always returns immediately.
+   *
+   * @param offset The offset of the start of the range within the file.
+   *
+   * @param length The size of the range. It is reduced so that the range does
+   * not extend beyond the end of the region.
+   *
+   * @param token The @ref completion_token that will be used to produce a
+   * completion handler, which will be called when the data is resident.
+   * Potential completion tokens include @ref use_future, @ref use_awaitable,
+   * @ref yield_context, or a function object with the correct completion
+   * signature. The function signature of the completion handler must be:
+   * @code void handler(
+   *   const ASIO_LIBNS::error_code& error // Result of operation.
+   * ); @endcode
+   * Regardless of whether the asynchronous operation completes immediately or
+   * not, the completion handler will not be invoked from within this function.
+   * On immediate completion, invocation of the handler will be performed in a
+   * manner equivalent to using ASIO_LIBNS::post().
+   *
+   * @par Completion Signature
+   * @code void(ASIO_LIBNS::error_code) @endcode
+   */
+  template <
+      ASIO_COMPLETION_TOKEN_FOR(void (ASIO_LIBNS::error_code))
+        PrefetchToken ASIO_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  ASIO_INITFN_AUTO_RESULT_TYPE_PREFIX(PrefetchToken,
+      void (ASIO_LIBNS::error_code))
+  async_prefetch(std::size_t offset, std::size_t length,
+      ASIO_MOVE_ARG(PrefetchToken) token
+        ASIO_DEFAULT_COMPLETION_TOKEN(executor_type))
+    ASIO_INITFN_AUTO_RESULT_TYPE_SUFFIX((
+      async_initiate<PrefetchToken, void (ASIO_LIBNS::error_code)>(
+          declval<initiate_async_prefetch>(), token, offset, length)))
+  {
+    return async_initiate<PrefetchToken, void (ASIO_LIBNS::error_code)>(
+        initiate_async_prefetch(this), token, offset, length);
+  }
+
+  /// Start an asynchronous operation to synchronise the mapped region to disk.
+  /**
+   * This function is used to asynchronously write modified pages back to the
+   * file, and wait for the file to reach the disk. The operation is performed
+   * by a background thread. It has no effect if the file was not opened for
+   * writing. It is an initiating function for an @ref asynchronous_operation,
+   * and always returns immediately.
+   *
+   * @param token The @ref completion_token that will be used to produce a
+   * completion handler, which will be called when the sync completes.
+   * Potential completion tokens include @ref use_future, @ref use_awaitable,
+   * @ref yield_context, or a function object with the correct completion
+   * signature. The function signature of the completion handler must be:
+   * @code void handler(
+   *   const ASIO_LIBNS::error_code& error // Result of operation.
+   * ); @endcode
+   * Regardless of whether the asynchronous operation completes immediately or
+   * not, the completion handler will not be invoked from within this function.
+   * On immediate completion, invocation of the handler will be performed in a
+   * manner equivalent to using ASIO_LIBNS::post().
+   *
+   * @par Completion Signature
+   * @code void(ASIO_LIBNS::error_code) @endcode
+   */
+  template <
+      ASIO_COMPLETION_TOKEN_FOR(void (ASIO_LIBNS::error_code))
+        SyncToken ASIO_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  ASIO_INITFN_AUTO_RESULT_TYPE_PREFIX(SyncToken,
+      void (ASIO_LIBNS::error_code))
+  async_sync(
+      ASIO_MOVE_ARG(SyncToken) token
+        ASIO_DEFAULT_COMPLETION_TOKEN(executor_type))
+    ASIO_INITFN_AUTO_RESULT_TYPE_SUFFIX((
+      async_initiate<SyncToken, void (ASIO_LIBNS::error_code)>(
+          declval<initiate_async_sync>(), token)))
+  {
+    return async_initiate<SyncToken, void (ASIO_LIBNS::error_code)>(
+        initiate_async_sync(this), token);
+  }
+
+private:
+  // Disallow copying and assignment.
+  basic_mapped_file(const basic_mapped_file&) ASIO_DELETED;
+  basic_mapped_file& operator=(const basic_mapped_file&) ASIO_DELETED;
+
+  class initiate_async_prefetch
+  {
+  public:
+    typedef Executor executor_type;
+
+    explicit initiate_async_prefetch(basic_mapped_file* self)
+      : self_(self)
+    {
+    }
+
+    executor_type get_executor() const ASIO_NOEXCEPT
+    {
+      return self_->get_executor();
+    }
+
+    template <typename Handler>
+    void operator()(ASIO_MOVE_ARG(Handler) handler,
+        std::size_t offset, std::size_t length) const
+    {
+      // If you get an error on the following line it means that your handler
+      // does not meet the documented type requirements for a WaitHandler.
+      ASIO_WAIT_HANDLER_CHECK(Handler, handler) type_check;
+
+      detail::non_const_lvalue<Handler> handler2(handler);
+      self_->impl_.get_service().async_prefetch(
+          self_->impl_.get_implementation(), offset, length,
+          handler2.value, self_->impl_.get_executor());
+    }
+
+  private:
+    basic_mapped_file* self_;
+  };
+
+  class initiate_async_sync
+  {
+  public:
+    typedef Executor executor_type;
+
+    explicit initiate_async_sync(basic_mapped_file* self)
+      : self_(self)
+    {
+    }
+
+    executor_type get_executor() const ASIO_NOEXCEPT
+    {
+      return self_->get_executor();
+    }
+
+    template <typename Handler>
+    void operator()(ASIO_MOVE_ARG(Handler) handler) const
+    {
+      // If you get an error on the following line it means that your handler
+      // does not meet the documented type requirements for a WaitHandler.
+      ASIO_WAIT_HANDLER_CHECK(Handler, handler) type_check;
+
+      detail::non_const_lvalue<Handler> handler2(handler);
+      self_->impl_.get_service().async_sync(
+          self_->impl_.get_implementation(),
+          handler2.value, self_->impl_.get_executor());
+    }
+
+  private:
+    basic_mapped_file* self_;
+  };
+
+  detail::io_object_impl<detail::mapped_file_service, Executor> impl_;
+};
+
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // defined(ASIO_HAS_MAPPED_FILE)
+       //   || defined(GENERATING_DOCUMENTATION)
+
+#endif // ASIO_BASIC_MAPPED_FILE_HPP
@@ -63,6 +63,7 @@ class basic_random_access_file
 private:
   class initiate_async_write_some_at;
   class initiate_async_read_some_at;
+  class initiate_async_copy_some_at;
 
 public:
   /// The type of the executor associated with the object.
@@ -618,6 +619,74 @@ public:
         initiate_async_read_some_at(this), token, offset, buffers);
   }
 
+  // All random-access files have access to each other's implementations.
+  template <typename Executor1>
+  friend class basic_random_access_file;
+
+  /// Start an asynchronous copy of data at the specified offset to another
+  /// file.
+  /**
+   * This function is used to asynchronously copy data from the random-access
+   * file to the same offset in another file, without passing through user
+   * space where the platform permits it. It is an initiating function for an
+   * @ref asynchronous_operation, and always returns immediately.
+   *
+   * On Linux the data is copied using @c copy_file_range, or by splicing it
+   * through a pipe when using io_uring. Elsewhere, or if the files do not
+   * support an in-kernel copy, the data is copied through memory.
+   *
+   * @param offset The offset at which the data will be copied.
+   *
+   * @param target The file to which the data will be copied. The file must
+   * remain open until the completion handler is called.
+   *
+   * @param length The maximum number of bytes to copy.
+   *
+   * @param token The @ref completion_token that will be used to produce a
+   * completion handler, which will be called when the copy completes.
+   * Potential completion tokens include @ref use_future, @ref use_awaitable,
+   * @ref yield_context, or a function object with the correct completion
+   * signature. The function signature of the completion handler must be:
+   * @code void handler(
+   *   const ASIO_LIBNS::error_code& error, // Result of operation.
+   *   std::size_t bytes_transferred // Number of bytes copied.
+   * ); @endcode
+   * Regardless of whether the asynchronous operation completes immediately or
+   * not, the completion handler will not be invoked from within this function.
+   * On immediate completion, invocation of the handler will be performed in a
+   * manner equivalent to using ASIO_LIBNS::post().
+   *
+   * @par Completion Signature
+   * @code void(ASIO_LIBNS::error_code, std::size_t) @endcode
+   *
+   * @note The copy operation may not copy all of the requested number of
+   * bytes, and copies 0 bytes when @c offset is at the end of the file.
+   * Consider using the @ref async_copy_file function if you need to ensure
+   * that the requested amount of data is copied before the asynchronous
+   * operation completes.
+   */
+  template <typename Executor1,
+      ASIO_COMPLETION_TOKEN_FOR(void (ASIO_LIBNS::error_code,
+        std::size_t)) CopyToken
+          ASIO_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  ASIO_INITFN_AUTO_RESULT_TYPE_PREFIX(CopyToken,
+      void (ASIO_LIBNS::error_code, std::size_t))
+  async_copy_some_at(uint64_t offset,
+      basic_random_access_file<Executor1>& target, std::size_t length,
+      ASIO_MOVE_ARG(CopyToken) token
+        ASIO_DEFAULT_COMPLETION_TOKEN(executor_type))
+    ASIO_INITFN_AUTO_RESULT_TYPE_SUFFIX((
+      async_initiate<CopyToken,
+        void (ASIO_LIBNS::error_code, std::size_t)>(
+          declval<initiate_async_copy_some_at>(), token, offset,
+          &target.impl_.get_implementation(), length)))
+  {
+    return async_initiate<CopyToken,
+      void (ASIO_LIBNS::error_code, std::size_t)>(
+        initiate_async_copy_some_at(this), token, offset,
+        &target.impl_.get_implementation(), length);
+  }
+
 private:
   // Disallow copying and assignment.
   basic_random_access_file(const basic_random_access_file&) ASIO_DELETED;
@@ -689,6 +758,39 @@ private:
   private:
     basic_random_access_file* self_;
   };
+
+  class initiate_async_copy_some_at
+  {
+  public:
+    typedef Executor executor_type;
+
+    explicit initiate_async_copy_some_at(basic_random_access_file* self)
+      : self_(self)
+    {
+    }
+
+    executor_type get_executor() const ASIO_NOEXCEPT
+    {
+      return self_->get_executor();
+    }
+
+    template <typename CopyHandler, typename Implementation>
+    void operator()(ASIO_MOVE_ARG(CopyHandler) handler,
+        uint64_t offset, Implementation* target, std::size_t length) const
+    {
+      // If you get an error on the following line it means that your handler
+      // does not meet the documented type requirements for a WriteHandler.
+      ASIO_WRITE_HANDLER_CHECK(CopyHandler, handler) type_check;
+
+      detail::non_const_lvalue<CopyHandler> handler2(handler);
+      self_->impl_.get_service().async_copy_some_at(
+          self_->impl_.get_implementation(), offset, *target, length,
+          handler2.value, self_->impl_.get_executor());
+    }
+
+  private:
+    basic_random_access_file* self_;
+  };
 };
 
 } // namespace asio
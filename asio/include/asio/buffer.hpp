@@ -23,6 +23,7 @@
 #include <string>
 #include <vector>
 #include "asio/detail/array_fwd.hpp"
+#include "asio/detail/copy_bytes.hpp"
 #include "asio/detail/memory.hpp"
 #include "asio/detail/string_view.hpp"
 #include "asio/detail/throw_exception.hpp"
@@ -2353,15 +2354,31 @@ namespace detail {
 inline std::size_t buffer_copy_1(const mutable_buffer& target,
     const const_buffer& source)
 {
-  using namespace std; // For memcpy.
   std::size_t target_size = target.size();
   std::size_t source_size = source.size();
   std::size_t n = target_size < source_size ? target_size : source_size;
   if (n > 0)
-    memcpy(target.data(), source.data(), n);
+    copy_bytes(target.data(), source.data(), n);
   return n;
 }
 
+// Get the buffer at the iterator, merged with any that follow it directly in
+// memory, and move the iterator past them. This lets many small pieces of one
+// block be copied together.
+template <typename Buffer, typename Iterator>
+inline Buffer merge_adjacent_buffers(Iterator& iter, Iterator end)
+{
+  Buffer buffer(*iter);
+  for (++iter; iter != end; ++iter)
+  {
+    Buffer next(*iter);
+    if (next.data() != static_cast<const char*>(buffer.data()) + buffer.size())
+      break;
+    buffer = Buffer(buffer.data(), buffer.size() + next.size());
+  }
+  return buffer;
+}
+
 template <typename TargetIterator, typename SourceIterator>
 inline std::size_t buffer_copy(one_buffer, one_buffer,
     TargetIterator target_begin, TargetIterator,
@@ -2392,9 +2409,10 @@ std::size_t buffer_copy(one_buffer, multiple_buffers,
 
   for (mutable_buffer target_buffer(
         ASIO_LIBNS::buffer(*target_begin, max_bytes_to_copy));
-      target_buffer.size() && source_iter != source_end; ++source_iter)
+      target_buffer.size() && source_iter != source_end; )
   {
-    const_buffer source_buffer(*source_iter);
+    const_buffer source_buffer = (merge_adjacent_buffers<const_buffer>)(
+        source_iter, source_end);
     std::size_t bytes_copied = (buffer_copy_1)(target_buffer, source_buffer);
     total_bytes_copied += bytes_copied;
     target_buffer += bytes_copied;
@@ -2415,9 +2433,10 @@ std::size_t buffer_copy(multiple_buffers, one_buffer,
 
   for (const_buffer source_buffer(
         ASIO_LIBNS::buffer(*source_begin, max_bytes_to_copy));
-      source_buffer.size() && target_iter != target_end; ++target_iter)
+      source_buffer.size() && target_iter != target_end; )
   {
-    mutable_buffer target_buffer(*target_iter);
+    mutable_buffer target_buffer = (merge_adjacent_buffers<mutable_buffer>)(
+        target_iter, target_end);
     std::size_t bytes_copied = (buffer_copy_1)(target_buffer, source_buffer);
     total_bytes_copied += bytes_copied;
     source_buffer += bytes_copied;
@@ -2434,37 +2453,35 @@ std::size_t buffer_copy(multiple_buffers, multiple_buffers,
   std::size_t total_bytes_copied = 0;
 
   TargetIterator target_iter = target_begin;
-  std::size_t target_buffer_offset = 0;
+  mutable_buffer target_buffer;
 
   SourceIterator source_iter = source_begin;
-  std::size_t source_buffer_offset = 0;
+  const_buffer source_buffer;
 
-  while (target_iter != target_end && source_iter != source_end)
+  for (;;)
   {
-    mutable_buffer target_buffer =
-      mutable_buffer(*target_iter) + target_buffer_offset;
-
-    const_buffer source_buffer =
-      const_buffer(*source_iter) + source_buffer_offset;
-
-    std::size_t bytes_copied = (buffer_copy_1)(target_buffer, source_buffer);
-    total_bytes_copied += bytes_copied;
-
-    if (bytes_copied == target_buffer.size())
+    // Move on to the next target and source buffers once the current ones
+    // are used up.
+    if (target_buffer.size() == 0)
     {
-      ++target_iter;
-      target_buffer_offset = 0;
+      if (target_iter == target_end)
+        break;
+      target_buffer = (merge_adjacent_buffers<mutable_buffer>)(
+          target_iter, target_end);
     }
-    else
-      target_buffer_offset += bytes_copied;
 
-    if (bytes_copied == source_buffer.size())
+    if (source_buffer.size() == 0)
     {
-      ++source_iter;
-      source_buffer_offset = 0;
+      if (source_iter == source_end)
+        break;
+      source_buffer = (merge_adjacent_buffers<const_buffer>)(
+          source_iter, source_end);
     }
-    else
-      source_buffer_offset += bytes_copied;
+
+    std::size_t bytes_copied = (buffer_copy_1)(target_buffer, source_buffer);
+    total_bytes_copied += bytes_copied;
+    target_buffer += bytes_copied;
+    source_buffer += bytes_copied;
   }
 
   return total_bytes_copied;
@@ -2479,40 +2496,37 @@ std::size_t buffer_copy(multiple_buffers, multiple_buffers,
   std::size_t total_bytes_copied = 0;
 
   TargetIterator target_iter = target_begin;
-  std::size_t target_buffer_offset = 0;
+  mutable_buffer target_buffer;
 
   SourceIterator source_iter = source_begin;
-  std::size_t source_buffer_offset = 0;
+  const_buffer source_buffer;
 
-  while (total_bytes_copied != max_bytes_to_copy
-      && target_iter != target_end && source_iter != source_end)
+  while (total_bytes_copied != max_bytes_to_copy)
   {
-    mutable_buffer target_buffer =
-      mutable_buffer(*target_iter) + target_buffer_offset;
+    // Move on to the next target and source buffers once the current ones
+    // are used up.
+    if (target_buffer.size() == 0)
+    {
+      if (target_iter == target_end)
+        break;
+      target_buffer = (merge_adjacent_buffers<mutable_buffer>)(
+          target_iter, target_end);
+    }
 
-    const_buffer source_buffer =
-      const_buffer(*source_iter) + source_buffer_offset;
+    if (source_buffer.size() == 0)
+    {
+      if (source_iter == source_end)
+        break;
+      source_buffer = (merge_adjacent_buffers<const_buffer>)(
+          source_iter, source_end);
+    }
 
     std::size_t bytes_copied = (buffer_copy_1)(
         target_buffer, ASIO_LIBNS::buffer(source_buffer,
           max_bytes_to_copy - total_bytes_copied));
     total_bytes_copied += bytes_copied;
-
-    if (bytes_copied == target_buffer.size())
-    {
-      ++target_iter;
-      target_buffer_offset = 0;
-    }
-    else
-      target_buffer_offset += bytes_copied;
-
-    if (bytes_copied == source_buffer.size())
-    {
-      ++source_iter;
-      source_buffer_offset = 0;
-    }
-    else
-      source_buffer_offset += bytes_copied;
+    target_buffer += bytes_copied;
+    source_buffer += bytes_copied;
   }
 
   return total_bytes_copied;
@@ -16,10 +16,14 @@
 #endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
 
 #include "asio/detail/config.hpp"
+#include <algorithm>
 #include <cstddef>
+#include <cstring>
 #include <iterator>
+#include <utility>
 #include "asio/buffer.hpp"
 #include "asio/detail/assert.hpp"
+#include "asio/detail/buffer_search.hpp"
 #include "asio/detail/type_traits.hpp"
 
 #include "asio/detail/push_options.hpp"
@@ -103,6 +107,8 @@ namespace detail
   };
 
 #endif // !defined(ASIO_NO_DEPRECATED)
+
+  struct buffers_iterator_access;
 }
 
 /// A random access iterator over the bytes in a buffer sequence.
@@ -337,6 +343,8 @@ public:
   }
 
 private:
+  friend struct detail::buffers_iterator_access;
+
   // Dereference the iterator.
   reference dereference() const
   {
@@ -514,6 +522,269 @@ inline buffers_iterator<BufferSequence> buffers_end(
   return buffers_iterator<BufferSequence>::end(buffers);
 }
 
+#if !defined(GENERATING_DOCUMENTATION)
+
+namespace detail
+{
+  // Gives the algorithms below access to the contiguous bytes at an iterator.
+  struct buffers_iterator_access
+  {
+    // Get a pointer to the byte at the iterator.
+    template <typename BufferSequence, typename ByteType>
+    static typename buffers_iterator<BufferSequence, ByteType>::pointer
+    segment_data(const buffers_iterator<BufferSequence, ByteType>& iter)
+    {
+      return static_cast<typename buffers_iterator<
+        BufferSequence, ByteType>::pointer>(iter.current_buffer_.data())
+          + iter.current_buffer_position_;
+    }
+
+    // Get the number of contiguous bytes that follow the iterator.
+    template <typename BufferSequence, typename ByteType>
+    static std::size_t segment_size(
+        const buffers_iterator<BufferSequence, ByteType>& iter)
+    {
+      return iter.current_buffer_.size() - iter.current_buffer_position_;
+    }
+
+    // Get the number of contiguous bytes that follow the iterator, but come
+    // before the last iterator.
+    template <typename BufferSequence, typename ByteType>
+    static std::size_t segment_size(
+        const buffers_iterator<BufferSequence, ByteType>& iter,
+        const buffers_iterator<BufferSequence, ByteType>& last)
+    {
+      std::size_t size = segment_size(iter);
+      std::size_t remaining = last.position_ - iter.position_;
+      return size < remaining ? size : remaining;
+    }
+  };
+
+  template <typename T>
+  inline const T* segment_find(const T* first, const T* last, const T& value)
+  {
+    return std::find(first, last, value);
+  }
+
+  inline const char* segment_find(
+      const char* first, const char* last, const char& value)
+  {
+    return find_byte(first, last, value);
+  }
+
+  template <typename T, typename ForwardIterator>
+  inline const T* segment_search(const T* first, const T* last,
+      ForwardIterator s_first, ForwardIterator s_last)
+  {
+    return std::search(first, last, s_first, s_last);
+  }
+
+  inline const char* segment_search(const char* first, const char* last,
+      const char* s_first, const char* s_last)
+  {
+    std::size_t n = s_last - s_first;
+    return n == 1
+      ? find_byte(first, last, *s_first)
+      : find_bytes(first, last, s_first, n);
+  }
+
+  template <typename T1, typename T2>
+  inline std::pair<const T1*, const T2*> segment_mismatch(
+      const T1* first1, const T1* last1, const T2* first2)
+  {
+    return std::mismatch(first1, last1, first2);
+  }
+
+  inline std::pair<const char*, const char*> segment_mismatch(
+      const char* first1, const char* last1, const char* first2)
+  {
+    if (std::memcmp(first1, first2, last1 - first1) == 0)
+      return std::make_pair(last1, first2 + (last1 - first1));
+    return std::mismatch(first1, last1, first2);
+  }
+} // namespace detail
+
+#endif // !defined(GENERATING_DOCUMENTATION)
+
+/// Find the first byte in a range that is equal to a value.
+/**
+ * Equivalent to @c std::find, except that each contiguous buffer in the
+ * range is searched in one step.
+ */
+template <typename BufferSequence, typename ByteType>
+buffers_iterator<BufferSequence, ByteType> find(
+    buffers_iterator<BufferSequence, ByteType> first,
+    buffers_iterator<BufferSequence, ByteType> last,
+    const ByteType& value)
+{
+  typedef detail::buffers_iterator_access access;
+  while (first != last)
+  {
+    std::size_t size = access::segment_size(first, last);
+    const ByteType* data = access::segment_data(first);
+    const ByteType* p = detail::segment_find(data, data + size, value);
+    first += p - data;
+    if (p != data + size)
+      break;
+  }
+  return first;
+}
+
+/// Find the first occurrence of a subsequence in a range.
+/**
+ * Equivalent to @c std::search, except that matches lying within one
+ * contiguous buffer are found in one step.
+ */
+template <typename BufferSequence, typename ByteType, typename ForwardIterator>
+buffers_iterator<BufferSequence, ByteType> search(
+    buffers_iterator<BufferSequence, ByteType> first,
+    buffers_iterator<BufferSequence, ByteType> last,
+    ForwardIterator s_first, ForwardIterator s_last)
+{
+  typedef detail::buffers_iterator_access access;
+  std::ptrdiff_t n = std::distance(s_first, s_last);
+  if (n == 0)
+    return first;
+
+  while (last - first >= n)
+  {
+    std::size_t size = access::segment_size(first, last);
+    const ByteType* data = access::segment_data(first);
+
+    // Look for a match that lies entirely within this buffer.
+    std::size_t pos = 0;
+    if (size >= static_cast<std::size_t>(n))
+    {
+      const ByteType* p = detail::segment_search(
+          data, data + size, s_first, s_last);
+      if (p != data + size)
+        return first + (p - data);
+      pos = size - n + 1;
+      first += pos;
+    }
+
+    // Check the positions where a match would run into the next buffer.
+    for (; pos < size; ++pos, ++first)
+    {
+      if (last - first < n)
+        return last;
+      if (data[pos] == *s_first && std::equal(s_first, s_last, first))
+        return first;
+    }
+  }
+  return last;
+}
+
+/// Copy a range of bytes.
+/**
+ * Equivalent to @c std::copy, except that each contiguous buffer in the
+ * range is copied in one step.
+ */
+template <typename BufferSequence, typename ByteType, typename OutputIterator>
+OutputIterator copy(buffers_iterator<BufferSequence, ByteType> first,
+    buffers_iterator<BufferSequence, ByteType> last, OutputIterator out)
+{
+  typedef detail::buffers_iterator_access access;
+  while (first != last)
+  {
+    std::size_t size = access::segment_size(first, last);
+    const ByteType* data = access::segment_data(first);
+    out = std::copy(data, data + size, out);
+    first += size;
+  }
+  return out;
+}
+
+/// Find the first position at which two ranges differ.
+/**
+ * Equivalent to @c std::mismatch, except that each contiguous buffer in the
+ * first range is compared in one step.
+ */
+template <typename BufferSequence, typename ByteType, typename InputIterator>
+std::pair<buffers_iterator<BufferSequence, ByteType>, InputIterator>
+mismatch(buffers_iterator<BufferSequence, ByteType> first1,
+    buffers_iterator<BufferSequence, ByteType> last1, InputIterator first2)
+{
+  typedef detail::buffers_iterator_access access;
+  while (first1 != last1)
+  {
+    std::size_t size = access::segment_size(first1, last1);
+    const ByteType* data = access::segment_data(first1);
+    std::pair<const ByteType*, InputIterator> result =
+      std::mismatch(data, data + size, first2);
+    first1 += result.first - data;
+    first2 = result.second;
+    if (result.first != data + size)
+      break;
+  }
+  return std::make_pair(first1, first2);
+}
+
+/// Find the first position at which two ranges differ.
+/**
+ * Equivalent to @c std::mismatch, except that each contiguous piece common
+ * to the buffers of both ranges is compared in one step.
+ */
+template <typename BufferSequence1, typename ByteType1,
+    typename BufferSequence2, typename ByteType2>
+std::pair<buffers_iterator<BufferSequence1, ByteType1>,
+    buffers_iterator<BufferSequence2, ByteType2> >
+mismatch(buffers_iterator<BufferSequence1, ByteType1> first1,
+    buffers_iterator<BufferSequence1, ByteType1> last1,
+    buffers_iterator<BufferSequence2, ByteType2> first2)
+{
+  typedef detail::buffers_iterator_access access;
+  while (first1 != last1)
+  {
+    std::size_t size1 = access::segment_size(first1, last1);
+    std::size_t size2 = access::segment_size(first2);
+    ASIO_ASSERT(size2 > 0 && "iterator out of bounds");
+    std::size_t size = size1 < size2 ? size1 : size2;
+    const ByteType1* data1 = access::segment_data(first1);
+    const ByteType2* data2 = access::segment_data(first2);
+    std::pair<const ByteType1*, const ByteType2*> result =
+      detail::segment_mismatch(data1, data1 + size, data2);
+    first1 += result.first - data1;
+    first2 += result.first - data1;
+    if (result.first != data1 + size)
+      break;
+  }
+  return std::make_pair(first1, first2);
+}
+
+/// Determine whether two ranges are equal.
+/**
+ * Equivalent to @c std::equal, except that each contiguous buffer in the
+ * first range is compared in one step.
+ */
+template <typename BufferSequence, typename ByteType, typename InputIterator>
+inline bool equal(buffers_iterator<BufferSequence, ByteType> first1,
+    buffers_iterator<BufferSequence, ByteType> last1, InputIterator first2)
+{
+  return ASIO_LIBNS::mismatch(first1, last1, first2).first == last1;
+}
+
+/// Count the bytes in a range that are equal to a value.
+/**
+ * Equivalent to @c std::count, except that each contiguous buffer in the
+ * range is counted in one step.
+ */
+template <typename BufferSequence, typename ByteType>
+std::ptrdiff_t count(buffers_iterator<BufferSequence, ByteType> first,
+    buffers_iterator<BufferSequence, ByteType> last, const ByteType& value)
+{
+  typedef detail::buffers_iterator_access access;
+  std::ptrdiff_t result = 0;
+  while (first != last)
+  {
+    std::size_t size = access::segment_size(first, last);
+    const ByteType* data = access::segment_data(first);
+    result += std::count(data, data + size, value);
+    first += size;
+  }
+  return result;
+}
+
 } // namespace asio
 
 #include "asio/detail/pop_options.hpp"
@@ -0,0 +1,235 @@
+//
+// copy_file.hpp
+// ~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_COPY_FILE_HPP
+#define ASIO_COPY_FILE_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+
+#if defined(ASIO_HAS_FILE) \
+  || defined(GENERATING_DOCUMENTATION)
+
+#include <cstddef>
+#include "asio/async_result.hpp"
+#include "asio/basic_random_access_file.hpp"
+#include "asio/detail/cstdint.hpp"
+#include "asio/error.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace ASIO_LIBNS {
+namespace detail {
+
+template <typename> class initiate_async_copy_file;
+
+// The progress function object used when none is supplied.
+struct copy_file_no_progress
+{
+  void operator()(uint64_t) const
+  {
+  }
+};
+
+} // namespace detail
+
+/**
+ * @defgroup async_copy_file asio::async_copy_file
+ *
+ * @brief The @c async_copy_file function is a composed asynchronous operation
+ * that copies a range of one file to the same range of another.
+ */
+/*@{*/
+
+/// Start an asynchronous operation to copy a range of a file to another file.
+/**
+ * This function is used to asynchronously copy a certain number of bytes from
+ * one file to the same offset in another file. It is an initiating function
+ * for an @ref asynchronous_operation, and always returns immediately. The
+ * asynchronous operation will continue until one of the following conditions
+ * is true:
+ *
+ * @li The requested number of bytes has been copied.
+ *
+ * @li The end of the source file has been reached.
+ *
+ * @li An error occurred.
+ *
+ * This operation is implemented in terms of zero or more calls to the source
+ * file's async_copy_some_at function, each of which copies at most one
+ * megabyte. Where the platform permits, the data does not pass through user
+ * space.
+ *
+ * @param source The file from which the data is to be copied.
+ *
+ * @param target The file to which the data is to be copied. The file must
+ * remain open until the completion handler is called.
+ *
+ * @param offset The offset of the range in both files.
+ *
+ * @param length The number of bytes to copy.
+ *
+ * @param token The @ref completion_token that will be used to produce a
+ * completion handler, which will be called when the copy completes.
+ * Potential completion tokens include @ref use_future, @ref use_awaitable,
+ * @ref yield_context, or a function object with the correct completion
+ * signature. The function signature of the completion handler must be:
+ * @code void handler(
+ *   // Result of operation. If the end of the source file was
+ *   // reached first, this is asio::error::eof.
+ *   const ASIO_LIBNS::error_code& error,
+ *
+ *   // Number of bytes copied.
+ *   uint64_t bytes_copied
+ * ); @endcode
+ * Regardless of whether the asynchronous operation completes immediately or
+ * not, the completion handler will not be invoked from within this function.
+ * On immediate completion, invocation of the handler will be performed in a
+ * manner equivalent to using ASIO_LIBNS::post().
+ *
+ * @par Completion Signature
+ * @code void(ASIO_LIBNS::error_code, uint64_t) @endcode
+ *
+ * @par Per-Operation Cancellation
+ * This asynchronous operation supports cancellation for the following
+ * ASIO_LIBNS::cancellation_type values:
+ *
+ * @li @c cancellation_type::terminal
+ *
+ * @li @c cancellation_type::partial
+ *
+ * Cancellation takes effect between calls to async_copy_some_at. Calling the
+ * source file's @c cancel function also stops the operation.
+ */
+template <typename Executor1, typename Executor2,
+    ASIO_COMPLETION_TOKEN_FOR(void (ASIO_LIBNS::error_code,
+      uint64_t)) CopyToken
+        ASIO_DEFAULT_COMPLETION_TOKEN_TYPE(Executor1)>
+ASIO_INITFN_AUTO_RESULT_TYPE_PREFIX(CopyToken,
+    void (ASIO_LIBNS::error_code, uint64_t))
+async_copy_file(basic_random_access_file<Executor1>& source,
+    basic_random_access_file<Executor2>& target,
+    uint64_t offset, uint64_t length,
+    ASIO_MOVE_ARG(CopyToken) token
+      ASIO_DEFAULT_COMPLETION_TOKEN(Executor1))
+  ASIO_INITFN_AUTO_RESULT_TYPE_SUFFIX((
+    async_initiate<CopyToken,
+      void (ASIO_LIBNS::error_code, uint64_t)>(
+        declval<detail::initiate_async_copy_file<Executor1> >(),
+        token, &target, offset, length, detail::copy_file_no_progress())));
+
+/// Start an asynchronous operation to copy a range of a file to another file,
+/// reporting progress as the copy proceeds.
+/**
+ * This function is used to asynchronously copy a certain number of bytes from
+ * one file to the same offset in another file. It is an initiating function
+ * for an @ref asynchronous_operation, and always returns immediately. The
+ * asynchronous operation will continue until one of the following conditions
+ * is true:
+ *
+ * @li The requested number of bytes has been copied.
+ *
+ * @li The end of the source file has been reached.
+ *
+ * @li An error occurred.
+ *
+ * This operation is implemented in terms of zero or more calls to the source
+ * file's async_copy_some_at function, each of which copies at most one
+ * megabyte. Where the platform permits, the data does not pass through user
+ * space.
+ *
+ * @param source The file from which the data is to be copied.
+ *
+ * @param target The file to which the data is to be copied. The file must
+ * remain open until the completion handler is called.
+ *
+ * @param offset The offset of the range in both files.
+ *
+ * @param length The number of bytes to copy.
+ *
+ * @param progress The function object to be called each time data has been
+ * copied. It is called in the same manner as the completion handler. The
+ * signature of the function object must be:
+ * @code void progress(
+ *   // Number of bytes copied so far.
+ *   uint64_t bytes_copied
+ * ); @endcode
+ *
+ * @param token The @ref completion_token that will be used to produce a
+ * completion handler, which will be called when the copy completes. Unlike
+ * the overload without a progress function object, there is no default
+ * completion token. Potential completion tokens include @ref use_future,
+ * @ref use_awaitable, @ref yield_context, or a function object with the
+ * correct completion signature. The function signature of the completion
+ * handler must be:
+ * @code void handler(
+ *   // Result of operation. If the end of the source file was
+ *   // reached first, this is asio::error::eof.
+ *   const ASIO_LIBNS::error_code& error,
+ *
+ *   // Number of bytes copied.
+ *   uint64_t bytes_copied
+ * ); @endcode
+ * Regardless of whether the asynchronous operation completes immediately or
+ * not, the completion handler will not be invoked from within this function.
+ * On immediate completion, invocation of the handler will be performed in a
+ * manner equivalent to using ASIO_LIBNS::post().
+ *
+ * @par Completion Signature
+ * @code void(ASIO_LIBNS::error_code, uint64_t) @endcode
+ *
+ * @par Example
+ * @code ASIO_LIBNS::async_copy_file(source, target, 0, source.size(),
+ *     [](uint64_t n){ std::cout << n << " bytes copied\n"; },
+ *     handler); @endcode
+ *
+ * @par Per-Operation Cancellation
+ * This asynchronous operation supports cancellation for the following
+ * ASIO_LIBNS::cancellation_type values:
+ *
+ * @li @c cancellation_type::terminal
+ *
+ * @li @c cancellation_type::partial
+ *
+ * Cancellation takes effect between calls to async_copy_some_at. Calling the
+ * source file's @c cancel function also stops the operation.
+ */
+template <typename Executor1, typename Executor2, typename ProgressHandler,
+    ASIO_COMPLETION_TOKEN_FOR(void (ASIO_LIBNS::error_code,
+      uint64_t)) CopyToken>
+ASIO_INITFN_AUTO_RESULT_TYPE_PREFIX(CopyToken,
+    void (ASIO_LIBNS::error_code, uint64_t))
+async_copy_file(basic_random_access_file<Executor1>& source,
+    basic_random_access_file<Executor2>& target,
+    uint64_t offset, uint64_t length,
+    ASIO_MOVE_ARG(ProgressHandler) progress,
+    ASIO_MOVE_ARG(CopyToken) token)
+  ASIO_INITFN_AUTO_RESULT_TYPE_SUFFIX((
+    async_initiate<CopyToken,
+      void (ASIO_LIBNS::error_code, uint64_t)>(
+        declval<detail::initiate_async_copy_file<Executor1> >(),
+        token, &target, offset, length,
+        ASIO_MOVE_CAST(ProgressHandler)(progress))));
+
+/*@}*/
+
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#include "asio/impl/copy_file.hpp"
+
+#endif // defined(ASIO_HAS_FILE)
+       //   || defined(GENERATING_DOCUMENTATION)
+
+#endif // ASIO_COPY_FILE_HPP
@@ -0,0 +1,244 @@
+//
+// detail/buffer_search.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_DETAIL_BUFFER_SEARCH_HPP
+#define ASIO_DETAIL_BUFFER_SEARCH_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+#include <cstddef>
+#include <cstring>
+#include <utility>
+#include "asio/buffer.hpp"
+
+#if defined(ASIO_HAS_AVX2)
+# include <immintrin.h>
+#elif defined(ASIO_HAS_SSE2)
+# include <emmintrin.h>
+#endif // defined(ASIO_HAS_SSE2)
+
+#if defined(ASIO_MSVC) \
+  && (defined(ASIO_HAS_SSE2) || defined(ASIO_HAS_AVX2))
+# include <intrin.h>
+#endif // defined(ASIO_MSVC)
+       //   && (defined(ASIO_HAS_SSE2) || defined(ASIO_HAS_AVX2))
+
+#include "asio/detail/push_options.hpp"
+
+namespace ASIO_LIBNS {
+namespace detail {
+
+#if defined(ASIO_HAS_SSE2) || defined(ASIO_HAS_AVX2)
+
+// Get the index of the lowest set bit in a non-zero mask.
+inline unsigned int lowest_set_bit(unsigned int mask)
+{
+#if defined(ASIO_MSVC)
+  unsigned long index;
+  _BitScanForward(&index, mask);
+  return static_cast<unsigned int>(index);
+#else // defined(ASIO_MSVC)
+  return static_cast<unsigned int>(__builtin_ctz(mask));
+#endif // defined(ASIO_MSVC)
+}
+
+#endif // defined(ASIO_HAS_SSE2) || defined(ASIO_HAS_AVX2)
+
+// Find the first occurrence of a byte in a contiguous range. Returns last if
+// there is none. The C library's memchr is already vectorised on the
+// platforms that matter, and so it is used as is.
+inline const char* find_byte(const char* first, const char* last, char c)
+{
+  if (first == last)
+    return last;
+  const void* p = std::memchr(first, c,
+      static_cast<std::size_t>(last - first));
+  return p ? static_cast<const char*>(p) : last;
+}
+
+// Find the first occurrence of a string of n bytes, where n is at least 2,
+// that lies entirely within a contiguous range. Returns last if there is
+// none.
+//
+// The vectorised loops compare a block of candidate positions against the
+// first and last bytes of the string at once, and only compare the rest of
+// the string at positions where both of those bytes match.
+inline const char* find_bytes(const char* first, const char* last,
+    const char* s, std::size_t n)
+{
+  if (static_cast<std::size_t>(last - first) < n)
+    return last;
+  const char* const final_pos = last - n;
+  const char* p = first;
+
+#if defined(ASIO_HAS_AVX2)
+  const __m256i first_byte = _mm256_set1_epi8(s[0]);
+  const __m256i last_byte = _mm256_set1_epi8(s[n - 1]);
+  for (; static_cast<std::size_t>(final_pos - p) >= 32; p += 32)
+  {
+    __m256i block_first = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(p));
+    __m256i block_last = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(p + n - 1));
+    unsigned int mask = static_cast<unsigned int>(_mm256_movemask_epi8(
+          _mm256_and_si256(_mm256_cmpeq_epi8(block_first, first_byte),
+            _mm256_cmpeq_epi8(block_last, last_byte))));
+    while (mask != 0)
+    {
+      unsigned int i = lowest_set_bit(mask);
+      if (std::memcmp(p + i + 1, s + 1, n - 2) == 0)
+        return p + i;
+      mask &= mask - 1;
+    }
+  }
+#elif defined(ASIO_HAS_SSE2)
+  const __m128i first_byte = _mm_set1_epi8(s[0]);
+  const __m128i last_byte = _mm_set1_epi8(s[n - 1]);
+  for (; static_cast<std::size_t>(final_pos - p) >= 16; p += 16)
+  {
+    __m128i block_first = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(p));
+    __m128i block_last = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(p + n - 1));
+    unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(
+          _mm_and_si128(_mm_cmpeq_epi8(block_first, first_byte),
+            _mm_cmpeq_epi8(block_last, last_byte))));
+    while (mask != 0)
+    {
+      unsigned int i = lowest_set_bit(mask);
+      if (std::memcmp(p + i + 1, s + 1, n - 2) == 0)
+        return p + i;
+      mask &= mask - 1;
+    }
+  }
+#endif // defined(ASIO_HAS_SSE2)
+
+  // Check the remaining positions, skipping ahead to each occurrence of the
+  // first byte.
+  for (;;)
+  {
+    p = find_byte(p, final_pos + 1, s[0]);
+    if (p > final_pos)
+      return last;
+    if (std::memcmp(p + 1, s + 1, n - 1) == 0)
+      return p;
+    ++p;
+  }
+}
+
+// Find the first occurrence of a byte in the buffer sequence [iter, end),
+// starting at the given offset. Returns (offset,true) if found, or
+// (size,false) if not.
+template <typename Iterator>
+std::pair<std::size_t, bool> buffer_sequence_find(
+    Iterator iter, Iterator end, std::size_t start, char c)
+{
+  std::size_t offset = 0;
+  for (; iter != end; ++iter)
+  {
+    const_buffer b(*iter);
+    const char* data = static_cast<const char*>(b.data());
+    std::size_t size = b.size();
+    if (start < offset + size)
+    {
+      const char* first = data + (start > offset ? start - offset : 0);
+      const char* p = find_byte(first, data + size, c);
+      if (p != data + size)
+        return std::make_pair(offset + (p - data), true);
+    }
+    offset += size;
+  }
+  return std::make_pair(offset, false);
+}
+
+// Compare a string of n bytes against a buffer sequence, starting at the
+// given position within the given segment. Returns 1 if the whole string
+// matches, 0 if the sequence ends after matching a prefix of the string, or -1
+// if there is a difference.
+template <typename Iterator>
+int buffer_sequence_compare(Iterator iter, Iterator end,
+    std::size_t pos, const char* s, std::size_t n)
+{
+  std::size_t matched = 0;
+  for (; iter != end; ++iter, pos = 0)
+  {
+    const_buffer b(*iter);
+    const char* data = static_cast<const char*>(b.data());
+    for (std::size_t i = pos; i < b.size(); ++i, ++matched)
+    {
+      if (matched == n)
+        return 1;
+      if (data[i] != s[matched])
+        return -1;
+    }
+  }
+  return matched == n ? 1 : 0;
+}
+
+// Find the first occurrence of a string of n bytes in the buffer sequence
+// [iter, end), starting at the given offset. Returns (offset,true) for a full
+// match. Returns (offset,false) if the sequence ends with a partial match, in
+// which case the offset is that of the start of the partial match. Returns
+// (size,false) if there is no full or partial match.
+template <typename Iterator>
+std::pair<std::size_t, bool> buffer_sequence_search(Iterator iter,
+    Iterator end, std::size_t start, const char* s, std::size_t n)
+{
+  std::size_t offset = 0;
+  for (; iter != end; ++iter)
+  {
+    const_buffer b(*iter);
+    const char* data = static_cast<const char*>(b.data());
+    std::size_t size = b.size();
+    if (start < offset + size)
+    {
+      std::size_t pos = start > offset ? start - offset : 0;
+
+      // An empty string matches at the start position.
+      if (n == 0)
+        return std::make_pair(offset + pos, true);
+
+      // Look for a match that lies entirely within this segment.
+      if (size - pos >= n)
+      {
+        const char* p = n == 1
+          ? find_byte(data + pos, data + size, s[0])
+          : find_bytes(data + pos, data + size, s, n);
+        if (p != data + size)
+          return std::make_pair(offset + (p - data), true);
+        pos = size - n + 1;
+      }
+
+      // Check the positions where a match would run past the end of the
+      // segment.
+      for (; pos < size; ++pos)
+      {
+        if (data[pos] == s[0])
+        {
+          int result = buffer_sequence_compare(iter, end, pos, s, n);
+          if (result >= 0)
+            return std::make_pair(offset + pos, result > 0);
+        }
+      }
+    }
+    offset += size;
+  }
+  return std::make_pair(offset, false);
+}
+
+} // namespace detail
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // ASIO_DETAIL_BUFFER_SEARCH_HPP
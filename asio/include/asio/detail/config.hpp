@@ -1765,6 +1765,19 @@
 # endif // !defined(ASIO_DISABLE_LOCAL_SOCKETS)
 #endif // !defined(ASIO_HAS_LOCAL_SOCKETS)
 
+// Native DNS resolver.
+#if !defined(ASIO_HAS_DNS_RESOLVER)
+# if !defined(ASIO_DISABLE_DNS_RESOLVER)
+#  if !defined(ASIO_WINDOWS) \
+  && !defined(ASIO_WINDOWS_RUNTIME) \
+  && !defined(__CYGWIN__)
+#   define ASIO_HAS_DNS_RESOLVER 1
+#  endif // !defined(ASIO_WINDOWS)
+         //   && !defined(ASIO_WINDOWS_RUNTIME)
+         //   && !defined(__CYGWIN__)
+# endif // !defined(ASIO_DISABLE_DNS_RESOLVER)
+#endif // !defined(ASIO_HAS_DNS_RESOLVER)
+
 // Files.
 #if !defined(ASIO_HAS_FILE)
 # if !defined(ASIO_DISABLE_FILE)
@@ -1772,10 +1785,34 @@
 #   define ASIO_HAS_FILE 1
 #  elif defined(ASIO_HAS_IO_URING)
 #   define ASIO_HAS_FILE 1
-#  endif // defined(ASIO_HAS_IO_URING)
+#  elif !defined(ASIO_WINDOWS) \
+  && !defined(ASIO_WINDOWS_RUNTIME) \
+  && !defined(__CYGWIN__)
+#   define ASIO_HAS_FILE 1
+#  endif // !defined(ASIO_WINDOWS)
+         //   && !defined(ASIO_WINDOWS_RUNTIME)
+         //   && !defined(__CYGWIN__)
 # endif // !defined(ASIO_DISABLE_FILE)
 #endif // !defined(ASIO_HAS_FILE)
 
+// Memory-mapped files.
+#if !defined(ASIO_HAS_MAPPED_FILE)
+# if !defined(ASIO_DISABLE_MAPPED_FILE)
+#  if defined(ASIO_HAS_FILE)
+#   define ASIO_HAS_MAPPED_FILE 1
+#  endif // defined(ASIO_HAS_FILE)
+# endif // !defined(ASIO_DISABLE_MAPPED_FILE)
+#endif // !defined(ASIO_HAS_MAPPED_FILE)
+
+// Ring buffers built on memory that is mapped twice.
+#if !defined(ASIO_HAS_RING_BUFFER)
+# if !defined(ASIO_DISABLE_RING_BUFFER)
+#  if !defined(ASIO_WINDOWS_RUNTIME)
+#   define ASIO_HAS_RING_BUFFER 1
+#  endif // !defined(ASIO_WINDOWS_RUNTIME)
+# endif // !defined(ASIO_DISABLE_RING_BUFFER)
+#endif // !defined(ASIO_HAS_RING_BUFFER)
+
 // Pipes.
 #if !defined(ASIO_HAS_PIPE)
 # if defined(ASIO_HAS_IOCP) \
@@ -2185,4 +2222,31 @@
 # endif // !defined(ASIO_DISABLE_STD_TO_ADDRESS)
 #endif // !defined(ASIO_HAS_STD_TO_ADDRESS)
 
+// Lock-free implementation of the strand<> executor adapter.
+#if !defined(ASIO_HAS_LOCK_FREE_STRAND)
+# if !defined(ASIO_DISABLE_LOCK_FREE_STRAND)
+#  if defined(ASIO_HAS_STD_ATOMIC)
+#   define ASIO_HAS_LOCK_FREE_STRAND 1
+#  endif // defined(ASIO_HAS_STD_ATOMIC)
+# endif // !defined(ASIO_DISABLE_LOCK_FREE_STRAND)
+#endif // !defined(ASIO_HAS_LOCK_FREE_STRAND)
+
+// SSE2 and AVX2 instruction sets, used to search buffers for delimiters.
+#if !defined(ASIO_HAS_SSE2)
+# if !defined(ASIO_DISABLE_SSE2)
+#  if defined(__SSE2__) || defined(_M_X64) \
+    || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#   define ASIO_HAS_SSE2 1
+#  endif // defined(__SSE2__) || defined(_M_X64)
+         //   || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+# endif // !defined(ASIO_DISABLE_SSE2)
+#endif // !defined(ASIO_HAS_SSE2)
+#if !defined(ASIO_HAS_AVX2)
+# if !defined(ASIO_DISABLE_AVX2)
+#  if defined(__AVX2__)
+#   define ASIO_HAS_AVX2 1
+#  endif // defined(__AVX2__)
+# endif // !defined(ASIO_DISABLE_AVX2)
+#endif // !defined(ASIO_HAS_AVX2)
+
 #endif // ASIO_DETAIL_CONFIG_HPP
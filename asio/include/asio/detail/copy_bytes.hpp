@@ -0,0 +1,126 @@
+//
+// detail/copy_bytes.hpp
+// ~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_DETAIL_COPY_BYTES_HPP
+#define ASIO_DETAIL_COPY_BYTES_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+#include <cstddef>
+#include <cstring>
+#include "asio/detail/cstdint.hpp"
+
+#if defined(ASIO_HAS_SSE2)
+# include <emmintrin.h>
+#endif // defined(ASIO_HAS_SSE2)
+
+#include "asio/detail/push_options.hpp"
+
+namespace ASIO_LIBNS {
+namespace detail {
+
+// Copies of at least this many bytes bypass the cache. Zero disables this.
+#ifndef ASIO_NON_TEMPORAL_COPY_THRESHOLD
+# define ASIO_NON_TEMPORAL_COPY_THRESHOLD (4 * 1024 * 1024)
+#endif // ASIO_NON_TEMPORAL_COPY_THRESHOLD
+
+#if defined(ASIO_HAS_SSE2) && (ASIO_NON_TEMPORAL_COPY_THRESHOLD > 0)
+
+// Copy a large block using stores that do not allocate cache lines, so that a
+// copy larger than the cache does not evict the rest of the working set.
+inline void copy_bytes_non_temporal(unsigned char* target,
+    const unsigned char* source, std::size_t n)
+{
+  // Copy normally up to the first 16-byte boundary in the target.
+  std::size_t head = (16 - (reinterpret_cast<uintptr_t>(target) & 15)) & 15;
+  std::memcpy(target, source, head);
+  target += head;
+  source += head;
+  n -= head;
+
+  for (; n >= 64; n -= 64, target += 64, source += 64)
+  {
+    const __m128i* s = reinterpret_cast<const __m128i*>(source);
+    __m128i* t = reinterpret_cast<__m128i*>(target);
+    __m128i a = _mm_loadu_si128(s);
+    __m128i b = _mm_loadu_si128(s + 1);
+    __m128i c = _mm_loadu_si128(s + 2);
+    __m128i d = _mm_loadu_si128(s + 3);
+    _mm_stream_si128(t, a);
+    _mm_stream_si128(t + 1, b);
+    _mm_stream_si128(t + 2, c);
+    _mm_stream_si128(t + 3, d);
+  }
+
+  // Order the streaming stores before any later stores.
+  _mm_sfence();
+
+  std::memcpy(target, source, n);
+}
+
+#endif // defined(ASIO_HAS_SSE2) && (ASIO_NON_TEMPORAL_COPY_THRESHOLD > 0)
+
+// Copy bytes between non-overlapping regions, choosing a method to suit the
+// size of the copy.
+inline void copy_bytes(void* target, const void* source, std::size_t n)
+{
+  unsigned char* t = static_cast<unsigned char*>(target);
+  const unsigned char* s = static_cast<const unsigned char*>(source);
+
+  // Small copies use at most two overlapping fixed-size moves, which the
+  // compiler can inline, rather than a call into the C library.
+  if (n <= 16)
+  {
+    if (n >= 8)
+    {
+      uint64_t first, last;
+      std::memcpy(&first, s, 8);
+      std::memcpy(&last, s + n - 8, 8);
+      std::memcpy(t, &first, 8);
+      std::memcpy(t + n - 8, &last, 8);
+    }
+    else if (n >= 4)
+    {
+      uint32_t first, last;
+      std::memcpy(&first, s, 4);
+      std::memcpy(&last, s + n - 4, 4);
+      std::memcpy(t, &first, 4);
+      std::memcpy(t + n - 4, &last, 4);
+    }
+    else if (n > 0)
+    {
+      unsigned char first = s[0], middle = s[n / 2], last = s[n - 1];
+      t[0] = first;
+      t[n / 2] = middle;
+      t[n - 1] = last;
+    }
+    return;
+  }
+
+#if defined(ASIO_HAS_SSE2) && (ASIO_NON_TEMPORAL_COPY_THRESHOLD > 0)
+  if (n >= static_cast<std::size_t>(ASIO_NON_TEMPORAL_COPY_THRESHOLD))
+  {
+    copy_bytes_non_temporal(t, s, n);
+    return;
+  }
+#endif // defined(ASIO_HAS_SSE2) && (ASIO_NON_TEMPORAL_COPY_THRESHOLD > 0)
+
+  std::memcpy(t, s, n);
+}
+
+} // namespace detail
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // ASIO_DETAIL_COPY_BYTES_HPP
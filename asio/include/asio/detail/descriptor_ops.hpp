@@ -143,6 +143,35 @@ ASIO_DECL bool non_blocking_write_at1(int d,
     uint64_t offset, const void* data, std::size_t size,
     ASIO_LIBNS::error_code& ec, std::size_t& bytes_transferred);
 
+// Read from a file without waiting for data that is not in the page cache.
+// Returns false if the read must instead be performed by a blocking call.
+ASIO_DECL bool nowait_read(int d, buf* bufs, std::size_t count,
+    ASIO_LIBNS::error_code& ec, std::size_t& bytes_transferred);
+
+ASIO_DECL bool nowait_read_at(int d, uint64_t offset,
+    buf* bufs, std::size_t count, ASIO_LIBNS::error_code& ec,
+    std::size_t& bytes_transferred);
+
+ASIO_DECL int fsync(int d, ASIO_LIBNS::error_code& ec);
+
+ASIO_DECL int fdatasync(int d, ASIO_LIBNS::error_code& ec);
+
+ASIO_DECL int ftruncate(int d, uint64_t n, ASIO_LIBNS::error_code& ec);
+
+// Allocate disk space for the given range, extending the file if necessary.
+ASIO_DECL int fallocate(int d, uint64_t offset,
+    uint64_t length, ASIO_LIBNS::error_code& ec);
+
+ASIO_DECL uint64_t file_size(int d, ASIO_LIBNS::error_code& ec);
+
+// Get the alignment of offsets, lengths and memory for direct I/O.
+ASIO_DECL std::size_t file_alignment(int d, ASIO_LIBNS::error_code& ec);
+
+// Copy data between two files at the same offset, within the kernel where
+// possible. Returns the number of bytes copied, which is 0 at end of file.
+ASIO_DECL std::size_t sync_copy_at(int s, int d, uint64_t offset,
+    std::size_t size, ASIO_LIBNS::error_code& ec);
+
 #endif // defined(ASIO_HAS_FILE)
 
 ASIO_DECL int ioctl(int d, state_type& state, long cmd,
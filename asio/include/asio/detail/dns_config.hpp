@@ -0,0 +1,108 @@
+//
+// detail/dns_config.hpp
+// ~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_DETAIL_DNS_CONFIG_HPP
+#define ASIO_DETAIL_DNS_CONFIG_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+
+#if defined(ASIO_HAS_DNS_RESOLVER)
+
+#include <istream>
+#include <map>
+#include <string>
+#include <vector>
+#include "asio/ip/address.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace ASIO_LIBNS {
+namespace detail {
+
+// The resolver configuration, as read from resolv.conf and the hosts file.
+struct dns_config
+{
+  // A server to which queries are sent.
+  struct name_server
+  {
+    ASIO_LIBNS::ip::address address;
+    unsigned short port;
+  };
+
+  // An address listed in the hosts file.
+  struct host_entry
+  {
+    ASIO_LIBNS::ip::address address;
+    std::string canonical_name;
+  };
+
+  // Construct a configuration using the defaults that apply when resolv.conf
+  // is empty.
+  ASIO_DECL dns_config();
+
+  // Load the configuration from the given files. A missing file leaves the
+  // corresponding defaults in place.
+  ASIO_DECL void load(const std::string& resolv_conf_path,
+      const std::string& hosts_path);
+
+  // Parse the contents of resolv.conf. Unrecognised lines are ignored.
+  ASIO_DECL void parse_resolv_conf(std::istream& is);
+
+  // Parse the contents of a hosts file.
+  ASIO_DECL void parse_hosts(std::istream& is);
+
+  // Find the hosts file entries for a name.
+  ASIO_DECL const std::vector<host_entry>* find_host(
+      const std::string& name) const;
+
+  // Find the hosts file name for an address.
+  ASIO_DECL const std::string* find_address(
+      const ASIO_LIBNS::ip::address& address) const;
+
+  // The servers to query, in order.
+  std::vector<name_server> name_servers;
+
+  // The domains to append to names with fewer than ndots dots.
+  std::vector<std::string> search;
+  int ndots;
+
+  // The number of seconds to wait for each server, and the number of times
+  // each server is tried.
+  int timeout;
+  int attempts;
+
+  // Whether queries should be spread across the servers.
+  bool rotate;
+
+  // Whether the host has any non-loopback IPv4 or IPv6 addresses.
+  bool ipv4_configured;
+  bool ipv6_configured;
+
+  // The hosts file, indexed by lower case name and by address.
+  std::map<std::string, std::vector<host_entry> > hosts_by_name;
+  std::map<ASIO_LIBNS::ip::address, std::string> hosts_by_address;
+};
+
+} // namespace detail
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#if defined(ASIO_HEADER_ONLY)
+# include "asio/detail/impl/dns_config.ipp"
+#endif // defined(ASIO_HEADER_ONLY)
+
+#endif // defined(ASIO_HAS_DNS_RESOLVER)
+
+#endif // ASIO_DETAIL_DNS_CONFIG_HPP
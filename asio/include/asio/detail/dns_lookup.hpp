@@ -0,0 +1,227 @@
+//
+// detail/dns_lookup.hpp
+// ~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_DETAIL_DNS_LOOKUP_HPP
+#define ASIO_DETAIL_DNS_LOOKUP_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+
+#if defined(ASIO_HAS_DNS_RESOLVER)
+
+#include <limits>
+#include <string>
+#include <vector>
+#include "asio/any_io_executor.hpp"
+#include "asio/error.hpp"
+#include "asio/detail/dns_config.hpp"
+#include "asio/detail/dns_random.hpp"
+#include "asio/detail/memory.hpp"
+#include "asio/detail/mutex.hpp"
+#include "asio/detail/noncopyable.hpp"
+#include "asio/detail/resolve_op.hpp"
+#include "asio/detail/scheduler.hpp"
+#include "asio/ip/address.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace ASIO_LIBNS {
+namespace detail {
+
+// The outcome of a lookup.
+struct dns_lookup_result
+{
+  dns_lookup_result()
+    : ttl((std::numeric_limits<unsigned long>::max)())
+  {
+  }
+
+  // The addresses found for a host name.
+  std::vector<ASIO_LIBNS::ip::address> addresses;
+
+  // The canonical name of a host, or the name found for an address.
+  std::string host_name;
+
+  // The number of seconds for which the outcome may be cached. There is no
+  // limit on an outcome that did not come from a name server.
+  unsigned long ttl;
+};
+
+// Base class for resolver operations completed by a dns_lookup.
+class dns_resolve_op : public resolve_op
+{
+public:
+  // The result to be delivered to the completion handler.
+  dns_lookup_result result_;
+
+protected:
+  dns_resolve_op(func_type complete_func)
+    : resolve_op(complete_func)
+  {
+  }
+};
+
+// A single forward or reverse lookup, performed by sending queries to the
+// configured name servers. All work is performed on a strand of the I/O
+// executor, and the lookup is kept alive by its outstanding handlers.
+class dns_lookup
+  : private noncopyable
+{
+public:
+  // The set of lookups started by one resolver, used to cancel them.
+  class registry
+    : private noncopyable
+  {
+  public:
+    // Add a lookup, discarding those that have finished.
+    ASIO_DECL void add(const shared_ptr<dns_lookup>& lookup);
+
+    // Cancel all outstanding lookups.
+    ASIO_DECL void cancel();
+
+  private:
+    mutex mutex_;
+    std::vector<weak_ptr<dns_lookup> > lookups_;
+  };
+
+  // Construct a lookup. On completion, the result is stored in op, if any,
+  // which is then passed to the scheduler.
+  ASIO_DECL dns_lookup(const ASIO_LIBNS::any_io_executor& io_ex,
+      const shared_ptr<const dns_config>& config,
+      const shared_ptr<dns_random>& random, scheduler* sched, dns_resolve_op* op);
+
+  // Destructor. Destroys the operation if the lookup was abandoned.
+  ASIO_DECL ~dns_lookup();
+
+  // Start resolving a host name to the addresses of the given family, or of
+  // both families if family is AF_UNSPEC, according to the resolver flags.
+  ASIO_DECL static void start_query(const shared_ptr<dns_lookup>& lookup,
+      const std::string& host_name, int family, int flags);
+
+  // Start resolving an address to a host name.
+  ASIO_DECL static void start_reverse(const shared_ptr<dns_lookup>& lookup,
+      const ASIO_LIBNS::ip::address& address);
+
+  // Cancel the lookup. May be called from any thread.
+  ASIO_DECL static void cancel(const shared_ptr<dns_lookup>& lookup);
+
+  // Get the result of a completed lookup that has no associated operation.
+  const dns_lookup_result& result() const
+  {
+    return result_;
+  }
+
+  // Get the error of a completed lookup that has no associated operation.
+  const ASIO_LIBNS::error_code& error() const
+  {
+    return ec_;
+  }
+
+private:
+  // A query for one name and record type, retried across the servers.
+  struct transaction;
+
+  // Handlers used to start and cancel the lookup, and to complete the
+  // asynchronous operations of a transaction.
+  struct start_handler;
+  struct cancel_handler;
+  struct transaction_handler;
+
+  // Handle completion of an asynchronous operation of a transaction.
+  ASIO_DECL void handle_event(const shared_ptr<transaction>& t, int event,
+      const ASIO_LIBNS::error_code& ec, std::size_t bytes_transferred);
+
+  // Check the hosts file and then start querying the name servers.
+  ASIO_DECL void start();
+
+  // Start the queries for the next search candidate.
+  ASIO_DECL void next_candidate();
+
+  // Start the next try of a transaction, or record its failure if all tries
+  // have been used.
+  ASIO_DECL void next_try(const shared_ptr<transaction>& t);
+
+  // Start a try of a transaction over TCP.
+  ASIO_DECL void start_tcp(const shared_ptr<transaction>& t);
+
+  // Handle a response received for a transaction.
+  ASIO_DECL void handle_response(const shared_ptr<transaction>& t,
+      const unsigned char* data, std::size_t size, bool over_tcp);
+
+  // Record the outcome of a transaction, and evaluate the candidate once all
+  // of its transactions have finished.
+  ASIO_DECL void transaction_done(transaction& t, int outcome);
+
+  // Complete the lookup.
+  ASIO_DECL void finish(const ASIO_LIBNS::error_code& ec);
+
+  // Get a handler for an asynchronous operation of a transaction.
+  ASIO_DECL transaction_handler make_handler(
+      const shared_ptr<transaction>& t, int event);
+
+  // The lookup itself, used to keep it alive while operations are pending.
+  weak_ptr<dns_lookup> self_;
+
+  // The strand on which the lookup runs.
+  ASIO_LIBNS::any_io_executor executor_;
+
+  // The configuration in effect when the lookup was started.
+  shared_ptr<const dns_config> config_;
+
+  // The source used to choose query IDs and the first server.
+  shared_ptr<dns_random> random_;
+
+  // The scheduler and operation to be completed, if any.
+  scheduler* scheduler_;
+  dns_resolve_op* op_;
+
+  // The names to query, the current candidate, and the requested families
+  // and flags.
+  std::vector<std::string> candidates_;
+  std::size_t candidate_;
+  int family_;
+  int flags_;
+  std::string host_name_;
+  bool reverse_;
+  ASIO_LIBNS::ip::address reverse_address_;
+
+  // The transactions for the current candidate.
+  std::vector<shared_ptr<transaction> > transactions_;
+  std::size_t pending_;
+
+  // The most severe failure seen across the candidates.
+  int failure_;
+
+  // The smallest TTL of the negative answers seen across the candidates.
+  unsigned long negative_ttl_;
+
+  // Whether the lookup has finished.
+  bool finished_;
+
+  // The result of the lookup.
+  dns_lookup_result result_;
+  ASIO_LIBNS::error_code ec_;
+};
+
+} // namespace detail
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#if defined(ASIO_HEADER_ONLY)
+# include "asio/detail/impl/dns_lookup.ipp"
+#endif // defined(ASIO_HEADER_ONLY)
+
+#endif // defined(ASIO_HAS_DNS_RESOLVER)
+
+#endif // ASIO_DETAIL_DNS_LOOKUP_HPP
@@ -0,0 +1,134 @@
+//
+// detail/dns_message.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_DETAIL_DNS_MESSAGE_HPP
+#define ASIO_DETAIL_DNS_MESSAGE_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+
+#if defined(ASIO_HAS_DNS_RESOLVER)
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "asio/ip/address.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace ASIO_LIBNS {
+namespace detail {
+
+// Construction of DNS queries and parsing of the responses, as described in
+// RFC 1035. Only the record types needed for host name resolution are
+// understood.
+class dns_message
+{
+public:
+  // Record types.
+  enum record_type
+  {
+    type_a = 1,
+    type_cname = 5,
+    type_ptr = 12,
+    type_aaaa = 28
+  };
+
+  // Response codes.
+  enum response_code
+  {
+    no_error = 0,
+    format_error = 1,
+    server_failure = 2,
+    name_error = 3,
+    not_implemented = 4,
+    refused = 5
+  };
+
+  // The largest message that may be sent or received over UDP.
+  enum { max_udp_size = 512 };
+
+  // Build a recursive query for the given name and record type. Returns false
+  // if the name cannot be encoded.
+  ASIO_DECL static bool build_query(unsigned short id,
+      const std::string& name, int type, std::vector<unsigned char>& query);
+
+  // Parse a response to a query built by build_query. Returns false if the
+  // response is malformed or does not answer the query.
+  ASIO_DECL bool parse_response(const unsigned char* data,
+      std::size_t size, unsigned short id,
+      const std::string& name, int type);
+
+  // Whether the response was truncated and should be retried over TCP.
+  bool truncated() const
+  {
+    return truncated_;
+  }
+
+  // The response code.
+  int rcode() const
+  {
+    return rcode_;
+  }
+
+  // The addresses found for the queried name, following any CNAME records.
+  const std::vector<ASIO_LIBNS::ip::address>& addresses() const
+  {
+    return addresses_;
+  }
+
+  // The name at the end of any CNAME chain, or the target of a PTR record.
+  const std::string& name() const
+  {
+    return name_;
+  }
+
+  // The smallest TTL, in seconds, of the records used in the answer.
+  unsigned long ttl() const
+  {
+    return ttl_;
+  }
+
+  // Get the name under which PTR records for the given address are found.
+  ASIO_DECL static std::string reverse_name(
+      const ASIO_LIBNS::ip::address& addr);
+
+  // Compare two domain names, ignoring case and any trailing dot.
+  ASIO_DECL static bool names_equal(
+      const std::string& a, const std::string& b);
+
+private:
+  // Read a possibly compressed domain name starting at pos, advancing pos past
+  // it. Returns false if the name is malformed.
+  static bool read_name(const unsigned char* data, std::size_t size,
+      std::size_t& pos, std::string& name);
+
+  bool truncated_;
+  int rcode_;
+  std::vector<ASIO_LIBNS::ip::address> addresses_;
+  std::string name_;
+  unsigned long ttl_;
+};
+
+} // namespace detail
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#if defined(ASIO_HEADER_ONLY)
+# include "asio/detail/impl/dns_message.ipp"
+#endif // defined(ASIO_HEADER_ONLY)
+
+#endif // defined(ASIO_HAS_DNS_RESOLVER)
+
+#endif // ASIO_DETAIL_DNS_MESSAGE_HPP
@@ -0,0 +1,72 @@
+//
+// detail/dns_random.hpp
+// ~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_DETAIL_DNS_RANDOM_HPP
+#define ASIO_DETAIL_DNS_RANDOM_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+
+#if defined(ASIO_HAS_DNS_RESOLVER)
+
+#include <cstddef>
+#include "asio/detail/mutex.hpp"
+#include "asio/detail/noncopyable.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace ASIO_LIBNS {
+namespace detail {
+
+// Unpredictable values for query IDs and server selection. The values are
+// read from the operating system's random number generator in batches, so
+// that each query does not need a system call.
+class dns_random
+  : private noncopyable
+{
+public:
+  // Constructor.
+  ASIO_DECL dns_random();
+
+  // Get a random 16-bit value. Thread-safe.
+  ASIO_DECL unsigned short next();
+
+  // Discard any buffered values, e.g. so that a forked child does not repeat
+  // the values used by its parent.
+  ASIO_DECL void reset();
+
+private:
+  // Refill the buffer. Must be called with the mutex held.
+  ASIO_DECL void refill();
+
+  // Mutex to protect access to the buffer.
+  ASIO_LIBNS::detail::mutex mutex_;
+
+  // The buffered random bytes, and the number already used.
+  enum { buffer_size = 256 };
+  unsigned char buffer_[buffer_size];
+  std::size_t used_;
+};
+
+} // namespace detail
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#if defined(ASIO_HEADER_ONLY)
+# include "asio/detail/impl/dns_random.ipp"
+#endif // defined(ASIO_HEADER_ONLY)
+
+#endif // defined(ASIO_HAS_DNS_RESOLVER)
+
+#endif // ASIO_DETAIL_DNS_RANDOM_HPP
@@ -0,0 +1,554 @@
+//
+// detail/dns_resolver_service.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_DETAIL_DNS_RESOLVER_SERVICE_HPP
+#define ASIO_DETAIL_DNS_RESOLVER_SERVICE_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+
+#if defined(ASIO_HAS_DNS_RESOLVER)
+
+#include <vector>
+#include "asio/associated_cancellation_slot.hpp"
+#include "asio/cancellation_type.hpp"
+#include "asio/ip/basic_resolver_query.hpp"
+#include "asio/ip/basic_resolver_results.hpp"
+#include "asio/detail/bind_handler.hpp"
+#include "asio/detail/dns_resolver_service_base.hpp"
+#include "asio/detail/fenced_block.hpp"
+#include "asio/detail/handler_alloc_helpers.hpp"
+#include "asio/detail/handler_invoke_helpers.hpp"
+#include "asio/detail/handler_work.hpp"
+#include "asio/detail/memory.hpp"
+#include "asio/detail/op_queue.hpp"
+#include "asio/detail/resolve_cached_op.hpp"
+#include "asio/detail/resolver_cache.hpp"
+
+#if !defined(ASIO_DNS_RESOLV_CONF_PATH)
+# define ASIO_DNS_RESOLV_CONF_PATH "/etc/resolv.conf"
+#endif // !defined(ASIO_DNS_RESOLV_CONF_PATH)
+
+#if !defined(ASIO_DNS_HOSTS_PATH)
+# define ASIO_DNS_HOSTS_PATH "/etc/hosts"
+#endif // !defined(ASIO_DNS_HOSTS_PATH)
+
+#include "asio/detail/push_options.hpp"
+
+namespace ASIO_LIBNS {
+namespace detail {
+
+// Resolves host names by sending queries to the name servers listed in
+// resolv.conf, using the reactor rather than a background thread.
+template <typename Protocol>
+class dns_resolver_service :
+  public execution_context_service_base<dns_resolver_service<Protocol> >,
+  public dns_resolver_service_base
+{
+public:
+  // The endpoint type.
+  typedef typename Protocol::endpoint endpoint_type;
+
+  // The query type.
+  typedef ASIO_LIBNS::ip::basic_resolver_query<Protocol> query_type;
+
+  // The results type.
+  typedef ASIO_LIBNS::ip::basic_resolver_results<Protocol> results_type;
+
+  // Constructor.
+  dns_resolver_service(execution_context& context)
+    : execution_context_service_base<dns_resolver_service<Protocol> >(context),
+      dns_resolver_service_base(context,
+          ASIO_DNS_RESOLV_CONF_PATH, ASIO_DNS_HOSTS_PATH)
+  {
+    this->construct(cache_lookups_);
+  }
+
+  // Destroy all user-defined handler objects owned by the service.
+  void shutdown()
+  {
+    this->base_shutdown();
+
+    op_queue<operation> ops;
+    cache_.shutdown(ops);
+  }
+
+  // Perform any fork-related housekeeping.
+  void notify_fork(execution_context::fork_event fork_ev)
+  {
+    this->base_notify_fork(fork_ev);
+  }
+
+  // Destroy a resolver implementation.
+  void destroy(implementation_type& impl)
+  {
+    cancel_cached(impl);
+    dns_resolver_service_base::destroy(impl);
+  }
+
+  // Move-assign from another resolver implementation.
+  void move_assign(implementation_type& impl,
+      dns_resolver_service_base& other_service,
+      implementation_type& other_impl)
+  {
+    cancel_cached(impl);
+    dns_resolver_service_base::move_assign(impl, other_service, other_impl);
+  }
+
+  // Cancel pending asynchronous operations.
+  void cancel(implementation_type& impl)
+  {
+    cancel_cached(impl);
+    dns_resolver_service_base::cancel(impl);
+  }
+
+  // Set the options of the cache of forward resolution results.
+  void set_cache_options(std::size_t max_entries,
+      long max_lifetime, long negative_lifetime)
+  {
+    cache_.set_options(max_entries, max_lifetime, negative_lifetime);
+  }
+
+  // Resolve a query to a list of entries.
+  results_type resolve(implementation_type&, const query_type& qry,
+      ASIO_LIBNS::error_code& ec)
+  {
+    results_type results;
+    if (cache_.find(qry, results, ec))
+    {
+      ASIO_ERROR_LOCATION(ec);
+      return results;
+    }
+
+    dns_lookup_result result;
+    unsigned short port = 0;
+    this->do_resolve(qry.host_name(), qry.service_name(),
+        qry.hints(), result, port, ec);
+
+    if (!ec)
+    {
+      results = make_results(result, port, qry.hints().ai_flags,
+          qry.host_name(), qry.service_name());
+    }
+    cache_.store(qry, results, ec, result.ttl);
+
+    ASIO_ERROR_LOCATION(ec);
+    return results;
+  }
+
+  // Asynchronously resolve a query to a list of entries.
+  template <typename Handler, typename IoExecutor>
+  void async_resolve(implementation_type& impl, const query_type& qry,
+      Handler& handler, const IoExecutor& io_ex)
+  {
+    if (cache_.enabled())
+    {
+      async_resolve_cached(impl, qry, handler, io_ex);
+      return;
+    }
+
+    typename associated_cancellation_slot<Handler>::type slot
+      = ASIO_LIBNS::get_associated_cancellation_slot(handler);
+
+    // Allocate and construct an operation to wrap the handler.
+    typedef query_op<Handler, IoExecutor> op;
+    typename op::ptr p = { ASIO_LIBNS::detail::addressof(handler),
+      op::ptr::allocate(handler), 0 };
+    p.p = new (p.v) op(qry, handler, io_ex);
+
+    ASIO_HANDLER_CREATION((scheduler_.context(),
+          *p.p, "resolver", &impl, 0, "async_resolve"));
+
+    shared_ptr<dns_lookup> lookup = this->begin_resolve(impl,
+        qry.host_name(), qry.service_name(), qry.hints(),
+        p.p, p.p->port_, ASIO_LIBNS::any_io_executor(io_ex));
+    p.v = p.p = 0;
+
+    if (lookup)
+    {
+      // Optionally register for per-operation cancellation.
+      if (slot.is_connected())
+        slot.template emplace<dns_cancellation>(lookup);
+
+      dns_lookup::start_query(lookup, qry.host_name(),
+          qry.hints().ai_family, qry.hints().ai_flags);
+    }
+  }
+
+  // Resolve an endpoint to a list of entries.
+  results_type resolve(implementation_type&,
+      const endpoint_type& endpoint, ASIO_LIBNS::error_code& ec)
+  {
+    dns_lookup_result result;
+    std::string service_name;
+    this->do_resolve(endpoint.address(), endpoint.port(),
+        endpoint.protocol().type(), result, service_name, ec);
+
+    ASIO_ERROR_LOCATION(ec);
+    return ec ? results_type() : results_type::create(
+        endpoint, result.host_name, service_name);
+  }
+
+  // Asynchronously resolve an endpoint to a list of entries.
+  template <typename Handler, typename IoExecutor>
+  void async_resolve(implementation_type& impl, const endpoint_type& endpoint,
+      Handler& handler, const IoExecutor& io_ex)
+  {
+    typename associated_cancellation_slot<Handler>::type slot
+      = ASIO_LIBNS::get_associated_cancellation_slot(handler);
+
+    // Allocate and construct an operation to wrap the handler.
+    typedef endpoint_op<Handler, IoExecutor> op;
+    typename op::ptr p = { ASIO_LIBNS::detail::addressof(handler),
+      op::ptr::allocate(handler), 0 };
+    p.p = new (p.v) op(endpoint, handler, io_ex);
+
+    ASIO_HANDLER_CREATION((scheduler_.context(),
+          *p.p, "resolver", &impl, 0, "async_resolve"));
+
+    shared_ptr<dns_lookup> lookup = this->begin_resolve(impl,
+        endpoint.address(), endpoint.port(), endpoint.protocol().type(),
+        p.p, p.p->service_name_, ASIO_LIBNS::any_io_executor(io_ex));
+    p.v = p.p = 0;
+
+    if (lookup)
+    {
+      // Optionally register for per-operation cancellation.
+      if (slot.is_connected())
+        slot.template emplace<dns_cancellation>(lookup);
+
+      dns_lookup::start_reverse(lookup, endpoint.address());
+    }
+  }
+
+private:
+  typedef resolver_cache<Protocol> cache_type;
+
+  // Asynchronously resolve a query using the cache.
+  template <typename Handler, typename IoExecutor>
+  void async_resolve_cached(implementation_type& impl,
+      const query_type& qry, Handler& handler, const IoExecutor& io_ex)
+  {
+    typename associated_cancellation_slot<Handler>::type slot
+      = ASIO_LIBNS::get_associated_cancellation_slot(handler);
+
+    // Allocate and construct an operation to wrap the handler.
+    typedef resolve_cached_op<Protocol, Handler, IoExecutor> op;
+    typename op::ptr p = { ASIO_LIBNS::detail::addressof(handler),
+      op::ptr::allocate(handler), 0 };
+    p.p = new (p.v) op(impl, handler, io_ex);
+
+    ASIO_HANDLER_CREATION((scheduler_.context(),
+          *p.p, "resolver", &impl, 0, "async_resolve"));
+
+    // Optionally register for per-operation cancellation.
+    if (slot.is_connected())
+      slot.template emplace<cache_cancellation>(this, p.p);
+
+    typename cache_type::start_result result = cache_.start(qry, p.p);
+    if (result == cache_type::cached)
+    {
+      scheduler_.post_immediate_completion(p.p, false);
+      p.v = p.p = 0;
+      return;
+    }
+
+    // The operation is now owned by the cache.
+    p.v = p.p = 0;
+    scheduler_.work_started();
+    if (result == cache_type::lookup_required)
+    {
+      cache_lookup_op* o = new cache_lookup_op(qry, cache_, scheduler_);
+      shared_ptr<dns_lookup> lookup = this->begin_resolve(cache_lookups_,
+          qry.host_name(), qry.service_name(), qry.hints(),
+          o, o->port_, ASIO_LIBNS::any_io_executor(io_ex));
+      if (lookup)
+      {
+        dns_lookup::start_query(lookup, qry.host_name(),
+            qry.hints().ai_family, qry.hints().ai_flags);
+      }
+    }
+  }
+
+  // Complete with operation_aborted any operations started by the resolver
+  // that are waiting for a lookup in the cache.
+  void cancel_cached(implementation_type& impl)
+  {
+    op_queue<operation> ops;
+    cache_.cancel(impl, ops);
+    scheduler_.post_deferred_completions(ops);
+  }
+
+  // Build the results of a forward lookup.
+  static results_type make_results(const dns_lookup_result& result,
+      unsigned short port, int flags, const std::string& host_name,
+      const std::string& service_name)
+  {
+    std::vector<endpoint_type> endpoints;
+    for (std::size_t i = 0; i < result.addresses.size(); ++i)
+      endpoints.push_back(endpoint_type(result.addresses[i], port));
+
+    const std::string& actual_host_name =
+      (flags & ASIO_OS_DEF(AI_CANONNAME)) && !result.host_name.empty()
+        ? result.host_name : host_name;
+    return results_type::create(endpoints.begin(),
+        endpoints.end(), actual_host_name, service_name);
+  }
+
+  // Cancellation handler that cancels a lookup.
+  class dns_cancellation
+  {
+  public:
+    explicit dns_cancellation(const shared_ptr<dns_lookup>& lookup)
+      : lookup_(lookup)
+    {
+    }
+
+    void operator()(cancellation_type_t type)
+    {
+      if (!!(type &
+            (cancellation_type::terminal
+              | cancellation_type::partial
+              | cancellation_type::total)))
+      {
+        if (shared_ptr<dns_lookup> lookup = lookup_.lock())
+          dns_lookup::cancel(lookup);
+      }
+    }
+
+  private:
+    weak_ptr<dns_lookup> lookup_;
+  };
+
+  // Cancellation handler that removes an operation waiting for a lookup in
+  // the cache.
+  class cache_cancellation
+  {
+  public:
+    cache_cancellation(dns_resolver_service* service,
+        resolver_cache_op<Protocol>* op)
+      : service_(service),
+        op_(op)
+    {
+    }
+
+    void operator()(cancellation_type_t type)
+    {
+      if (!!(type &
+            (cancellation_type::terminal
+              | cancellation_type::partial
+              | cancellation_type::total)))
+      {
+        op_queue<operation> ops;
+        service_->cache_.cancel_op(op_, ops);
+        service_->scheduler_.post_deferred_completions(ops);
+      }
+    }
+
+  private:
+    dns_resolver_service* service_;
+    resolver_cache_op<Protocol>* op_;
+  };
+
+  // Operation used to perform a lookup on behalf of the cache. The lookup is
+  // not cancelled when the resolver that started it is cancelled.
+  class cache_lookup_op : public dns_resolve_op
+  {
+  public:
+    cache_lookup_op(const query_type& qry,
+        cache_type& cache, scheduler_impl& sched)
+      : dns_resolve_op(&cache_lookup_op::do_complete),
+        port_(0),
+        query_(qry),
+        cache_(cache),
+        scheduler_(sched)
+    {
+    }
+
+    static void do_complete(void* owner, operation* base,
+        const ASIO_LIBNS::error_code& /*ec*/,
+        std::size_t /*bytes_transferred*/)
+    {
+      cache_lookup_op* o(static_cast<cache_lookup_op*>(base));
+      if (owner)
+      {
+        results_type results;
+        if (!o->ec_)
+        {
+          results = make_results(o->result_, o->port_,
+              o->query_.hints().ai_flags, o->query_.host_name(),
+              o->query_.service_name());
+        }
+
+        // Pass the waiting operations on for completion.
+        op_queue<operation> ops;
+        o->cache_.complete(o->query_, results, o->ec_, o->result_.ttl, ops);
+        o->scheduler_.post_deferred_completions(ops);
+      }
+      delete o;
+    }
+
+    // The port for the service.
+    unsigned short port_;
+
+  private:
+    query_type query_;
+    cache_type& cache_;
+    scheduler_impl& scheduler_;
+  };
+
+  // Operation used to resolve a query.
+  template <typename Handler, typename IoExecutor>
+  class query_op : public dns_resolve_op
+  {
+  public:
+    ASIO_DEFINE_HANDLER_PTR(query_op);
+
+    query_op(const query_type& qry, Handler& handler,
+        const IoExecutor& io_ex)
+      : dns_resolve_op(&query_op::do_complete),
+        port_(0),
+        query_(qry),
+        handler_(ASIO_MOVE_CAST(Handler)(handler)),
+        work_(handler_, io_ex)
+    {
+    }
+
+    static void do_complete(void* owner, operation* base,
+        const ASIO_LIBNS::error_code& /*ec*/,
+        std::size_t /*bytes_transferred*/)
+    {
+      // Take ownership of the operation object.
+      query_op* o(static_cast<query_op*>(base));
+      ptr p = { ASIO_LIBNS::detail::addressof(o->handler_), o, o };
+
+      ASIO_HANDLER_COMPLETION((*o));
+
+      // Take ownership of the operation's outstanding work.
+      handler_work<Handler, IoExecutor> w(
+          ASIO_MOVE_CAST2(handler_work<Handler, IoExecutor>)(
+            o->work_));
+
+      // Make a copy of the handler so that the memory can be deallocated
+      // before the upcall is made. Even if we're not about to make an upcall,
+      // a sub-object of the handler may be the true owner of the memory
+      // associated with the handler. Consequently, a local copy of the handler
+      // is required to ensure that any owning sub-object remains valid until
+      // after we have deallocated the memory here.
+      detail::binder2<Handler, ASIO_LIBNS::error_code, results_type>
+        handler(o->handler_, o->ec_, results_type());
+      p.h = ASIO_LIBNS::detail::addressof(handler.handler_);
+      if (!o->ec_)
+      {
+        handler.arg2_ = make_results(o->result_, o->port_,
+            o->query_.hints().ai_flags, o->query_.host_name(),
+            o->query_.service_name());
+      }
+      p.reset();
+
+      // Make the upcall if required.
+      if (owner)
+      {
+        fenced_block b(fenced_block::half);
+        ASIO_HANDLER_INVOCATION_BEGIN((handler.arg1_, "..."));
+        w.complete(handler, handler.handler_);
+        ASIO_HANDLER_INVOCATION_END;
+      }
+    }
+
+    // The port for the service.
+    unsigned short port_;
+
+  private:
+    query_type query_;
+    Handler handler_;
+    handler_work<Handler, IoExecutor> work_;
+  };
+
+  // Operation used to resolve an endpoint.
+  template <typename Handler, typename IoExecutor>
+  class endpoint_op : public dns_resolve_op
+  {
+  public:
+    ASIO_DEFINE_HANDLER_PTR(endpoint_op);
+
+    endpoint_op(const endpoint_type& endpoint, Handler& handler,
+        const IoExecutor& io_ex)
+      : dns_resolve_op(&endpoint_op::do_complete),
+        endpoint_(endpoint),
+        handler_(ASIO_MOVE_CAST(Handler)(handler)),
+        work_(handler_, io_ex)
+    {
+    }
+
+    static void do_complete(void* owner, operation* base,
+        const ASIO_LIBNS::error_code& /*ec*/,
+        std::size_t /*bytes_transferred*/)
+    {
+      // Take ownership of the operation object.
+      endpoint_op* o(static_cast<endpoint_op*>(base));
+      ptr p = { ASIO_LIBNS::detail::addressof(o->handler_), o, o };
+
+      ASIO_HANDLER_COMPLETION((*o));
+
+      // Take ownership of the operation's outstanding work.
+      handler_work<Handler, IoExecutor> w(
+          ASIO_MOVE_CAST2(handler_work<Handler, IoExecutor>)(
+            o->work_));
+
+      // Make a copy of the handler so that the memory can be deallocated
+      // before the upcall is made.
+      detail::binder2<Handler, ASIO_LIBNS::error_code, results_type>
+        handler(o->handler_, o->ec_, results_type());
+      p.h = ASIO_LIBNS::detail::addressof(handler.handler_);
+      if (!o->ec_)
+      {
+        handler.arg2_ = results_type::create(o->endpoint_,
+            o->result_.host_name, o->service_name_);
+      }
+      p.reset();
+
+      // Make the upcall if required.
+      if (owner)
+      {
+        fenced_block b(fenced_block::half);
+        ASIO_HANDLER_INVOCATION_BEGIN((handler.arg1_, "..."));
+        w.complete(handler, handler.handler_);
+        ASIO_HANDLER_INVOCATION_END;
+      }
+    }
+
+    // The service name for the endpoint's port.
+    std::string service_name_;
+
+  private:
+    endpoint_type endpoint_;
+    Handler handler_;
+    handler_work<Handler, IoExecutor> work_;
+  };
+
+  // The cache of forward resolution results.
+  cache_type cache_;
+
+  // The lookups started on behalf of the cache.
+  implementation_type cache_lookups_;
+};
+
+} // namespace detail
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // defined(ASIO_HAS_DNS_RESOLVER)
+
+#endif // ASIO_DETAIL_DNS_RESOLVER_SERVICE_HPP
@@ -0,0 +1,170 @@
+//
+// detail/dns_resolver_service_base.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_DETAIL_DNS_RESOLVER_SERVICE_BASE_HPP
+#define ASIO_DETAIL_DNS_RESOLVER_SERVICE_BASE_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+
+#if defined(ASIO_HAS_DNS_RESOLVER)
+
+#include <ctime>
+#include <string>
+#include "asio/any_io_executor.hpp"
+#include "asio/error.hpp"
+#include "asio/execution_context.hpp"
+#include "asio/detail/dns_config.hpp"
+#include "asio/detail/dns_lookup.hpp"
+#include "asio/detail/dns_random.hpp"
+#include "asio/detail/memory.hpp"
+#include "asio/detail/mutex.hpp"
+#include "asio/detail/scheduler.hpp"
+#include "asio/detail/socket_types.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace ASIO_LIBNS {
+namespace detail {
+
+class dns_resolver_service_base
+{
+public:
+  // The implementation type of the resolver. The registry records the
+  // outstanding lookups so that they may be cancelled.
+  typedef shared_ptr<dns_lookup::registry> implementation_type;
+
+  // Constructor.
+  ASIO_DECL dns_resolver_service_base(execution_context& context,
+      const char* resolv_conf_path, const char* hosts_path);
+
+  // Destroy all user-defined handler objects owned by the service.
+  ASIO_DECL void base_shutdown();
+
+  // Perform any fork-related housekeeping.
+  ASIO_DECL void base_notify_fork(
+      execution_context::fork_event fork_ev);
+
+  // Construct a new resolver implementation.
+  ASIO_DECL void construct(implementation_type& impl);
+
+  // Destroy a resolver implementation.
+  ASIO_DECL void destroy(implementation_type& impl);
+
+  // Move-construct a new resolver implementation.
+  ASIO_DECL void move_construct(implementation_type& impl,
+      implementation_type& other_impl);
+
+  // Move-assign from another resolver implementation.
+  ASIO_DECL void move_assign(implementation_type& impl,
+      dns_resolver_service_base& other_service,
+      implementation_type& other_impl);
+
+  // Move-construct a new resolver implementation.
+  void converting_move_construct(implementation_type& impl,
+      dns_resolver_service_base&, implementation_type& other_impl)
+  {
+    move_construct(impl, other_impl);
+  }
+
+  // Move-assign from another resolver implementation.
+  void converting_move_assign(implementation_type& impl,
+      dns_resolver_service_base& other_service,
+      implementation_type& other_impl)
+  {
+    move_assign(impl, other_service, other_impl);
+  }
+
+  // Cancel pending asynchronous operations.
+  ASIO_DECL void cancel(implementation_type& impl);
+
+protected:
+  // Resolve a host and service name to a list of addresses and a port.
+  ASIO_DECL void do_resolve(const std::string& host_name,
+      const std::string& service_name, const addrinfo_type& hints,
+      dns_lookup_result& result, unsigned short& port,
+      ASIO_LIBNS::error_code& ec);
+
+  // Begin resolving a host and service name. If the result is known
+  // immediately, the operation is posted for completion and an empty pointer
+  // is returned. Otherwise the returned lookup owns the operation and should
+  // be started using dns_lookup::start_query.
+  ASIO_DECL shared_ptr<dns_lookup> begin_resolve(implementation_type& impl,
+      const std::string& host_name, const std::string& service_name,
+      const addrinfo_type& hints, dns_resolve_op* op, unsigned short& port,
+      const ASIO_LIBNS::any_io_executor& io_ex);
+
+  // Resolve an address to a host name, and a port to a service name.
+  ASIO_DECL void do_resolve(const ASIO_LIBNS::ip::address& address,
+      unsigned short port, int sock_type, dns_lookup_result& result,
+      std::string& service_name, ASIO_LIBNS::error_code& ec);
+
+  // Begin resolving an address to a host name, and a port to a service name.
+  // The returned lookup owns the operation and should be started using
+  // dns_lookup::start_reverse.
+  ASIO_DECL shared_ptr<dns_lookup> begin_resolve(implementation_type& impl,
+      const ASIO_LIBNS::ip::address& address, unsigned short port,
+      int sock_type, dns_resolve_op* op, std::string& service_name,
+      const ASIO_LIBNS::any_io_executor& io_ex);
+
+  // The scheduler implementation used to post completions.
+  typedef class scheduler scheduler_impl;
+  scheduler_impl& scheduler_;
+
+private:
+  // Resolve a numeric or empty host name without querying the name servers.
+  // Returns false if the host name must be looked up.
+  ASIO_DECL bool resolve_locally(const std::string& host_name,
+      const std::string& service_name, const addrinfo_type& hints,
+      dns_lookup_result& result, unsigned short& port,
+      ASIO_LIBNS::error_code& ec);
+
+  // Resolve a service name to a port.
+  ASIO_DECL void resolve_service(const std::string& service_name,
+      const addrinfo_type& hints, unsigned short& port,
+      ASIO_LIBNS::error_code& ec);
+
+  // Resolve a port to a service name.
+  ASIO_DECL void resolve_port(const ASIO_LIBNS::ip::address& address,
+      unsigned short port, int sock_type, std::string& service_name,
+      ASIO_LIBNS::error_code& ec);
+
+  // Get the current configuration, reloading it if the files have changed.
+  ASIO_DECL shared_ptr<const dns_config> current_config();
+
+  // Mutex to protect access to internal data.
+  ASIO_LIBNS::detail::mutex mutex_;
+
+  // The configuration files, and their state when last loaded.
+  std::string resolv_conf_path_;
+  std::string hosts_path_;
+  std::string file_state_;
+  std::time_t last_check_;
+  shared_ptr<const dns_config> config_;
+
+  // The source of query IDs, shared with the lookups.
+  shared_ptr<dns_random> random_;
+};
+
+} // namespace detail
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#if defined(ASIO_HEADER_ONLY)
+# include "asio/detail/impl/dns_resolver_service_base.ipp"
+#endif // defined(ASIO_HEADER_ONLY)
+
+#endif // defined(ASIO_HAS_DNS_RESOLVER)
+
+#endif // ASIO_DETAIL_DNS_RESOLVER_SERVICE_BASE_HPP
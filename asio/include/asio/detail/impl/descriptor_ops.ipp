@@ -24,6 +24,9 @@
   && !defined(ASIO_WINDOWS_RUNTIME) \
   && !defined(__CYGWIN__)
 
+#include <fcntl.h>
+#include <sys/stat.h>
+
 #include "asio/detail/push_options.hpp"
 
 namespace ASIO_LIBNS {
@@ -790,6 +793,206 @@ bool non_blocking_write_at1(int d, uint64_t offset,
   }
 }
 
+bool nowait_read(int d, buf* bufs, std::size_t count,
+    ASIO_LIBNS::error_code& ec, std::size_t& bytes_transferred)
+{
+  // An offset of -1 reads from, and advances, the current file position.
+  return nowait_read_at(d, static_cast<uint64_t>(-1),
+      bufs, count, ec, bytes_transferred);
+}
+
+bool nowait_read_at(int d, uint64_t offset, buf* bufs, std::size_t count,
+    ASIO_LIBNS::error_code& ec, std::size_t& bytes_transferred)
+{
+#if defined(RWF_NOWAIT)
+  for (;;)
+  {
+    // Read some data, but only if it is already in the page cache.
+    signed_size_type bytes = ::preadv2(d, bufs,
+        static_cast<int>(count), offset, RWF_NOWAIT);
+    get_last_error(ec, bytes < 0);
+
+    // Check for EOF.
+    if (bytes == 0)
+    {
+      ec = ASIO_LIBNS::error::eof;
+      bytes_transferred = 0;
+      return true;
+    }
+
+    // Check if operation succeeded.
+    if (bytes > 0)
+    {
+      bytes_transferred = bytes;
+      return true;
+    }
+
+    // Retry operation if interrupted by signal.
+    if (ec == ASIO_LIBNS::error::interrupted)
+      continue;
+
+    // The data is not cached, or the kernel or file system does not support
+    // the flag. Any other failure is left for a blocking read to report.
+    return false;
+  }
+#else // defined(RWF_NOWAIT)
+  (void)d;
+  (void)offset;
+  (void)bufs;
+  (void)count;
+  (void)ec;
+  (void)bytes_transferred;
+  return false;
+#endif // defined(RWF_NOWAIT)
+}
+
+int fsync(int d, ASIO_LIBNS::error_code& ec)
+{
+  int result = ::fsync(d);
+  get_last_error(ec, result != 0);
+  return result;
+}
+
+int fdatasync(int d, ASIO_LIBNS::error_code& ec)
+{
+#if defined(_POSIX_SYNCHRONIZED_IO)
+  int result = ::fdatasync(d);
+#else // defined(_POSIX_SYNCHRONIZED_IO)
+  int result = ::fsync(d);
+#endif // defined(_POSIX_SYNCHRONIZED_IO)
+  get_last_error(ec, result != 0);
+  return result;
+}
+
+int ftruncate(int d, uint64_t n, ASIO_LIBNS::error_code& ec)
+{
+  int result = ::ftruncate(d, n);
+  get_last_error(ec, result != 0);
+  return result;
+}
+
+int fallocate(int d, uint64_t offset,
+    uint64_t length, ASIO_LIBNS::error_code& ec)
+{
+#if defined(_POSIX_ADVISORY_INFO) && (_POSIX_ADVISORY_INFO >= 0)
+  // The error is returned rather than stored in errno.
+  int result;
+  do
+    result = ::posix_fallocate(d, offset, length);
+  while (result == EINTR);
+  ec.assign(result, ASIO_LIBNS::error::get_system_category());
+  return result == 0 ? 0 : -1;
+#else // defined(_POSIX_ADVISORY_INFO) && (_POSIX_ADVISORY_INFO >= 0)
+  (void)d;
+  (void)offset;
+  (void)length;
+  ec = ASIO_LIBNS::error::operation_not_supported;
+  return -1;
+#endif // defined(_POSIX_ADVISORY_INFO) && (_POSIX_ADVISORY_INFO >= 0)
+}
+
+uint64_t file_size(int d, ASIO_LIBNS::error_code& ec)
+{
+  struct stat s;
+  int result = ::fstat(d, &s);
+  get_last_error(ec, result != 0);
+  return result == 0 ? s.st_size : 0;
+}
+
+std::size_t file_alignment(int d, ASIO_LIBNS::error_code& ec)
+{
+#if defined(STATX_DIOALIGN)
+  // Linux 6.1 and later report the alignment that direct I/O requires. A
+  // zero offset alignment means the file does not support direct I/O.
+  struct statx sx;
+  if (::statx(d, "", AT_EMPTY_PATH, STATX_DIOALIGN, &sx) == 0
+      && (sx.stx_mask & STATX_DIOALIGN) != 0 && sx.stx_dio_offset_align != 0)
+  {
+    ASIO_LIBNS::error::clear(ec);
+    return sx.stx_dio_mem_align > sx.stx_dio_offset_align
+      ? sx.stx_dio_mem_align : sx.stx_dio_offset_align;
+  }
+#endif // defined(STATX_DIOALIGN)
+
+  // Otherwise the file system's preferred block size is a multiple of the
+  // logical block size, and so is always sufficient.
+  struct stat s;
+  int result = ::fstat(d, &s);
+  get_last_error(ec, result != 0);
+  return result == 0 && s.st_blksize > 0
+    ? static_cast<std::size_t>(s.st_blksize) : 0;
+}
+
+std::size_t sync_copy_at(int s, int d, uint64_t offset,
+    std::size_t size, ASIO_LIBNS::error_code& ec)
+{
+  if (s == -1 || d == -1)
+  {
+    ec = ASIO_LIBNS::error::bad_descriptor;
+    return 0;
+  }
+
+  // A request to copy 0 bytes is a no-op.
+  if (size == 0)
+  {
+    ASIO_LIBNS::error::clear(ec);
+    return 0;
+  }
+
+#if defined(__linux__) && defined(__GLIBC__) \
+  && ((__GLIBC__ > 2) || ((__GLIBC__ == 2) && (__GLIBC_MINOR__ >= 27)))
+  // Let the kernel copy the data, or have the file system share the extents.
+  for (;;)
+  {
+    loff_t in_offset = offset;
+    loff_t out_offset = offset;
+    signed_size_type bytes = ::copy_file_range(
+        s, &in_offset, d, &out_offset, size, 0);
+    get_last_error(ec, bytes < 0);
+
+    // Check if operation succeeded.
+    if (bytes >= 0)
+      return bytes;
+
+    // Retry operation if interrupted by signal.
+    if (ec == ASIO_LIBNS::error::interrupted)
+      continue;
+
+    // Older kernels cannot copy between file systems, and some file systems
+    // do not support the call at all. Copy through memory instead.
+    if (ec != ASIO_LIBNS::error::operation_not_supported
+        && ec != ASIO_LIBNS::error::invalid_argument
+        && ec.value() != EXDEV && ec.value() != ENOSYS)
+      return 0;
+
+    break;
+  }
+#endif // defined(__linux__) && defined(__GLIBC__) ...
+
+  char data[65536];
+  std::size_t bytes_read = sync_read_at1(s, 0, offset,
+      data, size < sizeof(data) ? size : sizeof(data), ec);
+  if (bytes_read == 0)
+  {
+    // End of file is reported as a copy of 0 bytes.
+    if (ec == ASIO_LIBNS::error::eof)
+      ASIO_LIBNS::error::clear(ec);
+    return 0;
+  }
+
+  std::size_t bytes_written = 0;
+  while (bytes_written < bytes_read)
+  {
+    std::size_t bytes = sync_write_at1(d, 0, offset + bytes_written,
+        data + bytes_written, bytes_read - bytes_written, ec);
+    if (bytes == 0)
+      return 0;
+    bytes_written += bytes;
+  }
+
+  return bytes_written;
+}
+
 #endif // defined(ASIO_HAS_FILE)
 
 int ioctl(int d, state_type& state, long cmd,
@@ -0,0 +1,311 @@
+//
+// detail/impl/dns_config.ipp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_DETAIL_IMPL_DNS_CONFIG_IPP
+#define ASIO_DETAIL_IMPL_DNS_CONFIG_IPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+
+#if defined(ASIO_HAS_DNS_RESOLVER)
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <ifaddrs.h>
+#include <unistd.h>
+#include "asio/detail/dns_config.hpp"
+#include "asio/detail/socket_types.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace ASIO_LIBNS {
+namespace detail {
+
+namespace dns_config_helpers {
+
+enum
+{
+  default_port = 53,
+  max_name_servers = 3,
+  max_ndots = 15,
+  max_timeout = 30,
+  max_attempts = 5
+};
+
+inline std::string to_lower(std::string s)
+{
+  for (std::size_t i = 0; i < s.size(); ++i)
+    if (s[i] >= 'A' && s[i] <= 'Z')
+      s[i] = static_cast<char>(s[i] - 'A' + 'a');
+  return s;
+}
+
+inline std::string strip_dot(const std::string& s)
+{
+  if (!s.empty() && s[s.size() - 1] == '.')
+    return s.substr(0, s.size() - 1);
+  return s;
+}
+
+inline int option_value(const std::string& option,
+    std::size_t prefix_length, int max_value)
+{
+  int value = std::atoi(option.c_str() + prefix_length);
+  return value < 0 ? 0 : (value > max_value ? max_value : value);
+}
+
+// Parse a name server address. As an extension, a port may be given using the
+// forms "192.0.2.1:5353" and "[2001:db8::1]:5353".
+inline bool parse_name_server(const std::string& s,
+    dns_config::name_server& server)
+{
+  std::string address = s;
+  std::string port;
+  if (!s.empty() && s[0] == '[')
+  {
+    std::size_t end = s.find(']');
+    if (end == std::string::npos)
+      return false;
+    address = s.substr(1, end - 1);
+    if (end + 1 < s.size())
+    {
+      if (s[end + 1] != ':')
+        return false;
+      port = s.substr(end + 2);
+    }
+  }
+  else if (s.find(':') != std::string::npos
+      && s.find(':') == s.rfind(':') && s.find('.') != std::string::npos)
+  {
+    address = s.substr(0, s.find(':'));
+    port = s.substr(s.find(':') + 1);
+  }
+
+  ASIO_LIBNS::error_code ec;
+  server.address = ASIO_LIBNS::ip::make_address(address.c_str(), ec);
+  if (ec)
+    return false;
+
+  server.port = default_port;
+  if (!port.empty())
+  {
+    char* end = 0;
+    unsigned long value = std::strtoul(port.c_str(), &end, 10);
+    if (*end != 0 || value == 0 || value > 65535)
+      return false;
+    server.port = static_cast<unsigned short>(value);
+  }
+  return true;
+}
+
+} // namespace dns_config_helpers
+
+dns_config::dns_config()
+  : ndots(1),
+    timeout(5),
+    attempts(2),
+    rotate(false),
+    ipv4_configured(true),
+    ipv6_configured(true)
+{
+}
+
+void dns_config::load(const std::string& resolv_conf_path,
+    const std::string& hosts_path)
+{
+  using namespace dns_config_helpers;
+
+  std::ifstream resolv_conf(resolv_conf_path.c_str());
+  if (resolv_conf)
+    parse_resolv_conf(resolv_conf);
+
+  std::ifstream hosts(hosts_path.c_str());
+  if (hosts)
+    parse_hosts(hosts);
+
+  // As with the system resolver, use the local server if none is configured.
+  if (name_servers.empty())
+  {
+    name_server server;
+    server.address = ASIO_LIBNS::ip::address_v4::loopback();
+    server.port = default_port;
+    name_servers.push_back(server);
+  }
+
+  // Without a search list, names are searched for in the local domain.
+  if (search.empty())
+  {
+    char host_name[256] = "";
+    if (::gethostname(host_name, sizeof(host_name) - 1) == 0)
+    {
+      const char* domain = std::strchr(host_name, '.');
+      if (domain && domain[1])
+        search.push_back(strip_dot(domain + 1));
+    }
+  }
+
+  // Determine which address families are in use, to support the
+  // address_configured flag.
+  ifaddrs* interfaces = 0;
+  if (::getifaddrs(&interfaces) == 0)
+  {
+    ipv4_configured = false;
+    ipv6_configured = false;
+    for (ifaddrs* i = interfaces; i; i = i->ifa_next)
+    {
+      if (!i->ifa_addr)
+        continue;
+      if (i->ifa_addr->sa_family == ASIO_OS_DEF(AF_INET))
+      {
+        const sockaddr_in4_type* a
+          = reinterpret_cast<const sockaddr_in4_type*>(i->ifa_addr);
+        ASIO_LIBNS::ip::address_v4::bytes_type bytes;
+        std::memcpy(bytes.data(), &a->sin_addr, 4);
+        ASIO_LIBNS::ip::address_v4 address(bytes);
+        if (!address.is_loopback())
+          ipv4_configured = true;
+      }
+      else if (i->ifa_addr->sa_family == ASIO_OS_DEF(AF_INET6))
+      {
+        const sockaddr_in6_type* a
+          = reinterpret_cast<const sockaddr_in6_type*>(i->ifa_addr);
+        ASIO_LIBNS::ip::address_v6::bytes_type bytes;
+        std::memcpy(bytes.data(), a->sin6_addr.s6_addr, 16);
+        ASIO_LIBNS::ip::address_v6 address(bytes);
+        if (!address.is_loopback() && !address.is_link_local())
+          ipv6_configured = true;
+      }
+    }
+    ::freeifaddrs(interfaces);
+  }
+}
+
+void dns_config::parse_resolv_conf(std::istream& is)
+{
+  using namespace dns_config_helpers;
+
+  std::string line;
+  while (std::getline(is, line))
+  {
+    std::size_t comment = line.find_first_of("#;");
+    if (comment != std::string::npos)
+      line.erase(comment);
+
+    std::istringstream tokens(line);
+    std::string keyword;
+    if (!(tokens >> keyword))
+      continue;
+
+    std::string value;
+    if (keyword == "nameserver")
+    {
+      name_server server;
+      if (tokens >> value && name_servers.size() < max_name_servers
+          && parse_name_server(value, server))
+        name_servers.push_back(server);
+    }
+    else if (keyword == "domain" || keyword == "search")
+    {
+      // The last search or domain line takes precedence.
+      search.clear();
+      while (tokens >> value)
+      {
+        search.push_back(strip_dot(value));
+        if (keyword == "domain")
+          break;
+      }
+    }
+    else if (keyword == "options")
+    {
+      while (tokens >> value)
+      {
+        if (value.compare(0, 6, "ndots:") == 0)
+          ndots = option_value(value, 6, max_ndots);
+        else if (value.compare(0, 8, "timeout:") == 0)
+          timeout = option_value(value, 8, max_timeout);
+        else if (value.compare(0, 9, "attempts:") == 0)
+          attempts = option_value(value, 9, max_attempts);
+        else if (value == "rotate")
+          rotate = true;
+      }
+    }
+  }
+
+  if (timeout < 1)
+    timeout = 1;
+  if (attempts < 1)
+    attempts = 1;
+}
+
+void dns_config::parse_hosts(std::istream& is)
+{
+  using namespace dns_config_helpers;
+
+  std::string line;
+  while (std::getline(is, line))
+  {
+    std::size_t comment = line.find('#');
+    if (comment != std::string::npos)
+      line.erase(comment);
+
+    std::istringstream tokens(line);
+    std::string address_string, canonical_name;
+    if (!(tokens >> address_string >> canonical_name))
+      continue;
+
+    host_entry entry;
+    ASIO_LIBNS::error_code ec;
+    entry.address = ASIO_LIBNS::ip::make_address(address_string.c_str(), ec);
+    if (ec)
+      continue;
+    entry.canonical_name = strip_dot(canonical_name);
+
+    if (hosts_by_address.find(entry.address) == hosts_by_address.end())
+      hosts_by_address[entry.address] = entry.canonical_name;
+
+    std::string name = canonical_name;
+    do
+    {
+      hosts_by_name[to_lower(strip_dot(name))].push_back(entry);
+    } while (tokens >> name);
+  }
+}
+
+const std::vector<dns_config::host_entry>* dns_config::find_host(
+    const std::string& name) const
+{
+  using namespace dns_config_helpers;
+
+  std::map<std::string, std::vector<host_entry> >::const_iterator iter
+    = hosts_by_name.find(to_lower(strip_dot(name)));
+  return iter != hosts_by_name.end() ? &iter->second : 0;
+}
+
+const std::string* dns_config::find_address(
+    const ASIO_LIBNS::ip::address& address) const
+{
+  std::map<ASIO_LIBNS::ip::address, std::string>::const_iterator iter
+    = hosts_by_address.find(address);
+  return iter != hosts_by_address.end() ? &iter->second : 0;
+}
+
+} // namespace detail
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // defined(ASIO_HAS_DNS_RESOLVER)
+
+#endif // ASIO_DETAIL_IMPL_DNS_CONFIG_IPP
@@ -0,0 +1,666 @@
+//
+// detail/impl/dns_lookup.ipp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_DETAIL_IMPL_DNS_LOOKUP_IPP
+#define ASIO_DETAIL_IMPL_DNS_LOOKUP_IPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+
+#if defined(ASIO_HAS_DNS_RESOLVER)
+
+#include "asio/buffer.hpp"
+#include "asio/generic/datagram_protocol.hpp"
+#include "asio/generic/stream_protocol.hpp"
+#include "asio/ip/detail/endpoint.hpp"
+#include "asio/post.hpp"
+#include "asio/read.hpp"
+#include "asio/steady_timer.hpp"
+#include "asio/strand.hpp"
+#include "asio/write.hpp"
+#include "asio/detail/array.hpp"
+#include "asio/detail/dns_lookup.hpp"
+#include "asio/detail/dns_message.hpp"
+#include "asio/detail/socket_types.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace ASIO_LIBNS {
+namespace detail {
+
+namespace dns_lookup_helpers {
+
+// The outcome of a transaction, in increasing order of severity.
+enum outcome
+{
+  outcome_answer,
+  outcome_name_error,
+  outcome_no_recovery,
+  outcome_try_again
+};
+
+// The asynchronous operations performed by a transaction.
+enum event
+{
+  event_timeout,
+  event_udp_send,
+  event_udp_receive,
+  event_tcp_connect,
+  event_tcp_write,
+  event_tcp_read_length,
+  event_tcp_read
+};
+
+} // namespace dns_lookup_helpers
+
+struct dns_lookup::transaction
+{
+  explicit transaction(const ASIO_LIBNS::any_io_executor& ex)
+    : id(0),
+      first_server(0),
+      server(0),
+      tries(0),
+      generation(0),
+      done(false),
+      outcome(dns_lookup_helpers::outcome_try_again),
+      failure(dns_lookup_helpers::outcome_try_again),
+      udp_socket(ex),
+      tcp_socket(ex),
+      timer(ex)
+  {
+  }
+
+  // Abandon any operations in progress. Their handlers are identified as
+  // stale by the change in generation.
+  void reset()
+  {
+    ++generation;
+    ASIO_LIBNS::error_code ignored_ec;
+    udp_socket.close(ignored_ec);
+    tcp_socket.close(ignored_ec);
+    timer.cancel();
+  }
+
+  // The query.
+  std::string name;
+  int type;
+  unsigned short id;
+  std::vector<unsigned char> query;
+
+  // The response, and the length prefix used over TCP.
+  std::vector<unsigned char> response;
+  unsigned char length[2];
+  dns_message message;
+
+  // The server to try first, the server currently being tried, and the number
+  // of tries started.
+  std::size_t first_server;
+  std::size_t server;
+  std::size_t tries;
+
+  // Incremented whenever operations in progress are abandoned.
+  unsigned int generation;
+
+  // The outcome, once done, and the failure reported if all tries fail.
+  bool done;
+  int outcome;
+  int failure;
+
+  ASIO_LIBNS::generic::datagram_protocol::socket udp_socket;
+  ASIO_LIBNS::generic::stream_protocol::socket tcp_socket;
+  ASIO_LIBNS::steady_timer timer;
+};
+
+struct dns_lookup::start_handler
+{
+  shared_ptr<dns_lookup> lookup_;
+
+  void operator()()
+  {
+    lookup_->start();
+  }
+};
+
+struct dns_lookup::cancel_handler
+{
+  shared_ptr<dns_lookup> lookup_;
+
+  void operator()()
+  {
+    if (!lookup_->finished_)
+      lookup_->finish(ASIO_LIBNS::error::operation_aborted);
+  }
+};
+
+struct dns_lookup::transaction_handler
+{
+  shared_ptr<dns_lookup> lookup_;
+  shared_ptr<transaction> transaction_;
+  unsigned int generation_;
+  int event_;
+
+  void operator()(const ASIO_LIBNS::error_code& ec,
+      std::size_t bytes_transferred = 0)
+  {
+    if (!lookup_->finished_ && !transaction_->done
+        && generation_ == transaction_->generation)
+    {
+      lookup_->handle_event(transaction_, event_, ec, bytes_transferred);
+    }
+  }
+};
+
+void dns_lookup::registry::add(const shared_ptr<dns_lookup>& lookup)
+{
+  ASIO_LIBNS::detail::mutex::scoped_lock lock(mutex_);
+  for (std::size_t i = 0; i < lookups_.size();)
+  {
+    if (lookups_[i].expired())
+    {
+      lookups_[i] = lookups_.back();
+      lookups_.pop_back();
+    }
+    else
+      ++i;
+  }
+  lookups_.push_back(lookup);
+}
+
+void dns_lookup::registry::cancel()
+{
+  std::vector<weak_ptr<dns_lookup> > lookups;
+  {
+    ASIO_LIBNS::detail::mutex::scoped_lock lock(mutex_);
+    lookups.swap(lookups_);
+  }
+
+  for (std::size_t i = 0; i < lookups.size(); ++i)
+    if (shared_ptr<dns_lookup> lookup = lookups[i].lock())
+      dns_lookup::cancel(lookup);
+}
+
+dns_lookup::dns_lookup(const ASIO_LIBNS::any_io_executor& io_ex,
+    const shared_ptr<const dns_config>& config,
+    const shared_ptr<dns_random>& random, scheduler* sched, dns_resolve_op* op)
+  : executor_(ASIO_LIBNS::make_strand(io_ex)),
+    config_(config),
+    random_(random),
+    scheduler_(sched),
+    op_(op),
+    candidate_(0),
+    family_(ASIO_OS_DEF(AF_UNSPEC)),
+    flags_(0),
+    reverse_(false),
+    pending_(0),
+    failure_(dns_lookup_helpers::outcome_name_error),
+    negative_ttl_((std::numeric_limits<unsigned long>::max)()),
+    finished_(false)
+{
+}
+
+dns_lookup::~dns_lookup()
+{
+  if (op_)
+    op_->destroy();
+}
+
+void dns_lookup::start_query(const shared_ptr<dns_lookup>& lookup,
+    const std::string& host_name, int family, int flags)
+{
+  lookup->self_ = lookup;
+  lookup->host_name_ = host_name;
+  lookup->family_ = family;
+  lookup->flags_ = flags;
+
+  // Build the list of names to try, as described in resolv.conf(5). A name
+  // with at least ndots dots is tried as given before the search domains.
+  std::vector<std::string>& candidates = lookup->candidates_;
+  if (!host_name.empty() && host_name[host_name.size() - 1] == '.')
+  {
+    candidates.push_back(host_name.substr(0, host_name.size() - 1));
+  }
+  else
+  {
+    int dots = 0;
+    for (std::size_t i = 0; i < host_name.size(); ++i)
+      dots += host_name[i] == '.';
+    if (dots >= lookup->config_->ndots)
+      candidates.push_back(host_name);
+    for (std::size_t i = 0; i < lookup->config_->search.size(); ++i)
+      candidates.push_back(host_name + "." + lookup->config_->search[i]);
+    if (dots < lookup->config_->ndots)
+      candidates.push_back(host_name);
+  }
+
+  start_handler handler = { lookup };
+  ASIO_LIBNS::post(lookup->executor_, handler);
+}
+
+void dns_lookup::start_reverse(const shared_ptr<dns_lookup>& lookup,
+    const ASIO_LIBNS::ip::address& address)
+{
+  lookup->self_ = lookup;
+  lookup->reverse_ = true;
+  lookup->reverse_address_ = address;
+  lookup->candidates_.push_back(dns_message::reverse_name(address));
+
+  start_handler handler = { lookup };
+  ASIO_LIBNS::post(lookup->executor_, handler);
+}
+
+void dns_lookup::cancel(const shared_ptr<dns_lookup>& lookup)
+{
+  cancel_handler handler = { lookup };
+  ASIO_LIBNS::post(lookup->executor_, handler);
+}
+
+void dns_lookup::start()
+{
+  if (finished_)
+    return;
+
+  // Names and addresses listed in the hosts file are not looked up.
+  if (reverse_)
+  {
+    if (const std::string* name = config_->find_address(reverse_address_))
+    {
+      result_.host_name = *name;
+      finish(ASIO_LIBNS::error_code());
+      return;
+    }
+  }
+  else if (const std::vector<dns_config::host_entry>* entries
+      = config_->find_host(host_name_))
+  {
+    for (std::size_t i = 0; i < entries->size(); ++i)
+    {
+      const ASIO_LIBNS::ip::address& address = (*entries)[i].address;
+      if (family_ == ASIO_OS_DEF(AF_UNSPEC)
+          || (family_ == ASIO_OS_DEF(AF_INET) && address.is_v4())
+          || (family_ == ASIO_OS_DEF(AF_INET6) && address.is_v6()))
+      {
+        result_.addresses.push_back(address);
+        result_.host_name = (*entries)[i].canonical_name;
+      }
+    }
+    if (!result_.addresses.empty())
+    {
+      finish(ASIO_LIBNS::error_code());
+      return;
+    }
+  }
+
+  next_candidate();
+}
+
+void dns_lookup::next_candidate()
+{
+  using namespace dns_lookup_helpers;
+
+  for (std::size_t i = 0; i < transactions_.size(); ++i)
+    transactions_[i]->reset();
+  transactions_.clear();
+  pending_ = 0;
+
+  if (candidate_ == candidates_.size())
+  {
+    switch (failure_)
+    {
+    case outcome_try_again:
+      finish(ASIO_LIBNS::error::host_not_found_try_again);
+      break;
+    case outcome_no_recovery:
+      finish(ASIO_LIBNS::error::no_recovery);
+      break;
+    default:
+      finish(ASIO_LIBNS::error::host_not_found);
+      break;
+    }
+    return;
+  }
+
+  const std::string& name = candidates_[candidate_++];
+
+  // Determine the record types to query.
+  int types[2];
+  std::size_t num_types = 0;
+  if (reverse_)
+  {
+    types[num_types++] = dns_message::type_ptr;
+  }
+  else
+  {
+    bool want_v6 = family_ != ASIO_OS_DEF(AF_INET);
+    bool want_v4 = family_ != ASIO_OS_DEF(AF_INET6)
+      || (flags_ & ASIO_OS_DEF(AI_V4MAPPED)) != 0;
+    if (flags_ & ASIO_OS_DEF(AI_ADDRCONFIG))
+    {
+      want_v6 = want_v6 && config_->ipv6_configured;
+      want_v4 = want_v4 && config_->ipv4_configured;
+    }
+    if (want_v6)
+      types[num_types++] = dns_message::type_aaaa;
+    if (want_v4)
+      types[num_types++] = dns_message::type_a;
+  }
+
+  // Start the queries in parallel.
+  for (std::size_t i = 0; i < num_types; ++i)
+  {
+    shared_ptr<transaction> t(new transaction(executor_));
+    t->name = name;
+    t->type = types[i];
+    if (!dns_message::build_query(0, name, t->type, t->query))
+      continue;
+    if (config_->rotate)
+      t->first_server = random_->next() % config_->name_servers.size();
+    transactions_.push_back(t);
+  }
+
+  if (transactions_.empty())
+  {
+    next_candidate();
+    return;
+  }
+
+  pending_ = transactions_.size();
+  std::vector<shared_ptr<transaction> > transactions(transactions_);
+  for (std::size_t i = 0; i < transactions.size() && !finished_; ++i)
+    next_try(transactions[i]);
+}
+
+void dns_lookup::next_try(const shared_ptr<transaction>& t)
+{
+  using namespace dns_lookup_helpers;
+
+  const std::vector<dns_config::name_server>& servers = config_->name_servers;
+  for (;;)
+  {
+    t->reset();
+
+    // Each server is tried in turn, for the configured number of attempts.
+    if (t->tries == servers.size() * config_->attempts)
+    {
+      transaction_done(*t, t->failure);
+      return;
+    }
+    t->server = (t->first_server + t->tries++) % servers.size();
+
+    // Use a new, unpredictable ID for each try so that late or spoofed
+    // responses are discarded.
+    t->id = random_->next();
+    t->query[0] = static_cast<unsigned char>(t->id >> 8);
+    t->query[1] = static_cast<unsigned char>(t->id & 0xFF);
+
+    // Connecting the socket ensures that only the server's responses are
+    // received, and that ICMP errors are reported.
+    ASIO_LIBNS::ip::detail::endpoint server(
+        servers[t->server].address, servers[t->server].port);
+    ASIO_LIBNS::generic::datagram_protocol::endpoint endpoint(
+        server.data(), server.size(), ASIO_OS_DEF(IPPROTO_UDP));
+    ASIO_LIBNS::error_code ec;
+    t->udp_socket.open(endpoint.protocol(), ec);
+    if (!ec)
+      t->udp_socket.connect(endpoint, ec);
+    if (!ec)
+      break;
+  }
+
+  t->response.resize(dns_message::max_udp_size);
+  t->udp_socket.async_send(ASIO_LIBNS::buffer(t->query),
+      make_handler(t, event_udp_send));
+  t->udp_socket.async_receive(ASIO_LIBNS::buffer(t->response),
+      make_handler(t, event_udp_receive));
+  t->timer.expires_after(ASIO_LIBNS::chrono::seconds(config_->timeout));
+  t->timer.async_wait(make_handler(t, event_timeout));
+}
+
+void dns_lookup::start_tcp(const shared_ptr<transaction>& t)
+{
+  using namespace dns_lookup_helpers;
+
+  t->reset();
+
+  ASIO_LIBNS::ip::detail::endpoint server(
+      config_->name_servers[t->server].address,
+      config_->name_servers[t->server].port);
+  ASIO_LIBNS::generic::stream_protocol::endpoint endpoint(
+      server.data(), server.size(), ASIO_OS_DEF(IPPROTO_TCP));
+
+  t->tcp_socket.async_connect(endpoint, make_handler(t, event_tcp_connect));
+  t->timer.expires_after(ASIO_LIBNS::chrono::seconds(config_->timeout));
+  t->timer.async_wait(make_handler(t, event_timeout));
+}
+
+void dns_lookup::handle_event(const shared_ptr<transaction>& t,
+    int event, const ASIO_LIBNS::error_code& ec,
+    std::size_t bytes_transferred)
+{
+  using namespace dns_lookup_helpers;
+
+  if (ec)
+  {
+    // A timer that was cancelled has been superseded by the next try.
+    if (event != event_timeout || ec != ASIO_LIBNS::error::operation_aborted)
+      next_try(t);
+    return;
+  }
+
+  switch (event)
+  {
+  case event_timeout:
+    next_try(t);
+    break;
+  case event_udp_send:
+    break;
+  case event_udp_receive:
+    handle_response(t, &t->response[0], bytes_transferred, false);
+    break;
+  case event_tcp_connect:
+    {
+      // Messages sent over TCP are preceded by a two byte length.
+      t->length[0] = static_cast<unsigned char>(t->query.size() >> 8);
+      t->length[1] = static_cast<unsigned char>(t->query.size() & 0xFF);
+      ASIO_LIBNS::detail::array<ASIO_LIBNS::const_buffer, 2> buffers = {{
+        ASIO_LIBNS::buffer(t->length), ASIO_LIBNS::buffer(t->query) }};
+      ASIO_LIBNS::async_write(t->tcp_socket, buffers,
+          make_handler(t, event_tcp_write));
+    }
+    break;
+  case event_tcp_write:
+    ASIO_LIBNS::async_read(t->tcp_socket, ASIO_LIBNS::buffer(t->length),
+        make_handler(t, event_tcp_read_length));
+    break;
+  case event_tcp_read_length:
+    t->response.resize((t->length[0] << 8) | t->length[1]);
+    ASIO_LIBNS::async_read(t->tcp_socket, ASIO_LIBNS::buffer(t->response),
+        make_handler(t, event_tcp_read));
+    break;
+  case event_tcp_read:
+    if (t->response.empty())
+      next_try(t);
+    else
+      handle_response(t, &t->response[0], t->response.size(), true);
+    break;
+  default:
+    break;
+  }
+}
+
+void dns_lookup::handle_response(const shared_ptr<transaction>& t,
+    const unsigned char* data, std::size_t size, bool over_tcp)
+{
+  using namespace dns_lookup_helpers;
+
+  if (!t->message.parse_response(data, size, t->id, t->name, t->type))
+  {
+    // Discard a datagram that does not answer the query, and keep waiting for
+    // the real response until the timer expires.
+    if (over_tcp)
+      next_try(t);
+    else
+      t->udp_socket.async_receive(ASIO_LIBNS::buffer(t->response),
+          make_handler(t, event_udp_receive));
+    return;
+  }
+
+  if (t->message.truncated())
+  {
+    if (over_tcp)
+      next_try(t);
+    else
+      start_tcp(t);
+    return;
+  }
+
+  switch (t->message.rcode())
+  {
+  case dns_message::no_error:
+    transaction_done(*t, outcome_answer);
+    break;
+  case dns_message::name_error:
+    transaction_done(*t, outcome_name_error);
+    break;
+  case dns_message::format_error:
+  case dns_message::not_implemented:
+    t->failure = outcome_no_recovery;
+    next_try(t);
+    break;
+  default:
+    t->failure = outcome_try_again;
+    next_try(t);
+    break;
+  }
+}
+
+void dns_lookup::transaction_done(transaction& t, int outcome)
+{
+  using namespace dns_lookup_helpers;
+
+  t.reset();
+  t.done = true;
+  t.outcome = outcome;
+  if (--pending_ > 0)
+    return;
+
+  if (reverse_)
+  {
+    // As with getnameinfo, fall back to the numeric form of the address.
+    if (t.outcome == outcome_answer && !t.message.name().empty())
+    {
+      result_.host_name = t.message.name();
+      result_.ttl = t.message.ttl();
+    }
+    else
+      result_.host_name = reverse_address_.to_string();
+    finish(ASIO_LIBNS::error_code());
+    return;
+  }
+
+  // Combine the answers according to the requested family and flags.
+  std::vector<ASIO_LIBNS::ip::address> v4, v6;
+  std::string canonical_name;
+  unsigned long ttl = (std::numeric_limits<unsigned long>::max)();
+  for (std::size_t i = 0; i < transactions_.size(); ++i)
+  {
+    const transaction& u = *transactions_[i];
+    if (u.outcome == outcome_answer && !u.message.addresses().empty())
+    {
+      std::vector<ASIO_LIBNS::ip::address>& addresses
+        = u.type == dns_message::type_a ? v4 : v6;
+      addresses = u.message.addresses();
+      if (canonical_name.empty())
+        canonical_name = u.message.name();
+      if (u.message.ttl() < ttl)
+        ttl = u.message.ttl();
+    }
+    else if (u.outcome == outcome_answer || u.outcome == outcome_name_error)
+    {
+      // A negative answer's TTL is taken from the SOA record.
+      if (u.message.ttl() < negative_ttl_)
+        negative_ttl_ = u.message.ttl();
+    }
+    if (u.outcome > failure_)
+      failure_ = u.outcome;
+  }
+
+  std::vector<ASIO_LIBNS::ip::address>& addresses = result_.addresses;
+  if (family_ == ASIO_OS_DEF(AF_INET6))
+  {
+    addresses = v6;
+    if (addresses.empty() || (flags_ & ASIO_OS_DEF(AI_ALL)) != 0)
+    {
+      for (std::size_t i = 0; i < v4.size(); ++i)
+        addresses.push_back(ASIO_LIBNS::ip::make_address_v6(
+              ASIO_LIBNS::ip::v4_mapped, v4[i].to_v4()));
+    }
+  }
+  else if (family_ == ASIO_OS_DEF(AF_INET))
+  {
+    addresses = v4;
+  }
+  else
+  {
+    // Prefer IPv6 only if the host has IPv6 connectivity.
+    std::vector<ASIO_LIBNS::ip::address>& first
+      = config_->ipv6_configured ? v6 : v4;
+    std::vector<ASIO_LIBNS::ip::address>& second
+      = config_->ipv6_configured ? v4 : v6;
+    addresses = first;
+    addresses.insert(addresses.end(), second.begin(), second.end());
+  }
+
+  if (addresses.empty())
+  {
+    next_candidate();
+    return;
+  }
+
+  result_.host_name = canonical_name;
+  result_.ttl = ttl;
+  finish(ASIO_LIBNS::error_code());
+}
+
+void dns_lookup::finish(const ASIO_LIBNS::error_code& ec)
+{
+  finished_ = true;
+  ec_ = ec;
+  if (ec == ASIO_LIBNS::error::host_not_found)
+    result_.ttl = negative_ttl_;
+  for (std::size_t i = 0; i < transactions_.size(); ++i)
+    transactions_[i]->reset();
+
+  if (op_)
+  {
+    op_->ec_ = ec;
+    op_->result_ = result_;
+    scheduler_->post_deferred_completion(op_);
+    op_ = 0;
+  }
+}
+
+dns_lookup::transaction_handler dns_lookup::make_handler(
+    const shared_ptr<transaction>& t, int event)
+{
+  transaction_handler handler = { self_.lock(), t, t->generation, event };
+  return handler;
+}
+
+} // namespace detail
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // defined(ASIO_HAS_DNS_RESOLVER)
+
+#endif // ASIO_DETAIL_IMPL_DNS_LOOKUP_IPP
@@ -0,0 +1,379 @@
+//
+// detail/impl/dns_message.ipp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_DETAIL_IMPL_DNS_MESSAGE_IPP
+#define ASIO_DETAIL_IMPL_DNS_MESSAGE_IPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+
+#if defined(ASIO_HAS_DNS_RESOLVER)
+
+#include <cstring>
+#include "asio/detail/dns_message.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace ASIO_LIBNS {
+namespace detail {
+
+namespace dns_message_helpers {
+
+enum
+{
+  header_size = 12,
+  class_in = 1,
+  type_soa = 6,
+  max_name_size = 255,
+  max_label_size = 63,
+  max_cname_chain = 16,
+  max_compression_jumps = 64
+};
+
+inline unsigned short read_u16(const unsigned char* p)
+{
+  return static_cast<unsigned short>((p[0] << 8) | p[1]);
+}
+
+inline unsigned long read_u32(const unsigned char* p)
+{
+  return (static_cast<unsigned long>(p[0]) << 24)
+    | (static_cast<unsigned long>(p[1]) << 16)
+    | (static_cast<unsigned long>(p[2]) << 8)
+    | static_cast<unsigned long>(p[3]);
+}
+
+inline void write_u16(std::vector<unsigned char>& v, unsigned short n)
+{
+  v.push_back(static_cast<unsigned char>(n >> 8));
+  v.push_back(static_cast<unsigned char>(n & 0xFF));
+}
+
+struct record
+{
+  std::string owner;
+  int type;
+  unsigned long ttl;
+  std::size_t rdata;
+  std::size_t rdlength;
+};
+
+} // namespace dns_message_helpers
+
+bool dns_message::build_query(unsigned short id,
+    const std::string& name, int type, std::vector<unsigned char>& query)
+{
+  using namespace dns_message_helpers;
+
+  query.clear();
+  write_u16(query, id);
+  write_u16(query, 0x0100); // Recursion desired.
+  write_u16(query, 1);
+  write_u16(query, 0);
+  write_u16(query, 0);
+  write_u16(query, 0);
+
+  std::size_t length = name.size();
+  if (length > 0 && name[length - 1] == '.')
+    --length;
+  if (length == 0 || length + 2 > max_name_size)
+    return false;
+
+  std::size_t start = 0;
+  while (start <= length)
+  {
+    std::size_t end = name.find('.', start);
+    if (end == std::string::npos || end > length)
+      end = length;
+    std::size_t label_length = end - start;
+    if (label_length == 0 || label_length > max_label_size)
+      return false;
+    query.push_back(static_cast<unsigned char>(label_length));
+    query.insert(query.end(), name.begin() + start, name.begin() + end);
+    start = end + 1;
+  }
+  query.push_back(0);
+
+  write_u16(query, static_cast<unsigned short>(type));
+  write_u16(query, class_in);
+  return true;
+}
+
+bool dns_message::parse_response(const unsigned char* data,
+    std::size_t size, unsigned short id,
+    const std::string& name, int type)
+{
+  using namespace dns_message_helpers;
+
+  truncated_ = false;
+  rcode_ = no_error;
+  addresses_.clear();
+  name_.clear();
+  ttl_ = 0;
+
+  if (size < header_size || read_u16(data) != id)
+    return false;
+
+  unsigned short flags = read_u16(data + 2);
+  if ((flags & 0x8000) == 0)
+    return false;
+  truncated_ = (flags & 0x0200) != 0;
+  rcode_ = flags & 0x000F;
+
+  std::size_t qdcount = read_u16(data + 4);
+  std::size_t ancount = read_u16(data + 6);
+  std::size_t nscount = read_u16(data + 8);
+
+  // The response must echo the question.
+  std::size_t pos = header_size;
+  if (qdcount != 1)
+    return qdcount == 0 && truncated_;
+  std::string question;
+  if (!read_name(data, size, pos, question) || pos + 4 > size)
+    return false;
+  if (!names_equal(question, name) || read_u16(data + pos) != type
+      || read_u16(data + pos + 2) != class_in)
+    return false;
+  pos += 4;
+
+  // A truncated response is only useful as a signal to retry over TCP.
+  if (truncated_)
+    return true;
+
+  std::vector<record> answers;
+  std::vector<record> authority;
+  for (std::size_t i = 0; i < ancount + nscount; ++i)
+  {
+    record r;
+    if (!read_name(data, size, pos, r.owner) || pos + 10 > size)
+      return false;
+    r.type = read_u16(data + pos);
+    int rclass = read_u16(data + pos + 2);
+    r.ttl = read_u32(data + pos + 4) & 0x7FFFFFFF;
+    r.rdlength = read_u16(data + pos + 8);
+    r.rdata = pos + 10;
+    pos = r.rdata + r.rdlength;
+    if (pos > size)
+      return false;
+    if (rclass == class_in)
+      (i < ancount ? answers : authority).push_back(r);
+  }
+
+  // Follow any CNAME chain from the queried name.
+  std::string current = name;
+  bool have_ttl = false;
+  for (int depth = 0; depth < max_cname_chain; ++depth)
+  {
+    bool found = false;
+    for (std::size_t i = 0; i < answers.size() && !found; ++i)
+    {
+      if (answers[i].type == type_cname
+          && names_equal(answers[i].owner, current))
+      {
+        std::size_t target = answers[i].rdata;
+        std::string next;
+        if (!read_name(data, size, target, next))
+          return false;
+        if (!have_ttl || answers[i].ttl < ttl_)
+          ttl_ = answers[i].ttl;
+        have_ttl = true;
+        current = next;
+        found = true;
+      }
+    }
+    if (!found)
+      break;
+  }
+  name_ = current;
+
+  // Collect the records of the requested type.
+  bool answered = false;
+  for (std::size_t i = 0; i < answers.size(); ++i)
+  {
+    const record& r = answers[i];
+    if (r.type != type || !names_equal(r.owner, current))
+      continue;
+
+    if (type == type_a && r.rdlength == 4)
+    {
+      ASIO_LIBNS::ip::address_v4::bytes_type bytes;
+      std::memcpy(bytes.data(), data + r.rdata, 4);
+      addresses_.push_back(ASIO_LIBNS::ip::address_v4(bytes));
+    }
+    else if (type == type_aaaa && r.rdlength == 16)
+    {
+      ASIO_LIBNS::ip::address_v6::bytes_type bytes;
+      std::memcpy(bytes.data(), data + r.rdata, 16);
+      addresses_.push_back(ASIO_LIBNS::ip::address_v6(bytes));
+    }
+    else if (type == type_ptr)
+    {
+      std::size_t target = r.rdata;
+      if (!read_name(data, size, target, name_))
+        return false;
+    }
+    else
+    {
+      continue;
+    }
+
+    if (!have_ttl || r.ttl < ttl_)
+      ttl_ = r.ttl;
+    have_ttl = true;
+    answered = true;
+  }
+
+  // A negative answer may be cached for the lesser of the SOA record's TTL
+  // and its minimum field, as described in RFC 2308.
+  if (!answered)
+  {
+    ttl_ = 0;
+    for (std::size_t i = 0; i < authority.size(); ++i)
+    {
+      if (authority[i].type == type_soa)
+      {
+        std::size_t p = authority[i].rdata;
+        std::string mname, rname;
+        if (read_name(data, size, p, mname)
+            && read_name(data, size, p, rname) && p + 20 <= size)
+        {
+          unsigned long minimum = read_u32(data + p + 16);
+          ttl_ = authority[i].ttl < minimum ? authority[i].ttl : minimum;
+        }
+        break;
+      }
+    }
+    if (type == type_ptr)
+      name_.clear();
+  }
+
+  return true;
+}
+
+std::string dns_message::reverse_name(const ASIO_LIBNS::ip::address& addr)
+{
+  static const char hex[] = "0123456789abcdef";
+  std::string name;
+  if (addr.is_v4())
+  {
+    ASIO_LIBNS::ip::address_v4::bytes_type bytes = addr.to_v4().to_bytes();
+    for (std::size_t i = bytes.size(); i > 0; --i)
+    {
+      char label[4];
+      int n = bytes[i - 1];
+      std::size_t length = 0;
+      if (n >= 100)
+        label[length++] = static_cast<char>('0' + n / 100);
+      if (n >= 10)
+        label[length++] = static_cast<char>('0' + (n / 10) % 10);
+      label[length++] = static_cast<char>('0' + n % 10);
+      name.append(label, length);
+      name += '.';
+    }
+    name += "in-addr.arpa";
+  }
+  else
+  {
+    ASIO_LIBNS::ip::address_v6::bytes_type bytes = addr.to_v6().to_bytes();
+    for (std::size_t i = bytes.size(); i > 0; --i)
+    {
+      name += hex[bytes[i - 1] & 0xF];
+      name += '.';
+      name += hex[bytes[i - 1] >> 4];
+      name += '.';
+    }
+    name += "ip6.arpa";
+  }
+  return name;
+}
+
+bool dns_message::names_equal(const std::string& a, const std::string& b)
+{
+  std::size_t a_length = a.size();
+  if (a_length > 0 && a[a_length - 1] == '.')
+    --a_length;
+  std::size_t b_length = b.size();
+  if (b_length > 0 && b[b_length - 1] == '.')
+    --b_length;
+  if (a_length != b_length)
+    return false;
+  for (std::size_t i = 0; i < a_length; ++i)
+  {
+    char x = a[i], y = b[i];
+    if (x >= 'A' && x <= 'Z')
+      x = static_cast<char>(x - 'A' + 'a');
+    if (y >= 'A' && y <= 'Z')
+      y = static_cast<char>(y - 'A' + 'a');
+    if (x != y)
+      return false;
+  }
+  return true;
+}
+
+bool dns_message::read_name(const unsigned char* data,
+    std::size_t size, std::size_t& pos, std::string& name)
+{
+  using namespace dns_message_helpers;
+
+  name.clear();
+  std::size_t p = pos;
+  bool jumped = false;
+  for (int jumps = 0; jumps < max_compression_jumps;)
+  {
+    if (p >= size)
+      return false;
+    unsigned char length = data[p];
+    if ((length & 0xC0) == 0xC0)
+    {
+      // A compression pointer to an earlier occurrence of the name's suffix.
+      if (p + 2 > size)
+        return false;
+      if (!jumped)
+        pos = p + 2;
+      jumped = true;
+      p = ((length & 0x3F) << 8) | data[p + 1];
+      ++jumps;
+    }
+    else if ((length & 0xC0) != 0)
+    {
+      return false;
+    }
+    else if (length == 0)
+    {
+      if (!jumped)
+        pos = p + 1;
+      return true;
+    }
+    else
+    {
+      if (p + 1 + length > size)
+        return false;
+      if (!name.empty())
+        name += '.';
+      name.append(reinterpret_cast<const char*>(data + p + 1), length);
+      if (name.size() > max_name_size)
+        return false;
+      p += 1 + length;
+    }
+  }
+  return false;
+}
+
+} // namespace detail
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // defined(ASIO_HAS_DNS_RESOLVER)
+
+#endif // ASIO_DETAIL_IMPL_DNS_MESSAGE_IPP
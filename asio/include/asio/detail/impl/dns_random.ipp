@@ -0,0 +1,91 @@
+//
+// detail/impl/dns_random.ipp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_DETAIL_IMPL_DNS_RANDOM_IPP
+#define ASIO_DETAIL_IMPL_DNS_RANDOM_IPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+
+#if defined(ASIO_HAS_DNS_RESOLVER)
+
+#include <cerrno>
+#include <random>
+#include <fcntl.h>
+#include <unistd.h>
+#include "asio/detail/dns_random.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace ASIO_LIBNS {
+namespace detail {
+
+dns_random::dns_random()
+  : used_(buffer_size)
+{
+}
+
+unsigned short dns_random::next()
+{
+  ASIO_LIBNS::detail::mutex::scoped_lock lock(mutex_);
+  if (buffer_size - used_ < 2)
+    refill();
+  unsigned short value = static_cast<unsigned short>(
+      (buffer_[used_] << 8) | buffer_[used_ + 1]);
+  used_ += 2;
+  return value;
+}
+
+void dns_random::reset()
+{
+  ASIO_LIBNS::detail::mutex::scoped_lock lock(mutex_);
+  used_ = buffer_size;
+}
+
+void dns_random::refill()
+{
+  std::size_t filled = 0;
+  int fd = ::open("/dev/urandom", O_RDONLY);
+  if (fd != -1)
+  {
+    while (filled < buffer_size)
+    {
+      ssize_t n = ::read(fd, buffer_ + filled, buffer_size - filled);
+      if (n > 0)
+        filled += static_cast<std::size_t>(n);
+      else if (n == 0 || errno != EINTR)
+        break;
+    }
+    ::close(fd);
+  }
+
+  // Fall back to the standard library's source if /dev/urandom is not
+  // available, e.g. inside a chroot.
+  if (filled < buffer_size)
+  {
+    std::random_device device;
+    for (; filled < buffer_size; ++filled)
+      buffer_[filled] = static_cast<unsigned char>(device());
+  }
+
+  used_ = 0;
+}
+
+} // namespace detail
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // defined(ASIO_HAS_DNS_RESOLVER)
+
+#endif // ASIO_DETAIL_IMPL_DNS_RANDOM_IPP
@@ -0,0 +1,307 @@
+//
+// detail/impl/dns_resolver_service_base.ipp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_DETAIL_IMPL_DNS_RESOLVER_SERVICE_BASE_IPP
+#define ASIO_DETAIL_IMPL_DNS_RESOLVER_SERVICE_BASE_IPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+
+#if defined(ASIO_HAS_DNS_RESOLVER)
+
+#include <cstring>
+#include <sstream>
+#include <sys/stat.h>
+#include "asio/io_context.hpp"
+#include "asio/ip/detail/endpoint.hpp"
+#include "asio/detail/dns_resolver_service_base.hpp"
+#include "asio/detail/socket_ops.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace ASIO_LIBNS {
+namespace detail {
+
+dns_resolver_service_base::dns_resolver_service_base(
+    execution_context& context, const char* resolv_conf_path,
+    const char* hosts_path)
+  : scheduler_(ASIO_LIBNS::use_service<scheduler_impl>(context)),
+    resolv_conf_path_(resolv_conf_path),
+    hosts_path_(hosts_path),
+    last_check_(0),
+    random_(new dns_random)
+{
+}
+
+void dns_resolver_service_base::base_shutdown()
+{
+}
+
+void dns_resolver_service_base::base_notify_fork(
+    execution_context::fork_event fork_ev)
+{
+  // A child must not repeat the parent's query IDs.
+  if (fork_ev == execution_context::fork_child)
+    random_->reset();
+}
+
+void dns_resolver_service_base::construct(
+    dns_resolver_service_base::implementation_type& impl)
+{
+  impl.reset(new dns_lookup::registry);
+}
+
+void dns_resolver_service_base::destroy(
+    dns_resolver_service_base::implementation_type& impl)
+{
+  ASIO_HANDLER_OPERATION((scheduler_.context(),
+        "resolver", &impl, 0, "cancel"));
+
+  if (impl)
+    impl->cancel();
+  impl.reset();
+}
+
+void dns_resolver_service_base::move_construct(implementation_type& impl,
+    implementation_type& other_impl)
+{
+  impl = ASIO_MOVE_CAST(implementation_type)(other_impl);
+  other_impl.reset(new dns_lookup::registry);
+}
+
+void dns_resolver_service_base::move_assign(implementation_type& impl,
+    dns_resolver_service_base&, implementation_type& other_impl)
+{
+  destroy(impl);
+  impl = ASIO_MOVE_CAST(implementation_type)(other_impl);
+  other_impl.reset(new dns_lookup::registry);
+}
+
+void dns_resolver_service_base::cancel(
+    dns_resolver_service_base::implementation_type& impl)
+{
+  ASIO_HANDLER_OPERATION((scheduler_.context(),
+        "resolver", &impl, 0, "cancel"));
+
+  impl->cancel();
+}
+
+void dns_resolver_service_base::do_resolve(const std::string& host_name,
+    const std::string& service_name, const addrinfo_type& hints,
+    dns_lookup_result& result, unsigned short& port,
+    ASIO_LIBNS::error_code& ec)
+{
+  if (resolve_locally(host_name, service_name, hints, result, port, ec))
+    return;
+
+  resolve_service(service_name, hints, port, ec);
+  if (ec)
+    return;
+
+  // Run the lookup to completion on a private io_context.
+  ASIO_LIBNS::io_context io_context(1);
+  shared_ptr<dns_lookup> lookup(new dns_lookup(io_context.get_executor(),
+        current_config(), random_, 0, 0));
+  dns_lookup::start_query(lookup, host_name, hints.ai_family, hints.ai_flags);
+  io_context.run();
+
+  result = lookup->result();
+  ec = lookup->error();
+}
+
+shared_ptr<dns_lookup> dns_resolver_service_base::begin_resolve(
+    implementation_type& impl, const std::string& host_name,
+    const std::string& service_name, const addrinfo_type& hints,
+    dns_resolve_op* op, unsigned short& port,
+    const ASIO_LIBNS::any_io_executor& io_ex)
+{
+  if (!resolve_locally(host_name, service_name,
+        hints, op->result_, port, op->ec_))
+  {
+    resolve_service(service_name, hints, port, op->ec_);
+    if (!op->ec_)
+    {
+      shared_ptr<dns_lookup> lookup(new dns_lookup(io_ex,
+            current_config(), random_, &scheduler_, op));
+      impl->add(lookup);
+      scheduler_.work_started();
+      return lookup;
+    }
+  }
+
+  scheduler_.post_immediate_completion(op, false);
+  return shared_ptr<dns_lookup>();
+}
+
+void dns_resolver_service_base::do_resolve(
+    const ASIO_LIBNS::ip::address& address, unsigned short port,
+    int sock_type, dns_lookup_result& result, std::string& service_name,
+    ASIO_LIBNS::error_code& ec)
+{
+  resolve_port(address, port, sock_type, service_name, ec);
+  if (ec)
+    return;
+
+  ASIO_LIBNS::io_context io_context(1);
+  shared_ptr<dns_lookup> lookup(new dns_lookup(io_context.get_executor(),
+        current_config(), random_, 0, 0));
+  dns_lookup::start_reverse(lookup, address);
+  io_context.run();
+
+  result = lookup->result();
+  ec = lookup->error();
+}
+
+shared_ptr<dns_lookup> dns_resolver_service_base::begin_resolve(
+    implementation_type& impl, const ASIO_LIBNS::ip::address& address,
+    unsigned short port, int sock_type, dns_resolve_op* op,
+    std::string& service_name, const ASIO_LIBNS::any_io_executor& io_ex)
+{
+  resolve_port(address, port, sock_type, service_name, op->ec_);
+  if (op->ec_)
+  {
+    scheduler_.post_immediate_completion(op, false);
+    return shared_ptr<dns_lookup>();
+  }
+
+  shared_ptr<dns_lookup> lookup(new dns_lookup(io_ex,
+        current_config(), random_, &scheduler_, op));
+  impl->add(lookup);
+  scheduler_.work_started();
+  return lookup;
+}
+
+bool dns_resolver_service_base::resolve_locally(const std::string& host_name,
+    const std::string& service_name, const addrinfo_type& hints,
+    dns_lookup_result& result, unsigned short& port,
+    ASIO_LIBNS::error_code& ec)
+{
+  if (!host_name.empty()
+      && (hints.ai_flags & ASIO_OS_DEF(AI_NUMERICHOST)) == 0)
+  {
+    ASIO_LIBNS::error_code address_ec;
+    ASIO_LIBNS::ip::make_address(host_name.c_str(), address_ec);
+    if (address_ec)
+      return false;
+  }
+
+  // Numeric and empty host names involve no queries, so the system's
+  // getaddrinfo may be used to apply the hints.
+  addrinfo_type* address_info = 0;
+  socket_ops::getaddrinfo(host_name.c_str(),
+      service_name.c_str(), hints, &address_info, ec);
+  for (addrinfo_type* ai = address_info; ai; ai = ai->ai_next)
+  {
+    if (ai->ai_family == ASIO_OS_DEF(AF_INET)
+        || ai->ai_family == ASIO_OS_DEF(AF_INET6))
+    {
+      ASIO_LIBNS::ip::detail::endpoint endpoint;
+      endpoint.resize(static_cast<std::size_t>(ai->ai_addrlen));
+      std::memcpy(endpoint.data(), ai->ai_addr, ai->ai_addrlen);
+      result.addresses.push_back(endpoint.address());
+      port = endpoint.port();
+    }
+  }
+  if (address_info)
+    socket_ops::freeaddrinfo(address_info);
+  return true;
+}
+
+void dns_resolver_service_base::resolve_service(
+    const std::string& service_name, const addrinfo_type& hints,
+    unsigned short& port, ASIO_LIBNS::error_code& ec)
+{
+  port = 0;
+  if (service_name.empty())
+    return;
+
+  addrinfo_type service_hints = addrinfo_type();
+  service_hints.ai_family = ASIO_OS_DEF(AF_INET);
+  service_hints.ai_socktype = hints.ai_socktype;
+  service_hints.ai_protocol = hints.ai_protocol;
+  service_hints.ai_flags = ASIO_OS_DEF(AI_PASSIVE)
+    | (hints.ai_flags & ASIO_OS_DEF(AI_NUMERICSERV));
+
+  addrinfo_type* address_info = 0;
+  socket_ops::getaddrinfo("", service_name.c_str(),
+      service_hints, &address_info, ec);
+  if (address_info)
+  {
+    ASIO_LIBNS::ip::detail::endpoint endpoint;
+    endpoint.resize(static_cast<std::size_t>(address_info->ai_addrlen));
+    std::memcpy(endpoint.data(), address_info->ai_addr,
+        address_info->ai_addrlen);
+    port = endpoint.port();
+    socket_ops::freeaddrinfo(address_info);
+  }
+}
+
+void dns_resolver_service_base::resolve_port(
+    const ASIO_LIBNS::ip::address& address, unsigned short port,
+    int sock_type, std::string& service_name, ASIO_LIBNS::error_code& ec)
+{
+  // As with sync_getnameinfo, fall back to a numeric service name, but leave
+  // the address to be looked up by the caller.
+  ASIO_LIBNS::ip::detail::endpoint endpoint(address, port);
+  char host[NI_MAXHOST];
+  char service[NI_MAXSERV];
+  int flags = NI_NUMERICHOST
+    | (sock_type == ASIO_OS_DEF(SOCK_DGRAM) ? NI_DGRAM : 0);
+  socket_ops::getnameinfo(endpoint.data(), endpoint.size(),
+      host, NI_MAXHOST, service, NI_MAXSERV, flags, ec);
+  if (ec)
+  {
+    socket_ops::getnameinfo(endpoint.data(), endpoint.size(), host,
+        NI_MAXHOST, service, NI_MAXSERV, flags | NI_NUMERICSERV, ec);
+  }
+  if (!ec)
+    service_name = service;
+}
+
+shared_ptr<const dns_config> dns_resolver_service_base::current_config()
+{
+  ASIO_LIBNS::detail::mutex::scoped_lock lock(mutex_);
+
+  // The files are checked for changes at most once per second.
+  std::time_t now = std::time(0);
+  if (config_ && now == last_check_)
+    return config_;
+  last_check_ = now;
+
+  std::ostringstream state;
+  struct stat st;
+  if (::stat(resolv_conf_path_.c_str(), &st) == 0)
+    state << st.st_mtime << ':' << st.st_size;
+  state << '/';
+  if (::stat(hosts_path_.c_str(), &st) == 0)
+    state << st.st_mtime << ':' << st.st_size;
+
+  if (!config_ || state.str() != file_state_)
+  {
+    shared_ptr<dns_config> config(new dns_config);
+    config->load(resolv_conf_path_, hosts_path_);
+    config_ = config;
+    file_state_ = state.str();
+  }
+
+  return config_;
+}
+
+} // namespace detail
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // defined(ASIO_HAS_DNS_RESOLVER)
+
+#endif // ASIO_DETAIL_IMPL_DNS_RESOLVER_SERVICE_BASE_IPP
@@ -21,7 +21,6 @@
   && defined(ASIO_HAS_IO_URING)
 
 #include <cstring>
-#include <sys/stat.h>
 #include "asio/detail/io_uring_file_service.hpp"
 
 #include "asio/detail/push_options.hpp"
@@ -32,6 +31,8 @@ namespace detail {
 io_uring_file_service::io_uring_file_service(
     execution_context& context)
   : execution_context_service_base<io_uring_file_service>(context),
+    scheduler_(ASIO_LIBNS::use_service<scheduler>(context)),
+    io_uring_service_(ASIO_LIBNS::use_service<io_uring_service>(context)),
     descriptor_service_(context)
 {
 }
@@ -79,19 +80,25 @@ uint64_t io_uring_file_service::size(
     const io_uring_file_service::implementation_type& impl,
     ASIO_LIBNS::error_code& ec) const
 {
-  struct stat s;
-  int result = ::fstat(native_handle(impl), &s);
-  descriptor_ops::get_last_error(ec, result != 0);
+  uint64_t result = descriptor_ops::file_size(native_handle(impl), ec);
   ASIO_ERROR_LOCATION(ec);
-  return !ec ? s.st_size : 0;
+  return result;
+}
+
+std::size_t io_uring_file_service::alignment(
+    const io_uring_file_service::implementation_type& impl,
+    ASIO_LIBNS::error_code& ec) const
+{
+  std::size_t result = descriptor_ops::file_alignment(native_handle(impl), ec);
+  ASIO_ERROR_LOCATION(ec);
+  return result;
 }
 
 ASIO_LIBNS::error_code io_uring_file_service::resize(
     io_uring_file_service::implementation_type& impl,
     uint64_t n, ASIO_LIBNS::error_code& ec)
 {
-  int result = ::ftruncate(native_handle(impl), n);
-  descriptor_ops::get_last_error(ec, result != 0);
+  descriptor_ops::ftruncate(native_handle(impl), n, ec);
   ASIO_ERROR_LOCATION(ec);
   return ec;
 }
@@ -100,8 +107,7 @@ ASIO_LIBNS::error_code io_uring_file_service::sync_all(
     io_uring_file_service::implementation_type& impl,
     ASIO_LIBNS::error_code& ec)
 {
-  int result = ::fsync(native_handle(impl));
-  descriptor_ops::get_last_error(ec, result != 0);
+  descriptor_ops::fsync(native_handle(impl), ec);
   return ec;
 }
 
@@ -109,12 +115,16 @@ ASIO_LIBNS::error_code io_uring_file_service::sync_data(
     io_uring_file_service::implementation_type& impl,
     ASIO_LIBNS::error_code& ec)
 {
-#if defined(_POSIX_SYNCHRONIZED_IO)
-  int result = ::fdatasync(native_handle(impl));
-#else // defined(_POSIX_SYNCHRONIZED_IO)
-  int result = ::fsync(native_handle(impl));
-#endif // defined(_POSIX_SYNCHRONIZED_IO)
-  descriptor_ops::get_last_error(ec, result != 0);
+  descriptor_ops::fdatasync(native_handle(impl), ec);
+  ASIO_ERROR_LOCATION(ec);
+  return ec;
+}
+
+ASIO_LIBNS::error_code io_uring_file_service::allocate(
+    io_uring_file_service::implementation_type& impl,
+    uint64_t offset, uint64_t length, ASIO_LIBNS::error_code& ec)
+{
+  descriptor_ops::fallocate(native_handle(impl), offset, length, ec);
   ASIO_ERROR_LOCATION(ec);
   return ec;
 }
@@ -129,6 +139,91 @@ uint64_t io_uring_file_service::seek(
   return !ec ? static_cast<uint64_t>(result) : 0;
 }
 
+void io_uring_file_service::complete_open(
+    io_uring_file_open_op_base<io_uring_file_service>* op, bool deliver)
+{
+  ASIO_LIBNS::detail::mutex::scoped_lock lock(mutex_);
+
+  // The operation was submitted without a file, so its io object is freed
+  // here.
+  if (deliver && op->io_uring_service_)
+  {
+    op->io_uring_service_->cleanup_io_object(op->io_object_data_);
+    op->io_uring_service_ = 0;
+  }
+
+  implementation_type* impl = op->impl_;
+  if (impl)
+  {
+    impl->pending_open_ = 0;
+    op->impl_ = 0;
+  }
+
+  int fd = op->descriptor();
+  if (fd == -1)
+    return;
+  op->release_descriptor();
+
+  if (impl && deliver)
+  {
+    // Take ownership of the file descriptor.
+    if (!descriptor_service_.assign(*impl, fd, op->ec_))
+    {
+      (void)::posix_fadvise(fd, 0, 0,
+          impl->is_stream_ ? POSIX_FADV_SEQUENTIAL : POSIX_FADV_RANDOM);
+      return;
+    }
+  }
+  else
+  {
+    // The file was closed or destroyed while the open was in progress.
+    op->ec_ = ASIO_LIBNS::error::operation_aborted;
+  }
+
+  descriptor_ops::state_type state = 0;
+  ASIO_LIBNS::error_code ignored_ec;
+  descriptor_ops::close(fd, state, ignored_ec);
+}
+
+void io_uring_file_service::start_internal_op(
+    io_uring_file_control_op_base* op)
+{
+  op->io_uring_service_ = &io_uring_service_;
+  scheduler_.work_started();
+  io_uring_service_.register_internal_io_object(
+      op->io_object_data_, io_uring_service::write_op, op);
+}
+
+bool io_uring_file_service::begin_open(
+    io_uring_file_service::implementation_type& impl,
+    io_uring_file_open_op_base<io_uring_file_service>* op)
+{
+  ASIO_LIBNS::detail::mutex::scoped_lock lock(mutex_);
+  if (is_open(impl) || impl.pending_open_)
+  {
+    op->ec_ = ASIO_LIBNS::error::already_open;
+    return false;
+  }
+
+  impl.pending_open_ = op;
+  op->impl_ = &impl;
+  return true;
+}
+
+void io_uring_file_service::move_pending_open(
+    io_uring_file_service::implementation_type& impl,
+    io_uring_file_service::implementation_type* new_impl)
+{
+  ASIO_LIBNS::detail::mutex::scoped_lock lock(mutex_);
+  if (impl.pending_open_)
+  {
+    impl.pending_open_->impl_ = new_impl;
+    if (new_impl)
+      new_impl->pending_open_ = impl.pending_open_;
+    impl.pending_open_ = 0;
+  }
+}
+
 } // namespace detail
 } // namespace asio
 
@@ -0,0 +1,168 @@
+//
+// detail/impl/mapped_file_service.ipp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_DETAIL_IMPL_MAPPED_FILE_SERVICE_IPP
+#define ASIO_DETAIL_IMPL_MAPPED_FILE_SERVICE_IPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+
+#if defined(ASIO_HAS_MAPPED_FILE)
+
+#include "asio/detail/mapped_file_service.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace ASIO_LIBNS {
+namespace detail {
+
+class mapped_file_service::work_scheduler_runner
+{
+public:
+  work_scheduler_runner(scheduler_impl& work_scheduler)
+    : work_scheduler_(work_scheduler)
+  {
+  }
+
+  void operator()()
+  {
+    ASIO_LIBNS::error_code ec;
+    work_scheduler_.run(ec);
+  }
+
+private:
+  scheduler_impl& work_scheduler_;
+};
+
+mapped_file_service::mapped_file_service(execution_context& context)
+  : execution_context_service_base<mapped_file_service>(context),
+    scheduler_(ASIO_LIBNS::use_service<scheduler_impl>(context)),
+    work_scheduler_(new scheduler_impl(context, -1, false)),
+    work_thread_(0)
+{
+  work_scheduler_->work_started();
+}
+
+mapped_file_service::~mapped_file_service()
+{
+  shutdown();
+}
+
+void mapped_file_service::shutdown()
+{
+  if (work_scheduler_.get())
+  {
+    work_scheduler_->work_finished();
+    work_scheduler_->stop();
+    if (work_thread_.get())
+    {
+      work_thread_->join();
+      work_thread_.reset();
+    }
+    work_scheduler_.reset();
+  }
+}
+
+void mapped_file_service::notify_fork(
+    execution_context::fork_event fork_ev)
+{
+  if (work_thread_.get())
+  {
+    if (fork_ev == execution_context::fork_prepare)
+    {
+      work_scheduler_->stop();
+      work_thread_->join();
+      work_thread_.reset();
+    }
+  }
+  else if (fork_ev != execution_context::fork_prepare)
+  {
+    work_scheduler_->restart();
+  }
+}
+
+ASIO_LIBNS::error_code mapped_file_service::open(
+    mapped_file_service::implementation_type& impl,
+    const char* path, file_base::flags open_flags,
+    ASIO_LIBNS::error_code& ec)
+{
+  if (is_open(impl))
+  {
+    ec = ASIO_LIBNS::error::already_open;
+    ASIO_ERROR_LOCATION(ec);
+    return ec;
+  }
+
+  implementation_type region(new mapped_region);
+  if (!region->map(path, open_flags, ec))
+    impl = region;
+
+  ASIO_ERROR_LOCATION(ec);
+  return ec;
+}
+
+ASIO_LIBNS::error_code mapped_file_service::sync(
+    mapped_file_service::implementation_type& impl,
+    ASIO_LIBNS::error_code& ec)
+{
+  if (!is_open(impl))
+  {
+    ec = ASIO_LIBNS::error::bad_descriptor;
+    ASIO_ERROR_LOCATION(ec);
+    return ec;
+  }
+
+  impl->sync(ec);
+  ASIO_ERROR_LOCATION(ec);
+  return ec;
+}
+
+void mapped_file_service::start_op(mapped_file_op_base* op)
+{
+  if (!op->region())
+  {
+    op->ec_ = ASIO_LIBNS::error::bad_descriptor;
+    scheduler_.post_immediate_completion(op, false);
+  }
+  else if (ASIO_CONCURRENCY_HINT_IS_LOCKING(SCHEDULER,
+        scheduler_.concurrency_hint()))
+  {
+    start_work_thread();
+    scheduler_.work_started();
+    work_scheduler_->post_immediate_completion(op, false);
+  }
+  else
+  {
+    op->perform();
+    scheduler_.post_immediate_completion(op, false);
+  }
+}
+
+void mapped_file_service::start_work_thread()
+{
+  ASIO_LIBNS::detail::mutex::scoped_lock lock(mutex_);
+  if (!work_thread_.get())
+  {
+    work_thread_.reset(new ASIO_LIBNS::detail::thread(
+          work_scheduler_runner(*work_scheduler_)));
+  }
+}
+
+} // namespace detail
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // defined(ASIO_HAS_MAPPED_FILE)
+
+#endif // ASIO_DETAIL_IMPL_MAPPED_FILE_SERVICE_IPP
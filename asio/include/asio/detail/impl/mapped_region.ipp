@@ -0,0 +1,275 @@
+//
+// detail/impl/mapped_region.ipp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_DETAIL_IMPL_MAPPED_REGION_IPP
+#define ASIO_DETAIL_IMPL_MAPPED_REGION_IPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+
+#if defined(ASIO_HAS_MAPPED_FILE)
+
+#include <cerrno>
+#include <limits>
+#include "asio/detail/cstdint.hpp"
+#include "asio/detail/mapped_region.hpp"
+
+#if !defined(ASIO_WINDOWS)
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+# include "asio/detail/descriptor_ops.hpp"
+#endif // !defined(ASIO_WINDOWS)
+
+#include "asio/detail/push_options.hpp"
+
+namespace ASIO_LIBNS {
+namespace detail {
+
+#if defined(ASIO_WINDOWS)
+
+ASIO_LIBNS::error_code mapped_region::map(const char* path,
+    file_base::flags open_flags, ASIO_LIBNS::error_code& ec)
+{
+  bool writable = (open_flags
+      & (file_base::write_only | file_base::read_write)) != 0;
+
+  DWORD access = GENERIC_READ | (writable ? GENERIC_WRITE : 0);
+  DWORD share = FILE_SHARE_READ | FILE_SHARE_WRITE;
+  DWORD disposition = (open_flags & file_base::create) != 0
+    ? OPEN_ALWAYS : OPEN_EXISTING;
+
+  HANDLE file = ::CreateFileA(path, access, share,
+      0, disposition, FILE_ATTRIBUTE_NORMAL, 0);
+  if (file == INVALID_HANDLE_VALUE)
+  {
+    DWORD last_error = ::GetLastError();
+    ec.assign(last_error, ASIO_LIBNS::error::get_system_category());
+    return ec;
+  }
+
+  LARGE_INTEGER file_size;
+  if (!::GetFileSizeEx(file, &file_size))
+  {
+    DWORD last_error = ::GetLastError();
+    ::CloseHandle(file);
+    ec.assign(last_error, ASIO_LIBNS::error::get_system_category());
+    return ec;
+  }
+
+  if (static_cast<uint64_t>(file_size.QuadPart)
+      > (std::numeric_limits<std::size_t>::max)())
+  {
+    ::CloseHandle(file);
+    ec = ASIO_LIBNS::error::no_memory;
+    return ec;
+  }
+
+  void* data = 0;
+  if (file_size.QuadPart > 0)
+  {
+    // The view keeps the mapping object alive once it has been created.
+    HANDLE mapping = ::CreateFileMappingA(file, 0,
+        writable ? PAGE_READWRITE : PAGE_READONLY, 0, 0, 0);
+    if (mapping)
+    {
+      data = ::MapViewOfFile(mapping,
+          writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0);
+    }
+    DWORD last_error = ::GetLastError();
+    if (mapping)
+      ::CloseHandle(mapping);
+    if (!data)
+    {
+      ::CloseHandle(file);
+      ec.assign(last_error, ASIO_LIBNS::error::get_system_category());
+      return ec;
+    }
+  }
+
+  data_ = data;
+  size_ = static_cast<std::size_t>(file_size.QuadPart);
+  writable_ = writable;
+  file_ = file;
+  ASIO_LIBNS::error::clear(ec);
+  return ec;
+}
+
+ASIO_LIBNS::error_code mapped_region::sync(ASIO_LIBNS::error_code& ec)
+{
+  if (writable_ && data_)
+  {
+    if (!::FlushViewOfFile(data_, size_) || !::FlushFileBuffers(file_))
+    {
+      DWORD last_error = ::GetLastError();
+      ec.assign(last_error, ASIO_LIBNS::error::get_system_category());
+      return ec;
+    }
+  }
+
+  ASIO_LIBNS::error::clear(ec);
+  return ec;
+}
+
+void mapped_region::unmap()
+{
+  if (data_)
+    ::UnmapViewOfFile(data_);
+  if (file_ != INVALID_HANDLE_VALUE)
+    ::CloseHandle(file_);
+  data_ = 0;
+  size_ = 0;
+  file_ = INVALID_HANDLE_VALUE;
+}
+
+std::size_t mapped_region::page_size()
+{
+  SYSTEM_INFO system_info;
+  ::GetSystemInfo(&system_info);
+  return system_info.dwPageSize;
+}
+
+#else // defined(ASIO_WINDOWS)
+
+ASIO_LIBNS::error_code mapped_region::map(const char* path,
+    file_base::flags open_flags, ASIO_LIBNS::error_code& ec)
+{
+  // A shared, writable mapping requires the file to be open for reading.
+  bool writable = (open_flags
+      & (file_base::write_only | file_base::read_write)) != 0;
+  int flags = (writable ? O_RDWR : O_RDONLY) | (open_flags
+      & (file_base::create | file_base::exclusive | file_base::truncate));
+
+  int fd = descriptor_ops::open(path, flags, 0777, ec);
+  if (fd < 0)
+    return ec;
+
+  struct stat s;
+  int result = ::fstat(fd, &s);
+  descriptor_ops::get_last_error(ec, result != 0);
+
+  if (!ec && static_cast<uint64_t>(s.st_size)
+      > (std::numeric_limits<std::size_t>::max)())
+    ec = ASIO_LIBNS::error::no_memory;
+
+  void* data = 0;
+  if (!ec && s.st_size > 0)
+  {
+    data = ::mmap(0, static_cast<std::size_t>(s.st_size),
+        PROT_READ | (writable ? PROT_WRITE : 0), MAP_SHARED, fd, 0);
+    descriptor_ops::get_last_error(ec, data == MAP_FAILED);
+  }
+
+  // The mapping does not need the descriptor once it has been created.
+  descriptor_ops::state_type state = 0;
+  ASIO_LIBNS::error_code ignored_ec;
+  descriptor_ops::close(fd, state, ignored_ec);
+
+  if (ec)
+    return ec;
+
+  data_ = data;
+  size_ = static_cast<std::size_t>(s.st_size);
+  writable_ = writable;
+  return ec;
+}
+
+ASIO_LIBNS::error_code mapped_region::sync(ASIO_LIBNS::error_code& ec)
+{
+  if (writable_ && data_)
+  {
+    int result = ::msync(data_, size_, MS_SYNC);
+    descriptor_ops::get_last_error(ec, result != 0);
+    return ec;
+  }
+
+  ASIO_LIBNS::error::clear(ec);
+  return ec;
+}
+
+void mapped_region::unmap()
+{
+  if (data_)
+    ::munmap(data_, size_);
+  data_ = 0;
+  size_ = 0;
+}
+
+std::size_t mapped_region::page_size()
+{
+  long result = ::sysconf(_SC_PAGESIZE);
+  return result > 0 ? static_cast<std::size_t>(result) : 4096;
+}
+
+#endif // defined(ASIO_WINDOWS)
+
+ASIO_LIBNS::error_code mapped_region::prefetch(std::size_t offset,
+    std::size_t length, ASIO_LIBNS::error_code& ec)
+{
+  ASIO_LIBNS::error::clear(ec);
+  if (offset >= size_ || length == 0)
+    return ec;
+  if (length > size_ - offset)
+    length = size_ - offset;
+
+  // Widen the range to whole pages.
+  std::size_t page = page_size();
+  char* begin = static_cast<char*>(data_) + (offset - offset % page);
+  char* end = static_cast<char*>(data_) + offset + length;
+  std::size_t range = static_cast<std::size_t>(end - begin);
+
+#if defined(ASIO_WINDOWS)
+# if defined(_WIN32_WINNT) && (_WIN32_WINNT >= 0x0602)
+  // Start reading all of the pages at once.
+  WIN32_MEMORY_RANGE_ENTRY entry;
+  entry.VirtualAddress = begin;
+  entry.NumberOfBytes = range;
+  ::PrefetchVirtualMemory(::GetCurrentProcess(), 1, &entry, 0);
+# endif // defined(_WIN32_WINNT) && (_WIN32_WINNT >= 0x0602)
+#else // defined(ASIO_WINDOWS)
+# if defined(MADV_POPULATE_READ)
+  // Linux 5.14 and later fault the pages in and report any I/O error.
+  int result;
+  do
+    result = ::madvise(begin, range, MADV_POPULATE_READ);
+  while (result != 0 && errno == EINTR);
+  if (result == 0 || errno != EINVAL)
+  {
+    descriptor_ops::get_last_error(ec, result != 0);
+    return ec;
+  }
+# endif // defined(MADV_POPULATE_READ)
+
+  // Start reading all of the pages at once.
+# if defined(POSIX_MADV_WILLNEED)
+  ::posix_madvise(begin, range, POSIX_MADV_WILLNEED);
+# endif // defined(POSIX_MADV_WILLNEED)
+#endif // defined(ASIO_WINDOWS)
+
+  // Touch each page so that the data is resident when this returns.
+  volatile char sink = 0;
+  for (const char* p = begin; p < end; p += page)
+    sink = *p;
+  (void)sink;
+
+  return ec;
+}
+
+} // namespace detail
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // defined(ASIO_HAS_MAPPED_FILE)
+
+#endif // ASIO_DETAIL_IMPL_MAPPED_REGION_IPP
@@ -0,0 +1,215 @@
+//
+// detail/impl/mirrored_region.ipp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_DETAIL_IMPL_MIRRORED_REGION_IPP
+#define ASIO_DETAIL_IMPL_MIRRORED_REGION_IPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+
+#if defined(ASIO_HAS_RING_BUFFER)
+
+#include <limits>
+#include "asio/detail/cstdint.hpp"
+#include "asio/detail/mirrored_region.hpp"
+
+#if defined(ASIO_WINDOWS)
+# include "asio/detail/socket_types.hpp"
+#else // defined(ASIO_WINDOWS)
+# include <cerrno>
+# include <cstdio>
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <unistd.h>
+# include "asio/detail/descriptor_ops.hpp"
+#endif // defined(ASIO_WINDOWS)
+
+#include "asio/detail/push_options.hpp"
+
+namespace ASIO_LIBNS {
+namespace detail {
+
+ASIO_LIBNS::error_code mirrored_region::map(
+    std::size_t min_size, ASIO_LIBNS::error_code& ec)
+{
+  std::size_t size = granularity();
+  while (size < min_size)
+  {
+    if (size > (std::numeric_limits<std::size_t>::max)() / 4)
+    {
+      ec = ASIO_LIBNS::error::no_memory;
+      return ec;
+    }
+    size *= 2;
+  }
+
+#if defined(ASIO_WINDOWS)
+  HANDLE mapping = ::CreateFileMappingW(INVALID_HANDLE_VALUE, 0,
+      PAGE_READWRITE, static_cast<DWORD>(static_cast<uint64_t>(size) >> 32),
+      static_cast<DWORD>(size & 0xFFFFFFFF), 0);
+  if (!mapping)
+  {
+    DWORD last_error = ::GetLastError();
+    ec.assign(last_error, ASIO_LIBNS::error::get_system_category());
+    return ec;
+  }
+
+  // The address range is released before the views are mapped into it, and
+  // so another thread may claim it first. Try again with a new range if so.
+  char* data = 0;
+  DWORD last_error = 0;
+  for (int attempt = 0; attempt < 16 && !data; ++attempt)
+  {
+    void* base = ::VirtualAlloc(0, size * 2, MEM_RESERVE, PAGE_NOACCESS);
+    if (!base)
+    {
+      last_error = ::GetLastError();
+      break;
+    }
+    ::VirtualFree(base, 0, MEM_RELEASE);
+
+    void* first = ::MapViewOfFileEx(mapping,
+        FILE_MAP_ALL_ACCESS, 0, 0, size, base);
+    void* second = first ? ::MapViewOfFileEx(mapping, FILE_MAP_ALL_ACCESS,
+        0, 0, size, static_cast<char*>(base) + size) : 0;
+    if (second)
+      data = static_cast<char*>(base);
+    else
+    {
+      last_error = ::GetLastError();
+      if (first)
+        ::UnmapViewOfFile(first);
+    }
+  }
+
+  // The views keep the memory alive.
+  ::CloseHandle(mapping);
+
+  if (!data)
+  {
+    ec.assign(last_error, ASIO_LIBNS::error::get_system_category());
+    return ec;
+  }
+#else // defined(ASIO_WINDOWS)
+  // Create an anonymous shared memory object to be mapped twice.
+# if defined(__linux__) && defined(__GLIBC__) \
+  && ((__GLIBC__ > 2) || ((__GLIBC__ == 2) && (__GLIBC_MINOR__ >= 27)))
+  int fd = ::memfd_create("asio.ring_buffer", MFD_CLOEXEC);
+# elif defined(SHM_ANON)
+  int fd = ::shm_open(SHM_ANON, O_RDWR | O_CREAT, 0600);
+# else
+  int fd = -1;
+  for (int attempt = 0; fd == -1 && attempt < 16; ++attempt)
+  {
+    char name[64];
+    std::snprintf(name, sizeof(name), "/asio.ring_buffer.%ld.%p.%d",
+        static_cast<long>(::getpid()), static_cast<void*>(this), attempt);
+    fd = ::shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd != -1)
+      ::shm_unlink(name);
+    else if (errno != EEXIST)
+      break;
+  }
+# endif
+  if (fd == -1)
+  {
+    descriptor_ops::get_last_error(ec, true);
+    return ec;
+  }
+
+  if (::ftruncate(fd, static_cast<off_t>(size)) != 0)
+  {
+    descriptor_ops::get_last_error(ec, true);
+    ::close(fd);
+    return ec;
+  }
+
+  // Reserve an address range for both views, then map the object over each
+  // half of it.
+# if defined(MAP_ANONYMOUS)
+  int anonymous = MAP_ANONYMOUS;
+# else // defined(MAP_ANONYMOUS)
+  int anonymous = MAP_ANON;
+# endif // defined(MAP_ANONYMOUS)
+  void* base = ::mmap(0, size * 2, PROT_NONE,
+      MAP_PRIVATE | anonymous, -1, 0);
+  if (base == MAP_FAILED)
+  {
+    descriptor_ops::get_last_error(ec, true);
+    ::close(fd);
+    return ec;
+  }
+
+  void* first = ::mmap(base, size, PROT_READ | PROT_WRITE,
+      MAP_SHARED | MAP_FIXED, fd, 0);
+  void* second = first != MAP_FAILED
+    ? ::mmap(static_cast<char*>(base) + size, size,
+        PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0)
+    : MAP_FAILED;
+  if (second == MAP_FAILED)
+  {
+    descriptor_ops::get_last_error(ec, true);
+    ::munmap(base, size * 2);
+    ::close(fd);
+    return ec;
+  }
+
+  // The mappings keep the memory alive.
+  ::close(fd);
+
+  char* data = static_cast<char*>(base);
+#endif // defined(ASIO_WINDOWS)
+
+  unmap();
+  data_ = data;
+  size_ = size;
+
+  ASIO_LIBNS::error::clear(ec);
+  return ec;
+}
+
+void mirrored_region::unmap()
+{
+  if (data_)
+  {
+#if defined(ASIO_WINDOWS)
+    ::UnmapViewOfFile(data_);
+    ::UnmapViewOfFile(data_ + size_);
+#else // defined(ASIO_WINDOWS)
+    ::munmap(data_, size_ * 2);
+#endif // defined(ASIO_WINDOWS)
+    data_ = 0;
+    size_ = 0;
+  }
+}
+
+std::size_t mirrored_region::granularity()
+{
+#if defined(ASIO_WINDOWS)
+  SYSTEM_INFO system_info;
+  ::GetSystemInfo(&system_info);
+  return system_info.dwAllocationGranularity;
+#else // defined(ASIO_WINDOWS)
+  long result = ::sysconf(_SC_PAGESIZE);
+  return result > 0 ? static_cast<std::size_t>(result) : 4096;
+#endif // defined(ASIO_WINDOWS)
+}
+
+} // namespace detail
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // defined(ASIO_HAS_RING_BUFFER)
+
+#endif // ASIO_DETAIL_IMPL_MIRRORED_REGION_IPP
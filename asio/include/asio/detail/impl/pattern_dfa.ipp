@@ -0,0 +1,295 @@
+//
+// detail/impl/pattern_dfa.ipp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_DETAIL_IMPL_PATTERN_DFA_IPP
+#define ASIO_DETAIL_IMPL_PATTERN_DFA_IPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+#include <cctype>
+#include <map>
+#include <stdexcept>
+#include "asio/detail/pattern_dfa.hpp"
+#include "asio/detail/throw_exception.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace ASIO_LIBNS {
+namespace detail {
+
+pattern_dfa::pattern_dfa(const std::vector<std::string>& patterns)
+{
+  // Split each pattern into its alternatives and parse them. The start
+  // positions are the first atoms of the alternatives.
+  std::vector<std::size_t> starts;
+  for (std::size_t p = 0; p < patterns.size(); ++p)
+  {
+    const std::string& pattern = patterns[p];
+    std::size_t begin = 0;
+    bool escaped = false, bracketed = false;
+    for (std::size_t i = 0; i <= pattern.size(); ++i)
+    {
+      if (i < pattern.size())
+      {
+        char c = pattern[i];
+        bool separator = false;
+        if (escaped)
+          escaped = false;
+        else if (c == '\\')
+          escaped = true;
+        else if (c == '[')
+          bracketed = true;
+        else if (c == ']')
+          bracketed = false;
+        else
+          separator = !bracketed && c == '|';
+        if (!separator)
+          continue;
+      }
+
+      starts.push_back(atoms_.size());
+      parse(pattern.substr(begin, i - begin), atoms_);
+      atom end_atom = atom();
+      end_atom.pattern = p + 1;
+      atoms_.push_back(end_atom);
+      begin = i + 1;
+    }
+  }
+
+  if (starts.empty())
+  {
+    std::invalid_argument ex("no patterns");
+    ASIO_LIBNS::detail::throw_exception(ex);
+  }
+
+  // A match may begin at any byte, and so every state includes the start
+  // positions.
+  std::vector<bool> initial(atoms_.size(), false);
+  for (std::size_t i = 0; i < starts.size(); ++i)
+    close(starts[i], initial);
+  for (std::size_t i = 0; i < atoms_.size(); ++i)
+  {
+    if (initial[i] && atoms_[i].pattern)
+    {
+      std::invalid_argument ex("pattern matches an empty string");
+      ASIO_LIBNS::detail::throw_exception(ex);
+    }
+  }
+
+  // Build the states from sets of positions, starting with the initial set.
+  std::map<std::vector<bool>, std::size_t> ids;
+  std::vector<std::vector<bool> > sets;
+  ids[initial] = 0;
+  sets.push_back(initial);
+  for (std::size_t state = 0; state < sets.size(); ++state)
+  {
+    std::vector<bool> current = sets[state];
+
+    // A state that completes a match accepts the earliest pattern, and the
+    // search then starts again.
+    std::size_t accepted = 0;
+    for (std::size_t i = 0; i < atoms_.size() && !accepted; ++i)
+      if (current[i])
+        accepted = atoms_[i].pattern;
+    accepts_.push_back(accepted);
+    if (accepted)
+      current = initial;
+
+    for (int c = 0; c < 256; ++c)
+    {
+      std::vector<bool> next = initial;
+      for (std::size_t i = 0; i < atoms_.size(); ++i)
+      {
+        if (current[i] && atoms_[i].bytes[c])
+        {
+          close(i + 1, next);
+          if (atoms_[i].quantifier == '*' || atoms_[i].quantifier == '+')
+            close(i, next);
+        }
+      }
+
+      std::map<std::vector<bool>, std::size_t>::iterator iter
+        = ids.find(next);
+      if (iter == ids.end())
+      {
+        if (sets.size() == max_states)
+        {
+          std::length_error ex("too many pattern states");
+          ASIO_LIBNS::detail::throw_exception(ex);
+        }
+        iter = ids.insert(std::make_pair(next, sets.size())).first;
+        sets.push_back(next);
+      }
+      transitions_.push_back(static_cast<uint32_t>(iter->second));
+    }
+  }
+}
+
+void pattern_dfa::parse(const std::string& pattern, std::vector<atom>& atoms)
+{
+  if (pattern.empty())
+  {
+    std::invalid_argument ex("empty pattern");
+    ASIO_LIBNS::detail::throw_exception(ex);
+  }
+
+  for (std::size_t i = 0; i < pattern.size(); )
+  {
+    atom a = atom();
+    char c = pattern[i++];
+    switch (c)
+    {
+    case '.':
+      for (int b = 0; b < 256; ++b)
+        a.bytes[b] = true;
+      break;
+    case '\\':
+      if (i == pattern.size())
+      {
+        std::invalid_argument ex("pattern ends with a backslash");
+        ASIO_LIBNS::detail::throw_exception(ex);
+      }
+      parse_escape(pattern[i++], a.bytes);
+      break;
+    case '[':
+      {
+        bool negated = i < pattern.size() && pattern[i] == '^';
+        if (negated)
+          ++i;
+        bool terminated = false;
+        while (i < pattern.size() && !terminated)
+        {
+          c = pattern[i++];
+          if (c == ']')
+            terminated = true;
+          else if (c == '\\' && i < pattern.size())
+            parse_escape(pattern[i++], a.bytes);
+          else if (i + 1 < pattern.size()
+              && pattern[i] == '-' && pattern[i + 1] != ']')
+          {
+            unsigned char first = static_cast<unsigned char>(c);
+            unsigned char last = static_cast<unsigned char>(pattern[i + 1]);
+            if (last < first)
+            {
+              std::invalid_argument ex("invalid range in pattern");
+              ASIO_LIBNS::detail::throw_exception(ex);
+            }
+            for (int b = first; b <= last; ++b)
+              a.bytes[b] = true;
+            i += 2;
+          }
+          else
+            a.bytes[static_cast<unsigned char>(c)] = true;
+        }
+        if (!terminated)
+        {
+          std::invalid_argument ex("unterminated bracket in pattern");
+          ASIO_LIBNS::detail::throw_exception(ex);
+        }
+        if (negated)
+          for (int b = 0; b < 256; ++b)
+            a.bytes[b] = !a.bytes[b];
+      }
+      break;
+    case '?': case '*': case '+': case '(': case ')':
+    case '{': case '}': case '^': case '$':
+      {
+        std::invalid_argument ex("unsupported character in pattern");
+        ASIO_LIBNS::detail::throw_exception(ex);
+      }
+      break;
+    default:
+      a.bytes[static_cast<unsigned char>(c)] = true;
+      break;
+    }
+
+    if (i < pattern.size() && (pattern[i] == '?'
+          || pattern[i] == '*' || pattern[i] == '+'))
+      a.quantifier = pattern[i++];
+
+    atoms.push_back(a);
+  }
+}
+
+void pattern_dfa::parse_escape(char c, bool bytes[256])
+{
+  bool negated = false;
+  bool in_class[256] = {};
+  switch (c)
+  {
+  case 'D':
+    negated = true;
+    // Fall through.
+  case 'd':
+    for (int b = '0'; b <= '9'; ++b)
+      in_class[b] = true;
+    break;
+  case 'S':
+    negated = true;
+    // Fall through.
+  case 's':
+    in_class[static_cast<unsigned char>(' ')] = true;
+    for (int b = '\t'; b <= '\r'; ++b)
+      in_class[b] = true;
+    break;
+  case 'W':
+    negated = true;
+    // Fall through.
+  case 'w':
+    for (int b = 0; b < 128; ++b)
+      in_class[b] = std::isalnum(b) != 0;
+    in_class[static_cast<unsigned char>('_')] = true;
+    break;
+  case 'n':
+    in_class[static_cast<unsigned char>('\n')] = true;
+    break;
+  case 'r':
+    in_class[static_cast<unsigned char>('\r')] = true;
+    break;
+  case 't':
+    in_class[static_cast<unsigned char>('\t')] = true;
+    break;
+  default:
+    if (std::isalnum(static_cast<unsigned char>(c)))
+    {
+      std::invalid_argument ex("unsupported escape in pattern");
+      ASIO_LIBNS::detail::throw_exception(ex);
+    }
+    in_class[static_cast<unsigned char>(c)] = true;
+    break;
+  }
+
+  for (int b = 0; b < 256; ++b)
+    if (in_class[b] != negated)
+      bytes[b] = true;
+}
+
+void pattern_dfa::close(std::size_t position,
+    std::vector<bool>& positions) const
+{
+  while (!positions[position])
+  {
+    positions[position] = true;
+    char quantifier = atoms_[position].quantifier;
+    if (quantifier != '?' && quantifier != '*')
+      break;
+    ++position;
+  }
+}
+
+} // namespace detail
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // ASIO_DETAIL_IMPL_PATTERN_DFA_IPP
@@ -0,0 +1,356 @@
+//
+// detail/impl/reactive_file_service.ipp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_DETAIL_IMPL_REACTIVE_FILE_SERVICE_IPP
+#define ASIO_DETAIL_IMPL_REACTIVE_FILE_SERVICE_IPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+
+#if defined(ASIO_HAS_FILE) \
+  && !defined(ASIO_HAS_IOCP) \
+  && !defined(ASIO_HAS_IO_URING)
+
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include "asio/detail/reactive_file_service.hpp"
+#include "asio/detail/socket_ops.hpp"
+#include "asio/detail/thread.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace ASIO_LIBNS {
+namespace detail {
+
+class reactive_file_service::work_scheduler_runner
+{
+public:
+  explicit work_scheduler_runner(reactive_file_service* service)
+    : service_(service)
+  {
+  }
+
+  void operator()()
+  {
+    // Operations are performed one at a time so that the service knows when
+    // the thread is idle.
+    ASIO_LIBNS::error_code ec;
+    while (service_->work_scheduler_->run_one(ec))
+      --service_->outstanding_ops_;
+  }
+
+private:
+  reactive_file_service* service_;
+};
+
+reactive_file_service::reactive_file_service(
+    execution_context& context)
+  : execution_context_service_base<reactive_file_service>(context),
+    scheduler_(ASIO_LIBNS::use_service<scheduler>(context)),
+    descriptor_service_(context),
+    work_scheduler_(new scheduler(context, -1, false)),
+    num_threads_(0),
+    max_threads_(ASIO_LIBNS::detail::thread::hardware_concurrency()),
+    outstanding_ops_(0),
+    fork_threads_(0),
+    forking_(false)
+{
+  if (max_threads_ == 0)
+    max_threads_ = 1;
+  work_scheduler_->work_started();
+}
+
+reactive_file_service::~reactive_file_service()
+{
+  shutdown();
+}
+
+void reactive_file_service::shutdown()
+{
+  if (work_scheduler_.get())
+  {
+    work_scheduler_->work_finished();
+    work_scheduler_->stop();
+    work_threads_.join();
+    num_threads_ = 0;
+    work_scheduler_.reset();
+  }
+
+  descriptor_service_.shutdown();
+}
+
+void reactive_file_service::notify_fork(
+    execution_context::fork_event fork_ev)
+{
+  ASIO_LIBNS::detail::mutex::scoped_lock lock(mutex_);
+  if (!work_scheduler_.get())
+    return;
+
+  if (fork_ev == execution_context::fork_prepare)
+  {
+    // Operations started until the fork completes are queued, not performed.
+    work_scheduler_->stop();
+    work_threads_.join();
+    fork_threads_ = num_threads_;
+    num_threads_ = 0;
+    forking_ = true;
+  }
+  else if (forking_)
+  {
+    // Restart the threads so that operations queued across the fork are
+    // performed.
+    std::size_t outstanding_ops = static_cast<std::size_t>(outstanding_ops_);
+    if (fork_threads_ < outstanding_ops)
+      fork_threads_ = (std::min)(outstanding_ops, max_threads_);
+    work_scheduler_->restart();
+    for (; num_threads_ < fork_threads_; ++num_threads_)
+      work_threads_.create_thread(work_scheduler_runner(this));
+    fork_threads_ = 0;
+    forking_ = false;
+  }
+}
+
+ASIO_LIBNS::error_code reactive_file_service::open(
+    reactive_file_service::implementation_type& impl,
+    const char* path, file_base::flags open_flags,
+    ASIO_LIBNS::error_code& ec)
+{
+  if (is_open(impl))
+  {
+    ec = ASIO_LIBNS::error::already_open;
+    ASIO_ERROR_LOCATION(ec);
+    return ec;
+  }
+
+  descriptor_ops::state_type state = 0;
+  int fd = descriptor_ops::open(path, static_cast<int>(open_flags), 0777, ec);
+  if (fd < 0)
+  {
+    ASIO_ERROR_LOCATION(ec);
+    return ec;
+  }
+
+  // We're done. Take ownership of the file descriptor.
+  if (descriptor_service_.assign(impl, fd, ec))
+  {
+    ASIO_LIBNS::error_code ignored_ec;
+    descriptor_ops::close(fd, state, ignored_ec);
+    ASIO_ERROR_LOCATION(ec);
+    return ec;
+  }
+
+#if defined(POSIX_FADV_SEQUENTIAL)
+  (void)::posix_fadvise(native_handle(impl), 0, 0,
+      impl.is_stream_ ? POSIX_FADV_SEQUENTIAL : POSIX_FADV_RANDOM);
+#endif // defined(POSIX_FADV_SEQUENTIAL)
+
+  ASIO_ERROR_LOCATION(ec);
+  return ec;
+}
+
+uint64_t reactive_file_service::size(
+    const reactive_file_service::implementation_type& impl,
+    ASIO_LIBNS::error_code& ec) const
+{
+  uint64_t result = descriptor_ops::file_size(native_handle(impl), ec);
+  ASIO_ERROR_LOCATION(ec);
+  return result;
+}
+
+std::size_t reactive_file_service::alignment(
+    const reactive_file_service::implementation_type& impl,
+    ASIO_LIBNS::error_code& ec) const
+{
+  std::size_t result = descriptor_ops::file_alignment(native_handle(impl), ec);
+  ASIO_ERROR_LOCATION(ec);
+  return result;
+}
+
+ASIO_LIBNS::error_code reactive_file_service::resize(
+    reactive_file_service::implementation_type& impl,
+    uint64_t n, ASIO_LIBNS::error_code& ec)
+{
+  descriptor_ops::ftruncate(native_handle(impl), n, ec);
+  ASIO_ERROR_LOCATION(ec);
+  return ec;
+}
+
+ASIO_LIBNS::error_code reactive_file_service::sync_all(
+    reactive_file_service::implementation_type& impl,
+    ASIO_LIBNS::error_code& ec)
+{
+  descriptor_ops::fsync(native_handle(impl), ec);
+  ASIO_ERROR_LOCATION(ec);
+  return ec;
+}
+
+ASIO_LIBNS::error_code reactive_file_service::sync_data(
+    reactive_file_service::implementation_type& impl,
+    ASIO_LIBNS::error_code& ec)
+{
+  descriptor_ops::fdatasync(native_handle(impl), ec);
+  ASIO_ERROR_LOCATION(ec);
+  return ec;
+}
+
+ASIO_LIBNS::error_code reactive_file_service::allocate(
+    reactive_file_service::implementation_type& impl,
+    uint64_t offset, uint64_t length, ASIO_LIBNS::error_code& ec)
+{
+  descriptor_ops::fallocate(native_handle(impl), offset, length, ec);
+  ASIO_ERROR_LOCATION(ec);
+  return ec;
+}
+
+uint64_t reactive_file_service::seek(
+    reactive_file_service::implementation_type& impl, int64_t offset,
+    file_base::seek_basis whence, ASIO_LIBNS::error_code& ec)
+{
+  int64_t result = ::lseek(native_handle(impl), offset, whence);
+  descriptor_ops::get_last_error(ec, result < 0);
+  ASIO_ERROR_LOCATION(ec);
+  return !ec ? static_cast<uint64_t>(result) : 0;
+}
+
+void reactive_file_service::set_thread_pool(std::size_t max_threads)
+{
+  ASIO_LIBNS::detail::mutex::scoped_lock lock(mutex_);
+  max_threads_ = max_threads > 0 ? max_threads : 1;
+}
+
+void reactive_file_service::complete_open(
+    reactive_file_open_op_base<reactive_file_service>* op, bool deliver)
+{
+  ASIO_LIBNS::detail::mutex::scoped_lock lock(mutex_);
+
+  implementation_type* impl = op->impl_;
+  if (impl)
+  {
+    impl->pending_open_ = 0;
+    op->impl_ = 0;
+  }
+
+  int fd = op->descriptor();
+  if (fd == -1)
+    return;
+  op->release_descriptor();
+
+  if (impl && deliver)
+  {
+    // Take ownership of the file descriptor.
+    if (!descriptor_service_.assign(*impl, fd, op->ec_))
+    {
+#if defined(POSIX_FADV_SEQUENTIAL)
+      (void)::posix_fadvise(fd, 0, 0,
+          impl->is_stream_ ? POSIX_FADV_SEQUENTIAL : POSIX_FADV_RANDOM);
+#endif // defined(POSIX_FADV_SEQUENTIAL)
+      return;
+    }
+  }
+  else
+  {
+    // The file was closed or destroyed while the open was in progress.
+    op->ec_ = ASIO_LIBNS::error::operation_aborted;
+  }
+
+  descriptor_ops::state_type state = 0;
+  ASIO_LIBNS::error_code ignored_ec;
+  descriptor_ops::close(fd, state, ignored_ec);
+}
+
+bool reactive_file_service::begin_open(
+    reactive_file_service::implementation_type& impl,
+    reactive_file_open_op_base<reactive_file_service>* op)
+{
+  ASIO_LIBNS::detail::mutex::scoped_lock lock(mutex_);
+  if (is_open(impl) || impl.pending_open_)
+  {
+    op->ec_ = ASIO_LIBNS::error::already_open;
+    return false;
+  }
+
+  impl.pending_open_ = op;
+  op->impl_ = &impl;
+  return true;
+}
+
+void reactive_file_service::move_pending_open(
+    reactive_file_service::implementation_type& impl,
+    reactive_file_service::implementation_type* new_impl)
+{
+  ASIO_LIBNS::detail::mutex::scoped_lock lock(mutex_);
+  if (impl.pending_open_)
+  {
+    impl.pending_open_->impl_ = new_impl;
+    if (new_impl)
+      new_impl->pending_open_ = impl.pending_open_;
+    impl.pending_open_ = 0;
+  }
+}
+
+void reactive_file_service::start_op(
+    reactive_file_op* op, bool is_continuation)
+{
+  // Operations that need not block, such as reads of cached data, are
+  // completed without a thread hop.
+  if (op->try_perform())
+  {
+    scheduler_.post_immediate_completion(op, is_continuation);
+    return;
+  }
+
+#if defined(ASIO_HAS_THREADS)
+  if (ASIO_CONCURRENCY_HINT_IS_LOCKING(SCHEDULER,
+        scheduler_.concurrency_hint()))
+  {
+    // Start another thread only if no thread is idle and the pool is not
+    // full.
+    ASIO_LIBNS::detail::mutex::scoped_lock lock(mutex_);
+    std::size_t outstanding_ops = ++outstanding_ops_;
+    if (!forking_ && outstanding_ops > num_threads_
+        && num_threads_ < max_threads_)
+    {
+      work_threads_.create_thread(work_scheduler_runner(this));
+      ++num_threads_;
+    }
+    lock.unlock();
+
+    scheduler_.work_started();
+    work_scheduler_->post_immediate_completion(op, false);
+    return;
+  }
+#endif // defined(ASIO_HAS_THREADS)
+
+  // Without threads that may hand the operation back to the scheduler, the
+  // operation is performed inline.
+  op->perform();
+  scheduler_.post_immediate_completion(op, is_continuation);
+}
+
+void reactive_file_service::reset_cancel_token(
+    reactive_file_service::implementation_type& impl)
+{
+  impl.cancel_token_.reset(static_cast<void*>(0), socket_ops::noop_deleter());
+}
+
+} // namespace detail
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // defined(ASIO_HAS_FILE)
+       //   && !defined(ASIO_HAS_IOCP)
+       //   && !defined(ASIO_HAS_IO_URING)
+
+#endif // ASIO_DETAIL_IMPL_REACTIVE_FILE_SERVICE_IPP
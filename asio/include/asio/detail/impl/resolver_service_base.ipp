@@ -16,6 +16,8 @@
 #endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
 
 #include "asio/detail/config.hpp"
+#include <limits>
+#include "asio/detail/op_queue.hpp"
 #include "asio/detail/resolver_service_base.hpp"
 
 #include "asio/detail/push_options.hpp"
@@ -23,30 +25,32 @@
 namespace ASIO_LIBNS {
 namespace detail {
 
-class resolver_service_base::work_scheduler_runner
+class resolver_service_base::thread_function
 {
 public:
-  work_scheduler_runner(scheduler_impl& work_scheduler)
-    : work_scheduler_(work_scheduler)
+  explicit thread_function(resolver_service_base* s)
+    : this_(s)
   {
   }
 
   void operator()()
   {
-    ASIO_LIBNS::error_code ec;
-    work_scheduler_.run(ec);
+    this_->run_worker();
   }
 
 private:
-  scheduler_impl& work_scheduler_;
+  resolver_service_base* this_;
 };
 
 resolver_service_base::resolver_service_base(execution_context& context)
   : scheduler_(ASIO_LIBNS::use_service<scheduler_impl>(context)),
-    work_scheduler_(new scheduler_impl(context, -1, false)),
-    work_thread_(0)
+    max_threads_(1),
+    max_queued_((std::numeric_limits<std::size_t>::max)()),
+    num_threads_(0),
+    idle_threads_(0),
+    stopped_(false),
+    statistics_(statistics())
 {
-  work_scheduler_->work_started();
 }
 
 resolver_service_base::~resolver_service_base()
@@ -56,34 +60,35 @@ resolver_service_base::~resolver_service_base()
 
 void resolver_service_base::base_shutdown()
 {
-  if (work_scheduler_.get())
+  stop_threads();
+
+  // Destroy the lookups that were never started.
+  ASIO_LIBNS::detail::mutex::scoped_lock lock(mutex_);
+  while (!queue_.empty())
   {
-    work_scheduler_->work_finished();
-    work_scheduler_->stop();
-    if (work_thread_.get())
-    {
-      work_thread_->join();
-      work_thread_.reset();
-    }
-    work_scheduler_.reset();
+    resolve_op* op = queue_.front().op;
+    queue_.pop_front();
+    op->destroy();
   }
 }
 
 void resolver_service_base::base_notify_fork(
     execution_context::fork_event fork_ev)
 {
-  if (work_thread_.get())
+  if (fork_ev == execution_context::fork_prepare)
   {
-    if (fork_ev == execution_context::fork_prepare)
-    {
-      work_scheduler_->stop();
-      work_thread_->join();
-      work_thread_.reset();
-    }
+    stop_threads();
   }
-  else if (fork_ev != execution_context::fork_prepare)
+  else
   {
-    work_scheduler_->restart();
+    // Restart enough threads for any lookups that were queued.
+    ASIO_LIBNS::detail::mutex::scoped_lock lock(mutex_);
+    stopped_ = false;
+    while (num_threads_ < max_threads_ && num_threads_ < queue_.size())
+    {
+      threads_.create_thread(thread_function(this));
+      ++num_threads_;
+    }
   }
 }
 
@@ -99,6 +104,7 @@ void resolver_service_base::destroy(
   ASIO_HANDLER_OPERATION((scheduler_.context(),
         "resolver", &impl, 0, "cancel"));
 
+  cancel_queued(impl);
   impl.reset();
 }
 
@@ -121,35 +127,203 @@ void resolver_service_base::cancel(
   ASIO_HANDLER_OPERATION((scheduler_.context(),
         "resolver", &impl, 0, "cancel"));
 
+  // Lookups that have not started are completed now. Those already running
+  // observe the expired token and complete with operation_aborted.
+  cancel_queued(impl);
   impl.reset(static_cast<void*>(0), socket_ops::noop_deleter());
 }
 
-void resolver_service_base::start_resolve_op(resolve_op* op)
+void resolver_service_base::set_thread_pool(
+    std::size_t max_threads, std::size_t max_queued)
+{
+  ASIO_LIBNS::detail::mutex::scoped_lock lock(mutex_);
+  max_threads_ = max_threads > 0 ? max_threads : 1;
+  max_queued_ = max_queued;
+}
+
+resolver_service_base::statistics
+resolver_service_base::get_statistics() const
+{
+  ASIO_LIBNS::detail::mutex::scoped_lock lock(mutex_);
+  statistics s = statistics_;
+  s.threads = num_threads_;
+  s.busy_threads = num_threads_ - idle_threads_;
+  s.queued = queue_.size();
+  return s;
+}
+
+void resolver_service_base::start_resolve_op(
+    implementation_type& impl, resolve_op* op)
 {
   if (ASIO_CONCURRENCY_HINT_IS_LOCKING(SCHEDULER,
         scheduler_.concurrency_hint()))
   {
-    start_work_thread();
-    scheduler_.work_started();
-    work_scheduler_->post_immediate_completion(op, false);
+    if (enqueue(op, impl))
+    {
+      scheduler_.work_started();
+      return;
+    }
+    op->ec_ = ASIO_LIBNS::error::no_buffer_space;
   }
   else
   {
     op->ec_ = ASIO_LIBNS::error::operation_not_supported;
-    scheduler_.post_immediate_completion(op, false);
   }
+  scheduler_.post_immediate_completion(op, false);
 }
 
-void resolver_service_base::start_work_thread()
+void resolver_service_base::start_work_op(resolve_op* op)
+{
+  if (ASIO_CONCURRENCY_HINT_IS_LOCKING(SCHEDULER,
+        scheduler_.concurrency_hint()))
+  {
+    if (enqueue(op, socket_ops::weak_cancel_token_type()))
+      return;
+    op->ec_ = ASIO_LIBNS::error::no_buffer_space;
+  }
+  else
+  {
+    op->ec_ = ASIO_LIBNS::error::operation_not_supported;
+  }
+  scheduler_.post_immediate_completion(op, false);
+}
+
+void resolver_service_base::cancel_queued_op(resolve_op* op)
 {
   ASIO_LIBNS::detail::mutex::scoped_lock lock(mutex_);
-  if (!work_thread_.get())
+  for (std::deque<queued_lookup>::iterator i = queue_.begin();
+      i != queue_.end(); ++i)
   {
-    work_thread_.reset(new ASIO_LIBNS::detail::thread(
-          work_scheduler_runner(*work_scheduler_)));
+    if (i->op == op)
+    {
+      queue_.erase(i);
+      ++statistics_.cancelled;
+      lock.unlock();
+      op->ec_ = ASIO_LIBNS::error::operation_aborted;
+      scheduler_.post_deferred_completion(op);
+      return;
+    }
   }
 }
 
+bool resolver_service_base::enqueue(resolve_op* op,
+    const socket_ops::weak_cancel_token_type& owner)
+{
+  ASIO_LIBNS::detail::mutex::scoped_lock lock(mutex_);
+
+  // Lookups that an idle or new thread will start at once are not counted
+  // against the limit.
+  std::size_t available = idle_threads_;
+  if (num_threads_ < max_threads_ && !stopped_)
+    available += max_threads_ - num_threads_;
+  if (queue_.size() >= available
+      && queue_.size() - available >= max_queued_)
+  {
+    ++statistics_.rejected;
+    return false;
+  }
+
+  // Start another thread if all threads are busy. This is done before the
+  // operation is queued so that a failure leaves the operation with the
+  // caller.
+  if (idle_threads_ == 0 && num_threads_ < max_threads_ && !stopped_)
+  {
+    threads_.create_thread(thread_function(this));
+    ++num_threads_;
+  }
+
+  queued_lookup lookup;
+  lookup.op = op;
+  lookup.owner = owner;
+#if defined(ASIO_HAS_CHRONO)
+  lookup.queued = clock_type::now();
+#endif // defined(ASIO_HAS_CHRONO)
+  queue_.push_back(lookup);
+  if (queue_.size() > statistics_.peak_queued)
+    statistics_.peak_queued = queue_.size();
+
+  if (idle_threads_ > 0)
+    wakeup_event_.unlock_and_signal_one(lock);
+  return true;
+}
+
+void resolver_service_base::run_worker()
+{
+  ASIO_LIBNS::detail::mutex::scoped_lock lock(mutex_);
+  while (!stopped_)
+  {
+    if (queue_.empty())
+    {
+      ++idle_threads_;
+      wakeup_event_.clear(lock);
+      wakeup_event_.wait(lock);
+      --idle_threads_;
+      continue;
+    }
+
+    queued_lookup lookup = queue_.front();
+    queue_.pop_front();
+    ++statistics_.lookups;
+
+#if defined(ASIO_HAS_CHRONO)
+    clock_type::time_point start = clock_type::now();
+    uint64_t queue_time = chrono::duration_cast<chrono::microseconds>(
+        start - lookup.queued).count();
+    statistics_.total_queue_time += queue_time;
+    if (queue_time > statistics_.max_queue_time)
+      statistics_.max_queue_time = queue_time;
+#endif // defined(ASIO_HAS_CHRONO)
+
+    // Perform the blocking lookup. The operation passes itself back to the
+    // main scheduler for completion.
+    lock.unlock();
+    lookup.op->complete(this, ASIO_LIBNS::error_code(), 0);
+    lock.lock();
+
+#if defined(ASIO_HAS_CHRONO)
+    uint64_t lookup_time = chrono::duration_cast<chrono::microseconds>(
+        clock_type::now() - start).count();
+    statistics_.total_lookup_time += lookup_time;
+    if (lookup_time > statistics_.max_lookup_time)
+      statistics_.max_lookup_time = lookup_time;
+#endif // defined(ASIO_HAS_CHRONO)
+  }
+}
+
+void resolver_service_base::cancel_queued(implementation_type& impl)
+{
+  op_queue<operation> ops;
+  {
+    ASIO_LIBNS::detail::mutex::scoped_lock lock(mutex_);
+    for (std::deque<queued_lookup>::iterator i = queue_.begin();
+        i != queue_.end(); )
+    {
+      if (!i->owner.owner_before(impl) && !impl.owner_before(i->owner)
+          && !i->owner.expired())
+      {
+        i->op->ec_ = ASIO_LIBNS::error::operation_aborted;
+        ops.push(i->op);
+        i = queue_.erase(i);
+        ++statistics_.cancelled;
+      }
+      else
+        ++i;
+    }
+  }
+  scheduler_.post_deferred_completions(ops);
+}
+
+void resolver_service_base::stop_threads()
+{
+  ASIO_LIBNS::detail::mutex::scoped_lock lock(mutex_);
+  stopped_ = true;
+  wakeup_event_.signal_all(lock);
+  lock.unlock();
+  threads_.join();
+  lock.lock();
+  num_threads_ = 0;
+}
+
 } // namespace detail
 } // namespace asio
 
@@ -106,13 +106,29 @@ public:
       {
         recycling_allocator<void> allocator;
         executor_type ex = this_->executor_;
-        execution::execute(
-            ASIO_LIBNS::prefer(
-              ASIO_LIBNS::require(
-                ASIO_MOVE_CAST(executor_type)(ex),
-                execution::blocking.never),
-            execution::allocator(allocator)),
-            ASIO_MOVE_CAST(invoker)(*this_));
+        if (this_->impl_->sticky_)
+        {
+          // Reschedule the strand as a continuation, so that the underlying
+          // executor prefers to resume it on the current thread.
+          execution::execute(
+              ASIO_LIBNS::prefer(
+                ASIO_LIBNS::require(
+                  ASIO_MOVE_CAST(executor_type)(ex),
+                  execution::blocking.never),
+              execution::relationship.continuation,
+              execution::allocator(allocator)),
+              ASIO_MOVE_CAST(invoker)(*this_));
+        }
+        else
+        {
+          execution::execute(
+              ASIO_LIBNS::prefer(
+                ASIO_LIBNS::require(
+                  ASIO_MOVE_CAST(executor_type)(ex),
+                  execution::blocking.never),
+              execution::allocator(allocator)),
+              ASIO_MOVE_CAST(invoker)(*this_));
+        }
       }
     }
   };
@@ -177,7 +193,10 @@ public:
       {
         Executor ex(this_->work_.get_executor());
         recycling_allocator<void> allocator;
-        ex.post(ASIO_MOVE_CAST(invoker)(*this_), allocator);
+        if (this_->impl_->sticky_)
+          ex.defer(ASIO_MOVE_CAST(invoker)(*this_), allocator);
+        else
+          ex.post(ASIO_MOVE_CAST(invoker)(*this_), allocator);
       }
     }
   };
@@ -17,6 +17,7 @@
 
 #include "asio/detail/config.hpp"
 #include "asio/detail/strand_executor_service.hpp"
+#include "asio/detail/thread_context.hpp"
 
 #include "asio/detail/push_options.hpp"
 
@@ -27,7 +28,9 @@ namespace detail {
 strand_executor_service::strand_executor_service(execution_context& ctx)
   : execution_context_service_base<strand_executor_service>(ctx),
     mutex_(),
+#if !defined(ASIO_HAS_LOCK_FREE_STRAND)
     salt_(0),
+#endif // !defined(ASIO_HAS_LOCK_FREE_STRAND)
     impl_list_(0)
 {
 }
@@ -41,11 +44,18 @@ void strand_executor_service::shutdown()
   strand_impl* impl = impl_list_;
   while (impl)
   {
+#if defined(ASIO_HAS_LOCK_FREE_STRAND)
+    std::size_t state = impl->state_.exchange(
+        shutdown_state, std::memory_order_acq_rel);
+    push_waiting_stack(ops, state);
+    ops.push(impl->ready_queue_);
+#else // defined(ASIO_HAS_LOCK_FREE_STRAND)
     impl->mutex_->lock();
     impl->shutdown_ = true;
     ops.push(impl->waiting_queue_);
     ops.push(impl->ready_queue_);
     impl->mutex_->unlock();
+#endif // defined(ASIO_HAS_LOCK_FREE_STRAND)
     impl = impl->next_;
   }
 }
@@ -54,6 +64,11 @@ strand_executor_service::implementation_type
 strand_executor_service::create_implementation()
 {
   implementation_type new_impl(new strand_impl);
+#if defined(ASIO_HAS_LOCK_FREE_STRAND)
+  new_impl->state_.store(unlocked_state, std::memory_order_relaxed);
+
+  ASIO_LIBNS::detail::mutex::scoped_lock lock(mutex_);
+#else // defined(ASIO_HAS_LOCK_FREE_STRAND)
   new_impl->locked_ = false;
   new_impl->shutdown_ = false;
 
@@ -68,6 +83,7 @@ strand_executor_service::create_implementation()
   if (!mutexes_[mutex_index].get())
     mutexes_[mutex_index].reset(new mutex);
   new_impl->mutex_ = mutexes_[mutex_index].get();
+#endif // defined(ASIO_HAS_LOCK_FREE_STRAND)
 
   // Insert implementation into linked list of all implementations.
   new_impl->next_ = impl_list_;
@@ -80,6 +96,18 @@ strand_executor_service::create_implementation()
   return new_impl;
 }
 
+strand_executor_service::strand_impl::strand_impl()
+  : batch_budget_(0),
+    sticky_(false),
+    last_thread_(0),
+    handlers_executed_(0),
+    batches_(0),
+    budget_yields_(0),
+    same_thread_resumptions_(0),
+    thread_migrations_(0)
+{
+}
+
 strand_executor_service::strand_impl::~strand_impl()
 {
   ASIO_LIBNS::detail::mutex::scoped_lock lock(service_->mutex_);
@@ -91,8 +119,82 @@ strand_executor_service::strand_impl::~strand_impl()
     prev_->next_ = next_;
   if (next_)
     next_->prev_= prev_;
+
+#if defined(ASIO_HAS_LOCK_FREE_STRAND)
+  // Destroy any handlers that were still waiting on the strand.
+  op_queue<scheduler_operation> ops;
+  push_waiting_stack(ops,
+      state_.exchange(shutdown_state, std::memory_order_acquire));
+#endif // defined(ASIO_HAS_LOCK_FREE_STRAND)
+}
+
+#if defined(ASIO_HAS_LOCK_FREE_STRAND)
+
+void strand_executor_service::push_waiting_stack(
+    op_queue<scheduler_operation>& ops, std::size_t state)
+{
+  if (state == unlocked_state || state == locked_state
+      || state == shutdown_state)
+    return;
+
+  // The stack links the most recently added handler first, so reverse it to
+  // preserve the order in which the handlers were added.
+  scheduler_operation* head = reinterpret_cast<scheduler_operation*>(state);
+  scheduler_operation* reversed = 0;
+  while (head)
+  {
+    scheduler_operation* next = op_queue_access::next(head);
+    op_queue_access::next(head, reversed);
+    reversed = head;
+    head = next;
+  }
+
+  while (reversed)
+  {
+    scheduler_operation* next = op_queue_access::next(reversed);
+    ops.push(reversed);
+    reversed = next;
+  }
+}
+
+bool strand_executor_service::enqueue(const implementation_type& impl,
+    scheduler_operation* op)
+{
+  std::size_t state = impl->state_.load(std::memory_order_relaxed);
+  for (;;)
+  {
+    if (state == shutdown_state)
+    {
+      op->destroy();
+      return false;
+    }
+    else if (state == unlocked_state)
+    {
+      // The function is acquiring the strand lock and so is responsible for
+      // scheduling the strand.
+      if (impl->state_.compare_exchange_weak(state, locked_state,
+            std::memory_order_acquire, std::memory_order_relaxed))
+      {
+        impl->ready_queue_.push(op);
+        return true;
+      }
+    }
+    else
+    {
+      // Some other function already holds the strand lock. Enqueue for later.
+      op_queue_access::next(op, state == locked_state
+          ? static_cast<scheduler_operation*>(0)
+          : reinterpret_cast<scheduler_operation*>(state));
+      if (impl->state_.compare_exchange_weak(state,
+            reinterpret_cast<std::size_t>(op),
+            std::memory_order_release, std::memory_order_relaxed))
+        return false;
+    }
+  }
 }
 
+#else // defined(ASIO_HAS_LOCK_FREE_STRAND)
+
 bool strand_executor_service::enqueue(const implementation_type& impl,
     scheduler_operation* op)
 {
@@ -121,6 +223,8 @@ bool strand_executor_service::enqueue(const implementation_type& impl,
   }
 }
 
+#endif // defined(ASIO_HAS_LOCK_FREE_STRAND)
+
 bool strand_executor_service::running_in_this_thread(
     const implementation_type& impl)
 {
@@ -129,24 +233,123 @@ bool strand_executor_service::running_in_this_thread(
 
 bool strand_executor_service::push_waiting_to_ready(implementation_type& impl)
 {
+#if defined(ASIO_HAS_LOCK_FREE_STRAND)
+  std::size_t state = impl->state_.load(std::memory_order_acquire);
+  for (;;)
+  {
+    if (state == shutdown_state)
+    {
+      return false;
+    }
+    else if (state == locked_state)
+    {
+      // Release the strand lock unless there are still handlers that are
+      // ready to run.
+      if (!impl->ready_queue_.empty())
+        return true;
+      if (impl->state_.compare_exchange_weak(state, unlocked_state,
+            std::memory_order_release, std::memory_order_acquire))
+        return false;
+    }
+    else if (impl->state_.compare_exchange_weak(state, locked_state,
+          std::memory_order_acquire, std::memory_order_acquire))
+    {
+      push_waiting_stack(impl->ready_queue_, state);
+      return true;
+    }
+  }
+#else // defined(ASIO_HAS_LOCK_FREE_STRAND)
   impl->mutex_->lock();
   impl->ready_queue_.push(impl->waiting_queue_);
   bool more_handlers = impl->locked_ = !impl->ready_queue_.empty();
   impl->mutex_->unlock();
   return more_handlers;
+#endif // defined(ASIO_HAS_LOCK_FREE_STRAND)
+}
+
+void strand_executor_service::set_batch_budget(
+    const implementation_type& impl, std::size_t n)
+{
+  impl->batch_budget_ = n;
+}
+
+std::size_t strand_executor_service::batch_budget(
+    const implementation_type& impl)
+{
+  return impl->batch_budget_;
+}
+
+void strand_executor_service::set_sticky(
+    const implementation_type& impl, bool value)
+{
+  impl->sticky_ = value;
+}
+
+bool strand_executor_service::sticky(const implementation_type& impl)
+{
+  return impl->sticky_;
 }
 
+strand_executor_service::statistics strand_executor_service::get_statistics(
+    const implementation_type& impl)
+{
+  statistics s;
+  s.handlers_executed = static_cast<std::size_t>(impl->handlers_executed_);
+  s.batches = static_cast<std::size_t>(impl->batches_);
+  s.budget_yields = static_cast<std::size_t>(impl->budget_yields_);
+  s.same_thread_resumptions = static_cast<std::size_t>(
+      impl->same_thread_resumptions_);
+  s.thread_migrations = static_cast<std::size_t>(impl->thread_migrations_);
+  return s;
+}
+
+struct strand_executor_service::on_run_ready_exit
+{
+  strand_impl* impl_;
+  std::size_t handlers_executed_;
+
+  ~on_run_ready_exit()
+  {
+    increment(impl_->handlers_executed_,
+        static_cast<long>(handlers_executed_));
+  }
+};
+
 void strand_executor_service::run_ready_handlers(implementation_type& impl)
 {
   // Indicate that this strand is executing on the current thread.
   call_stack<strand_impl>::context ctx(impl.get());
 
-  // Run all ready handlers. No lock is required since the ready queue is
-  // accessed only within the strand.
+  // Record whether the strand has moved between threads. Only threads that
+  // are running an execution context can be identified.
+  if (thread_info_base* this_thread
+      = thread_context::top_of_thread_call_stack())
+  {
+    if (impl->last_thread_ == this_thread)
+      increment(impl->same_thread_resumptions_, 1);
+    else if (impl->last_thread_)
+      increment(impl->thread_migrations_, 1);
+    impl->last_thread_ = this_thread;
+  }
+  increment(impl->batches_, 1);
+
+  // Ensure the number of handlers run is recorded on block exit.
+  on_run_ready_exit on_exit = { impl.get(), 0 };
+
+  // Run ready handlers until the budget is exhausted. No lock is required
+  // since the ready queue is accessed only within the strand. Any handlers
+  // that remain cause the strand to be rescheduled.
+  std::size_t budget = impl->batch_budget_;
   ASIO_LIBNS::error_code ec;
   while (scheduler_operation* o = impl->ready_queue_.front())
   {
+    if (budget != 0 && on_exit.handlers_executed_ == budget)
+    {
+      increment(impl->budget_yields_, 1);
+      break;
+    }
     impl->ready_queue_.pop();
+    ++on_exit.handlers_executed_;
     o->complete(impl.get(), ec, 0);
   }
 }
@@ -29,6 +29,12 @@ namespace detail {
 inline strand_service::strand_impl::strand_impl()
   : operation(&strand_service::do_complete),
     locked_(false)
+#if defined(ASIO_ENABLE_DEDICATED_STRAND_IMPLEMENTATIONS)
+    , ref_count_(0),
+    service_(0),
+    next_(0),
+    prev_(0)
+#endif // defined(ASIO_ENABLE_DEDICATED_STRAND_IMPLEMENTATIONS)
 {
 }
 
@@ -38,6 +38,8 @@ struct strand_service::on_do_complete_exit
 
     if (more_handlers)
       owner_->post_immediate_completion(impl_, true);
+    else
+      lock_released(impl_);
   }
 };
 
@@ -46,10 +48,111 @@ strand_service::strand_service(ASIO_LIBNS::io_context& io_context)
     io_context_(io_context),
     io_context_impl_(ASIO_LIBNS::use_service<io_context_impl>(io_context)),
     mutex_(),
+#if defined(ASIO_ENABLE_DEDICATED_STRAND_IMPLEMENTATIONS)
+    impl_list_(0),
+    free_list_(0)
+#else // defined(ASIO_ENABLE_DEDICATED_STRAND_IMPLEMENTATIONS)
     salt_(0)
+#endif // defined(ASIO_ENABLE_DEDICATED_STRAND_IMPLEMENTATIONS)
 {
 }
 
+#if defined(ASIO_ENABLE_DEDICATED_STRAND_IMPLEMENTATIONS)
+
+strand_service::~strand_service()
+{
+  while (strand_impl* impl = free_list_)
+  {
+    free_list_ = impl->next_;
+    delete impl;
+  }
+
+  // Implementations that are still referenced by strand objects are orphaned,
+  // and are destroyed when the last of those objects is destroyed. The lock
+  // held by a strand that was scheduled at shutdown is abandoned.
+  while (strand_impl* impl = impl_list_)
+  {
+    impl_list_ = impl->next_;
+    impl->service_ = 0;
+    if (impl->locked_)
+    {
+      impl->locked_ = false;
+      if (ref_count_down(impl->ref_count_))
+        delete impl;
+    }
+  }
+}
+
+void strand_service::shutdown()
+{
+  op_queue<operation> ops;
+
+  ASIO_LIBNS::detail::mutex::scoped_lock lock(mutex_);
+
+  for (strand_impl* impl = impl_list_; impl; impl = impl->next_)
+  {
+    ops.push(impl->waiting_queue_);
+    ops.push(impl->ready_queue_);
+  }
+}
+
+void strand_service::construct(strand_service::implementation_type& impl)
+{
+  ASIO_LIBNS::detail::mutex::scoped_lock lock(mutex_);
+
+  // Reuse a free implementation if one is available.
+  strand_impl* new_impl = free_list_;
+  if (new_impl)
+    free_list_ = new_impl->next_;
+  else
+    new_impl = new strand_impl;
+
+  // Free implementations have no outstanding references.
+  ref_count_up(new_impl->ref_count_);
+  new_impl->service_ = this;
+
+  // Insert implementation into linked list of all implementations in use.
+  new_impl->next_ = impl_list_;
+  new_impl->prev_ = 0;
+  if (impl_list_)
+    impl_list_->prev_ = new_impl;
+  impl_list_ = new_impl;
+
+  if (impl.impl_)
+    release(impl.impl_);
+  impl.impl_ = new_impl;
+}
+
+void strand_service::release(strand_impl* impl)
+{
+  if (!ref_count_down(impl->ref_count_))
+    return;
+
+  strand_service* service = impl->service_;
+  if (!service)
+  {
+    delete impl;
+    return;
+  }
+
+  ASIO_LIBNS::detail::mutex::scoped_lock lock(service->mutex_);
+
+  // Remove implementation from linked list of all implementations in use.
+  if (service->impl_list_ == impl)
+    service->impl_list_ = impl->next_;
+  if (impl->prev_)
+    impl->prev_->next_ = impl->next_;
+  if (impl->next_)
+    impl->next_->prev_ = impl->prev_;
+
+  // Return the implementation to the pool.
+  impl->prev_ = 0;
+  impl->next_ = service->free_list_;
+  service->free_list_ = impl;
+}
+
+#else // defined(ASIO_ENABLE_DEDICATED_STRAND_IMPLEMENTATIONS)
+
 void strand_service::shutdown()
 {
   op_queue<operation> ops;
@@ -85,6 +188,8 @@ void strand_service::construct(strand_service::implementation_type& impl)
   impl = implementations_[index].get();
 }
 
+#endif // defined(ASIO_ENABLE_DEDICATED_STRAND_IMPLEMENTATIONS)
+
 bool strand_service::running_in_this_thread(
     const implementation_type& impl) const
 {
@@ -105,6 +210,8 @@ struct strand_service::on_dispatch_exit
 
     if (more_handlers)
       io_context_impl_->post_immediate_completion(impl_, false);
+    else
+      lock_released(impl_);
   }
 };
 
@@ -119,6 +226,7 @@ void strand_service::do_dispatch(implementation_type& impl, operation* op)
     // Immediate invocation is allowed.
     impl->locked_ = true;
     impl->mutex_.unlock();
+    lock_acquired(impl);
 
     // Indicate that this strand is executing on the current thread.
     call_stack<strand_impl>::context ctx(impl);
@@ -143,6 +251,7 @@ void strand_service::do_dispatch(implementation_type& impl, operation* op)
     // scheduling the strand.
     impl->locked_ = true;
     impl->mutex_.unlock();
+    lock_acquired(impl);
     impl->ready_queue_.push(op);
     io_context_impl_.post_immediate_completion(impl, false);
   }
@@ -164,6 +273,7 @@ void strand_service::do_post(implementation_type& impl,
     // scheduling the strand.
     impl->locked_ = true;
     impl->mutex_.unlock();
+    lock_acquired(impl);
     impl->ready_queue_.push(op);
     io_context_impl_.post_immediate_completion(impl, is_continuation);
   }
@@ -22,6 +22,7 @@
 
 #include <cstring>
 #include <sys/stat.h>
+#include "asio/detail/thread.hpp"
 #include "asio/detail/win_iocp_file_service.hpp"
 
 #include "asio/detail/push_options.hpp"
@@ -29,12 +30,42 @@
 namespace ASIO_LIBNS {
 namespace detail {
 
+class win_iocp_file_service::work_scheduler_runner
+{
+public:
+  explicit work_scheduler_runner(win_iocp_file_service* service)
+    : service_(service)
+  {
+  }
+
+  void operator()()
+  {
+    // Operations are performed one at a time so that the service knows when
+    // the thread is idle.
+    ASIO_LIBNS::error_code ec;
+    while (service_->work_scheduler_->run_one(ec))
+      --service_->outstanding_ops_;
+  }
+
+private:
+  win_iocp_file_service* service_;
+};
+
 win_iocp_file_service::win_iocp_file_service(
     execution_context& context)
   : execution_context_service_base<win_iocp_file_service>(context),
+    iocp_service_(ASIO_LIBNS::use_service<win_iocp_io_context>(context)),
     handle_service_(context),
+    work_scheduler_(new win_iocp_io_context(context, -1, false)),
+    num_threads_(0),
+    max_threads_(ASIO_LIBNS::detail::thread::hardware_concurrency()),
+    outstanding_ops_(0),
     nt_flush_buffers_file_ex_(0)
 {
+  if (max_threads_ == 0)
+    max_threads_ = 1;
+  work_scheduler_->work_started();
+
   if (FARPROC nt_flush_buffers_file_ex_ptr = ::GetProcAddress(
         ::GetModuleHandleA("NTDLL"), "NtFlushBuffersFileEx"))
   {
@@ -43,8 +74,22 @@ win_iocp_file_service::win_iocp_file_service(
   }
 }
 
+win_iocp_file_service::~win_iocp_file_service()
+{
+  shutdown();
+}
+
 void win_iocp_file_service::shutdown()
 {
+  if (work_scheduler_.get())
+  {
+    work_scheduler_->work_finished();
+    work_scheduler_->stop();
+    work_threads_.join();
+    num_threads_ = 0;
+    work_scheduler_.reset();
+  }
+
   handle_service_.shutdown();
 }
 
@@ -60,6 +105,233 @@ ASIO_LIBNS::error_code win_iocp_file_service::open(
     return ec;
   }
 
+  HANDLE handle = open_handle(path, open_flags, impl.is_stream_, ec);
+  if (handle != INVALID_HANDLE_VALUE)
+  {
+    handle_service_.assign(impl, handle, ec);
+    if (ec)
+      ::CloseHandle(handle);
+    impl.offset_ = 0;
+  }
+
+  ASIO_ERROR_LOCATION(ec);
+  return ec;
+}
+
+uint64_t win_iocp_file_service::size(
+    const win_iocp_file_service::implementation_type& impl,
+    ASIO_LIBNS::error_code& ec) const
+{
+  return do_size(native_handle(impl), ec);
+}
+
+std::size_t win_iocp_file_service::alignment(
+    const win_iocp_file_service::implementation_type& impl,
+    ASIO_LIBNS::error_code& ec) const
+{
+#if defined(_WIN32_WINNT) && (_WIN32_WINNT >= 0x0602)
+  // Unbuffered I/O must be aligned to the physical sector size.
+  FILE_STORAGE_INFO info;
+  if (::GetFileInformationByHandleEx(native_handle(impl),
+        FileStorageInfo, &info, sizeof(info)))
+  {
+    ASIO_LIBNS::error::clear(ec);
+    return info.PhysicalBytesPerSectorForPerformance;
+  }
+  else
+  {
+    DWORD last_error = ::GetLastError();
+    ec.assign(last_error, ASIO_LIBNS::error::get_system_category());
+    ASIO_ERROR_LOCATION(ec);
+    return 0;
+  }
+#else // defined(_WIN32_WINNT) && (_WIN32_WINNT >= 0x0602)
+  // Older versions cannot query the sector size of a handle, so the largest
+  // sector size in common use is assumed.
+  if (!is_open(impl))
+  {
+    ec = ASIO_LIBNS::error::bad_descriptor;
+    ASIO_ERROR_LOCATION(ec);
+    return 0;
+  }
+  ASIO_LIBNS::error::clear(ec);
+  return 4096;
+#endif // defined(_WIN32_WINNT) && (_WIN32_WINNT >= 0x0602)
+}
+
+ASIO_LIBNS::error_code win_iocp_file_service::resize(
+    win_iocp_file_service::implementation_type& impl,
+    uint64_t n, ASIO_LIBNS::error_code& ec)
+{
+  return do_resize(native_handle(impl), n, impl.offset_, ec);
+}
+
+ASIO_LIBNS::error_code win_iocp_file_service::sync_all(
+    win_iocp_file_service::implementation_type& impl,
+    ASIO_LIBNS::error_code& ec)
+{
+  return do_sync_all(native_handle(impl), ec);
+}
+
+ASIO_LIBNS::error_code win_iocp_file_service::sync_data(
+    win_iocp_file_service::implementation_type& impl,
+    ASIO_LIBNS::error_code& ec)
+{
+  return do_sync_data(native_handle(impl), ec);
+}
+
+ASIO_LIBNS::error_code win_iocp_file_service::allocate(
+    win_iocp_file_service::implementation_type& impl,
+    uint64_t offset, uint64_t length, ASIO_LIBNS::error_code& ec)
+{
+  return do_allocate(native_handle(impl), offset, length, impl.offset_, ec);
+}
+
+void win_iocp_file_service::perform(file_op* op)
+{
+  switch (op->type_)
+  {
+  case file_op::open_op:
+    op->handle_ = open_handle(op->path_.c_str(),
+        op->open_flags_, op->is_stream_, op->ec_);
+    break;
+  case file_op::close_op:
+    if (op->handle_ != INVALID_HANDLE_VALUE)
+    {
+      if (!::CloseHandle(op->handle_))
+      {
+        DWORD last_error = ::GetLastError();
+        op->ec_.assign(last_error, ASIO_LIBNS::error::get_system_category());
+      }
+      op->handle_ = INVALID_HANDLE_VALUE;
+    }
+    break;
+  case file_op::size_op:
+    op->size_ = do_size(op->handle_, op->ec_);
+    break;
+  case file_op::resize_op:
+    do_resize(op->handle_, op->length_, op->position_, op->ec_);
+    break;
+  case file_op::allocate_op:
+    do_allocate(op->handle_, op->offset_,
+        op->length_, op->position_, op->ec_);
+    break;
+  case file_op::sync_all_op:
+    do_sync_all(op->handle_, op->ec_);
+    break;
+  case file_op::sync_data_op:
+    do_sync_data(op->handle_, op->ec_);
+    break;
+  }
+}
+
+void win_iocp_file_service::complete(file_op* op, bool deliver)
+{
+  if (op->type_ == file_op::close_op)
+  {
+    // A handle that is still owned by the operation is closed.
+    if (op->handle_ != INVALID_HANDLE_VALUE)
+    {
+      ::CloseHandle(op->handle_);
+      op->handle_ = INVALID_HANDLE_VALUE;
+    }
+    return;
+  }
+
+  if (op->type_ != file_op::open_op)
+    return;
+
+  ASIO_LIBNS::detail::mutex::scoped_lock lock(mutex_);
+
+  implementation_type* impl = op->impl_;
+  if (impl)
+  {
+    impl->pending_open_ = 0;
+    op->impl_ = 0;
+  }
+
+  HANDLE handle = op->handle_;
+  if (handle == INVALID_HANDLE_VALUE)
+    return;
+  op->handle_ = INVALID_HANDLE_VALUE;
+
+  if (impl && deliver)
+  {
+    // Take ownership of the handle.
+    if (!handle_service_.assign(*impl, handle, op->ec_))
+    {
+      impl->offset_ = 0;
+      return;
+    }
+  }
+  else
+  {
+    // The file was closed or destroyed while the open was in progress.
+    op->ec_ = ASIO_LIBNS::error::operation_aborted;
+  }
+
+  ::CloseHandle(handle);
+}
+
+bool win_iocp_file_service::begin_open(
+    win_iocp_file_service::implementation_type& impl, file_op* op)
+{
+  ASIO_LIBNS::detail::mutex::scoped_lock lock(mutex_);
+  if (is_open(impl) || impl.pending_open_)
+  {
+    op->ec_ = ASIO_LIBNS::error::already_open;
+    return false;
+  }
+
+  impl.pending_open_ = op;
+  op->impl_ = &impl;
+  return true;
+}
+
+void win_iocp_file_service::move_pending_open(
+    win_iocp_file_service::implementation_type& impl,
+    win_iocp_file_service::implementation_type* new_impl)
+{
+  ASIO_LIBNS::detail::mutex::scoped_lock lock(mutex_);
+  if (impl.pending_open_)
+  {
+    impl.pending_open_->impl_ = new_impl;
+    if (new_impl)
+      new_impl->pending_open_ = impl.pending_open_;
+    impl.pending_open_ = 0;
+  }
+}
+
+void win_iocp_file_service::start_op(file_op* op)
+{
+  if (ASIO_CONCURRENCY_HINT_IS_LOCKING(SCHEDULER,
+        iocp_service_.concurrency_hint()))
+  {
+    // Start another thread only if no thread is idle and the pool is not
+    // full.
+    ASIO_LIBNS::detail::mutex::scoped_lock lock(mutex_);
+    std::size_t outstanding_ops = ++outstanding_ops_;
+    if (outstanding_ops > num_threads_ && num_threads_ < max_threads_)
+    {
+      work_threads_.create_thread(work_scheduler_runner(this));
+      ++num_threads_;
+    }
+    lock.unlock();
+
+    iocp_service_.work_started();
+    work_scheduler_->post_immediate_completion(op, false);
+    return;
+  }
+
+  // Without threads that may hand the operation back to the scheduler, the
+  // operation is performed inline.
+  perform(op);
+  iocp_service_.post_immediate_completion(op, false);
+}
+
+HANDLE win_iocp_file_service::open_handle(const char* path,
+    file_base::flags open_flags, bool is_stream, ASIO_LIBNS::error_code& ec)
+{
   DWORD access = 0;
   if ((open_flags & file_base::read_only) != 0)
     access = GENERIC_READ;
@@ -87,12 +359,14 @@ ASIO_LIBNS::error_code win_iocp_file_service::open(
   }
 
   DWORD flags = FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED;
-  if (impl.is_stream_)
+  if (is_stream)
     flags |= FILE_FLAG_SEQUENTIAL_SCAN;
   else
     flags |= FILE_FLAG_RANDOM_ACCESS;
   if ((open_flags & file_base::sync_all_on_write) != 0)
     flags |= FILE_FLAG_WRITE_THROUGH;
+  if ((open_flags & file_base::direct_io) != 0)
+    flags |= FILE_FLAG_NO_BUFFERING;
 
   HANDLE handle = ::CreateFileA(path, access, share, 0, disposition, flags, 0);
   if (handle != INVALID_HANDLE_VALUE)
@@ -105,32 +379,27 @@ ASIO_LIBNS::error_code win_iocp_file_service::open(
         ::CloseHandle(handle);
         ec.assign(last_error, ASIO_LIBNS::error::get_system_category());
         ASIO_ERROR_LOCATION(ec);
-        return ec;
+        return INVALID_HANDLE_VALUE;
       }
     }
 
-    handle_service_.assign(impl, handle, ec);
-    if (ec)
-      ::CloseHandle(handle);
-    impl.offset_ = 0;
-    ASIO_ERROR_LOCATION(ec);
-    return ec;
+    ASIO_LIBNS::error::clear(ec);
+    return handle;
   }
   else
   {
     DWORD last_error = ::GetLastError();
     ec.assign(last_error, ASIO_LIBNS::error::get_system_category());
     ASIO_ERROR_LOCATION(ec);
-    return ec;
+    return INVALID_HANDLE_VALUE;
   }
 }
 
-uint64_t win_iocp_file_service::size(
-    const win_iocp_file_service::implementation_type& impl,
+uint64_t win_iocp_file_service::do_size(HANDLE handle,
     ASIO_LIBNS::error_code& ec) const
 {
   LARGE_INTEGER result;
-  if (::GetFileSizeEx(native_handle(impl), &result))
+  if (::GetFileSizeEx(handle, &result))
   {
     ASIO_LIBNS::error::clear(ec);
     return static_cast<uint64_t>(result.QuadPart);
@@ -144,19 +413,18 @@ uint64_t win_iocp_file_service::size(
   }
 }
 
-ASIO_LIBNS::error_code win_iocp_file_service::resize(
-    win_iocp_file_service::implementation_type& impl,
-    uint64_t n, ASIO_LIBNS::error_code& ec)
+ASIO_LIBNS::error_code win_iocp_file_service::do_resize(HANDLE handle,
+    uint64_t n, uint64_t position, ASIO_LIBNS::error_code& ec)
 {
   LARGE_INTEGER distance;
   distance.QuadPart = n;
-  if (::SetFilePointerEx(native_handle(impl), distance, 0, FILE_BEGIN))
+  if (::SetFilePointerEx(handle, distance, 0, FILE_BEGIN))
   {
-    BOOL result = ::SetEndOfFile(native_handle(impl));
+    BOOL result = ::SetEndOfFile(handle);
     DWORD last_error = ::GetLastError();
 
-    distance.QuadPart = static_cast<LONGLONG>(impl.offset_);
-    if (!::SetFilePointerEx(native_handle(impl), distance, 0, FILE_BEGIN))
+    distance.QuadPart = static_cast<LONGLONG>(position);
+    if (!::SetFilePointerEx(handle, distance, 0, FILE_BEGIN))
     {
       result = FALSE;
       last_error = ::GetLastError();
@@ -178,11 +446,23 @@ ASIO_LIBNS::error_code win_iocp_file_service::resize(
   }
 }
 
-ASIO_LIBNS::error_code win_iocp_file_service::sync_all(
-    win_iocp_file_service::implementation_type& impl,
+ASIO_LIBNS::error_code win_iocp_file_service::do_allocate(HANDLE handle,
+    uint64_t offset, uint64_t length, uint64_t position,
     ASIO_LIBNS::error_code& ec)
 {
-  BOOL result = ::FlushFileBuffers(native_handle(impl));
+  // Windows has no equivalent of posix_fallocate, so the file is extended to
+  // cover the range.
+  uint64_t current_size = do_size(handle, ec);
+  if (!ec && current_size < offset + length)
+    do_resize(handle, offset + length, position, ec);
+  ASIO_ERROR_LOCATION(ec);
+  return ec;
+}
+
+ASIO_LIBNS::error_code win_iocp_file_service::do_sync_all(HANDLE handle,
+    ASIO_LIBNS::error_code& ec)
+{
+  BOOL result = ::FlushFileBuffers(handle);
   if (result)
   {
     ASIO_LIBNS::error::clear(ec);
@@ -197,21 +477,62 @@ ASIO_LIBNS::error_code win_iocp_file_service::sync_all(
   }
 }
 
-ASIO_LIBNS::error_code win_iocp_file_service::sync_data(
-    win_iocp_file_service::implementation_type& impl,
+ASIO_LIBNS::error_code win_iocp_file_service::do_sync_data(HANDLE handle,
     ASIO_LIBNS::error_code& ec)
 {
   if (nt_flush_buffers_file_ex_)
   {
     io_status_block status = {};
-    if (!nt_flush_buffers_file_ex_(native_handle(impl),
+    if (!nt_flush_buffers_file_ex_(handle,
           flush_flags_file_data_sync_only, 0, 0, &status))
     {
       ASIO_LIBNS::error::clear(ec);
       return ec;
     }
   }
-  return sync_all(impl, ec);
+  return do_sync_all(handle, ec);
+}
+
+std::size_t win_iocp_file_service::copy_some_at(
+    win_iocp_file_service::implementation_type& impl, uint64_t offset,
+    win_iocp_file_service::implementation_type& target, std::size_t length,
+    ASIO_LIBNS::error_code& ec)
+{
+  // A request to copy 0 bytes is a no-op.
+  if (length == 0)
+  {
+    ASIO_LIBNS::error::clear(ec);
+    return 0;
+  }
+
+  char data[65536];
+  std::size_t bytes_read = handle_service_.read_some_at(impl, offset,
+      ASIO_LIBNS::buffer(data, length < sizeof(data) ? length : sizeof(data)),
+      ec);
+  if (bytes_read == 0)
+  {
+    // End of file is reported as a copy of 0 bytes.
+    if (ec == ASIO_LIBNS::error::eof)
+      ASIO_LIBNS::error::clear(ec);
+    ASIO_ERROR_LOCATION(ec);
+    return 0;
+  }
+
+  std::size_t bytes_written = 0;
+  while (bytes_written < bytes_read)
+  {
+    std::size_t bytes = handle_service_.write_some_at(target,
+        offset + bytes_written, ASIO_LIBNS::buffer(data + bytes_written,
+          bytes_read - bytes_written), ec);
+    if (bytes == 0)
+    {
+      ASIO_ERROR_LOCATION(ec);
+      return 0;
+    }
+    bytes_written += bytes;
+  }
+
+  return bytes_written;
 }
 
 uint64_t win_iocp_file_service::seek(
@@ -625,6 +625,9 @@ public:
   }
 
 private:
+  // The file service queues its own operations on the descriptor.
+  friend class io_uring_file_service;
+
   // Start the asynchronous operation.
   ASIO_DECL void start_op(implementation_type& impl, int op_type,
       io_uring_operation* op, bool is_continuation, bool noop);
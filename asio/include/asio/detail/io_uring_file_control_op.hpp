@@ -0,0 +1,392 @@
+//
+// detail/io_uring_file_control_op.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_DETAIL_IO_URING_FILE_CONTROL_OP_HPP
+#define ASIO_DETAIL_IO_URING_FILE_CONTROL_OP_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+
+#if defined(ASIO_HAS_FILE) \
+  && defined(ASIO_HAS_IO_URING)
+
+#include <fcntl.h>
+#include <string>
+#include <sys/stat.h>
+#include "asio/detail/bind_handler.hpp"
+#include "asio/detail/cstdint.hpp"
+#include "asio/detail/descriptor_ops.hpp"
+#include "asio/detail/fenced_block.hpp"
+#include "asio/detail/handler_work.hpp"
+#include "asio/detail/io_uring_operation.hpp"
+#include "asio/detail/io_uring_service.hpp"
+#include "asio/detail/memory.hpp"
+#include "asio/file_base.hpp"
+
+// The ftruncate opcode is prepared by liburing 2.7 and later.
+#if defined(IO_URING_VERSION_MAJOR) && defined(IO_URING_VERSION_MINOR)
+# if (IO_URING_VERSION_MAJOR > 2) \
+  || ((IO_URING_VERSION_MAJOR == 2) && (IO_URING_VERSION_MINOR >= 7))
+#  define ASIO_HAS_IO_URING_FTRUNCATE 1
+# endif // (IO_URING_VERSION_MAJOR > 2) ...
+#endif // defined(IO_URING_VERSION_MAJOR) && defined(IO_URING_VERSION_MINOR)
+
+#include "asio/detail/push_options.hpp"
+
+namespace ASIO_LIBNS {
+namespace detail {
+
+// File operations that do not transfer data.
+class io_uring_file_control_op_base : public io_uring_operation
+{
+public:
+  enum control_type
+  {
+    sync_all_op,
+    sync_data_op,
+    resize_op,
+    allocate_op,
+    size_op,
+    open_op,
+    close_op
+  };
+
+  io_uring_file_control_op_base(const ASIO_LIBNS::error_code& success_ec,
+      int descriptor, control_type control, uint64_t offset,
+      uint64_t length, func_type complete_func)
+    : io_uring_operation(success_ec,
+        &io_uring_file_control_op_base::do_prepare,
+        &io_uring_file_control_op_base::do_perform, complete_func),
+      io_object_data_(0),
+      io_uring_service_(0),
+      descriptor_(descriptor),
+      control_(control),
+      offset_(offset),
+      length_(length),
+      size_(0),
+      open_flags_(0)
+  {
+  }
+
+  static void do_prepare(io_uring_operation* base, ::io_uring_sqe* sqe)
+  {
+    io_uring_file_control_op_base* o(
+        static_cast<io_uring_file_control_op_base*>(base));
+
+    switch (o->control_)
+    {
+    case sync_all_op:
+      ::io_uring_prep_fsync(sqe, o->descriptor_, 0);
+      break;
+    case sync_data_op:
+      ::io_uring_prep_fsync(sqe, o->descriptor_, IORING_FSYNC_DATASYNC);
+      break;
+    case resize_op:
+#if defined(ASIO_HAS_IO_URING_FTRUNCATE)
+      ::io_uring_prep_ftruncate(sqe, o->descriptor_, o->length_);
+#else // defined(ASIO_HAS_IO_URING_FTRUNCATE)
+      // Not submitted. The service resizes the file when the operation is
+      // started.
+      ::io_uring_prep_nop(sqe);
+#endif // defined(ASIO_HAS_IO_URING_FTRUNCATE)
+      break;
+    case allocate_op:
+      ::io_uring_prep_fallocate(sqe, o->descriptor_,
+          0, o->offset_, o->length_);
+      break;
+    case size_op:
+      ::io_uring_prep_statx(sqe, o->descriptor_, "",
+          AT_EMPTY_PATH, STATX_SIZE, &o->statx_);
+      break;
+    case open_op:
+      ::io_uring_prep_openat(sqe, AT_FDCWD,
+          o->path_.c_str(), o->open_flags_, 0777);
+      break;
+    case close_op:
+      ::io_uring_prep_close(sqe, o->descriptor_);
+      break;
+    }
+  }
+
+  static bool do_perform(io_uring_operation* base, bool after_completion)
+  {
+    io_uring_file_control_op_base* o(
+        static_cast<io_uring_file_control_op_base*>(base));
+
+    if (after_completion)
+    {
+      // The descriptor is released by the close, even if it fails.
+      if (o->control_ == close_op)
+        o->descriptor_ = -1;
+      else if (o->control_ == size_op && !o->ec_)
+        o->size_ = o->statx_.stx_size;
+      else if (o->control_ == open_op && !o->ec_)
+        o->descriptor_ = static_cast<int>(o->bytes_transferred_);
+    }
+
+    return after_completion;
+  }
+
+  // The descriptor that was opened, or -1 if none.
+  int descriptor() const
+  {
+    return descriptor_;
+  }
+
+  // Give up ownership of the descriptor.
+  void release_descriptor()
+  {
+    descriptor_ = -1;
+  }
+
+  // The I/O object used to submit an operation that has no file of its own,
+  // and the service that owns it.
+  io_uring_service::per_io_object_data io_object_data_;
+  io_uring_service* io_uring_service_;
+
+protected:
+  int descriptor_;
+  control_type control_;
+  uint64_t offset_;
+  uint64_t length_;
+  uint64_t size_;
+  struct statx statx_;
+  std::string path_;
+  int open_flags_;
+};
+
+template <typename Handler, typename IoExecutor>
+class io_uring_file_control_op : public io_uring_file_control_op_base
+{
+public:
+  ASIO_DEFINE_HANDLER_PTR(io_uring_file_control_op);
+
+  io_uring_file_control_op(const ASIO_LIBNS::error_code& success_ec,
+      int descriptor, control_type control, uint64_t offset,
+      uint64_t length, Handler& handler, const IoExecutor& io_ex)
+    : io_uring_file_control_op_base(success_ec, descriptor, control,
+        offset, length, &io_uring_file_control_op::do_complete),
+      handler_(ASIO_MOVE_CAST(Handler)(handler)),
+      work_(handler_, io_ex)
+  {
+  }
+
+  static void do_complete(void* owner, operation* base,
+      const ASIO_LIBNS::error_code& /*ec*/,
+      std::size_t /*bytes_transferred*/)
+  {
+    // Take ownership of the handler object.
+    io_uring_file_control_op* o(static_cast<io_uring_file_control_op*>(base));
+    ptr p = { ASIO_LIBNS::detail::addressof(o->handler_), o, o };
+
+    ASIO_HANDLER_COMPLETION((*o));
+
+    // A close that was never submitted still owns its descriptor.
+    if (o->control_ == close_op && o->descriptor_ != -1)
+    {
+      descriptor_ops::state_type state = 0;
+      ASIO_LIBNS::error_code ignored_ec;
+      descriptor_ops::close(o->descriptor_, state, ignored_ec);
+    }
+
+    // Free the I/O object that was used to submit the operation.
+    if (owner && o->io_uring_service_)
+      o->io_uring_service_->cleanup_io_object(o->io_object_data_);
+
+    // Take ownership of the operation's outstanding work.
+    handler_work<Handler, IoExecutor> w(
+        ASIO_MOVE_CAST2(handler_work<Handler, IoExecutor>)(
+          o->work_));
+
+    ASIO_ERROR_LOCATION(o->ec_);
+
+    // Make a copy of the handler so that the memory can be deallocated before
+    // the upcall is made. Even if we're not about to make an upcall, a
+    // sub-object of the handler may be the true owner of the memory associated
+    // with the handler. Consequently, a local copy of the handler is required
+    // to ensure that any owning sub-object remains valid until after we have
+    // deallocated the memory here.
+    detail::binder1<Handler, ASIO_LIBNS::error_code>
+      handler(o->handler_, o->ec_);
+    p.h = ASIO_LIBNS::detail::addressof(handler.handler_);
+    p.reset();
+
+    // Make the upcall if required.
+    if (owner)
+    {
+      fenced_block b(fenced_block::half);
+      ASIO_HANDLER_INVOCATION_BEGIN((handler.arg1_));
+      w.complete(handler, handler.handler_);
+      ASIO_HANDLER_INVOCATION_END;
+    }
+  }
+
+private:
+  Handler handler_;
+  handler_work<Handler, IoExecutor> work_;
+};
+
+template <typename Handler, typename IoExecutor>
+class io_uring_file_size_op : public io_uring_file_control_op_base
+{
+public:
+  ASIO_DEFINE_HANDLER_PTR(io_uring_file_size_op);
+
+  io_uring_file_size_op(const ASIO_LIBNS::error_code& success_ec,
+      int descriptor, Handler& handler, const IoExecutor& io_ex)
+    : io_uring_file_control_op_base(success_ec, descriptor, size_op,
+        0, 0, &io_uring_file_size_op::do_complete),
+      handler_(ASIO_MOVE_CAST(Handler)(handler)),
+      work_(handler_, io_ex)
+  {
+  }
+
+  static void do_complete(void* owner, operation* base,
+      const ASIO_LIBNS::error_code& /*ec*/,
+      std::size_t /*bytes_transferred*/)
+  {
+    // Take ownership of the handler object.
+    io_uring_file_size_op* o(static_cast<io_uring_file_size_op*>(base));
+    ptr p = { ASIO_LIBNS::detail::addressof(o->handler_), o, o };
+
+    ASIO_HANDLER_COMPLETION((*o));
+
+    // Take ownership of the operation's outstanding work.
+    handler_work<Handler, IoExecutor> w(
+        ASIO_MOVE_CAST2(handler_work<Handler, IoExecutor>)(
+          o->work_));
+
+    ASIO_ERROR_LOCATION(o->ec_);
+
+    // Make a copy of the handler so that the memory can be deallocated before
+    // the upcall is made. Even if we're not about to make an upcall, a
+    // sub-object of the handler may be the true owner of the memory associated
+    // with the handler. Consequently, a local copy of the handler is required
+    // to ensure that any owning sub-object remains valid until after we have
+    // deallocated the memory here.
+    detail::binder2<Handler, ASIO_LIBNS::error_code, uint64_t>
+      handler(o->handler_, o->ec_, o->size_);
+    p.h = ASIO_LIBNS::detail::addressof(handler.handler_);
+    p.reset();
+
+    // Make the upcall if required.
+    if (owner)
+    {
+      fenced_block b(fenced_block::half);
+      ASIO_HANDLER_INVOCATION_BEGIN((handler.arg1_, handler.arg2_));
+      w.complete(handler, handler.handler_);
+      ASIO_HANDLER_INVOCATION_END;
+    }
+  }
+
+private:
+  Handler handler_;
+  handler_work<Handler, IoExecutor> work_;
+};
+
+template <typename Service>
+class io_uring_file_open_op_base : public io_uring_file_control_op_base
+{
+public:
+  io_uring_file_open_op_base(const ASIO_LIBNS::error_code& success_ec,
+      Service& service, const char* path, file_base::flags open_flags,
+      func_type complete_func)
+    : io_uring_file_control_op_base(success_ec, -1,
+        open_op, 0, 0, complete_func),
+      impl_(0),
+      service_(service)
+  {
+    path_ = path;
+    open_flags_ = static_cast<int>(open_flags);
+  }
+
+  // The implementation that receives the descriptor, if it still exists.
+  // Protected by the service's mutex.
+  typename Service::implementation_type* impl_;
+
+protected:
+  // The service that completes the open.
+  Service& service_;
+};
+
+template <typename Service, typename Handler, typename IoExecutor>
+class io_uring_file_open_op : public io_uring_file_open_op_base<Service>
+{
+public:
+  ASIO_DEFINE_HANDLER_PTR(io_uring_file_open_op);
+
+  io_uring_file_open_op(const ASIO_LIBNS::error_code& success_ec,
+      Service& service, const char* path, file_base::flags open_flags,
+      Handler& handler, const IoExecutor& io_ex)
+    : io_uring_file_open_op_base<Service>(success_ec, service,
+        path, open_flags, &io_uring_file_open_op::do_complete),
+      handler_(ASIO_MOVE_CAST(Handler)(handler)),
+      work_(handler_, io_ex)
+  {
+  }
+
+  static void do_complete(void* owner, operation* base,
+      const ASIO_LIBNS::error_code& /*ec*/,
+      std::size_t /*bytes_transferred*/)
+  {
+    // Take ownership of the handler object.
+    io_uring_file_open_op* o(static_cast<io_uring_file_open_op*>(base));
+    ptr p = { ASIO_LIBNS::detail::addressof(o->handler_), o, o };
+
+    ASIO_HANDLER_COMPLETION((*o));
+
+    // Hand the descriptor to the file, or close it if the file has gone.
+    o->service_.complete_open(o, owner != 0);
+
+    // Take ownership of the operation's outstanding work.
+    handler_work<Handler, IoExecutor> w(
+        ASIO_MOVE_CAST2(handler_work<Handler, IoExecutor>)(
+          o->work_));
+
+    ASIO_ERROR_LOCATION(o->ec_);
+
+    // Make a copy of the handler so that the memory can be deallocated before
+    // the upcall is made. Even if we're not about to make an upcall, a
+    // sub-object of the handler may be the true owner of the memory associated
+    // with the handler. Consequently, a local copy of the handler is required
+    // to ensure that any owning sub-object remains valid until after we have
+    // deallocated the memory here.
+    detail::binder1<Handler, ASIO_LIBNS::error_code>
+      handler(o->handler_, o->ec_);
+    p.h = ASIO_LIBNS::detail::addressof(handler.handler_);
+    p.reset();
+
+    // Make the upcall if required.
+    if (owner)
+    {
+      fenced_block b(fenced_block::half);
+      ASIO_HANDLER_INVOCATION_BEGIN((handler.arg1_));
+      w.complete(handler, handler.handler_);
+      ASIO_HANDLER_INVOCATION_END;
+    }
+  }
+
+private:
+  Handler handler_;
+  handler_work<Handler, IoExecutor> work_;
+};
+
+} // namespace detail
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // defined(ASIO_HAS_FILE)
+       //   && defined(ASIO_HAS_IO_URING)
+
+#endif // ASIO_DETAIL_IO_URING_FILE_CONTROL_OP_HPP
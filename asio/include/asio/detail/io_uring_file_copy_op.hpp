@@ -0,0 +1,213 @@
+//
+// detail/io_uring_file_copy_op.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_DETAIL_IO_URING_FILE_COPY_OP_HPP
+#define ASIO_DETAIL_IO_URING_FILE_COPY_OP_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+
+#if defined(ASIO_HAS_FILE) \
+  && defined(ASIO_HAS_IO_URING)
+
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include "asio/detail/bind_handler.hpp"
+#include "asio/detail/cstdint.hpp"
+#include "asio/detail/descriptor_ops.hpp"
+#include "asio/detail/fenced_block.hpp"
+#include "asio/detail/handler_work.hpp"
+#include "asio/detail/io_uring_operation.hpp"
+#include "asio/detail/memory.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace ASIO_LIBNS {
+namespace detail {
+
+// Copies data between files by splicing it into a pipe from the source, and
+// out of the pipe into the target. The operation alternates between the two
+// until the whole range has been copied.
+class io_uring_file_copy_op_base : public io_uring_operation
+{
+public:
+  io_uring_file_copy_op_base(const ASIO_LIBNS::error_code& success_ec,
+      int descriptor, uint64_t offset, int target, std::size_t length,
+      func_type complete_func)
+    : io_uring_operation(success_ec,
+        &io_uring_file_copy_op_base::do_prepare,
+        &io_uring_file_copy_op_base::do_perform, complete_func),
+      descriptor_(descriptor),
+      offset_(offset),
+      target_(target),
+      length_(length),
+      copied_(0),
+      in_pipe_(0)
+  {
+    pipe_[0] = pipe_[1] = -1;
+    if (length_ > 0)
+    {
+      int result = ::pipe2(pipe_, O_CLOEXEC);
+      descriptor_ops::get_last_error(ec_, result != 0);
+      if (result != 0)
+        pipe_[0] = pipe_[1] = -1;
+#if defined(F_SETPIPE_SZ)
+      // Move more data per submission. The default size is used if the
+      // larger one is not permitted.
+      else if (length_ > 65536)
+        ::fcntl(pipe_[1], F_SETPIPE_SZ, 1024 * 1024);
+#endif // defined(F_SETPIPE_SZ)
+    }
+  }
+
+  ~io_uring_file_copy_op_base()
+  {
+    if (pipe_[0] != -1)
+      ::close(pipe_[0]);
+    if (pipe_[1] != -1)
+      ::close(pipe_[1]);
+  }
+
+  static void do_prepare(io_uring_operation* base, ::io_uring_sqe* sqe)
+  {
+    io_uring_file_copy_op_base* o(
+        static_cast<io_uring_file_copy_op_base*>(base));
+
+    if (o->in_pipe_ == 0)
+    {
+      std::size_t remaining = o->length_ - o->copied_;
+      ::io_uring_prep_splice(sqe, o->descriptor_, o->offset_ + o->copied_,
+          o->pipe_[1], -1, remaining < 0x40000000
+            ? static_cast<unsigned>(remaining) : 0x40000000u, 0);
+    }
+    else
+    {
+      ::io_uring_prep_splice(sqe, o->pipe_[0], -1, o->target_,
+          o->offset_ + o->copied_, static_cast<unsigned>(o->in_pipe_), 0);
+    }
+  }
+
+  static bool do_perform(io_uring_operation* base, bool after_completion)
+  {
+    io_uring_file_copy_op_base* o(
+        static_cast<io_uring_file_copy_op_base*>(base));
+
+    if (!after_completion)
+      return o->length_ == 0 || o->pipe_[0] == -1;
+
+    if (!o->ec_)
+    {
+      if (o->in_pipe_ == 0)
+      {
+        // Data has been moved into the pipe, unless the source is at its end.
+        o->in_pipe_ = o->bytes_transferred_;
+        if (o->in_pipe_ > 0)
+          return false;
+      }
+      else if (o->bytes_transferred_ > 0)
+      {
+        // Data has been moved out of the pipe to the target.
+        o->copied_ += o->bytes_transferred_;
+        o->in_pipe_ -= o->bytes_transferred_;
+        if (o->in_pipe_ > 0 || o->copied_ < o->length_)
+          return false;
+      }
+      else
+      {
+        o->ec_.assign(EIO, ASIO_LIBNS::error::get_system_category());
+      }
+    }
+
+    o->bytes_transferred_ = o->copied_;
+    return true;
+  }
+
+private:
+  int descriptor_;
+  uint64_t offset_;
+  int target_;
+  std::size_t length_;
+  std::size_t copied_;
+  std::size_t in_pipe_;
+  int pipe_[2];
+};
+
+template <typename Handler, typename IoExecutor>
+class io_uring_file_copy_op : public io_uring_file_copy_op_base
+{
+public:
+  ASIO_DEFINE_HANDLER_PTR(io_uring_file_copy_op);
+
+  io_uring_file_copy_op(const ASIO_LIBNS::error_code& success_ec,
+      int descriptor, uint64_t offset, int target, std::size_t length,
+      Handler& handler, const IoExecutor& io_ex)
+    : io_uring_file_copy_op_base(success_ec, descriptor, offset,
+        target, length, &io_uring_file_copy_op::do_complete),
+      handler_(ASIO_MOVE_CAST(Handler)(handler)),
+      work_(handler_, io_ex)
+  {
+  }
+
+  static void do_complete(void* owner, operation* base,
+      const ASIO_LIBNS::error_code& /*ec*/,
+      std::size_t /*bytes_transferred*/)
+  {
+    // Take ownership of the handler object.
+    io_uring_file_copy_op* o(static_cast<io_uring_file_copy_op*>(base));
+    ptr p = { ASIO_LIBNS::detail::addressof(o->handler_), o, o };
+
+    ASIO_HANDLER_COMPLETION((*o));
+
+    // Take ownership of the operation's outstanding work.
+    handler_work<Handler, IoExecutor> w(
+        ASIO_MOVE_CAST2(handler_work<Handler, IoExecutor>)(
+          o->work_));
+
+    ASIO_ERROR_LOCATION(o->ec_);
+
+    // Make a copy of the handler so that the memory can be deallocated before
+    // the upcall is made. Even if we're not about to make an upcall, a
+    // sub-object of the handler may be the true owner of the memory associated
+    // with the handler. Consequently, a local copy of the handler is required
+    // to ensure that any owning sub-object remains valid until after we have
+    // deallocated the memory here.
+    detail::binder2<Handler, ASIO_LIBNS::error_code, std::size_t>
+      handler(o->handler_, o->ec_, o->bytes_transferred_);
+    p.h = ASIO_LIBNS::detail::addressof(handler.handler_);
+    p.reset();
+
+    // Make the upcall if required.
+    if (owner)
+    {
+      fenced_block b(fenced_block::half);
+      ASIO_HANDLER_INVOCATION_BEGIN((handler.arg1_, handler.arg2_));
+      w.complete(handler, handler.handler_);
+      ASIO_HANDLER_INVOCATION_END;
+    }
+  }
+
+private:
+  Handler handler_;
+  handler_work<Handler, IoExecutor> work_;
+};
+
+} // namespace detail
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // defined(ASIO_HAS_FILE)
+       //   && defined(ASIO_HAS_IO_URING)
+
+#endif // ASIO_DETAIL_IO_URING_FILE_COPY_OP_HPP
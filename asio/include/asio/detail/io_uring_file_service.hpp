@@ -23,7 +23,15 @@
 #include <string>
 #include "asio/detail/cstdint.hpp"
 #include "asio/detail/descriptor_ops.hpp"
+#include "asio/detail/handler_alloc_helpers.hpp"
+#include "asio/detail/handler_cont_helpers.hpp"
 #include "asio/detail/io_uring_descriptor_service.hpp"
+#include "asio/detail/io_uring_file_control_op.hpp"
+#include "asio/detail/io_uring_file_copy_op.hpp"
+#include "asio/detail/io_uring_service.hpp"
+#include "asio/detail/memory.hpp"
+#include "asio/detail/mutex.hpp"
+#include "asio/detail/scheduler.hpp"
 #include "asio/error.hpp"
 #include "asio/execution_context.hpp"
 #include "asio/file_base.hpp"
@@ -51,6 +59,10 @@ public:
     friend class io_uring_file_service;
 
     bool is_stream_;
+
+    // The asynchronous open that will provide the descriptor, if any.
+    // Protected by the service's mutex.
+    io_uring_file_open_op_base<io_uring_file_service>* pending_open_;
   };
 
   ASIO_DECL io_uring_file_service(execution_context& context);
@@ -63,6 +75,7 @@ public:
   {
     descriptor_service_.construct(impl);
     impl.is_stream_ = false;
+    impl.pending_open_ = 0;
   }
 
   // Move-construct a new file implementation.
@@ -71,6 +84,8 @@ public:
   {
     descriptor_service_.move_construct(impl, other_impl);
     impl.is_stream_ = other_impl.is_stream_;
+    impl.pending_open_ = 0;
+    move_pending_open(other_impl, &impl);
   }
 
   // Move-assign from another file implementation.
@@ -81,11 +96,15 @@ public:
     descriptor_service_.move_assign(impl,
         other_service.descriptor_service_, other_impl);
     impl.is_stream_ = other_impl.is_stream_;
+    move_pending_open(impl, 0);
+    other_service.move_pending_open(other_impl,
+        &other_service == this ? &impl : 0);
   }
 
   // Destroy a file implementation.
   void destroy(implementation_type& impl)
   {
+    move_pending_open(impl, 0);
     descriptor_service_.destroy(impl);
   }
 
@@ -118,6 +137,7 @@ public:
   ASIO_LIBNS::error_code close(implementation_type& impl,
       ASIO_LIBNS::error_code& ec)
   {
+    move_pending_open(impl, 0);
     return descriptor_service_.close(impl, ec);
   }
 
@@ -146,6 +166,10 @@ public:
   ASIO_DECL uint64_t size(const implementation_type& impl,
       ASIO_LIBNS::error_code& ec) const;
 
+  // Get the alignment required for direct I/O on the file.
+  ASIO_DECL std::size_t alignment(const implementation_type& impl,
+      ASIO_LIBNS::error_code& ec) const;
+
   // Alter the size of the file.
   ASIO_DECL ASIO_LIBNS::error_code resize(implementation_type& impl,
       uint64_t n, ASIO_LIBNS::error_code& ec);
@@ -158,10 +182,152 @@ public:
   ASIO_DECL ASIO_LIBNS::error_code sync_data(implementation_type& impl,
       ASIO_LIBNS::error_code& ec);
 
+  // Allocate disk space for a range of the file.
+  ASIO_DECL ASIO_LIBNS::error_code allocate(implementation_type& impl,
+      uint64_t offset, uint64_t length, ASIO_LIBNS::error_code& ec);
+
   // Seek to a position in the file.
   ASIO_DECL uint64_t seek(implementation_type& impl, int64_t offset,
       file_base::seek_basis whence, ASIO_LIBNS::error_code& ec);
 
+  // Start an asynchronous open. The file becomes open when the operation
+  // completes.
+  template <typename Handler, typename IoExecutor>
+  void async_open(implementation_type& impl, const char* path,
+      file_base::flags open_flags, Handler& handler, const IoExecutor& io_ex)
+  {
+    bool is_continuation =
+      asio_handler_cont_helpers::is_continuation(handler);
+
+    // Allocate and construct an operation to wrap the handler.
+    typedef io_uring_file_open_op<
+      io_uring_file_service, Handler, IoExecutor> op;
+    typename op::ptr p = { ASIO_LIBNS::detail::addressof(handler),
+      op::ptr::allocate(handler), 0 };
+    p.p = new (p.v) op(success_ec_, *this, path, open_flags, handler, io_ex);
+
+    ASIO_HANDLER_CREATION((scheduler_.context(), *p.p, "file",
+          &impl, native_handle(impl), "async_open"));
+
+    if (begin_open(impl, p.p))
+      start_internal_op(p.p);
+    else
+      io_uring_service_.post_immediate_completion(p.p, is_continuation);
+    p.v = p.p = 0;
+  }
+
+  // Start an asynchronous close. The descriptor is detached from the file
+  // immediately, cancelling its outstanding operations.
+  template <typename Handler, typename IoExecutor>
+  void async_close(implementation_type& impl,
+      Handler& handler, const IoExecutor& io_ex)
+  {
+    bool is_continuation =
+      asio_handler_cont_helpers::is_continuation(handler);
+
+    move_pending_open(impl, 0);
+    int descriptor = descriptor_service_.release(impl);
+
+    // Allocate and construct an operation to wrap the handler.
+    typedef io_uring_file_control_op<Handler, IoExecutor> op;
+    typename op::ptr p = { ASIO_LIBNS::detail::addressof(handler),
+      op::ptr::allocate(handler), 0 };
+    p.p = new (p.v) op(success_ec_, descriptor,
+        op::close_op, 0, 0, handler, io_ex);
+
+    ASIO_HANDLER_CREATION((scheduler_.context(), *p.p, "file",
+          &impl, descriptor, "async_close"));
+
+    if (descriptor != -1)
+      start_internal_op(p.p);
+    else
+      io_uring_service_.post_immediate_completion(p.p, is_continuation);
+    p.v = p.p = 0;
+  }
+
+  // Start an asynchronous operation to get the size of the file.
+  template <typename Handler, typename IoExecutor>
+  void async_size(implementation_type& impl,
+      Handler& handler, const IoExecutor& io_ex)
+  {
+    bool is_continuation =
+      asio_handler_cont_helpers::is_continuation(handler);
+
+    // Allocate and construct an operation to wrap the handler.
+    typedef io_uring_file_size_op<Handler, IoExecutor> op;
+    typename op::ptr p = { ASIO_LIBNS::detail::addressof(handler),
+      op::ptr::allocate(handler), 0 };
+    p.p = new (p.v) op(success_ec_, native_handle(impl), handler, io_ex);
+
+    ASIO_HANDLER_CREATION((scheduler_.context(), *p.p, "file",
+          &impl, native_handle(impl), "async_size"));
+
+    descriptor_service_.start_op(impl, io_uring_service::read_op,
+        p.p, is_continuation, false);
+    p.v = p.p = 0;
+  }
+
+  // Start an asynchronous resize.
+  template <typename Handler, typename IoExecutor>
+  void async_resize(implementation_type& impl, uint64_t n,
+      Handler& handler, const IoExecutor& io_ex)
+  {
+#if defined(ASIO_HAS_IO_URING_FTRUNCATE)
+    start_control_op(impl, io_uring_file_control_op_base::resize_op,
+        0, n, handler, io_ex, "async_resize");
+#else // defined(ASIO_HAS_IO_URING_FTRUNCATE)
+    bool is_continuation =
+      asio_handler_cont_helpers::is_continuation(handler);
+
+    // Allocate and construct an operation to wrap the handler.
+    typedef io_uring_file_control_op<Handler, IoExecutor> op;
+    typename op::ptr p = { ASIO_LIBNS::detail::addressof(handler),
+      op::ptr::allocate(handler), 0 };
+    p.p = new (p.v) op(success_ec_, native_handle(impl),
+        op::resize_op, 0, n, handler, io_ex);
+
+    ASIO_HANDLER_CREATION((scheduler_.context(), *p.p, "file",
+          &impl, native_handle(impl), "async_resize"));
+
+    // Without the opcode the file is resized now.
+    resize(impl, n, p.p->ec_);
+    io_uring_service_.post_immediate_completion(p.p, is_continuation);
+    p.v = p.p = 0;
+#endif // defined(ASIO_HAS_IO_URING_FTRUNCATE)
+  }
+
+  // Start an asynchronous allocation of disk space.
+  template <typename Handler, typename IoExecutor>
+  void async_allocate(implementation_type& impl, uint64_t offset,
+      uint64_t length, Handler& handler, const IoExecutor& io_ex)
+  {
+    start_control_op(impl, io_uring_file_control_op_base::allocate_op,
+        offset, length, handler, io_ex, "async_allocate");
+  }
+
+  // Start an asynchronous synchronisation of the file to disk.
+  template <typename Handler, typename IoExecutor>
+  void async_sync_all(implementation_type& impl,
+      Handler& handler, const IoExecutor& io_ex)
+  {
+    start_control_op(impl, io_uring_file_control_op_base::sync_all_op,
+        0, 0, handler, io_ex, "async_sync_all");
+  }
+
+  // Start an asynchronous synchronisation of the file data to disk.
+  template <typename Handler, typename IoExecutor>
+  void async_sync_data(implementation_type& impl,
+      Handler& handler, const IoExecutor& io_ex)
+  {
+    start_control_op(impl, io_uring_file_control_op_base::sync_data_op,
+        0, 0, handler, io_ex, "async_sync_data");
+  }
+
+  // Attach the result of an asynchronous open to its file. Closes the
+  // descriptor if the file no longer wants it.
+  ASIO_DECL void complete_open(
+      io_uring_file_open_op_base<io_uring_file_service>* op, bool deliver);
+
   // Write the given data. Returns the number of bytes written.
   template <typename ConstBufferSequence>
   size_t write_some(implementation_type& impl,
@@ -239,10 +405,84 @@ public:
         impl, offset, buffers, handler, io_ex);
   }
 
+  // Start an asynchronous copy of data at the specified location to the same
+  // location in another file.
+  template <typename Handler, typename IoExecutor>
+  void async_copy_some_at(implementation_type& impl, uint64_t offset,
+      implementation_type& target, std::size_t length,
+      Handler& handler, const IoExecutor& io_ex)
+  {
+    bool is_continuation =
+      asio_handler_cont_helpers::is_continuation(handler);
+
+    // Allocate and construct an operation to wrap the handler.
+    typedef io_uring_file_copy_op<Handler, IoExecutor> op;
+    typename op::ptr p = { ASIO_LIBNS::detail::addressof(handler),
+      op::ptr::allocate(handler), 0 };
+    p.p = new (p.v) op(success_ec_, native_handle(impl),
+        offset, native_handle(target), length, handler, io_ex);
+
+    ASIO_HANDLER_CREATION((scheduler_.context(), *p.p, "file",
+          &impl, native_handle(impl), "async_copy_some_at"));
+
+    descriptor_service_.start_op(impl, io_uring_service::read_op,
+        p.p, is_continuation, false);
+    p.v = p.p = 0;
+  }
+
 private:
+  // Helper function to start an operation that does not transfer data. The
+  // operation is queued behind the file's outstanding writes.
+  template <typename Handler, typename IoExecutor>
+  void start_control_op(implementation_type& impl,
+      io_uring_file_control_op_base::control_type control,
+      uint64_t offset, uint64_t length, Handler& handler,
+      const IoExecutor& io_ex, const char* name)
+  {
+    bool is_continuation =
+      asio_handler_cont_helpers::is_continuation(handler);
+
+    // Allocate and construct an operation to wrap the handler.
+    typedef io_uring_file_control_op<Handler, IoExecutor> op;
+    typename op::ptr p = { ASIO_LIBNS::detail::addressof(handler),
+      op::ptr::allocate(handler), 0 };
+    p.p = new (p.v) op(success_ec_, native_handle(impl),
+        control, offset, length, handler, io_ex);
+
+    ASIO_HANDLER_CREATION((scheduler_.context(), *p.p, "file",
+          &impl, native_handle(impl), name));
+    (void)name;
+
+    descriptor_service_.start_op(impl, io_uring_service::write_op,
+        p.p, is_continuation, false);
+    p.v = p.p = 0;
+  }
+
+  // Submit an operation that is not associated with an open file.
+  ASIO_DECL void start_internal_op(io_uring_file_control_op_base* op);
+
+  // Attach an asynchronous open to a file that is not open. Returns false if
+  // the file is already open or being opened.
+  ASIO_DECL bool begin_open(implementation_type& impl,
+      io_uring_file_open_op_base<io_uring_file_service>* op);
+
+  // Hand a pending asynchronous open to another implementation, or detach it
+  // so that its result is discarded.
+  ASIO_DECL void move_pending_open(implementation_type& impl,
+      implementation_type* new_impl);
+
+  // The scheduler used to account for outstanding work.
+  scheduler& scheduler_;
+
+  // The io_uring_service used to submit operations that have no file.
+  io_uring_service& io_uring_service_;
+
   // The implementation used for initiating asynchronous operations.
   descriptor_service descriptor_service_;
 
+  // Mutex to protect access to pending opens.
+  ASIO_LIBNS::detail::mutex mutex_;
+
   // Cached success value to avoid accessing category singleton.
   const ASIO_LIBNS::error_code success_ec_;
 };
@@ -0,0 +1,181 @@
+//
+// detail/mapped_file_op.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_DETAIL_MAPPED_FILE_OP_HPP
+#define ASIO_DETAIL_MAPPED_FILE_OP_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+
+#if defined(ASIO_HAS_MAPPED_FILE)
+
+#include <cstddef>
+#include "asio/detail/bind_handler.hpp"
+#include "asio/detail/fenced_block.hpp"
+#include "asio/detail/handler_alloc_helpers.hpp"
+#include "asio/detail/handler_work.hpp"
+#include "asio/detail/mapped_region.hpp"
+#include "asio/detail/memory.hpp"
+#include "asio/detail/operation.hpp"
+#include "asio/error.hpp"
+
+#if defined(ASIO_HAS_IOCP)
+# include "asio/detail/win_iocp_io_context.hpp"
+#else // defined(ASIO_HAS_IOCP)
+# include "asio/detail/scheduler.hpp"
+#endif // defined(ASIO_HAS_IOCP)
+
+#include "asio/detail/push_options.hpp"
+
+namespace ASIO_LIBNS {
+namespace detail {
+
+class mapped_file_op_base : public operation
+{
+public:
+#if defined(ASIO_HAS_IOCP)
+  typedef class win_iocp_io_context scheduler_impl;
+#else
+  typedef class scheduler scheduler_impl;
+#endif
+
+  enum op_type
+  {
+    prefetch_op,
+    sync_op
+  };
+
+  // Perform the blocking operation on the region.
+  void perform()
+  {
+    if (type_ == prefetch_op)
+      region_->prefetch(offset_, length_, ec_);
+    else
+      region_->sync(ec_);
+  }
+
+  // Get the region the operation is performed on.
+  mapped_region* region() const
+  {
+    return region_.get();
+  }
+
+  // The error code to be passed to the completion handler.
+  ASIO_LIBNS::error_code ec_;
+
+protected:
+  mapped_file_op_base(const shared_ptr<mapped_region>& region,
+      op_type type, std::size_t offset, std::size_t length,
+      scheduler_impl& sched, func_type complete_func)
+    : operation(complete_func),
+      region_(region),
+      type_(type),
+      offset_(offset),
+      length_(length),
+      scheduler_(sched)
+  {
+  }
+
+  // The region is kept mapped until the operation is complete.
+  shared_ptr<mapped_region> region_;
+  op_type type_;
+  std::size_t offset_;
+  std::size_t length_;
+  scheduler_impl& scheduler_;
+};
+
+template <typename Handler, typename IoExecutor>
+class mapped_file_op : public mapped_file_op_base
+{
+public:
+  ASIO_DEFINE_HANDLER_PTR(mapped_file_op);
+
+  mapped_file_op(const shared_ptr<mapped_region>& region,
+      op_type type, std::size_t offset, std::size_t length,
+      scheduler_impl& sched, Handler& handler, const IoExecutor& io_ex)
+    : mapped_file_op_base(region, type, offset, length,
+        sched, &mapped_file_op::do_complete),
+      handler_(ASIO_MOVE_CAST(Handler)(handler)),
+      work_(handler_, io_ex)
+  {
+  }
+
+  static void do_complete(void* owner, operation* base,
+      const ASIO_LIBNS::error_code& /*ec*/,
+      std::size_t /*bytes_transferred*/)
+  {
+    // Take ownership of the operation object.
+    mapped_file_op* o(static_cast<mapped_file_op*>(base));
+    ptr p = { ASIO_LIBNS::detail::addressof(o->handler_), o, o };
+
+    if (owner && owner != &o->scheduler_)
+    {
+      // The operation is being run on the worker scheduler.
+      o->perform();
+
+      // Pass operation back to main scheduler for completion.
+      o->scheduler_.post_deferred_completion(o);
+      p.v = p.p = 0;
+    }
+    else
+    {
+      // The operation has been returned to the main scheduler. The completion
+      // handler is ready to be delivered.
+
+      ASIO_HANDLER_COMPLETION((*o));
+
+      // Release the region before the upcall, so that a file closed by the
+      // handler is unmapped immediately.
+      o->region_.reset();
+
+      // Take ownership of the operation's outstanding work.
+      handler_work<Handler, IoExecutor> w(
+          ASIO_MOVE_CAST2(handler_work<Handler, IoExecutor>)(
+            o->work_));
+
+      ASIO_ERROR_LOCATION(o->ec_);
+
+      // Make a copy of the handler so that the memory can be deallocated
+      // before the upcall is made. Even if we're not about to make an upcall,
+      // a sub-object of the handler may be the true owner of the memory
+      // associated with the handler. Consequently, a local copy of the handler
+      // is required to ensure that any owning sub-object remains valid until
+      // after we have deallocated the memory here.
+      detail::binder1<Handler, ASIO_LIBNS::error_code>
+        handler(o->handler_, o->ec_);
+      p.h = ASIO_LIBNS::detail::addressof(handler.handler_);
+      p.reset();
+
+      if (owner)
+      {
+        fenced_block b(fenced_block::half);
+        ASIO_HANDLER_INVOCATION_BEGIN((handler.arg1_));
+        w.complete(handler, handler.handler_);
+        ASIO_HANDLER_INVOCATION_END;
+      }
+    }
+  }
+
+private:
+  Handler handler_;
+  handler_work<Handler, IoExecutor> work_;
+};
+
+} // namespace detail
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // defined(ASIO_HAS_MAPPED_FILE)
+
+#endif // ASIO_DETAIL_MAPPED_FILE_OP_HPP
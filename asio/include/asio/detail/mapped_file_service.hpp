@@ -0,0 +1,219 @@
+//
+// detail/mapped_file_service.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_DETAIL_MAPPED_FILE_SERVICE_HPP
+#define ASIO_DETAIL_MAPPED_FILE_SERVICE_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+
+#if defined(ASIO_HAS_MAPPED_FILE)
+
+#include <cstddef>
+#include "asio/detail/mapped_file_op.hpp"
+#include "asio/detail/mapped_region.hpp"
+#include "asio/detail/memory.hpp"
+#include "asio/detail/mutex.hpp"
+#include "asio/detail/scoped_ptr.hpp"
+#include "asio/detail/thread.hpp"
+#include "asio/error.hpp"
+#include "asio/execution_context.hpp"
+#include "asio/file_base.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace ASIO_LIBNS {
+namespace detail {
+
+class mapped_file_service :
+  public execution_context_service_base<mapped_file_service>
+{
+public:
+  // The implementation type of the mapped file. Outstanding operations share
+  // ownership of the region so that it remains mapped while they run.
+  typedef shared_ptr<mapped_region> implementation_type;
+
+  // Constructor.
+  ASIO_DECL mapped_file_service(execution_context& context);
+
+  // Destructor.
+  ASIO_DECL ~mapped_file_service();
+
+  // Destroy all user-defined handler objects owned by the service.
+  ASIO_DECL void shutdown();
+
+  // Perform any fork-related housekeeping.
+  ASIO_DECL void notify_fork(execution_context::fork_event fork_ev);
+
+  // Construct a new mapped file implementation.
+  void construct(implementation_type&)
+  {
+  }
+
+  // Destroy a mapped file implementation.
+  void destroy(implementation_type& impl)
+  {
+    impl.reset();
+  }
+
+  // Move-construct a new mapped file implementation.
+  void move_construct(implementation_type& impl,
+      implementation_type& other_impl)
+  {
+    impl = ASIO_MOVE_CAST(implementation_type)(other_impl);
+    other_impl.reset();
+  }
+
+  // Move-assign from another mapped file implementation.
+  void move_assign(implementation_type& impl,
+      mapped_file_service&, implementation_type& other_impl)
+  {
+    impl = ASIO_MOVE_CAST(implementation_type)(other_impl);
+    other_impl.reset();
+  }
+
+  // Move-construct a new mapped file implementation.
+  void converting_move_construct(implementation_type& impl,
+      mapped_file_service&, implementation_type& other_impl)
+  {
+    move_construct(impl, other_impl);
+  }
+
+  // Move-assign from another mapped file implementation.
+  void converting_move_assign(implementation_type& impl,
+      mapped_file_service& other_service,
+      implementation_type& other_impl)
+  {
+    move_assign(impl, other_service, other_impl);
+  }
+
+  // Map the file using the specified path name.
+  ASIO_DECL ASIO_LIBNS::error_code open(implementation_type& impl,
+      const char* path, file_base::flags open_flags,
+      ASIO_LIBNS::error_code& ec);
+
+  // Determine whether the mapped file is open.
+  bool is_open(const implementation_type& impl) const
+  {
+    return impl.get() != 0;
+  }
+
+  // Unmap the file. The region remains mapped until outstanding operations
+  // are complete.
+  ASIO_LIBNS::error_code close(implementation_type& impl,
+      ASIO_LIBNS::error_code& ec)
+  {
+    impl.reset();
+    ASIO_LIBNS::error::clear(ec);
+    return ec;
+  }
+
+  // Get the start of the mapped region.
+  void* data(const implementation_type& impl) const
+  {
+    return impl.get() ? impl->data() : 0;
+  }
+
+  // Get the size of the mapped region.
+  std::size_t size(const implementation_type& impl) const
+  {
+    return impl.get() ? impl->size() : 0;
+  }
+
+  // Determine whether the mapped region may be written.
+  bool writable(const implementation_type& impl) const
+  {
+    return impl.get() ? impl->writable() : false;
+  }
+
+  // Write modified pages back to the file and wait for them to reach the disk.
+  ASIO_DECL ASIO_LIBNS::error_code sync(implementation_type& impl,
+      ASIO_LIBNS::error_code& ec);
+
+  // Start an asynchronous operation to bring a range into memory.
+  template <typename Handler, typename IoExecutor>
+  void async_prefetch(implementation_type& impl, std::size_t offset,
+      std::size_t length, Handler& handler, const IoExecutor& io_ex)
+  {
+    start_op(impl, mapped_file_op_base::prefetch_op,
+        offset, length, handler, io_ex, "async_prefetch");
+  }
+
+  // Start an asynchronous operation to write modified pages back to the file.
+  template <typename Handler, typename IoExecutor>
+  void async_sync(implementation_type& impl,
+      Handler& handler, const IoExecutor& io_ex)
+  {
+    start_op(impl, mapped_file_op_base::sync_op,
+        0, 0, handler, io_ex, "async_sync");
+  }
+
+private:
+  typedef mapped_file_op_base::scheduler_impl scheduler_impl;
+
+  // Helper function to allocate and start an operation.
+  template <typename Handler, typename IoExecutor>
+  void start_op(implementation_type& impl, mapped_file_op_base::op_type type,
+      std::size_t offset, std::size_t length, Handler& handler,
+      const IoExecutor& io_ex, const char* name)
+  {
+    // Allocate and construct an operation to wrap the handler.
+    typedef mapped_file_op<Handler, IoExecutor> op;
+    typename op::ptr p = { ASIO_LIBNS::detail::addressof(handler),
+      op::ptr::allocate(handler), 0 };
+    p.p = new (p.v) op(impl, type, offset, length,
+        scheduler_, handler, io_ex);
+
+    ASIO_HANDLER_CREATION((scheduler_.context(),
+          *p.p, "mapped_file", &impl, 0, name));
+    (void)name;
+
+    start_op(p.p);
+    p.v = p.p = 0;
+  }
+
+  // Start an operation on the worker thread, or perform it inline if the
+  // scheduler does not permit threads.
+  ASIO_DECL void start_op(mapped_file_op_base* op);
+
+  // Helper function to start the worker thread.
+  ASIO_DECL void start_work_thread();
+
+  // Helper class to run the work scheduler in a thread.
+  class work_scheduler_runner;
+
+  // The scheduler used to deliver completions.
+  scheduler_impl& scheduler_;
+
+  // Mutex to protect access to the worker thread.
+  ASIO_LIBNS::detail::mutex mutex_;
+
+  // Private scheduler used for performing blocking operations.
+  ASIO_LIBNS::detail::scoped_ptr<scheduler_impl> work_scheduler_;
+
+  // Thread used for running the work scheduler's run loop.
+  ASIO_LIBNS::detail::scoped_ptr<ASIO_LIBNS::detail::thread> work_thread_;
+};
+
+} // namespace detail
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#if defined(ASIO_HEADER_ONLY)
+# include "asio/detail/impl/mapped_file_service.ipp"
+#endif // defined(ASIO_HEADER_ONLY)
+
+#endif // defined(ASIO_HAS_MAPPED_FILE)
+
+#endif // ASIO_DETAIL_MAPPED_FILE_SERVICE_HPP
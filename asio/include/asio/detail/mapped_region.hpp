@@ -0,0 +1,117 @@
+//
+// detail/mapped_region.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_DETAIL_MAPPED_REGION_HPP
+#define ASIO_DETAIL_MAPPED_REGION_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+
+#if defined(ASIO_HAS_MAPPED_FILE)
+
+#include <cstddef>
+#include "asio/detail/noncopyable.hpp"
+#include "asio/error.hpp"
+#include "asio/file_base.hpp"
+
+#if defined(ASIO_WINDOWS)
+# include "asio/detail/socket_types.hpp"
+#endif // defined(ASIO_WINDOWS)
+
+#include "asio/detail/push_options.hpp"
+
+namespace ASIO_LIBNS {
+namespace detail {
+
+// A view of a whole file mapped into memory. The view is unmapped when the
+// region is destroyed.
+class mapped_region
+  : private noncopyable
+{
+public:
+  // Construct a region that is not mapped.
+  mapped_region()
+    : data_(0),
+      size_(0),
+      writable_(false)
+#if defined(ASIO_WINDOWS)
+      , file_(INVALID_HANDLE_VALUE)
+#endif // defined(ASIO_WINDOWS)
+  {
+  }
+
+  // Destructor unmaps the view.
+  ~mapped_region()
+  {
+    unmap();
+  }
+
+  // Map the file at the given path. An empty file is mapped as a view of
+  // size zero.
+  ASIO_DECL ASIO_LIBNS::error_code map(const char* path,
+      file_base::flags open_flags, ASIO_LIBNS::error_code& ec);
+
+  // Get the start of the view.
+  void* data() const
+  {
+    return data_;
+  }
+
+  // Get the size of the view.
+  std::size_t size() const
+  {
+    return size_;
+  }
+
+  // Whether the view may be written.
+  bool writable() const
+  {
+    return writable_;
+  }
+
+  // Bring the given range of the view into memory. Blocks until the data is
+  // resident.
+  ASIO_DECL ASIO_LIBNS::error_code prefetch(std::size_t offset,
+      std::size_t length, ASIO_LIBNS::error_code& ec);
+
+  // Write modified pages in the view back to the file, and wait for the file
+  // to reach the disk.
+  ASIO_DECL ASIO_LIBNS::error_code sync(ASIO_LIBNS::error_code& ec);
+
+private:
+  // Unmap the view and release the file.
+  ASIO_DECL void unmap();
+
+  // Get the size of a page.
+  ASIO_DECL static std::size_t page_size();
+
+  void* data_;
+  std::size_t size_;
+  bool writable_;
+#if defined(ASIO_WINDOWS)
+  HANDLE file_;
+#endif // defined(ASIO_WINDOWS)
+};
+
+} // namespace detail
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#if defined(ASIO_HEADER_ONLY)
+# include "asio/detail/impl/mapped_region.ipp"
+#endif // defined(ASIO_HEADER_ONLY)
+
+#endif // defined(ASIO_HAS_MAPPED_FILE)
+
+#endif // ASIO_DETAIL_MAPPED_REGION_HPP
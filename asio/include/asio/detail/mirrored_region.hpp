@@ -0,0 +1,102 @@
+//
+// detail/mirrored_region.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_DETAIL_MIRRORED_REGION_HPP
+#define ASIO_DETAIL_MIRRORED_REGION_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+
+#if defined(ASIO_HAS_RING_BUFFER)
+
+#include <cstddef>
+#include "asio/detail/noncopyable.hpp"
+#include "asio/error.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace ASIO_LIBNS {
+namespace detail {
+
+// A block of memory that is mapped twice into adjacent address ranges, so
+// that the byte at data() + size() + i is the byte at data() + i. Any range of
+// up to size() bytes that starts within the block is therefore contiguous.
+class mirrored_region
+  : private noncopyable
+{
+public:
+  // Construct a region that is not mapped.
+  mirrored_region()
+    : data_(0),
+      size_(0)
+  {
+  }
+
+  // Destructor unmaps the region.
+  ~mirrored_region()
+  {
+    unmap();
+  }
+
+  // Map a new region of at least the given size, replacing any existing one.
+  // The size is rounded up to a power of two that is a multiple of the
+  // system's allocation granularity.
+  ASIO_DECL ASIO_LIBNS::error_code map(std::size_t min_size,
+      ASIO_LIBNS::error_code& ec);
+
+  // Get the start of the region.
+  char* data() const
+  {
+    return data_;
+  }
+
+  // Get the size of the region, not counting the mirror.
+  std::size_t size() const
+  {
+    return size_;
+  }
+
+  // Exchange the regions held by two objects.
+  void swap(mirrored_region& other)
+  {
+    char* tmp_data = data_;
+    data_ = other.data_;
+    other.data_ = tmp_data;
+    std::size_t tmp_size = size_;
+    size_ = other.size_;
+    other.size_ = tmp_size;
+  }
+
+private:
+  // Unmap the region.
+  ASIO_DECL void unmap();
+
+  // Get the granularity at which memory may be mapped.
+  ASIO_DECL static std::size_t granularity();
+
+  char* data_;
+  std::size_t size_;
+};
+
+} // namespace detail
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#if defined(ASIO_HEADER_ONLY)
+# include "asio/detail/impl/mirrored_region.ipp"
+#endif // defined(ASIO_HEADER_ONLY)
+
+#endif // defined(ASIO_HAS_RING_BUFFER)
+
+#endif // ASIO_DETAIL_MIRRORED_REGION_HPP
@@ -0,0 +1,113 @@
+//
+// detail/pattern_dfa.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_DETAIL_PATTERN_DFA_HPP
+#define ASIO_DETAIL_PATTERN_DFA_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "asio/detail/cstdint.hpp"
+#include "asio/detail/noncopyable.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace ASIO_LIBNS {
+namespace detail {
+
+// A deterministic automaton that finds the earliest end of a match for any
+// of a set of simple patterns in a stream of bytes. The automaton searches
+// for matches starting at any position, so every byte is examined once.
+//
+// Each pattern is a sequence of atoms, each optionally followed by one of the
+// quantifiers ?, * or +. An atom is a literal byte, . for any byte, a
+// bracketed class such as [a-z] or [^\r\n], or one of the escapes \d, \D,
+// \s, \S, \w, \W, \n, \r, \t or \ followed by a punctuation character. A |
+// outside of brackets separates alternative patterns.
+class pattern_dfa
+  : private noncopyable
+{
+public:
+  // The largest number of states that the automaton may have.
+  enum { max_states = 4096 };
+
+  // Compile the patterns. Throws std::invalid_argument if a pattern is not
+  // valid or can match an empty string, and std::length_error if the
+  // automaton would have too many states.
+  ASIO_DECL explicit pattern_dfa(const std::vector<std::string>& patterns);
+
+  // Get the state in which the search starts.
+  std::size_t start() const
+  {
+    return 0;
+  }
+
+  // Get the state reached from the given state by the next byte.
+  std::size_t next(std::size_t state, unsigned char c) const
+  {
+    return transitions_[state * 256 + c];
+  }
+
+  // Get the index of the pattern matched on reaching the given state, plus
+  // one, or zero if the state does not complete a match.
+  std::size_t accepts(std::size_t state) const
+  {
+    return accepts_[state];
+  }
+
+private:
+  // An atom of a pattern, being a set of bytes and a quantifier. Each
+  // pattern ends with an atom that matches nothing, and which records the
+  // index of the pattern plus one.
+  struct atom
+  {
+    bool bytes[256];
+    char quantifier;
+    std::size_t pattern;
+  };
+
+  // Parse one alternative of a pattern, appending its atoms.
+  ASIO_DECL static void parse(const std::string& pattern,
+      std::vector<atom>& atoms);
+
+  // Parse an escape sequence into a set of bytes.
+  ASIO_DECL static void parse_escape(char c, bool bytes[256]);
+
+  // Add a position and the positions reachable from it without consuming a
+  // byte to a set of positions.
+  ASIO_DECL void close(std::size_t position,
+      std::vector<bool>& positions) const;
+
+  // The atoms of all patterns. A position in a pattern is the index of the
+  // next atom to be matched.
+  std::vector<atom> atoms_;
+
+  // The transition table, with 256 entries for each state.
+  std::vector<uint32_t> transitions_;
+
+  // The accepted pattern plus one for each state, or zero.
+  std::vector<std::size_t> accepts_;
+};
+
+} // namespace detail
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#if defined(ASIO_HEADER_ONLY)
+# include "asio/detail/impl/pattern_dfa.ipp"
+#endif // defined(ASIO_HEADER_ONLY)
+
+#endif // ASIO_DETAIL_PATTERN_DFA_HPP
@@ -0,0 +1,265 @@
+//
+// detail/reactive_file_control_op.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_DETAIL_REACTIVE_FILE_CONTROL_OP_HPP
+#define ASIO_DETAIL_REACTIVE_FILE_CONTROL_OP_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+
+#if defined(ASIO_HAS_FILE) \
+  && !defined(ASIO_HAS_IOCP) \
+  && !defined(ASIO_HAS_IO_URING)
+
+#include "asio/detail/bind_handler.hpp"
+#include "asio/detail/descriptor_ops.hpp"
+#include "asio/detail/fenced_block.hpp"
+#include "asio/detail/handler_work.hpp"
+#include "asio/detail/memory.hpp"
+#include "asio/detail/reactive_file_op.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace ASIO_LIBNS {
+namespace detail {
+
+// File operations that do not transfer data, and so are always performed by
+// the pool of threads.
+class reactive_file_control_op_base : public reactive_file_op
+{
+public:
+  enum control_type
+  {
+    sync_all_op,
+    sync_data_op,
+    resize_op,
+    allocate_op,
+    size_op,
+    close_op
+  };
+
+  reactive_file_control_op_base(const ASIO_LIBNS::error_code& success_ec,
+      scheduler& sched, const weak_ptr<void>& cancel_token, int descriptor,
+      control_type control, uint64_t offset, uint64_t length,
+      func_type complete_func)
+    : reactive_file_op(success_ec, &reactive_file_control_op_base::do_perform,
+        complete_func, sched, cancel_token, descriptor, true, offset),
+      control_(control),
+      length_(length),
+      size_(0)
+  {
+  }
+
+  static bool do_perform(reactive_file_op* base, bool may_block)
+  {
+    reactive_file_control_op_base* o(
+        static_cast<reactive_file_control_op_base*>(base));
+
+    // Closing a file that is not open does not need the pool.
+    if (!may_block && (o->control_ != close_op || o->descriptor_ != -1))
+      return false;
+
+    switch (o->control_)
+    {
+    case sync_all_op:
+      descriptor_ops::fsync(o->descriptor_, o->ec_);
+      break;
+    case sync_data_op:
+      descriptor_ops::fdatasync(o->descriptor_, o->ec_);
+      break;
+    case resize_op:
+      descriptor_ops::ftruncate(o->descriptor_, o->length_, o->ec_);
+      break;
+    case allocate_op:
+      descriptor_ops::fallocate(o->descriptor_,
+          o->offset_, o->length_, o->ec_);
+      break;
+    case size_op:
+      o->size_ = descriptor_ops::file_size(o->descriptor_, o->ec_);
+      break;
+    case close_op:
+      {
+        descriptor_ops::state_type state = 0;
+        descriptor_ops::close(o->descriptor_, state, o->ec_);
+        o->descriptor_ = -1;
+      }
+      break;
+    }
+
+    ASIO_HANDLER_REACTOR_OPERATION((*o, "file_control", o->ec_));
+
+    return true;
+  }
+
+protected:
+  control_type control_;
+  uint64_t length_;
+  uint64_t size_;
+};
+
+template <typename Handler, typename IoExecutor>
+class reactive_file_control_op : public reactive_file_control_op_base
+{
+public:
+  ASIO_DEFINE_HANDLER_PTR(reactive_file_control_op);
+
+  reactive_file_control_op(const ASIO_LIBNS::error_code& success_ec,
+      scheduler& sched, const weak_ptr<void>& cancel_token, int descriptor,
+      control_type control, uint64_t offset, uint64_t length,
+      Handler& handler, const IoExecutor& io_ex)
+    : reactive_file_control_op_base(success_ec, sched, cancel_token,
+        descriptor, control, offset, length,
+        &reactive_file_control_op::do_complete),
+      handler_(ASIO_MOVE_CAST(Handler)(handler)),
+      work_(handler_, io_ex)
+  {
+  }
+
+  // A close must be performed even if the file is cancelled, so the
+  // operation keeps its own token alive.
+  void set_cancel_token(const shared_ptr<void>& token)
+  {
+    token_ = token;
+  }
+
+  static void do_complete(void* owner, operation* base,
+      const ASIO_LIBNS::error_code& /*ec*/,
+      std::size_t /*bytes_transferred*/)
+  {
+    reactive_file_control_op* o(static_cast<reactive_file_control_op*>(base));
+
+    // When run on a worker thread, the operation is performed there.
+    if (o->perform_on_worker(owner))
+      return;
+
+    // A descriptor that is still owned by the operation is closed.
+    if (o->control_ == close_op && o->descriptor_ != -1)
+    {
+      descriptor_ops::state_type state = 0;
+      ASIO_LIBNS::error_code ignored_ec;
+      descriptor_ops::close(o->descriptor_, state, ignored_ec);
+    }
+
+    // Take ownership of the handler object.
+    ptr p = { ASIO_LIBNS::detail::addressof(o->handler_), o, o };
+
+    ASIO_HANDLER_COMPLETION((*o));
+
+    // Take ownership of the operation's outstanding work.
+    handler_work<Handler, IoExecutor> w(
+        ASIO_MOVE_CAST2(handler_work<Handler, IoExecutor>)(
+          o->work_));
+
+    ASIO_ERROR_LOCATION(o->ec_);
+
+    // Make a copy of the handler so that the memory can be deallocated before
+    // the upcall is made. Even if we're not about to make an upcall, a
+    // sub-object of the handler may be the true owner of the memory associated
+    // with the handler. Consequently, a local copy of the handler is required
+    // to ensure that any owning sub-object remains valid until after we have
+    // deallocated the memory here.
+    detail::binder1<Handler, ASIO_LIBNS::error_code>
+      handler(o->handler_, o->ec_);
+    p.h = ASIO_LIBNS::detail::addressof(handler.handler_);
+    p.reset();
+
+    // Make the upcall if required.
+    if (owner)
+    {
+      fenced_block b(fenced_block::half);
+      ASIO_HANDLER_INVOCATION_BEGIN((handler.arg1_));
+      w.complete(handler, handler.handler_);
+      ASIO_HANDLER_INVOCATION_END;
+    }
+  }
+
+private:
+  Handler handler_;
+  handler_work<Handler, IoExecutor> work_;
+  shared_ptr<void> token_;
+};
+
+template <typename Handler, typename IoExecutor>
+class reactive_file_size_op : public reactive_file_control_op_base
+{
+public:
+  ASIO_DEFINE_HANDLER_PTR(reactive_file_size_op);
+
+  reactive_file_size_op(const ASIO_LIBNS::error_code& success_ec,
+      scheduler& sched, const weak_ptr<void>& cancel_token, int descriptor,
+      Handler& handler, const IoExecutor& io_ex)
+    : reactive_file_control_op_base(success_ec, sched, cancel_token,
+        descriptor, size_op, 0, 0, &reactive_file_size_op::do_complete),
+      handler_(ASIO_MOVE_CAST(Handler)(handler)),
+      work_(handler_, io_ex)
+  {
+  }
+
+  static void do_complete(void* owner, operation* base,
+      const ASIO_LIBNS::error_code& /*ec*/,
+      std::size_t /*bytes_transferred*/)
+  {
+    reactive_file_size_op* o(static_cast<reactive_file_size_op*>(base));
+
+    // When run on a worker thread, the operation is performed there.
+    if (o->perform_on_worker(owner))
+      return;
+
+    // Take ownership of the handler object.
+    ptr p = { ASIO_LIBNS::detail::addressof(o->handler_), o, o };
+
+    ASIO_HANDLER_COMPLETION((*o));
+
+    // Take ownership of the operation's outstanding work.
+    handler_work<Handler, IoExecutor> w(
+        ASIO_MOVE_CAST2(handler_work<Handler, IoExecutor>)(
+          o->work_));
+
+    ASIO_ERROR_LOCATION(o->ec_);
+
+    // Make a copy of the handler so that the memory can be deallocated before
+    // the upcall is made. Even if we're not about to make an upcall, a
+    // sub-object of the handler may be the true owner of the memory associated
+    // with the handler. Consequently, a local copy of the handler is required
+    // to ensure that any owning sub-object remains valid until after we have
+    // deallocated the memory here.
+    detail::binder2<Handler, ASIO_LIBNS::error_code, uint64_t>
+      handler(o->handler_, o->ec_, o->size_);
+    p.h = ASIO_LIBNS::detail::addressof(handler.handler_);
+    p.reset();
+
+    // Make the upcall if required.
+    if (owner)
+    {
+      fenced_block b(fenced_block::half);
+      ASIO_HANDLER_INVOCATION_BEGIN((handler.arg1_, handler.arg2_));
+      w.complete(handler, handler.handler_);
+      ASIO_HANDLER_INVOCATION_END;
+    }
+  }
+
+private:
+  Handler handler_;
+  handler_work<Handler, IoExecutor> work_;
+};
+
+} // namespace detail
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // defined(ASIO_HAS_FILE)
+       //   && !defined(ASIO_HAS_IOCP)
+       //   && !defined(ASIO_HAS_IO_URING)
+
+#endif // ASIO_DETAIL_REACTIVE_FILE_CONTROL_OP_HPP
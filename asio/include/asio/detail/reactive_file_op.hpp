@@ -0,0 +1,118 @@
+//
+// detail/reactive_file_op.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_DETAIL_REACTIVE_FILE_OP_HPP
+#define ASIO_DETAIL_REACTIVE_FILE_OP_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+
+#if defined(ASIO_HAS_FILE) \
+  && !defined(ASIO_HAS_IOCP) \
+  && !defined(ASIO_HAS_IO_URING)
+
+#include "asio/detail/cstdint.hpp"
+#include "asio/detail/memory.hpp"
+#include "asio/detail/operation.hpp"
+#include "asio/detail/scheduler.hpp"
+#include "asio/error.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace ASIO_LIBNS {
+namespace detail {
+
+// Base class for file operations that are performed by a pool of threads when
+// they cannot be completed without blocking.
+class reactive_file_op : public operation
+{
+public:
+  // The error code to be passed to the completion handler.
+  ASIO_LIBNS::error_code ec_;
+
+  // The number of bytes transferred, to be passed to the completion handler.
+  std::size_t bytes_transferred_;
+
+  // Attempt to perform the operation without blocking. Returns true if the
+  // operation has completed.
+  bool try_perform()
+  {
+    return perform_func_(this, false);
+  }
+
+  // Perform the operation, blocking if necessary.
+  void perform()
+  {
+    perform_func_(this, true);
+  }
+
+protected:
+  typedef bool (*perform_func_type)(reactive_file_op*, bool);
+
+  reactive_file_op(const ASIO_LIBNS::error_code& success_ec,
+      perform_func_type perform_func, func_type complete_func,
+      scheduler& sched, const weak_ptr<void>& cancel_token,
+      int descriptor, bool has_offset, uint64_t offset)
+    : operation(complete_func),
+      ec_(success_ec),
+      bytes_transferred_(0),
+      descriptor_(descriptor),
+      has_offset_(has_offset),
+      offset_(offset),
+      perform_func_(perform_func),
+      scheduler_(sched),
+      cancel_token_(cancel_token)
+  {
+  }
+
+  // If the operation is being run by a worker thread, perform it and hand it
+  // back to the scheduler for completion. Returns true if this was done.
+  bool perform_on_worker(void* owner)
+  {
+    if (!owner || owner == &scheduler_)
+      return false;
+
+    // Operations that were cancelled before reaching a worker are abandoned.
+    if (cancel_token_.expired())
+      ec_ = ASIO_LIBNS::error::operation_aborted;
+    else
+      perform();
+
+    scheduler_.post_deferred_completion(this);
+    return true;
+  }
+
+  // The file descriptor.
+  int descriptor_;
+
+  // Whether the operation is performed at offset_, rather than at the
+  // current file position.
+  bool has_offset_;
+  uint64_t offset_;
+
+private:
+  perform_func_type perform_func_;
+  scheduler& scheduler_;
+  weak_ptr<void> cancel_token_;
+};
+
+} // namespace detail
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // defined(ASIO_HAS_FILE)
+       //   && !defined(ASIO_HAS_IOCP)
+       //   && !defined(ASIO_HAS_IO_URING)
+
+#endif // ASIO_DETAIL_REACTIVE_FILE_OP_HPP
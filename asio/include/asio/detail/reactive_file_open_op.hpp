@@ -0,0 +1,173 @@
+//
+// detail/reactive_file_open_op.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_DETAIL_REACTIVE_FILE_OPEN_OP_HPP
+#define ASIO_DETAIL_REACTIVE_FILE_OPEN_OP_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+
+#if defined(ASIO_HAS_FILE) \
+  && !defined(ASIO_HAS_IOCP) \
+  && !defined(ASIO_HAS_IO_URING)
+
+#include <string>
+#include "asio/detail/bind_handler.hpp"
+#include "asio/detail/descriptor_ops.hpp"
+#include "asio/detail/fenced_block.hpp"
+#include "asio/detail/handler_work.hpp"
+#include "asio/detail/memory.hpp"
+#include "asio/detail/reactive_file_op.hpp"
+#include "asio/file_base.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace ASIO_LIBNS {
+namespace detail {
+
+template <typename Service>
+class reactive_file_open_op_base : public reactive_file_op
+{
+public:
+  reactive_file_open_op_base(const ASIO_LIBNS::error_code& success_ec,
+      scheduler& sched, const weak_ptr<void>& cancel_token,
+      Service& service, const char* path, file_base::flags open_flags,
+      func_type complete_func)
+    : reactive_file_op(success_ec, &reactive_file_open_op_base::do_perform,
+        complete_func, sched, cancel_token, -1, false, 0),
+      impl_(0),
+      service_(service),
+      path_(path),
+      open_flags_(open_flags)
+  {
+  }
+
+  static bool do_perform(reactive_file_op* base, bool may_block)
+  {
+    reactive_file_open_op_base* o(
+        static_cast<reactive_file_open_op_base*>(base));
+
+    if (!may_block)
+      return false;
+
+    o->descriptor_ = descriptor_ops::open(o->path_.c_str(),
+        static_cast<int>(o->open_flags_), 0777, o->ec_);
+
+    ASIO_HANDLER_REACTOR_OPERATION((*o, "open", o->ec_));
+
+    return true;
+  }
+
+  // The descriptor that was opened, or -1 if none.
+  int descriptor() const
+  {
+    return descriptor_;
+  }
+
+  // Give up ownership of the descriptor.
+  void release_descriptor()
+  {
+    descriptor_ = -1;
+  }
+
+  // The implementation that receives the descriptor, if it still exists.
+  // Protected by the service's mutex.
+  typename Service::implementation_type* impl_;
+
+protected:
+  // The service that completes the open.
+  Service& service_;
+
+  // The arguments to the open.
+  std::string path_;
+  file_base::flags open_flags_;
+};
+
+template <typename Service, typename Handler, typename IoExecutor>
+class reactive_file_open_op : public reactive_file_open_op_base<Service>
+{
+public:
+  ASIO_DEFINE_HANDLER_PTR(reactive_file_open_op);
+
+  reactive_file_open_op(const ASIO_LIBNS::error_code& success_ec,
+      scheduler& sched, const weak_ptr<void>& cancel_token,
+      Service& service, const char* path, file_base::flags open_flags,
+      Handler& handler, const IoExecutor& io_ex)
+    : reactive_file_open_op_base<Service>(success_ec, sched, cancel_token,
+        service, path, open_flags, &reactive_file_open_op::do_complete),
+      handler_(ASIO_MOVE_CAST(Handler)(handler)),
+      work_(handler_, io_ex)
+  {
+  }
+
+  static void do_complete(void* owner, operation* base,
+      const ASIO_LIBNS::error_code& /*ec*/,
+      std::size_t /*bytes_transferred*/)
+  {
+    reactive_file_open_op* o(static_cast<reactive_file_open_op*>(base));
+
+    // When run on a worker thread, the operation is performed there.
+    if (o->perform_on_worker(owner))
+      return;
+
+    // Hand the descriptor to the file, or close it if the file has gone.
+    o->service_.complete_open(o, owner != 0);
+
+    // Take ownership of the handler object.
+    ptr p = { ASIO_LIBNS::detail::addressof(o->handler_), o, o };
+
+    ASIO_HANDLER_COMPLETION((*o));
+
+    // Take ownership of the operation's outstanding work.
+    handler_work<Handler, IoExecutor> w(
+        ASIO_MOVE_CAST2(handler_work<Handler, IoExecutor>)(
+          o->work_));
+
+    ASIO_ERROR_LOCATION(o->ec_);
+
+    // Make a copy of the handler so that the memory can be deallocated before
+    // the upcall is made. Even if we're not about to make an upcall, a
+    // sub-object of the handler may be the true owner of the memory associated
+    // with the handler. Consequently, a local copy of the handler is required
+    // to ensure that any owning sub-object remains valid until after we have
+    // deallocated the memory here.
+    detail::binder1<Handler, ASIO_LIBNS::error_code>
+      handler(o->handler_, o->ec_);
+    p.h = ASIO_LIBNS::detail::addressof(handler.handler_);
+    p.reset();
+
+    // Make the upcall if required.
+    if (owner)
+    {
+      fenced_block b(fenced_block::half);
+      ASIO_HANDLER_INVOCATION_BEGIN((handler.arg1_));
+      w.complete(handler, handler.handler_);
+      ASIO_HANDLER_INVOCATION_END;
+    }
+  }
+
+private:
+  Handler handler_;
+  handler_work<Handler, IoExecutor> work_;
+};
+
+} // namespace detail
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // defined(ASIO_HAS_FILE)
+       //   && !defined(ASIO_HAS_IOCP)
+       //   && !defined(ASIO_HAS_IO_URING)
+
+#endif // ASIO_DETAIL_REACTIVE_FILE_OPEN_OP_HPP
@@ -0,0 +1,629 @@
+//
+// detail/reactive_file_service.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_DETAIL_REACTIVE_FILE_SERVICE_HPP
+#define ASIO_DETAIL_REACTIVE_FILE_SERVICE_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+
+#if defined(ASIO_HAS_FILE) \
+  && !defined(ASIO_HAS_IOCP) \
+  && !defined(ASIO_HAS_IO_URING)
+
+#include <cstddef>
+#include <string>
+#include "asio/detail/atomic_count.hpp"
+#include "asio/detail/buffer_sequence_adapter.hpp"
+#include "asio/detail/cstdint.hpp"
+#include "asio/detail/descriptor_ops.hpp"
+#include "asio/detail/handler_alloc_helpers.hpp"
+#include "asio/detail/handler_cont_helpers.hpp"
+#include "asio/detail/memory.hpp"
+#include "asio/detail/mutex.hpp"
+#include "asio/detail/reactive_descriptor_service.hpp"
+#include "asio/detail/reactive_file_control_op.hpp"
+#include "asio/detail/reactive_file_copy_op.hpp"
+#include "asio/detail/reactive_file_op.hpp"
+#include "asio/detail/reactive_file_open_op.hpp"
+#include "asio/detail/reactive_file_read_op.hpp"
+#include "asio/detail/reactive_file_write_op.hpp"
+#include "asio/detail/scheduler.hpp"
+#include "asio/detail/scoped_ptr.hpp"
+#include "asio/detail/socket_ops.hpp"
+#include "asio/detail/thread_group.hpp"
+#include "asio/error.hpp"
+#include "asio/execution_context.hpp"
+#include "asio/file_base.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace ASIO_LIBNS {
+namespace detail {
+
+// Extend the reactive_descriptor_service to provide file support. As files are
+// always ready as far as the reactor is concerned, asynchronous operations
+// are instead performed by a pool of threads, unless they can be completed
+// immediately.
+class reactive_file_service :
+  public execution_context_service_base<reactive_file_service>
+{
+public:
+  typedef reactive_descriptor_service descriptor_service;
+
+  // The native type of a file.
+  typedef descriptor_service::native_handle_type native_handle_type;
+
+  // The implementation type of the file.
+  class implementation_type : descriptor_service::implementation_type
+  {
+  private:
+    // Only this service will have access to the internal values.
+    friend class reactive_file_service;
+
+    bool is_stream_;
+
+    // Replaced to abandon the operations that have not yet been performed.
+    shared_ptr<void> cancel_token_;
+
+    // The asynchronous open that will provide the descriptor, if any.
+    // Protected by the service's mutex.
+    reactive_file_open_op_base<reactive_file_service>* pending_open_;
+  };
+
+  ASIO_DECL reactive_file_service(execution_context& context);
+
+  // Destructor.
+  ASIO_DECL ~reactive_file_service();
+
+  // Destroy all user-defined handler objects owned by the service.
+  ASIO_DECL void shutdown();
+
+  // Perform any fork-related housekeeping.
+  ASIO_DECL void notify_fork(execution_context::fork_event fork_ev);
+
+  // Construct a new file implementation.
+  void construct(implementation_type& impl)
+  {
+    descriptor_service_.construct(impl);
+    impl.is_stream_ = false;
+    reset_cancel_token(impl);
+    impl.pending_open_ = 0;
+  }
+
+  // Move-construct a new file implementation.
+  void move_construct(implementation_type& impl,
+      implementation_type& other_impl)
+  {
+    descriptor_service_.move_construct(impl, other_impl);
+    impl.is_stream_ = other_impl.is_stream_;
+    impl.cancel_token_ = other_impl.cancel_token_;
+    reset_cancel_token(other_impl);
+    impl.pending_open_ = 0;
+    move_pending_open(other_impl, &impl);
+  }
+
+  // Move-assign from another file implementation.
+  void move_assign(implementation_type& impl,
+      reactive_file_service& other_service,
+      implementation_type& other_impl)
+  {
+    descriptor_service_.move_assign(impl,
+        other_service.descriptor_service_, other_impl);
+    impl.is_stream_ = other_impl.is_stream_;
+    impl.cancel_token_ = other_impl.cancel_token_;
+    other_service.reset_cancel_token(other_impl);
+    move_pending_open(impl, 0);
+    other_service.move_pending_open(other_impl,
+        &other_service == this ? &impl : 0);
+  }
+
+  // Destroy a file implementation.
+  void destroy(implementation_type& impl)
+  {
+    impl.cancel_token_.reset();
+    move_pending_open(impl, 0);
+    descriptor_service_.destroy(impl);
+  }
+
+  // Open the file using the specified path name.
+  ASIO_DECL ASIO_LIBNS::error_code open(implementation_type& impl,
+      const char* path, file_base::flags open_flags,
+      ASIO_LIBNS::error_code& ec);
+
+  // Assign a native descriptor to a file implementation.
+  ASIO_LIBNS::error_code assign(implementation_type& impl,
+      const native_handle_type& native_descriptor,
+      ASIO_LIBNS::error_code& ec)
+  {
+    return descriptor_service_.assign(impl, native_descriptor, ec);
+  }
+
+  // Set whether the implementation is stream-oriented.
+  void set_is_stream(implementation_type& impl, bool is_stream)
+  {
+    impl.is_stream_ = is_stream;
+  }
+
+  // Determine whether the file is open.
+  bool is_open(const implementation_type& impl) const
+  {
+    return descriptor_service_.is_open(impl);
+  }
+
+  // Destroy a file implementation.
+  ASIO_LIBNS::error_code close(implementation_type& impl,
+      ASIO_LIBNS::error_code& ec)
+  {
+    reset_cancel_token(impl);
+    move_pending_open(impl, 0);
+    return descriptor_service_.close(impl, ec);
+  }
+
+  // Get the native file representation.
+  native_handle_type native_handle(const implementation_type& impl) const
+  {
+    return descriptor_service_.native_handle(impl);
+  }
+
+  // Release ownership of the native descriptor representation.
+  native_handle_type release(implementation_type& impl,
+      ASIO_LIBNS::error_code& ec)
+  {
+    ec = success_ec_;
+    reset_cancel_token(impl);
+    return descriptor_service_.release(impl);
+  }
+
+  // Cancel all operations associated with the file. Operations that are
+  // already being performed run to completion.
+  ASIO_LIBNS::error_code cancel(implementation_type& impl,
+      ASIO_LIBNS::error_code& ec)
+  {
+    reset_cancel_token(impl);
+    return descriptor_service_.cancel(impl, ec);
+  }
+
+  // Get the size of the file.
+  ASIO_DECL uint64_t size(const implementation_type& impl,
+      ASIO_LIBNS::error_code& ec) const;
+
+  // Get the alignment required for direct I/O on the file.
+  ASIO_DECL std::size_t alignment(const implementation_type& impl,
+      ASIO_LIBNS::error_code& ec) const;
+
+  // Alter the size of the file.
+  ASIO_DECL ASIO_LIBNS::error_code resize(implementation_type& impl,
+      uint64_t n, ASIO_LIBNS::error_code& ec);
+
+  // Synchronise the file to disk.
+  ASIO_DECL ASIO_LIBNS::error_code sync_all(implementation_type& impl,
+      ASIO_LIBNS::error_code& ec);
+
+  // Synchronise the file data to disk.
+  ASIO_DECL ASIO_LIBNS::error_code sync_data(implementation_type& impl,
+      ASIO_LIBNS::error_code& ec);
+
+  // Allocate disk space for a range of the file.
+  ASIO_DECL ASIO_LIBNS::error_code allocate(implementation_type& impl,
+      uint64_t offset, uint64_t length, ASIO_LIBNS::error_code& ec);
+
+  // Seek to a position in the file.
+  ASIO_DECL uint64_t seek(implementation_type& impl, int64_t offset,
+      file_base::seek_basis whence, ASIO_LIBNS::error_code& ec);
+
+  // Set the maximum number of threads used to perform operations. The pool
+  // is grown on demand and never shrinks.
+  ASIO_DECL void set_thread_pool(std::size_t max_threads);
+
+  // Start an asynchronous open. The file is opened by the pool and becomes
+  // open when the operation completes.
+  template <typename Handler, typename IoExecutor>
+  void async_open(implementation_type& impl, const char* path,
+      file_base::flags open_flags, Handler& handler, const IoExecutor& io_ex)
+  {
+    bool is_continuation =
+      asio_handler_cont_helpers::is_continuation(handler);
+
+    // Allocate and construct an operation to wrap the handler.
+    typedef reactive_file_open_op<
+      reactive_file_service, Handler, IoExecutor> op;
+    typename op::ptr p = { ASIO_LIBNS::detail::addressof(handler),
+      op::ptr::allocate(handler), 0 };
+    p.p = new (p.v) op(success_ec_, scheduler_, impl.cancel_token_,
+        *this, path, open_flags, handler, io_ex);
+
+    ASIO_HANDLER_CREATION((scheduler_.context(), *p.p, "file",
+          &impl, native_handle(impl), "async_open"));
+
+    if (begin_open(impl, p.p))
+      start_op(p.p, is_continuation);
+    else
+      scheduler_.post_immediate_completion(p.p, is_continuation);
+    p.v = p.p = 0;
+  }
+
+  // Start an asynchronous close. The descriptor is detached from the file
+  // immediately, cancelling its outstanding operations, and closed by the
+  // pool.
+  template <typename Handler, typename IoExecutor>
+  void async_close(implementation_type& impl,
+      Handler& handler, const IoExecutor& io_ex)
+  {
+    bool is_continuation =
+      asio_handler_cont_helpers::is_continuation(handler);
+
+    reset_cancel_token(impl);
+    move_pending_open(impl, 0);
+    int descriptor = descriptor_service_.release(impl);
+
+    // Allocate and construct an operation to wrap the handler. The close is
+    // performed even if the file is cancelled, so it has its own token.
+    shared_ptr<void> token(static_cast<void*>(0), socket_ops::noop_deleter());
+    typedef reactive_file_control_op<Handler, IoExecutor> op;
+    typename op::ptr p = { ASIO_LIBNS::detail::addressof(handler),
+      op::ptr::allocate(handler), 0 };
+    p.p = new (p.v) op(success_ec_, scheduler_, token, descriptor,
+        op::close_op, 0, 0, handler, io_ex);
+    p.p->set_cancel_token(token);
+
+    ASIO_HANDLER_CREATION((scheduler_.context(), *p.p, "file",
+          &impl, descriptor, "async_close"));
+
+    start_op(p.p, is_continuation);
+    p.v = p.p = 0;
+  }
+
+  // Start an asynchronous operation to get the size of the file.
+  template <typename Handler, typename IoExecutor>
+  void async_size(implementation_type& impl,
+      Handler& handler, const IoExecutor& io_ex)
+  {
+    bool is_continuation =
+      asio_handler_cont_helpers::is_continuation(handler);
+
+    // Allocate and construct an operation to wrap the handler.
+    typedef reactive_file_size_op<Handler, IoExecutor> op;
+    typename op::ptr p = { ASIO_LIBNS::detail::addressof(handler),
+      op::ptr::allocate(handler), 0 };
+    p.p = new (p.v) op(success_ec_, scheduler_,
+        impl.cancel_token_, native_handle(impl), handler, io_ex);
+
+    ASIO_HANDLER_CREATION((scheduler_.context(), *p.p, "file",
+          &impl, native_handle(impl), "async_size"));
+
+    start_op(p.p, is_continuation);
+    p.v = p.p = 0;
+  }
+
+  // Start an asynchronous resize.
+  template <typename Handler, typename IoExecutor>
+  void async_resize(implementation_type& impl, uint64_t n,
+      Handler& handler, const IoExecutor& io_ex)
+  {
+    start_control_op(impl, reactive_file_control_op_base::resize_op,
+        0, n, handler, io_ex, "async_resize");
+  }
+
+  // Start an asynchronous allocation of disk space.
+  template <typename Handler, typename IoExecutor>
+  void async_allocate(implementation_type& impl, uint64_t offset,
+      uint64_t length, Handler& handler, const IoExecutor& io_ex)
+  {
+    start_control_op(impl, reactive_file_control_op_base::allocate_op,
+        offset, length, handler, io_ex, "async_allocate");
+  }
+
+  // Start an asynchronous synchronisation of the file to disk.
+  template <typename Handler, typename IoExecutor>
+  void async_sync_all(implementation_type& impl,
+      Handler& handler, const IoExecutor& io_ex)
+  {
+    start_control_op(impl, reactive_file_control_op_base::sync_all_op,
+        0, 0, handler, io_ex, "async_sync_all");
+  }
+
+  // Start an asynchronous synchronisation of the file data to disk.
+  template <typename Handler, typename IoExecutor>
+  void async_sync_data(implementation_type& impl,
+      Handler& handler, const IoExecutor& io_ex)
+  {
+    start_control_op(impl, reactive_file_control_op_base::sync_data_op,
+        0, 0, handler, io_ex, "async_sync_data");
+  }
+
+  // Attach the result of an asynchronous open to its file. Closes the
+  // descriptor if the file no longer wants it.
+  ASIO_DECL void complete_open(
+      reactive_file_open_op_base<reactive_file_service>* op, bool deliver);
+
+  // Write the given data. Returns the number of bytes written.
+  template <typename ConstBufferSequence>
+  size_t write_some(implementation_type& impl,
+      const ConstBufferSequence& buffers, ASIO_LIBNS::error_code& ec)
+  {
+    return descriptor_service_.write_some(impl, buffers, ec);
+  }
+
+  // Start an asynchronous write. The data being written must be valid for the
+  // lifetime of the asynchronous operation.
+  template <typename ConstBufferSequence, typename Handler, typename IoExecutor>
+  void async_write_some(implementation_type& impl,
+      const ConstBufferSequence& buffers,
+      Handler& handler, const IoExecutor& io_ex)
+  {
+    start_write_op(impl, false, 0, buffers,
+        handler, io_ex, "async_write_some");
+  }
+
+  // Write the given data at the specified location. Returns the number of
+  // bytes written.
+  template <typename ConstBufferSequence>
+  size_t write_some_at(implementation_type& impl, uint64_t offset,
+      const ConstBufferSequence& buffers, ASIO_LIBNS::error_code& ec)
+  {
+    typedef buffer_sequence_adapter<ASIO_LIBNS::const_buffer,
+        ConstBufferSequence> bufs_type;
+
+    if (bufs_type::is_single_buffer)
+    {
+      return descriptor_ops::sync_write_at1(native_handle(impl),
+          0, offset, bufs_type::first(buffers).data(),
+          bufs_type::first(buffers).size(), ec);
+    }
+    else
+    {
+      bufs_type bufs(buffers);
+
+      return descriptor_ops::sync_write_at(native_handle(impl), 0,
+          offset, bufs.buffers(), bufs.count(), bufs.all_empty(), ec);
+    }
+  }
+
+  // Start an asynchronous write at the specified location. The data being
+  // written must be valid for the lifetime of the asynchronous operation.
+  template <typename ConstBufferSequence, typename Handler, typename IoExecutor>
+  void async_write_some_at(implementation_type& impl,
+      uint64_t offset, const ConstBufferSequence& buffers,
+      Handler& handler, const IoExecutor& io_ex)
+  {
+    start_write_op(impl, true, offset, buffers,
+        handler, io_ex, "async_write_some_at");
+  }
+
+  // Read some data. Returns the number of bytes read.
+  template <typename MutableBufferSequence>
+  size_t read_some(implementation_type& impl,
+      const MutableBufferSequence& buffers, ASIO_LIBNS::error_code& ec)
+  {
+    return descriptor_service_.read_some(impl, buffers, ec);
+  }
+
+  // Start an asynchronous read. The buffer for the data being read must be
+  // valid for the lifetime of the asynchronous operation.
+  template <typename MutableBufferSequence,
+      typename Handler, typename IoExecutor>
+  void async_read_some(implementation_type& impl,
+      const MutableBufferSequence& buffers,
+      Handler& handler, const IoExecutor& io_ex)
+  {
+    start_read_op(impl, false, 0, buffers,
+        handler, io_ex, "async_read_some");
+  }
+
+  // Read some data. Returns the number of bytes read.
+  template <typename MutableBufferSequence>
+  size_t read_some_at(implementation_type& impl, uint64_t offset,
+      const MutableBufferSequence& buffers, ASIO_LIBNS::error_code& ec)
+  {
+    typedef buffer_sequence_adapter<ASIO_LIBNS::mutable_buffer,
+        MutableBufferSequence> bufs_type;
+
+    if (bufs_type::is_single_buffer)
+    {
+      return descriptor_ops::sync_read_at1(native_handle(impl),
+          0, offset, bufs_type::first(buffers).data(),
+          bufs_type::first(buffers).size(), ec);
+    }
+    else
+    {
+      bufs_type bufs(buffers);
+
+      return descriptor_ops::sync_read_at(native_handle(impl), 0,
+          offset, bufs.buffers(), bufs.count(), bufs.all_empty(), ec);
+    }
+  }
+
+  // Start an asynchronous read. The buffer for the data being read must be
+  // valid for the lifetime of the asynchronous operation.
+  template <typename MutableBufferSequence,
+      typename Handler, typename IoExecutor>
+  void async_read_some_at(implementation_type& impl,
+      uint64_t offset, const MutableBufferSequence& buffers,
+      Handler& handler, const IoExecutor& io_ex)
+  {
+    start_read_op(impl, true, offset, buffers,
+        handler, io_ex, "async_read_some_at");
+  }
+
+  // Start an asynchronous copy of data at the specified location to the same
+  // location in another file.
+  template <typename Handler, typename IoExecutor>
+  void async_copy_some_at(implementation_type& impl, uint64_t offset,
+      implementation_type& target, std::size_t length,
+      Handler& handler, const IoExecutor& io_ex)
+  {
+    bool is_continuation =
+      asio_handler_cont_helpers::is_continuation(handler);
+
+    // Allocate and construct an operation to wrap the handler.
+    typedef reactive_file_copy_op<Handler, IoExecutor> op;
+    typename op::ptr p = { ASIO_LIBNS::detail::addressof(handler),
+      op::ptr::allocate(handler), 0 };
+    p.p = new (p.v) op(success_ec_, scheduler_, impl.cancel_token_,
+        native_handle(impl), offset, native_handle(target),
+        length, handler, io_ex);
+
+    ASIO_HANDLER_CREATION((scheduler_.context(), *p.p, "file",
+          &impl, native_handle(impl), "async_copy_some_at"));
+
+    start_op(p.p, is_continuation);
+    p.v = p.p = 0;
+  }
+
+private:
+  // Helper function to start an asynchronous read.
+  template <typename MutableBufferSequence,
+      typename Handler, typename IoExecutor>
+  void start_read_op(implementation_type& impl, bool has_offset,
+      uint64_t offset, const MutableBufferSequence& buffers,
+      Handler& handler, const IoExecutor& io_ex, const char* name)
+  {
+    bool is_continuation =
+      asio_handler_cont_helpers::is_continuation(handler);
+
+    // Allocate and construct an operation to wrap the handler.
+    typedef reactive_file_read_op<
+      MutableBufferSequence, Handler, IoExecutor> op;
+    typename op::ptr p = { ASIO_LIBNS::detail::addressof(handler),
+      op::ptr::allocate(handler), 0 };
+    p.p = new (p.v) op(success_ec_, scheduler_, impl.cancel_token_,
+        native_handle(impl), has_offset, offset, buffers, handler, io_ex);
+
+    ASIO_HANDLER_CREATION((scheduler_.context(), *p.p, "file",
+          &impl, native_handle(impl), name));
+    (void)name;
+
+    start_op(p.p, is_continuation);
+    p.v = p.p = 0;
+  }
+
+  // Helper function to start an asynchronous write.
+  template <typename ConstBufferSequence, typename Handler, typename IoExecutor>
+  void start_write_op(implementation_type& impl, bool has_offset,
+      uint64_t offset, const ConstBufferSequence& buffers,
+      Handler& handler, const IoExecutor& io_ex, const char* name)
+  {
+    bool is_continuation =
+      asio_handler_cont_helpers::is_continuation(handler);
+
+    // Allocate and construct an operation to wrap the handler.
+    typedef reactive_file_write_op<
+      ConstBufferSequence, Handler, IoExecutor> op;
+    typename op::ptr p = { ASIO_LIBNS::detail::addressof(handler),
+      op::ptr::allocate(handler), 0 };
+    p.p = new (p.v) op(success_ec_, scheduler_, impl.cancel_token_,
+        native_handle(impl), has_offset, offset, buffers, handler, io_ex);
+
+    ASIO_HANDLER_CREATION((scheduler_.context(), *p.p, "file",
+          &impl, native_handle(impl), name));
+    (void)name;
+
+    start_op(p.p, is_continuation);
+    p.v = p.p = 0;
+  }
+
+  // Helper function to start an operation that does not transfer data.
+  template <typename Handler, typename IoExecutor>
+  void start_control_op(implementation_type& impl,
+      reactive_file_control_op_base::control_type control,
+      uint64_t offset, uint64_t length, Handler& handler,
+      const IoExecutor& io_ex, const char* name)
+  {
+    bool is_continuation =
+      asio_handler_cont_helpers::is_continuation(handler);
+
+    // Allocate and construct an operation to wrap the handler.
+    typedef reactive_file_control_op<Handler, IoExecutor> op;
+    typename op::ptr p = { ASIO_LIBNS::detail::addressof(handler),
+      op::ptr::allocate(handler), 0 };
+    p.p = new (p.v) op(success_ec_, scheduler_, impl.cancel_token_,
+        native_handle(impl), control, offset, length, handler, io_ex);
+
+    ASIO_HANDLER_CREATION((scheduler_.context(), *p.p, "file",
+          &impl, native_handle(impl), name));
+    (void)name;
+
+    start_op(p.p, is_continuation);
+    p.v = p.p = 0;
+  }
+
+  // Attach an asynchronous open to a file that is not open. Returns false if
+  // the file is already open or being opened.
+  ASIO_DECL bool begin_open(implementation_type& impl,
+      reactive_file_open_op_base<reactive_file_service>* op);
+
+  // Hand a pending asynchronous open to another implementation, or detach it
+  // so that its result is discarded.
+  ASIO_DECL void move_pending_open(implementation_type& impl,
+      implementation_type* new_impl);
+
+  // Complete the operation immediately if possible, otherwise hand it to the
+  // pool of threads.
+  ASIO_DECL void start_op(reactive_file_op* op, bool is_continuation);
+
+  // Replace the token that is observed by the file's pending operations.
+  ASIO_DECL void reset_cancel_token(implementation_type& impl);
+
+  // Helper class to run the work scheduler in a thread.
+  class work_scheduler_runner;
+  friend class work_scheduler_runner;
+
+  // The scheduler used to deliver completions.
+  scheduler& scheduler_;
+
+  // The implementation used for the synchronous operations.
+  descriptor_service descriptor_service_;
+
+  // Mutex to protect access to the pool of threads and to pending opens.
+  ASIO_LIBNS::detail::mutex mutex_;
+
+  // Private scheduler used for performing blocking file operations.
+  ASIO_LIBNS::detail::scoped_ptr<scheduler> work_scheduler_;
+
+  // The threads that are running the private scheduler.
+  ASIO_LIBNS::detail::thread_group work_threads_;
+
+  // The number of threads that have been started, and the maximum number.
+  std::size_t num_threads_;
+  std::size_t max_threads_;
+
+  // The number of operations handed to the threads that have not yet been
+  // performed. It is not protected by the mutex, as the mutex is held while
+  // the threads are joined.
+  atomic_count outstanding_ops_;
+
+  // The number of threads to restart after a fork.
+  std::size_t fork_threads_;
+
+  // Whether the threads are stopped while a fork is in progress.
+  bool forking_;
+
+  // Cached success value to avoid accessing category singleton.
+  const ASIO_LIBNS::error_code success_ec_;
+};
+
+} // namespace detail
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#if defined(ASIO_HEADER_ONLY)
+# include "asio/detail/impl/reactive_file_service.ipp"
+#endif // defined(ASIO_HEADER_ONLY)
+
+#endif // defined(ASIO_HAS_FILE)
+       //   && !defined(ASIO_HAS_IOCP)
+       //   && !defined(ASIO_HAS_IO_URING)
+
+#endif // ASIO_DETAIL_REACTIVE_FILE_SERVICE_HPP
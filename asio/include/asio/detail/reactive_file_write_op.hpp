@@ -0,0 +1,166 @@
+//
+// detail/reactive_file_write_op.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_DETAIL_REACTIVE_FILE_WRITE_OP_HPP
+#define ASIO_DETAIL_REACTIVE_FILE_WRITE_OP_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+
+#if defined(ASIO_HAS_FILE) \
+  && !defined(ASIO_HAS_IOCP) \
+  && !defined(ASIO_HAS_IO_URING)
+
+#include "asio/detail/bind_handler.hpp"
+#include "asio/detail/buffer_sequence_adapter.hpp"
+#include "asio/detail/descriptor_ops.hpp"
+#include "asio/detail/fenced_block.hpp"
+#include "asio/detail/handler_work.hpp"
+#include "asio/detail/memory.hpp"
+#include "asio/detail/reactive_file_op.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace ASIO_LIBNS {
+namespace detail {
+
+template <typename ConstBufferSequence>
+class reactive_file_write_op_base : public reactive_file_op
+{
+public:
+  reactive_file_write_op_base(const ASIO_LIBNS::error_code& success_ec,
+      scheduler& sched, const weak_ptr<void>& cancel_token, int descriptor,
+      bool has_offset, uint64_t offset, const ConstBufferSequence& buffers,
+      func_type complete_func)
+    : reactive_file_op(success_ec, &reactive_file_write_op_base::do_perform,
+        complete_func, sched, cancel_token, descriptor, has_offset, offset),
+      buffers_(buffers)
+  {
+  }
+
+  static bool do_perform(reactive_file_op* base, bool may_block)
+  {
+    reactive_file_write_op_base* o(
+        static_cast<reactive_file_write_op_base*>(base));
+
+    typedef buffer_sequence_adapter<ASIO_LIBNS::const_buffer,
+        ConstBufferSequence> bufs_type;
+
+    bufs_type bufs(o->buffers_);
+
+    if (may_block)
+    {
+      if (o->has_offset_)
+      {
+        o->bytes_transferred_ = descriptor_ops::sync_write_at(o->descriptor_,
+            0, o->offset_, bufs.buffers(), bufs.count(), bufs.all_empty(),
+            o->ec_);
+      }
+      else
+      {
+        o->bytes_transferred_ = descriptor_ops::sync_write(o->descriptor_,
+            0, bufs.buffers(), bufs.count(), bufs.all_empty(), o->ec_);
+      }
+
+      ASIO_HANDLER_REACTOR_OPERATION((*o, "sync_write",
+            o->ec_, o->bytes_transferred_));
+
+      return true;
+    }
+
+    // A request to write 0 bytes is a no-op. All other writes are performed
+    // by the pool, as a write may block even when its pages are cached.
+    return bufs.all_empty();
+  }
+
+private:
+  ConstBufferSequence buffers_;
+};
+
+template <typename ConstBufferSequence, typename Handler, typename IoExecutor>
+class reactive_file_write_op
+  : public reactive_file_write_op_base<ConstBufferSequence>
+{
+public:
+  ASIO_DEFINE_HANDLER_PTR(reactive_file_write_op);
+
+  reactive_file_write_op(const ASIO_LIBNS::error_code& success_ec,
+      scheduler& sched, const weak_ptr<void>& cancel_token, int descriptor,
+      bool has_offset, uint64_t offset, const ConstBufferSequence& buffers,
+      Handler& handler, const IoExecutor& io_ex)
+    : reactive_file_write_op_base<ConstBufferSequence>(success_ec, sched,
+        cancel_token, descriptor, has_offset, offset, buffers,
+        &reactive_file_write_op::do_complete),
+      handler_(ASIO_MOVE_CAST(Handler)(handler)),
+      work_(handler_, io_ex)
+  {
+  }
+
+  static void do_complete(void* owner, operation* base,
+      const ASIO_LIBNS::error_code& /*ec*/,
+      std::size_t /*bytes_transferred*/)
+  {
+    reactive_file_write_op* o(static_cast<reactive_file_write_op*>(base));
+
+    // When run on a worker thread, the operation is performed there.
+    if (o->perform_on_worker(owner))
+      return;
+
+    // Take ownership of the handler object.
+    ptr p = { ASIO_LIBNS::detail::addressof(o->handler_), o, o };
+
+    ASIO_HANDLER_COMPLETION((*o));
+
+    // Take ownership of the operation's outstanding work.
+    handler_work<Handler, IoExecutor> w(
+        ASIO_MOVE_CAST2(handler_work<Handler, IoExecutor>)(
+          o->work_));
+
+    ASIO_ERROR_LOCATION(o->ec_);
+
+    // Make a copy of the handler so that the memory can be deallocated before
+    // the upcall is made. Even if we're not about to make an upcall, a
+    // sub-object of the handler may be the true owner of the memory associated
+    // with the handler. Consequently, a local copy of the handler is required
+    // to ensure that any owning sub-object remains valid until after we have
+    // deallocated the memory here.
+    detail::binder2<Handler, ASIO_LIBNS::error_code, std::size_t>
+      handler(o->handler_, o->ec_, o->bytes_transferred_);
+    p.h = ASIO_LIBNS::detail::addressof(handler.handler_);
+    p.reset();
+
+    // Make the upcall if required.
+    if (owner)
+    {
+      fenced_block b(fenced_block::half);
+      ASIO_HANDLER_INVOCATION_BEGIN((handler.arg1_, handler.arg2_));
+      w.complete(handler, handler.handler_);
+      ASIO_HANDLER_INVOCATION_END;
+    }
+  }
+
+private:
+  Handler handler_;
+  handler_work<Handler, IoExecutor> work_;
+};
+
+} // namespace detail
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // defined(ASIO_HAS_FILE)
+       //   && !defined(ASIO_HAS_IOCP)
+       //   && !defined(ASIO_HAS_IO_URING)
+
+#endif // ASIO_DETAIL_REACTIVE_FILE_WRITE_OP_HPP
@@ -75,7 +75,7 @@ public:
 
     if (owner && owner != &o->scheduler_)
     {
-      // The operation is being run on the worker io_context. Time to perform
+      // The operation is being run on a worker thread. Time to perform
       // the resolver operation.
     
       // Perform the blocking endpoint resolution operation.
@@ -0,0 +1,395 @@
+//
+// detail/resolver_cache.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_DETAIL_RESOLVER_CACHE_HPP
+#define ASIO_DETAIL_RESOLVER_CACHE_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+#include <cstddef>
+#include <ctime>
+#include <limits>
+#include <map>
+#include <string>
+#include "asio/error.hpp"
+#include "asio/ip/basic_resolver_query.hpp"
+#include "asio/ip/basic_resolver_results.hpp"
+#include "asio/detail/memory.hpp"
+#include "asio/detail/mutex.hpp"
+#include "asio/detail/noncopyable.hpp"
+#include "asio/detail/op_queue.hpp"
+#include "asio/detail/resolve_op.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace ASIO_LIBNS {
+namespace detail {
+
+template <typename Protocol>
+class resolver_cache;
+
+// An operation waiting for the results of a query held by the cache.
+template <typename Protocol>
+class resolver_cache_op : public resolve_op
+{
+public:
+  // The results to be passed to the completion handler.
+  ASIO_LIBNS::ip::basic_resolver_results<Protocol> results_;
+
+protected:
+  resolver_cache_op(func_type complete_func, const weak_ptr<void>& owner)
+    : resolve_op(complete_func),
+      owner_(owner),
+      key_(0)
+  {
+  }
+
+private:
+  friend class resolver_cache<Protocol>;
+
+  // Identifies the resolver implementation that started the operation.
+  weak_ptr<void> owner_;
+
+  // The key of the entry for which the operation is waiting.
+  const std::string* key_;
+};
+
+// Caches the results of forward resolution for a limited time, and coalesces
+// concurrent lookups of the same query. Cached results share their entries,
+// and so are handed out without being copied.
+template <typename Protocol>
+class resolver_cache
+  : private noncopyable
+{
+public:
+  typedef ASIO_LIBNS::ip::basic_resolver_query<Protocol> query_type;
+  typedef ASIO_LIBNS::ip::basic_resolver_results<Protocol> results_type;
+  typedef resolver_cache_op<Protocol> op;
+
+  // The outcome of starting an operation.
+  enum start_result
+  {
+    // The operation has been given cached results and may be completed.
+    cached,
+
+    // The operation is waiting for a lookup that is already in progress.
+    waiting,
+
+    // The operation is waiting for a lookup that the caller must start, and
+    // whose result must be passed to complete().
+    lookup_required
+  };
+
+  // Constructor. The cache is initially disabled.
+  resolver_cache()
+    : max_entries_(0),
+      max_lifetime_(0),
+      negative_lifetime_(0)
+  {
+  }
+
+  // Set the maximum number of entries, and the maximum number of seconds for
+  // which results and host_not_found errors are kept. A maximum of zero
+  // entries disables the cache. Results cached under previous options are
+  // discarded.
+  void set_options(std::size_t max_entries,
+      long max_lifetime, long negative_lifetime)
+  {
+    ASIO_LIBNS::detail::mutex::scoped_lock lock(mutex_);
+    max_entries_ = max_entries;
+    max_lifetime_ = max_lifetime;
+    negative_lifetime_ = negative_lifetime;
+
+    // Entries with lookups in progress are kept for their waiting operations.
+    for (typename entry_map::iterator i = entries_.begin();
+        i != entries_.end(); )
+    {
+      if (i->second.pending)
+        ++i;
+      else
+        entries_.erase(i++);
+    }
+  }
+
+  // Whether the cache is enabled.
+  bool enabled()
+  {
+    ASIO_LIBNS::detail::mutex::scoped_lock lock(mutex_);
+    return max_entries_ != 0;
+  }
+
+  // Get the cached outcome of a query. Returns false if there is none.
+  bool find(const query_type& qry, results_type& results,
+      ASIO_LIBNS::error_code& ec)
+  {
+    ASIO_LIBNS::detail::mutex::scoped_lock lock(mutex_);
+    typename entry_map::iterator i = entries_.find(make_key(qry));
+    if (i == entries_.end() || !is_fresh(i->second, std::time(0)))
+      return false;
+    results = i->second.results;
+    ec = i->second.ec;
+    return true;
+  }
+
+  // Record the outcome of a lookup performed without calling start(). The ttl
+  // is the number of seconds for which the outcome remains valid.
+  void store(const query_type& qry, const results_type& results,
+      const ASIO_LIBNS::error_code& ec,
+      unsigned long ttl = (std::numeric_limits<unsigned long>::max)())
+  {
+    ASIO_LIBNS::detail::mutex::scoped_lock lock(mutex_);
+    if (max_entries_ == 0)
+      return;
+
+    std::string key = make_key(qry);
+    typename entry_map::iterator i = entries_.find(key);
+    if (i == entries_.end())
+      i = entries_.insert(std::make_pair(key, entry())).first;
+    else if (i->second.pending)
+      return;
+    update(i, results, ec, ttl);
+  }
+
+  // Start an asynchronous operation. Unless the cached results are returned
+  // immediately, the cache takes ownership of the operation until it is
+  // returned by complete() or cancel().
+  start_result start(const query_type& qry, op* o)
+  {
+    ASIO_LIBNS::detail::mutex::scoped_lock lock(mutex_);
+    std::string key = make_key(qry);
+    typename entry_map::iterator i = entries_.find(key);
+    start_result result = lookup_required;
+    if (i == entries_.end())
+    {
+      i = entries_.insert(std::make_pair(key, entry())).first;
+    }
+    else if (i->second.pending)
+    {
+      result = waiting;
+    }
+    else if (is_fresh(i->second, std::time(0)))
+    {
+      o->results_ = i->second.results;
+      o->ec_ = i->second.ec;
+      return cached;
+    }
+
+    i->second.pending = true;
+    o->key_ = &i->first;
+    waiters_.push(o);
+    return result;
+  }
+
+  // Record the outcome of a lookup required by start(), and collect the
+  // operations waiting for it.
+  void complete(const query_type& qry, const results_type& results,
+      const ASIO_LIBNS::error_code& ec, unsigned long ttl,
+      op_queue<operation>& ops)
+  {
+    ASIO_LIBNS::detail::mutex::scoped_lock lock(mutex_);
+    typename entry_map::iterator i = entries_.find(make_key(qry));
+    if (i == entries_.end())
+      return;
+
+    op_queue<op> other_waiters;
+    while (op* o = waiters_.front())
+    {
+      waiters_.pop();
+      if (o->key_ == &i->first)
+      {
+        o->results_ = results;
+        o->ec_ = ec;
+        ops.push(o);
+      }
+      else
+        other_waiters.push(o);
+    }
+    waiters_.push(other_waiters);
+
+    i->second.pending = false;
+    update(i, results, ec, ttl);
+  }
+
+  // Collect the waiting operations started by the given resolver
+  // implementation, which complete with operation_aborted. The lookups they
+  // are waiting for continue on behalf of other operations and the cache.
+  template <typename Owner>
+  void cancel(const shared_ptr<Owner>& owner, op_queue<operation>& ops)
+  {
+    ASIO_LIBNS::detail::mutex::scoped_lock lock(mutex_);
+    op_queue<op> other_waiters;
+    while (op* o = waiters_.front())
+    {
+      waiters_.pop();
+      if (!o->owner_.owner_before(owner) && !owner.owner_before(o->owner_))
+      {
+        o->ec_ = ASIO_LIBNS::error::operation_aborted;
+        ops.push(o);
+      }
+      else
+        other_waiters.push(o);
+    }
+    waiters_.push(other_waiters);
+  }
+
+  // Collect a single waiting operation, which completes with
+  // operation_aborted. Does nothing if the operation is not waiting.
+  void cancel_op(op* target, op_queue<operation>& ops)
+  {
+    ASIO_LIBNS::detail::mutex::scoped_lock lock(mutex_);
+    op_queue<op> other_waiters;
+    while (op* o = waiters_.front())
+    {
+      waiters_.pop();
+      if (o == target)
+      {
+        o->ec_ = ASIO_LIBNS::error::operation_aborted;
+        ops.push(o);
+      }
+      else
+        other_waiters.push(o);
+    }
+    waiters_.push(other_waiters);
+  }
+
+  // Collect all waiting operations so that they may be destroyed, and discard
+  // all entries.
+  void shutdown(op_queue<operation>& ops)
+  {
+    ASIO_LIBNS::detail::mutex::scoped_lock lock(mutex_);
+    ops.push(waiters_);
+    entries_.clear();
+  }
+
+private:
+  // The cached outcome of a query.
+  struct entry
+  {
+    entry()
+      : stored(0),
+        lifetime(0),
+        pending(false)
+    {
+    }
+
+    results_type results;
+    ASIO_LIBNS::error_code ec;
+    std::time_t stored;
+    long lifetime;
+    bool pending;
+  };
+
+  typedef std::map<std::string, entry> entry_map;
+
+  // Build the key under which a query's outcome is cached.
+  static std::string make_key(const query_type& qry)
+  {
+    const addrinfo_type& hints = qry.hints();
+    int values[4] = { hints.ai_flags, hints.ai_family,
+      hints.ai_socktype, hints.ai_protocol };
+
+    std::string key(reinterpret_cast<const char*>(values), sizeof(values));
+    key += qry.host_name();
+    key += '\0';
+    key += qry.service_name();
+    return key;
+  }
+
+  // Whether an entry holds an outcome that may still be used. An entry stored
+  // in the future is treated as expired, in case the clock has been changed.
+  static bool is_fresh(const entry& e, std::time_t now)
+  {
+    return !e.pending && e.stored <= now && now - e.stored < e.lifetime;
+  }
+
+  // Store an outcome in an entry, or erase the entry if the outcome may not be
+  // cached. Only successful results and host_not_found errors are cached.
+  void update(typename entry_map::iterator i, const results_type& results,
+      const ASIO_LIBNS::error_code& ec, unsigned long ttl)
+  {
+    long lifetime = 0;
+    if (!ec)
+      lifetime = max_lifetime_;
+    else if (ec == ASIO_LIBNS::error::host_not_found)
+      lifetime = negative_lifetime_;
+    if (static_cast<unsigned long>(lifetime) > ttl)
+      lifetime = static_cast<long>(ttl);
+
+    if (max_entries_ == 0 || lifetime <= 0)
+    {
+      entries_.erase(i);
+      return;
+    }
+
+    i->second.results = results;
+    i->second.ec = ec;
+    i->second.stored = std::time(0);
+    i->second.lifetime = lifetime;
+    evict(i);
+  }
+
+  // Remove expired entries, and then the entries closest to expiry, until the
+  // number of entries is within the limit. The given entry is kept.
+  void evict(typename entry_map::iterator keep)
+  {
+    if (entries_.size() <= max_entries_)
+      return;
+
+    std::time_t now = std::time(0);
+    for (typename entry_map::iterator i = entries_.begin();
+        i != entries_.end(); )
+    {
+      if (i != keep && !i->second.pending && !is_fresh(i->second, now))
+        entries_.erase(i++);
+      else
+        ++i;
+    }
+
+    while (entries_.size() > max_entries_)
+    {
+      typename entry_map::iterator oldest = entries_.end();
+      for (typename entry_map::iterator i = entries_.begin();
+          i != entries_.end(); ++i)
+      {
+        if (i != keep && !i->second.pending && (oldest == entries_.end()
+              || i->second.stored + i->second.lifetime
+                < oldest->second.stored + oldest->second.lifetime))
+          oldest = i;
+      }
+      if (oldest == entries_.end())
+        break;
+      entries_.erase(oldest);
+    }
+  }
+
+  // Mutex to protect access to internal data.
+  ASIO_LIBNS::detail::mutex mutex_;
+
+  // The options.
+  std::size_t max_entries_;
+  long max_lifetime_;
+  long negative_lifetime_;
+
+  // The cached outcomes, and the entries of lookups in progress.
+  entry_map entries_;
+
+  // The operations waiting for lookups in progress.
+  op_queue<op> waiters_;
+};
+
+} // namespace detail
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // ASIO_DETAIL_RESOLVER_CACHE_HPP
@@ -19,12 +19,17 @@
 
 #if !defined(ASIO_WINDOWS_RUNTIME)
 
+#include "asio/associated_cancellation_slot.hpp"
+#include "asio/cancellation_type.hpp"
 #include "asio/ip/basic_resolver_query.hpp"
 #include "asio/ip/basic_resolver_results.hpp"
 #include "asio/detail/concurrency_hint.hpp"
 #include "asio/detail/memory.hpp"
+#include "asio/detail/op_queue.hpp"
+#include "asio/detail/resolve_cached_op.hpp"
 #include "asio/detail/resolve_endpoint_op.hpp"
 #include "asio/detail/resolve_query_op.hpp"
+#include "asio/detail/resolver_cache.hpp"
 #include "asio/detail/resolver_service_base.hpp"
 
 #include "asio/detail/push_options.hpp"
@@ -62,6 +67,9 @@ public:
   void shutdown()
   {
     this->base_shutdown();
+
+    op_queue<operation> ops;
+    cache_.shutdown(ops);
   }
 
   // Perform any fork-related housekeeping.
@@ -70,19 +78,62 @@ public:
     this->base_notify_fork(fork_ev);
   }
 
+  // Destroy a resolver implementation.
+  void destroy(implementation_type& impl)
+  {
+    cancel_cached(impl);
+    resolver_service_base::destroy(impl);
+  }
+
+  // Move-assign from another resolver implementation.
+  void move_assign(implementation_type& impl,
+      resolver_service_base& other_service,
+      implementation_type& other_impl)
+  {
+    cancel_cached(impl);
+    resolver_service_base::move_assign(impl, other_service, other_impl);
+  }
+
+  // Cancel pending asynchronous operations.
+  void cancel(implementation_type& impl)
+  {
+    cancel_cached(impl);
+    resolver_service_base::cancel(impl);
+  }
+
+  // Set the options of the cache of forward resolution results.
+  void set_cache_options(std::size_t max_entries,
+      long max_lifetime, long negative_lifetime)
+  {
+    cache_.set_options(max_entries, max_lifetime, negative_lifetime);
+  }
+
   // Resolve a query to a list of entries.
   results_type resolve(implementation_type&, const query_type& qry,
       ASIO_LIBNS::error_code& ec)
   {
+    results_type results;
+    if (cache_.find(qry, results, ec))
+    {
+      ASIO_ERROR_LOCATION(ec);
+      return results;
+    }
+
     ASIO_LIBNS::detail::addrinfo_type* address_info = 0;
 
     socket_ops::getaddrinfo(qry.host_name().c_str(),
         qry.service_name().c_str(), qry.hints(), &address_info, ec);
     auto_addrinfo auto_address_info(address_info);
 
+    if (!ec)
+    {
+      results = results_type::create(
+          address_info, qry.host_name(), qry.service_name());
+    }
+    cache_.store(qry, results, ec);
+
     ASIO_ERROR_LOCATION(ec);
-    return ec ? results_type() : results_type::create(
-        address_info, qry.host_name(), qry.service_name());
+    return results;
   }
 
   // Asynchronously resolve a query to a list of entries.
@@ -90,6 +141,15 @@ public:
   void async_resolve(implementation_type& impl, const query_type& qry,
       Handler& handler, const IoExecutor& io_ex)
   {
+    if (cache_.enabled())
+    {
+      async_resolve_cached(impl, qry, handler, io_ex);
+      return;
+    }
+
+    typename associated_cancellation_slot<Handler>::type slot
+      = ASIO_LIBNS::get_associated_cancellation_slot(handler);
+
     // Allocate and construct an operation to wrap the handler.
     typedef resolve_query_op<Protocol, Handler, IoExecutor> op;
     typename op::ptr p = { ASIO_LIBNS::detail::addressof(handler),
@@ -99,7 +159,11 @@ public:
     ASIO_HANDLER_CREATION((scheduler_.context(),
           *p.p, "resolver", &impl, 0, "async_resolve"));
 
-    start_resolve_op(p.p);
+    // Optionally register for per-operation cancellation.
+    if (slot.is_connected())
+      slot.template emplace<queued_op_cancellation>(this, p.p);
+
+    start_resolve_op(impl, p.p);
     p.v = p.p = 0;
   }
 
@@ -123,6 +187,9 @@ public:
   void async_resolve(implementation_type& impl, const endpoint_type& endpoint,
       Handler& handler, const IoExecutor& io_ex)
   {
+    typename associated_cancellation_slot<Handler>::type slot
+      = ASIO_LIBNS::get_associated_cancellation_slot(handler);
+
     // Allocate and construct an operation to wrap the handler.
     typedef resolve_endpoint_op<Protocol, Handler, IoExecutor> op;
     typename op::ptr p = { ASIO_LIBNS::detail::addressof(handler),
@@ -132,9 +199,175 @@ public:
     ASIO_HANDLER_CREATION((scheduler_.context(),
           *p.p, "resolver", &impl, 0, "async_resolve"));
 
-    start_resolve_op(p.p);
+    // Optionally register for per-operation cancellation.
+    if (slot.is_connected())
+      slot.template emplace<queued_op_cancellation>(this, p.p);
+
+    start_resolve_op(impl, p.p);
+    p.v = p.p = 0;
+  }
+
+private:
+  typedef resolver_cache<Protocol> cache_type;
+
+  // Asynchronously resolve a query using the cache.
+  template <typename Handler, typename IoExecutor>
+  void async_resolve_cached(implementation_type& impl,
+      const query_type& qry, Handler& handler, const IoExecutor& io_ex)
+  {
+    typename associated_cancellation_slot<Handler>::type slot
+      = ASIO_LIBNS::get_associated_cancellation_slot(handler);
+
+    // Allocate and construct an operation to wrap the handler.
+    typedef resolve_cached_op<Protocol, Handler, IoExecutor> op;
+    typename op::ptr p = { ASIO_LIBNS::detail::addressof(handler),
+      op::ptr::allocate(handler), 0 };
+    p.p = new (p.v) op(impl, handler, io_ex);
+
+    ASIO_HANDLER_CREATION((scheduler_.context(),
+          *p.p, "resolver", &impl, 0, "async_resolve"));
+
+    // Optionally register for per-operation cancellation.
+    if (slot.is_connected())
+      slot.template emplace<cache_cancellation>(this, p.p);
+
+    typename cache_type::start_result result = cache_.start(qry, p.p);
+    if (result == cache_type::cached)
+    {
+      scheduler_.post_immediate_completion(p.p, false);
+      p.v = p.p = 0;
+      return;
+    }
+
+    // The operation is now owned by the cache.
     p.v = p.p = 0;
+    scheduler_.work_started();
+    if (result == cache_type::lookup_required)
+      start_work_op(new cache_lookup_op(qry, cache_, scheduler_));
   }
+
+  // Complete with operation_aborted any operations started by the resolver
+  // that are waiting for a lookup in the cache.
+  void cancel_cached(implementation_type& impl)
+  {
+    op_queue<operation> ops;
+    cache_.cancel(impl, ops);
+    scheduler_.post_deferred_completions(ops);
+  }
+
+  // Cancellation handler that removes an operation from the queue of lookups
+  // waiting for a worker thread. A lookup that has already started runs to
+  // completion.
+  class queued_op_cancellation
+  {
+  public:
+    queued_op_cancellation(resolver_service* service, resolve_op* op)
+      : service_(service),
+        op_(op)
+    {
+    }
+
+    void operator()(cancellation_type_t type)
+    {
+      if (!!(type &
+            (cancellation_type::terminal
+              | cancellation_type::partial
+              | cancellation_type::total)))
+      {
+        service_->cancel_queued_op(op_);
+      }
+    }
+
+  private:
+    resolver_service* service_;
+    resolve_op* op_;
+  };
+
+  // Cancellation handler that completes an operation that is waiting for a
+  // lookup in the cache. The lookup itself continues, and its result is still
+  // stored for later operations.
+  class cache_cancellation
+  {
+  public:
+    cache_cancellation(resolver_service* service,
+        resolver_cache_op<Protocol>* op)
+      : service_(service),
+        op_(op)
+    {
+    }
+
+    void operator()(cancellation_type_t type)
+    {
+      if (!!(type &
+            (cancellation_type::terminal
+              | cancellation_type::partial
+              | cancellation_type::total)))
+      {
+        op_queue<operation> ops;
+        service_->cache_.cancel_op(op_, ops);
+        service_->scheduler_.post_deferred_completions(ops);
+      }
+    }
+
+  private:
+    resolver_service* service_;
+    resolver_cache_op<Protocol>* op_;
+  };
+
+  // Operation used to perform a lookup on behalf of the cache.
+  class cache_lookup_op : public resolve_op
+  {
+  public:
+    cache_lookup_op(const query_type& qry,
+        cache_type& cache, scheduler_impl& sched)
+      : resolve_op(&cache_lookup_op::do_complete),
+        query_(qry),
+        cache_(cache),
+        scheduler_(sched)
+    {
+    }
+
+    static void do_complete(void* owner, operation* base,
+        const ASIO_LIBNS::error_code& /*ec*/,
+        std::size_t /*bytes_transferred*/)
+    {
+      cache_lookup_op* o(static_cast<cache_lookup_op*>(base));
+      if (owner)
+      {
+        results_type results;
+        if (owner != &o->scheduler_)
+        {
+          // The operation is being run on a worker thread. Perform the
+          // blocking host resolution operation.
+          ASIO_LIBNS::detail::addrinfo_type* address_info = 0;
+          socket_ops::getaddrinfo(o->query_.host_name().c_str(),
+              o->query_.service_name().c_str(), o->query_.hints(),
+              &address_info, o->ec_);
+          auto_addrinfo auto_address_info(address_info);
+          if (!o->ec_)
+          {
+            results = results_type::create(address_info,
+                o->query_.host_name(), o->query_.service_name());
+          }
+        }
+
+        // Pass the waiting operations to the main io_context for completion.
+        op_queue<operation> ops;
+        o->cache_.complete(o->query_, results, o->ec_,
+            (std::numeric_limits<unsigned long>::max)(), ops);
+        o->scheduler_.post_deferred_completions(ops);
+      }
+      delete o;
+    }
+
+  private:
+    query_type query_;
+    cache_type& cache_;
+    scheduler_impl& scheduler_;
+  };
+
+  // The cache of forward resolution results.
+  cache_type cache_;
 };
 
 } // namespace detail
@@ -16,15 +16,19 @@
 #endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
 
 #include "asio/detail/config.hpp"
+#include <cstddef>
+#include <deque>
 #include "asio/error.hpp"
 #include "asio/execution_context.hpp"
+#include "asio/detail/chrono.hpp"
+#include "asio/detail/cstdint.hpp"
+#include "asio/detail/event.hpp"
 #include "asio/detail/mutex.hpp"
 #include "asio/detail/noncopyable.hpp"
 #include "asio/detail/resolve_op.hpp"
 #include "asio/detail/socket_ops.hpp"
 #include "asio/detail/socket_types.hpp"
-#include "asio/detail/scoped_ptr.hpp"
-#include "asio/detail/thread.hpp"
+#include "asio/detail/thread_group.hpp"
 
 #if defined(ASIO_HAS_IOCP)
 # include "asio/detail/win_iocp_io_context.hpp"
@@ -44,6 +48,39 @@ public:
   // indicate to the background thread that the operation has been cancelled.
   typedef socket_ops::shared_cancel_token_type implementation_type;
 
+  // Counters that describe how the worker threads have performed lookups.
+  struct statistics
+  {
+    // The number of worker threads, and the number performing a lookup.
+    std::size_t threads;
+    std::size_t busy_threads;
+
+    // The number of lookups waiting for a worker thread, and the largest
+    // number that have waited at once.
+    std::size_t queued;
+    std::size_t peak_queued;
+
+    // The number of lookups started by the worker threads.
+    std::size_t lookups;
+
+    // The number of lookups rejected because the queue was full.
+    std::size_t rejected;
+
+    // The number of queued lookups removed by cancellation before they were
+    // started.
+    std::size_t cancelled;
+
+    // The total and longest times, in microseconds, that lookups waited in
+    // the queue before being started by a worker thread.
+    uint64_t total_queue_time;
+    uint64_t max_queue_time;
+
+    // The total and longest times, in microseconds, that worker threads
+    // spent performing lookups.
+    uint64_t total_lookup_time;
+    uint64_t max_lookup_time;
+  };
+
   // Constructor.
   ASIO_DECL resolver_service_base(execution_context& context);
 
@@ -90,9 +127,27 @@ public:
   // Cancel pending asynchronous operations.
   ASIO_DECL void cancel(implementation_type& impl);
 
+  // Set the maximum number of worker threads, and the maximum number of
+  // lookups that may wait for a worker thread.
+  ASIO_DECL void set_thread_pool(std::size_t max_threads,
+      std::size_t max_queued);
+
+  // Get the counters that describe the worker threads.
+  ASIO_DECL statistics get_statistics() const;
+
 protected:
   // Helper function to start an asynchronous resolve operation.
-  ASIO_DECL void start_resolve_op(resolve_op* op);
+  ASIO_DECL void start_resolve_op(implementation_type& impl, resolve_op* op);
+
+  // Helper function to start an operation on a worker thread that does not
+  // count as outstanding work on the main scheduler. If a worker thread
+  // cannot be used, the operation is instead posted to the main scheduler
+  // with the error set.
+  ASIO_DECL void start_work_op(resolve_op* op);
+
+  // Remove an operation from the queue before it is started, and complete it
+  // with operation_aborted. Does nothing if the operation is not queued.
+  ASIO_DECL void cancel_queued_op(resolve_op* op);
 
 #if !defined(ASIO_WINDOWS_RUNTIME)
   // Helper class to perform exception-safe cleanup of addrinfo objects.
@@ -121,12 +176,6 @@ protected:
   };
 #endif // !defined(ASIO_WINDOWS_RUNTIME)
 
-  // Helper class to run the work scheduler in a thread.
-  class work_scheduler_runner;
-
-  // Start the work scheduler if it's not already running.
-  ASIO_DECL void start_work_thread();
-
   // The scheduler implementation used to post completions.
 #if defined(ASIO_HAS_IOCP)
   typedef class win_iocp_io_context scheduler_impl;
@@ -136,14 +185,64 @@ protected:
   scheduler_impl& scheduler_;
 
 private:
+  // Helper class to run the worker threads.
+  class thread_function;
+  friend class thread_function;
+
+  // Queue an operation for a worker thread, starting a new thread if no
+  // thread is idle. Returns false if the queue is full.
+  ASIO_DECL bool enqueue(resolve_op* op,
+      const socket_ops::weak_cancel_token_type& owner);
+
+  // Perform queued lookups until the worker threads are stopped.
+  ASIO_DECL void run_worker();
+
+  // Remove the queued operations started by a resolver implementation, and
+  // complete them with operation_aborted.
+  ASIO_DECL void cancel_queued(implementation_type& impl);
+
+  // Stop and join the worker threads.
+  ASIO_DECL void stop_threads();
+
+#if defined(ASIO_HAS_CHRONO)
+  typedef chrono::steady_clock clock_type;
+#endif // defined(ASIO_HAS_CHRONO)
+
+  // A lookup waiting for a worker thread.
+  struct queued_lookup
+  {
+    resolve_op* op;
+    socket_ops::weak_cancel_token_type owner;
+#if defined(ASIO_HAS_CHRONO)
+    clock_type::time_point queued;
+#endif // defined(ASIO_HAS_CHRONO)
+  };
+
   // Mutex to protect access to internal data.
-  ASIO_LIBNS::detail::mutex mutex_;
+  mutable ASIO_LIBNS::detail::mutex mutex_;
+
+  // Event used to wake idle worker threads.
+  ASIO_LIBNS::detail::event wakeup_event_;
+
+  // The lookups waiting for a worker thread.
+  std::deque<queued_lookup> queue_;
+
+  // The worker threads.
+  ASIO_LIBNS::detail::thread_group threads_;
+
+  // The limits on the number of threads and queued lookups.
+  std::size_t max_threads_;
+  std::size_t max_queued_;
+
+  // The number of threads started, and the number waiting for work.
+  std::size_t num_threads_;
+  std::size_t idle_threads_;
 
-  // Private scheduler used for performing asynchronous host resolution.
-  ASIO_LIBNS::detail::scoped_ptr<scheduler_impl> work_scheduler_;
+  // Whether the worker threads have been told to exit.
+  bool stopped_;
 
-  // Thread used for running the work io_context's run loop.
-  ASIO_LIBNS::detail::scoped_ptr<ASIO_LIBNS::detail::thread> work_thread_;
+  // The counters.
+  statistics statistics_;
 };
 
 } // namespace detail
@@ -23,10 +23,15 @@
 #include "asio/detail/op_queue.hpp"
 #include "asio/detail/scheduler_operation.hpp"
 #include "asio/detail/scoped_ptr.hpp"
+#include "asio/detail/thread_info_base.hpp"
 #include "asio/detail/type_traits.hpp"
 #include "asio/execution.hpp"
 #include "asio/execution_context.hpp"
 
+#if defined(ASIO_HAS_STD_ATOMIC)
+# include <atomic>
+#endif // defined(ASIO_HAS_STD_ATOMIC)
+
 #include "asio/detail/push_options.hpp"
 
 namespace ASIO_LIBNS {
@@ -41,11 +46,21 @@ public:
   class strand_impl
   {
   public:
+    ASIO_DECL strand_impl();
     ASIO_DECL ~strand_impl();
 
   private:
     friend class strand_executor_service;
 
+#if defined(ASIO_HAS_LOCK_FREE_STRAND)
+    // The strand's state word. The values unlocked_state, locked_state and
+    // shutdown_state have the obvious meanings. Any other value means that the
+    // strand is locked, and is a pointer to the most recently added handler
+    // in a stack of handlers that are waiting on the strand. Handlers are
+    // pushed onto this stack by any thread, using compare-and-swap, and the
+    // whole stack is claimed by the thread holding the strand's lock.
+    std::atomic<std::size_t> state_;
+#else // defined(ASIO_HAS_LOCK_FREE_STRAND)
     // Mutex to protect access to internal data.
     mutex* mutex_;
 
@@ -62,12 +77,37 @@ public:
     // after the next time the strand is scheduled. This queue must only be
     // modified while the mutex is locked.
     op_queue<scheduler_operation> waiting_queue_;
+#endif // defined(ASIO_HAS_LOCK_FREE_STRAND)
 
     // The handlers that are ready to be run. Logically speaking, these are the
     // handlers that hold the strand's lock. The ready queue is only modified
     // from within the strand and so may be accessed without locking the mutex.
     op_queue<scheduler_operation> ready_queue_;
 
+#if defined(ASIO_HAS_STD_ATOMIC)
+    // The maximum number of ready handlers to run each time the strand is
+    // scheduled, or zero if there is no limit.
+    std::atomic<std::size_t> batch_budget_;
+
+    // Whether the strand should be rescheduled as a continuation of the
+    // thread that last ran it.
+    std::atomic<bool> sticky_;
+#else // defined(ASIO_HAS_STD_ATOMIC)
+    std::size_t batch_budget_;
+    bool sticky_;
+#endif // defined(ASIO_HAS_STD_ATOMIC)
+
+    // The thread that last ran the strand's handlers. Only accessed from
+    // within the strand.
+    thread_info_base* last_thread_;
+
+    // Counters reported by get_statistics().
+    atomic_count handlers_executed_;
+    atomic_count batches_;
+    atomic_count budget_yields_;
+    atomic_count same_thread_resumptions_;
+    atomic_count thread_migrations_;
+
     // Pointers to adjacent handle implementations in linked list.
     strand_impl* next_;
     strand_impl* prev_;
@@ -78,6 +118,28 @@ public:
 
   typedef shared_ptr<strand_impl> implementation_type;
 
+  // Counters that describe how a strand's handlers have been scheduled.
+  struct statistics
+  {
+    // The number of handlers that have been run by the strand.
+    std::size_t handlers_executed;
+
+    // The number of times the strand has been scheduled to run its handlers.
+    std::size_t batches;
+
+    // The number of times the strand has rescheduled itself because the batch
+    // budget was exhausted while handlers were still ready to run.
+    std::size_t budget_yields;
+
+    // The number of times the strand has been run by the same thread that ran
+    // it previously.
+    std::size_t same_thread_resumptions;
+
+    // The number of times the strand has been run by a different thread from
+    // the one that ran it previously.
+    std::size_t thread_migrations;
+  };
+
   // Construct a new strand service for the specified context.
   ASIO_DECL explicit strand_executor_service(execution_context& context);
 
@@ -122,8 +184,30 @@ public:
   ASIO_DECL static bool running_in_this_thread(
       const implementation_type& impl);
 
+  // Set the maximum number of handlers to run each time the strand is
+  // scheduled. Zero means no limit.
+  ASIO_DECL static void set_batch_budget(
+      const implementation_type& impl, std::size_t n);
+
+  // Get the maximum number of handlers to run each time the strand is
+  // scheduled.
+  ASIO_DECL static std::size_t batch_budget(const implementation_type& impl);
+
+  // Set whether the strand is rescheduled as a continuation of the thread that
+  // last ran it.
+  ASIO_DECL static void set_sticky(
+      const implementation_type& impl, bool value);
+
+  // Get whether the strand is rescheduled as a continuation of the thread that
+  // last ran it.
+  ASIO_DECL static bool sticky(const implementation_type& impl);
+
+  // Obtain a snapshot of the strand's counters.
+  ASIO_DECL static statistics get_statistics(const implementation_type& impl);
+
 private:
   friend class strand_impl;
+  struct on_run_ready_exit;
   template <typename F, typename Allocator> class allocator_binder;
   template <typename Executor, typename = void> class invoker;
 
@@ -135,7 +219,7 @@ private:
   // handlers were transferred.
   ASIO_DECL static bool push_waiting_to_ready(implementation_type& impl);
 
-  // Invokes all ready-to-run handlers.
+  // Invokes ready-to-run handlers, up to the strand's batch budget.
   ASIO_DECL static void run_ready_handlers(implementation_type& impl);
 
   // Helper function to request invocation of the given function.
@@ -143,9 +227,25 @@ private:
   static void do_execute(const implementation_type& impl, Executor& ex,
       ASIO_MOVE_ARG(Function) function, const Allocator& a);
 
+#if defined(ASIO_HAS_LOCK_FREE_STRAND)
+  // Values of the strand_impl state word that are not handler pointers.
+  enum
+  {
+    unlocked_state = 0,
+    locked_state = 1,
+    shutdown_state = 2
+  };
+
+  // Moves a stack of waiting handlers, in the order they were added, to the
+  // back of the given queue.
+  ASIO_DECL static void push_waiting_stack(
+      op_queue<scheduler_operation>& ops, std::size_t state);
+#endif // defined(ASIO_HAS_LOCK_FREE_STRAND)
+
   // Mutex to protect access to the service-wide state.
   mutex mutex_;
 
+#if !defined(ASIO_HAS_LOCK_FREE_STRAND)
   // Number of mutexes shared between all strand objects.
   enum { num_mutexes = 193 };
 
@@ -155,6 +255,7 @@ private:
   // Extra value used when hashing to prevent recycled memory locations from
   // getting the same mutex.
   std::size_t salt_;
+#endif // !defined(ASIO_HAS_LOCK_FREE_STRAND)
 
   // The head of a linked list of all implementations.
   strand_impl* impl_list_;
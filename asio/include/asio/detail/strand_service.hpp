@@ -17,6 +17,7 @@
 
 #include "asio/detail/config.hpp"
 #include "asio/io_context.hpp"
+#include "asio/detail/atomic_count.hpp"
 #include "asio/detail/mutex.hpp"
 #include "asio/detail/op_queue.hpp"
 #include "asio/detail/operation.hpp"
@@ -70,13 +71,81 @@ public:
     // handlers that hold the strand's lock. The ready queue is only modified
     // from within the strand and so may be accessed without locking the mutex.
     op_queue<operation> ready_queue_;
+
+#if defined(ASIO_ENABLE_DEDICATED_STRAND_IMPLEMENTATIONS)
+    // The number of strand objects that refer to the implementation, plus one
+    // while the strand is locked.
+    atomic_count ref_count_;
+
+    // The service that owns the implementation, or null if the service has
+    // been destroyed.
+    strand_service* service_;
+
+    // Pointers to adjacent implementations in the live or free list.
+    strand_impl* next_;
+    strand_impl* prev_;
+#endif // defined(ASIO_ENABLE_DEDICATED_STRAND_IMPLEMENTATIONS)
   };
 
+#if defined(ASIO_ENABLE_DEDICATED_STRAND_IMPLEMENTATIONS)
+  // Reference-counted handle to a strand implementation that is used by a
+  // single strand object and its copies.
+  class implementation_type
+  {
+  public:
+    implementation_type() ASIO_NOEXCEPT
+      : impl_(0)
+    {
+    }
+
+    implementation_type(const implementation_type& other) ASIO_NOEXCEPT
+      : impl_(other.impl_)
+    {
+      if (impl_)
+        ref_count_up(impl_->ref_count_);
+    }
+
+    ~implementation_type()
+    {
+      if (impl_)
+        strand_service::release(impl_);
+    }
+
+    implementation_type& operator=(const implementation_type& other)
+    {
+      implementation_type tmp(other);
+      strand_impl* old_impl = impl_;
+      impl_ = tmp.impl_;
+      tmp.impl_ = old_impl;
+      return *this;
+    }
+
+    operator strand_impl*() const ASIO_NOEXCEPT
+    {
+      return impl_;
+    }
+
+    strand_impl* operator->() const ASIO_NOEXCEPT
+    {
+      return impl_;
+    }
+
+  private:
+    friend class strand_service;
+    strand_impl* impl_;
+  };
+#else // defined(ASIO_ENABLE_DEDICATED_STRAND_IMPLEMENTATIONS)
   typedef strand_impl* implementation_type;
+#endif // defined(ASIO_ENABLE_DEDICATED_STRAND_IMPLEMENTATIONS)
 
   // Construct a new strand service for the specified io_context.
   ASIO_DECL explicit strand_service(ASIO_LIBNS::io_context& io_context);
 
+#if defined(ASIO_ENABLE_DEDICATED_STRAND_IMPLEMENTATIONS)
+  // Destroy all strand implementations that are no longer referenced.
+  ASIO_DECL ~strand_service();
+#endif // defined(ASIO_ENABLE_DEDICATED_STRAND_IMPLEMENTATIONS)
+
   // Destroy all user-defined handler objects owned by the service.
   ASIO_DECL void shutdown();
 
@@ -107,6 +176,32 @@ private:
       operation* base, const ASIO_LIBNS::error_code& ec,
       std::size_t bytes_transferred);
 
+  // Helper function to note that a handler has acquired the strand lock.
+  static void lock_acquired(strand_impl* impl)
+  {
+#if defined(ASIO_ENABLE_DEDICATED_STRAND_IMPLEMENTATIONS)
+    ref_count_up(impl->ref_count_);
+#else // defined(ASIO_ENABLE_DEDICATED_STRAND_IMPLEMENTATIONS)
+    (void)impl;
+#endif // defined(ASIO_ENABLE_DEDICATED_STRAND_IMPLEMENTATIONS)
+  }
+
+  // Helper function to note that the strand lock has been released.
+  static void lock_released(strand_impl* impl)
+  {
+#if defined(ASIO_ENABLE_DEDICATED_STRAND_IMPLEMENTATIONS)
+    release(impl);
+#else // defined(ASIO_ENABLE_DEDICATED_STRAND_IMPLEMENTATIONS)
+    (void)impl;
+#endif // defined(ASIO_ENABLE_DEDICATED_STRAND_IMPLEMENTATIONS)
+  }
+
+#if defined(ASIO_ENABLE_DEDICATED_STRAND_IMPLEMENTATIONS)
+  // Drop a reference to the implementation, returning it to the pool of free
+  // implementations when no references remain.
+  ASIO_DECL static void release(strand_impl* impl);
+#endif // defined(ASIO_ENABLE_DEDICATED_STRAND_IMPLEMENTATIONS)
+
   // The io_context used to obtain an I/O executor.
   io_context& io_context_;
 
@@ -116,6 +211,13 @@ private:
   // Mutex to protect access to the array of implementations.
   ASIO_LIBNS::detail::mutex mutex_;
 
+#if defined(ASIO_ENABLE_DEDICATED_STRAND_IMPLEMENTATIONS)
+  // The head of a linked list of all implementations in use.
+  strand_impl* impl_list_;
+
+  // The head of a linked list of implementations available for reuse.
+  strand_impl* free_list_;
+#else // defined(ASIO_ENABLE_DEDICATED_STRAND_IMPLEMENTATIONS)
   // Number of implementations shared between all strand objects.
 #if defined(ASIO_STRAND_IMPLEMENTATIONS)
   enum { num_implementations = ASIO_STRAND_IMPLEMENTATIONS };
@@ -129,6 +231,7 @@ private:
   // Extra value used when hashing to prevent recycled memory locations from
   // getting the same strand implementation.
   std::size_t salt_;
+#endif // defined(ASIO_ENABLE_DEDICATED_STRAND_IMPLEMENTATIONS)
 };
 
 } // namespace detail
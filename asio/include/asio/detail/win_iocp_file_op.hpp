@@ -0,0 +1,261 @@
+//
+// detail/win_iocp_file_op.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_DETAIL_WIN_IOCP_FILE_OP_HPP
+#define ASIO_DETAIL_WIN_IOCP_FILE_OP_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+
+#if defined(ASIO_HAS_IOCP) && defined(ASIO_HAS_FILE)
+
+#include <string>
+#include "asio/detail/bind_handler.hpp"
+#include "asio/detail/cstdint.hpp"
+#include "asio/detail/fenced_block.hpp"
+#include "asio/detail/handler_alloc_helpers.hpp"
+#include "asio/detail/handler_work.hpp"
+#include "asio/detail/memory.hpp"
+#include "asio/detail/operation.hpp"
+#include "asio/detail/win_iocp_io_context.hpp"
+#include "asio/error.hpp"
+#include "asio/file_base.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace ASIO_LIBNS {
+namespace detail {
+
+// File operations that do not transfer data. They may block, and so are
+// performed by the service's pool of threads before the handler is posted.
+template <typename Service>
+class win_iocp_file_op_base : public operation
+{
+public:
+  enum op_type
+  {
+    open_op,
+    close_op,
+    size_op,
+    resize_op,
+    allocate_op,
+    sync_all_op,
+    sync_data_op
+  };
+
+  // The error code to be passed to the completion handler.
+  ASIO_LIBNS::error_code ec_;
+
+  // The kind of operation.
+  op_type type_;
+
+  // The handle operated on. An open stores the handle it opens, and a close
+  // owns the handle until it has been closed.
+  HANDLE handle_;
+
+  // The range of the file for an allocation, or the new size for a resize.
+  uint64_t offset_;
+  uint64_t length_;
+
+  // The file position to be restored after the size is changed.
+  uint64_t position_;
+
+  // The size of the file, for a size operation.
+  uint64_t size_;
+
+  // The arguments to an open.
+  std::string path_;
+  file_base::flags open_flags_;
+  bool is_stream_;
+
+  // The implementation that receives the handle from an open, if it still
+  // exists. Protected by the service's mutex.
+  typename Service::implementation_type* impl_;
+
+protected:
+  win_iocp_file_op_base(Service& service, win_iocp_io_context& sched,
+      op_type type, HANDLE handle, func_type complete_func)
+    : operation(complete_func),
+      type_(type),
+      handle_(handle),
+      offset_(0),
+      length_(0),
+      position_(0),
+      size_(0),
+      open_flags_(file_base::flags()),
+      is_stream_(false),
+      impl_(0),
+      service_(service),
+      scheduler_(sched)
+  {
+  }
+
+  // If the operation is being run by a worker thread, perform it and hand it
+  // back to the scheduler for completion. Returns true if this was done.
+  bool perform_on_worker(void* owner)
+  {
+    if (!owner || owner == &scheduler_)
+      return false;
+
+    service_.perform(this);
+    scheduler_.post_deferred_completion(this);
+    return true;
+  }
+
+  // The service that performs and completes the operation.
+  Service& service_;
+
+  // The scheduler used to deliver the completion.
+  win_iocp_io_context& scheduler_;
+};
+
+template <typename Service, typename Handler, typename IoExecutor>
+class win_iocp_file_op : public win_iocp_file_op_base<Service>
+{
+public:
+  ASIO_DEFINE_HANDLER_PTR(win_iocp_file_op);
+
+  win_iocp_file_op(Service& service, win_iocp_io_context& sched,
+      typename win_iocp_file_op_base<Service>::op_type type,
+      HANDLE handle, Handler& handler, const IoExecutor& io_ex)
+    : win_iocp_file_op_base<Service>(service, sched,
+        type, handle, &win_iocp_file_op::do_complete),
+      handler_(ASIO_MOVE_CAST(Handler)(handler)),
+      work_(handler_, io_ex)
+  {
+  }
+
+  static void do_complete(void* owner, operation* base,
+      const ASIO_LIBNS::error_code& /*result_ec*/,
+      std::size_t /*bytes_transferred*/)
+  {
+    win_iocp_file_op* o(static_cast<win_iocp_file_op*>(base));
+
+    // When run on a worker thread, the operation is performed there.
+    if (o->perform_on_worker(owner))
+      return;
+
+    // Hand an opened handle to its file, and close any handle that is no
+    // longer wanted.
+    o->service_.complete(o, owner != 0);
+
+    // Take ownership of the handler object.
+    ptr p = { ASIO_LIBNS::detail::addressof(o->handler_), o, o };
+
+    ASIO_HANDLER_COMPLETION((*o));
+
+    // Take ownership of the operation's outstanding work.
+    handler_work<Handler, IoExecutor> w(
+        ASIO_MOVE_CAST2(handler_work<Handler, IoExecutor>)(
+          o->work_));
+
+    ASIO_ERROR_LOCATION(o->ec_);
+
+    // Make a copy of the handler so that the memory can be deallocated before
+    // the upcall is made. Even if we're not about to make an upcall, a
+    // sub-object of the handler may be the true owner of the memory associated
+    // with the handler. Consequently, a local copy of the handler is required
+    // to ensure that any owning sub-object remains valid until after we have
+    // deallocated the memory here.
+    detail::binder1<Handler, ASIO_LIBNS::error_code>
+      handler(o->handler_, o->ec_);
+    p.h = ASIO_LIBNS::detail::addressof(handler.handler_);
+    p.reset();
+
+    // Make the upcall if required.
+    if (owner)
+    {
+      fenced_block b(fenced_block::half);
+      ASIO_HANDLER_INVOCATION_BEGIN((handler.arg1_));
+      w.complete(handler, handler.handler_);
+      ASIO_HANDLER_INVOCATION_END;
+    }
+  }
+
+private:
+  Handler handler_;
+  handler_work<Handler, IoExecutor> work_;
+};
+
+template <typename Service, typename Handler, typename IoExecutor>
+class win_iocp_file_size_op : public win_iocp_file_op_base<Service>
+{
+public:
+  ASIO_DEFINE_HANDLER_PTR(win_iocp_file_size_op);
+
+  win_iocp_file_size_op(Service& service, win_iocp_io_context& sched,
+      HANDLE handle, Handler& handler, const IoExecutor& io_ex)
+    : win_iocp_file_op_base<Service>(service, sched,
+        win_iocp_file_op_base<Service>::size_op, handle,
+        &win_iocp_file_size_op::do_complete),
+      handler_(ASIO_MOVE_CAST(Handler)(handler)),
+      work_(handler_, io_ex)
+  {
+  }
+
+  static void do_complete(void* owner, operation* base,
+      const ASIO_LIBNS::error_code& /*result_ec*/,
+      std::size_t /*bytes_transferred*/)
+  {
+    win_iocp_file_size_op* o(static_cast<win_iocp_file_size_op*>(base));
+
+    // When run on a worker thread, the operation is performed there.
+    if (o->perform_on_worker(owner))
+      return;
+
+    // Take ownership of the handler object.
+    ptr p = { ASIO_LIBNS::detail::addressof(o->handler_), o, o };
+
+    ASIO_HANDLER_COMPLETION((*o));
+
+    // Take ownership of the operation's outstanding work.
+    handler_work<Handler, IoExecutor> w(
+        ASIO_MOVE_CAST2(handler_work<Handler, IoExecutor>)(
+          o->work_));
+
+    ASIO_ERROR_LOCATION(o->ec_);
+
+    // Make a copy of the handler so that the memory can be deallocated before
+    // the upcall is made. Even if we're not about to make an upcall, a
+    // sub-object of the handler may be the true owner of the memory associated
+    // with the handler. Consequently, a local copy of the handler is required
+    // to ensure that any owning sub-object remains valid until after we have
+    // deallocated the memory here.
+    detail::binder2<Handler, ASIO_LIBNS::error_code, uint64_t>
+      handler(o->handler_, o->ec_, o->size_);
+    p.h = ASIO_LIBNS::detail::addressof(handler.handler_);
+    p.reset();
+
+    // Make the upcall if required.
+    if (owner)
+    {
+      fenced_block b(fenced_block::half);
+      ASIO_HANDLER_INVOCATION_BEGIN((handler.arg1_, handler.arg2_));
+      w.complete(handler, handler.handler_);
+      ASIO_HANDLER_INVOCATION_END;
+    }
+  }
+
+private:
+  Handler handler_;
+  handler_work<Handler, IoExecutor> work_;
+};
+
+} // namespace detail
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // defined(ASIO_HAS_IOCP) && defined(ASIO_HAS_FILE)
+
+#endif // ASIO_DETAIL_WIN_IOCP_FILE_OP_HPP
@@ -20,11 +20,19 @@
 #if defined(ASIO_HAS_IOCP) && defined(ASIO_HAS_FILE)
 
 #include <string>
+#include "asio/detail/atomic_count.hpp"
+#include "asio/detail/bind_handler.hpp"
 #include "asio/detail/cstdint.hpp"
+#include "asio/detail/mutex.hpp"
+#include "asio/detail/scoped_ptr.hpp"
+#include "asio/detail/thread_group.hpp"
+#include "asio/detail/win_iocp_file_op.hpp"
 #include "asio/detail/win_iocp_handle_service.hpp"
+#include "asio/detail/win_iocp_io_context.hpp"
 #include "asio/error.hpp"
 #include "asio/execution_context.hpp"
 #include "asio/file_base.hpp"
+#include "asio/post.hpp"
 
 #include "asio/detail/push_options.hpp"
 
@@ -48,11 +56,21 @@ public:
 
     uint64_t offset_;
     bool is_stream_;
+
+    // The asynchronous open that will provide the handle, if any. Protected
+    // by the service's mutex.
+    win_iocp_file_op_base<win_iocp_file_service>* pending_open_;
   };
 
+  // The type of the operations performed by the pool of threads.
+  typedef win_iocp_file_op_base<win_iocp_file_service> file_op;
+
   // Constructor.
   ASIO_DECL win_iocp_file_service(execution_context& context);
 
+  // Destructor.
+  ASIO_DECL ~win_iocp_file_service();
+
   // Destroy all user-defined handler objects owned by the service.
   ASIO_DECL void shutdown();
 
@@ -62,6 +80,7 @@ public:
     handle_service_.construct(impl);
     impl.offset_ = 0;
     impl.is_stream_ = false;
+    impl.pending_open_ = 0;
   }
 
   // Move-construct a new file implementation.
@@ -72,6 +91,8 @@ public:
     impl.offset_ = other_impl.offset_;
     impl.is_stream_ = other_impl.is_stream_;
     other_impl.offset_ = 0;
+    impl.pending_open_ = 0;
+    move_pending_open(other_impl, &impl);
   }
 
   // Move-assign from another file implementation.
@@ -84,11 +105,15 @@ public:
     impl.offset_ = other_impl.offset_;
     impl.is_stream_ = other_impl.is_stream_;
     other_impl.offset_ = 0;
+    move_pending_open(impl, 0);
+    other_service.move_pending_open(other_impl,
+        &other_service == this ? &impl : 0);
   }
 
   // Destroy a file implementation.
   void destroy(implementation_type& impl)
   {
+    move_pending_open(impl, 0);
     handle_service_.destroy(impl);
   }
 
@@ -121,6 +146,7 @@ public:
   ASIO_LIBNS::error_code close(implementation_type& impl,
       ASIO_LIBNS::error_code& ec)
   {
+    move_pending_open(impl, 0);
     return handle_service_.close(impl, ec);
   }
 
@@ -148,6 +174,10 @@ public:
   ASIO_DECL uint64_t size(const implementation_type& impl,
       ASIO_LIBNS::error_code& ec) const;
 
+  // Get the alignment required for direct I/O on the file.
+  ASIO_DECL std::size_t alignment(const implementation_type& impl,
+      ASIO_LIBNS::error_code& ec) const;
+
   // Alter the size of the file.
   ASIO_DECL ASIO_LIBNS::error_code resize(implementation_type& impl,
       uint64_t n, ASIO_LIBNS::error_code& ec);
@@ -160,6 +190,143 @@ public:
   ASIO_DECL ASIO_LIBNS::error_code sync_data(implementation_type& impl,
       ASIO_LIBNS::error_code& ec);
 
+  // Allocate disk space for a range of the file.
+  ASIO_DECL ASIO_LIBNS::error_code allocate(implementation_type& impl,
+      uint64_t offset, uint64_t length, ASIO_LIBNS::error_code& ec);
+
+  // Start an asynchronous open. The file is opened by the pool and becomes
+  // open when the operation completes.
+  template <typename Handler, typename IoExecutor>
+  void async_open(implementation_type& impl, const char* path,
+      file_base::flags open_flags, Handler& handler, const IoExecutor& io_ex)
+  {
+    // Allocate and construct an operation to wrap the handler.
+    typedef win_iocp_file_op<win_iocp_file_service, Handler, IoExecutor> op;
+    typename op::ptr p = { ASIO_LIBNS::detail::addressof(handler),
+      op::ptr::allocate(handler), 0 };
+    p.p = new (p.v) op(*this, iocp_service_, file_op::open_op,
+        INVALID_HANDLE_VALUE, handler, io_ex);
+    p.p->path_ = path;
+    p.p->open_flags_ = open_flags;
+    p.p->is_stream_ = impl.is_stream_;
+
+    ASIO_HANDLER_CREATION((iocp_service_.context(), *p.p, "file", &impl,
+          reinterpret_cast<uintmax_t>(native_handle(impl)), "async_open"));
+
+    if (begin_open(impl, p.p))
+      start_op(p.p);
+    else
+      iocp_service_.post_immediate_completion(p.p, false);
+    p.v = p.p = 0;
+  }
+
+  // Start an asynchronous close. The handle is detached from the file
+  // immediately and closed by the pool, which aborts its outstanding
+  // operations.
+  template <typename Handler, typename IoExecutor>
+  void async_close(implementation_type& impl,
+      Handler& handler, const IoExecutor& io_ex)
+  {
+    move_pending_open(impl, 0);
+    HANDLE handle = handle_service_.detach(impl);
+
+    // Allocate and construct an operation to wrap the handler.
+    typedef win_iocp_file_op<win_iocp_file_service, Handler, IoExecutor> op;
+    typename op::ptr p = { ASIO_LIBNS::detail::addressof(handler),
+      op::ptr::allocate(handler), 0 };
+    p.p = new (p.v) op(*this, iocp_service_,
+        file_op::close_op, handle, handler, io_ex);
+
+    ASIO_HANDLER_CREATION((iocp_service_.context(), *p.p, "file", &impl,
+          reinterpret_cast<uintmax_t>(handle), "async_close"));
+
+    start_op(p.p);
+    p.v = p.p = 0;
+  }
+
+  // Start an asynchronous operation to get the size of the file.
+  template <typename Handler, typename IoExecutor>
+  void async_size(implementation_type& impl,
+      Handler& handler, const IoExecutor& io_ex)
+  {
+    // Allocate and construct an operation to wrap the handler.
+    typedef win_iocp_file_size_op<
+      win_iocp_file_service, Handler, IoExecutor> op;
+    typename op::ptr p = { ASIO_LIBNS::detail::addressof(handler),
+      op::ptr::allocate(handler), 0 };
+    p.p = new (p.v) op(*this, iocp_service_,
+        native_handle(impl), handler, io_ex);
+
+    ASIO_HANDLER_CREATION((iocp_service_.context(), *p.p, "file", &impl,
+          reinterpret_cast<uintmax_t>(native_handle(impl)), "async_size"));
+
+    start_op(p.p);
+    p.v = p.p = 0;
+  }
+
+  // Start an asynchronous resize.
+  template <typename Handler, typename IoExecutor>
+  void async_resize(implementation_type& impl, uint64_t n,
+      Handler& handler, const IoExecutor& io_ex)
+  {
+    start_control_op(impl, file_op::resize_op,
+        0, n, handler, io_ex, "async_resize");
+  }
+
+  // Start an asynchronous allocation of disk space.
+  template <typename Handler, typename IoExecutor>
+  void async_allocate(implementation_type& impl, uint64_t offset,
+      uint64_t length, Handler& handler, const IoExecutor& io_ex)
+  {
+    start_control_op(impl, file_op::allocate_op,
+        offset, length, handler, io_ex, "async_allocate");
+  }
+
+  // Start an asynchronous synchronisation of the file to disk.
+  template <typename Handler, typename IoExecutor>
+  void async_sync_all(implementation_type& impl,
+      Handler& handler, const IoExecutor& io_ex)
+  {
+    start_control_op(impl, file_op::sync_all_op,
+        0, 0, handler, io_ex, "async_sync_all");
+  }
+
+  // Start an asynchronous synchronisation of the file data to disk.
+  template <typename Handler, typename IoExecutor>
+  void async_sync_data(implementation_type& impl,
+      Handler& handler, const IoExecutor& io_ex)
+  {
+    start_control_op(impl, file_op::sync_data_op,
+        0, 0, handler, io_ex, "async_sync_data");
+  }
+
+  // Perform an operation, blocking if necessary. Called by the pool.
+  ASIO_DECL void perform(file_op* op);
+
+  // Finish an operation before its handler is invoked. Attaches the result of
+  // an open to its file, and closes any handle that is no longer wanted.
+  ASIO_DECL void complete(file_op* op, bool deliver);
+
+  // Copy data at the specified location to the same location in another
+  // file. Returns the number of bytes copied, which is 0 at end of file.
+  ASIO_DECL std::size_t copy_some_at(implementation_type& impl,
+      uint64_t offset, implementation_type& target, std::size_t length,
+      ASIO_LIBNS::error_code& ec);
+
+  // Copy data to another file asynchronously. Windows cannot copy a range of
+  // a file within the kernel, so the data is copied through memory before the
+  // handler is posted.
+  template <typename Handler, typename IoExecutor>
+  void async_copy_some_at(implementation_type& impl, uint64_t offset,
+      implementation_type& target, std::size_t length,
+      Handler& handler, const IoExecutor& io_ex)
+  {
+    ASIO_LIBNS::error_code ec;
+    std::size_t n = copy_some_at(impl, offset, target, length, ec);
+    ASIO_LIBNS::post(io_ex, detail::bind_handler(
+          ASIO_MOVE_CAST(Handler)(handler), ec, n));
+  }
+
   // Seek to a position in the file.
   ASIO_DECL uint64_t seek(implementation_type& impl, int64_t offset,
       file_base::seek_basis whence, ASIO_LIBNS::error_code& ec);
@@ -248,9 +415,88 @@ public:
   }
 
 private:
+  // Helper function to allocate and start an operation on an open file.
+  template <typename Handler, typename IoExecutor>
+  void start_control_op(implementation_type& impl, file_op::op_type type,
+      uint64_t offset, uint64_t length, Handler& handler,
+      const IoExecutor& io_ex, const char* name)
+  {
+    // Allocate and construct an operation to wrap the handler.
+    typedef win_iocp_file_op<win_iocp_file_service, Handler, IoExecutor> op;
+    typename op::ptr p = { ASIO_LIBNS::detail::addressof(handler),
+      op::ptr::allocate(handler), 0 };
+    p.p = new (p.v) op(*this, iocp_service_,
+        type, native_handle(impl), handler, io_ex);
+    p.p->offset_ = offset;
+    p.p->length_ = length;
+    p.p->position_ = impl.offset_;
+
+    ASIO_HANDLER_CREATION((iocp_service_.context(), *p.p, "file", &impl,
+          reinterpret_cast<uintmax_t>(native_handle(impl)), name));
+    (void)name;
+
+    start_op(p.p);
+    p.v = p.p = 0;
+  }
+
+  // Attach an asynchronous open to a file that is not open. Returns false if
+  // the file is already open or being opened.
+  ASIO_DECL bool begin_open(implementation_type& impl, file_op* op);
+
+  // Hand a pending asynchronous open to another implementation, or detach it
+  // so that its result is discarded.
+  ASIO_DECL void move_pending_open(implementation_type& impl,
+      implementation_type* new_impl);
+
+  // Hand an operation to the pool of threads, or perform it inline if the
+  // scheduler does not permit threads.
+  ASIO_DECL void start_op(file_op* op);
+
+  // Open a handle to the named file.
+  ASIO_DECL HANDLE open_handle(const char* path, file_base::flags open_flags,
+      bool is_stream, ASIO_LIBNS::error_code& ec);
+
+  // Helper functions that operate on a handle, so that they may be used by
+  // the pool after the file has changed.
+  ASIO_DECL uint64_t do_size(HANDLE handle,
+      ASIO_LIBNS::error_code& ec) const;
+  ASIO_DECL ASIO_LIBNS::error_code do_resize(HANDLE handle, uint64_t n,
+      uint64_t position, ASIO_LIBNS::error_code& ec);
+  ASIO_DECL ASIO_LIBNS::error_code do_allocate(HANDLE handle,
+      uint64_t offset, uint64_t length, uint64_t position,
+      ASIO_LIBNS::error_code& ec);
+  ASIO_DECL ASIO_LIBNS::error_code do_sync_all(HANDLE handle,
+      ASIO_LIBNS::error_code& ec);
+  ASIO_DECL ASIO_LIBNS::error_code do_sync_data(HANDLE handle,
+      ASIO_LIBNS::error_code& ec);
+
+  // Helper class to run the work scheduler in a thread.
+  class work_scheduler_runner;
+  friend class work_scheduler_runner;
+
+  // The scheduler used to deliver completions.
+  win_iocp_io_context& iocp_service_;
+
   // The implementation used for initiating asynchronous operations.
   win_iocp_handle_service handle_service_;
 
+  // Mutex to protect access to the pool of threads and to pending opens.
+  ASIO_LIBNS::detail::mutex mutex_;
+
+  // Private scheduler used for performing blocking file operations.
+  ASIO_LIBNS::detail::scoped_ptr<win_iocp_io_context> work_scheduler_;
+
+  // The threads that are running the private scheduler.
+  ASIO_LIBNS::detail::thread_group work_threads_;
+
+  // The number of threads that have been started, and the maximum number.
+  std::size_t num_threads_;
+  std::size_t max_threads_;
+
+  // The number of operations handed to the threads that have not yet been
+  // performed.
+  atomic_count outstanding_ops_;
+
   // Emulation of Windows IO_STATUS_BLOCK structure.
   struct io_status_block
   {
@@ -114,6 +114,16 @@ public:
   ASIO_DECL native_handle_type release(implementation_type& impl,
       ASIO_LIBNS::error_code& ec);
 
+  // Detach the handle from the implementation without closing it, leaving it
+  // associated with the I/O completion port so that it may be closed later.
+  native_handle_type detach(implementation_type& impl)
+  {
+    native_handle_type tmp = impl.handle_;
+    impl.handle_ = INVALID_HANDLE_VALUE;
+    impl.safe_cancellation_thread_id_ = 0;
+    return tmp;
+  }
+
   // Get the native handle representation.
   native_handle_type native_handle(const implementation_type& impl) const
   {
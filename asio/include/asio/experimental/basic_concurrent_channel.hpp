@@ -16,12 +16,15 @@
 #endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
 
 #include "asio/detail/config.hpp"
+#include "asio/compose.hpp"
 #include "asio/detail/non_const_lvalue.hpp"
 #include "asio/detail/mutex.hpp"
 #include "asio/execution/executor.hpp"
 #include "asio/execution_context.hpp"
+#include "asio/experimental/detail/channel_receive_batch_op.hpp"
+#include "asio/experimental/detail/channel_send_batch_op.hpp"
 #include "asio/experimental/detail/channel_send_functions.hpp"
-#include "asio/experimental/detail/channel_service.hpp"
+#include "asio/experimental/detail/concurrent_channel_service.hpp"
 
 #include "asio/detail/push_options.hpp"
 
@@ -104,7 +107,7 @@ class basic_concurrent_channel
 private:
   class initiate_async_send;
   class initiate_async_receive;
-  typedef detail::channel_service<ASIO_LIBNS::detail::mutex> service_type;
+  typedef detail::concurrent_channel_service service_type;
   typedef typename service_type::template implementation_type<
       Traits, Signatures...>::payload_type payload_type;
 
@@ -362,6 +365,55 @@ public:
 
 #endif // defined(GENERATING_DOCUMENTATION)
 
+  /// Try to send a range of messages without blocking.
+  /**
+   * Sends the elements of the range <tt>[first, last)</tt> in order, each as a
+   * message with no error, until a message cannot be sent without blocking.
+   * The channel is locked once for the whole range, and waiting receive
+   * operations are woken after the messages have been added.
+   *
+   * Only available for channels with a single signature of the form
+   * <tt>R(error_code, Args...)</tt>, where <tt>Args...</tt> is not empty. Each
+   * element holds the arguments of one message, either as a single value or as
+   * a @c std::tuple.
+   *
+   * @returns The number of messages that were sent.
+   */
+  template <typename Iterator>
+  std::size_t try_send_batch(Iterator first, Iterator last)
+  {
+    return service_->try_send_batch(impl_, first, last);
+  }
+
+  /// Asynchronously send a batch of messages.
+  /**
+   * Sends each element of @c values as a message with no error. Messages are
+   * sent as for try_send_batch() while there is room, and the operation waits
+   * only when no further message can be sent. It completes when all messages
+   * have been sent, or when a message cannot be sent because the channel has
+   * been closed or the operation cancelled.
+   *
+   * The channel signature and element type are as for try_send_batch().
+   *
+   * @par Completion Signature
+   * @code void(ASIO_LIBNS::error_code, std::size_t) @endcode
+   * The second argument is the number of messages that were sent.
+   */
+  template <typename Value, typename CompletionToken
+      ASIO_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  auto async_send_batch(std::vector<Value> values,
+      ASIO_MOVE_ARG(CompletionToken) token
+        ASIO_DEFAULT_COMPLETION_TOKEN(Executor))
+  {
+    typedef detail::channel_batch_traits<Signatures...> batch_traits;
+    return async_compose<CompletionToken,
+      void (ASIO_LIBNS::error_code, std::size_t)>(
+        detail::channel_send_batch_op<basic_concurrent_channel,
+          batch_traits, Value>(this,
+            ASIO_MOVE_CAST(std::vector<Value>)(values)),
+        token, *this);
+  }
+
   /// Try to receive a message without blocking.
   /**
    * Fails if the buffer is full and there are no waiting receive operations.
@@ -374,6 +426,20 @@ public:
     return service_->try_receive(impl_, ASIO_MOVE_CAST(Handler)(handler));
   }
 
+  /// Try to receive a number of messages without blocking.
+  /**
+   * Receives up to @c max_count messages that are immediately available,
+   * invoking @c handler once for each message.
+   *
+   * @returns The number of messages that were received.
+   */
+  template <typename Handler>
+  std::size_t try_receive_n(std::size_t max_count,
+      ASIO_MOVE_ARG(Handler) handler)
+  {
+    return service_->try_receive_n(impl_, max_count, handler);
+  }
+
   /// Asynchronously receive a message.
   template <typename CompletionToken
       ASIO_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
@@ -390,6 +456,36 @@ public:
         ASIO_MOVE_CAST(CompletionToken)(token));
   }
 
+  /// Asynchronously receive a batch of messages.
+  /**
+   * Waits until at least one message is available, and then receives up to
+   * @c max_count messages in a single completion. A message that carries an
+   * error ends the batch, and its error code is passed to the completion
+   * handler. If the channel is closed or the operation cancelled, the vector
+   * is empty.
+   *
+   * Only available for channels with a single signature of the form
+   * <tt>R(error_code, Args...)</tt>, where <tt>Args...</tt> is not empty. Each
+   * element of the vector holds the arguments of one message, either as a
+   * single value or as a @c std::tuple.
+   *
+   * @par Completion Signature
+   * @code void(ASIO_LIBNS::error_code, std::vector<value_type>) @endcode
+   */
+  template <typename CompletionToken
+      ASIO_DEFAULT_COMPLETION_TOKEN_TYPE(executor_type)>
+  auto async_receive_batch(std::size_t max_count,
+      ASIO_MOVE_ARG(CompletionToken) token
+        ASIO_DEFAULT_COMPLETION_TOKEN(Executor))
+  {
+    typedef detail::channel_batch_traits<Signatures...> batch_traits;
+    return async_compose<CompletionToken,
+      typename batch_traits::signature>(
+        detail::channel_receive_batch_op<basic_concurrent_channel,
+          typename batch_traits::value_type>(this, max_count),
+        token, *this);
+  }
+
 private:
   // Disallow copying and assignment.
   basic_concurrent_channel(
@@ -0,0 +1,125 @@
+//
+// experimental/detail/channel_batch_traits.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_EXPERIMENTAL_DETAIL_CHANNEL_BATCH_TRAITS_HPP
+#define ASIO_EXPERIMENTAL_DETAIL_CHANNEL_BATCH_TRAITS_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+#include <cstddef>
+#include <tuple>
+#include <vector>
+#include "asio/detail/type_traits.hpp"
+#include "asio/detail/utility.hpp"
+#include "asio/error_code.hpp"
+#include "asio/experimental/detail/channel_message.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace ASIO_LIBNS {
+namespace experimental {
+namespace detail {
+
+// Determines the element type of a batch of messages, and how an element is
+// turned into a message. Batches are supported only for channels with a single
+// signature of the form R(error_code, Args...) with at least one argument.
+template <typename... Signatures>
+struct channel_batch_traits
+{
+};
+
+// Each element of a batch is a single value.
+template <typename R, typename Arg0>
+struct channel_batch_traits<R(ASIO_LIBNS::error_code, Arg0)>
+{
+  typedef typename decay<Arg0>::type value_type;
+
+  typedef R signature(ASIO_LIBNS::error_code, std::vector<value_type>);
+
+  typedef channel_message<R(ASIO_LIBNS::error_code, Arg0)> message_type;
+
+  // Make a message, with no error, from an element.
+  template <typename Value>
+  static message_type make_message(ASIO_MOVE_ARG(Value) value)
+  {
+    return message_type(0, ASIO_LIBNS::error_code(),
+        ASIO_MOVE_CAST(Value)(value));
+  }
+
+  // Start an asynchronous send of an element, with no error.
+  template <typename Channel, typename Value, typename Handler>
+  static void async_send(Channel& channel,
+      ASIO_MOVE_ARG(Value) value, ASIO_MOVE_ARG(Handler) handler)
+  {
+    channel.async_send(ASIO_LIBNS::error_code(),
+        ASIO_MOVE_CAST(Value)(value), ASIO_MOVE_CAST(Handler)(handler));
+  }
+};
+
+// Each element of a batch is a tuple of values.
+template <typename R, typename Arg0, typename Arg1, typename... Args>
+struct channel_batch_traits<R(ASIO_LIBNS::error_code, Arg0, Arg1, Args...)>
+{
+  typedef std::tuple<typename decay<Arg0>::type,
+      typename decay<Arg1>::type, typename decay<Args>::type...> value_type;
+
+  typedef R signature(ASIO_LIBNS::error_code, std::vector<value_type>);
+
+  typedef channel_message<
+    R(ASIO_LIBNS::error_code, Arg0, Arg1, Args...)> message_type;
+
+  // Make a message, with no error, from an element.
+  template <typename Value>
+  static message_type make_message(ASIO_MOVE_ARG(Value) value)
+  {
+    return make_message(ASIO_MOVE_CAST(Value)(value),
+        ASIO_LIBNS::detail::index_sequence_for<Arg0, Arg1, Args...>());
+  }
+
+  // Start an asynchronous send of an element, with no error.
+  template <typename Channel, typename Value, typename Handler>
+  static void async_send(Channel& channel,
+      ASIO_MOVE_ARG(Value) value, ASIO_MOVE_ARG(Handler) handler)
+  {
+    async_send(channel, ASIO_MOVE_CAST(Value)(value),
+        ASIO_MOVE_CAST(Handler)(handler),
+        ASIO_LIBNS::detail::index_sequence_for<Arg0, Arg1, Args...>());
+  }
+
+private:
+  template <typename Value, std::size_t... I>
+  static message_type make_message(ASIO_MOVE_ARG(Value) value,
+      ASIO_LIBNS::detail::index_sequence<I...>)
+  {
+    return message_type(0, ASIO_LIBNS::error_code(),
+        std::get<I>(ASIO_MOVE_CAST(Value)(value))...);
+  }
+
+  template <typename Channel, typename Value,
+      typename Handler, std::size_t... I>
+  static void async_send(Channel& channel, ASIO_MOVE_ARG(Value) value,
+      ASIO_MOVE_ARG(Handler) handler, ASIO_LIBNS::detail::index_sequence<I...>)
+  {
+    channel.async_send(ASIO_LIBNS::error_code(),
+        std::get<I>(ASIO_MOVE_CAST(Value)(value))...,
+        ASIO_MOVE_CAST(Handler)(handler));
+  }
+};
+
+} // namespace detail
+} // namespace experimental
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // ASIO_EXPERIMENTAL_DETAIL_CHANNEL_BATCH_TRAITS_HPP
@@ -0,0 +1,94 @@
+//
+// experimental/detail/channel_receive_batch_op.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_EXPERIMENTAL_DETAIL_CHANNEL_RECEIVE_BATCH_OP_HPP
+#define ASIO_EXPERIMENTAL_DETAIL_CHANNEL_RECEIVE_BATCH_OP_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+#include <cstddef>
+#include <vector>
+#include "asio/error_code.hpp"
+#include "asio/experimental/channel_error.hpp"
+#include "asio/experimental/detail/channel_batch_traits.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace ASIO_LIBNS {
+namespace experimental {
+namespace detail {
+
+// Composed operation that waits for a message and then takes any further
+// messages that are immediately available, up to a maximum count.
+template <typename Channel, typename Value>
+class channel_receive_batch_op
+{
+public:
+  channel_receive_batch_op(Channel* channel, std::size_t max_count)
+    : channel_(channel),
+      max_count_(max_count ? max_count : 1)
+  {
+  }
+
+  template <typename Self>
+  void operator()(Self& self)
+  {
+    channel_->async_receive(ASIO_MOVE_CAST(Self)(self));
+  }
+
+  template <typename Self, typename... Args>
+  void operator()(Self& self, ASIO_LIBNS::error_code ec,
+      ASIO_MOVE_ARG(Args)... args)
+  {
+    if (ec != error::channel_closed && ec != error::channel_cancelled)
+    {
+      values_.reserve(max_count_);
+      values_.emplace_back(ASIO_MOVE_CAST(Args)(args)...);
+
+      // A message carrying an error ends the batch, so that the completion's
+      // error code always applies to the last element.
+      collector c = { &ec, &values_ };
+      while (!ec && values_.size() < max_count_ && channel_->try_receive(c))
+      {
+      }
+    }
+
+    self.complete(ec, ASIO_MOVE_CAST(std::vector<Value>)(values_));
+  }
+
+private:
+  struct collector
+  {
+    template <typename... Args>
+    void operator()(ASIO_LIBNS::error_code e, ASIO_MOVE_ARG(Args)... args)
+    {
+      *ec_ = e;
+      values_->emplace_back(ASIO_MOVE_CAST(Args)(args)...);
+    }
+
+    ASIO_LIBNS::error_code* ec_;
+    std::vector<Value>* values_;
+  };
+
+  Channel* channel_;
+  std::size_t max_count_;
+  std::vector<Value> values_;
+};
+
+} // namespace detail
+} // namespace experimental
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // ASIO_EXPERIMENTAL_DETAIL_CHANNEL_RECEIVE_BATCH_OP_HPP
@@ -0,0 +1,287 @@
+//
+// experimental/detail/channel_ring.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_EXPERIMENTAL_DETAIL_CHANNEL_RING_HPP
+#define ASIO_EXPERIMENTAL_DETAIL_CHANNEL_RING_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include "asio/detail/noncopyable.hpp"
+#include "asio/detail/type_traits.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace ASIO_LIBNS {
+namespace experimental {
+namespace detail {
+
+// A bounded, lock-free, multi-producer multi-consumer queue. Each cell carries
+// a sequence number that tells producers and consumers whether the cell is
+// free or full for the current lap around the ring. An even sequence number
+// 2*n means the cell is free for lap n, and 2*n+1 means it holds lap n's
+// element.
+template <typename T>
+class channel_ring
+  : private ASIO_LIBNS::detail::noncopyable
+{
+public:
+  // Holds an element that has been removed from the ring.
+  class value
+    : private ASIO_LIBNS::detail::noncopyable
+  {
+  public:
+    value()
+      : p_(0)
+    {
+    }
+
+    ~value()
+    {
+      if (p_)
+        p_->~T();
+    }
+
+    T& get()
+    {
+      return *p_;
+    }
+
+  private:
+    friend class channel_ring;
+    typename ASIO_LIBNS::aligned_storage<sizeof(T),
+      ASIO_LIBNS::alignment_of<T>::value>::type storage_;
+    T* p_;
+  };
+
+  // Construct a ring with no capacity.
+  channel_ring()
+    : cells_(0),
+      capacity_(0),
+      enqueue_pos_(0),
+      dequeue_pos_(0)
+  {
+  }
+
+  // Destroy all elements and free the ring's storage.
+  ~channel_ring()
+  {
+    clear();
+    delete[] cells_;
+  }
+
+  // Replace the ring's storage with space for the given number of elements.
+  void reset(std::size_t capacity)
+  {
+    clear();
+    delete[] cells_;
+    cells_ = 0;
+    capacity_ = 0;
+    if (capacity)
+      cells_ = new cell[capacity];
+    capacity_ = capacity;
+    for (std::size_t i = 0; i < capacity_; ++i)
+      cells_[i].sequence_.store(0, std::memory_order_relaxed);
+    enqueue_pos_.store(0, std::memory_order_relaxed);
+    dequeue_pos_.store(0, std::memory_order_relaxed);
+  }
+
+  // Exchange storage and contents with another ring. Not thread-safe.
+  void swap(channel_ring& other)
+  {
+    cell* cells = cells_;
+    cells_ = other.cells_;
+    other.cells_ = cells;
+    std::size_t capacity = capacity_;
+    capacity_ = other.capacity_;
+    other.capacity_ = capacity;
+    std::size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    enqueue_pos_.store(other.enqueue_pos_.load(
+          std::memory_order_relaxed), std::memory_order_relaxed);
+    other.enqueue_pos_.store(pos, std::memory_order_relaxed);
+    pos = dequeue_pos_.load(std::memory_order_relaxed);
+    dequeue_pos_.store(other.dequeue_pos_.load(
+          std::memory_order_relaxed), std::memory_order_relaxed);
+    other.dequeue_pos_.store(pos, std::memory_order_relaxed);
+  }
+
+  // Get the maximum number of elements the ring can hold.
+  std::size_t capacity() const
+  {
+    return capacity_;
+  }
+
+  // Determine whether the ring appears to be empty. The result is only a
+  // snapshot when other threads are using the ring.
+  bool empty() const
+  {
+    return enqueue_pos_.load(std::memory_order_acquire)
+      == dequeue_pos_.load(std::memory_order_acquire);
+  }
+
+  // Add an element constructed from the result of the given function object.
+  // The function object is called only if a cell has been claimed, so that its
+  // arguments are left untouched when the ring is full. If constructing the
+  // element throws, the cell is published as skipped so that consumers step
+  // over it instead of waiting for it.
+  template <typename Function>
+  bool try_emplace(Function f)
+  {
+    if (capacity_ == 0)
+      return false;
+
+    cell* c;
+    std::size_t turn;
+    std::size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    for (;;)
+    {
+      c = &cells_[pos % capacity_];
+      turn = pos / capacity_;
+      std::size_t seq = c->sequence_.load(std::memory_order_acquire);
+      std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq)
+        - static_cast<std::ptrdiff_t>(turn * 2);
+      if (diff == 0)
+      {
+        if (enqueue_pos_.compare_exchange_weak(pos, pos + 1,
+              std::memory_order_relaxed, std::memory_order_relaxed))
+          break;
+      }
+      else if (diff < 0)
+        return false;
+      else
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+    }
+
+    publish_on_exit on_exit = { c, turn * 2 + 1, true };
+    new (&c->storage_) T(f());
+    on_exit.skipped_ = false;
+    return true;
+  }
+
+  // Remove the element at the front of the ring, if any.
+  bool try_pop(value& v)
+  {
+    if (capacity_ == 0)
+      return false;
+
+    cell* c;
+    std::size_t turn;
+    std::size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+    for (;;)
+    {
+      c = &cells_[pos % capacity_];
+      turn = pos / capacity_;
+      std::size_t seq = c->sequence_.load(std::memory_order_acquire);
+      std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq)
+        - static_cast<std::ptrdiff_t>(turn * 2 + 1);
+      if (diff == 0)
+      {
+        if (dequeue_pos_.compare_exchange_weak(pos, pos + 1,
+              std::memory_order_relaxed, std::memory_order_relaxed))
+        {
+          if (!c->skipped_)
+            break;
+
+          // The producer failed to construct an element, so free the cell
+          // and move on to the next one.
+          c->sequence_.store(turn * 2 + 2, std::memory_order_release);
+          pos = dequeue_pos_.load(std::memory_order_relaxed);
+        }
+      }
+      else if (diff < 0)
+        return false;
+      else
+        pos = dequeue_pos_.load(std::memory_order_relaxed);
+    }
+
+    // The cell is freed even if moving the element out of it throws.
+    release_on_exit on_exit = { c, turn * 2 + 2 };
+    v.p_ = new (&v.storage_) T(ASIO_MOVE_CAST(T)(*on_exit.element()));
+    return true;
+  }
+
+  // Destroy all elements in the ring.
+  void clear()
+  {
+    for (;;)
+    {
+      value v;
+      if (!try_pop(v))
+        break;
+    }
+  }
+
+private:
+  struct cell
+  {
+    std::atomic<std::size_t> sequence_;
+    bool skipped_;
+    typename ASIO_LIBNS::aligned_storage<sizeof(T),
+      ASIO_LIBNS::alignment_of<T>::value>::type storage_;
+  };
+
+  // Publishes a cell to consumers, as full or as skipped.
+  struct publish_on_exit
+  {
+    cell* cell_;
+    std::size_t sequence_;
+    bool skipped_;
+
+    ~publish_on_exit()
+    {
+      cell_->skipped_ = skipped_;
+      cell_->sequence_.store(sequence_, std::memory_order_release);
+    }
+  };
+
+  // Destroys a cell's element and returns the cell to producers.
+  struct release_on_exit
+  {
+    cell* cell_;
+    std::size_t sequence_;
+
+    T* element()
+    {
+      return static_cast<T*>(static_cast<void*>(&cell_->storage_));
+    }
+
+    ~release_on_exit()
+    {
+      element()->~T();
+      cell_->sequence_.store(sequence_, std::memory_order_release);
+    }
+  };
+
+  // The ring's storage.
+  cell* cells_;
+  std::size_t capacity_;
+
+  // The positions at which the next element will be added and removed. They
+  // are kept on separate cache lines so that producers and consumers do not
+  // contend with each other.
+  char pad1_[64];
+  std::atomic<std::size_t> enqueue_pos_;
+  char pad2_[64 - sizeof(std::atomic<std::size_t>)];
+  std::atomic<std::size_t> dequeue_pos_;
+  char pad3_[64 - sizeof(std::atomic<std::size_t>)];
+};
+
+} // namespace detail
+} // namespace experimental
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // ASIO_EXPERIMENTAL_DETAIL_CHANNEL_RING_HPP
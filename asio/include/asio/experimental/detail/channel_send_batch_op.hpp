@@ -0,0 +1,107 @@
+//
+// experimental/detail/channel_send_batch_op.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_EXPERIMENTAL_DETAIL_CHANNEL_SEND_BATCH_OP_HPP
+#define ASIO_EXPERIMENTAL_DETAIL_CHANNEL_SEND_BATCH_OP_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+#include <cstddef>
+#include <iterator>
+#include <vector>
+#include "asio/detail/bind_handler.hpp"
+#include "asio/error_code.hpp"
+#include "asio/experimental/detail/channel_batch_traits.hpp"
+#include "asio/post.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace ASIO_LIBNS {
+namespace experimental {
+namespace detail {
+
+// Composed operation that sends a batch of messages. As many messages as
+// possible are sent without blocking, and the operation then waits to send the
+// next one before trying again.
+template <typename Channel, typename Traits, typename Value>
+class channel_send_batch_op
+{
+public:
+  typedef Value value_type;
+
+  channel_send_batch_op(Channel* channel,
+      ASIO_MOVE_ARG(std::vector<value_type>) values)
+    : channel_(channel),
+      values_(ASIO_MOVE_CAST(std::vector<value_type>)(values)),
+      next_(0)
+  {
+  }
+
+  template <typename Self>
+  void operator()(Self& self)
+  {
+    // Start by waiting to send the first message, so that the operation never
+    // completes inside the initiating function.
+    if (values_.empty())
+    {
+      ASIO_LIBNS::post(channel_->get_executor(),
+          ASIO_LIBNS::detail::bind_handler(
+            ASIO_MOVE_CAST(Self)(self), ASIO_LIBNS::error_code()));
+    }
+    else
+    {
+      Traits::async_send(*channel_,
+          ASIO_MOVE_CAST(value_type)(values_[next_++]),
+          ASIO_MOVE_CAST(Self)(self));
+    }
+  }
+
+  template <typename Self>
+  void operator()(Self& self, ASIO_LIBNS::error_code ec)
+  {
+    if (!ec)
+    {
+      next_ += channel_->try_send_batch(
+          std::make_move_iterator(values_.begin() + next_),
+          std::make_move_iterator(values_.end()));
+
+      if (next_ < values_.size())
+      {
+        Traits::async_send(*channel_,
+            ASIO_MOVE_CAST(value_type)(values_[next_++]),
+            ASIO_MOVE_CAST(Self)(self));
+        return;
+      }
+
+      self.complete(ec, next_);
+    }
+    else
+    {
+      // The message that failed was not sent.
+      self.complete(ec, next_ - 1);
+    }
+  }
+
+private:
+  Channel* channel_;
+  std::vector<value_type> values_;
+  std::size_t next_;
+};
+
+} // namespace detail
+} // namespace experimental
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // ASIO_EXPERIMENTAL_DETAIL_CHANNEL_SEND_BATCH_OP_HPP
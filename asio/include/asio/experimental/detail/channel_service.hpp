@@ -21,6 +21,7 @@
 #include "asio/detail/mutex.hpp"
 #include "asio/detail/op_queue.hpp"
 #include "asio/execution_context.hpp"
+#include "asio/experimental/detail/channel_batch_traits.hpp"
 #include "asio/experimental/detail/channel_message.hpp"
 #include "asio/experimental/detail/channel_receive_op.hpp"
 #include "asio/experimental/detail/channel_send_op.hpp"
@@ -145,6 +146,11 @@ public:
   std::size_t try_send_n(implementation_type<Traits, Signatures...>& impl,
       std::size_t count, ASIO_MOVE_ARG(Args)... args);
 
+  // Synchronously send a range of new values into the channel.
+  template <typename Traits, typename... Signatures, typename Iterator>
+  std::size_t try_send_batch(implementation_type<Traits, Signatures...>& impl,
+      Iterator first, Iterator last);
+
   // Asynchronously send a new value into the channel.
   template <typename Traits, typename... Signatures,
       typename Handler, typename IoExecutor>
@@ -185,6 +191,11 @@ public:
   bool try_receive(implementation_type<Traits, Signatures...>& impl,
       ASIO_MOVE_ARG(Handler) handler);
 
+  // Synchronously receive a number of values from the channel.
+  template <typename Traits, typename... Signatures, typename Handler>
+  std::size_t try_receive_n(implementation_type<Traits, Signatures...>& impl,
+      std::size_t max_count, Handler& handler);
+
   // Asynchronously send a new value into the channel.
   // Asynchronously receive a value from the channel.
   template <typename Traits, typename... Signatures,
@@ -242,6 +253,12 @@ private:
   // Destroy a base channel implementation.
   void base_destroy(base_implementation_type& impl);
 
+  // Helper function to take a single value from the channel. The function
+  // object is called with the value after the mutex has been released.
+  template <typename Traits, typename... Signatures, typename Function>
+  bool receive_one(implementation_type<Traits, Signatures...>& impl,
+      Function f);
+
   // Helper function to start an asynchronous put operation.
   template <typename Traits, typename... Signatures>
   void start_send_op(implementation_type<Traits, Signatures...>& impl,
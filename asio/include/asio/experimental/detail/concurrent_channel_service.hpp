@@ -0,0 +1,375 @@
+//
+// experimental/detail/concurrent_channel_service.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_EXPERIMENTAL_DETAIL_CONCURRENT_CHANNEL_SERVICE_HPP
+#define ASIO_EXPERIMENTAL_DETAIL_CONCURRENT_CHANNEL_SERVICE_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+#include <atomic>
+#include "asio/associated_cancellation_slot.hpp"
+#include "asio/cancellation_type.hpp"
+#include "asio/detail/mutex.hpp"
+#include "asio/detail/null_mutex.hpp"
+#include "asio/detail/op_queue.hpp"
+#include "asio/execution_context.hpp"
+#include "asio/experimental/detail/channel_batch_traits.hpp"
+#include "asio/experimental/detail/channel_message.hpp"
+#include "asio/experimental/detail/channel_receive_op.hpp"
+#include "asio/experimental/detail/channel_ring.hpp"
+#include "asio/experimental/detail/channel_send_op.hpp"
+#include "asio/experimental/detail/channel_service.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace ASIO_LIBNS {
+namespace experimental {
+namespace detail {
+
+// Channel service used by basic_concurrent_channel. Buffered values are held
+// in a lock-free ring so that try_send and try_receive do not need to take the
+// mutex while the channel has no waiting asynchronous operations. The mutex is
+// used only to manage the queue of waiting operations.
+class concurrent_channel_service
+  : public ASIO_LIBNS::detail::execution_context_service_base<
+      concurrent_channel_service>
+{
+public:
+  // The base implementation type of all channels.
+  struct base_implementation_type
+  {
+    // Default constructor.
+    base_implementation_type()
+      : max_buffer_size_(0),
+        closed_(false),
+        has_waiters_(false),
+        waiters_are_senders_(false),
+        next_(0),
+        prev_(0)
+    {
+    }
+
+    // The maximum number of elements that may be buffered in the channel.
+    std::size_t max_buffer_size_;
+
+    // Whether the channel has been closed.
+    std::atomic<bool> closed_;
+
+    // Whether there are operations waiting on the channel. Mirrors the state
+    // of waiters_ so that it may be tested without holding the mutex.
+    std::atomic<bool> has_waiters_;
+
+    // Whether the waiting operations are send operations.
+    bool waiters_are_senders_;
+
+    // The operations that are waiting on the channel.
+    ASIO_LIBNS::detail::op_queue<channel_operation> waiters_;
+
+    // Pointers to adjacent channel implementations in linked list.
+    base_implementation_type* next_;
+    base_implementation_type* prev_;
+
+    // The mutex to protect the waiting operations.
+    mutable ASIO_LIBNS::detail::mutex mutex_;
+  };
+
+  // The implementation for a specific value type.
+  template <typename Traits, typename... Signatures>
+  struct implementation_type : base_implementation_type
+  {
+    // The traits type associated with the channel.
+    typedef typename Traits::template rebind<Signatures...>::other traits_type;
+
+    // Type of an element stored in the buffer.
+    typedef typename channel_service<ASIO_LIBNS::detail::null_mutex>::template
+      implementation_type<Traits, Signatures...>::payload_type payload_type;
+
+    // Buffered values.
+    channel_ring<payload_type> ring_;
+  };
+
+  // Constructor.
+  concurrent_channel_service(execution_context& ctx);
+
+  // Destroy all user-defined handler objects owned by the service.
+  void shutdown();
+
+  // Construct a new channel implementation.
+  template <typename Traits, typename... Signatures>
+  void construct(implementation_type<Traits, Signatures...>& impl,
+      std::size_t max_buffer_size);
+
+  // Destroy a channel implementation.
+  template <typename Traits, typename... Signatures>
+  void destroy(implementation_type<Traits, Signatures...>& impl);
+
+  // Move-construct a new channel implementation.
+  template <typename Traits, typename... Signatures>
+  void move_construct(implementation_type<Traits, Signatures...>& impl,
+      implementation_type<Traits, Signatures...>& other_impl);
+
+  // Move-assign from another channel implementation.
+  template <typename Traits, typename... Signatures>
+  void move_assign(implementation_type<Traits, Signatures...>& impl,
+      concurrent_channel_service& other_service,
+      implementation_type<Traits, Signatures...>& other_impl);
+
+  // Get the capacity of the channel.
+  std::size_t capacity(
+      const base_implementation_type& impl) const ASIO_NOEXCEPT;
+
+  // Determine whether the channel is open.
+  bool is_open(const base_implementation_type& impl) const ASIO_NOEXCEPT;
+
+  // Reset the channel to its initial state.
+  template <typename Traits, typename... Signatures>
+  void reset(implementation_type<Traits, Signatures...>& impl);
+
+  // Close the channel.
+  template <typename Traits, typename... Signatures>
+  void close(implementation_type<Traits, Signatures...>& impl);
+
+  // Cancel all operations associated with the channel.
+  template <typename Traits, typename... Signatures>
+  void cancel(implementation_type<Traits, Signatures...>& impl);
+
+  // Cancel the operation associated with the channel that has the given key.
+  template <typename Traits, typename... Signatures>
+  void cancel_by_key(implementation_type<Traits, Signatures...>& impl,
+      void* cancellation_key);
+
+  // Determine whether a value can be read from the channel without blocking.
+  template <typename Traits, typename... Signatures>
+  bool ready(const implementation_type<Traits, Signatures...>& impl)
+    const ASIO_NOEXCEPT;
+
+  // Synchronously send a new value into the channel.
+  template <typename Message, typename Traits,
+      typename... Signatures, typename... Args>
+  bool try_send(implementation_type<Traits, Signatures...>& impl,
+      ASIO_MOVE_ARG(Args)... args);
+
+  // Synchronously send a number of new values into the channel.
+  template <typename Message, typename Traits,
+      typename... Signatures, typename... Args>
+  std::size_t try_send_n(implementation_type<Traits, Signatures...>& impl,
+      std::size_t count, ASIO_MOVE_ARG(Args)... args);
+
+  // Synchronously send a range of new values into the channel.
+  template <typename Traits, typename... Signatures, typename Iterator>
+  std::size_t try_send_batch(implementation_type<Traits, Signatures...>& impl,
+      Iterator first, Iterator last);
+
+  // Asynchronously send a new value into the channel.
+  template <typename Traits, typename... Signatures,
+      typename Handler, typename IoExecutor>
+  void async_send(implementation_type<Traits, Signatures...>& impl,
+      ASIO_MOVE_ARG2(typename implementation_type<
+        Traits, Signatures...>::payload_type) payload,
+      Handler& handler, const IoExecutor& io_ex)
+  {
+    typename associated_cancellation_slot<Handler>::type slot
+      = ASIO_LIBNS::get_associated_cancellation_slot(handler);
+
+    // Allocate and construct an operation to wrap the handler.
+    typedef channel_send_op<
+      typename implementation_type<Traits, Signatures...>::payload_type,
+        Handler, IoExecutor> op;
+    typename op::ptr p = { ASIO_LIBNS::detail::addressof(handler),
+      op::ptr::allocate(handler), 0 };
+    p.p = new (p.v) op(ASIO_MOVE_CAST2(typename implementation_type<
+          Traits, Signatures...>::payload_type)(payload), handler, io_ex);
+
+    // Optionally register for per-operation cancellation.
+    if (slot.is_connected())
+    {
+      p.p->cancellation_key_ =
+        &slot.template emplace<op_cancellation<Traits, Signatures...> >(
+            this, &impl);
+    }
+
+    ASIO_HANDLER_CREATION((this->context(), *p.p,
+          "concurrent_channel", &impl, 0, "async_send"));
+
+    start_send_op(impl, p.p);
+    p.v = p.p = 0;
+  }
+
+  // Synchronously receive a value from the channel.
+  template <typename Traits, typename... Signatures, typename Handler>
+  bool try_receive(implementation_type<Traits, Signatures...>& impl,
+      ASIO_MOVE_ARG(Handler) handler);
+
+  // Synchronously receive a number of values from the channel.
+  template <typename Traits, typename... Signatures, typename Handler>
+  std::size_t try_receive_n(implementation_type<Traits, Signatures...>& impl,
+      std::size_t max_count, Handler& handler);
+
+  // Asynchronously receive a value from the channel.
+  template <typename Traits, typename... Signatures,
+      typename Handler, typename IoExecutor>
+  void async_receive(implementation_type<Traits, Signatures...>& impl,
+      Handler& handler, const IoExecutor& io_ex)
+  {
+    typename associated_cancellation_slot<Handler>::type slot
+      = ASIO_LIBNS::get_associated_cancellation_slot(handler);
+
+    // Allocate and construct an operation to wrap the handler.
+    typedef channel_receive_op<
+      typename implementation_type<Traits, Signatures...>::payload_type,
+        Handler, IoExecutor> op;
+    typename op::ptr p = { ASIO_LIBNS::detail::addressof(handler),
+      op::ptr::allocate(handler), 0 };
+    p.p = new (p.v) op(handler, io_ex);
+
+    // Optionally register for per-operation cancellation.
+    if (slot.is_connected())
+    {
+      p.p->cancellation_key_ =
+        &slot.template emplace<op_cancellation<Traits, Signatures...> >(
+            this, &impl);
+    }
+
+    ASIO_HANDLER_CREATION((this->context(), *p.p,
+          "concurrent_channel", &impl, 0, "async_receive"));
+
+    start_receive_op(impl, p.p);
+    p.v = p.p = 0;
+  }
+
+private:
+  // Helper function object to handle a closed notification.
+  template <typename Payload, typename Signature>
+  struct complete_receive
+  {
+    explicit complete_receive(channel_receive<Payload>* op)
+      : op_(op)
+    {
+    }
+
+    template <typename... Args>
+    void operator()(ASIO_MOVE_ARG(Args)... args)
+    {
+      op_->complete(
+          channel_message<Signature>(0,
+            ASIO_MOVE_CAST(Args)(args)...));
+    }
+
+    channel_receive<Payload>* op_;
+  };
+
+  // Helper function object to move a waiting sender's payload into the ring.
+  template <typename Payload>
+  struct take_payload
+  {
+    Payload operator()()
+    {
+      return op_->get_payload();
+    }
+
+    channel_send<Payload>* op_;
+  };
+
+  // Insert a channel implementation into the linked list.
+  void base_insert(base_implementation_type& impl);
+
+  // Remove a channel implementation from the linked list.
+  void base_remove(base_implementation_type& impl);
+
+  // Update the waiter flag after the waiting operations have changed. Must be
+  // called with the implementation's mutex held.
+  static void update_waiters(base_implementation_type& impl);
+
+  // Transfer values between the ring and the waiting operations until neither
+  // can make further progress. Must be called with the implementation's mutex
+  // held.
+  template <typename Traits, typename... Signatures>
+  static void pump(implementation_type<Traits, Signatures...>& impl);
+
+  // Add the values for a range to the channel, using the function object to
+  // make the payload for each position. Must be called with the
+  // implementation's mutex held.
+  template <typename Traits, typename... Signatures,
+      typename Iterator, typename Function>
+  static std::size_t send_batch(
+      implementation_type<Traits, Signatures...>& impl,
+      Iterator first, Iterator last, Function make_payload);
+
+  // Complete a waiting operation as cancelled. Must be called with the
+  // implementation's mutex held.
+  template <typename Traits, typename... Signatures>
+  static void cancel_op(implementation_type<Traits, Signatures...>& impl,
+      channel_operation* op);
+
+  // Helper function to take a single value from the channel. The function
+  // object is called with the value after the mutex has been released.
+  template <typename Traits, typename... Signatures, typename Function>
+  bool receive_one(implementation_type<Traits, Signatures...>& impl,
+      Function f);
+
+  // Helper function to start an asynchronous put operation.
+  template <typename Traits, typename... Signatures>
+  void start_send_op(implementation_type<Traits, Signatures...>& impl,
+      channel_send<typename implementation_type<
+        Traits, Signatures...>::payload_type>* send_op);
+
+  // Helper function to start an asynchronous get operation.
+  template <typename Traits, typename... Signatures>
+  void start_receive_op(implementation_type<Traits, Signatures...>& impl,
+      channel_receive<typename implementation_type<
+        Traits, Signatures...>::payload_type>* receive_op);
+
+  // Helper class used to implement per-operation cancellation.
+  template <typename Traits, typename... Signatures>
+  class op_cancellation
+  {
+  public:
+    op_cancellation(concurrent_channel_service* s,
+        implementation_type<Traits, Signatures...>* impl)
+      : service_(s),
+        impl_(impl)
+    {
+    }
+
+    void operator()(cancellation_type_t type)
+    {
+      if (!!(type &
+            (cancellation_type::terminal
+              | cancellation_type::partial
+              | cancellation_type::total)))
+      {
+        service_->cancel_by_key(*impl_, this);
+      }
+    }
+
+  private:
+    concurrent_channel_service* service_;
+    implementation_type<Traits, Signatures...>* impl_;
+  };
+
+  // Mutex to protect access to the linked list of implementations.
+  ASIO_LIBNS::detail::mutex mutex_;
+
+  // The head of a linked list of all implementations.
+  base_implementation_type* impl_list_;
+};
+
+} // namespace detail
+} // namespace experimental
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#include "asio/experimental/detail/impl/concurrent_channel_service.hpp"
+
+#endif // ASIO_EXPERIMENTAL_DETAIL_CONCURRENT_CHANNEL_SERVICE_HPP
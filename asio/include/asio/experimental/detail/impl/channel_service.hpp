@@ -420,6 +420,54 @@ std::size_t channel_service<Mutex>::try_send_n(
   return count;
 }
 
+template <typename Mutex>
+template <typename Traits, typename... Signatures, typename Iterator>
+std::size_t channel_service<Mutex>::try_send_batch(
+    channel_service<Mutex>::implementation_type<Traits, Signatures...>& impl,
+    Iterator first, Iterator last)
+{
+  typedef typename implementation_type<Traits,
+      Signatures...>::payload_type payload_type;
+  typedef channel_batch_traits<Signatures...> batch_traits;
+
+  typename Mutex::scoped_lock lock(impl.mutex_);
+
+  std::size_t count = 0;
+  for (; first != last; ++first, ++count)
+  {
+    switch (impl.send_state_)
+    {
+    case buffer:
+      {
+        impl.buffer_push(batch_traits::make_message(*first));
+        impl.receive_state_ = buffer;
+        if (impl.buffer_size() == impl.max_buffer_size_)
+          impl.send_state_ = block;
+        break;
+      }
+    case waiter:
+      {
+        payload_type payload(batch_traits::make_message(*first));
+        channel_receive<payload_type>* receive_op =
+          static_cast<channel_receive<payload_type>*>(impl.waiters_.front());
+        impl.waiters_.pop();
+        receive_op->complete(ASIO_MOVE_CAST(payload_type)(payload));
+        if (impl.waiters_.empty())
+          impl.send_state_ = impl.max_buffer_size_ ? buffer : block;
+        break;
+      }
+    case block:
+    case closed:
+    default:
+      {
+        return count;
+      }
+    }
+  }
+
+  return count;
+}
+
 template <typename Mutex>
 template <typename Traits, typename... Signatures>
 void channel_service<Mutex>::start_send_op(
@@ -479,6 +527,46 @@ bool channel_service<Mutex>::try_receive(
   typedef typename implementation_type<Traits,
       Signatures...>::payload_type payload_type;
 
+  ASIO_LIBNS::detail::non_const_lvalue<Handler> handler2(handler);
+  return receive_one(impl,
+      [&](ASIO_MOVE_ARG(payload_type) payload)
+      {
+        channel_handler<payload_type, typename decay<Handler>::type>(
+            ASIO_MOVE_CAST(payload_type)(payload), handler2.value)();
+      });
+}
+
+template <typename Mutex>
+template <typename Traits, typename... Signatures, typename Handler>
+std::size_t channel_service<Mutex>::try_receive_n(
+    channel_service<Mutex>::implementation_type<Traits, Signatures...>& impl,
+    std::size_t max_count, Handler& handler)
+{
+  typedef typename implementation_type<Traits,
+      Signatures...>::payload_type payload_type;
+
+  std::size_t count = 0;
+  while (count < max_count
+      && receive_one(impl,
+        [&](ASIO_MOVE_ARG(payload_type) payload)
+        {
+          payload.receive(handler);
+        }))
+  {
+    ++count;
+  }
+  return count;
+}
+
+template <typename Mutex>
+template <typename Traits, typename... Signatures, typename Function>
+bool channel_service<Mutex>::receive_one(
+    channel_service<Mutex>::implementation_type<Traits, Signatures...>& impl,
+    Function f)
+{
+  typedef typename implementation_type<Traits,
+      Signatures...>::payload_type payload_type;
+
   typename Mutex::scoped_lock lock(impl.mutex_);
 
   switch (impl.receive_state_)
@@ -506,9 +594,7 @@ bool channel_service<Mutex>::try_receive(
         impl.send_state_ = (impl.send_state_ == closed) ? closed : buffer;
       }
       lock.unlock();
-      ASIO_LIBNS::detail::non_const_lvalue<Handler> handler2(handler);
-      channel_handler<payload_type, typename decay<Handler>::type>(
-          ASIO_MOVE_CAST(payload_type)(payload), handler2.value)();
+      f(ASIO_MOVE_CAST(payload_type)(payload));
       return true;
     }
   case waiter:
@@ -521,9 +607,7 @@ bool channel_service<Mutex>::try_receive(
       if (impl.waiters_.front() == 0)
         impl.receive_state_ = (impl.send_state_ == closed) ? closed : block;
       lock.unlock();
-      ASIO_LIBNS::detail::non_const_lvalue<Handler> handler2(handler);
-      channel_handler<payload_type, typename decay<Handler>::type>(
-          ASIO_MOVE_CAST(payload_type)(payload), handler2.value)();
+      f(ASIO_MOVE_CAST(payload_type)(payload));
       return true;
     }
   case closed:
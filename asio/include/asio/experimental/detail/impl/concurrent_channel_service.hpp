@@ -0,0 +1,737 @@
+//
+// experimental/detail/impl/concurrent_channel_service.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_EXPERIMENTAL_DETAIL_IMPL_CONCURRENT_CHANNEL_SERVICE_HPP
+#define ASIO_EXPERIMENTAL_DETAIL_IMPL_CONCURRENT_CHANNEL_SERVICE_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/push_options.hpp"
+
+namespace ASIO_LIBNS {
+namespace experimental {
+namespace detail {
+
+inline concurrent_channel_service::concurrent_channel_service(
+    execution_context& ctx)
+  : ASIO_LIBNS::detail::execution_context_service_base<
+      concurrent_channel_service>(ctx),
+    mutex_(),
+    impl_list_(0)
+{
+}
+
+inline void concurrent_channel_service::shutdown()
+{
+  // Abandon all pending operations.
+  ASIO_LIBNS::detail::op_queue<channel_operation> ops;
+  ASIO_LIBNS::detail::mutex::scoped_lock lock(mutex_);
+  base_implementation_type* impl = impl_list_;
+  while (impl)
+  {
+    ASIO_LIBNS::detail::mutex::scoped_lock impl_lock(impl->mutex_);
+    ops.push(impl->waiters_);
+    update_waiters(*impl);
+    impl = impl->next_;
+  }
+}
+
+template <typename Traits, typename... Signatures>
+void concurrent_channel_service::construct(
+    concurrent_channel_service::implementation_type<
+      Traits, Signatures...>& impl,
+    std::size_t max_buffer_size)
+{
+  impl.max_buffer_size_ = max_buffer_size;
+  impl.ring_.reset(max_buffer_size);
+  base_insert(impl);
+}
+
+template <typename Traits, typename... Signatures>
+void concurrent_channel_service::destroy(
+    concurrent_channel_service::implementation_type<
+      Traits, Signatures...>& impl)
+{
+  cancel(impl);
+  base_remove(impl);
+}
+
+template <typename Traits, typename... Signatures>
+void concurrent_channel_service::move_construct(
+    concurrent_channel_service::implementation_type<
+      Traits, Signatures...>& impl,
+    concurrent_channel_service::implementation_type<
+      Traits, Signatures...>& other_impl)
+{
+  impl.max_buffer_size_ = other_impl.max_buffer_size_;
+  impl.closed_.store(other_impl.closed_.load());
+  impl.ring_.swap(other_impl.ring_);
+
+  // The moved-from channel is left unbuffered and open.
+  other_impl.max_buffer_size_ = 0;
+  other_impl.closed_.store(false);
+
+  base_insert(impl);
+}
+
+template <typename Traits, typename... Signatures>
+void concurrent_channel_service::move_assign(
+    concurrent_channel_service::implementation_type<
+      Traits, Signatures...>& impl,
+    concurrent_channel_service& other_service,
+    concurrent_channel_service::implementation_type<
+      Traits, Signatures...>& other_impl)
+{
+  cancel(impl);
+
+  if (this != &other_service)
+    base_remove(impl);
+
+  impl.max_buffer_size_ = other_impl.max_buffer_size_;
+  impl.closed_.store(other_impl.closed_.load());
+  impl.ring_.swap(other_impl.ring_);
+  other_impl.ring_.reset(0);
+
+  // The moved-from channel is left unbuffered and open.
+  other_impl.max_buffer_size_ = 0;
+  other_impl.closed_.store(false);
+
+  if (this != &other_service)
+    other_service.base_insert(impl);
+}
+
+inline void concurrent_channel_service::base_insert(
+    concurrent_channel_service::base_implementation_type& impl)
+{
+  // Insert implementation into linked list of all implementations.
+  ASIO_LIBNS::detail::mutex::scoped_lock lock(mutex_);
+  impl.next_ = impl_list_;
+  impl.prev_ = 0;
+  if (impl_list_)
+    impl_list_->prev_ = &impl;
+  impl_list_ = &impl;
+}
+
+inline void concurrent_channel_service::base_remove(
+    concurrent_channel_service::base_implementation_type& impl)
+{
+  // Remove implementation from linked list of all implementations.
+  ASIO_LIBNS::detail::mutex::scoped_lock lock(mutex_);
+  if (impl_list_ == &impl)
+    impl_list_ = impl.next_;
+  if (impl.prev_)
+    impl.prev_->next_ = impl.next_;
+  if (impl.next_)
+    impl.next_->prev_= impl.prev_;
+  impl.next_ = 0;
+  impl.prev_ = 0;
+}
+
+inline std::size_t concurrent_channel_service::capacity(
+    const concurrent_channel_service::base_implementation_type& impl)
+  const ASIO_NOEXCEPT
+{
+  return impl.max_buffer_size_;
+}
+
+inline bool concurrent_channel_service::is_open(
+    const concurrent_channel_service::base_implementation_type& impl)
+  const ASIO_NOEXCEPT
+{
+  return !impl.closed_.load(std::memory_order_acquire);
+}
+
+template <typename Traits, typename... Signatures>
+void concurrent_channel_service::reset(
+    concurrent_channel_service::implementation_type<
+      Traits, Signatures...>& impl)
+{
+  cancel(impl);
+
+  ASIO_LIBNS::detail::mutex::scoped_lock lock(impl.mutex_);
+
+  impl.closed_.store(false, std::memory_order_release);
+  impl.ring_.clear();
+}
+
+template <typename Traits, typename... Signatures>
+void concurrent_channel_service::close(
+    concurrent_channel_service::implementation_type<
+      Traits, Signatures...>& impl)
+{
+  typedef typename implementation_type<Traits,
+      Signatures...>::traits_type traits_type;
+  typedef typename implementation_type<Traits,
+      Signatures...>::payload_type payload_type;
+
+  ASIO_LIBNS::detail::mutex::scoped_lock lock(impl.mutex_);
+
+  impl.closed_.store(true, std::memory_order_release);
+
+  if (!impl.waiters_are_senders_)
+  {
+    while (channel_operation* op = impl.waiters_.front())
+    {
+      impl.waiters_.pop();
+      traits_type::invoke_receive_closed(
+          complete_receive<payload_type,
+            typename traits_type::receive_closed_signature>(
+              static_cast<channel_receive<payload_type>*>(op)));
+    }
+    update_waiters(impl);
+  }
+}
+
+template <typename Traits, typename... Signatures>
+void concurrent_channel_service::cancel(
+    concurrent_channel_service::implementation_type<
+      Traits, Signatures...>& impl)
+{
+  ASIO_LIBNS::detail::mutex::scoped_lock lock(impl.mutex_);
+
+  while (channel_operation* op = impl.waiters_.front())
+  {
+    impl.waiters_.pop();
+    cancel_op(impl, op);
+  }
+  update_waiters(impl);
+}
+
+template <typename Traits, typename... Signatures>
+void concurrent_channel_service::cancel_by_key(
+    concurrent_channel_service::implementation_type<
+      Traits, Signatures...>& impl,
+    void* cancellation_key)
+{
+  ASIO_LIBNS::detail::mutex::scoped_lock lock(impl.mutex_);
+
+  ASIO_LIBNS::detail::op_queue<channel_operation> other_ops;
+  while (channel_operation* op = impl.waiters_.front())
+  {
+    impl.waiters_.pop();
+    if (op->cancellation_key_ == cancellation_key)
+      cancel_op(impl, op);
+    else
+      other_ops.push(op);
+  }
+  impl.waiters_.push(other_ops);
+  update_waiters(impl);
+}
+
+template <typename Traits, typename... Signatures>
+bool concurrent_channel_service::ready(
+    const concurrent_channel_service::implementation_type<
+      Traits, Signatures...>& impl) const ASIO_NOEXCEPT
+{
+  if (impl.closed_.load(std::memory_order_acquire) || !impl.ring_.empty())
+    return true;
+
+  ASIO_LIBNS::detail::mutex::scoped_lock lock(impl.mutex_);
+
+  return impl.waiters_are_senders_ && !impl.waiters_.empty();
+}
+
+template <typename Message, typename Traits,
+    typename... Signatures, typename... Args>
+bool concurrent_channel_service::try_send(
+    concurrent_channel_service::implementation_type<
+      Traits, Signatures...>& impl,
+    ASIO_MOVE_ARG(Args)... args)
+{
+  typedef typename implementation_type<Traits,
+      Signatures...>::payload_type payload_type;
+
+  // Fast path: with nobody waiting, the value can go straight into the ring.
+  // The arguments are consumed only if a slot has been claimed. A queued
+  // sender keeps has_waiters_ set until pump() has moved its value into the
+  // ring, so a new value never overtakes one that is already waiting.
+  if (!impl.has_waiters_.load(std::memory_order_acquire)
+      && !impl.closed_.load(std::memory_order_acquire))
+  {
+    if (impl.ring_.try_emplace(
+          [&]()
+          {
+            return payload_type(Message(0, ASIO_MOVE_CAST(Args)(args)...));
+          }))
+    {
+      // Pairs with the fence in start_receive_op, so that either we observe
+      // the newly registered waiter, or it observes our value.
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (impl.has_waiters_.load(std::memory_order_relaxed))
+      {
+        ASIO_LIBNS::detail::mutex::scoped_lock lock(impl.mutex_);
+        pump(impl);
+      }
+      return true;
+    }
+  }
+
+  ASIO_LIBNS::detail::mutex::scoped_lock lock(impl.mutex_);
+
+  if (impl.closed_.load(std::memory_order_relaxed))
+    return false;
+
+  pump(impl);
+
+  if (impl.max_buffer_size_ > 0)
+  {
+    // Values always pass through the ring, even when there are receivers
+    // waiting, so that they are not reordered with respect to values that
+    // are still being added by other threads.
+    if (impl.waiters_are_senders_ && !impl.waiters_.empty())
+      return false;
+    if (!impl.ring_.try_emplace(
+          [&]()
+          {
+            return payload_type(Message(0, ASIO_MOVE_CAST(Args)(args)...));
+          }))
+      return false;
+    pump(impl);
+    return true;
+  }
+  else if (!impl.waiters_are_senders_ && !impl.waiters_.empty())
+  {
+    payload_type payload(Message(0, ASIO_MOVE_CAST(Args)(args)...));
+    channel_receive<payload_type>* receive_op =
+      static_cast<channel_receive<payload_type>*>(impl.waiters_.front());
+    impl.waiters_.pop();
+    receive_op->complete(ASIO_MOVE_CAST(payload_type)(payload));
+    update_waiters(impl);
+    return true;
+  }
+  else
+  {
+    return false;
+  }
+}
+
+template <typename Message, typename Traits,
+    typename... Signatures, typename... Args>
+std::size_t concurrent_channel_service::try_send_n(
+    concurrent_channel_service::implementation_type<
+      Traits, Signatures...>& impl,
+    std::size_t count, ASIO_MOVE_ARG(Args)... args)
+{
+  typedef typename implementation_type<Traits,
+      Signatures...>::payload_type payload_type;
+
+  ASIO_LIBNS::detail::mutex::scoped_lock lock(impl.mutex_);
+
+  if (count == 0 || impl.closed_.load(std::memory_order_relaxed))
+    return 0;
+
+  payload_type payload(Message(0, ASIO_MOVE_CAST(Args)(args)...));
+  return send_batch(impl, std::size_t(0), count,
+      [&](std::size_t)
+      {
+        return payload;
+      });
+}
+
+template <typename Traits, typename... Signatures, typename Iterator>
+std::size_t concurrent_channel_service::try_send_batch(
+    concurrent_channel_service::implementation_type<
+      Traits, Signatures...>& impl,
+    Iterator first, Iterator last)
+{
+  typedef typename implementation_type<Traits,
+      Signatures...>::payload_type payload_type;
+  typedef channel_batch_traits<Signatures...> batch_traits;
+
+  ASIO_LIBNS::detail::mutex::scoped_lock lock(impl.mutex_);
+
+  if (impl.closed_.load(std::memory_order_relaxed))
+    return 0;
+
+  return send_batch(impl, first, last,
+      [](const Iterator& iter)
+      {
+        return payload_type(batch_traits::make_message(*iter));
+      });
+}
+
+template <typename Traits, typename... Signatures,
+    typename Iterator, typename Function>
+std::size_t concurrent_channel_service::send_batch(
+    concurrent_channel_service::implementation_type<
+      Traits, Signatures...>& impl,
+    Iterator first, Iterator last, Function make_payload)
+{
+  typedef typename implementation_type<Traits,
+      Signatures...>::payload_type payload_type;
+
+  pump(impl);
+
+  std::size_t count = 0;
+  if (impl.max_buffer_size_ > 0)
+  {
+    if (impl.waiters_are_senders_ && !impl.waiters_.empty())
+      return 0;
+
+    // Waiting receivers are woken only when the ring fills up, and once after
+    // the last value has been added.
+    for (; first != last; ++first, ++count)
+    {
+      if (!impl.ring_.try_emplace(
+            [&]()
+            {
+              return make_payload(first);
+            }))
+      {
+        if (impl.waiters_are_senders_ || impl.waiters_.empty())
+          break;
+        pump(impl);
+        if (!impl.ring_.try_emplace(
+              [&]()
+              {
+                return make_payload(first);
+              }))
+          break;
+      }
+    }
+    pump(impl);
+  }
+  else
+  {
+    // Unbuffered channel, so hand each value to a waiting receiver.
+    for (; first != last && !impl.waiters_are_senders_
+        && !impl.waiters_.empty(); ++first, ++count)
+    {
+      channel_receive<payload_type>* receive_op =
+        static_cast<channel_receive<payload_type>*>(impl.waiters_.front());
+      impl.waiters_.pop();
+      receive_op->complete(make_payload(first));
+    }
+    update_waiters(impl);
+  }
+
+  return count;
+}
+
+inline void concurrent_channel_service::update_waiters(
+    concurrent_channel_service::base_implementation_type& impl)
+{
+  if (impl.waiters_.empty())
+  {
+    impl.waiters_are_senders_ = false;
+    impl.has_waiters_.store(false, std::memory_order_release);
+  }
+}
+
+template <typename Traits, typename... Signatures>
+void concurrent_channel_service::pump(
+    concurrent_channel_service::implementation_type<
+      Traits, Signatures...>& impl)
+{
+  typedef typename implementation_type<Traits,
+      Signatures...>::payload_type payload_type;
+
+  if (impl.waiters_.empty())
+    return;
+
+  if (impl.waiters_are_senders_)
+  {
+    // Move the values of waiting senders into any space in the ring.
+    while (channel_send<payload_type>* send_op =
+        static_cast<channel_send<payload_type>*>(impl.waiters_.front()))
+    {
+      take_payload<payload_type> take = { send_op };
+      if (!impl.ring_.try_emplace(take))
+        break;
+      impl.waiters_.pop();
+      send_op->complete();
+    }
+  }
+  else
+  {
+    // Deliver any buffered values to waiting receivers.
+    while (channel_receive<payload_type>* receive_op =
+        static_cast<channel_receive<payload_type>*>(impl.waiters_.front()))
+    {
+      typename channel_ring<payload_type>::value value;
+      if (!impl.ring_.try_pop(value))
+        break;
+      impl.waiters_.pop();
+      receive_op->complete(ASIO_MOVE_CAST(payload_type)(value.get()));
+    }
+  }
+
+  update_waiters(impl);
+}
+
+template <typename Traits, typename... Signatures>
+void concurrent_channel_service::cancel_op(
+    concurrent_channel_service::implementation_type<
+      Traits, Signatures...>& impl,
+    channel_operation* op)
+{
+  typedef typename implementation_type<Traits,
+      Signatures...>::traits_type traits_type;
+  typedef typename implementation_type<Traits,
+      Signatures...>::payload_type payload_type;
+
+  if (impl.waiters_are_senders_)
+  {
+    static_cast<channel_send<payload_type>*>(op)->cancel();
+  }
+  else
+  {
+    traits_type::invoke_receive_cancelled(
+        complete_receive<payload_type,
+          typename traits_type::receive_cancelled_signature>(
+            static_cast<channel_receive<payload_type>*>(op)));
+  }
+}
+
+template <typename Traits, typename... Signatures>
+void concurrent_channel_service::start_send_op(
+    concurrent_channel_service::implementation_type<
+      Traits, Signatures...>& impl,
+    channel_send<typename implementation_type<
+      Traits, Signatures...>::payload_type>* send_op)
+{
+  typedef typename implementation_type<Traits,
+      Signatures...>::payload_type payload_type;
+
+  ASIO_LIBNS::detail::mutex::scoped_lock lock(impl.mutex_);
+
+  if (impl.closed_.load(std::memory_order_relaxed))
+  {
+    send_op->close();
+    return;
+  }
+
+  pump(impl);
+
+  if (impl.max_buffer_size_ > 0)
+  {
+    if (!impl.waiters_are_senders_ || impl.waiters_.empty())
+    {
+      take_payload<payload_type> take = { send_op };
+      if (impl.ring_.try_emplace(take))
+      {
+        send_op->complete();
+        pump(impl);
+        return;
+      }
+    }
+  }
+  else if (!impl.waiters_are_senders_ && !impl.waiters_.empty())
+  {
+    channel_receive<payload_type>* receive_op =
+      static_cast<channel_receive<payload_type>*>(impl.waiters_.front());
+    impl.waiters_.pop();
+    receive_op->complete(send_op->get_payload());
+    update_waiters(impl);
+    send_op->complete();
+    return;
+  }
+
+  // Wait for space in the ring, or for a receiver.
+  impl.waiters_.push(send_op);
+  impl.waiters_are_senders_ = true;
+  impl.has_waiters_.store(true, std::memory_order_relaxed);
+
+  // Pairs with the fence in try_receive, so that either the receiver observes
+  // the waiter, or we observe the space it has freed.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  pump(impl);
+}
+
+template <typename Traits, typename... Signatures, typename Handler>
+bool concurrent_channel_service::try_receive(
+    concurrent_channel_service::implementation_type<
+      Traits, Signatures...>& impl,
+    ASIO_MOVE_ARG(Handler) handler)
+{
+  typedef typename implementation_type<Traits,
+      Signatures...>::payload_type payload_type;
+
+  ASIO_LIBNS::detail::non_const_lvalue<Handler> handler2(handler);
+  return receive_one(impl,
+      [&](ASIO_MOVE_ARG(payload_type) payload)
+      {
+        channel_handler<payload_type, typename decay<Handler>::type>(
+            ASIO_MOVE_CAST(payload_type)(payload), handler2.value)();
+      });
+}
+
+template <typename Traits, typename... Signatures, typename Handler>
+std::size_t concurrent_channel_service::try_receive_n(
+    concurrent_channel_service::implementation_type<
+      Traits, Signatures...>& impl,
+    std::size_t max_count, Handler& handler)
+{
+  typedef typename implementation_type<Traits,
+      Signatures...>::payload_type payload_type;
+
+  // Drain buffered values without locking, then wake any waiting senders
+  // once for the whole batch.
+  std::size_t count = 0;
+  while (count < max_count && !impl.closed_.load(std::memory_order_acquire))
+  {
+    typename channel_ring<payload_type>::value value;
+    if (!impl.ring_.try_pop(value))
+      break;
+    value.get().receive(handler);
+    ++count;
+  }
+
+  if (count > 0)
+  {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (impl.has_waiters_.load(std::memory_order_relaxed))
+    {
+      ASIO_LIBNS::detail::mutex::scoped_lock lock(impl.mutex_);
+      pump(impl);
+    }
+  }
+
+  // Pick up any values that were supplied by senders that were waiting.
+  while (count < max_count
+      && receive_one(impl,
+        [&](ASIO_MOVE_ARG(payload_type) payload)
+        {
+          payload.receive(handler);
+        }))
+  {
+    ++count;
+  }
+
+  return count;
+}
+
+template <typename Traits, typename... Signatures, typename Function>
+bool concurrent_channel_service::receive_one(
+    concurrent_channel_service::implementation_type<
+      Traits, Signatures...>& impl,
+    Function f)
+{
+  typedef typename implementation_type<Traits,
+      Signatures...>::payload_type payload_type;
+
+  if (impl.closed_.load(std::memory_order_acquire))
+    return false;
+
+  // Fast path: take a buffered value without locking.
+  typename channel_ring<payload_type>::value value;
+  if (impl.ring_.try_pop(value))
+  {
+    // Pairs with the fence in start_send_op, so that either we observe the
+    // newly registered waiter, or it observes the space we have freed.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (impl.has_waiters_.load(std::memory_order_relaxed))
+    {
+      ASIO_LIBNS::detail::mutex::scoped_lock lock(impl.mutex_);
+      pump(impl);
+    }
+  }
+  else
+  {
+    ASIO_LIBNS::detail::mutex::scoped_lock lock(impl.mutex_);
+
+    if (impl.closed_.load(std::memory_order_relaxed))
+      return false;
+
+    pump(impl);
+
+    if (impl.ring_.try_pop(value))
+    {
+      pump(impl);
+    }
+    else if (impl.max_buffer_size_ == 0
+        && impl.waiters_are_senders_ && !impl.waiters_.empty())
+    {
+      // Unbuffered channel, so take the value directly from a sender.
+      channel_send<payload_type>* send_op =
+        static_cast<channel_send<payload_type>*>(impl.waiters_.front());
+      payload_type payload(send_op->get_payload());
+      impl.waiters_.pop();
+      send_op->complete();
+      update_waiters(impl);
+      lock.unlock();
+      f(ASIO_MOVE_CAST(payload_type)(payload));
+      return true;
+    }
+    else
+    {
+      return false;
+    }
+  }
+
+  f(ASIO_MOVE_CAST(payload_type)(value.get()));
+  return true;
+}
+
+template <typename Traits, typename... Signatures>
+void concurrent_channel_service::start_receive_op(
+    concurrent_channel_service::implementation_type<
+      Traits, Signatures...>& impl,
+    channel_receive<typename implementation_type<
+      Traits, Signatures...>::payload_type>* receive_op)
+{
+  typedef typename implementation_type<Traits,
+      Signatures...>::traits_type traits_type;
+  typedef typename implementation_type<Traits,
+      Signatures...>::payload_type payload_type;
+
+  ASIO_LIBNS::detail::mutex::scoped_lock lock(impl.mutex_);
+
+  if (impl.closed_.load(std::memory_order_relaxed))
+  {
+    traits_type::invoke_receive_closed(
+        complete_receive<payload_type,
+          typename traits_type::receive_closed_signature>(receive_op));
+    return;
+  }
+
+  pump(impl);
+
+  typename channel_ring<payload_type>::value value;
+  if (impl.ring_.try_pop(value))
+  {
+    receive_op->complete(ASIO_MOVE_CAST(payload_type)(value.get()));
+    pump(impl);
+    return;
+  }
+  else if (impl.max_buffer_size_ == 0
+      && impl.waiters_are_senders_ && !impl.waiters_.empty())
+  {
+    // Unbuffered channel, so take the value directly from a sender.
+    channel_send<payload_type>* send_op =
+      static_cast<channel_send<payload_type>*>(impl.waiters_.front());
+    payload_type payload(send_op->get_payload());
+    impl.waiters_.pop();
+    send_op->complete();
+    receive_op->complete(ASIO_MOVE_CAST(payload_type)(payload));
+    update_waiters(impl);
+    return;
+  }
+
+  // Wait for a value.
+  impl.waiters_.push(receive_op);
+  impl.waiters_are_senders_ = false;
+  impl.has_waiters_.store(true, std::memory_order_relaxed);
+
+  // Pairs with the fence in try_send, so that either the sender observes the
+  // waiter, or we observe the value it has added.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  pump(impl);
+}
+
+} // namespace detail
+} // namespace experimental
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // ASIO_EXPERIMENTAL_DETAIL_IMPL_CONCURRENT_CHANNEL_SERVICE_HPP
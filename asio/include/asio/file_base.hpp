@@ -62,6 +62,12 @@ public:
   /// Open the file so that write operations automatically synchronise the file
   /// data and metadata to disk.
   static const flags sync_all_on_write = implementation_defined;
+
+  /// Open the file so that reads and writes bypass the operating system's
+  /// cache. Offsets, lengths and buffer addresses must then be multiples of
+  /// the file's @c alignment(). Has no effect on platforms that do not
+  /// support direct I/O.
+  static const flags direct_io = implementation_defined;
 #else
   enum flags
   {
@@ -73,7 +79,8 @@ public:
     create = 16,
     exclusive = 32,
     truncate = 64,
-    sync_all_on_write = 128
+    sync_all_on_write = 128,
+    direct_io = 256
 #else // defined(ASIO_WINDOWS)
     read_only = O_RDONLY,
     write_only = O_WRONLY,
@@ -82,7 +89,12 @@ public:
     create = O_CREAT,
     exclusive = O_EXCL,
     truncate = O_TRUNC,
-    sync_all_on_write = O_SYNC
+    sync_all_on_write = O_SYNC,
+# if defined(O_DIRECT)
+    direct_io = O_DIRECT
+# else // defined(O_DIRECT)
+    direct_io = 0
+# endif // defined(O_DIRECT)
 #endif // defined(ASIO_WINDOWS)
   };
 
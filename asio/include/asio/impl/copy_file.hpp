@@ -0,0 +1,318 @@
+//
+// impl/copy_file.hpp
+// ~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_IMPL_COPY_FILE_HPP
+#define ASIO_IMPL_COPY_FILE_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/associator.hpp"
+#include "asio/detail/base_from_cancellation_state.hpp"
+#include "asio/detail/handler_alloc_helpers.hpp"
+#include "asio/detail/handler_cont_helpers.hpp"
+#include "asio/detail/handler_invoke_helpers.hpp"
+#include "asio/detail/handler_tracking.hpp"
+#include "asio/detail/handler_type_requirements.hpp"
+#include "asio/detail/non_const_lvalue.hpp"
+#include "asio/detail/type_traits.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace ASIO_LIBNS {
+
+namespace detail
+{
+  // The largest amount of data copied by each intermediate operation, which
+  // determines how often progress is reported and cancellation is checked.
+  enum { copy_file_chunk_size = 1024 * 1024 };
+
+  template <typename Executor1, typename Executor2,
+      typename ProgressHandler, typename CopyHandler>
+  class copy_file_op
+    : public base_from_cancellation_state<CopyHandler>
+  {
+  public:
+    copy_file_op(basic_random_access_file<Executor1>& source,
+        basic_random_access_file<Executor2>& target, uint64_t offset,
+        uint64_t length, ProgressHandler& progress, CopyHandler& handler)
+      : base_from_cancellation_state<CopyHandler>(
+          handler, enable_partial_cancellation()),
+        source_(source),
+        target_(target),
+        offset_(offset),
+        length_(length),
+        total_copied_(0),
+        start_(0),
+        progress_(ASIO_MOVE_CAST(ProgressHandler)(progress)),
+        handler_(ASIO_MOVE_CAST(CopyHandler)(handler))
+    {
+    }
+
+#if defined(ASIO_HAS_MOVE)
+    copy_file_op(const copy_file_op& other)
+      : base_from_cancellation_state<CopyHandler>(other),
+        source_(other.source_),
+        target_(other.target_),
+        offset_(other.offset_),
+        length_(other.length_),
+        total_copied_(other.total_copied_),
+        start_(other.start_),
+        progress_(other.progress_),
+        handler_(other.handler_)
+    {
+    }
+
+    copy_file_op(copy_file_op&& other)
+      : base_from_cancellation_state<CopyHandler>(
+          ASIO_MOVE_CAST(base_from_cancellation_state<
+            CopyHandler>)(other)),
+        source_(other.source_),
+        target_(other.target_),
+        offset_(other.offset_),
+        length_(other.length_),
+        total_copied_(other.total_copied_),
+        start_(other.start_),
+        progress_(ASIO_MOVE_CAST(ProgressHandler)(other.progress_)),
+        handler_(ASIO_MOVE_CAST(CopyHandler)(other.handler_))
+    {
+    }
+#endif // defined(ASIO_HAS_MOVE)
+
+    void operator()(ASIO_LIBNS::error_code ec,
+        std::size_t bytes_transferred, int start = 0)
+    {
+      switch (start_ = start)
+      {
+        case 1:
+        for (;;)
+        {
+          {
+            ASIO_HANDLER_LOCATION((__FILE__, __LINE__, "async_copy_file"));
+            source_.async_copy_some_at(offset_ + total_copied_, target_,
+                length_ - total_copied_ < copy_file_chunk_size
+                  ? static_cast<std::size_t>(length_ - total_copied_)
+                  : static_cast<std::size_t>(copy_file_chunk_size),
+                ASIO_MOVE_CAST(copy_file_op)(*this));
+          }
+          return; default:
+          total_copied_ += bytes_transferred;
+          if (bytes_transferred > 0)
+            progress_(static_cast<const uint64_t&>(total_copied_));
+          if (ec || total_copied_ == length_)
+            break;
+          if (bytes_transferred == 0)
+          {
+            ec = ASIO_LIBNS::error::eof;
+            break;
+          }
+          if (this->cancelled() != cancellation_type::none)
+          {
+            ec = ASIO_LIBNS::error::operation_aborted;
+            break;
+          }
+        }
+
+        ASIO_MOVE_OR_LVALUE(CopyHandler)(handler_)(
+            static_cast<const ASIO_LIBNS::error_code&>(ec),
+            static_cast<const uint64_t&>(total_copied_));
+      }
+    }
+
+  //private:
+    basic_random_access_file<Executor1>& source_;
+    basic_random_access_file<Executor2>& target_;
+    uint64_t offset_;
+    uint64_t length_;
+    uint64_t total_copied_;
+    int start_;
+    ProgressHandler progress_;
+    CopyHandler handler_;
+  };
+
+  template <typename Executor1, typename Executor2,
+      typename ProgressHandler, typename CopyHandler>
+  inline asio_handler_allocate_is_deprecated
+  asio_handler_allocate(std::size_t size,
+      copy_file_op<Executor1, Executor2,
+        ProgressHandler, CopyHandler>* this_handler)
+  {
+#if defined(ASIO_NO_DEPRECATED)
+    asio_handler_alloc_helpers::allocate(size, this_handler->handler_);
+    return asio_handler_allocate_is_no_longer_used();
+#else // defined(ASIO_NO_DEPRECATED)
+    return asio_handler_alloc_helpers::allocate(
+        size, this_handler->handler_);
+#endif // defined(ASIO_NO_DEPRECATED)
+  }
+
+  template <typename Executor1, typename Executor2,
+      typename ProgressHandler, typename CopyHandler>
+  inline asio_handler_deallocate_is_deprecated
+  asio_handler_deallocate(void* pointer, std::size_t size,
+      copy_file_op<Executor1, Executor2,
+        ProgressHandler, CopyHandler>* this_handler)
+  {
+    asio_handler_alloc_helpers::deallocate(
+        pointer, size, this_handler->handler_);
+#if defined(ASIO_NO_DEPRECATED)
+    return asio_handler_deallocate_is_no_longer_used();
+#endif // defined(ASIO_NO_DEPRECATED)
+  }
+
+  template <typename Executor1, typename Executor2,
+      typename ProgressHandler, typename CopyHandler>
+  inline bool asio_handler_is_continuation(
+      copy_file_op<Executor1, Executor2,
+        ProgressHandler, CopyHandler>* this_handler)
+  {
+    return this_handler->start_ == 0 ? true
+      : asio_handler_cont_helpers::is_continuation(
+          this_handler->handler_);
+  }
+
+  template <typename Function, typename Executor1, typename Executor2,
+      typename ProgressHandler, typename CopyHandler>
+  inline asio_handler_invoke_is_deprecated
+  asio_handler_invoke(Function& function,
+      copy_file_op<Executor1, Executor2,
+        ProgressHandler, CopyHandler>* this_handler)
+  {
+    asio_handler_invoke_helpers::invoke(
+        function, this_handler->handler_);
+#if defined(ASIO_NO_DEPRECATED)
+    return asio_handler_invoke_is_no_longer_used();
+#endif // defined(ASIO_NO_DEPRECATED)
+  }
+
+  template <typename Function, typename Executor1, typename Executor2,
+      typename ProgressHandler, typename CopyHandler>
+  inline asio_handler_invoke_is_deprecated
+  asio_handler_invoke(const Function& function,
+      copy_file_op<Executor1, Executor2,
+        ProgressHandler, CopyHandler>* this_handler)
+  {
+    asio_handler_invoke_helpers::invoke(
+        function, this_handler->handler_);
+#if defined(ASIO_NO_DEPRECATED)
+    return asio_handler_invoke_is_no_longer_used();
+#endif // defined(ASIO_NO_DEPRECATED)
+  }
+
+  template <typename Executor1>
+  class initiate_async_copy_file
+  {
+  public:
+    typedef Executor1 executor_type;
+
+    explicit initiate_async_copy_file(
+        basic_random_access_file<Executor1>& source)
+      : source_(source)
+    {
+    }
+
+    executor_type get_executor() const ASIO_NOEXCEPT
+    {
+      return source_.get_executor();
+    }
+
+    template <typename CopyHandler, typename Executor2,
+        typename ProgressHandler>
+    void operator()(ASIO_MOVE_ARG(CopyHandler) handler,
+        basic_random_access_file<Executor2>* target, uint64_t offset,
+        uint64_t length, ASIO_MOVE_ARG(ProgressHandler) progress) const
+    {
+      typedef typename decay<ProgressHandler>::type progress_type;
+
+      non_const_lvalue<CopyHandler> handler2(handler);
+      progress_type progress2(ASIO_MOVE_CAST(ProgressHandler)(progress));
+      copy_file_op<Executor1, Executor2, progress_type,
+        typename decay<CopyHandler>::type>(
+          source_, *target, offset, length, progress2, handler2.value)(
+            ASIO_LIBNS::error_code(), 0, 1);
+    }
+
+  private:
+    basic_random_access_file<Executor1>& source_;
+  };
+} // namespace detail
+
+#if !defined(GENERATING_DOCUMENTATION)
+
+template <template <typename, typename> class Associator,
+    typename Executor1, typename Executor2, typename ProgressHandler,
+    typename CopyHandler, typename DefaultCandidate>
+struct associator<Associator,
+    detail::copy_file_op<Executor1, Executor2, ProgressHandler, CopyHandler>,
+    DefaultCandidate>
+  : Associator<CopyHandler, DefaultCandidate>
+{
+  static typename Associator<CopyHandler, DefaultCandidate>::type get(
+      const detail::copy_file_op<Executor1, Executor2,
+        ProgressHandler, CopyHandler>& h,
+      const DefaultCandidate& c = DefaultCandidate()) ASIO_NOEXCEPT
+  {
+    return Associator<CopyHandler, DefaultCandidate>::get(h.handler_, c);
+  }
+};
+
+#endif // !defined(GENERATING_DOCUMENTATION)
+
+template <typename Executor1, typename Executor2,
+    ASIO_COMPLETION_TOKEN_FOR(void (ASIO_LIBNS::error_code,
+      uint64_t)) CopyToken>
+inline ASIO_INITFN_AUTO_RESULT_TYPE_PREFIX(CopyToken,
+    void (ASIO_LIBNS::error_code, uint64_t))
+async_copy_file(basic_random_access_file<Executor1>& source,
+    basic_random_access_file<Executor2>& target,
+    uint64_t offset, uint64_t length,
+    ASIO_MOVE_ARG(CopyToken) token)
+  ASIO_INITFN_AUTO_RESULT_TYPE_SUFFIX((
+    async_initiate<CopyToken,
+      void (ASIO_LIBNS::error_code, uint64_t)>(
+        declval<detail::initiate_async_copy_file<Executor1> >(),
+        token, &target, offset, length, detail::copy_file_no_progress())))
+{
+  return async_initiate<CopyToken,
+    void (ASIO_LIBNS::error_code, uint64_t)>(
+      detail::initiate_async_copy_file<Executor1>(source),
+      token, &target, offset, length, detail::copy_file_no_progress());
+}
+
+template <typename Executor1, typename Executor2, typename ProgressHandler,
+    ASIO_COMPLETION_TOKEN_FOR(void (ASIO_LIBNS::error_code,
+      uint64_t)) CopyToken>
+inline ASIO_INITFN_AUTO_RESULT_TYPE_PREFIX(CopyToken,
+    void (ASIO_LIBNS::error_code, uint64_t))
+async_copy_file(basic_random_access_file<Executor1>& source,
+    basic_random_access_file<Executor2>& target,
+    uint64_t offset, uint64_t length,
+    ASIO_MOVE_ARG(ProgressHandler) progress,
+    ASIO_MOVE_ARG(CopyToken) token)
+  ASIO_INITFN_AUTO_RESULT_TYPE_SUFFIX((
+    async_initiate<CopyToken,
+      void (ASIO_LIBNS::error_code, uint64_t)>(
+        declval<detail::initiate_async_copy_file<Executor1> >(),
+        token, &target, offset, length,
+        ASIO_MOVE_CAST(ProgressHandler)(progress))))
+{
+  return async_initiate<CopyToken,
+    void (ASIO_LIBNS::error_code, uint64_t)>(
+      detail::initiate_async_copy_file<Executor1>(source),
+      token, &target, offset, length,
+      ASIO_MOVE_CAST(ProgressHandler)(progress));
+}
+
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // ASIO_IMPL_COPY_FILE_HPP
@@ -22,6 +22,7 @@
 #include "asio/associator.hpp"
 #include "asio/buffer.hpp"
 #include "asio/buffers_iterator.hpp"
+#include "asio/detail/buffer_search.hpp"
 #include "asio/detail/base_from_cancellation_state.hpp"
 #include "asio/detail/bind_handler.hpp"
 #include "asio/detail/handler_alloc_helpers.hpp"
@@ -37,41 +38,6 @@
 
 namespace ASIO_LIBNS {
 
-namespace detail
-{
-  // Algorithm that finds a subsequence of equal values in a sequence. Returns
-  // (iterator,true) if a full match was found, in which case the iterator
-  // points to the beginning of the match. Returns (iterator,false) if a
-  // partial match was found at the end of the first sequence, in which case
-  // the iterator points to the beginning of the partial match. Returns
-  // (last1,false) if no full or partial match was found.
-  template <typename Iterator1, typename Iterator2>
-  std::pair<Iterator1, bool> partial_search(
-      Iterator1 first1, Iterator1 last1, Iterator2 first2, Iterator2 last2)
-  {
-    for (Iterator1 iter1 = first1; iter1 != last1; ++iter1)
-    {
-      Iterator1 test_iter1 = iter1;
-      Iterator2 test_iter2 = first2;
-      for (;; ++test_iter1, ++test_iter2)
-      {
-        if (test_iter2 == last2)
-          return std::make_pair(iter1, true);
-        if (test_iter1 == last1)
-        {
-          if (test_iter2 != first2)
-            return std::make_pair(iter1, false);
-          else
-            break;
-        }
-        if (*test_iter1 != *test_iter2)
-          break;
-      }
-    }
-    return std::make_pair(last1, false);
-  }
-} // namespace detail
-
 #if !defined(ASIO_NO_DYNAMIC_BUFFER_V1)
 
 template <typename SyncReadStream, typename DynamicBuffer_v1>
@@ -110,24 +76,23 @@ std::size_t read_until(SyncReadStream& s,
   {
     // Determine the range of the data to be searched.
     typedef typename DynamicBuffer_v1::const_buffers_type buffers_type;
-    typedef buffers_iterator<buffers_type> iterator;
     buffers_type data_buffers = b.data();
-    iterator begin = iterator::begin(data_buffers);
-    iterator start_pos = begin + search_position;
-    iterator end = iterator::end(data_buffers);
 
     // Look for a match.
-    iterator iter = std::find(start_pos, end, delim);
-    if (iter != end)
+    std::pair<std::size_t, bool> result = detail::buffer_sequence_find(
+        ASIO_LIBNS::buffer_sequence_begin(data_buffers),
+        ASIO_LIBNS::buffer_sequence_end(data_buffers),
+        search_position, delim);
+    if (result.second)
     {
       // Found a match. We're done.
       ec = ASIO_LIBNS::error_code();
-      return iter - begin + 1;
+      return result.first + 1;
     }
     else
     {
       // No match. Next search can start with the new data.
-      search_position = end - begin;
+      search_position = result.first;
     }
 
     // Check if buffer is full.
@@ -184,33 +149,24 @@ std::size_t read_until(SyncReadStream& s,
   {
     // Determine the range of the data to be searched.
     typedef typename DynamicBuffer_v1::const_buffers_type buffers_type;
-    typedef buffers_iterator<buffers_type> iterator;
     buffers_type data_buffers = b.data();
-    iterator begin = iterator::begin(data_buffers);
-    iterator start_pos = begin + search_position;
-    iterator end = iterator::end(data_buffers);
 
     // Look for a match.
-    std::pair<iterator, bool> result = detail::partial_search(
-        start_pos, end, delim.begin(), delim.end());
-    if (result.first != end)
+    std::pair<std::size_t, bool> result = detail::buffer_sequence_search(
+        ASIO_LIBNS::buffer_sequence_begin(data_buffers),
+        ASIO_LIBNS::buffer_sequence_end(data_buffers),
+        search_position, delim.data(), delim.length());
+    if (result.second)
     {
-      if (result.second)
-      {
-        // Full match. We're done.
-        ec = ASIO_LIBNS::error_code();
-        return result.first - begin + delim.length();
-      }
-      else
-      {
-        // Partial match. Next search needs to start from beginning of match.
-        search_position = result.first - begin;
-      }
+      // Full match. We're done.
+      ec = ASIO_LIBNS::error_code();
+      return result.first + delim.length();
     }
     else
     {
-      // No match. Next search can start with the new data.
-      search_position = end - begin;
+      // Partial match or no match. Next search needs to start from beginning
+      // of any partial match, or else with the new data.
+      search_position = result.first;
     }
 
     // Check if buffer is full.
@@ -509,25 +465,24 @@ std::size_t read_until(SyncReadStream& s, DynamicBuffer_v2 buffers,
   {
     // Determine the range of the data to be searched.
     typedef typename DynamicBuffer_v2::const_buffers_type buffers_type;
-    typedef buffers_iterator<buffers_type> iterator;
     buffers_type data_buffers =
       const_cast<const DynamicBuffer_v2&>(b).data(0, b.size());
-    iterator begin = iterator::begin(data_buffers);
-    iterator start_pos = begin + search_position;
-    iterator end = iterator::end(data_buffers);
 
     // Look for a match.
-    iterator iter = std::find(start_pos, end, delim);
-    if (iter != end)
+    std::pair<std::size_t, bool> result = detail::buffer_sequence_find(
+        ASIO_LIBNS::buffer_sequence_begin(data_buffers),
+        ASIO_LIBNS::buffer_sequence_end(data_buffers),
+        search_position, delim);
+    if (result.second)
     {
       // Found a match. We're done.
       ec = ASIO_LIBNS::error_code();
-      return iter - begin + 1;
+      return result.first + 1;
     }
     else
     {
       // No match. Next search can start with the new data.
-      search_position = end - begin;
+      search_position = result.first;
     }
 
     // Check if buffer is full.
@@ -578,34 +533,25 @@ std::size_t read_until(SyncReadStream& s, DynamicBuffer_v2 buffers,
   {
     // Determine the range of the data to be searched.
     typedef typename DynamicBuffer_v2::const_buffers_type buffers_type;
-    typedef buffers_iterator<buffers_type> iterator;
     buffers_type data_buffers =
       const_cast<const DynamicBuffer_v2&>(b).data(0, b.size());
-    iterator begin = iterator::begin(data_buffers);
-    iterator start_pos = begin + search_position;
-    iterator end = iterator::end(data_buffers);
 
     // Look for a match.
-    std::pair<iterator, bool> result = detail::partial_search(
-        start_pos, end, delim.begin(), delim.end());
-    if (result.first != end)
+    std::pair<std::size_t, bool> result = detail::buffer_sequence_search(
+        ASIO_LIBNS::buffer_sequence_begin(data_buffers),
+        ASIO_LIBNS::buffer_sequence_end(data_buffers),
+        search_position, delim.data(), delim.length());
+    if (result.second)
     {
-      if (result.second)
-      {
-        // Full match. We're done.
-        ec = ASIO_LIBNS::error_code();
-        return result.first - begin + delim.length();
-      }
-      else
-      {
-        // Partial match. Next search needs to start from beginning of match.
-        search_position = result.first - begin;
-      }
+      // Full match. We're done.
+      ec = ASIO_LIBNS::error_code();
+      return result.first + delim.length();
     }
     else
     {
-      // No match. Next search can start with the new data.
-      search_position = end - begin;
+      // Partial match or no match. Next search needs to start from beginning
+      // of any partial match, or else with the new data.
+      search_position = result.first;
     }
 
     // Check if buffer is full.
@@ -863,18 +809,17 @@ namespace detail
             // Determine the range of the data to be searched.
             typedef typename DynamicBuffer_v1::const_buffers_type
               buffers_type;
-            typedef buffers_iterator<buffers_type> iterator;
             buffers_type data_buffers = buffers_.data();
-            iterator begin = iterator::begin(data_buffers);
-            iterator start_pos = begin + search_position_;
-            iterator end = iterator::end(data_buffers);
 
             // Look for a match.
-            iterator iter = std::find(start_pos, end, delim_);
-            if (iter != end)
+            std::pair<std::size_t, bool> result = detail::buffer_sequence_find(
+                ASIO_LIBNS::buffer_sequence_begin(data_buffers),
+                ASIO_LIBNS::buffer_sequence_end(data_buffers),
+                search_position_, delim_);
+            if (result.second)
             {
               // Found a match. We're done.
-              search_position_ = iter - begin + 1;
+              search_position_ = result.first + 1;
               bytes_to_read = 0;
             }
 
@@ -889,7 +834,7 @@ namespace detail
             else
             {
               // Next search can start with the new data.
-              search_position_ = end - begin;
+              search_position_ = result.first;
               bytes_to_read = std::min<std::size_t>(
                     std::max<std::size_t>(512,
                       buffers_.capacity() - buffers_.size()),
@@ -1159,19 +1104,18 @@ namespace detail
             // Determine the range of the data to be searched.
             typedef typename DynamicBuffer_v1::const_buffers_type
               buffers_type;
-            typedef buffers_iterator<buffers_type> iterator;
             buffers_type data_buffers = buffers_.data();
-            iterator begin = iterator::begin(data_buffers);
-            iterator start_pos = begin + search_position_;
-            iterator end = iterator::end(data_buffers);
 
             // Look for a match.
-            std::pair<iterator, bool> result = detail::partial_search(
-                start_pos, end, delim_.begin(), delim_.end());
-            if (result.first != end && result.second)
+            std::pair<std::size_t, bool> result =
+              detail::buffer_sequence_search(
+                  ASIO_LIBNS::buffer_sequence_begin(data_buffers),
+                  ASIO_LIBNS::buffer_sequence_end(data_buffers),
+                  search_position_, delim_.data(), delim_.length());
+            if (result.second)
             {
               // Full match. We're done.
-              search_position_ = result.first - begin + delim_.length();
+              search_position_ = result.first + delim_.length();
               bytes_to_read = 0;
             }
 
@@ -1185,17 +1129,9 @@ namespace detail
             // Need to read some more data.
             else
             {
-              if (result.first != end)
-              {
-                // Partial match. Next search needs to start from beginning of
-                // match.
-                search_position_ = result.first - begin;
-              }
-              else
-              {
-                // Next search can start with the new data.
-                search_position_ = end - begin;
-              }
+              // Next search needs to start from beginning of any partial
+              // match, or else with the new data.
+              search_position_ = result.first;
 
               bytes_to_read = std::min<std::size_t>(
                     std::max<std::size_t>(512,
@@ -2179,20 +2115,19 @@ namespace detail
             // Determine the range of the data to be searched.
             typedef typename DynamicBuffer_v2::const_buffers_type
               buffers_type;
-            typedef buffers_iterator<buffers_type> iterator;
             buffers_type data_buffers =
               const_cast<const DynamicBuffer_v2&>(buffers_).data(
                   0, buffers_.size());
-            iterator begin = iterator::begin(data_buffers);
-            iterator start_pos = begin + search_position_;
-            iterator end = iterator::end(data_buffers);
 
             // Look for a match.
-            iterator iter = std::find(start_pos, end, delim_);
-            if (iter != end)
+            std::pair<std::size_t, bool> result = detail::buffer_sequence_find(
+                ASIO_LIBNS::buffer_sequence_begin(data_buffers),
+                ASIO_LIBNS::buffer_sequence_end(data_buffers),
+                search_position_, delim_);
+            if (result.second)
             {
               // Found a match. We're done.
-              search_position_ = iter - begin + 1;
+              search_position_ = result.first + 1;
               bytes_to_read_ = 0;
             }
 
@@ -2207,7 +2142,7 @@ namespace detail
             else
             {
               // Next search can start with the new data.
-              search_position_ = end - begin;
+              search_position_ = result.first;
               bytes_to_read_ = std::min<std::size_t>(
                     std::max<std::size_t>(512,
                       buffers_.capacity() - buffers_.size()),
@@ -2478,21 +2413,20 @@ namespace detail
             // Determine the range of the data to be searched.
             typedef typename DynamicBuffer_v2::const_buffers_type
               buffers_type;
-            typedef buffers_iterator<buffers_type> iterator;
             buffers_type data_buffers =
               const_cast<const DynamicBuffer_v2&>(buffers_).data(
                   0, buffers_.size());
-            iterator begin = iterator::begin(data_buffers);
-            iterator start_pos = begin + search_position_;
-            iterator end = iterator::end(data_buffers);
 
             // Look for a match.
-            std::pair<iterator, bool> result = detail::partial_search(
-                start_pos, end, delim_.begin(), delim_.end());
-            if (result.first != end && result.second)
+            std::pair<std::size_t, bool> result =
+              detail::buffer_sequence_search(
+                  ASIO_LIBNS::buffer_sequence_begin(data_buffers),
+                  ASIO_LIBNS::buffer_sequence_end(data_buffers),
+                  search_position_, delim_.data(), delim_.length());
+            if (result.second)
             {
               // Full match. We're done.
-              search_position_ = result.first - begin + delim_.length();
+              search_position_ = result.first + delim_.length();
               bytes_to_read_ = 0;
             }
 
@@ -2506,17 +2440,9 @@ namespace detail
             // Need to read some more data.
             else
             {
-              if (result.first != end)
-              {
-                // Partial match. Next search needs to start from beginning of
-                // match.
-                search_position_ = result.first - begin;
-              }
-              else
-              {
-                // Next search can start with the new data.
-                search_position_ = end - begin;
-              }
+              // Next search needs to start from beginning of any partial
+              // match, or else with the new data.
+              search_position_ = result.first;
 
               bytes_to_read_ = std::min<std::size_t>(
                     std::max<std::size_t>(512,
@@ -35,6 +35,11 @@
 #include "asio/detail/impl/buffer_sequence_adapter.ipp"
 #include "asio/detail/impl/descriptor_ops.ipp"
 #include "asio/detail/impl/dev_poll_reactor.ipp"
+#include "asio/detail/impl/dns_config.ipp"
+#include "asio/detail/impl/dns_lookup.ipp"
+#include "asio/detail/impl/dns_message.ipp"
+#include "asio/detail/impl/dns_random.ipp"
+#include "asio/detail/impl/dns_resolver_service_base.ipp"
 #include "asio/detail/impl/epoll_reactor.ipp"
 #include "asio/detail/impl/eventfd_select_interrupter.ipp"
 #include "asio/detail/impl/handler_tracking.ipp"
@@ -43,7 +48,11 @@
 #include "asio/detail/impl/io_uring_socket_service_base.ipp"
 #include "asio/detail/impl/io_uring_service.ipp"
 #include "asio/detail/impl/kqueue_reactor.ipp"
+#include "asio/detail/impl/mapped_file_service.ipp"
+#include "asio/detail/impl/mapped_region.ipp"
+#include "asio/detail/impl/mirrored_region.ipp"
 #include "asio/detail/impl/null_event.ipp"
+#include "asio/detail/impl/pattern_dfa.ipp"
 #include "asio/detail/impl/pipe_select_interrupter.ipp"
 #include "asio/detail/impl/posix_event.ipp"
 #include "asio/detail/impl/posix_mutex.ipp"
@@ -51,6 +60,7 @@
 #include "asio/detail/impl/posix_thread.ipp"
 #include "asio/detail/impl/posix_tss_ptr.ipp"
 #include "asio/detail/impl/reactive_descriptor_service.ipp"
+#include "asio/detail/impl/reactive_file_service.ipp"
 #include "asio/detail/impl/reactive_socket_service_base.ipp"
 #include "asio/detail/impl/resolver_service_base.ipp"
 #include "asio/detail/impl/scheduler.ipp"
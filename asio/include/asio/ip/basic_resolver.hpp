@@ -16,6 +16,8 @@
 #endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
 
 #include "asio/detail/config.hpp"
+#include <cstddef>
+#include <limits>
 #include <string>
 #include "asio/any_io_executor.hpp"
 #include "asio/async_result.hpp"
@@ -32,6 +34,8 @@
 #include "asio/ip/resolver_base.hpp"
 #if defined(ASIO_WINDOWS_RUNTIME)
 # include "asio/detail/winrt_resolver_service.hpp"
+#elif defined(ASIO_USE_DNS_RESOLVER) && defined(ASIO_HAS_DNS_RESOLVER)
+# include "asio/detail/dns_resolver_service.hpp"
 #else
 # include "asio/detail/resolver_service.hpp"
 #endif
@@ -59,6 +63,13 @@ class basic_resolver;
  * The basic_resolver class template provides the ability to resolve a query
  * to a list of endpoints.
  *
+ * By default, host names are resolved by calling @c getaddrinfo on a pool of
+ * private background threads. On POSIX platforms, defining
+ * @c ASIO_USE_DNS_RESOLVER instead resolves them by sending queries to the
+ * name servers listed in @c /etc/resolv.conf, using the I/O object's
+ * executor. Names listed in @c /etc/hosts are resolved without sending
+ * queries.
+ *
  * @par Thread Safety
  * @e Distinct @e objects: Safe.@n
  * @e Shared @e objects: Unsafe.
@@ -237,6 +248,88 @@ public:
     return impl_.get_service().cancel(impl_.get_implementation());
   }
 
+#if !defined(ASIO_WINDOWS_RUNTIME)
+  /// Enable caching of the results of forward resolution.
+  /**
+   * The cache is shared by all resolvers for the same protocol that use the
+   * same execution context, so enabling it on one resolver enables it for
+   * all of them. Cached results share their entries rather than copying
+   * them. While a query is being resolved, asynchronous operations for the
+   * same query wait for its results instead of starting another resolution.
+   *
+   * Calling this function discards any results already cached.
+   *
+   * @param max_entries The maximum number of queries whose results are
+   * cached.
+   *
+   * @param max_lifetime The maximum number of seconds for which results are
+   * cached. When host names are resolved by querying the name servers
+   * directly, results are not cached for longer than their time-to-live.
+   *
+   * @param negative_lifetime The maximum number of seconds for which a
+   * ASIO_LIBNS::error::host_not_found error is cached. A value of zero
+   * disables caching of errors. Other errors are never cached.
+   */
+  void enable_cache(std::size_t max_entries = 1024,
+      long max_lifetime = 300, long negative_lifetime = 30)
+  {
+    impl_.get_service().set_cache_options(
+        max_entries, max_lifetime, negative_lifetime);
+  }
+
+  /// Disable caching of the results of forward resolution.
+  /**
+   * This function disables the cache shared by all resolvers for the same
+   * protocol that use the same execution context, and discards any results
+   * already cached.
+   */
+  void disable_cache()
+  {
+    impl_.get_service().set_cache_options(0, 0, 0);
+  }
+#endif // !defined(ASIO_WINDOWS_RUNTIME)
+
+#if !defined(ASIO_WINDOWS_RUNTIME) \
+  && !(defined(ASIO_USE_DNS_RESOLVER) && defined(ASIO_HAS_DNS_RESOLVER))
+  /// The type of the counters returned by get_thread_pool_statistics().
+  typedef ASIO_LIBNS::detail::resolver_service_base::statistics
+    thread_pool_statistics;
+
+  /// Configure the threads used to perform lookups.
+  /**
+   * Lookups are performed by calling @c getaddrinfo or @c getnameinfo on a
+   * pool of worker threads, shared by all resolvers for the same protocol
+   * that use the same execution context. Threads are started as needed, up
+   * to the given maximum, and run until the execution context is shut down.
+   * By default there is a single thread and the queue is unbounded.
+   *
+   * @param max_threads The maximum number of worker threads. Reducing the
+   * maximum does not stop threads that have already started.
+   *
+   * @param max_queued The maximum number of lookups that may wait for a
+   * worker thread. An asynchronous operation started when the queue is full
+   * fails with ASIO_LIBNS::error::no_buffer_space.
+   */
+  void set_thread_pool(std::size_t max_threads,
+      std::size_t max_queued = (std::numeric_limits<std::size_t>::max)())
+  {
+    impl_.get_service().set_thread_pool(max_threads, max_queued);
+  }
+
+  /// Obtain the counters that describe the worker threads.
+  /**
+   * The counters separate the time that lookups spend waiting for a worker
+   * thread from the time spent performing them, to assist in sizing the
+   * pool. Times are measured in microseconds.
+   */
+  thread_pool_statistics get_thread_pool_statistics() const
+  {
+    return impl_.get_service().get_statistics();
+  }
+#endif // !defined(ASIO_WINDOWS_RUNTIME)
+       //   && !(defined(ASIO_USE_DNS_RESOLVER)
+       //     && defined(ASIO_HAS_DNS_RESOLVER))
+
 #if !defined(ASIO_NO_DEPRECATED)
   /// (Deprecated: Use overload with separate host and service parameters.)
   /// Perform forward resolution of a query to a list of entries.
@@ -1127,6 +1220,10 @@ private:
   ASIO_LIBNS::detail::io_object_impl<
     ASIO_LIBNS::detail::winrt_resolver_service<InternetProtocol>,
     Executor> impl_;
+# elif defined(ASIO_USE_DNS_RESOLVER) && defined(ASIO_HAS_DNS_RESOLVER)
+  ASIO_LIBNS::detail::io_object_impl<
+    ASIO_LIBNS::detail::dns_resolver_service<InternetProtocol>,
+    Executor> impl_;
 # else
   ASIO_LIBNS::detail::io_object_impl<
     ASIO_LIBNS::detail::resolver_service<InternetProtocol>,
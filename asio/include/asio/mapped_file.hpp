@@ -0,0 +1,35 @@
+//
+// mapped_file.hpp
+// ~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_MAPPED_FILE_HPP
+#define ASIO_MAPPED_FILE_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+
+#if defined(ASIO_HAS_MAPPED_FILE) \
+  || defined(GENERATING_DOCUMENTATION)
+
+#include "asio/basic_mapped_file.hpp"
+
+namespace ASIO_LIBNS {
+
+/// Typedef for the typical usage of a memory-mapped file.
+typedef basic_mapped_file<> mapped_file;
+
+} // namespace asio
+
+#endif // defined(ASIO_HAS_MAPPED_FILE)
+       //   || defined(GENERATING_DOCUMENTATION)
+
+#endif // ASIO_MAPPED_FILE_HPP
@@ -0,0 +1,183 @@
+//
+// pattern_matcher.hpp
+// ~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_PATTERN_MATCHER_HPP
+#define ASIO_PATTERN_MATCHER_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+#include "asio/detail/memory.hpp"
+#include "asio/detail/pattern_dfa.hpp"
+#include "asio/read_until.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace ASIO_LIBNS {
+
+/// A match condition that searches for any of a set of simple patterns.
+/**
+ * The pattern_matcher class is a match condition for use with
+ * ASIO_LIBNS::read_until and ASIO_LIBNS::async_read_until. The patterns are
+ * compiled into a deterministic automaton, and the matcher keeps the state of
+ * the automaton between calls. When a call finds no match, the next call
+ * continues with the bytes that follow, and so each byte read is examined
+ * only once however small the reads are.
+ *
+ * A pattern is a sequence of atoms, each optionally followed by one of the
+ * quantifiers @c ?, @c * or @c +. An atom is one of:
+ *
+ * @li A byte, which matches itself.
+ *
+ * @li @c . which matches any byte.
+ *
+ * @li A bracketed set of bytes and ranges, such as <tt>[a-z_]</tt>, or its
+ * complement, such as <tt>[^\\r\\n]</tt>.
+ *
+ * @li One of the escapes <tt>\\d</tt>, <tt>\\D</tt>, <tt>\\s</tt>,
+ * <tt>\\S</tt>, <tt>\\w</tt>, <tt>\\W</tt>, <tt>\\n</tt>, <tt>\\r</tt> or
+ * <tt>\\t</tt>, or a backslash followed by a punctuation character, which
+ * matches that character.
+ *
+ * A @c | outside of brackets separates alternative patterns. Groups, anchors
+ * and counted repetition are not supported.
+ *
+ * The matcher reports the earliest position at which a match of any pattern
+ * ends. A pattern that could match an empty string is rejected.
+ *
+ * @par Thread Safety
+ * @e Distinct @e objects: Safe.@n
+ * @e Shared @e objects: Unsafe. Copies of a matcher share the compiled
+ * automaton and the result of the last match, but not the search state.
+ * Copies must therefore not be used concurrently.
+ *
+ * Since ASIO_LIBNS::read_until and ASIO_LIBNS::async_read_until work on a copy
+ * of the match condition, sharing the result lets matched_pattern() be called
+ * on the original matcher once the operation completes. Each operation starts
+ * from the state that the original matcher had when it was passed in.
+ *
+ * @par Example
+ * To read an HTTP header block terminated by either CRLFCRLF or LFLF:
+ * @code ASIO_LIBNS::pattern_matcher end_of_headers("\r\n\r\n|\n\n");
+ * ...
+ * std::string data;
+ * std::size_t n = ASIO_LIBNS::read_until(s,
+ *     ASIO_LIBNS::dynamic_buffer(data), end_of_headers); @endcode
+ */
+class pattern_matcher
+{
+public:
+  /// Construct a matcher for a single pattern, which may contain
+  /// alternatives.
+  /**
+   * @throws std::invalid_argument Thrown if the pattern is not valid or may
+   * match an empty string.
+   *
+   * @throws std::length_error Thrown if the automaton is too large.
+   */
+  explicit pattern_matcher(const std::string& pattern)
+    : dfa_(compile(std::vector<std::string>(1, pattern))),
+      state_(dfa_->start()),
+      matched_pattern_(new std::size_t(0))
+  {
+  }
+
+  /// Construct a matcher for a set of patterns.
+  /**
+   * @throws std::invalid_argument Thrown if a pattern is not valid or may
+   * match an empty string, or if the set is empty.
+   *
+   * @throws std::length_error Thrown if the automaton is too large.
+   */
+  explicit pattern_matcher(const std::vector<std::string>& patterns)
+    : dfa_(compile(patterns)),
+      state_(dfa_->start()),
+      matched_pattern_(new std::size_t(0))
+  {
+  }
+
+  /// Search a range of bytes for the end of a match.
+  /**
+   * The range is taken to follow on from the range given to the previous
+   * call, unless that call found a match or reset() has since been called.
+   *
+   * @returns <tt>(i, true)</tt> if a match ends immediately before the
+   * iterator @c i, otherwise <tt>(end, false)</tt>.
+   */
+  template <typename Iterator>
+  std::pair<Iterator, bool> operator()(Iterator begin, Iterator end)
+  {
+    const detail::pattern_dfa& dfa = *dfa_;
+    std::size_t state = state_;
+    for (Iterator iter = begin; iter != end; )
+    {
+      state = dfa.next(state, static_cast<unsigned char>(*iter++));
+      if (std::size_t accepted = dfa.accepts(state))
+      {
+        state_ = dfa.start();
+        *matched_pattern_ = accepted - 1;
+        return std::make_pair(iter, true);
+      }
+    }
+    state_ = state;
+    return std::make_pair(end, false);
+  }
+
+  /// Get the index of the pattern that the last match was for.
+  /**
+   * The index refers to the set of patterns given to the constructor. All
+   * alternatives within one pattern have the same index. The last match may
+   * have been found by this matcher or by any copy of it.
+   */
+  std::size_t matched_pattern() const
+  {
+    return *matched_pattern_;
+  }
+
+  /// Discard any partial match so that the next search starts afresh.
+  void reset()
+  {
+    state_ = dfa_->start();
+  }
+
+private:
+  static detail::shared_ptr<const detail::pattern_dfa> compile(
+      const std::vector<std::string>& patterns)
+  {
+    return detail::shared_ptr<const detail::pattern_dfa>(
+        new detail::pattern_dfa(patterns));
+  }
+
+  detail::shared_ptr<const detail::pattern_dfa> dfa_;
+  std::size_t state_;
+  detail::shared_ptr<std::size_t> matched_pattern_;
+};
+
+#if !defined(GENERATING_DOCUMENTATION)
+
+template <>
+struct is_match_condition<pattern_matcher>
+{
+  enum { value = true };
+};
+
+#endif // !defined(GENERATING_DOCUMENTATION)
+
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // ASIO_PATTERN_MATCHER_HPP
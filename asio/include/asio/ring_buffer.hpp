@@ -0,0 +1,431 @@
+//
+// ring_buffer.hpp
+// ~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_RING_BUFFER_HPP
+#define ASIO_RING_BUFFER_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+
+#if defined(ASIO_HAS_RING_BUFFER) \
+  || defined(GENERATING_DOCUMENTATION)
+
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include "asio/buffer.hpp"
+#include "asio/detail/mirrored_region.hpp"
+#include "asio/detail/noncopyable.hpp"
+#include "asio/detail/throw_error.hpp"
+#include "asio/detail/throw_exception.hpp"
+#include "asio/error.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace ASIO_LIBNS {
+
+/// Contiguous circular storage for use as a dynamic buffer.
+/**
+ * The ring_buffer class holds a sequence of bytes in a circular region of
+ * memory that is mapped twice into adjacent address ranges. Because the second
+ * mapping continues where the first one ends, the bytes held are always
+ * contiguous in memory, no matter where in the region they start. Removing
+ * bytes from the front of the sequence and appending bytes to its end
+ * therefore never moves the bytes in between.
+ *
+ * The capacity of the region is a power of two, and is a multiple of the
+ * system's page size. The region is replaced by a larger one, and the bytes
+ * held are copied once, only when the sequence outgrows it.
+ *
+ * A ring_buffer is used with I/O operations through the dynamic_ring_buffer
+ * class, which meets the DynamicBuffer_v2 type requirements and is created
+ * with ASIO_LIBNS::dynamic_buffer().
+ *
+ * @par Thread Safety
+ * @e Distinct @e objects: Safe.@n
+ * @e Shared @e objects: Unsafe.
+ */
+class ring_buffer
+#if !defined(GENERATING_DOCUMENTATION)
+  : private noncopyable
+#endif // !defined(GENERATING_DOCUMENTATION)
+{
+public:
+  /// Construct an empty ring buffer without allocating any memory.
+  ring_buffer() ASIO_NOEXCEPT
+    : head_(0),
+      size_(0)
+  {
+  }
+
+  /// Construct an empty ring buffer with at least the specified capacity.
+  /**
+   * @throws ASIO_LIBNS::system_error Thrown on failure to map the memory.
+   */
+  explicit ring_buffer(std::size_t capacity)
+    : head_(0),
+      size_(0)
+  {
+    reserve(capacity);
+  }
+
+#if defined(ASIO_HAS_MOVE) || defined(GENERATING_DOCUMENTATION)
+  /// Move-construct a ring buffer from another.
+  /**
+   * Following the move, the moved-from object is empty and holds no memory.
+   */
+  ring_buffer(ring_buffer&& other) ASIO_NOEXCEPT
+    : head_(other.head_),
+      size_(other.size_)
+  {
+    region_.swap(other.region_);
+    other.head_ = 0;
+    other.size_ = 0;
+  }
+
+  /// Move-assign a ring buffer from another.
+  /**
+   * Following the move, the moved-from object is empty and holds no memory.
+   */
+  ring_buffer& operator=(ring_buffer&& other) ASIO_NOEXCEPT
+  {
+    detail::mirrored_region region;
+    region.swap(other.region_);
+    region_.swap(region);
+    head_ = other.head_;
+    size_ = other.size_;
+    other.head_ = 0;
+    other.size_ = 0;
+    return *this;
+  }
+#endif // defined(ASIO_HAS_MOVE) || defined(GENERATING_DOCUMENTATION)
+
+  /// Get the number of bytes held.
+  std::size_t size() const ASIO_NOEXCEPT
+  {
+    return size_;
+  }
+
+  /// Get the number of bytes that may be held without mapping a larger
+  /// region.
+  std::size_t capacity() const ASIO_NOEXCEPT
+  {
+    return region_.size();
+  }
+
+  /// Get the bytes held, as a single contiguous buffer.
+  /**
+   * @note The returned buffer is invalidated by any member function that
+   * changes the size or capacity of the ring buffer.
+   */
+  mutable_buffer data() ASIO_NOEXCEPT
+  {
+    return mutable_buffer(region_.data() + head_, size_);
+  }
+
+  /// Get the bytes held, as a single contiguous buffer.
+  /**
+   * @note The returned buffer is invalidated by any member function that
+   * changes the size or capacity of the ring buffer.
+   */
+  const_buffer data() const ASIO_NOEXCEPT
+  {
+    return const_buffer(region_.data() + head_, size_);
+  }
+
+  /// Ensure that the capacity is at least the specified number of bytes.
+  /**
+   * @throws ASIO_LIBNS::system_error Thrown on failure to map the memory.
+   * The contents of the ring buffer are unchanged.
+   */
+  void reserve(std::size_t n)
+  {
+    if (n <= region_.size())
+      return;
+
+    detail::mirrored_region region;
+    ASIO_LIBNS::error_code ec;
+    region.map(n, ec);
+    ASIO_LIBNS::detail::throw_error(ec, "ring_buffer");
+
+    if (size_ > 0)
+      std::memcpy(region.data(), region_.data() + head_, size_);
+    region_.swap(region);
+    head_ = 0;
+  }
+
+  /// Append the specified number of bytes to the end of the sequence.
+  /**
+   * The contents of the new bytes are unspecified. The capacity is increased
+   * as necessary.
+   *
+   * @throws std::length_error If the size would overflow.
+   *
+   * @throws ASIO_LIBNS::system_error Thrown on failure to map the memory.
+   */
+  void grow(std::size_t n)
+  {
+    if ((std::numeric_limits<std::size_t>::max)() - size_ < n)
+    {
+      std::length_error ex("ring_buffer too long");
+      ASIO_LIBNS::detail::throw_exception(ex);
+    }
+    reserve(size_ + n);
+    size_ += n;
+  }
+
+  /// Remove the specified number of bytes from the end of the sequence.
+  /**
+   * If @c n is greater than the size of the sequence, the sequence is
+   * emptied.
+   */
+  void shrink(std::size_t n) ASIO_NOEXCEPT
+  {
+    size_ -= (std::min)(n, size_);
+  }
+
+  /// Remove the specified number of bytes from the start of the sequence.
+  /**
+   * If @c n is greater than the size of the sequence, the sequence is
+   * emptied.
+   */
+  void consume(std::size_t n) ASIO_NOEXCEPT
+  {
+    if (n >= size_)
+    {
+      head_ = 0;
+      size_ = 0;
+    }
+    else
+    {
+      // The capacity is a power of two.
+      head_ = (head_ + n) & (region_.size() - 1);
+      size_ -= n;
+    }
+  }
+
+  /// Remove all bytes from the sequence. The capacity is unchanged.
+  void clear() ASIO_NOEXCEPT
+  {
+    head_ = 0;
+    size_ = 0;
+  }
+
+private:
+  detail::mirrored_region region_;
+  std::size_t head_;
+  std::size_t size_;
+};
+
+/// Adapt a ring_buffer to the DynamicBuffer_v2 requirements.
+/**
+ * Unlike dynamic_vector_buffer and dynamic_string_buffer, consuming bytes from
+ * the start of a dynamic_ring_buffer does not move the remaining bytes, and
+ * growing it moves them only when the underlying ring_buffer needs a larger
+ * region. Both data() overloads always return a single contiguous buffer.
+ */
+class dynamic_ring_buffer
+{
+public:
+  /// The type used to represent a sequence of constant buffers that refers to
+  /// the underlying memory.
+  typedef ASIO_CONST_BUFFER const_buffers_type;
+
+  /// The type used to represent a sequence of mutable buffers that refers to
+  /// the underlying memory.
+  typedef ASIO_MUTABLE_BUFFER mutable_buffers_type;
+
+  /// Construct a dynamic buffer from a ring buffer.
+  /**
+   * @param b The ring buffer to be used as backing storage for the dynamic
+   * buffer. The object stores a reference to the ring buffer and the user is
+   * responsible for ensuring that the ring buffer object remains valid while
+   * the dynamic_ring_buffer object, and copies of the object, are in use.
+   *
+   * @param maximum_size Specifies a maximum size for the buffer, in bytes.
+   */
+  explicit dynamic_ring_buffer(ring_buffer& b,
+      std::size_t maximum_size =
+        (std::numeric_limits<std::size_t>::max)()) ASIO_NOEXCEPT
+    : ring_(b),
+      max_size_(maximum_size)
+  {
+  }
+
+  /// @b DynamicBuffer_v2: Copy construct a dynamic buffer.
+  dynamic_ring_buffer(const dynamic_ring_buffer& other) ASIO_NOEXCEPT
+    : ring_(other.ring_),
+      max_size_(other.max_size_)
+  {
+  }
+
+#if defined(ASIO_HAS_MOVE) || defined(GENERATING_DOCUMENTATION)
+  /// Move construct a dynamic buffer.
+  dynamic_ring_buffer(dynamic_ring_buffer&& other) ASIO_NOEXCEPT
+    : ring_(other.ring_),
+      max_size_(other.max_size_)
+  {
+  }
+#endif // defined(ASIO_HAS_MOVE) || defined(GENERATING_DOCUMENTATION)
+
+  /// @b DynamicBuffer_v2: Get the current size of the underlying memory.
+  /**
+   * @returns The current size of the underlying ring buffer if less than
+   * max_size(). Otherwise returns max_size().
+   */
+  std::size_t size() const ASIO_NOEXCEPT
+  {
+    return (std::min)(ring_.size(), max_size_);
+  }
+
+  /// Get the maximum size of the dynamic buffer.
+  /**
+   * @returns The allowed maximum size of the underlying memory.
+   */
+  std::size_t max_size() const ASIO_NOEXCEPT
+  {
+    return max_size_;
+  }
+
+  /// Get the maximum size that the buffer may grow to without triggering
+  /// reallocation.
+  /**
+   * @returns The current capacity of the underlying ring buffer if less than
+   * max_size(). Otherwise returns max_size().
+   */
+  std::size_t capacity() const ASIO_NOEXCEPT
+  {
+    return (std::min)(ring_.capacity(), max_size_);
+  }
+
+  /// @b DynamicBuffer_v2: Get a sequence of buffers that represents the
+  /// underlying memory.
+  /**
+   * @param pos Position of the first byte to represent in the buffer sequence
+   *
+   * @param n The number of bytes to return in the buffer sequence. If the
+   * underlying memory is shorter, the buffer sequence represents as many bytes
+   * as are available.
+   *
+   * @returns An object of type @c mutable_buffers_type that satisfies
+   * MutableBufferSequence requirements, representing a single contiguous
+   * range of the ring buffer's memory.
+   *
+   * @note The returned object is invalidated by any @c dynamic_ring_buffer
+   * or @c ring_buffer member function that grows, shrinks or consumes the
+   * ring buffer.
+   */
+  mutable_buffers_type data(std::size_t pos, std::size_t n) ASIO_NOEXCEPT
+  {
+    return mutable_buffers_type(ASIO_LIBNS::buffer(
+          ASIO_LIBNS::buffer(ring_.data(), max_size_) + pos, n));
+  }
+
+  /// @b DynamicBuffer_v2: Get a sequence of buffers that represents the
+  /// underlying memory.
+  /**
+   * @param pos Position of the first byte to represent in the buffer sequence
+   *
+   * @param n The number of bytes to return in the buffer sequence. If the
+   * underlying memory is shorter, the buffer sequence represents as many bytes
+   * as are available.
+   *
+   * @note The returned object is invalidated by any @c dynamic_ring_buffer
+   * or @c ring_buffer member function that grows, shrinks or consumes the
+   * ring buffer.
+   */
+  const_buffers_type data(std::size_t pos,
+      std::size_t n) const ASIO_NOEXCEPT
+  {
+    const ring_buffer& ring = ring_;
+    return const_buffers_type(ASIO_LIBNS::buffer(
+          ASIO_LIBNS::buffer(ring.data(), max_size_) + pos, n));
+  }
+
+  /// @b DynamicBuffer_v2: Grow the underlying memory by the specified number of
+  /// bytes.
+  /**
+   * Appends @c n bytes to the end of the ring buffer.
+   *
+   * @throws std::length_error If <tt>size() + n > max_size()</tt>.
+   *
+   * @throws ASIO_LIBNS::system_error Thrown on failure to map the memory.
+   */
+  void grow(std::size_t n)
+  {
+    if (size() > max_size() || max_size() - size() < n)
+    {
+      std::length_error ex("dynamic_ring_buffer too long");
+      ASIO_LIBNS::detail::throw_exception(ex);
+    }
+    ring_.grow(n);
+  }
+
+  /// @b DynamicBuffer_v2: Shrink the underlying memory by the specified number
+  /// of bytes.
+  /**
+   * Removes @c n bytes from the end of the ring buffer. If @c n is greater
+   * than the current size of the ring buffer, the ring buffer is emptied.
+   */
+  void shrink(std::size_t n)
+  {
+    ring_.shrink(n);
+  }
+
+  /// @b DynamicBuffer_v2: Consume the specified number of bytes from the
+  /// beginning of the underlying memory.
+  /**
+   * Removes @c n bytes from the beginning of the ring buffer without moving
+   * the remaining bytes. If @c n is greater than the current size of the ring
+   * buffer, the ring buffer is emptied.
+   */
+  void consume(std::size_t n)
+  {
+    ring_.consume(n);
+  }
+
+private:
+  ring_buffer& ring_;
+  const std::size_t max_size_;
+};
+
+/// Create a new dynamic buffer that represents the given ring buffer.
+/**
+ * @returns <tt>dynamic_ring_buffer(data)</tt>.
+ */
+ASIO_NODISCARD inline
+dynamic_ring_buffer dynamic_buffer(ring_buffer& data) ASIO_NOEXCEPT
+{
+  return dynamic_ring_buffer(data);
+}
+
+/// Create a new dynamic buffer that represents the given ring buffer.
+/**
+ * @returns <tt>dynamic_ring_buffer(data, max_size)</tt>.
+ */
+ASIO_NODISCARD inline
+dynamic_ring_buffer dynamic_buffer(ring_buffer& data,
+    std::size_t max_size) ASIO_NOEXCEPT
+{
+  return dynamic_ring_buffer(data, max_size);
+}
+
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // defined(ASIO_HAS_RING_BUFFER)
+       //   || defined(GENERATING_DOCUMENTATION)
+
+#endif // ASIO_RING_BUFFER_HPP
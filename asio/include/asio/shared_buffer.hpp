@@ -0,0 +1,355 @@
+//
+// shared_buffer.hpp
+// ~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_SHARED_BUFFER_HPP
+#define ASIO_SHARED_BUFFER_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <vector>
+#include "asio/buffer.hpp"
+#include "asio/detail/atomic_count.hpp"
+#include "asio/detail/recycling_allocator.hpp"
+#include "asio/detail/thread_info_base.hpp"
+#include "asio/detail/type_traits.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace ASIO_LIBNS {
+namespace detail {
+
+// The header that precedes the contents of a shared buffer in memory.
+struct shared_buffer_block
+{
+  explicit shared_buffer_block(std::size_t size)
+    : ref_count_(1),
+      size_(size)
+  {
+  }
+
+  atomic_count ref_count_;
+  std::size_t size_;
+};
+
+} // namespace detail
+
+/// A reference-counted, non-modifiable buffer.
+/**
+ * The shared_buffer class owns a single block of memory that is shared by all
+ * copies of the object. Copying a shared_buffer only increments a reference
+ * count, so one payload may be passed to many asynchronous operations without
+ * being copied. The memory is released when the last copy is destroyed.
+ *
+ * Memory is obtained through the calling thread's recycling allocator, so
+ * blocks of a few hundred bytes that are released on a thread running an
+ * io_context are reused by the next buffer created on that thread.
+ *
+ * The class meets the ConstBufferSequence type requirements.
+ *
+ * @par Thread Safety
+ * @e Distinct @e objects: Safe.@n
+ * @e Shared @e objects: Unsafe. Distinct copies that share the same memory
+ * may be used and destroyed concurrently.
+ */
+class shared_buffer
+{
+public:
+  /// The type for each element in the list of buffers.
+  typedef const_buffer value_type;
+
+  /// A random-access iterator type that may be used to read elements.
+  typedef const const_buffer* const_iterator;
+
+  /// Construct an empty buffer.
+  shared_buffer() ASIO_NOEXCEPT
+    : block_(0)
+  {
+  }
+
+  /// Construct a buffer of the specified size.
+  /**
+   * The contents of the buffer are uninitialised. Use mutable_data() to fill
+   * them before the buffer is shared.
+   */
+  explicit shared_buffer(std::size_t size)
+    : block_(allocate(size)),
+      buffer_(contents(block_), size)
+  {
+  }
+
+  /// Construct a buffer that holds a copy of the specified memory.
+  shared_buffer(const void* data, std::size_t size)
+    : block_(allocate(size)),
+      buffer_(contents(block_), size)
+  {
+    if (size > 0)
+      std::memcpy(contents(block_), data, size);
+  }
+
+  /// Construct a buffer that holds a copy of the contents of a buffer
+  /// sequence.
+  template <typename ConstBufferSequence>
+  explicit shared_buffer(const ConstBufferSequence& buffers,
+      typename constraint<
+        is_const_buffer_sequence<ConstBufferSequence>::value
+      >::type = 0)
+    : block_(allocate(ASIO_LIBNS::buffer_size(buffers))),
+      buffer_(contents(block_), ASIO_LIBNS::buffer_size(buffers))
+  {
+    ASIO_LIBNS::buffer_copy(mutable_data(), buffers);
+  }
+
+  /// Copy constructor. The new object shares the memory of @c other.
+  shared_buffer(const shared_buffer& other) ASIO_NOEXCEPT
+    : block_(other.block_),
+      buffer_(other.buffer_)
+  {
+    if (block_)
+      detail::ref_count_up(block_->ref_count_);
+  }
+
+#if defined(ASIO_HAS_MOVE) || defined(GENERATING_DOCUMENTATION)
+  /// Move constructor.
+  shared_buffer(shared_buffer&& other) ASIO_NOEXCEPT
+    : block_(other.block_),
+      buffer_(other.buffer_)
+  {
+    other.block_ = 0;
+    other.buffer_ = const_buffer();
+  }
+#endif // defined(ASIO_HAS_MOVE) || defined(GENERATING_DOCUMENTATION)
+
+  /// Destructor. Releases the memory if this is the last copy.
+  ~shared_buffer()
+  {
+    release(block_);
+  }
+
+  /// Copy assignment. The object shares the memory of @c other.
+  shared_buffer& operator=(const shared_buffer& other) ASIO_NOEXCEPT
+  {
+    if (other.block_)
+      detail::ref_count_up(other.block_->ref_count_);
+    release(block_);
+    block_ = other.block_;
+    buffer_ = other.buffer_;
+    return *this;
+  }
+
+#if defined(ASIO_HAS_MOVE) || defined(GENERATING_DOCUMENTATION)
+  /// Move assignment.
+  shared_buffer& operator=(shared_buffer&& other) ASIO_NOEXCEPT
+  {
+    if (this != &other)
+    {
+      release(block_);
+      block_ = other.block_;
+      buffer_ = other.buffer_;
+      other.block_ = 0;
+      other.buffer_ = const_buffer();
+    }
+    return *this;
+  }
+#endif // defined(ASIO_HAS_MOVE) || defined(GENERATING_DOCUMENTATION)
+
+  /// Get a random-access iterator to the first element.
+  const_iterator begin() const ASIO_NOEXCEPT
+  {
+    return &buffer_;
+  }
+
+  /// Get a random-access iterator for one past the last element.
+  const_iterator end() const ASIO_NOEXCEPT
+  {
+    return &buffer_ + 1;
+  }
+
+  /// Get the contents of the buffer.
+  const_buffer data() const ASIO_NOEXCEPT
+  {
+    return buffer_;
+  }
+
+  /// Get modifiable access to the contents of the buffer.
+  /**
+   * This function is intended for filling a newly constructed buffer. The
+   * contents must not be modified once copies of the buffer have been passed
+   * to asynchronous operations.
+   */
+  mutable_buffer mutable_data() const ASIO_NOEXCEPT
+  {
+    return mutable_buffer(const_cast<void*>(buffer_.data()), buffer_.size());
+  }
+
+  /// Get the size of the buffer.
+  std::size_t size() const ASIO_NOEXCEPT
+  {
+    return buffer_.size();
+  }
+
+  /// Get the number of copies that share the buffer's memory.
+  long use_count() const ASIO_NOEXCEPT
+  {
+    return block_ ? static_cast<long>(block_->ref_count_) : 0;
+  }
+
+  /// Convert to a single non-modifiable buffer.
+  operator const_buffer() const ASIO_NOEXCEPT
+  {
+    return buffer_;
+  }
+
+private:
+  typedef detail::recycling_allocator<detail::shared_buffer_block,
+    detail::thread_info_base::shared_buffer_tag> allocator_type;
+
+  // Get the number of blocks needed to hold the header and the contents.
+  static std::size_t block_count(std::size_t size)
+  {
+    return 1 + (size + sizeof(detail::shared_buffer_block) - 1)
+      / sizeof(detail::shared_buffer_block);
+  }
+
+  static detail::shared_buffer_block* allocate(std::size_t size)
+  {
+    if (size == 0)
+      return 0;
+    void* p = allocator_type().allocate(block_count(size));
+    return new (p) detail::shared_buffer_block(size);
+  }
+
+  static void release(detail::shared_buffer_block* block)
+  {
+    if (block && detail::ref_count_down(block->ref_count_))
+    {
+      std::size_t count = block_count(block->size_);
+      block->~shared_buffer_block();
+      allocator_type().deallocate(block, count);
+    }
+  }
+
+  static void* contents(detail::shared_buffer_block* block)
+  {
+    return block + 1;
+  }
+
+  detail::shared_buffer_block* block_;
+  const_buffer buffer_;
+};
+
+/// A sequence of reference-counted, non-modifiable buffers.
+/**
+ * The shared_buffer_chain class holds shared_buffer objects that together
+ * form one message, such as a header and a body, so that the whole message
+ * may be sent with a single gather-write operation. Copying the chain copies
+ * only the references to the buffers it holds.
+ *
+ * The class meets the ConstBufferSequence type requirements.
+ *
+ * @par Thread Safety
+ * @e Distinct @e objects: Safe.@n
+ * @e Shared @e objects: Unsafe.
+ */
+class shared_buffer_chain
+{
+public:
+  /// The type for each element in the list of buffers.
+  typedef const_buffer value_type;
+
+  /// A random-access iterator type that may be used to read elements. The
+  /// iterator's elements are shared_buffer objects, which are convertible to
+  /// const_buffer.
+  typedef std::vector<shared_buffer>::const_iterator const_iterator;
+
+  /// Construct an empty chain.
+  shared_buffer_chain()
+  {
+  }
+
+  /// Construct a chain that holds a single buffer.
+  explicit shared_buffer_chain(const shared_buffer& b)
+    : buffers_(1, b)
+  {
+  }
+
+  /// Add a buffer to the end of the chain.
+  void push_back(const shared_buffer& b)
+  {
+    buffers_.push_back(b);
+  }
+
+#if defined(ASIO_HAS_MOVE) || defined(GENERATING_DOCUMENTATION)
+  /// Add a buffer to the end of the chain.
+  void push_back(shared_buffer&& b)
+  {
+    buffers_.push_back(ASIO_MOVE_CAST(shared_buffer)(b));
+  }
+#endif // defined(ASIO_HAS_MOVE) || defined(GENERATING_DOCUMENTATION)
+
+  /// Remove all buffers from the chain.
+  void clear() ASIO_NOEXCEPT
+  {
+    buffers_.clear();
+  }
+
+  /// Reserve space for the specified number of buffers.
+  void reserve(std::size_t n)
+  {
+    buffers_.reserve(n);
+  }
+
+  /// Get a random-access iterator to the first element.
+  const_iterator begin() const ASIO_NOEXCEPT
+  {
+    return buffers_.begin();
+  }
+
+  /// Get a random-access iterator for one past the last element.
+  const_iterator end() const ASIO_NOEXCEPT
+  {
+    return buffers_.end();
+  }
+
+  /// Get the number of buffers in the chain.
+  std::size_t count() const ASIO_NOEXCEPT
+  {
+    return buffers_.size();
+  }
+
+  /// Determine whether the chain holds no buffers.
+  bool empty() const ASIO_NOEXCEPT
+  {
+    return buffers_.empty();
+  }
+
+  /// Get the total size of the buffers in the chain.
+  std::size_t size() const ASIO_NOEXCEPT
+  {
+    std::size_t total = 0;
+    for (const_iterator i = buffers_.begin(); i != buffers_.end(); ++i)
+      total += i->size();
+    return total;
+  }
+
+private:
+  std::vector<shared_buffer> buffers_;
+};
+
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // ASIO_SHARED_BUFFER_HPP
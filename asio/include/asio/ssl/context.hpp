@@ -24,6 +24,7 @@
 #include "asio/ssl/detail/openssl_types.hpp"
 #include "asio/ssl/detail/openssl_init.hpp"
 #include "asio/ssl/detail/password_callback.hpp"
+#include "asio/ssl/detail/session_cache.hpp"
 #include "asio/ssl/detail/verify_callback.hpp"
 #include "asio/ssl/verify_mode.hpp"
 
@@ -40,6 +41,24 @@ public:
   /// The native handle type of the SSL context.
   typedef SSL_CTX* native_handle_type;
 
+  /// Counters describing how often handshakes resumed a session.
+  /**
+   * The @c client_hits and @c client_misses members count client handshakes
+   * on streams that have a session cache key. The @c server_hits and
+   * @c server_misses members count all server handshakes.
+   */
+#if defined(GENERATING_DOCUMENTATION)
+  struct session_statistics
+  {
+    std::size_t client_hits;
+    std::size_t client_misses;
+    std::size_t server_hits;
+    std::size_t server_misses;
+  };
+#else // defined(GENERATING_DOCUMENTATION)
+  typedef detail::session_statistics session_statistics;
+#endif // defined(GENERATING_DOCUMENTATION)
+
   /// Constructor.
   ASIO_DECL explicit context(method m);
 
@@ -670,6 +689,114 @@ public:
   ASIO_DECL ASIO_SYNC_OP_VOID use_tmp_dh_file(
       const std::string& filename, ASIO_LIBNS::error_code& ec);
 
+  /// Enable caching of sessions for resumption.
+  /**
+   * This function enables a thread-safe, size-bounded session cache shared by
+   * all streams that use the context. On the client side, sessions are cached
+   * under the host and port given to ssl::stream::set_session_cache_key(),
+   * and are offered when a later stream uses the same key. On the server
+   * side, OpenSSL's internal session cache is used.
+   *
+   * @param max_sessions The maximum number of sessions to cache. A value of
+   * zero disables the cache.
+   *
+   * @throws ASIO_LIBNS::system_error Thrown on failure.
+   *
+   * @note Calls @c SSL_CTX_set_session_cache_mode, @c
+   * SSL_CTX_sess_set_cache_size and @c SSL_CTX_sess_set_new_cb. A new session
+   * callback installed before this function is called continues to be called
+   * for every new session.
+   */
+  ASIO_DECL void enable_session_cache(std::size_t max_sessions);
+
+  /// Enable caching of sessions for resumption.
+  /**
+   * This function enables a thread-safe, size-bounded session cache shared by
+   * all streams that use the context. On the client side, sessions are cached
+   * under the host and port given to ssl::stream::set_session_cache_key(),
+   * and are offered when a later stream uses the same key. On the server
+   * side, OpenSSL's internal session cache is used.
+   *
+   * @param max_sessions The maximum number of sessions to cache. A value of
+   * zero disables the cache.
+   *
+   * @param ec Set to indicate what error occurred, if any.
+   *
+   * @note Calls @c SSL_CTX_set_session_cache_mode, @c
+   * SSL_CTX_sess_set_cache_size and @c SSL_CTX_sess_set_new_cb. A new session
+   * callback installed before this function is called continues to be called
+   * for every new session.
+   */
+  ASIO_DECL ASIO_SYNC_OP_VOID enable_session_cache(
+      std::size_t max_sessions, ASIO_LIBNS::error_code& ec);
+
+  /// Enable session tickets with automatically rotated keys.
+  /**
+   * This function makes a server issue session tickets encrypted with keys
+   * that are managed by the context. A new key is generated when the current
+   * one has been in use for the given lifetime. Tickets issued with the
+   * previous key are still accepted, and are replaced with new tickets, until
+   * that key is two lifetimes old.
+   *
+   * @param key_lifetime The number of seconds for which a key is used to
+   * issue tickets. A value of zero disables automatic rotation.
+   *
+   * @throws ASIO_LIBNS::system_error Thrown on failure.
+   *
+   * @note Calls @c SSL_CTX_set_tlsext_ticket_key_evp_cb, or @c
+   * SSL_CTX_set_tlsext_ticket_key_cb for OpenSSL versions before 3.0.
+   */
+  ASIO_DECL void enable_session_tickets(long key_lifetime = 3600);
+
+  /// Enable session tickets with automatically rotated keys.
+  /**
+   * This function makes a server issue session tickets encrypted with keys
+   * that are managed by the context. A new key is generated when the current
+   * one has been in use for the given lifetime. Tickets issued with the
+   * previous key are still accepted, and are replaced with new tickets, until
+   * that key is two lifetimes old.
+   *
+   * @param key_lifetime The number of seconds for which a key is used to
+   * issue tickets. A value of zero disables automatic rotation.
+   *
+   * @param ec Set to indicate what error occurred, if any.
+   *
+   * @note Calls @c SSL_CTX_set_tlsext_ticket_key_evp_cb, or @c
+   * SSL_CTX_set_tlsext_ticket_key_cb for OpenSSL versions before 3.0.
+   */
+  ASIO_DECL ASIO_SYNC_OP_VOID enable_session_tickets(
+      long key_lifetime, ASIO_LIBNS::error_code& ec);
+
+  /// Rotate the session ticket keys.
+  /**
+   * This function replaces the key used to issue session tickets with a new,
+   * randomly generated key. Tickets issued with the previous key are still
+   * accepted. Session tickets must have been enabled using
+   * enable_session_tickets().
+   *
+   * @throws ASIO_LIBNS::system_error Thrown on failure.
+   */
+  ASIO_DECL void rotate_session_ticket_keys();
+
+  /// Rotate the session ticket keys.
+  /**
+   * This function replaces the key used to issue session tickets with a new,
+   * randomly generated key. Tickets issued with the previous key are still
+   * accepted. Session tickets must have been enabled using
+   * enable_session_tickets().
+   *
+   * @param ec Set to indicate what error occurred, if any.
+   */
+  ASIO_DECL ASIO_SYNC_OP_VOID rotate_session_ticket_keys(
+      ASIO_LIBNS::error_code& ec);
+
+  /// Get the session resumption counters.
+  /**
+   * @returns The number of handshakes, since the session cache or session
+   * tickets were enabled, that did and did not resume a session.
+   */
+  ASIO_DECL session_statistics get_session_statistics() const;
+
   /// Set the password callback.
   /**
    * This function is used to specify a callback function to obtain password
@@ -0,0 +1,128 @@
+//
+// ssl/detail/buffer_bio.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_SSL_DETAIL_BUFFER_BIO_HPP
+#define ASIO_SSL_DETAIL_BUFFER_BIO_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+
+#include <vector>
+#include "asio/buffer.hpp"
+#include "asio/detail/noncopyable.hpp"
+#include "asio/ssl/detail/buffer_pool.hpp"
+#include "asio/ssl/detail/openssl_types.hpp"
+
+#if (OPENSSL_VERSION_NUMBER >= 0x10100000L) \
+  && !defined(LIBRESSL_VERSION_NUMBER) \
+  && !defined(ASIO_USE_WOLFSSL)
+# define ASIO_SSL_HAS_BUFFER_BIO 1
+#endif // (OPENSSL_VERSION_NUMBER >= 0x10100000L) ...
+
+#if defined(ASIO_SSL_HAS_BUFFER_BIO)
+
+#include "asio/detail/push_options.hpp"
+
+namespace ASIO_LIBNS {
+namespace ssl {
+namespace detail {
+
+// A BIO that passes ciphertext between OpenSSL and the stream's transport
+// without the extra copy made by a BIO pair. Input is read by OpenSSL directly
+// from the buffer filled by the transport, and output records are written
+// into a buffer that is handed to the transport as-is.
+class buffer_bio
+  : private ASIO_LIBNS::detail::noncopyable
+{
+public:
+  // The amount of input that may be copied in, and of output that may be
+  // staged. Sufficient to hold the largest possible TLS record.
+  enum { capacity = buffer_pool::buffer_size };
+
+  // Create a new BIO. The BIO owns the buffer_bio object, which is destroyed
+  // when the BIO is freed. Returns 0 on failure.
+  ASIO_DECL static BIO* create(buffer_bio** state);
+
+  // Make the given data available to OpenSSL without copying it. The data
+  // must remain valid until OpenSSL has consumed it, which is guaranteed when
+  // OpenSSL next asks for more input. Returns the portion not accepted.
+  ASIO_DECL ASIO_LIBNS::const_buffer attach_input(
+      const ASIO_LIBNS::const_buffer& data);
+
+  // Copy the given data into the BIO's own input storage. Returns the portion
+  // not accepted.
+  ASIO_DECL ASIO_LIBNS::const_buffer copy_input(
+      const ASIO_LIBNS::const_buffer& data);
+
+  // Get the amount of input that OpenSSL has not yet consumed.
+  std::size_t input_pending() const
+  {
+    return (copied_input_.size() - copied_input_pos_) + attached_input_size_;
+  }
+
+  // Take all output written by OpenSSL since the last call. The output handed
+  // out by the previous call is assumed to have been written to the
+  // transport, and its space is reclaimed.
+  ASIO_DECL ASIO_LIBNS::mutable_buffer take_output();
+
+  // Get the amount of output that has not yet been taken.
+  std::size_t output_pending() const
+  {
+    return output_size_ - output_taken_;
+  }
+
+  // Return the output storage to the buffer pool if all output has been
+  // taken, and free the copied input storage if it has been consumed. Must
+  // not be called while output handed out by take_output is still in use.
+  ASIO_DECL void release_storage();
+
+private:
+  buffer_bio();
+  ~buffer_bio();
+
+  ASIO_DECL static BIO_METHOD* method();
+  ASIO_DECL static int bio_create(BIO* b);
+  ASIO_DECL static int bio_destroy(BIO* b);
+  ASIO_DECL static int bio_read(BIO* b, char* data, int length);
+  ASIO_DECL static int bio_write(BIO* b, const char* data, int length);
+  ASIO_DECL static long bio_ctrl(BIO* b, int cmd, long num, void* ptr);
+
+  // Input copied in by copy_input, and the offset of the next byte to read.
+  std::vector<unsigned char> copied_input_;
+  std::size_t copied_input_pos_;
+
+  // Input attached by attach_input. Consumed after any copied input.
+  const unsigned char* attached_input_;
+  std::size_t attached_input_size_;
+
+  // Output staged for the transport, in storage taken from the buffer pool
+  // when first needed. The first output_taken_ bytes have been handed out by
+  // take_output.
+  unsigned char* output_;
+  std::size_t output_size_;
+  std::size_t output_taken_;
+};
+
+} // namespace detail
+} // namespace ssl
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#if defined(ASIO_HEADER_ONLY)
+# include "asio/ssl/detail/impl/buffer_bio.ipp"
+#endif // defined(ASIO_HEADER_ONLY)
+
+#endif // defined(ASIO_SSL_HAS_BUFFER_BIO)
+
+#endif // ASIO_SSL_DETAIL_BUFFER_BIO_HPP
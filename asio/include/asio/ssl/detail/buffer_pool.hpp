@@ -0,0 +1,80 @@
+//
+// ssl/detail/buffer_pool.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_SSL_DETAIL_BUFFER_POOL_HPP
+#define ASIO_SSL_DETAIL_BUFFER_POOL_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+
+#include <cstddef>
+#include <vector>
+#include "asio/detail/mutex.hpp"
+#include "asio/detail/noncopyable.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+#ifndef ASIO_SSL_BUFFER_POOL_SIZE
+# define ASIO_SSL_BUFFER_POOL_SIZE 256
+#endif // ASIO_SSL_BUFFER_POOL_SIZE
+
+namespace ASIO_LIBNS {
+namespace ssl {
+namespace detail {
+
+// A process-wide pool of the buffers used to hold TLS records. Streams take
+// buffers from the pool when they have data to process and return them when
+// they are idle, so that idle streams do not hold buffer memory. Up to
+// ASIO_SSL_BUFFER_POOL_SIZE returned buffers are kept for reuse.
+class buffer_pool
+  : private ASIO_LIBNS::detail::noncopyable
+{
+public:
+  // The size of each buffer. Sufficient to hold the largest possible TLS
+  // record.
+  enum { buffer_size = 17 * 1024 };
+
+  // Get a buffer of buffer_size bytes. Throws std::bad_alloc on failure.
+  ASIO_DECL static unsigned char* allocate();
+
+  // Return a buffer obtained from allocate().
+  ASIO_DECL static void deallocate(unsigned char* p);
+
+  // Get the number of free buffers held for reuse.
+  ASIO_DECL static std::size_t available();
+
+private:
+  buffer_pool();
+
+  // Get the pool. The pool is never destroyed, so that buffers may be returned
+  // to it during static destruction.
+  ASIO_DECL static buffer_pool& instance();
+
+  // Protects the list of free buffers.
+  ASIO_LIBNS::detail::mutex mutex_;
+
+  // Buffers available for reuse.
+  std::vector<unsigned char*> free_buffers_;
+};
+
+} // namespace detail
+} // namespace ssl
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#if defined(ASIO_HEADER_ONLY)
+# include "asio/ssl/detail/impl/buffer_pool.ipp"
+#endif // defined(ASIO_HEADER_ONLY)
+
+#endif // ASIO_SSL_DETAIL_BUFFER_POOL_HPP
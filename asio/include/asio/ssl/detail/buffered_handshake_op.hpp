@@ -17,6 +17,7 @@
 
 #include "asio/detail/config.hpp"
 
+#include "asio/error.hpp"
 #include "asio/ssl/detail/engine.hpp"
 
 #include "asio/detail/push_options.hpp"
@@ -34,6 +35,11 @@ public:
     return "ssl::stream<>::async_buffered_handshake";
   }
 
+  static ASIO_CONSTEXPR bool offloadable()
+  {
+    return true;
+  }
+
   buffered_handshake_op(stream_base::handshake_type type,
       const ConstBufferSequence& buffers)
     : type_(type),
@@ -66,6 +72,13 @@ private:
       std::size_t& bytes_transferred,
       Iterator begin, Iterator end) const
   {
+    // An engine doing its own socket I/O has no way to accept buffered data.
+    if (eng.uses_native_socket() && total_buffer_size_ != 0)
+    {
+      ec = ASIO_LIBNS::error::operation_not_supported;
+      return engine::want_nothing;
+    }
+
     Iterator iter = begin;
     std::size_t accumulated_size = 0;
 
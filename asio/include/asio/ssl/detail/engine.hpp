@@ -18,8 +18,11 @@
 #include "asio/detail/config.hpp"
 
 #include "asio/buffer.hpp"
+#include "asio/detail/cstdint.hpp"
 #include "asio/detail/static_mutex.hpp"
+#include "asio/ssl/detail/buffer_bio.hpp"
 #include "asio/ssl/detail/openssl_types.hpp"
+#include "asio/ssl/detail/session_cache.hpp"
 #include "asio/ssl/detail/verify_callback.hpp"
 #include "asio/ssl/stream_base.hpp"
 #include "asio/ssl/verify_mode.hpp"
@@ -55,6 +58,14 @@ public:
     want_output = 1
   };
 
+  // The largest amount of data that fits in a single TLS record.
+  enum { max_record_size = 16 * 1024 };
+
+  // The record size used at the start of a connection, and after it has been
+  // idle, when dynamic record sizing is enabled. Records of this size fit in a
+  // single TCP segment, so that the peer can process each one on arrival.
+  enum { small_record_size = 1369 };
+
   // Construct a new engine for the specified context.
   ASIO_DECL explicit engine(SSL_CTX* context);
 
@@ -89,6 +100,12 @@ public:
   ASIO_DECL ASIO_LIBNS::error_code set_verify_callback(
       verify_callback_base* callback, ASIO_LIBNS::error_code& ec);
 
+  // Set the host and port under which a client session is cached, and offer
+  // any session already cached for them.
+  ASIO_DECL ASIO_LIBNS::error_code set_session_cache_key(
+      const std::string& host, unsigned short port,
+      ASIO_LIBNS::error_code& ec);
+
   // Perform an SSL handshake using either SSL_connect (client-side) or
   // SSL_accept (server-side).
   ASIO_DECL want handshake(
@@ -97,7 +114,15 @@ public:
   // Perform a graceful shutdown of the SSL session.
   ASIO_DECL want shutdown(ASIO_LIBNS::error_code& ec);
 
-  // Write bytes to the SSL session.
+  // Enable or disable dynamic record sizing for writes.
+  ASIO_DECL void set_dynamic_record_sizing(bool enabled);
+
+  // Get the amount of data that the next call to write() will put into a
+  // single record.
+  ASIO_DECL std::size_t next_record_size() const;
+
+  // Write bytes to the SSL session. At most next_record_size() bytes are
+  // written by each call.
   ASIO_DECL want write(const ASIO_LIBNS::const_buffer& data,
       ASIO_LIBNS::error_code& ec, std::size_t& bytes_transferred);
 
@@ -109,16 +134,50 @@ public:
   ASIO_DECL ASIO_LIBNS::mutable_buffer get_output(
       const ASIO_LIBNS::mutable_buffer& data);
 
-  // Put input data that was read from the transport.
+  // Put input data that was read from the transport. The data is copied.
   ASIO_DECL ASIO_LIBNS::const_buffer put_input(
       const ASIO_LIBNS::const_buffer& data);
 
+  // Put input data that was read from the transport, without copying it if
+  // possible. The data must remain valid until the engine next wants input.
+  ASIO_DECL ASIO_LIBNS::const_buffer attach_input(
+      const ASIO_LIBNS::const_buffer& data);
+
+  // Whether get_output returns data staged by the engine itself, in which case
+  // the buffer passed to get_output is not used.
+  ASIO_DECL bool stages_output() const;
+
+  // Get the amount of input that has been put or attached but not yet
+  // consumed by the SSL session.
+  ASIO_DECL std::size_t input_pending() const;
+
+  // Release the engine's buffer storage if it is idle. Must not be called
+  // while output returned by get_output is still in use.
+  ASIO_DECL void release_buffers();
+
   // Map an error::eof code returned by the underlying transport according to
   // the type and state of the SSL session. Returns a const reference to the
   // error code object, suitable for passing to a completion handler.
   ASIO_DECL const ASIO_LIBNS::error_code& map_error_code(
       ASIO_LIBNS::error_code& ec) const;
 
+  // Make the engine perform its own I/O on the given native socket, with
+  // kernel TLS enabled, instead of using the get_output/put_input buffers.
+  // Must be called before the handshake.
+  ASIO_DECL ASIO_LIBNS::error_code use_native_socket(
+      int fd, ASIO_LIBNS::error_code& ec);
+
+  // Whether the engine performs its own I/O on a native socket. When it does,
+  // want_input_and_retry and want_output_and_retry mean that the caller must
+  // wait for the socket to become readable or writable, respectively.
+  ASIO_DECL bool uses_native_socket() const;
+
+  // Whether record encryption for sending has been offloaded to the kernel.
+  ASIO_DECL bool ktls_send() const;
+
+  // Whether record decryption for receiving has been offloaded to the kernel.
+  ASIO_DECL bool ktls_receive() const;
+
 private:
   // Disallow copying and assignment.
   engine(const engine&);
@@ -134,6 +193,12 @@ private:
   ASIO_DECL static ASIO_LIBNS::detail::static_mutex& accept_mutex();
 #endif // (OPENSSL_VERSION_NUMBER < 0x10000000L)
 
+  // Set up the BIO used to exchange data with the transport.
+  ASIO_DECL void init_bio();
+
+  // Get the amount of output that has not yet been taken by get_output.
+  ASIO_DECL std::size_t output_pending() const;
+
   // Perform one operation. Returns >= 0 on success or error, want_read if the
   // operation needs more input, or want_write if it needs to write some output
   // before the operation can complete.
@@ -157,7 +222,24 @@ private:
   ASIO_DECL int do_write(void* data, std::size_t length);
 
   SSL* ssl_;
+
+  // The external end of the BIO pair, if one is used.
   BIO* ext_bio_;
+
+#if defined(ASIO_SSL_HAS_BUFFER_BIO)
+  // The state of the buffer BIO, if one is used. Owned by the SSL's BIO.
+  buffer_bio* buffer_bio_;
+#endif // defined(ASIO_SSL_HAS_BUFFER_BIO)
+
+  // Dynamic record sizing state: whether it is enabled, the number of small
+  // records written since the connection started or was last idle, and the
+  // time in milliseconds of the last write.
+  bool dynamic_record_sizing_;
+  std::size_t small_records_written_;
+  ASIO_LIBNS::uint64_t last_write_time_;
+
+  // The length of a write that must be retried with the same length.
+  std::size_t write_retry_length_;
 };
 
 } // namespace detail
@@ -33,6 +33,11 @@ public:
     return "ssl::stream<>::async_handshake";
   }
 
+  static ASIO_CONSTEXPR bool offloadable()
+  {
+    return true;
+  }
+
   handshake_op(stream_base::handshake_type type)
     : type_(type)
   {
@@ -0,0 +1,261 @@
+//
+// ssl/detail/impl/buffer_bio.ipp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_SSL_DETAIL_IMPL_BUFFER_BIO_IPP
+#define ASIO_SSL_DETAIL_IMPL_BUFFER_BIO_IPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+#include <cstring>
+#include "asio/ssl/detail/buffer_bio.hpp"
+
+#if defined(ASIO_SSL_HAS_BUFFER_BIO)
+
+#include "asio/detail/push_options.hpp"
+
+namespace ASIO_LIBNS {
+namespace ssl {
+namespace detail {
+
+buffer_bio::buffer_bio()
+  : copied_input_pos_(0),
+    attached_input_(0),
+    attached_input_size_(0),
+    output_(0),
+    output_size_(0),
+    output_taken_(0)
+{
+}
+
+buffer_bio::~buffer_bio()
+{
+  buffer_pool::deallocate(output_);
+}
+
+BIO* buffer_bio::create(buffer_bio** state)
+{
+  BIO_METHOD* m = method();
+  if (!m)
+    return 0;
+
+  BIO* b = ::BIO_new(m);
+  if (b && state)
+    *state = static_cast<buffer_bio*>(::BIO_get_data(b));
+  return b;
+}
+
+ASIO_LIBNS::const_buffer buffer_bio::attach_input(
+    const ASIO_LIBNS::const_buffer& data)
+{
+  if (input_pending() != 0)
+    return data;
+
+  attached_input_ = static_cast<const unsigned char*>(data.data());
+  attached_input_size_ = data.size();
+  return ASIO_LIBNS::const_buffer(
+      static_cast<const unsigned char*>(data.data()) + data.size(), 0);
+}
+
+ASIO_LIBNS::const_buffer buffer_bio::copy_input(
+    const ASIO_LIBNS::const_buffer& data)
+{
+  copied_input_.erase(copied_input_.begin(),
+      copied_input_.begin() + copied_input_pos_);
+  copied_input_pos_ = 0;
+
+  std::size_t space = capacity > copied_input_.size()
+    ? capacity - copied_input_.size() : 0;
+  std::size_t length = data.size() < space ? data.size() : space;
+  const unsigned char* p = static_cast<const unsigned char*>(data.data());
+  copied_input_.insert(copied_input_.end(), p, p + length);
+
+  return data + length;
+}
+
+ASIO_LIBNS::mutable_buffer buffer_bio::take_output()
+{
+  // Reclaim the space used by output handed out by the previous call. Output
+  // written since then is normally empty, in which case nothing is moved.
+  if (output_taken_ != 0)
+  {
+    std::memmove(output_, output_ + output_taken_,
+        output_size_ - output_taken_);
+    output_size_ -= output_taken_;
+  }
+
+  output_taken_ = output_size_;
+  return ASIO_LIBNS::mutable_buffer(output_, output_size_);
+}
+
+void buffer_bio::release_storage()
+{
+  if (output_ && output_taken_ == output_size_)
+  {
+    buffer_pool::deallocate(output_);
+    output_ = 0;
+    output_size_ = 0;
+    output_taken_ = 0;
+  }
+
+  if (copied_input_pos_ == copied_input_.size())
+  {
+    std::vector<unsigned char>().swap(copied_input_);
+    copied_input_pos_ = 0;
+  }
+}
+
+BIO_METHOD* buffer_bio::method()
+{
+  struct method_holder
+  {
+    method_holder()
+      : m(::BIO_meth_new(BIO_TYPE_SOURCE_SINK | ::BIO_get_new_index(),
+            "asio buffer"))
+    {
+      if (m)
+      {
+        ::BIO_meth_set_create(m, &buffer_bio::bio_create);
+        ::BIO_meth_set_destroy(m, &buffer_bio::bio_destroy);
+        ::BIO_meth_set_read(m, &buffer_bio::bio_read);
+        ::BIO_meth_set_write(m, &buffer_bio::bio_write);
+        ::BIO_meth_set_ctrl(m, &buffer_bio::bio_ctrl);
+      }
+    }
+
+    BIO_METHOD* m;
+  };
+
+  static method_holder holder;
+  return holder.m;
+}
+
+int buffer_bio::bio_create(BIO* b)
+{
+#if !defined(ASIO_NO_EXCEPTIONS)
+  try
+  {
+#endif // !defined(ASIO_NO_EXCEPTIONS)
+    ::BIO_set_data(b, new buffer_bio);
+    ::BIO_set_init(b, 1);
+    return 1;
+#if !defined(ASIO_NO_EXCEPTIONS)
+  }
+  catch (...)
+  {
+    return 0;
+  }
+#endif // !defined(ASIO_NO_EXCEPTIONS)
+}
+
+int buffer_bio::bio_destroy(BIO* b)
+{
+  delete static_cast<buffer_bio*>(::BIO_get_data(b));
+  ::BIO_set_data(b, 0);
+  ::BIO_set_init(b, 0);
+  return 1;
+}
+
+int buffer_bio::bio_read(BIO* b, char* data, int length)
+{
+  buffer_bio* self = static_cast<buffer_bio*>(::BIO_get_data(b));
+  ::BIO_clear_retry_flags(b);
+
+  std::size_t n = 0;
+  std::size_t max_length = length > 0 ? static_cast<std::size_t>(length) : 0;
+
+  if (self->copied_input_pos_ < self->copied_input_.size())
+  {
+    n = self->copied_input_.size() - self->copied_input_pos_;
+    n = n < max_length ? n : max_length;
+    std::memcpy(data, &self->copied_input_[0] + self->copied_input_pos_, n);
+    self->copied_input_pos_ += n;
+  }
+  else if (self->attached_input_size_ != 0)
+  {
+    n = self->attached_input_size_ < max_length
+      ? self->attached_input_size_ : max_length;
+    std::memcpy(data, self->attached_input_, n);
+    self->attached_input_ += n;
+    self->attached_input_size_ -= n;
+  }
+
+  if (n == 0)
+  {
+    ::BIO_set_retry_read(b);
+    return -1;
+  }
+
+  return static_cast<int>(n);
+}
+
+int buffer_bio::bio_write(BIO* b, const char* data, int length)
+{
+  buffer_bio* self = static_cast<buffer_bio*>(::BIO_get_data(b));
+  ::BIO_clear_retry_flags(b);
+
+  if (!self->output_)
+  {
+#if !defined(ASIO_NO_EXCEPTIONS)
+    try
+    {
+#endif // !defined(ASIO_NO_EXCEPTIONS)
+      self->output_ = buffer_pool::allocate();
+#if !defined(ASIO_NO_EXCEPTIONS)
+    }
+    catch (...)
+    {
+      return -1;
+    }
+#endif // !defined(ASIO_NO_EXCEPTIONS)
+  }
+
+  std::size_t space = capacity - self->output_size_;
+  std::size_t n = length > 0 ? static_cast<std::size_t>(length) : 0;
+  n = n < space ? n : space;
+
+  if (n == 0)
+  {
+    ::BIO_set_retry_write(b);
+    return -1;
+  }
+
+  std::memcpy(self->output_ + self->output_size_, data, n);
+  self->output_size_ += n;
+  return static_cast<int>(n);
+}
+
+long buffer_bio::bio_ctrl(BIO* b, int cmd, long, void*)
+{
+  buffer_bio* self = static_cast<buffer_bio*>(::BIO_get_data(b));
+  switch (cmd)
+  {
+  case BIO_CTRL_PENDING:
+    return static_cast<long>(self->input_pending());
+  case BIO_CTRL_WPENDING:
+    return static_cast<long>(self->output_pending());
+  case BIO_CTRL_FLUSH:
+    return 1;
+  default:
+    return 0;
+  }
+}
+
+} // namespace detail
+} // namespace ssl
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // defined(ASIO_SSL_HAS_BUFFER_BIO)
+
+#endif // ASIO_SSL_DETAIL_IMPL_BUFFER_BIO_IPP
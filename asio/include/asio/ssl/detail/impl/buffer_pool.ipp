@@ -0,0 +1,86 @@
+//
+// ssl/detail/impl/buffer_pool.ipp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_SSL_DETAIL_IMPL_BUFFER_POOL_IPP
+#define ASIO_SSL_DETAIL_IMPL_BUFFER_POOL_IPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+#include <new>
+#include "asio/ssl/detail/buffer_pool.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace ASIO_LIBNS {
+namespace ssl {
+namespace detail {
+
+buffer_pool::buffer_pool()
+{
+  free_buffers_.reserve(ASIO_SSL_BUFFER_POOL_SIZE);
+}
+
+unsigned char* buffer_pool::allocate()
+{
+  buffer_pool& pool = instance();
+  {
+    ASIO_LIBNS::detail::mutex::scoped_lock lock(pool.mutex_);
+    if (!pool.free_buffers_.empty())
+    {
+      unsigned char* p = pool.free_buffers_.back();
+      pool.free_buffers_.pop_back();
+      return p;
+    }
+  }
+
+  return static_cast<unsigned char*>(::operator new(buffer_size));
+}
+
+void buffer_pool::deallocate(unsigned char* p)
+{
+  if (!p)
+    return;
+
+  buffer_pool& pool = instance();
+  {
+    ASIO_LIBNS::detail::mutex::scoped_lock lock(pool.mutex_);
+    if (pool.free_buffers_.size() < ASIO_SSL_BUFFER_POOL_SIZE)
+    {
+      pool.free_buffers_.push_back(p);
+      return;
+    }
+  }
+
+  ::operator delete(p);
+}
+
+std::size_t buffer_pool::available()
+{
+  buffer_pool& pool = instance();
+  ASIO_LIBNS::detail::mutex::scoped_lock lock(pool.mutex_);
+  return pool.free_buffers_.size();
+}
+
+buffer_pool& buffer_pool::instance()
+{
+  static buffer_pool* pool = new buffer_pool;
+  return *pool;
+}
+
+} // namespace detail
+} // namespace ssl
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // ASIO_SSL_DETAIL_IMPL_BUFFER_POOL_IPP
@@ -17,6 +17,10 @@
 
 #include "asio/detail/config.hpp"
 
+#include <cerrno>
+#if defined(ASIO_HAS_STD_CHRONO)
+# include <chrono>
+#endif // defined(ASIO_HAS_STD_CHRONO)
 #include "asio/detail/throw_error.hpp"
 #include "asio/error.hpp"
 #include "asio/ssl/detail/engine.hpp"
@@ -30,7 +34,11 @@ namespace ssl {
 namespace detail {
 
 engine::engine(SSL_CTX* context)
-  : ssl_(::SSL_new(context))
+  : ssl_(::SSL_new(context)),
+    dynamic_record_sizing_(false),
+    small_records_written_(0),
+    last_write_time_(0),
+    write_retry_length_(0)
 {
   if (!ssl_)
   {
@@ -50,13 +58,15 @@ engine::engine(SSL_CTX* context)
   ::SSL_set_mode(ssl_, SSL_MODE_RELEASE_BUFFERS);
 #endif // defined(SSL_MODE_RELEASE_BUFFERS)
 
-  ::BIO* int_bio = 0;
-  ::BIO_new_bio_pair(&int_bio, 0, &ext_bio_, 0);
-  ::SSL_set_bio(ssl_, int_bio, int_bio);
+  init_bio();
 }
 
 engine::engine(SSL* ssl_impl)
-  : ssl_(ssl_impl)
+  : ssl_(ssl_impl),
+    dynamic_record_sizing_(false),
+    small_records_written_(0),
+    last_write_time_(0),
+    write_retry_length_(0)
 {
 #if (OPENSSL_VERSION_NUMBER < 0x10000000L)
   accept_mutex().init();
@@ -68,18 +78,26 @@ engine::engine(SSL* ssl_impl)
   ::SSL_set_mode(ssl_, SSL_MODE_RELEASE_BUFFERS);
 #endif // defined(SSL_MODE_RELEASE_BUFFERS)
 
-  ::BIO* int_bio = 0;
-  ::BIO_new_bio_pair(&int_bio, 0, &ext_bio_, 0);
-  ::SSL_set_bio(ssl_, int_bio, int_bio);
+  init_bio();
 }
 
 #if defined(ASIO_HAS_MOVE)
 engine::engine(engine&& other) ASIO_NOEXCEPT
   : ssl_(other.ssl_),
     ext_bio_(other.ext_bio_)
+#if defined(ASIO_SSL_HAS_BUFFER_BIO)
+    , buffer_bio_(other.buffer_bio_)
+#endif // defined(ASIO_SSL_HAS_BUFFER_BIO)
+    , dynamic_record_sizing_(other.dynamic_record_sizing_),
+    small_records_written_(other.small_records_written_),
+    last_write_time_(other.last_write_time_),
+    write_retry_length_(other.write_retry_length_)
 {
   other.ssl_ = 0;
   other.ext_bio_ = 0;
+#if defined(ASIO_SSL_HAS_BUFFER_BIO)
+  other.buffer_bio_ = 0;
+#endif // defined(ASIO_SSL_HAS_BUFFER_BIO)
 }
 #endif // defined(ASIO_HAS_MOVE)
 
@@ -107,6 +125,14 @@ engine& engine::operator=(engine&& other) ASIO_NOEXCEPT
     ext_bio_ = other.ext_bio_;
     other.ssl_ = 0;
     other.ext_bio_ = 0;
+#if defined(ASIO_SSL_HAS_BUFFER_BIO)
+    buffer_bio_ = other.buffer_bio_;
+    other.buffer_bio_ = 0;
+#endif // defined(ASIO_SSL_HAS_BUFFER_BIO)
+    dynamic_record_sizing_ = other.dynamic_record_sizing_;
+    small_records_written_ = other.small_records_written_;
+    last_write_time_ = other.last_write_time_;
+    write_retry_length_ = other.write_retry_length_;
   }
   return *this;
 }
@@ -173,11 +199,32 @@ int engine::verify_callback_function(int preverified, X509_STORE_CTX* ctx)
   return 0;
 }
 
+ASIO_LIBNS::error_code engine::set_session_cache_key(
+    const std::string& host, unsigned short port,
+    ASIO_LIBNS::error_code& ec)
+{
+#if defined(ASIO_SSL_HAS_SESSION_CACHE)
+  session_cache::set_client_key(ssl_, host, port, ec);
+#else // defined(ASIO_SSL_HAS_SESSION_CACHE)
+  (void)host;
+  (void)port;
+  ec = ASIO_LIBNS::error::operation_not_supported;
+#endif // defined(ASIO_SSL_HAS_SESSION_CACHE)
+  return ec;
+}
+
 engine::want engine::handshake(
     stream_base::handshake_type type, ASIO_LIBNS::error_code& ec)
 {
-  return perform((type == ASIO_LIBNS::ssl::stream_base::client)
+  want result = perform((type == ASIO_LIBNS::ssl::stream_base::client)
       ? &engine::do_connect : &engine::do_accept, 0, 0, ec, 0);
+
+#if defined(ASIO_SSL_HAS_SESSION_CACHE)
+  if (!ec && (result == want_nothing || result == want_output))
+    session_cache::handshake_done(ssl_);
+#endif // defined(ASIO_SSL_HAS_SESSION_CACHE)
+
+  return result;
 }
 
 engine::want engine::shutdown(ASIO_LIBNS::error_code& ec)
@@ -185,6 +232,51 @@ engine::want engine::shutdown(ASIO_LIBNS::error_code& ec)
   return perform(&engine::do_shutdown, 0, 0, ec, 0);
 }
 
+namespace {
+
+// The number of small records written before switching to full-sized records.
+const std::size_t small_record_threshold = 40;
+
+// The idle time, in milliseconds, after which small records are used again.
+const ASIO_LIBNS::uint64_t record_size_idle_timeout = 1000;
+
+ASIO_LIBNS::uint64_t record_size_clock()
+{
+#if defined(ASIO_HAS_STD_CHRONO)
+  return static_cast<ASIO_LIBNS::uint64_t>(
+      std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#else // defined(ASIO_HAS_STD_CHRONO)
+  return 0;
+#endif // defined(ASIO_HAS_STD_CHRONO)
+}
+
+} // namespace
+
+void engine::set_dynamic_record_sizing(bool enabled)
+{
+  dynamic_record_sizing_ = enabled;
+  small_records_written_ = 0;
+  last_write_time_ = 0;
+}
+
+std::size_t engine::next_record_size() const
+{
+  if (write_retry_length_ != 0)
+    return write_retry_length_;
+
+  if (!dynamic_record_sizing_)
+    return max_record_size;
+
+  if (small_records_written_ < small_record_threshold)
+    return small_record_size;
+
+  if (record_size_clock() - last_write_time_ > record_size_idle_timeout)
+    return small_record_size;
+
+  return max_record_size;
+}
+
 engine::want engine::write(const ASIO_LIBNS::const_buffer& data,
     ASIO_LIBNS::error_code& ec, std::size_t& bytes_transferred)
 {
@@ -194,9 +286,34 @@ engine::want engine::write(const ASIO_LIBNS::const_buffer& data,
     return engine::want_nothing;
   }
 
-  return perform(&engine::do_write,
-      const_cast<void*>(data.data()),
-      data.size(), ec, &bytes_transferred);
+  // A write that could not complete must be retried with the same length.
+  std::size_t record_size = next_record_size();
+  std::size_t length = data.size() < record_size ? data.size() : record_size;
+
+  std::size_t bytes = 0;
+  engine::want result = perform(&engine::do_write,
+      const_cast<void*>(data.data()), length, ec, &bytes);
+  if (bytes != 0)
+    bytes_transferred = bytes;
+
+  if (result == want_output_and_retry || result == want_input_and_retry)
+  {
+    write_retry_length_ = length;
+    return result;
+  }
+
+  write_retry_length_ = 0;
+  if (dynamic_record_sizing_ && bytes != 0)
+  {
+    ASIO_LIBNS::uint64_t now = record_size_clock();
+    if (now - last_write_time_ > record_size_idle_timeout)
+      small_records_written_ = 0;
+    if (record_size == small_record_size)
+      ++small_records_written_;
+    last_write_time_ = now;
+  }
+
+  return result;
 }
 
 engine::want engine::read(const ASIO_LIBNS::mutable_buffer& data,
@@ -215,6 +332,14 @@ engine::want engine::read(const ASIO_LIBNS::mutable_buffer& data,
 ASIO_LIBNS::mutable_buffer engine::get_output(
     const ASIO_LIBNS::mutable_buffer& data)
 {
+#if defined(ASIO_SSL_HAS_BUFFER_BIO)
+  if (buffer_bio_)
+    return buffer_bio_->take_output();
+#endif // defined(ASIO_SSL_HAS_BUFFER_BIO)
+
+  if (!ext_bio_)
+    return ASIO_LIBNS::buffer(data, 0);
+
   int length = ::BIO_read(ext_bio_,
       data.data(), static_cast<int>(data.size()));
 
@@ -225,6 +350,14 @@ ASIO_LIBNS::mutable_buffer engine::get_output(
 ASIO_LIBNS::const_buffer engine::put_input(
     const ASIO_LIBNS::const_buffer& data)
 {
+#if defined(ASIO_SSL_HAS_BUFFER_BIO)
+  if (buffer_bio_)
+    return buffer_bio_->copy_input(data);
+#endif // defined(ASIO_SSL_HAS_BUFFER_BIO)
+
+  if (!ext_bio_)
+    return data;
+
   int length = ::BIO_write(ext_bio_,
       data.data(), static_cast<int>(data.size()));
 
@@ -232,6 +365,44 @@ ASIO_LIBNS::const_buffer engine::put_input(
       (length > 0 ? static_cast<std::size_t>(length) : 0));
 }
 
+ASIO_LIBNS::const_buffer engine::attach_input(
+    const ASIO_LIBNS::const_buffer& data)
+{
+#if defined(ASIO_SSL_HAS_BUFFER_BIO)
+  if (buffer_bio_)
+    return buffer_bio_->attach_input(data);
+#endif // defined(ASIO_SSL_HAS_BUFFER_BIO)
+
+  return put_input(data);
+}
+
+bool engine::stages_output() const
+{
+#if defined(ASIO_SSL_HAS_BUFFER_BIO)
+  return buffer_bio_ != 0;
+#else // defined(ASIO_SSL_HAS_BUFFER_BIO)
+  return false;
+#endif // defined(ASIO_SSL_HAS_BUFFER_BIO)
+}
+
+std::size_t engine::input_pending() const
+{
+#if defined(ASIO_SSL_HAS_BUFFER_BIO)
+  if (buffer_bio_)
+    return buffer_bio_->input_pending();
+#endif // defined(ASIO_SSL_HAS_BUFFER_BIO)
+
+  return ext_bio_ ? static_cast<std::size_t>(BIO_wpending(ext_bio_)) : 0;
+}
+
+void engine::release_buffers()
+{
+#if defined(ASIO_SSL_HAS_BUFFER_BIO)
+  if (buffer_bio_)
+    buffer_bio_->release_storage();
+#endif // defined(ASIO_SSL_HAS_BUFFER_BIO)
+}
+
 const ASIO_LIBNS::error_code& engine::map_error_code(
     ASIO_LIBNS::error_code& ec) const
 {
@@ -240,7 +411,7 @@ const ASIO_LIBNS::error_code& engine::map_error_code(
     return ec;
 
   // If there's data yet to be read, it's an error.
-  if (BIO_wpending(ext_bio_))
+  if (input_pending() != 0)
   {
     ec = ASIO_LIBNS::ssl::error::stream_truncated;
     return ec;
@@ -262,6 +433,108 @@ const ASIO_LIBNS::error_code& engine::map_error_code(
   return ec;
 }
 
+ASIO_LIBNS::error_code engine::use_native_socket(
+    int fd, ASIO_LIBNS::error_code& ec)
+{
+#if defined(SSL_OP_ENABLE_KTLS)
+  if (uses_native_socket())
+  {
+    ec = ASIO_LIBNS::error_code();
+    return ec;
+  }
+
+  if (fd < 0 || !::SSL_in_before(ssl_))
+  {
+    ec = ASIO_LIBNS::error::invalid_argument;
+    return ec;
+  }
+
+  ::ERR_clear_error();
+  if (::SSL_set_fd(ssl_, fd) != 1)
+  {
+    ec = ASIO_LIBNS::error_code(
+        static_cast<int>(::ERR_get_error()),
+        ASIO_LIBNS::error::get_ssl_category());
+    return ec;
+  }
+
+  // SSL_set_fd has replaced, and freed, the SSL's BIO.
+  if (ext_bio_)
+    ::BIO_free(ext_bio_);
+  ext_bio_ = 0;
+#if defined(ASIO_SSL_HAS_BUFFER_BIO)
+  buffer_bio_ = 0;
+#endif // defined(ASIO_SSL_HAS_BUFFER_BIO)
+
+  // The kernel takes over record processing for each direction only if the
+  // negotiated cipher suite is supported. Otherwise OpenSSL continues to
+  // process records in user space, using the socket directly.
+  ::SSL_set_options(ssl_, SSL_OP_ENABLE_KTLS);
+
+  ec = ASIO_LIBNS::error_code();
+  return ec;
+#else // defined(SSL_OP_ENABLE_KTLS)
+  (void)fd;
+  ec = ASIO_LIBNS::error::operation_not_supported;
+  return ec;
+#endif // defined(SSL_OP_ENABLE_KTLS)
+}
+
+bool engine::uses_native_socket() const
+{
+#if defined(ASIO_SSL_HAS_BUFFER_BIO)
+  return ext_bio_ == 0 && buffer_bio_ == 0;
+#else // defined(ASIO_SSL_HAS_BUFFER_BIO)
+  return ext_bio_ == 0;
+#endif // defined(ASIO_SSL_HAS_BUFFER_BIO)
+}
+
+bool engine::ktls_send() const
+{
+#if defined(BIO_get_ktls_send)
+  return uses_native_socket() && BIO_get_ktls_send(::SSL_get_wbio(ssl_));
+#else // defined(BIO_get_ktls_send)
+  return false;
+#endif // defined(BIO_get_ktls_send)
+}
+
+bool engine::ktls_receive() const
+{
+#if defined(BIO_get_ktls_recv)
+  return uses_native_socket() && BIO_get_ktls_recv(::SSL_get_rbio(ssl_));
+#else // defined(BIO_get_ktls_recv)
+  return false;
+#endif // defined(BIO_get_ktls_recv)
+}
+
+void engine::init_bio()
+{
+  ext_bio_ = 0;
+
+#if defined(ASIO_SSL_HAS_BUFFER_BIO)
+  buffer_bio_ = 0;
+  if (::BIO* bio = buffer_bio::create(&buffer_bio_))
+  {
+    ::SSL_set_bio(ssl_, bio, bio);
+    return;
+  }
+#endif // defined(ASIO_SSL_HAS_BUFFER_BIO)
+
+  ::BIO* int_bio = 0;
+  ::BIO_new_bio_pair(&int_bio, 0, &ext_bio_, 0);
+  ::SSL_set_bio(ssl_, int_bio, int_bio);
+}
+
+std::size_t engine::output_pending() const
+{
+#if defined(ASIO_SSL_HAS_BUFFER_BIO)
+  if (buffer_bio_)
+    return buffer_bio_->output_pending();
+#endif // defined(ASIO_SSL_HAS_BUFFER_BIO)
+
+  return ext_bio_ ? ::BIO_ctrl_pending(ext_bio_) : 0;
+}
+
 #if (OPENSSL_VERSION_NUMBER < 0x10000000L)
 ASIO_LIBNS::detail::static_mutex& engine::accept_mutex()
 {
@@ -274,24 +547,43 @@ engine::want engine::perform(int (engine::* op)(void*, std::size_t),
     void* data, std::size_t length, ASIO_LIBNS::error_code& ec,
     std::size_t* bytes_transferred)
 {
-  std::size_t pending_output_before = ::BIO_ctrl_pending(ext_bio_);
+  std::size_t pending_output_before = output_pending();
   ::ERR_clear_error();
+  errno = 0;
   int result = (this->*op)(data, length);
   int ssl_error = ::SSL_get_error(ssl_, result);
   int sys_error = static_cast<int>(::ERR_get_error());
-  std::size_t pending_output_after = ::BIO_ctrl_pending(ext_bio_);
+  int errno_value = errno;
+  std::size_t pending_output_after = output_pending();
 
   if (ssl_error == SSL_ERROR_SSL)
   {
     ec = ASIO_LIBNS::error_code(sys_error,
         ASIO_LIBNS::error::get_ssl_category());
+#if defined(SSL_R_UNEXPECTED_EOF_WHILE_READING)
+    // With a native socket, the transport's eof is seen by OpenSSL rather
+    // than by map_error_code.
+    if (uses_native_socket() && ERR_GET_REASON(sys_error)
+        == SSL_R_UNEXPECTED_EOF_WHILE_READING)
+      ec = ASIO_LIBNS::ssl::error::stream_truncated;
+#endif // defined(SSL_R_UNEXPECTED_EOF_WHILE_READING)
     return pending_output_after > pending_output_before
       ? want_output : want_nothing;
   }
 
   if (ssl_error == SSL_ERROR_SYSCALL)
   {
-    if (sys_error == 0)
+    if (sys_error == 0 && uses_native_socket())
+    {
+      // Socket I/O performed by OpenSSL reports failures through errno, and
+      // an eof without a close_notify as no error at all.
+      if (errno_value != 0)
+        ec = ASIO_LIBNS::error_code(errno_value,
+            ASIO_LIBNS::error::get_system_category());
+      else
+        ec = ASIO_LIBNS::ssl::error::stream_truncated;
+    }
+    else if (sys_error == 0)
     {
       ec = ASIO_LIBNS::ssl::error::unspecified_system_error;
     }
@@ -0,0 +1,480 @@
+//
+// ssl/detail/impl/session_cache.ipp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_SSL_DETAIL_IMPL_SESSION_CACHE_IPP
+#define ASIO_SSL_DETAIL_IMPL_SESSION_CACHE_IPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+#include <cstdio>
+#include <cstring>
+#include "asio/error.hpp"
+#include "asio/ssl/error.hpp"
+#include "asio/ssl/detail/session_cache.hpp"
+
+#if defined(ASIO_SSL_HAS_SESSION_CACHE)
+
+#include <openssl/rand.h>
+#if (OPENSSL_VERSION_NUMBER >= 0x30000000L)
+# include <openssl/core_names.h>
+# include <openssl/params.h>
+#else // (OPENSSL_VERSION_NUMBER >= 0x30000000L)
+# include <openssl/hmac.h>
+#endif // (OPENSSL_VERSION_NUMBER >= 0x30000000L)
+
+#include "asio/detail/push_options.hpp"
+
+namespace ASIO_LIBNS {
+namespace ssl {
+namespace detail {
+
+session_cache::session_cache()
+  : previous_new_session_callback_(0),
+    max_sessions_(0),
+    ticket_key_lifetime_(default_ticket_key_lifetime)
+{
+  statistics_.client_hits = 0;
+  statistics_.client_misses = 0;
+  statistics_.server_hits = 0;
+  statistics_.server_misses = 0;
+}
+
+session_cache::~session_cache()
+{
+  for (session_list::iterator i = sessions_.begin(); i != sessions_.end(); ++i)
+    ::SSL_SESSION_free(i->second);
+  ::OPENSSL_cleanse(ticket_keys_.empty() ? 0 : &ticket_keys_[0],
+      ticket_keys_.size() * sizeof(ticket_key));
+}
+
+session_cache* session_cache::get(SSL_CTX* ctx, ASIO_LIBNS::error_code& ec)
+{
+  if (session_cache* cache = find(ctx))
+  {
+    ec = ASIO_LIBNS::error_code();
+    return cache;
+  }
+
+  int index = context_index();
+  if (index < 0)
+  {
+    ec = ASIO_LIBNS::error::no_memory;
+    return 0;
+  }
+
+  session_cache* cache = new session_cache;
+  if (::SSL_CTX_set_ex_data(ctx, index, cache) != 1)
+  {
+    delete cache;
+    ec = ASIO_LIBNS::error::no_memory;
+    return 0;
+  }
+
+  ec = ASIO_LIBNS::error_code();
+  return cache;
+}
+
+session_cache* session_cache::find(SSL_CTX* ctx)
+{
+  int index = context_index();
+  return index < 0 ? 0 : static_cast<session_cache*>(
+      ::SSL_CTX_get_ex_data(ctx, index));
+}
+
+void session_cache::enable_cache(SSL_CTX* ctx, std::size_t max_sessions)
+{
+  {
+    ASIO_LIBNS::detail::mutex::scoped_lock lock(mutex_);
+    int (*callback)(SSL*, SSL_SESSION*) = ::SSL_CTX_sess_get_new_cb(ctx);
+    if (callback != &session_cache::new_session_callback)
+      previous_new_session_callback_ = callback;
+    max_sessions_ = max_sessions;
+    while (sessions_.size() > max_sessions_)
+    {
+      session_index_.erase(sessions_.back().first);
+      ::SSL_SESSION_free(sessions_.back().second);
+      sessions_.pop_back();
+    }
+  }
+
+  // Servers use OpenSSL's internal cache. Client sessions are passed to the
+  // new session callback, which caches them after passing them on to any
+  // callback it replaced.
+  ::SSL_CTX_set_session_cache_mode(ctx, max_sessions == 0
+      ? SSL_SESS_CACHE_OFF : SSL_SESS_CACHE_SERVER | SSL_SESS_CACHE_CLIENT);
+  ::SSL_CTX_sess_set_cache_size(ctx, static_cast<long>(max_sessions));
+  ::SSL_CTX_sess_set_new_cb(ctx, &session_cache::new_session_callback);
+}
+
+void session_cache::enable_tickets(SSL_CTX* ctx, long key_lifetime,
+    ASIO_LIBNS::error_code& ec)
+{
+  {
+    ASIO_LIBNS::detail::mutex::scoped_lock lock(mutex_);
+    ticket_key_lifetime_ = key_lifetime;
+    if (ticket_keys_.empty() && !add_ticket_key())
+    {
+      ec = ASIO_LIBNS::error_code(static_cast<int>(::ERR_get_error()),
+          ASIO_LIBNS::error::get_ssl_category());
+      return;
+    }
+  }
+
+  ::SSL_CTX_clear_options(ctx, SSL_OP_NO_TICKET);
+#if (OPENSSL_VERSION_NUMBER >= 0x30000000L)
+  ::SSL_CTX_set_tlsext_ticket_key_evp_cb(ctx,
+      &session_cache::ticket_key_callback);
+#else // (OPENSSL_VERSION_NUMBER >= 0x30000000L)
+  SSL_CTX_set_tlsext_ticket_key_cb(ctx,
+      &session_cache::ticket_key_callback);
+#endif // (OPENSSL_VERSION_NUMBER >= 0x30000000L)
+
+  ec = ASIO_LIBNS::error_code();
+}
+
+void session_cache::rotate_ticket_keys(ASIO_LIBNS::error_code& ec)
+{
+  ASIO_LIBNS::detail::mutex::scoped_lock lock(mutex_);
+  if (!add_ticket_key())
+  {
+    ec = ASIO_LIBNS::error_code(static_cast<int>(::ERR_get_error()),
+        ASIO_LIBNS::error::get_ssl_category());
+    return;
+  }
+
+  ec = ASIO_LIBNS::error_code();
+}
+
+session_statistics session_cache::statistics() const
+{
+  ASIO_LIBNS::detail::mutex::scoped_lock lock(mutex_);
+  return statistics_;
+}
+
+void session_cache::set_client_key(SSL* ssl, const std::string& host,
+    unsigned short port, ASIO_LIBNS::error_code& ec)
+{
+  int index = connection_index();
+  if (index < 0)
+  {
+    ec = ASIO_LIBNS::error::no_memory;
+    return;
+  }
+
+  char port_string[8];
+  std::sprintf(port_string, ":%u", static_cast<unsigned>(port));
+  std::string* key = new std::string(host + port_string);
+
+  std::string* old_key = static_cast<std::string*>(
+      ::SSL_get_ex_data(ssl, index));
+  if (::SSL_set_ex_data(ssl, index, key) != 1)
+  {
+    delete key;
+    ec = ASIO_LIBNS::error::no_memory;
+    return;
+  }
+  delete old_key;
+
+  if (session_cache* cache = find(::SSL_get_SSL_CTX(ssl)))
+  {
+    if (SSL_SESSION* session = cache->get_session(*key))
+    {
+      ::SSL_set_session(ssl, session);
+      ::SSL_SESSION_free(session);
+    }
+  }
+
+  ec = ASIO_LIBNS::error_code();
+}
+
+void session_cache::handshake_done(SSL* ssl)
+{
+  session_cache* cache = find(::SSL_get_SSL_CTX(ssl));
+  if (!cache)
+    return;
+
+  bool reused = ::SSL_session_reused(ssl) != 0;
+  ASIO_LIBNS::detail::mutex::scoped_lock lock(cache->mutex_);
+  if (::SSL_is_server(ssl))
+  {
+    if (reused)
+      ++cache->statistics_.server_hits;
+    else
+      ++cache->statistics_.server_misses;
+  }
+  else if (connection_index() >= 0
+      && ::SSL_get_ex_data(ssl, connection_index()))
+  {
+    if (reused)
+      ++cache->statistics_.client_hits;
+    else
+      ++cache->statistics_.client_misses;
+  }
+}
+
+int session_cache::context_index()
+{
+  static int index = ::SSL_CTX_get_ex_new_index(
+      0, 0, 0, 0, &session_cache::free_cache);
+  return index;
+}
+
+int session_cache::connection_index()
+{
+  static int index = ::SSL_get_ex_new_index(
+      0, 0, 0, 0, &session_cache::free_key);
+  return index;
+}
+
+void session_cache::free_cache(void*, void* ptr,
+    CRYPTO_EX_DATA*, int, long, void*)
+{
+  delete static_cast<session_cache*>(ptr);
+}
+
+void session_cache::free_key(void*, void* ptr,
+    CRYPTO_EX_DATA*, int, long, void*)
+{
+  delete static_cast<std::string*>(ptr);
+}
+
+int session_cache::new_session_callback(SSL* ssl, SSL_SESSION* session)
+{
+  session_cache* cache = find(::SSL_get_SSL_CTX(ssl));
+  if (!cache)
+    return 0;
+
+  int (*previous)(SSL*, SSL_SESSION*) = 0;
+  {
+    ASIO_LIBNS::detail::mutex::scoped_lock lock(cache->mutex_);
+    previous = cache->previous_new_session_callback_;
+  }
+
+  // A non-zero result means that the previous callback has kept the reference
+  // it was given, which must then not be kept here.
+  int result = previous ? previous(ssl, session) : 0;
+
+  if (::SSL_is_server(ssl))
+    return result;
+
+  int index = connection_index();
+  std::string* key = index < 0 ? 0
+    : static_cast<std::string*>(::SSL_get_ex_data(ssl, index));
+  if (!key)
+    return result;
+
+#if (OPENSSL_VERSION_NUMBER >= 0x10101000L)
+  // OpenSSL also keeps the session in the context's internal cache, and marks
+  // it as not resumable when it is evicted from there. Cache a copy so that
+  // only this cache's own limit applies.
+  if (SSL_SESSION* copy = ::SSL_SESSION_dup(session))
+    cache->add_session(*key, copy);
+  return result;
+#else // (OPENSSL_VERSION_NUMBER >= 0x10101000L)
+  if (result != 0)
+    ::SSL_SESSION_up_ref(session);
+  cache->add_session(*key, session);
+  return 1;
+#endif // (OPENSSL_VERSION_NUMBER >= 0x10101000L)
+}
+
+#if (OPENSSL_VERSION_NUMBER >= 0x30000000L)
+int session_cache::ticket_key_callback(SSL* ssl, unsigned char* key_name,
+    unsigned char* iv, EVP_CIPHER_CTX* cipher_ctx, EVP_MAC_CTX* mac_ctx,
+    int enc)
+#else // (OPENSSL_VERSION_NUMBER >= 0x30000000L)
+int session_cache::ticket_key_callback(SSL* ssl, unsigned char* key_name,
+    unsigned char* iv, EVP_CIPHER_CTX* cipher_ctx, HMAC_CTX* hmac_ctx,
+    int enc)
+#endif // (OPENSSL_VERSION_NUMBER >= 0x30000000L)
+{
+  session_cache* cache = find(::SSL_get_SSL_CTX(ssl));
+  if (!cache)
+    return -1;
+
+  ticket_key key;
+  bool current = false;
+  if (!cache->find_ticket_key(key_name, enc != 0, key, current))
+    return enc ? -1 : 0;
+
+  int result = 1;
+  if (enc)
+  {
+    std::memcpy(key_name, key.name, sizeof(key.name));
+    if (::RAND_bytes(iv, EVP_MAX_IV_LENGTH) != 1
+        || ::EVP_EncryptInit_ex(cipher_ctx,
+          ::EVP_aes_256_cbc(), 0, key.aes_key, iv) != 1)
+      result = -1;
+  }
+  else
+  {
+    if (::EVP_DecryptInit_ex(cipher_ctx,
+          ::EVP_aes_256_cbc(), 0, key.aes_key, iv) != 1)
+      result = -1;
+
+    // Ask for the ticket to be renewed if it used an older key. TLS 1.3
+    // tickets are single use, so a replacement is always issued.
+    else if (!current || ::SSL_version(ssl) >= TLS1_3_VERSION)
+      result = 2;
+  }
+
+  if (result > 0)
+  {
+#if (OPENSSL_VERSION_NUMBER >= 0x30000000L)
+    char digest[] = "SHA256";
+    OSSL_PARAM params[] =
+    {
+      ::OSSL_PARAM_construct_octet_string(OSSL_MAC_PARAM_KEY,
+          key.hmac_key, sizeof(key.hmac_key)),
+      ::OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST, digest, 0),
+      ::OSSL_PARAM_construct_end()
+    };
+    if (::EVP_MAC_CTX_set_params(mac_ctx, params) != 1)
+      result = -1;
+#else // (OPENSSL_VERSION_NUMBER >= 0x30000000L)
+    if (::HMAC_Init_ex(hmac_ctx, key.hmac_key,
+          static_cast<int>(sizeof(key.hmac_key)), ::EVP_sha256(), 0) != 1)
+      result = -1;
+#endif // (OPENSSL_VERSION_NUMBER >= 0x30000000L)
+  }
+
+  ::OPENSSL_cleanse(&key, sizeof(key));
+  return result;
+}
+
+bool session_cache::add_ticket_key()
+{
+  ticket_key key;
+  if (::RAND_bytes(key.name, sizeof(key.name)) != 1
+      || ::RAND_bytes(key.aes_key, sizeof(key.aes_key)) != 1
+      || ::RAND_bytes(key.hmac_key, sizeof(key.hmac_key)) != 1)
+    return false;
+  key.created = std::time(0);
+
+  // Keep the previous key for decryption only.
+  ticket_keys_.insert(ticket_keys_.begin(), key);
+  if (ticket_keys_.size() > 2)
+  {
+    ::OPENSSL_cleanse(&ticket_keys_.back(), sizeof(ticket_key));
+    ticket_keys_.pop_back();
+  }
+
+  ::OPENSSL_cleanse(&key, sizeof(key));
+  return true;
+}
+
+bool session_cache::find_ticket_key(const unsigned char* name, bool encrypt,
+    ticket_key& key, bool& current)
+{
+  ASIO_LIBNS::detail::mutex::scoped_lock lock(mutex_);
+
+  std::time_t now = std::time(0);
+  bool expired = ticket_keys_.empty() || (ticket_key_lifetime_ > 0
+      && now - ticket_keys_.front().created >= ticket_key_lifetime_);
+
+  if (encrypt)
+  {
+    if (expired && !add_ticket_key() && ticket_keys_.empty())
+      return false;
+    key = ticket_keys_.front();
+    current = true;
+    return true;
+  }
+
+  for (std::size_t i = 0; i < ticket_keys_.size(); ++i)
+  {
+    if (std::memcmp(name, ticket_keys_[i].name, sizeof(key.name)) == 0)
+    {
+      // A ticket is accepted for up to two key lifetimes after its key was
+      // created, since the key may have been used until it was rotated.
+      if (ticket_key_lifetime_ > 0
+          && now - ticket_keys_[i].created >= 2 * ticket_key_lifetime_)
+        return false;
+      key = ticket_keys_[i];
+      current = (i == 0) && !expired;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void session_cache::add_session(const std::string& key, SSL_SESSION* session)
+{
+  ASIO_LIBNS::detail::mutex::scoped_lock lock(mutex_);
+
+  std::map<std::string, session_list::iterator>::iterator i =
+    session_index_.find(key);
+  if (i != session_index_.end())
+  {
+    ::SSL_SESSION_free(i->second->second);
+    sessions_.erase(i->second);
+    session_index_.erase(i);
+  }
+
+  if (max_sessions_ == 0)
+  {
+    ::SSL_SESSION_free(session);
+    return;
+  }
+
+  sessions_.push_front(std::make_pair(key, session));
+  session_index_[key] = sessions_.begin();
+
+  while (sessions_.size() > max_sessions_)
+  {
+    session_index_.erase(sessions_.back().first);
+    ::SSL_SESSION_free(sessions_.back().second);
+    sessions_.pop_back();
+  }
+}
+
+SSL_SESSION* session_cache::get_session(const std::string& key)
+{
+  ASIO_LIBNS::detail::mutex::scoped_lock lock(mutex_);
+
+  std::map<std::string, session_list::iterator>::iterator i =
+    session_index_.find(key);
+  if (i == session_index_.end())
+    return 0;
+
+  // Discard the session if it has expired or can no longer be resumed.
+  SSL_SESSION* session = i->second->second;
+  bool resumable = ::SSL_SESSION_get_time(session)
+    + ::SSL_SESSION_get_timeout(session) > static_cast<long>(std::time(0));
+#if (OPENSSL_VERSION_NUMBER >= 0x10101000L)
+  resumable = resumable && ::SSL_SESSION_is_resumable(session);
+#endif // (OPENSSL_VERSION_NUMBER >= 0x10101000L)
+  if (!resumable)
+  {
+    ::SSL_SESSION_free(session);
+    sessions_.erase(i->second);
+    session_index_.erase(i);
+    return 0;
+  }
+
+  // Move the session to the front of the list.
+  sessions_.splice(sessions_.begin(), sessions_, i->second);
+  ::SSL_SESSION_up_ref(session);
+  return session;
+}
+
+} // namespace detail
+} // namespace ssl
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // defined(ASIO_SSL_HAS_SESSION_CACHE)
+
+#endif // ASIO_SSL_DETAIL_IMPL_SESSION_CACHE_IPP
@@ -18,8 +18,12 @@
 #include "asio/detail/config.hpp"
 
 #include "asio/detail/base_from_cancellation_state.hpp"
+#include "asio/detail/bind_handler.hpp"
 #include "asio/detail/handler_tracking.hpp"
+#include "asio/executor_work_guard.hpp"
+#include "asio/post.hpp"
 #include "asio/ssl/detail/engine.hpp"
+#include "asio/ssl/detail/native_transport.hpp"
 #include "asio/ssl/detail/stream_core.hpp"
 #include "asio/write.hpp"
 
@@ -39,10 +43,21 @@ std::size_t io(Stream& next_layer, stream_core& core,
   {
   case engine::want_input_and_retry:
 
+    // If the engine does its own socket I/O, wait until it can read.
+    if (core.engine_.uses_native_socket())
+    {
+      native_transport<Stream>::wait(next_layer,
+          socket_base::wait_read, io_ec);
+      if (!ec)
+        ec = io_ec;
+      continue;
+    }
+
     // If the input buffer is empty then we need to read some more data from
     // the underlying transport.
     if (core.input_.size() == 0)
     {
+      core.acquire_input_buffer();
       core.input_ = ASIO_LIBNS::buffer(core.input_buffer_,
           next_layer.read_some(core.input_buffer_, io_ec));
       if (!ec)
@@ -50,17 +65,26 @@ std::size_t io(Stream& next_layer, stream_core& core,
     }
 
     // Pass the new input data to the engine.
-    core.input_ = core.engine_.put_input(core.input_);
+    core.input_ = core.engine_.attach_input(core.input_);
 
     // Try the operation again.
     continue;
 
   case engine::want_output_and_retry:
 
+    // If the engine does its own socket I/O, wait until it can write.
+    if (core.engine_.uses_native_socket())
+    {
+      native_transport<Stream>::wait(next_layer,
+          socket_base::wait_write, io_ec);
+      if (!ec)
+        ec = io_ec;
+      continue;
+    }
+
     // Get output data from the engine and write it to the underlying
     // transport.
-    ASIO_LIBNS::write(next_layer,
-        core.engine_.get_output(core.output_buffer_), io_ec);
+    ASIO_LIBNS::write(next_layer, core.get_output(), io_ec);
     if (!ec)
       ec = io_ec;
 
@@ -71,28 +95,33 @@ std::size_t io(Stream& next_layer, stream_core& core,
 
     // Get output data from the engine and write it to the underlying
     // transport.
-    ASIO_LIBNS::write(next_layer,
-        core.engine_.get_output(core.output_buffer_), io_ec);
+    ASIO_LIBNS::write(next_layer, core.get_output(), io_ec);
     if (!ec)
       ec = io_ec;
 
     // Operation is complete. Return result to caller.
+    core.release_buffers();
     core.engine_.map_error_code(ec);
     return bytes_transferred;
 
   default:
 
     // Operation is complete. Return result to caller.
+    core.release_buffers();
     core.engine_.map_error_code(ec);
     return bytes_transferred;
 
   } while (!ec);
 
   // Operation failed. Return result to caller.
+  core.release_buffers();
   core.engine_.map_error_code(ec);
   return 0;
 }
 
+template <typename Stream, typename Operation, typename Handler>
+class offload_op;
+
 template <typename Stream, typename Operation, typename Handler>
 class io_op
   : public ASIO_LIBNS::detail::base_from_cancellation_state<Handler>
@@ -107,6 +136,7 @@ public:
       start_(0),
       want_(engine::want_nothing),
       bytes_transferred_(0),
+      waited_for_input_(false),
       handler_(ASIO_MOVE_CAST(Handler)(handler))
   {
   }
@@ -121,6 +151,7 @@ public:
       want_(other.want_),
       ec_(other.ec_),
       bytes_transferred_(other.bytes_transferred_),
+      waited_for_input_(other.waited_for_input_),
       handler_(other.handler_)
   {
   }
@@ -137,6 +168,7 @@ public:
       want_(other.want_),
       ec_(other.ec_),
       bytes_transferred_(other.bytes_transferred_),
+      waited_for_input_(other.waited_for_input_),
       handler_(ASIO_MOVE_CAST(Handler)(other.handler_))
   {
   }
@@ -150,15 +182,44 @@ public:
     case 1: // Called after at least one async operation.
       do
       {
-        switch (want_ = op_(core_.engine_, ec_, bytes_transferred_))
+        // Run CPU-intensive operations, such as handshakes, on the offload
+        // executor if one has been set. Control resumes at the "case 2:"
+        // label below once the operation has run.
+        if (Operation::offloadable() && core_.handshake_executor_)
+        {
+          ASIO_HANDLER_LOCATION((
+                __FILE__, __LINE__, Operation::tracking_name()));
+
+          ASIO_LIBNS::post(core_.handshake_executor_,
+              offload_op<Stream, Operation, Handler>(*this));
+          return;
+        }
+
+        want_ = op_(core_.engine_, ec_, bytes_transferred_);
+
+        case 2: // Called after the operation ran on the offload executor.
+        switch (want_)
         {
         case engine::want_input_and_retry:
 
+          // If the engine does its own socket I/O, wait until it can read.
+          // The socket allows concurrent waits, so there is no need to
+          // serialise these with other operations.
+          if (core_.engine_.uses_native_socket())
+          {
+            ASIO_HANDLER_LOCATION((
+                  __FILE__, __LINE__, Operation::tracking_name()));
+
+            native_transport<Stream>::async_wait(next_layer_,
+                socket_base::wait_read, ASIO_MOVE_CAST(io_op)(*this));
+            return;
+          }
+
           // If the input buffer already has data in it we can pass it to the
           // engine and then retry the operation immediately.
           if (core_.input_.size() != 0)
           {
-            core_.input_ = core_.engine_.put_input(core_.input_);
+            core_.input_ = core_.engine_.attach_input(core_.input_);
             continue;
           }
 
@@ -171,6 +232,27 @@ public:
             // Prevent other read operations from being started.
             core_.pending_read_.expires_at(core_.pos_infin());
 
+            // If requested, input buffers are taken from the pool only once
+            // there is data to read, so that streams waiting for their peer
+            // do not hold one. If the transport is a socket with no data
+            // available, wait for it to become readable first.
+            if (core_.lazy_input_buffer_ && !waited_for_input_
+                && native_transport<Stream>::available(next_layer_) == 0)
+            {
+              core_.release_input_buffer();
+              waited_for_input_ = true;
+
+              ASIO_HANDLER_LOCATION((
+                    __FILE__, __LINE__, Operation::tracking_name()));
+
+              native_transport<Stream>::async_wait(next_layer_,
+                  socket_base::wait_read, ASIO_MOVE_CAST(io_op)(*this));
+              return;
+            }
+
+            waited_for_input_ = false;
+            core_.acquire_input_buffer();
+
             ASIO_HANDLER_LOCATION((
                   __FILE__, __LINE__, Operation::tracking_name()));
 
@@ -195,6 +277,17 @@ public:
         case engine::want_output_and_retry:
         case engine::want_output:
 
+          // If the engine does its own socket I/O, wait until it can write.
+          if (core_.engine_.uses_native_socket())
+          {
+            ASIO_HANDLER_LOCATION((
+                  __FILE__, __LINE__, Operation::tracking_name()));
+
+            native_transport<Stream>::async_wait(next_layer_,
+                socket_base::wait_write, ASIO_MOVE_CAST(io_op)(*this));
+            return;
+          }
+
           // The engine wants some data to be written to the output. However, we
           // cannot allow more than one write operation at a time on the
           // underlying transport. The pending_write_ timer's expiry is set to
@@ -208,8 +301,7 @@ public:
                   __FILE__, __LINE__, Operation::tracking_name()));
 
             // Start writing all the data to the underlying transport.
-            ASIO_LIBNS::async_write(next_layer_,
-                core_.engine_.get_output(core_.output_buffer_),
+            ASIO_LIBNS::async_write(next_layer_, core_.get_output(),
                 ASIO_MOVE_CAST(io_op)(*this));
           }
           else
@@ -232,7 +324,7 @@ public:
           // the async operation's initiating function. In this case we're not
           // allowed to call the handler directly. Instead, issue a zero-sized
           // read so the handler runs "as-if" posted using io_context::post().
-          if (start)
+          if (start == 1)
           {
             ASIO_HANDLER_LOCATION((
                   __FILE__, __LINE__, Operation::tracking_name()));
@@ -254,7 +346,15 @@ public:
 
         default:
         if (bytes_transferred == ~std::size_t(0))
+        {
           bytes_transferred = 0; // Timer cancellation, no data transferred.
+
+          // Socket readiness waits also complete without a byte count, but
+          // their errors must be reported.
+          if ((core_.engine_.uses_native_socket() || waited_for_input_)
+              && !ec_)
+            ec_ = ec;
+        }
         else if (!ec_)
           ec_ = ec;
 
@@ -262,10 +362,21 @@ public:
         {
         case engine::want_input_and_retry:
 
+          // An engine doing its own socket I/O reads the data itself.
+          if (core_.engine_.uses_native_socket())
+          {
+            if (this->cancelled() != cancellation_type::none)
+            {
+              ec_ = ASIO_LIBNS::error::operation_aborted;
+              break;
+            }
+            continue;
+          }
+
           // Add received data to the engine's input.
           core_.input_ = ASIO_LIBNS::buffer(
               core_.input_buffer_, bytes_transferred);
-          core_.input_ = core_.engine_.put_input(core_.input_);
+          core_.input_ = core_.engine_.attach_input(core_.input_);
 
           // Release any waiting read operations.
           core_.pending_read_.expires_at(core_.neg_infin());
@@ -305,6 +416,7 @@ public:
         default:
 
           // Pass the result to the handler.
+          core_.release_buffers();
           op_.call_handler(handler_,
               core_.engine_.map_error_code(ec_),
               ec_ ? 0 : bytes_transferred_);
@@ -315,6 +427,7 @@ public:
       } while (!ec_);
 
       // Operation failed. Pass the result to the handler.
+      core_.release_buffers();
       op_.call_handler(handler_, core_.engine_.map_error_code(ec_), 0);
     }
   }
@@ -327,9 +440,58 @@ public:
   engine::want want_;
   ASIO_LIBNS::error_code ec_;
   std::size_t bytes_transferred_;
+  bool waited_for_input_;
   Handler handler_;
 };
 
+// Runs an SSL operation on the offload executor and then resumes the io_op on
+// the executor of the underlying transport.
+template <typename Stream, typename Operation, typename Handler>
+class offload_op
+{
+public:
+  typedef io_op<Stream, Operation, Handler> io_op_type;
+
+  explicit offload_op(io_op_type& op)
+    : work_(ASIO_LIBNS::make_work_guard(op.next_layer_.get_executor())),
+      op_(ASIO_MOVE_CAST(io_op_type)(op))
+  {
+  }
+
+#if defined(ASIO_HAS_MOVE)
+  offload_op(const offload_op& other)
+    : work_(other.work_),
+      op_(other.op_)
+  {
+  }
+
+  offload_op(offload_op&& other)
+    : work_(ASIO_MOVE_CAST(work_guard_type)(other.work_)),
+      op_(ASIO_MOVE_CAST(io_op_type)(other.op_))
+  {
+  }
+#endif // defined(ASIO_HAS_MOVE)
+
+  void operator()()
+  {
+    // The io_op is suspended, so nothing else uses the engine until it is
+    // resumed.
+    op_.want_ = op_.op_(op_.core_.engine_, op_.ec_, op_.bytes_transferred_);
+
+    ASIO_LIBNS::post(work_.get_executor(),
+        ASIO_LIBNS::detail::bind_handler(
+          ASIO_MOVE_CAST(io_op_type)(op_),
+          ASIO_LIBNS::error_code(), 0, 2));
+    work_.reset();
+  }
+
+private:
+  typedef executor_work_guard<typename Stream::executor_type> work_guard_type;
+
+  work_guard_type work_;
+  io_op_type op_;
+};
+
 template <typename Stream, typename Operation, typename Handler>
 inline asio_handler_allocate_is_deprecated
 asio_handler_allocate(std::size_t size,
@@ -0,0 +1,138 @@
+//
+// ssl/detail/native_transport.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_SSL_DETAIL_NATIVE_TRANSPORT_HPP
+#define ASIO_SSL_DETAIL_NATIVE_TRANSPORT_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+#include "asio/detail/type_traits.hpp"
+#include "asio/error.hpp"
+#include "asio/post.hpp"
+#include "asio/socket_base.hpp"
+#include "asio/detail/bind_handler.hpp"
+
+#include "asio/detail/push_options.hpp"
+
+namespace ASIO_LIBNS {
+namespace ssl {
+namespace detail {
+
+// Gives the SSL engine access to the native socket beneath a stream, for use
+// when the engine performs its own socket I/O (e.g. for kernel TLS) or waits
+// for input to arrive before taking a buffer for it. Streams whose lowest
+// layer is not a socket get the primary template, which reports that native
+// socket access is not supported, and that the amount of available input is
+// unknown.
+template <typename Stream, typename = void>
+struct native_transport
+{
+  static int native_socket(Stream&, ASIO_LIBNS::error_code& ec)
+  {
+    ec = ASIO_LIBNS::error::operation_not_supported;
+    return -1;
+  }
+
+  static void wait(Stream&, socket_base::wait_type,
+      ASIO_LIBNS::error_code& ec)
+  {
+    ec = ASIO_LIBNS::error::operation_not_supported;
+  }
+
+  template <typename Handler>
+  static void async_wait(Stream& s, socket_base::wait_type,
+      ASIO_MOVE_ARG(Handler) handler)
+  {
+    ASIO_LIBNS::post(s.get_executor(),
+        ASIO_LIBNS::detail::bind_handler(
+          ASIO_MOVE_CAST(Handler)(handler),
+          ASIO_LIBNS::error_code(
+            ASIO_LIBNS::error::operation_not_supported)));
+  }
+
+  static std::size_t available(Stream&)
+  {
+    return ~std::size_t(0);
+  }
+};
+
+#if !defined(ASIO_WINDOWS) && !defined(__CYGWIN__)
+
+template <typename Stream>
+struct native_transport<Stream,
+    typename void_type<
+      decltype(
+        static_cast<int>(declval<Stream&>().lowest_layer().native_handle()),
+        declval<Stream&>().lowest_layer().native_non_blocking(true),
+        declval<Stream&>().lowest_layer().wait(
+          socket_base::wait_read, declval<ASIO_LIBNS::error_code&>())
+      )
+    >::type>
+{
+  // Get the native socket, switching it to non-blocking mode so that the
+  // engine's socket I/O reports when it would block.
+  static int native_socket(Stream& s, ASIO_LIBNS::error_code& ec)
+  {
+    s.lowest_layer().native_non_blocking(true, ec);
+    if (ec)
+      return -1;
+    return static_cast<int>(s.lowest_layer().native_handle());
+  }
+
+  static void wait(Stream& s, socket_base::wait_type w,
+      ASIO_LIBNS::error_code& ec)
+  {
+    s.lowest_layer().wait(w, ec);
+  }
+
+  template <typename Handler>
+  static void async_wait(Stream& s, socket_base::wait_type w,
+      ASIO_MOVE_ARG(Handler) handler)
+  {
+    s.lowest_layer().async_wait(w, ASIO_MOVE_CAST(Handler)(handler));
+  }
+
+  // Get the number of bytes that can be read from the stream without blocking.
+  // Only known when the stream is the socket itself, since a layered stream
+  // may hold data of its own.
+  static std::size_t available(Stream& s)
+  {
+    typedef typename remove_reference<
+      decltype(declval<Stream&>().lowest_layer())>::type lowest_layer_type;
+
+    return available(s, is_base_of<lowest_layer_type, Stream>());
+  }
+
+private:
+  static std::size_t available(Stream& s, true_type)
+  {
+    ASIO_LIBNS::error_code ec;
+    std::size_t n = s.lowest_layer().available(ec);
+    return ec ? ~std::size_t(0) : n;
+  }
+
+  static std::size_t available(Stream&, false_type)
+  {
+    return ~std::size_t(0);
+  }
+};
+
+#endif // !defined(ASIO_WINDOWS) && !defined(__CYGWIN__)
+
+} // namespace detail
+} // namespace ssl
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#endif // ASIO_SSL_DETAIL_NATIVE_TRANSPORT_HPP
@@ -35,6 +35,11 @@ public:
     return "ssl::stream<>::async_read_some";
   }
 
+  static ASIO_CONSTEXPR bool offloadable()
+  {
+    return false;
+  }
+
   read_op(const MutableBufferSequence& buffers)
     : buffers_(buffers)
   {
@@ -0,0 +1,184 @@
+//
+// ssl/detail/session_cache.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef ASIO_SSL_DETAIL_SESSION_CACHE_HPP
+#define ASIO_SSL_DETAIL_SESSION_CACHE_HPP
+
+#if defined(_MSC_VER) && (_MSC_VER >= 1200)
+# pragma once
+#endif // defined(_MSC_VER) && (_MSC_VER >= 1200)
+
+#include "asio/detail/config.hpp"
+
+#include <cstddef>
+#include <ctime>
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+#include "asio/detail/mutex.hpp"
+#include "asio/detail/noncopyable.hpp"
+#include "asio/error_code.hpp"
+#include "asio/ssl/detail/openssl_types.hpp"
+
+#if (OPENSSL_VERSION_NUMBER >= 0x10100000L) \
+  && !defined(LIBRESSL_VERSION_NUMBER) \
+  && !defined(ASIO_USE_WOLFSSL)
+# define ASIO_SSL_HAS_SESSION_CACHE 1
+#endif // (OPENSSL_VERSION_NUMBER >= 0x10100000L) ...
+
+#include "asio/detail/push_options.hpp"
+
+namespace ASIO_LIBNS {
+namespace ssl {
+namespace detail {
+
+// Counters describing how often handshakes resumed a session.
+struct session_statistics
+{
+  // Client handshakes, on streams with a session cache key, that did or did
+  // not resume a cached session.
+  std::size_t client_hits;
+  std::size_t client_misses;
+
+  // Server handshakes that did or did not resume a session.
+  std::size_t server_hits;
+  std::size_t server_misses;
+};
+
+#if defined(ASIO_SSL_HAS_SESSION_CACHE)
+
+// Session resumption state attached to an SSL_CTX. Holds a size-bounded LRU
+// cache of client sessions keyed by host and port, the keys used to encrypt
+// server session tickets, and hit and miss counters. The object is owned by
+// the SSL_CTX and destroyed with it.
+class session_cache
+  : private ASIO_LIBNS::detail::noncopyable
+{
+public:
+  // The number of seconds for which a ticket key is used, by default.
+  enum { default_ticket_key_lifetime = 3600 };
+
+  // Get the cache attached to a context, creating it if required. Returns 0
+  // and sets ec on failure.
+  ASIO_DECL static session_cache* get(SSL_CTX* ctx,
+      ASIO_LIBNS::error_code& ec);
+
+  // Get the cache attached to a context, if any.
+  ASIO_DECL static session_cache* find(SSL_CTX* ctx);
+
+  // Enable the client and server session caches. Any new session callback
+  // already installed on the context is called before the cache's own.
+  ASIO_DECL void enable_cache(SSL_CTX* ctx, std::size_t max_sessions);
+
+  // Enable session tickets using keys that are rotated after the given number
+  // of seconds. A lifetime of zero disables automatic rotation.
+  ASIO_DECL void enable_tickets(SSL_CTX* ctx, long key_lifetime,
+      ASIO_LIBNS::error_code& ec);
+
+  // Replace the current ticket key with a new, randomly generated one. The
+  // previous key is retained so that recently issued tickets remain valid.
+  ASIO_DECL void rotate_ticket_keys(ASIO_LIBNS::error_code& ec);
+
+  // Get the hit and miss counters.
+  ASIO_DECL session_statistics statistics() const;
+
+  // Associate a client connection with the given host and port, and offer
+  // any session cached for them.
+  ASIO_DECL static void set_client_key(SSL* ssl, const std::string& host,
+      unsigned short port, ASIO_LIBNS::error_code& ec);
+
+  // Update the counters once a handshake has completed.
+  ASIO_DECL static void handshake_done(SSL* ssl);
+
+private:
+  struct ticket_key
+  {
+    unsigned char name[16];
+    unsigned char aes_key[32];
+    unsigned char hmac_key[32];
+    std::time_t created;
+  };
+
+  typedef std::list<std::pair<std::string, SSL_SESSION*> > session_list;
+
+  ASIO_DECL session_cache();
+  ASIO_DECL ~session_cache();
+
+  // Get the ex_data indexes used to attach state to contexts and connections.
+  ASIO_DECL static int context_index();
+  ASIO_DECL static int connection_index();
+
+  // Free state attached using ex_data.
+  ASIO_DECL static void free_cache(void* parent, void* ptr,
+      CRYPTO_EX_DATA* ad, int idx, long argl, void* argp);
+  ASIO_DECL static void free_key(void* parent, void* ptr,
+      CRYPTO_EX_DATA* ad, int idx, long argl, void* argp);
+
+  // Called by OpenSSL when a new client session has been established.
+  ASIO_DECL static int new_session_callback(SSL* ssl, SSL_SESSION* session);
+
+  // Called by OpenSSL to encrypt or decrypt a session ticket.
+#if (OPENSSL_VERSION_NUMBER >= 0x30000000L)
+  ASIO_DECL static int ticket_key_callback(SSL* ssl, unsigned char* key_name,
+      unsigned char* iv, EVP_CIPHER_CTX* cipher_ctx, EVP_MAC_CTX* mac_ctx,
+      int enc);
+#else // (OPENSSL_VERSION_NUMBER >= 0x30000000L)
+  ASIO_DECL static int ticket_key_callback(SSL* ssl, unsigned char* key_name,
+      unsigned char* iv, EVP_CIPHER_CTX* cipher_ctx, HMAC_CTX* hmac_ctx,
+      int enc);
+#endif // (OPENSSL_VERSION_NUMBER >= 0x30000000L)
+
+  // Add a new ticket key. The mutex must be held.
+  ASIO_DECL bool add_ticket_key();
+
+  // Find the key with which to encrypt a new ticket, rotating the current key
+  // if it has expired, or the key named by a ticket being decrypted. Returns
+  // false if there is no suitable key.
+  ASIO_DECL bool find_ticket_key(const unsigned char* name, bool encrypt,
+      ticket_key& key, bool& current);
+
+  // Add a client session, taking ownership of the reference.
+  ASIO_DECL void add_session(const std::string& key, SSL_SESSION* session);
+
+  // Get a client session, returning a new reference, or 0 if there is none.
+  ASIO_DECL SSL_SESSION* get_session(const std::string& key);
+
+  // Protects all members.
+  mutable ASIO_LIBNS::detail::mutex mutex_;
+
+  // The new session callback that was installed before the cache's own.
+  int (*previous_new_session_callback_)(SSL*, SSL_SESSION*);
+
+  // Cached client sessions, most recently used first.
+  std::size_t max_sessions_;
+  session_list sessions_;
+  std::map<std::string, session_list::iterator> session_index_;
+
+  // Ticket keys, newest first. The first key encrypts new tickets.
+  std::vector<ticket_key> ticket_keys_;
+  long ticket_key_lifetime_;
+
+  session_statistics statistics_;
+};
+
+#endif // defined(ASIO_SSL_HAS_SESSION_CACHE)
+
+} // namespace detail
+} // namespace ssl
+} // namespace asio
+
+#include "asio/detail/pop_options.hpp"
+
+#if defined(ASIO_HEADER_ONLY)
+# include "asio/ssl/detail/impl/session_cache.ipp"
+#endif // defined(ASIO_HEADER_ONLY)
+
+#endif // ASIO_SSL_DETAIL_SESSION_CACHE_HPP
@@ -33,6 +33,11 @@ public:
     return "ssl::stream<>::async_shutdown";
   }
 
+  static ASIO_CONSTEXPR bool offloadable()
+  {
+    return false;
+  }
+
   engine::want operator()(engine& eng,
       ASIO_LIBNS::error_code& ec,
       std::size_t& bytes_transferred) const
@@ -22,6 +22,8 @@
 #else // defined(ASIO_HAS_BOOST_DATE_TIME)
 # include "asio/steady_timer.hpp"
 #endif // defined(ASIO_HAS_BOOST_DATE_TIME)
+#include "asio/any_io_executor.hpp"
+#include "asio/ssl/detail/buffer_pool.hpp"
 #include "asio/ssl/detail/engine.hpp"
 #include "asio/buffer.hpp"
 
@@ -33,19 +35,16 @@ namespace detail {
 
 struct stream_core
 {
-  // According to the OpenSSL documentation, this is the buffer size that is
-  // sufficient to hold the largest possible TLS record.
-  enum { max_tls_record_size = 17 * 1024 };
-
   template <typename Executor>
   stream_core(SSL_CTX* context, const Executor& ex)
     : engine_(context),
       pending_read_(ex),
       pending_write_(ex),
-      output_buffer_space_(max_tls_record_size),
-      output_buffer_(ASIO_LIBNS::buffer(output_buffer_space_)),
-      input_buffer_space_(max_tls_record_size),
-      input_buffer_(ASIO_LIBNS::buffer(input_buffer_space_))
+      output_buffer_space_(0),
+      output_buffer_(0, 0),
+      input_buffer_space_(0),
+      input_buffer_(0, 0),
+      lazy_input_buffer_(false)
   {
     pending_read_.expires_at(neg_infin());
     pending_write_.expires_at(neg_infin());
@@ -56,10 +55,11 @@ struct stream_core
     : engine_(ssl_impl),
       pending_read_(ex),
       pending_write_(ex),
-      output_buffer_space_(max_tls_record_size),
-      output_buffer_(ASIO_LIBNS::buffer(output_buffer_space_)),
-      input_buffer_space_(max_tls_record_size),
-      input_buffer_(ASIO_LIBNS::buffer(input_buffer_space_))
+      output_buffer_space_(0),
+      output_buffer_(0, 0),
+      input_buffer_space_(0),
+      input_buffer_(0, 0),
+      lazy_input_buffer_(false)
   {
     pending_read_.expires_at(neg_infin());
     pending_write_.expires_at(neg_infin());
@@ -83,17 +83,19 @@ struct stream_core
          ASIO_MOVE_CAST(ASIO_LIBNS::steady_timer)(
            other.pending_write_)),
 #endif // defined(ASIO_HAS_BOOST_DATE_TIME)
-      output_buffer_space_(
-          ASIO_MOVE_CAST(std::vector<unsigned char>)(
-            other.output_buffer_space_)),
+      output_buffer_space_(other.output_buffer_space_),
       output_buffer_(other.output_buffer_),
-      input_buffer_space_(
-          ASIO_MOVE_CAST(std::vector<unsigned char>)(
-            other.input_buffer_space_)),
+      input_buffer_space_(other.input_buffer_space_),
       input_buffer_(other.input_buffer_),
-      input_(other.input_)
+      input_(other.input_),
+      lazy_input_buffer_(other.lazy_input_buffer_),
+      handshake_executor_(
+          ASIO_MOVE_CAST(ASIO_LIBNS::any_io_executor)(
+            other.handshake_executor_))
   {
+    other.output_buffer_space_ = 0;
     other.output_buffer_ = ASIO_LIBNS::mutable_buffer(0, 0);
+    other.input_buffer_space_ = 0;
     other.input_buffer_ = ASIO_LIBNS::mutable_buffer(0, 0);
     other.input_ = ASIO_LIBNS::const_buffer(0, 0);
   }
@@ -101,6 +103,8 @@ struct stream_core
 
   ~stream_core()
   {
+    buffer_pool::deallocate(output_buffer_space_);
+    buffer_pool::deallocate(input_buffer_space_);
   }
 
 #if defined(ASIO_HAS_MOVE)
@@ -124,16 +128,20 @@ struct stream_core
         ASIO_MOVE_CAST(ASIO_LIBNS::steady_timer)(
           other.pending_write_);
 #endif // defined(ASIO_HAS_BOOST_DATE_TIME)
-      output_buffer_space_ =
-        ASIO_MOVE_CAST(std::vector<unsigned char>)(
-          other.output_buffer_space_);
+      buffer_pool::deallocate(output_buffer_space_);
+      output_buffer_space_ = other.output_buffer_space_;
       output_buffer_ = other.output_buffer_;
-      input_buffer_space_ =
-        ASIO_MOVE_CAST(std::vector<unsigned char>)(
-          other.input_buffer_space_);
+      buffer_pool::deallocate(input_buffer_space_);
+      input_buffer_space_ = other.input_buffer_space_;
       input_buffer_ = other.input_buffer_;
       input_ = other.input_;
+      lazy_input_buffer_ = other.lazy_input_buffer_;
+      handshake_executor_ =
+        ASIO_MOVE_CAST(ASIO_LIBNS::any_io_executor)(
+          other.handshake_executor_);
+      other.output_buffer_space_ = 0;
       other.output_buffer_ = ASIO_LIBNS::mutable_buffer(0, 0);
+      other.input_buffer_space_ = 0;
       other.input_buffer_ = ASIO_LIBNS::mutable_buffer(0, 0);
       other.input_ = ASIO_LIBNS::const_buffer(0, 0);
     }
@@ -141,6 +149,61 @@ struct stream_core
   }
 #endif // defined(ASIO_HAS_MOVE)
 
+  // Make input_buffer_ refer to storage taken from the buffer pool, if it does
+  // not already.
+  void acquire_input_buffer()
+  {
+    if (!input_buffer_space_)
+    {
+      input_buffer_space_ = buffer_pool::allocate();
+      input_buffer_ = ASIO_LIBNS::buffer(
+          input_buffer_space_, buffer_pool::buffer_size);
+    }
+  }
+
+  // Get output data from the engine to be written to the transport.
+  ASIO_LIBNS::mutable_buffer get_output()
+  {
+    if (!output_buffer_space_ && !engine_.stages_output())
+    {
+      output_buffer_space_ = buffer_pool::allocate();
+      output_buffer_ = ASIO_LIBNS::buffer(
+          output_buffer_space_, buffer_pool::buffer_size);
+    }
+
+    return engine_.get_output(output_buffer_);
+  }
+
+  // Return the buffers to the pool, and let the engine release its own, if
+  // no operation is using them.
+  void release_buffers()
+  {
+    if (expiry(pending_read_) != neg_infin()
+        || expiry(pending_write_) != neg_infin())
+      return;
+
+    engine_.release_buffers();
+
+    buffer_pool::deallocate(output_buffer_space_);
+    output_buffer_space_ = 0;
+    output_buffer_ = ASIO_LIBNS::mutable_buffer(0, 0);
+
+    release_input_buffer();
+  }
+
+  // Return the input buffer to the pool if the engine has consumed all of the
+  // data in it. Must not be called while a read is in progress.
+  void release_input_buffer()
+  {
+    if (input_.size() == 0 && engine_.input_pending() == 0)
+    {
+      buffer_pool::deallocate(input_buffer_space_);
+      input_buffer_space_ = 0;
+      input_buffer_ = ASIO_LIBNS::mutable_buffer(0, 0);
+      input_ = ASIO_LIBNS::const_buffer(0, 0);
+    }
+  }
+
   // The SSL engine.
   engine engine_;
 
@@ -196,20 +259,32 @@ struct stream_core
   }
 #endif // defined(ASIO_HAS_BOOST_DATE_TIME)
 
-  // Buffer space used to prepare output intended for the transport.
-  std::vector<unsigned char> output_buffer_space_;
+  // Buffer space used to prepare output intended for the transport, taken
+  // from the buffer pool when needed. Never used if the engine stages its own
+  // output.
+  unsigned char* output_buffer_space_;
 
   // A buffer that may be used to prepare output intended for the transport.
   ASIO_LIBNS::mutable_buffer output_buffer_;
 
-  // Buffer space used to read input intended for the engine.
-  std::vector<unsigned char> input_buffer_space_;
+  // Buffer space used to read input intended for the engine, taken from the
+  // buffer pool when needed.
+  unsigned char* input_buffer_space_;
 
-  // A buffer that may be used to read input intended for the engine.
+  // A buffer that may be used to read input intended for the engine. Empty
+  // until acquire_input_buffer() is called.
   ASIO_LIBNS::mutable_buffer input_buffer_;
 
   // The buffer pointing to the engine's unconsumed input.
   ASIO_LIBNS::const_buffer input_;
+
+  // Whether asynchronous reads wait for the transport to become readable
+  // before taking an input buffer.
+  bool lazy_input_buffer_;
+
+  // The executor on which asynchronous handshakes perform their SSL
+  // operations, or an empty executor if they run in the calling thread.
+  ASIO_LIBNS::any_io_executor handshake_executor_;
 };
 
 } // namespace detail
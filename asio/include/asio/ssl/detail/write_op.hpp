@@ -35,6 +35,11 @@ public:
     return "ssl::stream<>::async_write_some";
   }
 
+  static ASIO_CONSTEXPR bool offloadable()
+  {
+    return false;
+  }
+
   write_op(const ConstBufferSequence& buffers)
     : buffers_(buffers)
   {
@@ -44,13 +49,17 @@ public:
       ASIO_LIBNS::error_code& ec,
       std::size_t& bytes_transferred) const
   {
+    // Gather small buffers into a single record of up to the size that the
+    // engine will write, rather than writing one record per buffer.
     unsigned char storage[
       ASIO_LIBNS::detail::buffer_sequence_adapter<ASIO_LIBNS::const_buffer,
-        ConstBufferSequence>::linearisation_storage_size];
+        ConstBufferSequence>::linearisation_storage_size == 1
+      ? 1 : engine::max_record_size];
 
     ASIO_LIBNS::const_buffer buffer =
       ASIO_LIBNS::detail::buffer_sequence_adapter<ASIO_LIBNS::const_buffer,
-        ConstBufferSequence>::linearise(buffers_, ASIO_LIBNS::buffer(storage));
+        ConstBufferSequence>::linearise(buffers_,
+          ASIO_LIBNS::buffer(storage, eng.next_record_size()));
 
     return eng.write(buffer, ec, bytes_transferred);
   }
@@ -1162,6 +1162,77 @@ ASIO_SYNC_OP_VOID context::use_tmp_dh_file(
   ASIO_SYNC_OP_VOID_RETURN(ec);
 }
 
+void context::enable_session_cache(std::size_t max_sessions)
+{
+  ASIO_LIBNS::error_code ec;
+  enable_session_cache(max_sessions, ec);
+  ASIO_LIBNS::detail::throw_error(ec, "enable_session_cache");
+}
+
+ASIO_SYNC_OP_VOID context::enable_session_cache(
+    std::size_t max_sessions, ASIO_LIBNS::error_code& ec)
+{
+#if defined(ASIO_SSL_HAS_SESSION_CACHE)
+  if (detail::session_cache* cache = detail::session_cache::get(handle_, ec))
+    cache->enable_cache(handle_, max_sessions);
+#else // defined(ASIO_SSL_HAS_SESSION_CACHE)
+  (void)max_sessions;
+  ec = ASIO_LIBNS::error::operation_not_supported;
+#endif // defined(ASIO_SSL_HAS_SESSION_CACHE)
+  ASIO_SYNC_OP_VOID_RETURN(ec);
+}
+
+void context::enable_session_tickets(long key_lifetime)
+{
+  ASIO_LIBNS::error_code ec;
+  enable_session_tickets(key_lifetime, ec);
+  ASIO_LIBNS::detail::throw_error(ec, "enable_session_tickets");
+}
+
+ASIO_SYNC_OP_VOID context::enable_session_tickets(
+    long key_lifetime, ASIO_LIBNS::error_code& ec)
+{
+#if defined(ASIO_SSL_HAS_SESSION_CACHE)
+  if (detail::session_cache* cache = detail::session_cache::get(handle_, ec))
+    cache->enable_tickets(handle_, key_lifetime, ec);
+#else // defined(ASIO_SSL_HAS_SESSION_CACHE)
+  (void)key_lifetime;
+  ec = ASIO_LIBNS::error::operation_not_supported;
+#endif // defined(ASIO_SSL_HAS_SESSION_CACHE)
+  ASIO_SYNC_OP_VOID_RETURN(ec);
+}
+
+void context::rotate_session_ticket_keys()
+{
+  ASIO_LIBNS::error_code ec;
+  rotate_session_ticket_keys(ec);
+  ASIO_LIBNS::detail::throw_error(ec, "rotate_session_ticket_keys");
+}
+
+ASIO_SYNC_OP_VOID context::rotate_session_ticket_keys(
+    ASIO_LIBNS::error_code& ec)
+{
+#if defined(ASIO_SSL_HAS_SESSION_CACHE)
+  if (detail::session_cache* cache = detail::session_cache::find(handle_))
+    cache->rotate_ticket_keys(ec);
+  else
+    ec = ASIO_LIBNS::error::invalid_argument;
+#else // defined(ASIO_SSL_HAS_SESSION_CACHE)
+  ec = ASIO_LIBNS::error::operation_not_supported;
+#endif // defined(ASIO_SSL_HAS_SESSION_CACHE)
+  ASIO_SYNC_OP_VOID_RETURN(ec);
+}
+
+context::session_statistics context::get_session_statistics() const
+{
+#if defined(ASIO_SSL_HAS_SESSION_CACHE)
+  if (detail::session_cache* cache = detail::session_cache::find(handle_))
+    return cache->statistics();
+#endif // defined(ASIO_SSL_HAS_SESSION_CACHE)
+  session_statistics stats = { 0, 0, 0, 0 };
+  return stats;
+}
+
 ASIO_SYNC_OP_VOID context::do_use_tmp_dh(
     BIO* bio, ASIO_LIBNS::error_code& ec)
 {
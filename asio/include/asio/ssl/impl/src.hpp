@@ -21,8 +21,11 @@
 
 #include "asio/ssl/impl/context.ipp"
 #include "asio/ssl/impl/error.ipp"
+#include "asio/ssl/detail/impl/buffer_bio.ipp"
+#include "asio/ssl/detail/impl/buffer_pool.ipp"
 #include "asio/ssl/detail/impl/engine.ipp"
 #include "asio/ssl/detail/impl/openssl_init.ipp"
+#include "asio/ssl/detail/impl/session_cache.ipp"
 #include "asio/ssl/impl/host_name_verification.ipp"
 #include "asio/ssl/impl/rfc2818_verification.ipp"
 
@@ -27,6 +27,7 @@
 #include "asio/ssl/detail/buffered_handshake_op.hpp"
 #include "asio/ssl/detail/handshake_op.hpp"
 #include "asio/ssl/detail/io.hpp"
+#include "asio/ssl/detail/native_transport.hpp"
 #include "asio/ssl/detail/read_op.hpp"
 #include "asio/ssl/detail/shutdown_op.hpp"
 #include "asio/ssl/detail/stream_core.hpp"
@@ -403,6 +404,184 @@ public:
     ASIO_SYNC_OP_VOID_RETURN(ec);
   }
 
+  /// Set the key under which the client's session is cached.
+  /**
+   * This function associates the stream with a host and port in the session
+   * cache of the stream's context, and offers any session already cached for
+   * them when the handshake is performed. Once the handshake completes, the
+   * session negotiated with the server is cached for use by later streams.
+   * The session cache must have been enabled using
+   * context::enable_session_cache().
+   *
+   * This function must be called before the handshake.
+   *
+   * @param host The name of the host to which the stream is connected.
+   *
+   * @param port The port to which the stream is connected.
+   *
+   * @throws ASIO_LIBNS::system_error Thrown on failure.
+   *
+   * @note Calls @c SSL_set_session.
+   */
+  void set_session_cache_key(const std::string& host, unsigned short port)
+  {
+    ASIO_LIBNS::error_code ec;
+    set_session_cache_key(host, port, ec);
+    ASIO_LIBNS::detail::throw_error(ec, "set_session_cache_key");
+  }
+
+  /// Set the key under which the client's session is cached.
+  /**
+   * This function associates the stream with a host and port in the session
+   * cache of the stream's context, and offers any session already cached for
+   * them when the handshake is performed. It must be called before the
+   * handshake.
+   *
+   * @param host The name of the host to which the stream is connected.
+   *
+   * @param port The port to which the stream is connected.
+   *
+   * @param ec Set to indicate what error occurred, if any.
+   *
+   * @note Calls @c SSL_set_session.
+   */
+  ASIO_SYNC_OP_VOID set_session_cache_key(const std::string& host,
+      unsigned short port, ASIO_LIBNS::error_code& ec)
+  {
+    core_.engine_.set_session_cache_key(host, port, ec);
+    ASIO_SYNC_OP_VOID_RETURN(ec);
+  }
+
+  /// Enable or disable dynamic record sizing.
+  /**
+   * By default, each write operation puts as much of the data as possible, up
+   * to 16KB gathered from the buffer sequence, into a single TLS record. When
+   * dynamic record sizing is enabled, writes use records that fit in a single
+   * TCP segment at the start of the connection and after it has been idle for
+   * a second, and switch to full-sized records once the connection is busy.
+   * This lets the peer process the first data sooner, at the cost of some
+   * throughput early in the connection.
+   *
+   * @param enabled Whether dynamic record sizing should be used.
+   */
+  void set_dynamic_record_sizing(bool enabled)
+  {
+    core_.engine_.set_dynamic_record_sizing(enabled);
+  }
+
+  /// Enable or disable taking the input buffer only once data has arrived.
+  /**
+   * The buffer into which an asynchronous operation reads from the next layer
+   * is taken from a pool shared by all streams, and returned when the stream
+   * becomes idle. By default, a read that is waiting for the peer holds its
+   * buffer. When this option is enabled, the read instead waits for the
+   * socket to become readable before taking a buffer, so that streams that
+   * are waiting for their peer hold no buffer memory. This costs an extra
+   * system call to check for data, and an extra wait when there is none.
+   *
+   * The option has an effect only if the next layer is the socket itself.
+   *
+   * @param enabled Whether reads should wait for data before taking a buffer.
+   */
+  void set_lazy_input_buffer(bool enabled)
+  {
+    core_.lazy_input_buffer_ = enabled;
+  }
+
+  /// Set the executor used to run the SSL operations of asynchronous
+  /// handshakes.
+  /**
+   * The key exchange and signature operations performed during a handshake are
+   * CPU-intensive. By default they run in the thread that performs the
+   * asynchronous handshake, delaying other work on that thread. When an
+   * executor, such as that of a @c thread_pool, has been set, each step of
+   * the handshake's SSL processing is run on it instead. I/O on the underlying
+   * transport and the completion handler continue to run on the stream's
+   * executor.
+   *
+   * Synchronous handshakes, and other asynchronous operations, are not
+   * affected.
+   *
+   * @param ex The executor to use, or a default-constructed executor to run
+   * the handshake in the calling thread.
+   *
+   * @note No other operation may be performed on the stream while an
+   * asynchronous handshake is in progress.
+   */
+  void set_handshake_executor(const ASIO_LIBNS::any_io_executor& ex)
+  {
+    core_.handshake_executor_ = ex;
+  }
+
+  /// Enable kernel TLS offload.
+  /**
+   * This function may be used to hand the stream's record processing to the
+   * kernel's TLS implementation. It binds the SSL session directly to the
+   * native socket of the lowest layer, which is switched to non-blocking mode,
+   * and asks OpenSSL to install the negotiated keys in the kernel when the
+   * handshake completes. Once offload is active, writes go straight to the
+   * underlying socket. Reads continue to use OpenSSL so that TLS control
+   * records are handled, but the data is decrypted by the kernel.
+   *
+   * If the kernel or the negotiated cipher suite does not support offload for
+   * a direction, OpenSSL processes that direction's records in user space.
+   *
+   * This function must be called before the handshake. A buffered handshake
+   * cannot be used once it has been called.
+   *
+   * @throws ASIO_LIBNS::system_error Thrown on failure. The error is
+   * ASIO_LIBNS::error::operation_not_supported if the lowest layer is not a
+   * socket or if OpenSSL was built without kernel TLS support.
+   *
+   * @note Calls @c SSL_set_fd and sets @c SSL_OP_ENABLE_KTLS.
+   */
+  void enable_ktls()
+  {
+    ASIO_LIBNS::error_code ec;
+    enable_ktls(ec);
+    ASIO_LIBNS::detail::throw_error(ec, "enable_ktls");
+  }
+
+  /// Enable kernel TLS offload.
+  /**
+   * This function may be used to hand the stream's record processing to the
+   * kernel's TLS implementation. It must be called before the handshake.
+   *
+   * @param ec Set to indicate what error occurred, if any. The error is
+   * ASIO_LIBNS::error::operation_not_supported if the lowest layer is not a
+   * socket or if OpenSSL was built without kernel TLS support.
+   *
+   * @note Calls @c SSL_set_fd and sets @c SSL_OP_ENABLE_KTLS.
+   */
+  ASIO_SYNC_OP_VOID enable_ktls(ASIO_LIBNS::error_code& ec)
+  {
+    int fd = detail::native_transport<next_layer_type>::native_socket(
+        next_layer_, ec);
+    if (!ec)
+      core_.engine_.use_native_socket(fd, ec);
+    ASIO_SYNC_OP_VOID_RETURN(ec);
+  }
+
+  /// Determine whether sending has been offloaded to the kernel.
+  /**
+   * @returns @c true if kernel TLS offload has been enabled and the kernel
+   * encrypts outgoing records. Only meaningful after the handshake.
+   */
+  bool ktls_send_active() const
+  {
+    return core_.engine_.ktls_send();
+  }
+
+  /// Determine whether receiving has been offloaded to the kernel.
+  /**
+   * @returns @c true if kernel TLS offload has been enabled and the kernel
+   * decrypts incoming records. Only meaningful after the handshake.
+   */
+  bool ktls_receive_active() const
+  {
+    return core_.engine_.ktls_receive();
+  }
+
   /// Perform SSL handshaking.
   /**
    * This function is used to perform SSL handshaking on the stream. The
@@ -718,6 +897,10 @@ public:
   std::size_t write_some(const ConstBufferSequence& buffers,
       ASIO_LIBNS::error_code& ec)
   {
+    // The kernel encrypts data written directly to the socket.
+    if (core_.engine_.ktls_send())
+      return next_layer_.write_some(buffers, ec);
+
     return detail::io(next_layer_, core_,
         detail::write_op<ConstBufferSequence>(buffers), ec);
   }
@@ -1020,6 +1203,14 @@ private:
       // does not meet the documented type requirements for a WriteHandler.
       ASIO_WRITE_HANDLER_CHECK(WriteHandler, handler) type_check;
 
+      // The kernel encrypts data written directly to the socket.
+      if (self_->core_.engine_.ktls_send())
+      {
+        self_->next_layer_.async_write_some(buffers,
+            ASIO_MOVE_CAST(WriteHandler)(handler));
+        return;
+      }
+
       ASIO_LIBNS::detail::non_const_lvalue<WriteHandler> handler2(handler);
       detail::async_io(self_->next_layer_, self_->core_,
           detail::write_op<ConstBufferSequence>(buffers), handler2.value);
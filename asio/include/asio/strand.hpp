@@ -362,6 +362,59 @@ public:
     return detail::strand_executor_service::running_in_this_thread(impl_);
   }
 
+  /// The type of the counters returned by get_statistics().
+  typedef detail::strand_executor_service::statistics statistics;
+
+  /// Set the maximum number of function objects run each time the strand is
+  /// scheduled.
+  /**
+   * When the budget is exhausted and further function objects are ready to
+   * run, the strand reschedules itself on the underlying executor so that
+   * other work is given a chance to run. A value of zero, the default, means
+   * that there is no limit. The budget is shared by all copies of the strand.
+   */
+  void set_batch_budget(std::size_t n) const ASIO_NOEXCEPT
+  {
+    detail::strand_executor_service::set_batch_budget(impl_, n);
+  }
+
+  /// Get the maximum number of function objects run each time the strand is
+  /// scheduled.
+  std::size_t batch_budget() const ASIO_NOEXCEPT
+  {
+    return detail::strand_executor_service::batch_budget(impl_);
+  }
+
+  /// Set whether the strand prefers to resume on the thread that last ran it.
+  /**
+   * When enabled, the strand reschedules itself on the underlying executor as
+   * a continuation of the current thread, rather than as a new piece of work
+   * that may be picked up by any thread. Executors such as @c io_context and
+   * @c thread_pool use this as a hint to keep the strand on the same thread.
+   * The setting is shared by all copies of the strand.
+   */
+  void set_sticky(bool value) const ASIO_NOEXCEPT
+  {
+    detail::strand_executor_service::set_sticky(impl_, value);
+  }
+
+  /// Get whether the strand prefers to resume on the thread that last ran it.
+  bool sticky() const ASIO_NOEXCEPT
+  {
+    return detail::strand_executor_service::sticky(impl_);
+  }
+
+  /// Obtain the counters that describe how the strand has been scheduled.
+  /**
+   * The counters are shared by all copies of the strand. Thread resumptions
+   * and migrations are only counted when the strand runs on threads that are
+   * running an @c io_context or @c thread_pool.
+   */
+  statistics get_statistics() const ASIO_NOEXCEPT
+  {
+    return detail::strand_executor_service::get_statistics(impl_);
+  }
+
   /// Compare two strands for equality.
   /**
    * Two strands are equal if they refer to the same ordered, non-concurrent
@@ -9,36 +9,14 @@
 //
 
 #include <asio.hpp>
+#include <cstring>
 #include <iostream>
 #include <memory>
 #include <utility>
-#include <vector>
 #include <ctime>
 
 using asio::ip::tcp;
 
-// A reference-counted non-modifiable buffer class.
-class shared_const_buffer
-{
-public:
-  // Construct from a std::string.
-  explicit shared_const_buffer(const std::string& data)
-    : data_(new std::vector<char>(data.begin(), data.end())),
-      buffer_(asio::buffer(*data_))
-  {
-  }
-
-  // Implement the ConstBufferSequence requirements.
-  typedef asio::const_buffer value_type;
-  typedef const asio::const_buffer* const_iterator;
-  const asio::const_buffer* begin() const { return &buffer_; }
-  const asio::const_buffer* end() const { return &buffer_ + 1; }
-
-private:
-  std::shared_ptr<std::vector<char> > data_;
-  asio::const_buffer buffer_;
-};
-
 class session
   : public std::enable_shared_from_this<session>
 {
@@ -56,8 +34,11 @@ public:
 private:
   void do_write()
   {
+    // The buffer's memory is shared by every copy of the buffer object, and
+    // is released when the write operation no longer needs it.
     std::time_t now = std::time(0);
-    shared_const_buffer buffer(std::ctime(&now));
+    const char* text = std::ctime(&now);
+    asio::shared_buffer buffer(text, std::strlen(text));
 
     auto self(shared_from_this());
     asio::async_write(socket_, buffer,
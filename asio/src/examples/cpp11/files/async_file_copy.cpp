@@ -10,6 +10,8 @@
 
 #include <iostream>
 #include "asio.hpp"
+#include "asio/stream_file.hpp"
+#include "asio/write.hpp"
 
 #if defined(ASIO_HAS_FILE)
 
@@ -0,0 +1,146 @@
+//
+// buffer_copy.cpp
+// ~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "asio/buffer.hpp"
+#include "asio/detail/chrono.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+// Copy between buffer sequences by pairing up segments and calling memcpy for
+// each piece. This is how buffer_copy worked before the size-adaptive copy.
+template <typename MutableBufferSequence, typename ConstBufferSequence>
+std::size_t reference_copy(const MutableBufferSequence& target,
+    const ConstBufferSequence& source)
+{
+  std::size_t total_bytes_copied = 0;
+
+  typename MutableBufferSequence::const_iterator target_iter = target.begin();
+  std::size_t target_buffer_offset = 0;
+
+  typename ConstBufferSequence::const_iterator source_iter = source.begin();
+  std::size_t source_buffer_offset = 0;
+
+  while (target_iter != target.end() && source_iter != source.end())
+  {
+    asio::mutable_buffer target_buffer =
+      asio::mutable_buffer(*target_iter) + target_buffer_offset;
+
+    asio::const_buffer source_buffer =
+      asio::const_buffer(*source_iter) + source_buffer_offset;
+
+    std::size_t bytes_copied = target_buffer.size() < source_buffer.size()
+      ? target_buffer.size() : source_buffer.size();
+    if (bytes_copied > 0)
+      std::memcpy(target_buffer.data(), source_buffer.data(), bytes_copied);
+    total_bytes_copied += bytes_copied;
+
+    if (bytes_copied == target_buffer.size())
+    {
+      ++target_iter;
+      target_buffer_offset = 0;
+    }
+    else
+      target_buffer_offset += bytes_copied;
+
+    if (bytes_copied == source_buffer.size())
+    {
+      ++source_iter;
+      source_buffer_offset = 0;
+    }
+    else
+      source_buffer_offset += bytes_copied;
+  }
+
+  return total_bytes_copied;
+}
+
+// Time a number of copies, returning the average nanoseconds per copy.
+template <typename Function>
+double time_copies(Function f, int iterations, std::size_t& checksum)
+{
+  typedef asio::chrono::steady_clock clock;
+  clock::time_point start = clock::now();
+  for (int i = 0; i < iterations; ++i)
+    checksum += f();
+  clock::duration elapsed = clock::now() - start;
+  return static_cast<double>(
+      asio::chrono::duration_cast<asio::chrono::nanoseconds>(
+        elapsed).count()) / iterations;
+}
+
+struct asio_copy
+{
+  const std::vector<asio::mutable_buffer>* target;
+  const std::vector<asio::const_buffer>* source;
+  std::size_t operator()() const { return asio::buffer_copy(*target, *source); }
+};
+
+struct memcpy_copy
+{
+  const std::vector<asio::mutable_buffer>* target;
+  const std::vector<asio::const_buffer>* source;
+  std::size_t operator()() const { return reference_copy(*target, *source); }
+};
+
+// Run one scenario: copy a source made of pieces of the given size into a
+// target made of pieces of another size. Pieces are adjacent in memory, or
+// separated by a gap of one byte.
+void run(const char* name, std::size_t source_piece, std::size_t target_piece,
+    std::size_t total, bool adjacent, int iterations)
+{
+  std::size_t stride = adjacent ? 0 : 1;
+  std::size_t source_pieces = total / source_piece;
+  std::size_t target_pieces = total / target_piece;
+  std::vector<char> source_data(source_pieces * (source_piece + stride), 'x');
+  std::vector<char> target_data(target_pieces * (target_piece + stride));
+
+  std::vector<asio::const_buffer> source;
+  for (std::size_t i = 0; i < source_pieces; ++i)
+    source.push_back(asio::buffer(
+          &source_data[i * (source_piece + stride)], source_piece));
+
+  std::vector<asio::mutable_buffer> target;
+  for (std::size_t i = 0; i < target_pieces; ++i)
+    target.push_back(asio::buffer(
+          &target_data[i * (target_piece + stride)], target_piece));
+
+  std::size_t checksum = 0;
+  asio_copy f1 = { &target, &source };
+  memcpy_copy f2 = { &target, &source };
+  double ns1 = time_copies(f1, iterations, checksum);
+  double ns2 = time_copies(f2, iterations, checksum);
+
+  std::printf("%-28s %12.1f %12.1f %8.2fx\n",
+      name, ns2, ns1, ns1 > 0 ? ns2 / ns1 : 0.0);
+  if (checksum == 0)
+    std::printf("no bytes copied\n");
+}
+
+int main(int argc, char* argv[])
+{
+  int scale = argc > 1 ? std::atoi(argv[1]) : 1;
+  if (scale < 1)
+  {
+    std::fprintf(stderr, "Usage: buffer_copy [<scale>]\n");
+    return 1;
+  }
+
+  std::printf("%-28s %12s %12s %9s\n",
+      "scenario", "memcpy ns", "buffer_copy", "speedup");
+  run("64 x 8 byte gather", 8, 512, 512, false, 200000 * scale);
+  run("64 x 8 byte adjacent gather", 8, 512, 512, true, 200000 * scale);
+  run("256 x 3 byte gather", 3, 768, 768, false, 100000 * scale);
+  run("16 x 4096 byte scatter", 65536, 4096, 65536, false, 10000 * scale);
+  run("1 KiB pieces, both sides", 1024, 1000, 1024 * 1000, false, 200 * scale);
+  run("64 MiB single block", 64 << 20, 64 << 20, 64 << 20, false, 5 * scale);
+  return 0;
+}
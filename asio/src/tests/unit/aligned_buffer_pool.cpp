@@ -0,0 +1,156 @@
+//
+// aligned_buffer_pool.cpp
+// ~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+// Disable autolinking for unit tests.
+#if !defined(BOOST_ALL_NO_LIB)
+#define BOOST_ALL_NO_LIB 1
+#endif // !defined(BOOST_ALL_NO_LIB)
+
+// Test that header file is self-contained.
+#include "asio/aligned_buffer_pool.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include "asio/io_context.hpp"
+#include "asio/random_access_file.hpp"
+#include "asio/system_error.hpp"
+#include "unit_test.hpp"
+
+//------------------------------------------------------------------------------
+
+// aligned_buffer_pool_runtime test
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// The following test checks the runtime operation of the aligned_buffer_pool
+// class.
+
+namespace aligned_buffer_pool_runtime {
+
+void test()
+{
+  using namespace asio;
+
+  io_context ioc;
+  aligned_buffer_pool pool(ioc, 1000, 3, 512);
+
+  ASIO_CHECK(pool.alignment() == 512);
+  ASIO_CHECK(pool.buffer_size() == 1024);
+  ASIO_CHECK(pool.size() == 3);
+  ASIO_CHECK(pool.available() == 3);
+
+  mutable_registered_buffer b1 = pool.acquire();
+  mutable_registered_buffer b2 = pool.acquire();
+  mutable_registered_buffer b3 = pool.acquire();
+  ASIO_CHECK(b1.size() == 1024);
+  ASIO_CHECK(reinterpret_cast<asio::uintptr_t>(b1.data()) % 512 == 0);
+  ASIO_CHECK(reinterpret_cast<asio::uintptr_t>(b2.data()) % 512 == 0);
+  ASIO_CHECK(reinterpret_cast<asio::uintptr_t>(b3.data()) % 512 == 0);
+  ASIO_CHECK(b1.data() != b2.data() && b2.data() != b3.data());
+  ASIO_CHECK(pool.available() == 0);
+
+  // An exhausted pool hands out an invalid buffer.
+  mutable_registered_buffer b4 = pool.acquire();
+  ASIO_CHECK(b4.size() == 0);
+  ASIO_CHECK(b4.id() == registered_buffer_id());
+
+  // Buffers may be returned after being advanced.
+  b2 += 100;
+  pool.release(b2);
+  pool.release(b4);
+  ASIO_CHECK(pool.available() == 1);
+  mutable_registered_buffer b5 = pool.acquire();
+  ASIO_CHECK(b5.id() == b2.id());
+  ASIO_CHECK(b5.size() == 1024);
+
+  pool.release(b1);
+  pool.release(b3);
+  pool.release(b5);
+  ASIO_CHECK(pool.available() == 3);
+
+  // A buffer that has already been returned is not added to the pool again.
+  pool.release(b1);
+  pool.release(b5);
+  ASIO_CHECK(pool.available() == 3);
+  b1 = pool.acquire();
+  b2 = pool.acquire();
+  b3 = pool.acquire();
+  ASIO_CHECK(b1.data() != b2.data() && b2.data() != b3.data());
+  ASIO_CHECK(b1.data() != b3.data());
+  ASIO_CHECK(pool.available() == 0);
+  ASIO_CHECK(pool.acquire().size() == 0);
+  pool.release(b1);
+  pool.release(b2);
+  pool.release(b3);
+
+  bool thrown = false;
+  try
+  {
+    aligned_buffer_pool bad_pool(ioc.get_executor(), 1000, 1, 3000);
+  }
+  catch (asio::system_error& e)
+  {
+    thrown = true;
+    ASIO_CHECK(e.code() == asio::error::invalid_argument);
+  }
+  ASIO_CHECK(thrown);
+}
+
+void test_direct_io()
+{
+#if defined(ASIO_HAS_FILE)
+  using namespace asio;
+
+  const char* path = "aligned_buffer_pool_runtime.tmp";
+
+  io_context ioc;
+  random_access_file file(ioc);
+  asio::error_code ec;
+  file.open(path, random_access_file::read_write
+      | random_access_file::create | random_access_file::truncate
+      | random_access_file::direct_io, ec);
+  if (ec)
+  {
+    // Not every file system supports direct I/O.
+    std::remove(path);
+    return;
+  }
+
+  std::size_t alignment = file.alignment();
+  ASIO_CHECK(alignment > 0);
+  ASIO_CHECK((alignment & (alignment - 1)) == 0);
+
+  aligned_buffer_pool pool(ioc, alignment, 2, alignment);
+  mutable_registered_buffer out = pool.acquire();
+  mutable_registered_buffer in = pool.acquire();
+  std::memset(out.data(), 'x', out.size());
+  std::memset(in.data(), 0, in.size());
+
+  std::size_t n = file.write_some_at(0, out, ec);
+  ASIO_CHECK(!ec);
+  ASIO_CHECK(n == out.size());
+  n = file.read_some_at(0, in, ec);
+  ASIO_CHECK(!ec);
+  ASIO_CHECK(n == in.size());
+  ASIO_CHECK(std::memcmp(in.data(), out.data(), n) == 0);
+
+  file.close();
+  std::remove(path);
+#endif // defined(ASIO_HAS_FILE)
+}
+
+} // namespace aligned_buffer_pool_runtime
+
+//------------------------------------------------------------------------------
+
+ASIO_TEST_SUITE
+(
+  "aligned_buffer_pool",
+  ASIO_TEST_CASE(aligned_buffer_pool_runtime::test)
+  ASIO_TEST_CASE(aligned_buffer_pool_runtime::test_direct_io)
+)
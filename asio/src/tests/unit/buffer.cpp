@@ -16,6 +16,10 @@
 // Test that header file is self-contained.
 #include "asio/buffer.hpp"
 
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
 #include "unit_test.hpp"
 
 #if defined(ASIO_HAS_BOOST_ARRAY)
@@ -631,6 +635,69 @@ void test()
   ASIO_CHECK(memcmp(dest_data, source_data, n) == 0);
 }
 
+void test_sizes()
+{
+  // Copy between sequences of many small pieces, some of them adjacent in
+  // memory, for every copy size up to a limit.
+  std::vector<char> source_data(300), dest_data(300);
+  for (std::size_t i = 0; i < source_data.size(); ++i)
+    source_data[i] = static_cast<char>(i * 7 + 1);
+
+  std::vector<const_buffer> source;
+  for (std::size_t i = 0, size = 0; i < 280; i += size + (size % 3 == 0))
+  {
+    size = i % 19;
+    source.push_back(asio::buffer(&source_data[i], size));
+  }
+  std::string expected;
+  for (std::size_t i = 0; i < source.size(); ++i)
+    expected.append(static_cast<const char*>(source[i].data()),
+        source[i].size());
+
+  std::vector<mutable_buffer> dest;
+  for (std::size_t i = 0, size = 0; i < 280; i += size + (size % 4 == 0))
+  {
+    size = i % 23;
+    dest.push_back(asio::buffer(&dest_data[i], size));
+  }
+
+  for (std::size_t max = 0; max <= expected.size() + 1; ++max)
+  {
+    std::fill(dest_data.begin(), dest_data.end(), 0);
+    std::size_t n = buffer_copy(dest, source, max);
+    ASIO_CHECK(n == (std::min)(max, (std::min)(
+            buffer_size(dest), buffer_size(source))));
+
+    std::string actual;
+    for (std::size_t i = 0; i < dest.size() && actual.size() < n; ++i)
+      actual.append(static_cast<const char*>(dest[i].data()),
+          (std::min)(dest[i].size(), n - actual.size()));
+    ASIO_CHECK(actual == expected.substr(0, n));
+
+    std::fill(dest_data.begin(), dest_data.end(), 0);
+    n = buffer_copy(asio::buffer(dest_data), source, max);
+    ASIO_CHECK(n == (std::min)(max, expected.size()));
+    ASIO_CHECK(std::string(&dest_data[0], n) == expected.substr(0, n));
+  }
+
+  // Copy blocks large enough to bypass the cache, at odd alignments.
+  std::vector<char> large_source(5 * 1024 * 1024 + 100);
+  std::vector<char> large_dest(large_source.size());
+  for (std::size_t i = 0; i < large_source.size(); ++i)
+    large_source[i] = static_cast<char>(i % 251);
+  for (std::size_t offset = 0; offset < 20; offset += 7)
+  {
+    std::fill(large_dest.begin(), large_dest.end(), 0);
+    std::size_t size = large_source.size() - 20;
+    std::size_t n = buffer_copy(asio::buffer(&large_dest[offset], size),
+        asio::buffer(&large_source[20 - offset], size));
+    ASIO_CHECK(n == size);
+    ASIO_CHECK(memcmp(&large_dest[offset],
+          &large_source[20 - offset], size) == 0);
+    ASIO_CHECK(large_dest[offset + size] == 0);
+  }
+}
+
 } // namespace buffer_copy_runtime
 
 //------------------------------------------------------------------------------
@@ -874,5 +941,6 @@ ASIO_TEST_SUITE
   "buffer",
   ASIO_COMPILE_TEST_CASE(buffer_compile::test)
   ASIO_TEST_CASE(buffer_copy_runtime::test)
+  ASIO_TEST_CASE(buffer_copy_runtime::test_sizes)
   ASIO_TEST_CASE(buffer_sequence::test)
 )
@@ -16,6 +16,9 @@
 // Test that header file is self-contained.
 #include "asio/buffers_iterator.hpp"
 
+#include <algorithm>
+#include <string>
+#include <vector>
 #include "asio/buffer.hpp"
 #include "unit_test.hpp"
 
@@ -285,8 +288,100 @@ void test()
 
 //------------------------------------------------------------------------------
 
+// buffers_iterator_algorithms test
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// The following test checks that the segment-aware algorithms give the same
+// results as the standard algorithms, for buffer sequences split in many
+// different ways.
+
+namespace buffers_iterator_algorithms {
+
+typedef std::vector<asio::const_buffer> buffers_type;
+typedef asio::buffers_iterator<buffers_type> iterator;
+
+// Split the data into four buffers, one of them empty.
+buffers_type split(const std::string& data, std::size_t i, std::size_t j)
+{
+  buffers_type buffers;
+  buffers.push_back(asio::buffer(data.data(), i));
+  buffers.push_back(asio::const_buffer());
+  buffers.push_back(asio::buffer(data.data() + i, j - i));
+  buffers.push_back(asio::buffer(data.data() + j, data.size() - j));
+  return buffers;
+}
+
+void test()
+{
+  std::string data;
+  for (int i = 0; i < 40; ++i)
+    data += (i % 3 == 0) ? "xy\r\n" : "xyz";
+  std::string other(data);
+  other[77] = '!';
+
+  for (std::size_t i = 0; i <= data.size(); i += 7)
+  {
+    for (std::size_t j = i; j <= data.size(); j += 11)
+    {
+      buffers_type buffers = split(data, i, j);
+      iterator begin = asio::buffers_begin(buffers);
+      iterator end = asio::buffers_end(buffers);
+      buffers_type other_buffers = split(other, j, j);
+
+      for (std::size_t k = 0; k < data.size(); k += 13)
+      {
+        iterator first = begin + k;
+        std::string::iterator data_first = data.begin() + k;
+
+        ASIO_CHECK(asio::find(first, end, '\r') - begin
+            == std::find(data_first, data.end(), '\r') - data.begin());
+        ASIO_CHECK(asio::find(first, end, '!') == end);
+
+        ASIO_CHECK(asio::count(first, end, 'y')
+            == std::count(data_first, data.end(), 'y'));
+
+        const char* patterns[] = { "z", "\r\n", "zxy\r", "z!", "yzxyzxy\r" };
+        for (std::size_t p = 0; p < sizeof(patterns) / sizeof(patterns[0]);
+            ++p)
+        {
+          std::string pattern(patterns[p]);
+          std::ptrdiff_t expected = std::search(data_first, data.end(),
+              pattern.begin(), pattern.end()) - data.begin();
+          ASIO_CHECK(asio::search(first, end,
+                pattern.begin(), pattern.end()) - begin == expected);
+          ASIO_CHECK(asio::search(first, end, pattern.data(),
+                pattern.data() + pattern.size()) - begin == expected);
+        }
+
+        std::string copied(data.size() - k, '\0');
+        ASIO_CHECK(asio::copy(first, end, &copied[0])
+            == &copied[0] + copied.size());
+        ASIO_CHECK(copied == data.substr(k));
+
+        ASIO_CHECK(asio::equal(first, end, data_first));
+        ASIO_CHECK(asio::equal(first, end, asio::buffers_begin(
+                other_buffers) + k) == (k > 77));
+        std::pair<iterator, std::string::iterator> result1 =
+          asio::mismatch(first, end, other.begin() + k);
+        std::pair<iterator, iterator> result2 = asio::mismatch(
+            first, end, asio::buffers_begin(other_buffers) + k);
+        std::ptrdiff_t expected = k > 77 ? data.size() : 77;
+        ASIO_CHECK(result1.first - begin == expected);
+        ASIO_CHECK(result1.second - other.begin() == expected);
+        ASIO_CHECK(result2.first - begin == expected);
+        ASIO_CHECK(result2.second - asio::buffers_begin(other_buffers)
+            == expected);
+      }
+    }
+  }
+}
+
+} // namespace buffers_iterator_algorithms
+
+//------------------------------------------------------------------------------
+
 ASIO_TEST_SUITE
 (
   "buffers_iterator",
   ASIO_COMPILE_TEST_CASE(buffers_iterator_compile::test)
+  ASIO_TEST_CASE(buffers_iterator_algorithms::test)
 )
@@ -0,0 +1,234 @@
+//
+// copy_file.cpp
+// ~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+// Disable autolinking for unit tests.
+#if !defined(BOOST_ALL_NO_LIB)
+#define BOOST_ALL_NO_LIB 1
+#endif // !defined(BOOST_ALL_NO_LIB)
+
+// Test that header file is self-contained.
+#include "asio/copy_file.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "archetypes/async_result.hpp"
+#include "asio/bind_cancellation_slot.hpp"
+#include "asio/cancellation_signal.hpp"
+#include "asio/io_context.hpp"
+#include "asio/random_access_file.hpp"
+#include "unit_test.hpp"
+
+#if defined(ASIO_HAS_BOOST_BIND)
+# include <boost/bind/bind.hpp>
+#else // defined(ASIO_HAS_BOOST_BIND)
+# include <functional>
+#endif // defined(ASIO_HAS_BOOST_BIND)
+
+//------------------------------------------------------------------------------
+
+// copy_file_compile test
+// ~~~~~~~~~~~~~~~~~~~~~~
+// The following test checks that the async_copy_file overloads compile and
+// link correctly. Runtime failures are ignored.
+
+namespace copy_file_compile {
+
+struct copy_handler
+{
+  copy_handler() {}
+  void operator()(const asio::error_code&, asio::uint64_t) {}
+#if defined(ASIO_HAS_MOVE)
+  copy_handler(copy_handler&&) {}
+private:
+  copy_handler(const copy_handler&);
+#endif // defined(ASIO_HAS_MOVE)
+};
+
+struct progress_handler
+{
+  void operator()(asio::uint64_t) {}
+};
+
+void test()
+{
+#if defined(ASIO_HAS_FILE)
+  using namespace asio;
+
+  try
+  {
+    io_context ioc;
+    archetypes::lazy_handler lazy;
+
+    random_access_file file1(ioc);
+    random_access_file file2(ioc);
+
+    async_copy_file(file1, file2, 0, 1, copy_handler());
+    int i1 = async_copy_file(file1, file2, 0, 1, lazy);
+    (void)i1;
+
+    async_copy_file(file1, file2, 0, 1, progress_handler(), copy_handler());
+    int i2 = async_copy_file(file1, file2, 0, 1, progress_handler(), lazy);
+    (void)i2;
+  }
+  catch (std::exception&)
+  {
+  }
+#endif // defined(ASIO_HAS_FILE)
+}
+
+} // namespace copy_file_compile
+
+//------------------------------------------------------------------------------
+
+// copy_file_runtime test
+// ~~~~~~~~~~~~~~~~~~~~~~
+// The following test checks the runtime operation of the async_copy_file
+// function.
+
+namespace copy_file_runtime {
+
+void handle_copy(const asio::error_code& err, asio::uint64_t n,
+    asio::error_code* out_err, asio::uint64_t* out_n)
+{
+  *out_err = err;
+  *out_n = n;
+}
+
+void handle_progress(asio::uint64_t n, std::vector<asio::uint64_t>* out)
+{
+  out->push_back(n);
+}
+
+void handle_progress_and_cancel(asio::uint64_t n,
+    asio::cancellation_signal* signal, asio::uint64_t* out_n)
+{
+  *out_n = n;
+  signal->emit(asio::cancellation_type::partial);
+}
+
+bool check_contents(const char* path, const std::vector<char>& data,
+    std::size_t offset, std::size_t length)
+{
+  std::vector<char> read_data(length);
+  std::FILE* f = std::fopen(path, "rb");
+  if (!f)
+    return false;
+  bool result = std::fseek(f, static_cast<long>(offset), SEEK_SET) == 0
+    && std::fread(&read_data[0], 1, length, f) == length
+    && std::memcmp(&read_data[0], &data[offset], length) == 0;
+  std::fclose(f);
+  return result;
+}
+
+void test()
+{
+#if defined(ASIO_HAS_FILE)
+  using namespace asio;
+
+#if defined(ASIO_HAS_BOOST_BIND)
+  namespace bindns = boost;
+#else // defined(ASIO_HAS_BOOST_BIND)
+  namespace bindns = std;
+#endif // defined(ASIO_HAS_BOOST_BIND)
+  using bindns::placeholders::_1;
+  using bindns::placeholders::_2;
+
+  const char* source_path = "copy_file_runtime_source.tmp";
+  const char* target_path = "copy_file_runtime_target.tmp";
+  const std::size_t data_size = 3 * 1024 * 1024 + 123;
+
+  std::vector<char> data(data_size);
+  for (std::size_t i = 0; i < data_size; ++i)
+    data[i] = static_cast<char>(i * 7 + i / 4096);
+
+  io_context ioc;
+  random_access_file source(ioc, source_path, random_access_file::read_write
+      | random_access_file::create | random_access_file::truncate);
+  random_access_file target(ioc, target_path, random_access_file::read_write
+      | random_access_file::create | random_access_file::truncate);
+  source.write_some_at(0, buffer(data));
+  asio::error_code err;
+  uint64_t n = 0;
+
+  // The whole file is copied, with progress reported for each chunk.
+  std::vector<uint64_t> progress;
+  async_copy_file(source, target, 0, data_size,
+      bindns::bind(handle_progress, _1, &progress),
+      bindns::bind(handle_copy, _1, _2, &err, &n));
+  ioc.run();
+  ASIO_CHECK(!err);
+  ASIO_CHECK(n == data_size);
+  ASIO_CHECK(target.size() == data_size);
+  ASIO_CHECK(!progress.empty());
+  ASIO_CHECK(progress.size() >= 4);
+  ASIO_CHECK(progress.back() == data_size);
+  for (std::size_t i = 1; i < progress.size(); ++i)
+    ASIO_CHECK(progress[i] > progress[i - 1]);
+  ASIO_CHECK(check_contents(target_path, data, 0, data_size));
+
+  // A copy that runs past the end of the source stops there.
+  target.resize(0);
+  ioc.restart();
+  async_copy_file(source, target, data_size - 100, 1000,
+      bindns::bind(handle_copy, _1, _2, &err, &n));
+  ioc.run();
+  ASIO_CHECK(err == asio::error::eof);
+  ASIO_CHECK(n == 100);
+  ASIO_CHECK(target.size() == data_size);
+  ASIO_CHECK(check_contents(target_path, data, data_size - 100, 100));
+
+  // A copy of nothing completes immediately.
+  ioc.restart();
+  async_copy_file(source, target, 0, 0,
+      bindns::bind(handle_copy, _1, _2, &err, &n));
+  ioc.run();
+  ASIO_CHECK(!err);
+  ASIO_CHECK(n == 0);
+
+  // Cancellation takes effect between chunks.
+  cancellation_signal signal;
+  uint64_t progress_n = 0;
+  ioc.restart();
+  async_copy_file(source, target, 0, data_size,
+      bindns::bind(handle_progress_and_cancel, _1, &signal, &progress_n),
+      bind_cancellation_slot(signal.slot(),
+        bindns::bind(handle_copy, _1, _2, &err, &n)));
+  ioc.run();
+  ASIO_CHECK(err == asio::error::operation_aborted);
+  ASIO_CHECK(n > 0);
+  ASIO_CHECK(n < data_size);
+  ASIO_CHECK(n == progress_n);
+
+  // Copies to a closed file fail.
+  target.close();
+  ioc.restart();
+  async_copy_file(source, target, 0, data_size,
+      bindns::bind(handle_copy, _1, _2, &err, &n));
+  ioc.run();
+  ASIO_CHECK(err == asio::error::bad_descriptor);
+  ASIO_CHECK(n == 0);
+
+  source.close();
+  std::remove(source_path);
+  std::remove(target_path);
+#endif // defined(ASIO_HAS_FILE)
+}
+
+} // namespace copy_file_runtime
+
+//------------------------------------------------------------------------------
+
+ASIO_TEST_SUITE
+(
+  "copy_file",
+  ASIO_COMPILE_TEST_CASE(copy_file_compile::test)
+  ASIO_TEST_CASE(copy_file_runtime::test)
+)
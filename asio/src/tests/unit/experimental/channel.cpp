@@ -17,9 +17,11 @@
 #include "asio/experimental/channel.hpp"
 
 #include <utility>
+#include <vector>
 #include "asio/error.hpp"
 #include "asio/io_context.hpp"
 #include "../unit_test.hpp"
+#include "channel_batch.hpp"
 
 using namespace asio;
 using namespace asio::experimental;
@@ -157,9 +159,27 @@ void buffered_channel_test()
   ASIO_CHECK(!ec2);
 };
 
+void batch_receive_channel_test()
+{
+  channel_batch::receive_test<channel>();
+}
+
+void batch_send_channel_test()
+{
+  channel_batch::send_test<channel>();
+}
+
+void async_batch_send_channel_test()
+{
+  channel_batch::async_send_test<channel>();
+}
+
 ASIO_TEST_SUITE
 (
   "experimental/channel",
   ASIO_TEST_CASE(unbuffered_channel_test)
   ASIO_TEST_CASE(buffered_channel_test)
+  ASIO_TEST_CASE(batch_receive_channel_test)
+  ASIO_TEST_CASE(batch_send_channel_test)
+  ASIO_TEST_CASE(async_batch_send_channel_test)
 )
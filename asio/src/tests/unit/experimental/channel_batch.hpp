@@ -0,0 +1,263 @@
+//
+// experimental/channel_batch.hpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef EXPERIMENTAL_CHANNEL_BATCH_HPP
+#define EXPERIMENTAL_CHANNEL_BATCH_HPP
+
+#include <cstddef>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "asio/error.hpp"
+#include "asio/experimental/channel_error.hpp"
+#include "asio/io_context.hpp"
+#include "../unit_test.hpp"
+
+// Tests of the batch operations, shared by all channel types.
+namespace channel_batch {
+
+template <template <typename, typename...> class Channel>
+void receive_test()
+{
+  asio::io_context ctx;
+
+  Channel<void(asio::error_code, int)> ch1(ctx, 8);
+
+  std::size_t n1 = ch1.try_send_n(5, asio::error_code(), 42);
+
+  ASIO_CHECK(n1 == 5);
+
+  std::vector<int> v1;
+  std::size_t n2 = ch1.try_receive_n(3,
+      [&](asio::error_code, int i)
+      {
+        v1.push_back(i);
+      });
+
+  ASIO_CHECK(n2 == 3);
+  ASIO_CHECK(v1.size() == 3);
+
+  for (int i = 0; i < 4; ++i)
+    ch1.try_send(asio::error_code(), i);
+  ch1.try_send(asio::error::eof, 4);
+  ch1.try_send(asio::error_code(), 5);
+
+  asio::error_code ec1;
+  std::vector<int> v2;
+  ch1.async_receive_batch(100,
+      [&](asio::error_code ec, std::vector<int> v)
+      {
+        ec1 = ec;
+        v2 = std::move(v);
+      });
+
+  ctx.run();
+
+  // The batch ends with the first message that carries an error.
+  ASIO_CHECK(ec1 == asio::error::eof);
+  ASIO_CHECK(v2.size() == 7);
+  ASIO_CHECK(v2[0] == 42 && v2[1] == 42);
+  ASIO_CHECK(v2[2] == 0 && v2[5] == 3 && v2[6] == 4);
+
+  asio::error_code ec2;
+  std::vector<int> v3;
+  ch1.async_receive_batch(2,
+      [&](asio::error_code ec, std::vector<int> v)
+      {
+        ec2 = ec;
+        v3 = std::move(v);
+      });
+
+  ctx.restart();
+  ctx.run();
+
+  ASIO_CHECK(!ec2);
+  ASIO_CHECK(v3.size() == 1 && v3[0] == 5);
+
+  asio::error_code ec3;
+  std::vector<int> v4(1);
+  ch1.async_receive_batch(2,
+      [&](asio::error_code ec, std::vector<int> v)
+      {
+        ec3 = ec;
+        v4 = std::move(v);
+      });
+
+  ch1.close();
+  ctx.restart();
+  ctx.run();
+
+  ASIO_CHECK(ec3 == asio::experimental::error::channel_closed);
+  ASIO_CHECK(v4.empty());
+}
+
+template <template <typename, typename...> class Channel>
+void send_test()
+{
+  asio::io_context ctx;
+
+  std::vector<int> values;
+  for (int i = 0; i < 6; ++i)
+    values.push_back(i);
+
+  std::vector<int> received;
+  auto receive = [&](asio::error_code ec, int i)
+  {
+    ASIO_CHECK(!ec);
+    received.push_back(i);
+  };
+
+  // Distinct messages are sent in order, until the buffer is full.
+  Channel<void(asio::error_code, int)> ch1(ctx, 4);
+
+  std::size_t n1 = ch1.try_send_batch(values.begin(), values.end());
+
+  ASIO_CHECK(n1 == 4);
+  ASIO_CHECK(ch1.try_receive_n(10, receive) == 4);
+
+  std::size_t n2 = ch1.try_send_batch(values.begin() + n1, values.end());
+
+  ASIO_CHECK(n2 == 2);
+  ASIO_CHECK(ch1.try_receive_n(10, receive) == 2);
+  ASIO_CHECK(received == values);
+
+  // Waiting receivers are given messages from the batch.
+  Channel<void(asio::error_code, int)> ch2(ctx);
+  received.clear();
+  ch2.async_receive(receive);
+  ch2.async_receive(receive);
+
+  std::size_t n3 = ch2.try_send_batch(values.begin(), values.end());
+
+  ASIO_CHECK(n3 == 2);
+
+  ctx.run();
+
+  ASIO_CHECK(received.size() == 2);
+  ASIO_CHECK(received[0] == 0 && received[1] == 1);
+
+  // Messages with several arguments are sent from tuples.
+  Channel<void(asio::error_code, int, std::string)> ch3(ctx, 4);
+  std::vector<std::tuple<int, std::string> > tuples;
+  tuples.push_back(std::make_tuple(1, std::string("one")));
+  tuples.push_back(std::make_tuple(2, std::string("two")));
+
+  std::size_t n4 = ch3.try_send_batch(tuples.begin(), tuples.end());
+
+  ASIO_CHECK(n4 == 2);
+
+  asio::error_code ec1 = asio::error::would_block;
+  std::vector<std::tuple<int, std::string> > v1;
+  ch3.async_receive_batch(10,
+      [&](asio::error_code ec, std::vector<std::tuple<int, std::string> > v)
+      {
+        ec1 = ec;
+        v1 = std::move(v);
+      });
+
+  ctx.restart();
+  ctx.run();
+
+  ASIO_CHECK(!ec1);
+  ASIO_CHECK(v1 == tuples);
+}
+
+template <template <typename, typename...> class Channel>
+void async_send_test()
+{
+  asio::io_context ctx;
+
+  std::vector<int> values;
+  for (int i = 0; i < 5; ++i)
+    values.push_back(i);
+
+  std::vector<int> received;
+  auto receive = [&](asio::error_code, int i)
+  {
+    received.push_back(i);
+  };
+
+  // The batch waits for room whenever the buffer is full.
+  Channel<void(asio::error_code, int)> ch1(ctx, 2);
+
+  bool called = false;
+  asio::error_code ec1 = asio::error::would_block;
+  std::size_t n1 = 0;
+  ch1.async_send_batch(values,
+      [&](asio::error_code ec, std::size_t n)
+      {
+        called = true;
+        ec1 = ec;
+        n1 = n;
+      });
+
+  ASIO_CHECK(!called);
+
+  for (int i = 0; i < 10 && !called; ++i)
+  {
+    ctx.restart();
+    ctx.poll();
+    ch1.try_receive_n(10, receive);
+  }
+
+  ASIO_CHECK(called);
+  ASIO_CHECK(!ec1);
+  ASIO_CHECK(n1 == 5);
+  ASIO_CHECK(received == values);
+
+  // The operation stops at the first message that cannot be sent.
+  Channel<void(asio::error_code, int)> ch2(ctx, 1);
+
+  called = false;
+  ch2.async_send_batch(values,
+      [&](asio::error_code ec, std::size_t n)
+      {
+        called = true;
+        ec1 = ec;
+        n1 = n;
+      });
+
+  ctx.restart();
+  ctx.poll();
+
+  ASIO_CHECK(!called);
+
+  ch2.cancel();
+  ctx.restart();
+  ctx.poll();
+
+  ASIO_CHECK(called);
+  ASIO_CHECK(ec1 == asio::experimental::error::channel_cancelled);
+  ASIO_CHECK(n1 == 1);
+
+  // An empty batch completes without sending anything.
+  called = false;
+  ch2.async_send_batch(std::vector<int>(),
+      [&](asio::error_code ec, std::size_t n)
+      {
+        called = true;
+        ec1 = ec;
+        n1 = n;
+      });
+
+  ASIO_CHECK(!called);
+
+  ctx.restart();
+  ctx.poll();
+
+  ASIO_CHECK(called);
+  ASIO_CHECK(!ec1);
+  ASIO_CHECK(n1 == 0);
+}
+
+} // namespace channel_batch
+
+#endif // EXPERIMENTAL_CHANNEL_BATCH_HPP
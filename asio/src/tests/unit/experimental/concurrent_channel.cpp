@@ -16,10 +16,17 @@
 // Test that header file is self-contained.
 #include "asio/experimental/concurrent_channel.hpp"
 
+#include <atomic>
+#include <stdexcept>
+#include <thread>
 #include <utility>
+#include <vector>
 #include "asio/error.hpp"
+#include "asio/executor_work_guard.hpp"
 #include "asio/io_context.hpp"
+#include "asio/thread.hpp"
 #include "../unit_test.hpp"
+#include "channel_batch.hpp"
 
 using namespace asio;
 using namespace asio::experimental;
@@ -157,9 +164,210 @@ void buffered_concurrent_channel_test()
   ASIO_CHECK(!ec2);
 };
 
+void fair_concurrent_channel_test()
+{
+  io_context ctx;
+
+  concurrent_channel<void(asio::error_code, int)> ch1(ctx, 2);
+
+  ASIO_CHECK(ch1.try_send(asio::error_code(), 1));
+  ASIO_CHECK(ch1.try_send(asio::error_code(), 2));
+
+  asio::error_code ec1 = asio::error::would_block;
+  ch1.async_send(asio::error_code(), 3,
+      [&](asio::error_code ec)
+      {
+        ec1 = ec;
+      });
+
+  std::vector<int> values;
+  auto receive = [&](asio::error_code, int i)
+  {
+    values.push_back(i);
+  };
+
+  // The space freed by a receive goes to the queued sender, not to a new one.
+  ASIO_CHECK(ch1.try_receive(receive));
+  ASIO_CHECK(!ch1.try_send(asio::error_code(), 4));
+
+  while (ch1.try_receive(receive))
+    ;
+
+  ctx.run();
+
+  ASIO_CHECK(!ec1);
+  ASIO_CHECK(values.size() == 3);
+  ASIO_CHECK(values[0] == 1);
+  ASIO_CHECK(values[1] == 2);
+  ASIO_CHECK(values[2] == 3);
+}
+
+struct throwing_value
+{
+  explicit throwing_value(int v = 0)
+    : value(v)
+  {
+  }
+
+  throwing_value(const throwing_value& other)
+    : value(other.value)
+  {
+    if (value < 0)
+      throw std::runtime_error("throwing_value");
+  }
+
+  int value;
+};
+
+void throwing_concurrent_channel_test()
+{
+  io_context ctx;
+
+  concurrent_channel<void(asio::error_code, throwing_value)> ch1(ctx, 2);
+
+  int received = 0;
+  auto receive = [&](asio::error_code, throwing_value v)
+  {
+    received = v.value;
+  };
+
+  // A value that throws while it is added to the ring leaves a skipped cell,
+  // which must not stop later values from being received.
+  for (int i = 1; i <= 5; ++i)
+  {
+    bool threw = false;
+    try
+    {
+      ch1.try_send(asio::error_code(), throwing_value(-i));
+    }
+    catch (std::runtime_error&)
+    {
+      threw = true;
+    }
+    ASIO_CHECK(threw);
+
+    ASIO_CHECK(ch1.try_send(asio::error_code(), throwing_value(i)));
+    ASIO_CHECK(ch1.try_receive(receive));
+    ASIO_CHECK(received == i);
+    ASIO_CHECK(!ch1.try_receive(receive));
+  }
+}
+
+struct concurrent_channel_consumer
+{
+  concurrent_channel<void(asio::error_code, int)>* ch;
+  std::atomic<int>* received;
+  std::vector<int>* last;
+  bool* in_order;
+
+  void operator()(asio::error_code ec, int value)
+  {
+    if (ec)
+      return;
+
+    int producer = value / 100000;
+    int sequence = value % 100000;
+    if (sequence <= (*last)[producer])
+      *in_order = false;
+    (*last)[producer] = sequence;
+    ++*received;
+
+    ch->async_receive(*this);
+  }
+};
+
+void multithreaded_concurrent_channel_test()
+{
+  const int producers = 4;
+  const int messages = 20000;
+
+  io_context ctx;
+  executor_work_guard<io_context::executor_type> work = make_work_guard(ctx);
+  concurrent_channel<void(asio::error_code, int)> ch1(ctx, 16);
+
+  // Each consumer chain is implicitly serialised, so it can check that it
+  // sees every producer's values in increasing order.
+  std::atomic<int> received(0);
+  std::vector<int> last1(producers, -1), last2(producers, -1);
+  bool in_order1 = true, in_order2 = true;
+  concurrent_channel_consumer c1 = { &ch1, &received, &last1, &in_order1 };
+  concurrent_channel_consumer c2 = { &ch1, &received, &last2, &in_order2 };
+  ch1.async_receive(c1);
+  ch1.async_receive(c2);
+
+  std::vector<int> last3(producers, -1);
+  bool in_order3 = true;
+  int try_received = 0;
+
+  std::vector<asio::thread*> threads;
+  for (int p = 0; p < producers; ++p)
+  {
+    threads.push_back(new asio::thread(
+          [&ch1, p]()
+          {
+            for (int i = 0; i < messages; ++i)
+              while (!ch1.try_send(asio::error_code(), p * 100000 + i))
+                std::this_thread::yield();
+          }));
+  }
+  threads.push_back(new asio::thread([&ctx](){ ctx.run(); }));
+  threads.push_back(new asio::thread([&ctx](){ ctx.run(); }));
+
+  // Compete with the asynchronous consumers using the synchronous fast path.
+  while (received.load() + try_received < producers * messages)
+  {
+    ch1.try_receive(
+        [&](asio::error_code, int value)
+        {
+          int producer = value / 100000;
+          int sequence = value % 100000;
+          if (sequence <= last3[producer])
+            in_order3 = false;
+          last3[producer] = sequence;
+          ++try_received;
+        });
+  }
+
+  ch1.close();
+  work.reset();
+
+  for (std::size_t i = 0; i < threads.size(); ++i)
+  {
+    threads[i]->join();
+    delete threads[i];
+  }
+
+  ASIO_CHECK(received.load() + try_received == producers * messages);
+  ASIO_CHECK(in_order1);
+  ASIO_CHECK(in_order2);
+  ASIO_CHECK(in_order3);
+  ASIO_CHECK(!ch1.try_receive([](asio::error_code, int){}));
+}
+
+void batch_receive_concurrent_channel_test()
+{
+  channel_batch::receive_test<concurrent_channel>();
+}
+
+void batch_send_concurrent_channel_test()
+{
+  channel_batch::send_test<concurrent_channel>();
+}
+
+void async_batch_send_concurrent_channel_test()
+{
+  channel_batch::async_send_test<concurrent_channel>();
+}
+
 ASIO_TEST_SUITE
 (
   "experimental/concurrent_channel",
   ASIO_TEST_CASE(unbuffered_concurrent_channel_test)
   ASIO_TEST_CASE(buffered_concurrent_channel_test)
+  ASIO_TEST_CASE(fair_concurrent_channel_test)
+  ASIO_TEST_CASE(throwing_concurrent_channel_test)
+  ASIO_TEST_CASE(batch_receive_concurrent_channel_test)
+  ASIO_TEST_CASE(batch_send_concurrent_channel_test)
+  ASIO_TEST_CASE(async_batch_send_concurrent_channel_test)
+  ASIO_TEST_CASE(multithreaded_concurrent_channel_test)
 )
@@ -317,9 +317,47 @@ void strand_wrap_test()
 #endif // !defined(ASIO_NO_DEPRECATED)
 }
 
+void strand_lifetime_test()
+{
+  io_context ioc;
+  int count = 0;
+
+  // Handlers posted through a strand are still invoked after the strand and
+  // all of its copies have been destroyed.
+  {
+    io_context::strand s1(ioc);
+    io_context::strand s2(s1);
+    ASIO_CHECK(s1 == s2);
+
+    post(s1, bindns::bind(increment, &count));
+    post(s2, bindns::bind(increment, &count));
+  }
+
+  // Strands that are created after the previous ones have been destroyed may
+  // reuse their implementation.
+  io_context::strand s3(ioc);
+  io_context::strand s4(ioc);
+  post(s3, bindns::bind(increment, &count));
+  post(s4, bindns::bind(increment, &count));
+
+#if defined(ASIO_ENABLE_DEDICATED_STRAND_IMPLEMENTATIONS)
+  // Unrelated strands never share an implementation.
+  ASIO_CHECK(s3 != s4);
+#endif // defined(ASIO_ENABLE_DEDICATED_STRAND_IMPLEMENTATIONS)
+
+  // No handlers can be called until run() is called.
+  ASIO_CHECK(count == 0);
+
+  ioc.run();
+
+  // The run() call will not return until all work has finished.
+  ASIO_CHECK(count == 4);
+}
+
 ASIO_TEST_SUITE
 (
   "strand",
   ASIO_TEST_CASE(strand_test)
   ASIO_TEST_CASE(strand_wrap_test)
+  ASIO_TEST_CASE(strand_lifetime_test)
 )
@@ -0,0 +1,17 @@
+//
+// io_context_strand_dedicated.cpp
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+// Run the io_context::strand tests against the dedicated strand
+// implementations. These change the layout of strand_service, and so this
+// test is always built header-only.
+#undef ASIO_SEPARATE_COMPILATION
+#define ASIO_ENABLE_DEDICATED_STRAND_IMPLEMENTATIONS 1
+
+#include "io_context_strand.cpp"
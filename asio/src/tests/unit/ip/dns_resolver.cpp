@@ -0,0 +1,565 @@
+//
+// dns_resolver.cpp
+// ~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+// Disable autolinking for unit tests.
+#if !defined(BOOST_ALL_NO_LIB)
+#define BOOST_ALL_NO_LIB 1
+#endif // !defined(BOOST_ALL_NO_LIB)
+
+// Resolve names using the DNS resolver, configured from files written by the
+// test.
+#define ASIO_USE_DNS_RESOLVER 1
+#define ASIO_DNS_RESOLV_CONF_PATH "dns_resolver_test.resolv.conf"
+#define ASIO_DNS_HOSTS_PATH "dns_resolver_test.hosts"
+
+// Test that header file is self-contained.
+#include "asio/ip/tcp.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "asio/bind_cancellation_slot.hpp"
+#include "asio/cancellation_signal.hpp"
+#include "asio/io_context.hpp"
+#include "asio/ip/udp.hpp"
+#include "asio/read.hpp"
+#include "asio/write.hpp"
+#include "asio/detail/atomic_count.hpp"
+#include "asio/detail/thread.hpp"
+#include "../unit_test.hpp"
+
+#if defined(ASIO_HAS_BOOST_BIND)
+# include <boost/bind/bind.hpp>
+#else // defined(ASIO_HAS_BOOST_BIND)
+# include <functional>
+#endif // defined(ASIO_HAS_BOOST_BIND)
+
+//------------------------------------------------------------------------------
+
+// ip_dns_resolver_runtime test
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// The following test checks the runtime operation of the resolver against a
+// name server running on the loopback interface.
+
+namespace ip_dns_resolver_runtime {
+
+#if defined(ASIO_HAS_DNS_RESOLVER)
+
+#if defined(ASIO_HAS_BOOST_BIND)
+namespace bindns = boost;
+#else // defined(ASIO_HAS_BOOST_BIND)
+namespace bindns = std;
+#endif
+
+using asio::ip::tcp;
+using asio::ip::udp;
+
+typedef std::vector<unsigned char> message;
+
+// The number of queries received by the name server.
+asio::detail::atomic_count queries_received(0);
+
+void put_u16(message& m, int n)
+{
+  m.push_back(static_cast<unsigned char>((n >> 8) & 0xFF));
+  m.push_back(static_cast<unsigned char>(n & 0xFF));
+}
+
+void put_name(message& m, const std::string& name)
+{
+  std::size_t start = 0;
+  while (start < name.size())
+  {
+    std::size_t end = name.find('.', start);
+    if (end == std::string::npos)
+      end = name.size();
+    m.push_back(static_cast<unsigned char>(end - start));
+    m.insert(m.end(), name.begin() + start, name.begin() + end);
+    start = end + 1;
+  }
+  m.push_back(0);
+}
+
+void put_u32(message& m, long n)
+{
+  put_u16(m, static_cast<int>((n >> 16) & 0xFFFF));
+  put_u16(m, static_cast<int>(n & 0xFFFF));
+}
+
+void put_record(message& m, const std::string& owner,
+    int type, const message& rdata, long ttl = 300)
+{
+  put_name(m, owner);
+  put_u16(m, type);
+  put_u16(m, 1);
+  put_u32(m, ttl);
+  put_u16(m, static_cast<int>(rdata.size()));
+  m.insert(m.end(), rdata.begin(), rdata.end());
+}
+
+message address_rdata(const asio::ip::address& a)
+{
+  message rdata;
+  if (a.is_v4())
+  {
+    asio::ip::address_v4::bytes_type b = a.to_v4().to_bytes();
+    rdata.assign(b.begin(), b.end());
+  }
+  else
+  {
+    asio::ip::address_v6::bytes_type b = a.to_v6().to_bytes();
+    rdata.assign(b.begin(), b.end());
+  }
+  return rdata;
+}
+
+message name_rdata(const std::string& name)
+{
+  message rdata;
+  put_name(rdata, name);
+  return rdata;
+}
+
+// Build the response to a query. Returns an empty message if the query should
+// not be answered.
+message make_response(const unsigned char* q, std::size_t n, bool over_tcp)
+{
+  const int type_a = 1, type_cname = 5, type_soa = 6;
+  const int type_ptr = 12, type_aaaa = 28;
+
+  ++queries_received;
+
+  std::string name;
+  std::size_t pos = 12;
+  while (pos < n && q[pos] != 0)
+  {
+    if (!name.empty())
+      name += '.';
+    name.append(reinterpret_cast<const char*>(q + pos + 1), q[pos]);
+    pos += 1 + q[pos];
+  }
+  int type = (q[pos + 1] << 8) | q[pos + 2];
+
+  int rcode = 0;
+  bool truncated = false;
+  message answers;
+  int count = 0;
+  message authority;
+  int authority_count = 0;
+
+  std::string owner = name;
+  if (name == "slow.example.test")
+    return message();
+  if (name == "alias.example.test")
+  {
+    put_record(answers, owner, type_cname, name_rdata("www.example.test"));
+    ++count;
+    owner = "www.example.test";
+  }
+
+  if (owner == "www.example.test")
+  {
+    if (type == type_a)
+      put_record(answers, owner, type_a,
+          address_rdata(asio::ip::make_address("192.0.2.1")));
+    else
+      put_record(answers, owner, type_aaaa,
+          address_rdata(asio::ip::make_address("2001:db8::1")));
+    ++count;
+  }
+  else if (name == "short.example.test")
+  {
+    if (type == type_a)
+    {
+      put_record(answers, owner, type_a,
+          address_rdata(asio::ip::make_address("192.0.2.2")));
+      ++count;
+    }
+  }
+  else if (name == "big.example.test")
+  {
+    if (!over_tcp)
+      truncated = true;
+    else if (type == type_a)
+    {
+      for (; count < 40; ++count)
+      {
+        asio::ip::address_v4::bytes_type b = {{ 192, 0, 2,
+          static_cast<unsigned char>(100 + count) }};
+        put_record(answers, owner, type_a,
+            address_rdata(asio::ip::address_v4(b)));
+      }
+    }
+  }
+  else if (name == "brief.example.test")
+  {
+    if (type == type_a)
+    {
+      put_record(answers, owner, type_a,
+          address_rdata(asio::ip::make_address("192.0.2.3")), 0);
+      ++count;
+    }
+  }
+  else if (name == "gone.example.test")
+  {
+    // A negative answer that may be cached for the SOA minimum.
+    message soa = name_rdata("ns.example.test");
+    message rname = name_rdata("admin.example.test");
+    soa.insert(soa.end(), rname.begin(), rname.end());
+    for (int i = 0; i < 4; ++i)
+      put_u32(soa, 3600);
+    put_u32(soa, 60);
+    put_record(authority, "example.test", type_soa, soa);
+    ++authority_count;
+    rcode = 3;
+  }
+  else if (name == "1.2.0.192.in-addr.arpa" && type == type_ptr)
+  {
+    put_record(answers, owner, type_ptr, name_rdata("www.example.test"));
+    ++count;
+  }
+  else
+  {
+    rcode = 3;
+  }
+
+  message m(q, q + 2);
+  put_u16(m, 0x8180 | (truncated ? 0x0200 : 0) | rcode);
+  put_u16(m, 1);
+  put_u16(m, truncated ? 0 : count);
+  put_u16(m, truncated ? 0 : authority_count);
+  put_u16(m, 0);
+  m.insert(m.end(), q + 12, q + pos + 5);
+  if (!truncated)
+  {
+    m.insert(m.end(), answers.begin(), answers.end());
+    m.insert(m.end(), authority.begin(), authority.end());
+  }
+  return m;
+}
+
+// A name server that answers queries over UDP and TCP on the same port.
+class stub_server
+{
+public:
+  stub_server(asio::io_context& ioc)
+    : acceptor_(ioc, tcp::endpoint(asio::ip::address_v4::loopback(), 0)),
+      udp_socket_(ioc, udp::endpoint(asio::ip::address_v4::loopback(),
+            acceptor_.local_endpoint().port())),
+      tcp_socket_(ioc),
+      udp_buffer_(512)
+  {
+    start_receive();
+    start_accept();
+  }
+
+  unsigned short port() const
+  {
+    return acceptor_.local_endpoint().port();
+  }
+
+private:
+  void start_receive()
+  {
+    udp_socket_.async_receive_from(asio::buffer(udp_buffer_), sender_,
+        bindns::bind(&stub_server::handle_receive, this,
+          bindns::placeholders::_1, bindns::placeholders::_2));
+  }
+
+  void handle_receive(const asio::error_code& ec, std::size_t n)
+  {
+    if (ec == asio::error::operation_aborted)
+      return;
+    if (!ec)
+    {
+      message response = make_response(&udp_buffer_[0], n, false);
+      if (!response.empty())
+      {
+        asio::error_code ignored_ec;
+        udp_socket_.send_to(asio::buffer(response), sender_, 0, ignored_ec);
+      }
+    }
+    start_receive();
+  }
+
+  void start_accept()
+  {
+    acceptor_.async_accept(tcp_socket_,
+        bindns::bind(&stub_server::handle_accept, this,
+          bindns::placeholders::_1));
+  }
+
+  void handle_accept(const asio::error_code& ec)
+  {
+    if (ec == asio::error::operation_aborted)
+      return;
+    if (!ec)
+    {
+      asio::error_code ignored_ec;
+      unsigned char length[2];
+      asio::read(tcp_socket_, asio::buffer(length), ignored_ec);
+      message query((length[0] << 8) | length[1]);
+      asio::read(tcp_socket_, asio::buffer(query), ignored_ec);
+      message response = make_response(&query[0], query.size(), true);
+      length[0] = static_cast<unsigned char>(response.size() >> 8);
+      length[1] = static_cast<unsigned char>(response.size() & 0xFF);
+      asio::write(tcp_socket_, asio::buffer(length), ignored_ec);
+      asio::write(tcp_socket_, asio::buffer(response), ignored_ec);
+      tcp_socket_.close(ignored_ec);
+    }
+    start_accept();
+  }
+
+  tcp::acceptor acceptor_;
+  udp::socket udp_socket_;
+  tcp::socket tcp_socket_;
+  message udp_buffer_;
+  udp::endpoint sender_;
+};
+
+void run_server(asio::io_context* ioc)
+{
+  ioc->run();
+}
+
+void resolve_handler(const asio::error_code& ec,
+    const tcp::resolver::results_type& results,
+    asio::error_code* out_ec, tcp::resolver::results_type* out_results)
+{
+  *out_ec = ec;
+  *out_results = results;
+}
+
+bool contains(const tcp::resolver::results_type& results,
+    const char* address, unsigned short port)
+{
+  tcp::endpoint endpoint(asio::ip::make_address(address), port);
+  for (tcp::resolver::results_type::const_iterator i = results.begin();
+      i != results.end(); ++i)
+    if (i->endpoint() == endpoint)
+      return true;
+  return false;
+}
+
+void test()
+{
+  asio::io_context server_ioc;
+  stub_server server(server_ioc);
+  asio::executor_work_guard<asio::io_context::executor_type>
+    work = asio::make_work_guard(server_ioc);
+  asio::detail::thread server_thread(
+      bindns::bind(run_server, &server_ioc));
+
+  {
+    std::ofstream resolv_conf(ASIO_DNS_RESOLV_CONF_PATH);
+    resolv_conf << "# Test configuration\n";
+    resolv_conf << "nameserver 127.0.0.1:" << server.port() << "\n";
+    resolv_conf << "search example.test\n";
+    resolv_conf << "options ndots:1 timeout:1 attempts:1\n";
+    std::ofstream hosts(ASIO_DNS_HOSTS_PATH);
+    hosts << "192.0.2.7 hosted.example hosted # Comment\n";
+  }
+
+  asio::io_context ioc;
+  tcp::resolver resolver(ioc);
+  asio::error_code ec;
+  tcp::resolver::results_type results;
+
+  // Addresses of both families are queried in parallel.
+  resolver.async_resolve("www.example.test", "80",
+      bindns::bind(resolve_handler, bindns::placeholders::_1,
+        bindns::placeholders::_2, &ec, &results));
+  ioc.run();
+  ASIO_CHECK(!ec);
+  ASIO_CHECK(results.size() == 2);
+  ASIO_CHECK(contains(results, "192.0.2.1", 80));
+  ASIO_CHECK(contains(results, "2001:db8::1", 80));
+
+  // CNAME records are followed, and the canonical name may be requested.
+  results = resolver.resolve(tcp::v4(), "alias.example.test", "http",
+      tcp::resolver::canonical_name, ec);
+  ASIO_CHECK(!ec);
+  ASIO_CHECK(results.size() == 1);
+  ASIO_CHECK(contains(results, "192.0.2.1", 80));
+  ASIO_CHECK(results.begin()->host_name() == "www.example.test");
+
+  // Names with fewer than ndots dots are tried with the search domains.
+  results = resolver.resolve("short", "80", ec);
+  ASIO_CHECK(!ec);
+  ASIO_CHECK(results.size() == 1);
+  ASIO_CHECK(contains(results, "192.0.2.2", 80));
+
+  // Truncated responses are retried over TCP.
+  results = resolver.resolve(tcp::v4(), "big.example.test", "80", ec);
+  ASIO_CHECK(!ec);
+  ASIO_CHECK(results.size() == 40);
+  ASIO_CHECK(contains(results, "192.0.2.139", 80));
+
+  // Names that do not exist are reported as not found.
+  results = resolver.resolve("missing.example.test.", "80", ec);
+  ASIO_CHECK(ec == asio::error::host_not_found);
+  ASIO_CHECK(results.empty());
+
+  // Names in the hosts file are resolved without a query.
+  results = resolver.resolve("HOSTED", "80", ec);
+  ASIO_CHECK(!ec);
+  ASIO_CHECK(results.size() == 1);
+  ASIO_CHECK(contains(results, "192.0.2.7", 80));
+
+  // Numeric addresses are resolved without a query.
+  results = resolver.resolve("192.0.2.200", "80", ec);
+  ASIO_CHECK(!ec);
+  ASIO_CHECK(results.size() == 1);
+  ASIO_CHECK(contains(results, "192.0.2.200", 80));
+
+  // Endpoints are resolved using PTR records, falling back to the numeric
+  // form of the address.
+  results = resolver.resolve(
+      tcp::endpoint(asio::ip::make_address("192.0.2.1"), 80), ec);
+  ASIO_CHECK(!ec);
+  ASIO_CHECK(results.size() == 1);
+  ASIO_CHECK(results.begin()->host_name() == "www.example.test");
+  results = resolver.resolve(
+      tcp::endpoint(asio::ip::make_address("192.0.2.9"), 80), ec);
+  ASIO_CHECK(!ec);
+  ASIO_CHECK(results.size() == 1);
+  ASIO_CHECK(results.begin()->host_name() == "192.0.2.9");
+
+  // Servers that do not respond cause a temporary failure.
+  results = resolver.resolve("slow.example.test.", "80", ec);
+  ASIO_CHECK(ec == asio::error::host_not_found_try_again);
+
+  // Outstanding operations may be cancelled using the resolver.
+  ioc.restart();
+  resolver.async_resolve("slow.example.test.", "80",
+      bindns::bind(resolve_handler, bindns::placeholders::_1,
+        bindns::placeholders::_2, &ec, &results));
+  ioc.poll();
+  resolver.cancel();
+  ioc.run();
+  ASIO_CHECK(ec == asio::error::operation_aborted);
+
+  // Outstanding operations may be cancelled using a cancellation slot.
+  ioc.restart();
+  asio::cancellation_signal signal;
+  resolver.async_resolve("slow.example.test.", "80",
+      asio::bind_cancellation_slot(signal.slot(),
+        bindns::bind(resolve_handler, bindns::placeholders::_1,
+          bindns::placeholders::_2, &ec, &results)));
+  ioc.poll();
+  signal.emit(asio::cancellation_type::terminal);
+  ioc.run();
+  ASIO_CHECK(ec == asio::error::operation_aborted);
+
+  // When caching is enabled, concurrent lookups of the same query share one
+  // set of queries, and their results share the same entries.
+  resolver.enable_cache(16, 300, 300);
+  tcp::resolver resolver2(ioc);
+  asio::error_code ec2;
+  tcp::resolver::results_type results2;
+  long queries = queries_received;
+  ioc.restart();
+  resolver.async_resolve("www.example.test", "80",
+      bindns::bind(resolve_handler, bindns::placeholders::_1,
+        bindns::placeholders::_2, &ec, &results));
+  resolver2.async_resolve("www.example.test", "80",
+      bindns::bind(resolve_handler, bindns::placeholders::_1,
+        bindns::placeholders::_2, &ec2, &results2));
+  ioc.run();
+  ASIO_CHECK(!ec);
+  ASIO_CHECK(!ec2);
+  ASIO_CHECK(results.size() == 2);
+  ASIO_CHECK(results == results2);
+  ASIO_CHECK(queries_received == queries + 2);
+
+  // Cached results are used by later operations without a query.
+  results2 = resolver2.resolve("www.example.test", "80", ec2);
+  ASIO_CHECK(!ec2);
+  ASIO_CHECK(results == results2);
+  ioc.restart();
+  resolver2.async_resolve("www.example.test", "80",
+      bindns::bind(resolve_handler, bindns::placeholders::_1,
+        bindns::placeholders::_2, &ec2, &results2));
+  ioc.run();
+  ASIO_CHECK(!ec2);
+  ASIO_CHECK(results == results2);
+  ASIO_CHECK(queries_received == queries + 2);
+
+  // Results are not cached beyond their TTL.
+  queries = queries_received;
+  resolver.resolve(tcp::v4(), "brief.example.test", "80", ec);
+  ASIO_CHECK(!ec);
+  resolver.resolve(tcp::v4(), "brief.example.test", "80", ec);
+  ASIO_CHECK(!ec);
+  ASIO_CHECK(queries_received == queries + 2);
+
+  // Names that do not exist are cached only when the answer includes an SOA
+  // record.
+  queries = queries_received;
+  resolver.resolve(tcp::v4(), "missing.example.test.", "80", ec);
+  ASIO_CHECK(ec == asio::error::host_not_found);
+  resolver.resolve(tcp::v4(), "missing.example.test.", "80", ec);
+  ASIO_CHECK(ec == asio::error::host_not_found);
+  ASIO_CHECK(queries_received == queries + 2);
+  queries = queries_received;
+  resolver.resolve(tcp::v4(), "gone.example.test.", "80", ec);
+  ASIO_CHECK(ec == asio::error::host_not_found);
+  resolver.resolve(tcp::v4(), "gone.example.test.", "80", ec);
+  ASIO_CHECK(ec == asio::error::host_not_found);
+  ASIO_CHECK(queries_received == queries + 1);
+
+  // Cancelling one resolver does not affect another resolver's operation
+  // that waits for the same lookup.
+  ioc.restart();
+  resolver.async_resolve("slow.example.test.", "80",
+      bindns::bind(resolve_handler, bindns::placeholders::_1,
+        bindns::placeholders::_2, &ec, &results));
+  resolver2.async_resolve("slow.example.test.", "80",
+      bindns::bind(resolve_handler, bindns::placeholders::_1,
+        bindns::placeholders::_2, &ec2, &results2));
+  ioc.poll();
+  resolver.cancel();
+  ioc.run();
+  ASIO_CHECK(ec == asio::error::operation_aborted);
+  ASIO_CHECK(ec2 == asio::error::host_not_found_try_again);
+
+  // Disabling the cache discards the cached results.
+  resolver.disable_cache();
+  queries = queries_received;
+  resolver.resolve("www.example.test", "80", ec);
+  ASIO_CHECK(!ec);
+  ASIO_CHECK(queries_received == queries + 2);
+
+  work.reset();
+  server_ioc.stop();
+  server_thread.join();
+
+  std::remove(ASIO_DNS_RESOLV_CONF_PATH);
+  std::remove(ASIO_DNS_HOSTS_PATH);
+}
+
+#else // defined(ASIO_HAS_DNS_RESOLVER)
+
+void test()
+{
+}
+
+#endif // defined(ASIO_HAS_DNS_RESOLVER)
+
+} // namespace ip_dns_resolver_runtime
+
+//------------------------------------------------------------------------------
+
+ASIO_TEST_SUITE
+(
+  "ip/dns_resolver",
+  ASIO_TEST_CASE(ip_dns_resolver_runtime::test)
+)
@@ -20,6 +20,8 @@
 #include "asio/ip/tcp.hpp"
 
 #include <cstring>
+#include "asio/bind_cancellation_slot.hpp"
+#include "asio/cancellation_signal.hpp"
 #include "asio/io_context.hpp"
 #include "asio/read.hpp"
 #include "asio/write.hpp"
@@ -1099,6 +1101,16 @@ void test()
 
     resolver.cancel();
 
+    resolver.enable_cache();
+    resolver.enable_cache(16, 60, 0);
+    resolver.disable_cache();
+
+    resolver.set_thread_pool(2);
+    resolver.set_thread_pool(2, 16);
+    ip::tcp::resolver::thread_pool_statistics stats
+      = resolver.get_thread_pool_statistics();
+    (void)stats;
+
 #if !defined(ASIO_NO_DEPRECATED)
     ip::tcp::resolver::results_type results1 = resolver.resolve(q);
     (void)results1;
@@ -1200,6 +1212,239 @@ void test()
 
 //------------------------------------------------------------------------------
 
+// ip_tcp_resolver_runtime test
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// The following test checks the runtime operation of the threads used by the
+// ip::tcp::resolver class to perform lookups.
+
+namespace ip_tcp_resolver_runtime {
+
+struct resolve_counts
+{
+  int succeeded;
+  int aborted;
+  int rejected;
+};
+
+void handle_resolve(const asio::error_code& err,
+    const asio::ip::tcp::resolver::results_type&, resolve_counts* counts)
+{
+  if (!err)
+    ++counts->succeeded;
+  else if (err == asio::error::operation_aborted)
+    ++counts->aborted;
+  else if (err == asio::error::no_buffer_space)
+    ++counts->rejected;
+}
+
+void test()
+{
+#if defined(ASIO_HAS_BOOST_BIND)
+  namespace bindns = boost;
+#else // defined(ASIO_HAS_BOOST_BIND)
+  namespace bindns = std;
+#endif // defined(ASIO_HAS_BOOST_BIND)
+  using bindns::placeholders::_1;
+  using bindns::placeholders::_2;
+
+  using namespace asio;
+  namespace ip = asio::ip;
+  const int num_lookups = 16;
+
+  // Stopping the worker threads, as is done before a fork, holds lookups in
+  // the queue until the threads are restarted. When restarted, a thread is
+  // started for each queued lookup, up to the configured number of threads.
+  {
+    io_context ioc;
+    ip::tcp::resolver resolver(ioc);
+    resolver.set_thread_pool(4);
+    ioc.notify_fork(io_context::fork_prepare);
+    resolve_counts counts = { 0, 0, 0 };
+    for (int i = 0; i < num_lookups; ++i)
+      resolver.async_resolve("127.0.0.1", "80",
+          bindns::bind(handle_resolve, _1, _2, &counts));
+
+    ip::tcp::resolver::thread_pool_statistics stats
+      = resolver.get_thread_pool_statistics();
+    ASIO_CHECK(stats.threads == 0);
+    ASIO_CHECK(stats.queued == static_cast<std::size_t>(num_lookups));
+    ASIO_CHECK(stats.peak_queued == static_cast<std::size_t>(num_lookups));
+
+    ioc.notify_fork(io_context::fork_parent);
+    ioc.run();
+    ASIO_CHECK(counts.succeeded == num_lookups);
+
+    stats = resolver.get_thread_pool_statistics();
+    ASIO_CHECK(stats.threads == 4);
+    ASIO_CHECK(stats.lookups == static_cast<std::size_t>(num_lookups));
+    ASIO_CHECK(stats.queued == 0);
+    ASIO_CHECK(stats.rejected == 0);
+    ASIO_CHECK(stats.cancelled == 0);
+    ASIO_CHECK(stats.max_queue_time <= stats.total_queue_time);
+    ASIO_CHECK(stats.max_lookup_time <= stats.total_lookup_time);
+  }
+
+  // Cancelling the resolver removes queued lookups before they start.
+  {
+    io_context ioc;
+    ip::tcp::resolver resolver(ioc);
+    ioc.notify_fork(io_context::fork_prepare);
+    resolve_counts counts = { 0, 0, 0 };
+    for (int i = 0; i < num_lookups; ++i)
+      resolver.async_resolve("127.0.0.1", "80",
+          bindns::bind(handle_resolve, _1, _2, &counts));
+    resolver.cancel();
+    ioc.notify_fork(io_context::fork_parent);
+    ioc.run();
+    ASIO_CHECK(counts.aborted == num_lookups);
+
+    ip::tcp::resolver::thread_pool_statistics stats
+      = resolver.get_thread_pool_statistics();
+    ASIO_CHECK(stats.cancelled == static_cast<std::size_t>(num_lookups));
+    ASIO_CHECK(stats.lookups == 0);
+
+    // Lookups started after the cancellation are not affected by it.
+    resolver.async_resolve("127.0.0.1", "80",
+        bindns::bind(handle_resolve, _1, _2, &counts));
+    ioc.restart();
+    ioc.run();
+    ASIO_CHECK(counts.succeeded == 1);
+    ASIO_CHECK(resolver.get_thread_pool_statistics().lookups == 1);
+  }
+
+  // Queued lookups may be cancelled individually.
+  {
+    io_context ioc;
+    ip::tcp::resolver resolver(ioc);
+    ioc.notify_fork(io_context::fork_prepare);
+    resolve_counts counts = { 0, 0, 0 };
+    cancellation_signal signals[num_lookups];
+    for (int i = 0; i < num_lookups; ++i)
+      resolver.async_resolve("127.0.0.1", "80",
+          bind_cancellation_slot(signals[i].slot(),
+            bindns::bind(handle_resolve, _1, _2, &counts)));
+    for (int i = 0; i < num_lookups; i += 2)
+      signals[i].emit(cancellation_type::terminal);
+    ioc.notify_fork(io_context::fork_parent);
+    ioc.run();
+    ASIO_CHECK(counts.succeeded == num_lookups / 2);
+    ASIO_CHECK(counts.aborted == num_lookups / 2);
+
+    ip::tcp::resolver::thread_pool_statistics stats
+      = resolver.get_thread_pool_statistics();
+    ASIO_CHECK(stats.cancelled == static_cast<std::size_t>(num_lookups / 2));
+    ASIO_CHECK(stats.lookups == static_cast<std::size_t>(num_lookups / 2));
+  }
+
+  // Lookups are rejected when the queue is full.
+  {
+    io_context ioc;
+    ip::tcp::resolver resolver(ioc);
+    resolver.set_thread_pool(1, 2);
+    ioc.notify_fork(io_context::fork_prepare);
+    resolve_counts counts = { 0, 0, 0 };
+    for (int i = 0; i < num_lookups; ++i)
+      resolver.async_resolve("127.0.0.1", "80",
+          bindns::bind(handle_resolve, _1, _2, &counts));
+    ioc.notify_fork(io_context::fork_parent);
+    ioc.run();
+    ASIO_CHECK(counts.succeeded == 2);
+    ASIO_CHECK(counts.rejected == num_lookups - 2);
+    ASIO_CHECK(counts.rejected > 0);
+
+    ip::tcp::resolver::thread_pool_statistics stats
+      = resolver.get_thread_pool_statistics();
+    ASIO_CHECK(stats.threads == 1);
+    ASIO_CHECK(stats.rejected == static_cast<std::size_t>(num_lookups - 2));
+    ASIO_CHECK(stats.peak_queued == 2);
+  }
+}
+
+void handle_resolve_results(const asio::error_code& err,
+    const asio::ip::tcp::resolver::results_type& results,
+    asio::error_code* err_out,
+    asio::ip::tcp::resolver::results_type* results_out)
+{
+  *err_out = err;
+  *results_out = results;
+}
+
+void test_cache()
+{
+#if defined(ASIO_HAS_BOOST_BIND)
+  namespace bindns = boost;
+#else // defined(ASIO_HAS_BOOST_BIND)
+  namespace bindns = std;
+#endif // defined(ASIO_HAS_BOOST_BIND)
+  using bindns::placeholders::_1;
+  using bindns::placeholders::_2;
+
+  using namespace asio;
+  namespace ip = asio::ip;
+
+  io_context ioc;
+  ip::tcp::resolver resolver(ioc);
+  resolver.enable_cache();
+
+  // Operations for the same query share a single lookup.
+  error_code ec1, ec2;
+  ip::tcp::resolver::results_type results1, results2;
+  resolver.async_resolve("127.0.0.1", "80",
+      bindns::bind(handle_resolve_results, _1, _2, &ec1, &results1));
+  resolver.async_resolve("127.0.0.1", "80",
+      bindns::bind(handle_resolve_results, _1, _2, &ec2, &results2));
+  ioc.run();
+  ASIO_CHECK(!ec1);
+  ASIO_CHECK(!ec2);
+  ASIO_CHECK(!results1.empty());
+  ASIO_CHECK(results1 == results2);
+  ASIO_CHECK(results1.begin()->endpoint()
+      == ip::tcp::endpoint(ip::make_address("127.0.0.1"), 80));
+  ASIO_CHECK(resolver.get_thread_pool_statistics().lookups == 1);
+
+  // A later operation completes from the cache.
+  error_code ec3;
+  ip::tcp::resolver::results_type results3;
+  resolver.async_resolve("127.0.0.1", "80",
+      bindns::bind(handle_resolve_results, _1, _2, &ec3, &results3));
+  ioc.restart();
+  ioc.run();
+  ASIO_CHECK(!ec3);
+  ASIO_CHECK(results3 == results1);
+  ASIO_CHECK(resolver.get_thread_pool_statistics().lookups == 1);
+
+  // An operation waiting for a lookup may be cancelled individually. Stopping
+  // the worker threads, as is done before a fork, holds the lookup in the
+  // queue until the threads are restarted.
+  ioc.notify_fork(io_context::fork_prepare);
+  error_code ec4, ec5;
+  ip::tcp::resolver::results_type results4, results5;
+  cancellation_signal signal;
+  resolver.async_resolve("127.0.0.2", "80",
+      bindns::bind(handle_resolve_results, _1, _2, &ec4, &results4));
+  resolver.async_resolve("127.0.0.2", "80",
+      bind_cancellation_slot(signal.slot(),
+        bindns::bind(handle_resolve_results, _1, _2, &ec5, &results5)));
+  signal.emit(cancellation_type::terminal);
+  ioc.restart();
+  ioc.poll();
+  ASIO_CHECK(ec5 == asio::error::operation_aborted);
+  ASIO_CHECK(results5.empty());
+  ASIO_CHECK(resolver.get_thread_pool_statistics().queued == 1);
+
+  // The lookup continues for the operation that was not cancelled.
+  ioc.notify_fork(io_context::fork_parent);
+  ioc.run();
+  ASIO_CHECK(!ec4);
+  ASIO_CHECK(!results4.empty());
+  ASIO_CHECK(ec5 == asio::error::operation_aborted);
+  ASIO_CHECK(resolver.get_thread_pool_statistics().lookups == 2);
+}
+
+} // namespace ip_tcp_resolver_runtime
+
+//------------------------------------------------------------------------------
+
 // ip_tcp_resolver_entry_compile test
 // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 // The following test checks that all public member functions on the class
@@ -1345,6 +1590,8 @@ ASIO_TEST_SUITE
   ASIO_COMPILE_TEST_CASE(ip_tcp_acceptor_compile::test)
   ASIO_TEST_CASE(ip_tcp_acceptor_runtime::test)
   ASIO_COMPILE_TEST_CASE(ip_tcp_resolver_compile::test)
+  ASIO_TEST_CASE(ip_tcp_resolver_runtime::test)
+  ASIO_TEST_CASE(ip_tcp_resolver_runtime::test_cache)
   ASIO_COMPILE_TEST_CASE(ip_tcp_resolver_entry_compile::test)
   ASIO_COMPILE_TEST_CASE(ip_tcp_resolver_entry_compile::test)
   ASIO_COMPILE_TEST_CASE(ip_tcp_iostream_compile::test)
@@ -0,0 +1,259 @@
+//
+// mapped_file.cpp
+// ~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+// Disable autolinking for unit tests.
+#if !defined(BOOST_ALL_NO_LIB)
+#define BOOST_ALL_NO_LIB 1
+#endif // !defined(BOOST_ALL_NO_LIB)
+
+// Test that header file is self-contained.
+#include "asio/mapped_file.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include "archetypes/async_result.hpp"
+#include "asio/io_context.hpp"
+#include "unit_test.hpp"
+
+#if defined(ASIO_HAS_BOOST_BIND)
+# include <boost/bind/bind.hpp>
+#else // defined(ASIO_HAS_BOOST_BIND)
+# include <functional>
+#endif // defined(ASIO_HAS_BOOST_BIND)
+
+//------------------------------------------------------------------------------
+
+// mapped_file_compile test
+// ~~~~~~~~~~~~~~~~~~~~~~~~
+// The following test checks that all public member functions on the class
+// mapped_file compile and link correctly. Runtime failures are ignored.
+
+namespace mapped_file_compile {
+
+struct wait_handler
+{
+  wait_handler() {}
+  void operator()(const asio::error_code&) {}
+#if defined(ASIO_HAS_MOVE)
+  wait_handler(wait_handler&&) {}
+private:
+  wait_handler(const wait_handler&);
+#endif // defined(ASIO_HAS_MOVE)
+};
+
+void test()
+{
+#if defined(ASIO_HAS_MAPPED_FILE)
+  using namespace asio;
+
+  try
+  {
+    io_context ioc;
+    const io_context::executor_type ioc_ex = ioc.get_executor();
+    archetypes::lazy_handler lazy;
+    asio::error_code ec;
+    const std::string path;
+
+    // basic_mapped_file constructors.
+
+    mapped_file file1(ioc);
+    mapped_file file2(ioc, "", mapped_file::read_only);
+    mapped_file file3(ioc, path, mapped_file::read_only);
+
+    mapped_file file4(ioc_ex);
+    mapped_file file5(ioc_ex, "", mapped_file::read_only);
+    mapped_file file6(ioc_ex, path, mapped_file::read_only);
+
+#if defined(ASIO_HAS_MOVE)
+    mapped_file file7(std::move(file6));
+
+    basic_mapped_file<io_context::executor_type> file8(ioc);
+    mapped_file file9(std::move(file8));
+#endif // defined(ASIO_HAS_MOVE)
+
+    // basic_mapped_file operators.
+
+#if defined(ASIO_HAS_MOVE)
+    file1 = mapped_file(ioc);
+    file1 = std::move(file2);
+    file1 = std::move(file8);
+#endif // defined(ASIO_HAS_MOVE)
+
+    // basic_io_object functions.
+
+    mapped_file::executor_type ex = file1.get_executor();
+    (void)ex;
+
+    // basic_mapped_file functions.
+
+    file1.open("", mapped_file::read_only);
+    file1.open("", mapped_file::read_only, ec);
+
+    file1.open(path, mapped_file::read_only);
+    file1.open(path, mapped_file::read_only, ec);
+
+    bool is_open = file1.is_open();
+    (void)is_open;
+
+    file1.close();
+    file1.close(ec);
+
+    std::size_t s1 = file1.size();
+    (void)s1;
+
+    const_buffer b1 = file1.data();
+    (void)b1;
+
+    const_buffer b2 = file1.data(0, 1);
+    (void)b2;
+
+    mutable_buffer b3 = file1.mutable_data();
+    (void)b3;
+
+    file1.sync();
+    file1.sync(ec);
+
+    file1.async_prefetch(0, 1, wait_handler());
+    int i1 = file1.async_prefetch(0, 1, lazy);
+    (void)i1;
+
+    file1.async_sync(wait_handler());
+    int i2 = file1.async_sync(lazy);
+    (void)i2;
+  }
+  catch (std::exception&)
+  {
+  }
+#endif // defined(ASIO_HAS_MAPPED_FILE)
+}
+
+} // namespace mapped_file_compile
+
+//------------------------------------------------------------------------------
+
+// mapped_file_runtime test
+// ~~~~~~~~~~~~~~~~~~~~~~~~
+// The following test checks the runtime operation of the mapped_file class.
+
+namespace mapped_file_runtime {
+
+void handle_wait(const asio::error_code& err, asio::error_code* out_err)
+{
+  *out_err = err;
+}
+
+void test()
+{
+#if defined(ASIO_HAS_MAPPED_FILE)
+  using namespace asio;
+
+#if defined(ASIO_HAS_BOOST_BIND)
+  namespace bindns = boost;
+#else // defined(ASIO_HAS_BOOST_BIND)
+  namespace bindns = std;
+#endif // defined(ASIO_HAS_BOOST_BIND)
+  using bindns::placeholders::_1;
+
+  const char* path = "mapped_file_runtime.tmp";
+  const char data[] = "0123456789abcdefghijklmnopqrstuv";
+  const std::size_t data_size = sizeof(data) - 1;
+
+  std::FILE* f = std::fopen(path, "wb");
+  ASIO_CHECK(f != 0);
+  if (!f)
+    return;
+  std::fwrite(data, 1, data_size, f);
+  std::fclose(f);
+
+  io_context ioc;
+  asio::error_code err;
+
+  mapped_file file(ioc, path, mapped_file::read_only);
+  ASIO_CHECK(file.is_open());
+  ASIO_CHECK(file.size() == data_size);
+  ASIO_CHECK(file.data().size() == data_size);
+  ASIO_CHECK(std::memcmp(file.data().data(), data, data_size) == 0);
+  ASIO_CHECK(file.data(4, 100).size() == data_size - 4);
+  ASIO_CHECK(std::memcmp(file.data(4, 100).data(), data + 4, 4) == 0);
+  ASIO_CHECK(file.mutable_data().size() == 0);
+
+  file.open(path, mapped_file::read_only, err);
+  ASIO_CHECK(err == asio::error::already_open);
+
+  file.async_prefetch(0, data_size, bindns::bind(handle_wait, _1, &err));
+  ioc.run();
+  ASIO_CHECK(!err);
+
+  // Ranges beyond the end of the file are ignored.
+  ioc.restart();
+  file.async_prefetch(data_size, 100, bindns::bind(handle_wait, _1, &err));
+  ioc.run();
+  ASIO_CHECK(!err);
+
+  // A read-only mapping has nothing to write back.
+  ioc.restart();
+  file.async_sync(bindns::bind(handle_wait, _1, &err));
+  ioc.run();
+  ASIO_CHECK(!err);
+
+  // The region stays mapped until an outstanding operation completes.
+  ioc.restart();
+  file.async_prefetch(0, data_size, bindns::bind(handle_wait, _1, &err));
+  file.close();
+  ASIO_CHECK(!file.is_open());
+  ASIO_CHECK(file.size() == 0);
+  ioc.run();
+  ASIO_CHECK(!err);
+
+  ioc.restart();
+  file.async_sync(bindns::bind(handle_wait, _1, &err));
+  ioc.run();
+  ASIO_CHECK(err == asio::error::bad_descriptor);
+
+  // Changes through a writable mapping reach the file.
+  file.open(path, mapped_file::read_write);
+  mutable_buffer b = file.mutable_data();
+  ASIO_CHECK(b.size() == data_size);
+  std::memcpy(b.data(), "ABCD", 4);
+  ioc.restart();
+  file.async_sync(bindns::bind(handle_wait, _1, &err));
+  ioc.run();
+  ASIO_CHECK(!err);
+  file.close();
+
+  char read_data[sizeof(data)] = "";
+  f = std::fopen(path, "rb");
+  ASIO_CHECK(f != 0);
+  if (f)
+  {
+    ASIO_CHECK(std::fread(read_data, 1, data_size, f) == data_size);
+    std::fclose(f);
+  }
+  ASIO_CHECK(std::memcmp(read_data, "ABCD", 4) == 0);
+  ASIO_CHECK(std::memcmp(read_data + 4, data + 4, data_size - 4) == 0);
+
+  std::remove(path);
+
+  file.open(path, mapped_file::read_only, err);
+  ASIO_CHECK(!!err);
+  ASIO_CHECK(!file.is_open());
+#endif // defined(ASIO_HAS_MAPPED_FILE)
+}
+
+} // namespace mapped_file_runtime
+
+//------------------------------------------------------------------------------
+
+ASIO_TEST_SUITE
+(
+  "mapped_file",
+  ASIO_COMPILE_TEST_CASE(mapped_file_compile::test)
+  ASIO_TEST_CASE(mapped_file_runtime::test)
+)
@@ -0,0 +1,330 @@
+//
+// pattern_matcher.cpp
+// ~~~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+// Disable autolinking for unit tests.
+#if !defined(BOOST_ALL_NO_LIB)
+#define BOOST_ALL_NO_LIB 1
+#endif // !defined(BOOST_ALL_NO_LIB)
+
+// Test that header file is self-contained.
+#include "asio/pattern_matcher.hpp"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "asio/io_context.hpp"
+#include "asio/post.hpp"
+#include "unit_test.hpp"
+
+#if defined(ASIO_HAS_BOOST_BIND)
+# include <boost/bind/bind.hpp>
+#else // defined(ASIO_HAS_BOOST_BIND)
+# include <functional>
+#endif // defined(ASIO_HAS_BOOST_BIND)
+
+//------------------------------------------------------------------------------
+
+// pattern_matcher_compile test
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// The following test checks that all public member functions on the class
+// pattern_matcher compile and link correctly. Runtime failures are ignored.
+
+namespace pattern_matcher_compile {
+
+void test()
+{
+  using namespace asio;
+
+  try
+  {
+    // pattern_matcher constructors.
+
+    pattern_matcher m1("\r\n");
+    pattern_matcher m2(std::vector<std::string>(1, "\n"));
+    pattern_matcher m3(m1);
+
+    // pattern_matcher functions.
+
+    std::string data("abc\r\n");
+    std::pair<std::string::iterator, bool> r1 = m1(data.begin(), data.end());
+    (void)r1;
+
+    std::size_t s1 = m1.matched_pattern();
+    (void)s1;
+
+    m1.reset();
+
+    ASIO_CHECK(is_match_condition<pattern_matcher>::value);
+  }
+  catch (std::exception&)
+  {
+  }
+}
+
+} // namespace pattern_matcher_compile
+
+//------------------------------------------------------------------------------
+
+// pattern_matcher_runtime test
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// The following test checks the runtime operation of the pattern_matcher
+// class.
+
+namespace pattern_matcher_runtime {
+
+// Find the end of the first match in a string, feeding the matcher in pieces
+// of the given size. Returns 0 if there is no match.
+std::size_t match_end(asio::pattern_matcher m,
+    const std::string& data, std::size_t piece)
+{
+  for (std::size_t i = 0; i < data.size(); i += piece)
+  {
+    std::string::const_iterator begin = data.begin() + i;
+    std::string::const_iterator end = data.begin()
+      + (std::min)(i + piece, data.size());
+    std::pair<std::string::const_iterator, bool> result = m(begin, end);
+    if (result.second)
+      return result.first - data.begin();
+    ASIO_CHECK(result.first == end);
+  }
+  return 0;
+}
+
+void test_literals()
+{
+  using namespace asio;
+
+  for (std::size_t piece = 1; piece <= 8; ++piece)
+  {
+    ASIO_CHECK(match_end(pattern_matcher("\r\n\r\n"),
+          "GET / HTTP/1.1\r\nHost: x\r\n\r\nbody", piece) == 27);
+    ASIO_CHECK(match_end(pattern_matcher("\r\n\r\n"),
+          "\r\n\r\r\n\r\r\n\r\n", piece) == 10);
+    ASIO_CHECK(match_end(pattern_matcher("\r\n\r\n"),
+          "\r\n\r\r\n", piece) == 0);
+    ASIO_CHECK(match_end(pattern_matcher("aab"), "aaaab", piece) == 5);
+  }
+
+  // The earliest ending match wins, whichever pattern it is for.
+  std::vector<std::string> patterns;
+  patterns.push_back("\r\n\r\n");
+  patterns.push_back("\n\n");
+  pattern_matcher m(patterns);
+  std::string data("abc\r\n\n\r\n\r\n");
+  std::pair<std::string::iterator, bool> result = m(data.begin(), data.end());
+  ASIO_CHECK(result.second);
+  ASIO_CHECK(result.first - data.begin() == 6);
+  ASIO_CHECK(m.matched_pattern() == 1);
+
+  // The search starts again after a match.
+  result = m(result.first, data.end());
+  ASIO_CHECK(result.second);
+  ASIO_CHECK(result.first == data.end());
+  ASIO_CHECK(m.matched_pattern() == 0);
+
+  // Alternatives share the index of their pattern.
+  ASIO_CHECK(match_end(pattern_matcher("xyz|\n"), "ab\ncd", 1) == 3);
+}
+
+void test_classes_and_quantifiers()
+{
+  using namespace asio;
+
+  for (std::size_t piece = 1; piece <= 4; ++piece)
+  {
+    ASIO_CHECK(match_end(pattern_matcher("\\d+;"), "ab;12;", piece) == 6);
+    ASIO_CHECK(match_end(pattern_matcher("a.c"), "abxaxc", piece) == 6);
+    ASIO_CHECK(match_end(pattern_matcher("[0-9a-f]+\r\n"),
+          "xyz\r\n1F\r\n3f\r\n", piece) == 13);
+    ASIO_CHECK(match_end(pattern_matcher("[^\\r\\n]\n"),
+          "\n\r\nab\n", piece) == 6);
+    ASIO_CHECK(match_end(pattern_matcher("ab?c"), "xacx", piece) == 3);
+    ASIO_CHECK(match_end(pattern_matcher("ab?c"), "xabcx", piece) == 4);
+    ASIO_CHECK(match_end(pattern_matcher("ab*c"), "xabbbbcx", piece) == 7);
+    ASIO_CHECK(match_end(pattern_matcher("\\s*;"), "a ;", piece) == 3);
+    ASIO_CHECK(match_end(pattern_matcher("\\w\\W"), "__-", piece) == 3);
+    ASIO_CHECK(match_end(pattern_matcher("\\|\\."), "a|.", piece) == 3);
+    ASIO_CHECK(match_end(pattern_matcher("[|]x"), "|x", piece) == 2);
+  }
+}
+
+void test_invalid()
+{
+  using namespace asio;
+
+  const char* invalid[] = { "", "a|", "*a", "a\\", "[ab", "(a)", "a*",
+    "\\q", "[z-a]", "x?|y" };
+  for (std::size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); ++i)
+  {
+    bool threw = false;
+    try
+    {
+      pattern_matcher m(invalid[i]);
+    }
+    catch (std::invalid_argument&)
+    {
+      threw = true;
+    }
+    ASIO_CHECK(threw);
+  }
+
+  bool threw = false;
+  try
+  {
+    pattern_matcher m((std::vector<std::string>()));
+  }
+  catch (std::invalid_argument&)
+  {
+    threw = true;
+  }
+  ASIO_CHECK(threw);
+}
+
+class test_stream
+{
+public:
+  typedef asio::io_context::executor_type executor_type;
+
+  test_stream(asio::io_context& io_context, const std::string& data)
+    : io_context_(io_context),
+      data_(data),
+      position_(0)
+  {
+  }
+
+  executor_type get_executor() ASIO_NOEXCEPT
+  {
+    return io_context_.get_executor();
+  }
+
+  template <typename Mutable_Buffers>
+  size_t read_some(const Mutable_Buffers& buffers,
+      asio::error_code& ec)
+  {
+    ec = asio::error_code();
+    size_t n = asio::buffer_copy(buffers,
+        asio::buffer(data_) + position_, 3);
+    position_ += n;
+    if (n == 0)
+      ec = asio::error::eof;
+    return n;
+  }
+
+  template <typename Mutable_Buffers, typename Handler>
+  void async_read_some(const Mutable_Buffers& buffers, Handler handler)
+  {
+    asio::error_code ec;
+    size_t bytes_transferred = read_some(buffers, ec);
+    asio::post(get_executor(),
+        asio::detail::bind_handler(
+          ASIO_MOVE_CAST(Handler)(handler),
+          ec, bytes_transferred));
+  }
+
+private:
+  asio::io_context& io_context_;
+  std::string data_;
+  size_t position_;
+};
+
+void async_read_handler(const asio::error_code& err,
+    asio::error_code* err_out, std::size_t bytes_transferred,
+    std::size_t* bytes_out, bool* called)
+{
+  *err_out = err;
+  *bytes_out = bytes_transferred;
+  *called = true;
+}
+
+void test_read_until()
+{
+#if defined(ASIO_HAS_BOOST_BIND)
+  namespace bindns = boost;
+#else // defined(ASIO_HAS_BOOST_BIND)
+  namespace bindns = std;
+#endif // defined(ASIO_HAS_BOOST_BIND)
+  using bindns::placeholders::_1;
+  using bindns::placeholders::_2;
+
+  using namespace asio;
+
+  pattern_matcher end_of_headers("\r\n\r\n|\n\n");
+  const std::string request("GET / HTTP/1.1\r\nHost: x\r\n\r\nbody");
+
+  io_context ioc;
+  test_stream s1(ioc, request);
+  std::string data;
+  error_code ec;
+  std::size_t length = read_until(s1,
+      dynamic_buffer(data), end_of_headers, ec);
+  ASIO_CHECK(!ec);
+  ASIO_CHECK(length == 27);
+
+  // The matcher passed in keeps its initial state, and so may be reused.
+  test_stream s2(ioc, request);
+  data.clear();
+  length = 0;
+  bool called = false;
+  async_read_until(s2, dynamic_buffer(data), end_of_headers,
+      bindns::bind(async_read_handler, _1, &ec,
+        _2, &length, &called));
+  ioc.run();
+  ASIO_CHECK(called);
+  ASIO_CHECK(!ec);
+  ASIO_CHECK(length == 27);
+
+  // The pattern matched by a copy used by the operation is reported by the
+  // matcher passed in.
+  std::vector<std::string> patterns;
+  patterns.push_back("\r\n\r\n");
+  patterns.push_back("\n\n");
+  pattern_matcher m(patterns);
+
+  test_stream s4(ioc, "GET / HTTP/1.1\nHost: x\n\nbody");
+  data.clear();
+  length = read_until(s4, dynamic_buffer(data), m, ec);
+  ASIO_CHECK(!ec);
+  ASIO_CHECK(length == 24);
+  ASIO_CHECK(m.matched_pattern() == 1);
+
+  test_stream s5(ioc, request);
+  data.clear();
+  length = 0;
+  called = false;
+  async_read_until(s5, dynamic_buffer(data), m,
+      bindns::bind(async_read_handler, _1, &ec,
+        _2, &length, &called));
+  ioc.restart();
+  ioc.run();
+  ASIO_CHECK(called);
+  ASIO_CHECK(!ec);
+  ASIO_CHECK(length == 27);
+  ASIO_CHECK(m.matched_pattern() == 0);
+
+  test_stream s3(ioc, "GET / HTTP/1.1\r\n\r");
+  data.clear();
+  length = read_until(s3, dynamic_buffer(data), end_of_headers, ec);
+  ASIO_CHECK(ec == asio::error::eof);
+  ASIO_CHECK(length == 0);
+}
+
+} // namespace pattern_matcher_runtime
+
+//------------------------------------------------------------------------------
+
+ASIO_TEST_SUITE
+(
+  "pattern_matcher",
+  ASIO_COMPILE_TEST_CASE(pattern_matcher_compile::test)
+  ASIO_TEST_CASE(pattern_matcher_runtime::test_literals)
+  ASIO_TEST_CASE(pattern_matcher_runtime::test_classes_and_quantifiers)
+  ASIO_TEST_CASE(pattern_matcher_runtime::test_invalid)
+  ASIO_TEST_CASE(pattern_matcher_runtime::test_read_until)
+)
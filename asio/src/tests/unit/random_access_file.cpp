@@ -16,10 +16,20 @@
 // Test that header file is self-contained.
 #include "asio/random_access_file.hpp"
 
+#include <cstdio>
+#include <cstring>
 #include "archetypes/async_result.hpp"
 #include "asio/io_context.hpp"
+#include "asio/read_at.hpp"
+#include "asio/write_at.hpp"
 #include "unit_test.hpp"
 
+#if defined(ASIO_HAS_BOOST_BIND)
+# include <boost/bind/bind.hpp>
+#else // defined(ASIO_HAS_BOOST_BIND)
+# include <functional>
+#endif // defined(ASIO_HAS_BOOST_BIND)
+
 // random_access_file_compile test
 // ~~~~~~~~~~~~~~~~~~~~~~~~
 // The following test checks that all public member functions on the class
@@ -27,6 +37,28 @@
 
 namespace random_access_file_compile {
 
+struct wait_handler
+{
+  wait_handler() {}
+  void operator()(const asio::error_code&) {}
+#if defined(ASIO_HAS_MOVE)
+  wait_handler(wait_handler&&) {}
+private:
+  wait_handler(const wait_handler&);
+#endif // defined(ASIO_HAS_MOVE)
+};
+
+struct size_handler
+{
+  size_handler() {}
+  void operator()(const asio::error_code&, asio::uint64_t) {}
+#if defined(ASIO_HAS_MOVE)
+  size_handler(size_handler&&) {}
+private:
+  size_handler(const size_handler&);
+#endif // defined(ASIO_HAS_MOVE)
+};
+
 struct write_some_at_handler
 {
   write_some_at_handler() {}
@@ -142,6 +174,37 @@ void test()
     file1.sync_data();
     file1.sync_data(ec);
 
+    file1.allocate(0, 0);
+    file1.allocate(0, 0, ec);
+
+    file1.async_open(path, random_access_file::read_only, wait_handler());
+    int i4 = file1.async_open(path, random_access_file::read_only, lazy);
+    (void)i4;
+
+    file1.async_close(wait_handler());
+    int i5 = file1.async_close(lazy);
+    (void)i5;
+
+    file1.async_size(size_handler());
+    int i6 = file1.async_size(lazy);
+    (void)i6;
+
+    file1.async_resize(0, wait_handler());
+    int i7 = file1.async_resize(0, lazy);
+    (void)i7;
+
+    file1.async_allocate(0, 0, wait_handler());
+    int i8 = file1.async_allocate(0, 0, lazy);
+    (void)i8;
+
+    file1.async_sync_all(wait_handler());
+    int i9 = file1.async_sync_all(lazy);
+    (void)i9;
+
+    file1.async_sync_data(wait_handler());
+    int i10 = file1.async_sync_data(lazy);
+    (void)i10;
+
     file1.write_some_at(0, buffer(mutable_char_buffer));
     file1.write_some_at(0, buffer(const_char_buffer));
     file1.write_some_at(0, buffer(mutable_char_buffer), ec);
@@ -163,6 +226,10 @@ void test()
         read_some_at_handler());
     int i3 = file1.async_read_some_at(0, buffer(mutable_char_buffer), lazy);
     (void)i3;
+
+    file1.async_copy_some_at(0, file2, 1, write_some_at_handler());
+    int i11 = file1.async_copy_some_at(0, file2, 1, lazy);
+    (void)i11;
   }
   catch (std::exception&)
   {
@@ -172,8 +239,165 @@ void test()
 
 } // namespace random_access_file_compile
 
+//------------------------------------------------------------------------------
+
+// random_access_file_runtime test
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// The following test checks the runtime operation of the random_access_file
+// class.
+
+namespace random_access_file_runtime {
+
+void handle_transfer(const asio::error_code& err, std::size_t n,
+    asio::error_code* out_err, std::size_t* out_n)
+{
+  *out_err = err;
+  *out_n = n;
+}
+
+void handle_wait(const asio::error_code& err, asio::error_code* out_err)
+{
+  *out_err = err;
+}
+
+void handle_size(const asio::error_code& err, asio::uint64_t n,
+    asio::error_code* out_err, asio::uint64_t* out_n)
+{
+  *out_err = err;
+  *out_n = n;
+}
+
+void test()
+{
+#if defined(ASIO_HAS_FILE)
+  using namespace asio;
+
+#if defined(ASIO_HAS_BOOST_BIND)
+  namespace bindns = boost;
+#else // defined(ASIO_HAS_BOOST_BIND)
+  namespace bindns = std;
+#endif // defined(ASIO_HAS_BOOST_BIND)
+  using bindns::placeholders::_1;
+  using bindns::placeholders::_2;
+
+  const char* path = "random_access_file_runtime.tmp";
+  const char data[] = "0123456789abcdefghijklmnopqrstuv";
+  const std::size_t data_size = sizeof(data) - 1;
+
+  io_context ioc;
+  random_access_file file(ioc, path, random_access_file::read_write
+      | random_access_file::create | random_access_file::truncate);
+  asio::error_code err;
+  std::size_t n = 0;
+
+  async_write_at(file, 0, buffer(data, data_size),
+      bindns::bind(handle_transfer, _1, _2, &err, &n));
+  ioc.run();
+  ASIO_CHECK(!err);
+  ASIO_CHECK(n == data_size);
+  ASIO_CHECK(file.size() == data_size);
+
+  // The data just written is cached, and so may be read without the pool.
+  char read_data[sizeof(data)] = "";
+  ioc.restart();
+  async_read_at(file, 4, buffer(read_data, data_size - 4),
+      bindns::bind(handle_transfer, _1, _2, &err, &n));
+  ioc.run();
+  ASIO_CHECK(!err);
+  ASIO_CHECK(n == data_size - 4);
+  ASIO_CHECK(std::memcmp(read_data, data + 4, data_size - 4) == 0);
+
+  ioc.restart();
+  file.async_read_some_at(data_size, buffer(read_data),
+      bindns::bind(handle_transfer, _1, _2, &err, &n));
+  ioc.run();
+  ASIO_CHECK(err == asio::error::eof);
+  ASIO_CHECK(n == 0);
+
+  // Writes that are abandoned by cancel() leave the file unchanged. The
+  // pool's threads are stopped, as for a fork, so that the write is still
+  // queued when it is cancelled.
+  file.set_thread_pool(1);
+  ioc.notify_fork(io_context::fork_prepare);
+  ioc.restart();
+  file.async_write_some_at(data_size, buffer(data, data_size),
+      bindns::bind(handle_transfer, _1, _2, &err, &n));
+  file.cancel();
+  ioc.notify_fork(io_context::fork_parent);
+  ioc.run();
+  ASIO_CHECK(err == asio::error::operation_aborted);
+  ASIO_CHECK(n == 0);
+  ASIO_CHECK(file.size() == data_size);
+
+  file.close();
+
+  // Files may be opened and closed without blocking the caller.
+  ioc.restart();
+  file.async_open(path, random_access_file::read_write,
+      bindns::bind(handle_wait, _1, &err));
+  ioc.run();
+  ASIO_CHECK(!err);
+  ASIO_CHECK(file.is_open());
+
+  asio::error_code open_err;
+  ioc.restart();
+  file.async_open(path, random_access_file::read_write,
+      bindns::bind(handle_wait, _1, &open_err));
+  ioc.run();
+  ASIO_CHECK(open_err == asio::error::already_open);
+
+  asio::uint64_t size = 0;
+  ioc.restart();
+  file.async_resize(1000, bindns::bind(handle_wait, _1, &err));
+  ioc.run();
+  ASIO_CHECK(!err);
+  ioc.restart();
+  file.async_size(bindns::bind(handle_size, _1, _2, &err, &size));
+  ioc.run();
+  ASIO_CHECK(!err);
+  ASIO_CHECK(size == 1000);
+
+  ioc.restart();
+  file.async_allocate(0, 4096, bindns::bind(handle_wait, _1, &err));
+  ioc.run();
+  ASIO_CHECK(!err || err == asio::error::operation_not_supported);
+  ASIO_CHECK(err || file.size() == 4096);
+
+  ioc.restart();
+  file.async_sync_all(bindns::bind(handle_wait, _1, &err));
+  ioc.run();
+  ASIO_CHECK(!err);
+  ioc.restart();
+  file.async_sync_data(bindns::bind(handle_wait, _1, &err));
+  ioc.run();
+  ASIO_CHECK(!err);
+
+  ioc.restart();
+  file.async_close(bindns::bind(handle_wait, _1, &err));
+  ASIO_CHECK(!file.is_open());
+  ioc.run();
+  ASIO_CHECK(!err);
+
+#if !defined(ASIO_HAS_IOCP)
+  // An open abandoned by close() leaves the file closed.
+  ioc.restart();
+  file.async_open(path, random_access_file::read_only,
+      bindns::bind(handle_wait, _1, &err));
+  file.close();
+  ioc.run();
+  ASIO_CHECK(err == asio::error::operation_aborted);
+  ASIO_CHECK(!file.is_open());
+#endif // !defined(ASIO_HAS_IOCP)
+
+  std::remove(path);
+#endif // defined(ASIO_HAS_FILE)
+}
+
+} // namespace random_access_file_runtime
+
 ASIO_TEST_SUITE
 (
   "random_access_file",
   ASIO_COMPILE_TEST_CASE(random_access_file_compile::test)
+  ASIO_TEST_CASE(random_access_file_runtime::test)
 )
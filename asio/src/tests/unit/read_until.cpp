@@ -17,6 +17,8 @@
 #include "asio/read_until.hpp"
 
 #include <cstring>
+#include <string>
+#include <vector>
 #include "archetypes/async_result.hpp"
 #include "asio/io_context.hpp"
 #include "asio/post.hpp"
@@ -1640,6 +1642,95 @@ void test_streambuf_async_read_until_match_condition()
 #endif // !defined(ASIO_NO_DYNAMIC_BUFFER_V1)
 }
 
+void test_buffer_sequence_search()
+{
+  // Compare the segmented searches against a naive search of the whole data,
+  // for many ways of splitting the data into three segments.
+  std::string data;
+  for (int i = 0; i < 100; ++i)
+    data += (i % 7 == 0) ? "\r\n\r" : "ab\rc";
+  data += "\r\n\r\nab\r\n\r";
+
+  const char* delims[] = { "\n", "\r\n\r\n", "ab\rc", "\r\n\r\n?" };
+  for (std::size_t d = 0; d < sizeof(delims) / sizeof(delims[0]); ++d)
+  {
+    std::string delim(delims[d]);
+    for (std::size_t i = 0; i <= data.size(); i += 13)
+    {
+      for (std::size_t j = i; j <= data.size(); j += 5)
+      {
+        std::vector<asio::const_buffer> buffers;
+        buffers.push_back(asio::buffer(data.data(), i));
+        buffers.push_back(asio::buffer(data.data() + i, j - i));
+        buffers.push_back(asio::buffer(data.data() + j, data.size() - j));
+
+        for (std::size_t start = 0; start < data.size(); start += 97)
+        {
+          std::pair<std::size_t, bool> result =
+            asio::detail::buffer_sequence_find(
+                buffers.begin(), buffers.end(), start, delim[0]);
+          std::size_t expected = data.find(delim[0], start);
+          ASIO_CHECK(result.second == (expected != std::string::npos));
+          ASIO_CHECK(result.first
+              == (result.second ? expected : data.size()));
+
+          result = asio::detail::buffer_sequence_search(buffers.begin(),
+              buffers.end(), start, delim.data(), delim.length());
+          expected = data.find(delim, start);
+          if (expected == std::string::npos)
+          {
+            // Look for a partial match at the end of the data.
+            expected = data.size();
+            for (std::size_t k = start; k < data.size(); ++k)
+            {
+              if (data.compare(k, std::string::npos,
+                    delim, 0, data.size() - k) == 0)
+              {
+                expected = k;
+                break;
+              }
+            }
+          }
+          ASIO_CHECK(result.second == (data.find(delim, start)
+                != std::string::npos));
+          ASIO_CHECK(result.first == expected);
+        }
+      }
+    }
+  }
+}
+
+void test_dynamic_string_read_until_long_string()
+{
+  asio::io_context ioc;
+  test_stream s(ioc);
+  std::string data(3000, 'x');
+  for (std::size_t i = 0; i < data.size(); i += 11)
+    data[i] = '\r';
+  data += "\r\n\r\n";
+  data += std::string(1000, 'y');
+  std::string data1;
+  asio::error_code ec;
+
+  for (std::size_t n = 1; n <= 64; n *= 2)
+  {
+    s.reset(data.data(), data.size());
+    s.next_read_length(n + 1);
+    data1.clear();
+    std::size_t length = asio::read_until(s,
+        asio::dynamic_buffer(data1), "\r\n\r\n", ec);
+    ASIO_CHECK(!ec);
+    ASIO_CHECK(length == 3004);
+
+    s.reset(data.data(), data.size());
+    s.next_read_length(n + 1);
+    data1.clear();
+    length = asio::read_until(s, asio::dynamic_buffer(data1), '\n', ec);
+    ASIO_CHECK(!ec);
+    ASIO_CHECK(length == 3002);
+  }
+}
+
 ASIO_TEST_SUITE
 (
   "read_until",
@@ -1655,4 +1746,6 @@ ASIO_TEST_SUITE
   ASIO_TEST_CASE(test_streambuf_async_read_until_string)
   ASIO_TEST_CASE(test_dynamic_string_async_read_until_match_condition)
   ASIO_TEST_CASE(test_streambuf_async_read_until_match_condition)
+  ASIO_TEST_CASE(test_buffer_sequence_search)
+  ASIO_TEST_CASE(test_dynamic_string_read_until_long_string)
 )
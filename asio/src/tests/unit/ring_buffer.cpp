@@ -0,0 +1,303 @@
+//
+// ring_buffer.cpp
+// ~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+// Disable autolinking for unit tests.
+#if !defined(BOOST_ALL_NO_LIB)
+#define BOOST_ALL_NO_LIB 1
+#endif // !defined(BOOST_ALL_NO_LIB)
+
+// Test that header file is self-contained.
+#include "asio/ring_buffer.hpp"
+
+#include <cstring>
+#include <string>
+#include "asio/io_context.hpp"
+#include "asio/local/connect_pair.hpp"
+#include "asio/local/stream_protocol.hpp"
+#include "asio/read_until.hpp"
+#include "asio/write.hpp"
+#include "unit_test.hpp"
+
+//------------------------------------------------------------------------------
+
+// ring_buffer_compile test
+// ~~~~~~~~~~~~~~~~~~~~~~~~
+// The following test checks that all public member functions on the classes
+// ring_buffer and dynamic_ring_buffer compile and link correctly. Runtime
+// failures are ignored.
+
+namespace ring_buffer_compile {
+
+void test()
+{
+#if defined(ASIO_HAS_RING_BUFFER)
+  using namespace asio;
+
+  try
+  {
+    // ring_buffer constructors.
+
+    ring_buffer rb1;
+    ring_buffer rb2(100);
+
+#if defined(ASIO_HAS_MOVE)
+    ring_buffer rb3(std::move(rb2));
+#endif // defined(ASIO_HAS_MOVE)
+
+    // ring_buffer operators.
+
+#if defined(ASIO_HAS_MOVE)
+    rb1 = std::move(rb3);
+    rb1 = ring_buffer(100);
+#endif // defined(ASIO_HAS_MOVE)
+
+    // ring_buffer functions.
+
+    std::size_t s1 = rb1.size();
+    (void)s1;
+
+    std::size_t s2 = rb1.capacity();
+    (void)s2;
+
+    mutable_buffer mb1 = rb1.data();
+    (void)mb1;
+
+    const ring_buffer& crb1 = rb1;
+    const_buffer cb1 = crb1.data();
+    (void)cb1;
+
+    rb1.reserve(200);
+    rb1.grow(10);
+    rb1.shrink(1);
+    rb1.consume(1);
+    rb1.clear();
+
+    // dynamic_ring_buffer constructors.
+
+    dynamic_ring_buffer db1(rb1);
+    dynamic_ring_buffer db2(rb1, 100);
+    dynamic_ring_buffer db3(db1);
+
+#if defined(ASIO_HAS_MOVE)
+    dynamic_ring_buffer db4(std::move(db3));
+#endif // defined(ASIO_HAS_MOVE)
+
+    // dynamic_ring_buffer functions.
+
+    std::size_t s3 = db1.size();
+    (void)s3;
+
+    std::size_t s4 = db1.max_size();
+    (void)s4;
+
+    std::size_t s5 = db1.capacity();
+    (void)s5;
+
+    dynamic_ring_buffer::mutable_buffers_type mb2 = db1.data(0, 1);
+    (void)mb2;
+
+    const dynamic_ring_buffer& cdb1 = db1;
+    dynamic_ring_buffer::const_buffers_type cb2 = cdb1.data(0, 1);
+    (void)cb2;
+
+    db1.grow(1);
+    db1.shrink(1);
+    db1.consume(1);
+
+    // dynamic_buffer overloads.
+
+    dynamic_ring_buffer db5 = dynamic_buffer(rb1);
+    (void)db5;
+
+    dynamic_ring_buffer db6 = dynamic_buffer(rb1, 100);
+    (void)db6;
+  }
+  catch (std::exception&)
+  {
+  }
+#endif // defined(ASIO_HAS_RING_BUFFER)
+}
+
+} // namespace ring_buffer_compile
+
+//------------------------------------------------------------------------------
+
+// ring_buffer_runtime test
+// ~~~~~~~~~~~~~~~~~~~~~~~~
+// The following test checks the runtime operation of the ring_buffer and
+// dynamic_ring_buffer classes.
+
+namespace ring_buffer_runtime {
+
+void test_ring_buffer()
+{
+#if defined(ASIO_HAS_RING_BUFFER)
+  using namespace asio;
+
+  ring_buffer rb1;
+  ASIO_CHECK(rb1.size() == 0);
+  ASIO_CHECK(rb1.capacity() == 0);
+  ASIO_CHECK(rb1.data().size() == 0);
+
+  // The capacity is a power of two.
+  ring_buffer rb2(100);
+  std::size_t capacity = rb2.capacity();
+  ASIO_CHECK(capacity >= 100);
+  ASIO_CHECK((capacity & (capacity - 1)) == 0);
+
+  // Bytes that wrap around the end of the region stay contiguous.
+  rb2.grow(capacity - 10);
+  std::memset(rb2.data().data(), 'x', rb2.size());
+  const char* first = static_cast<const char*>(rb2.data().data());
+  rb2.consume(capacity - 20);
+  ASIO_CHECK(rb2.data().data() == first + capacity - 20);
+  ASIO_CHECK(rb2.size() == 10);
+  rb2.grow(30);
+  ASIO_CHECK(rb2.size() == 40);
+  ASIO_CHECK(rb2.capacity() == capacity);
+  char* p = static_cast<char*>(rb2.data().data());
+  for (int i = 0; i < 40; ++i)
+    p[i] = static_cast<char>('a' + i % 26);
+
+  // The second mapping shows the same memory as the first.
+  const char* start = first;
+  ASIO_CHECK(std::memcmp(start, p + 20, 20) == 0);
+
+  // Growing beyond the capacity keeps the contents.
+  rb2.grow(capacity);
+  ASIO_CHECK(rb2.size() == 40 + capacity);
+  ASIO_CHECK(rb2.capacity() > capacity);
+  p = static_cast<char*>(rb2.data().data());
+  for (int i = 0; i < 40; ++i)
+    ASIO_CHECK(p[i] == static_cast<char>('a' + i % 26));
+
+  rb2.shrink(capacity + 35);
+  ASIO_CHECK(rb2.size() == 5);
+  rb2.shrink(100);
+  ASIO_CHECK(rb2.size() == 0);
+
+  rb2.grow(10);
+  rb2.consume(100);
+  ASIO_CHECK(rb2.size() == 0);
+
+  rb2.grow(10);
+  rb2.clear();
+  ASIO_CHECK(rb2.size() == 0);
+  ASIO_CHECK(rb2.capacity() > capacity);
+
+#if defined(ASIO_HAS_MOVE)
+  capacity = rb2.capacity();
+  rb2.grow(3);
+  ring_buffer rb3(std::move(rb2));
+  ASIO_CHECK(rb2.size() == 0);
+  ASIO_CHECK(rb2.capacity() == 0);
+  ASIO_CHECK(rb3.size() == 3);
+  ASIO_CHECK(rb3.capacity() == capacity);
+
+  rb1 = std::move(rb3);
+  ASIO_CHECK(rb3.capacity() == 0);
+  ASIO_CHECK(rb1.size() == 3);
+  ASIO_CHECK(rb1.capacity() == capacity);
+#endif // defined(ASIO_HAS_MOVE)
+#endif // defined(ASIO_HAS_RING_BUFFER)
+}
+
+void test_dynamic_ring_buffer()
+{
+#if defined(ASIO_HAS_RING_BUFFER)
+  using namespace asio;
+
+  ASIO_CHECK(is_dynamic_buffer_v2<dynamic_ring_buffer>::value);
+
+  ring_buffer rb;
+  dynamic_ring_buffer db(rb, 10);
+  ASIO_CHECK(db.size() == 0);
+  ASIO_CHECK(db.max_size() == 10);
+  ASIO_CHECK(db.capacity() == 0);
+
+  db.grow(6);
+  ASIO_CHECK(db.size() == 6);
+  ASIO_CHECK(db.capacity() == 10);
+  ASIO_CHECK(rb.size() == 6);
+  buffer_copy(db.data(0, 6), buffer("abcdef", 6));
+
+  const dynamic_ring_buffer& cdb = db;
+  ASIO_CHECK(cdb.data(2, 100).size() == 4);
+  ASIO_CHECK(std::memcmp(cdb.data(2, 100).data(), "cdef", 4) == 0);
+  ASIO_CHECK(db.data(100, 1).size() == 0);
+
+  bool threw = false;
+  try
+  {
+    db.grow(5);
+  }
+  catch (std::length_error&)
+  {
+    threw = true;
+  }
+  ASIO_CHECK(threw);
+  ASIO_CHECK(db.size() == 6);
+
+  db.consume(2);
+  ASIO_CHECK(db.size() == 4);
+  ASIO_CHECK(std::memcmp(db.data(0, 4).data(), "cdef", 4) == 0);
+
+  db.shrink(1);
+  ASIO_CHECK(db.size() == 3);
+  ASIO_CHECK(std::memcmp(db.data(0, 3).data(), "cde", 3) == 0);
+#endif // defined(ASIO_HAS_RING_BUFFER)
+}
+
+void test_read_until()
+{
+#if defined(ASIO_HAS_RING_BUFFER) && defined(ASIO_HAS_LOCAL_SOCKETS)
+  using namespace asio;
+
+  io_context ioc;
+  local::stream_protocol::socket s1(ioc);
+  local::stream_protocol::socket s2(ioc);
+  local::connect_pair(s1, s2);
+
+  // Read enough lines to wrap around the region several times.
+  ring_buffer rb(1);
+  std::size_t capacity = rb.capacity();
+  std::string line(capacity / 3 - 1, 'x');
+  line += '\n';
+
+  for (int i = 0; i < 10; ++i)
+  {
+    line[0] = static_cast<char>('0' + i);
+    write(s1, buffer(line));
+
+    asio::error_code ec;
+    std::size_t n = read_until(s2, dynamic_buffer(rb), '\n', ec);
+    ASIO_CHECK(!ec);
+    ASIO_CHECK(n == line.size());
+    ASIO_CHECK(rb.size() >= n);
+    ASIO_CHECK(std::memcmp(rb.data().data(), line.data(), n) == 0);
+    rb.consume(n);
+  }
+
+  ASIO_CHECK(rb.capacity() == capacity);
+#endif // defined(ASIO_HAS_RING_BUFFER) && defined(ASIO_HAS_LOCAL_SOCKETS)
+}
+
+} // namespace ring_buffer_runtime
+
+//------------------------------------------------------------------------------
+
+ASIO_TEST_SUITE
+(
+  "ring_buffer",
+  ASIO_COMPILE_TEST_CASE(ring_buffer_compile::test)
+  ASIO_TEST_CASE(ring_buffer_runtime::test_ring_buffer)
+  ASIO_TEST_CASE(ring_buffer_runtime::test_dynamic_ring_buffer)
+  ASIO_TEST_CASE(ring_buffer_runtime::test_read_until)
+)
@@ -0,0 +1,357 @@
+//
+// shared_buffer.cpp
+// ~~~~~~~~~~~~~~~~~
+//
+// Copyright (c) 2003-2022 Christopher M. Kohlhoff (chris at kohlhoff dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+
+// Disable autolinking for unit tests.
+#if !defined(BOOST_ALL_NO_LIB)
+#define BOOST_ALL_NO_LIB 1
+#endif // !defined(BOOST_ALL_NO_LIB)
+
+// Test that header file is self-contained.
+#include "asio/shared_buffer.hpp"
+
+#include <cstring>
+#include <string>
+#include <vector>
+#include "asio/buffers_iterator.hpp"
+#include "asio/io_context.hpp"
+#include "asio/local/connect_pair.hpp"
+#include "asio/local/stream_protocol.hpp"
+#include "asio/post.hpp"
+#include "asio/read.hpp"
+#include "asio/write.hpp"
+#include "unit_test.hpp"
+
+#if defined(ASIO_HAS_BOOST_BIND)
+# include <boost/bind/bind.hpp>
+#else // defined(ASIO_HAS_BOOST_BIND)
+# include <functional>
+#endif // defined(ASIO_HAS_BOOST_BIND)
+
+//------------------------------------------------------------------------------
+
+// shared_buffer_compile test
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~
+// The following test checks that all public member functions on the classes
+// shared_buffer and shared_buffer_chain compile and link correctly. Runtime
+// failures are ignored.
+
+namespace shared_buffer_compile {
+
+using namespace asio;
+
+void test()
+{
+  try
+  {
+    char raw_data[1024] = "";
+    const std::string string_data("abc");
+
+    // shared_buffer constructors.
+
+    shared_buffer b1;
+    shared_buffer b2(10);
+    shared_buffer b3(raw_data, sizeof(raw_data));
+    shared_buffer b4(buffer(string_data));
+    shared_buffer b5(b4);
+
+#if defined(ASIO_HAS_MOVE)
+    shared_buffer b6(std::move(b5));
+#endif // defined(ASIO_HAS_MOVE)
+
+    // shared_buffer operators.
+
+    b1 = b2;
+
+#if defined(ASIO_HAS_MOVE)
+    b1 = std::move(b3);
+#endif // defined(ASIO_HAS_MOVE)
+
+    const_buffer cb1 = b1;
+    (void)cb1;
+
+    // shared_buffer functions.
+
+    shared_buffer::const_iterator i1 = b1.begin();
+    (void)i1;
+    shared_buffer::const_iterator i2 = b1.end();
+    (void)i2;
+
+    const_buffer cb2 = b1.data();
+    (void)cb2;
+
+    mutable_buffer mb1 = b1.mutable_data();
+    (void)mb1;
+
+    std::size_t s1 = b1.size();
+    (void)s1;
+
+    long l1 = b1.use_count();
+    (void)l1;
+
+    // shared_buffer_chain constructors.
+
+    shared_buffer_chain c1;
+    shared_buffer_chain c2(b1);
+    shared_buffer_chain c3(c2);
+
+    // shared_buffer_chain operators.
+
+    c1 = c2;
+
+    // shared_buffer_chain functions.
+
+    c1.push_back(b1);
+    c1.push_back(shared_buffer(10));
+    c1.reserve(10);
+
+    shared_buffer_chain::const_iterator i3 = c1.begin();
+    (void)i3;
+    shared_buffer_chain::const_iterator i4 = c1.end();
+    (void)i4;
+
+    std::size_t s2 = c1.count();
+    (void)s2;
+
+    bool e1 = c1.empty();
+    (void)e1;
+
+    std::size_t s3 = c1.size();
+    (void)s3;
+
+    c1.clear();
+
+    // Free functions.
+
+    std::size_t s4 = buffer_size(b1);
+    (void)s4;
+
+    std::size_t s5 = buffer_size(c1);
+    (void)s5;
+
+    std::size_t s6 = buffer_copy(buffer(raw_data), b1);
+    (void)s6;
+
+    std::size_t s7 = buffer_copy(buffer(raw_data), c1);
+    (void)s7;
+
+    shared_buffer b7(c1);
+    (void)b7;
+  }
+  catch (std::exception&)
+  {
+  }
+}
+
+} // namespace shared_buffer_compile
+
+//------------------------------------------------------------------------------
+
+// shared_buffer_runtime test
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~
+// The following test checks the runtime operation of the shared_buffer and
+// shared_buffer_chain classes.
+
+namespace shared_buffer_runtime {
+
+using namespace asio;
+
+#if defined(ASIO_HAS_BOOST_BIND)
+namespace bindns = boost;
+#else // defined(ASIO_HAS_BOOST_BIND)
+namespace bindns = std;
+#endif // defined(ASIO_HAS_BOOST_BIND)
+
+void test_shared_buffer()
+{
+  const char data[] = "0123456789abcdefghijklmnopqrstuv";
+  const std::size_t data_size = sizeof(data) - 1;
+
+  ASIO_CHECK(is_const_buffer_sequence<shared_buffer>::value);
+  ASIO_CHECK(!is_mutable_buffer_sequence<shared_buffer>::value);
+
+  shared_buffer b1;
+  ASIO_CHECK(b1.size() == 0);
+  ASIO_CHECK(b1.use_count() == 0);
+  ASIO_CHECK(buffer_size(b1) == 0);
+
+  shared_buffer b2(data, data_size);
+  ASIO_CHECK(b2.size() == data_size);
+  ASIO_CHECK(b2.use_count() == 1);
+  ASIO_CHECK(b2.data().data() != data);
+  ASIO_CHECK(std::memcmp(b2.data().data(), data, data_size) == 0);
+  ASIO_CHECK(b2.end() - b2.begin() == 1);
+
+  // Copies share the same memory.
+  shared_buffer b3(b2);
+  ASIO_CHECK(b3.data().data() == b2.data().data());
+  ASIO_CHECK(b2.use_count() == 2);
+  ASIO_CHECK(b3.use_count() == 2);
+
+  b1 = b3;
+  ASIO_CHECK(b2.use_count() == 3);
+
+  b1 = b1;
+  ASIO_CHECK(b2.use_count() == 3);
+
+  b1 = shared_buffer();
+  ASIO_CHECK(b1.size() == 0);
+  ASIO_CHECK(b2.use_count() == 2);
+
+#if defined(ASIO_HAS_MOVE)
+  shared_buffer b4(std::move(b3));
+  ASIO_CHECK(b3.size() == 0);
+  ASIO_CHECK(b3.use_count() == 0);
+  ASIO_CHECK(b4.use_count() == 2);
+
+  b1 = std::move(b4);
+  ASIO_CHECK(b4.use_count() == 0);
+  ASIO_CHECK(b1.use_count() == 2);
+  ASIO_CHECK(b1.data().data() == b2.data().data());
+#endif // defined(ASIO_HAS_MOVE)
+
+  // A buffer may be filled after it is created.
+  shared_buffer b5(4);
+  std::memcpy(b5.mutable_data().data(), "wxyz", 4);
+  ASIO_CHECK(std::memcmp(b5.data().data(), "wxyz", 4) == 0);
+
+  // A buffer may be created from any buffer sequence.
+  std::vector<const_buffer> seq;
+  seq.push_back(buffer(data, 4));
+  seq.push_back(buffer(data + 10, 6));
+  shared_buffer b6(seq);
+  ASIO_CHECK(b6.size() == 10);
+  ASIO_CHECK(std::memcmp(b6.data().data(), "0123abcdef", 10) == 0);
+
+  // Buffers too large for the recycling allocator's cache are supported.
+  shared_buffer b7(100000);
+  ASIO_CHECK(b7.size() == 100000);
+  b7 = shared_buffer(1);
+  ASIO_CHECK(b7.size() == 1);
+}
+
+void check_recycling(bool* reused)
+{
+  const void* p = 0;
+  {
+    shared_buffer b(64);
+    p = b.data().data();
+  }
+  shared_buffer b(64);
+  *reused = (b.data().data() == p);
+}
+
+void test_recycling()
+{
+  // Memory released on a thread running an io_context is reused by the next
+  // buffer created on that thread.
+  io_context ioc;
+  bool reused = false;
+  asio::post(ioc, bindns::bind(check_recycling, &reused));
+  ioc.run();
+  ASIO_CHECK(reused);
+}
+
+void test_shared_buffer_chain()
+{
+  ASIO_CHECK(is_const_buffer_sequence<shared_buffer_chain>::value);
+  ASIO_CHECK(!is_mutable_buffer_sequence<shared_buffer_chain>::value);
+
+  shared_buffer header("head:", 5);
+  shared_buffer body("body", 4);
+
+  shared_buffer_chain c1;
+  ASIO_CHECK(c1.empty());
+  ASIO_CHECK(c1.count() == 0);
+  ASIO_CHECK(c1.size() == 0);
+  ASIO_CHECK(buffer_size(c1) == 0);
+
+  c1.push_back(header);
+  c1.push_back(body);
+  ASIO_CHECK(!c1.empty());
+  ASIO_CHECK(c1.count() == 2);
+  ASIO_CHECK(c1.size() == 9);
+  ASIO_CHECK(buffer_size(c1) == 9);
+  ASIO_CHECK(header.use_count() == 2);
+
+  // Copying a chain copies only the references.
+  shared_buffer_chain c2(c1);
+  ASIO_CHECK(header.use_count() == 3);
+  ASIO_CHECK(body.use_count() == 3);
+
+  char out[16] = "";
+  ASIO_CHECK(buffer_copy(buffer(out), c2) == 9);
+  ASIO_CHECK(std::memcmp(out, "head:body", 9) == 0);
+
+  std::string s(buffers_begin(c2), buffers_end(c2));
+  ASIO_CHECK(s == "head:body");
+
+  c2.clear();
+  ASIO_CHECK(c2.empty());
+  ASIO_CHECK(header.use_count() == 2);
+}
+
+void handle_write(const asio::error_code& err, std::size_t n,
+    asio::error_code* out_err, std::size_t* total)
+{
+  if (err)
+    *out_err = err;
+  *total += n;
+}
+
+void test_write()
+{
+#if defined(ASIO_HAS_LOCAL_SOCKETS)
+  using bindns::placeholders::_1;
+  using bindns::placeholders::_2;
+
+  io_context ioc;
+  local::stream_protocol::socket s1(ioc);
+  local::stream_protocol::socket s2(ioc);
+  local::connect_pair(s1, s2);
+
+  shared_buffer header("head:", 5);
+  shared_buffer_chain message(header);
+  message.push_back(shared_buffer("body", 4));
+
+  // Each operation keeps the message alive until it completes.
+  asio::error_code write_err;
+  std::size_t bytes_written = 0;
+  for (int i = 0; i < 3; ++i)
+  {
+    asio::async_write(s1, message, bindns::bind(handle_write,
+          _1, _2, &write_err, &bytes_written));
+  }
+  message.clear();
+  ASIO_CHECK(header.use_count() > 1);
+
+  ioc.run();
+  ASIO_CHECK(!write_err);
+  ASIO_CHECK(bytes_written == 27);
+  ASIO_CHECK(header.use_count() == 1);
+
+  char in[27] = "";
+  asio::read(s2, buffer(in));
+  ASIO_CHECK(std::memcmp(in, "head:bodyhead:bodyhead:body", 27) == 0);
+#endif // defined(ASIO_HAS_LOCAL_SOCKETS)
+}
+
+} // namespace shared_buffer_runtime
+
+//------------------------------------------------------------------------------
+
+ASIO_TEST_SUITE
+(
+  "shared_buffer",
+  ASIO_COMPILE_TEST_CASE(shared_buffer_compile::test)
+  ASIO_TEST_CASE(shared_buffer_runtime::test_shared_buffer)
+  ASIO_TEST_CASE(shared_buffer_runtime::test_recycling)
+  ASIO_TEST_CASE(shared_buffer_runtime::test_shared_buffer_chain)
+  ASIO_TEST_CASE(shared_buffer_runtime::test_write)
+)
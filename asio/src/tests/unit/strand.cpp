@@ -18,6 +18,7 @@
 
 #include <sstream>
 #include "asio/executor.hpp"
+#include "asio/executor_work_guard.hpp"
 #include "asio/io_context.hpp"
 #include "asio/dispatch.hpp"
 #include "asio/post.hpp"
@@ -466,10 +467,201 @@ void strand_execute_test()
   ASIO_CHECK(count == 1);
 }
 
+struct ordering_state
+{
+  int in_strand;
+  int next_value[4];
+  int count;
+  bool ok;
+};
+
+void check_ordering(ordering_state* state, int producer, int value)
+{
+  if (++state->in_strand != 1)
+    state->ok = false;
+  if (state->next_value[producer] != value)
+    state->ok = false;
+  state->next_value[producer] = value + 1;
+  ++state->count;
+  --state->in_strand;
+}
+
+void post_ordered(strand<io_context::executor_type>* s,
+    ordering_state* state, int producer, int n)
+{
+  for (int i = 0; i < n; ++i)
+    post(*s, bindns::bind(check_ordering, state, producer, i));
+}
+
+void strand_ordering_test()
+{
+  const int num_producers = 4;
+  const int num_handlers = 20000;
+
+  io_context ioc;
+  strand<io_context::executor_type> s = make_strand(ioc);
+  ordering_state state = { 0, { 0, 0, 0, 0 }, 0, true };
+
+  executor_work_guard<io_context::executor_type> work
+    = make_work_guard(ioc);
+  thread run_thread1(bindns::bind(io_context_run, &ioc));
+  thread run_thread2(bindns::bind(io_context_run, &ioc));
+
+  // Handlers posted concurrently from several threads must run one at a time,
+  // and in the order in which each thread posted them.
+  thread producer1(bindns::bind(post_ordered, &s, &state, 0, num_handlers));
+  thread producer2(bindns::bind(post_ordered, &s, &state, 1, num_handlers));
+  thread producer3(bindns::bind(post_ordered, &s, &state, 2, num_handlers));
+  post_ordered(&s, &state, 3, num_handlers);
+
+  producer1.join();
+  producer2.join();
+  producer3.join();
+  work.reset();
+  run_thread1.join();
+  run_thread2.join();
+
+  ASIO_CHECK(state.ok);
+  ASIO_CHECK(state.count == num_producers * num_handlers);
+}
+
+void strand_batch_budget_test()
+{
+  io_context ioc;
+  strand<io_context::executor_type> s = make_strand(ioc);
+  int count = 0;
+
+  ASIO_CHECK(s.batch_budget() == 0);
+  s.set_batch_budget(3);
+  ASIO_CHECK(s.batch_budget() == 3);
+
+  for (int i = 0; i < 10; ++i)
+    post(s, bindns::bind(increment, &count));
+
+  ioc.run();
+
+  // The first handler acquires the strand and runs alone. The remaining nine
+  // are run three at a time, with the strand yielding twice in between.
+  strand<io_context::executor_type>::statistics stats = s.get_statistics();
+  ASIO_CHECK(count == 10);
+  ASIO_CHECK(stats.handlers_executed == 10);
+  ASIO_CHECK(stats.batches == 4);
+  ASIO_CHECK(stats.budget_yields == 2);
+}
+
+// An executor that counts the number of functions submitted to it, and how
+// many of those were submitted as continuations.
+class recording_executor
+{
+public:
+  recording_executor(io_context::executor_type ex,
+      int* executions, int* continuations, bool continuation = false)
+    : ex_(ex),
+      executions_(executions),
+      continuations_(continuations),
+      continuation_(continuation)
+  {
+  }
+
+  io_context& query(execution::context_t) const ASIO_NOEXCEPT
+  {
+    return ex_.context();
+  }
+
+  recording_executor require(execution::blocking_t::never_t) const
+  {
+    return *this;
+  }
+
+  recording_executor prefer(execution::relationship_t::continuation_t) const
+  {
+    return recording_executor(ex_, executions_, continuations_, true);
+  }
+
+  template <typename Function>
+  void execute(ASIO_MOVE_ARG(Function) f) const
+  {
+    ++*executions_;
+    if (continuation_)
+      ++*continuations_;
+    execution::execute(ex_, ASIO_MOVE_CAST(Function)(f));
+  }
+
+  friend bool operator==(const recording_executor& a,
+      const recording_executor& b) ASIO_NOEXCEPT
+  {
+    return a.ex_ == b.ex_ && a.continuation_ == b.continuation_;
+  }
+
+  friend bool operator!=(const recording_executor& a,
+      const recording_executor& b) ASIO_NOEXCEPT
+  {
+    return !(a == b);
+  }
+
+private:
+  io_context::executor_type ex_;
+  int* executions_;
+  int* continuations_;
+  bool continuation_;
+};
+
+void strand_sticky_test()
+{
+  io_context ioc;
+  int count = 0;
+
+  // Without stickiness, the strand is rescheduled as an unrelated function.
+  int executions = 0;
+  int continuations = 0;
+  strand<recording_executor> s1(
+      recording_executor(ioc.get_executor(), &executions, &continuations));
+  ASIO_CHECK(!s1.sticky());
+  s1.set_batch_budget(1);
+
+  for (int i = 0; i < 5; ++i)
+    post(s1, bindns::bind(increment, &count));
+
+  ioc.run();
+
+  ASIO_CHECK(count == 5);
+  ASIO_CHECK(executions == 5);
+  ASIO_CHECK(continuations == 0);
+
+  // A sticky strand is first scheduled normally, and then rescheduled after
+  // each batch as a continuation of the thread that ran it.
+  executions = 0;
+  continuations = 0;
+  strand<recording_executor> s2(
+      recording_executor(ioc.get_executor(), &executions, &continuations));
+  s2.set_sticky(true);
+  ASIO_CHECK(s2.sticky());
+  s2.set_batch_budget(1);
+
+  for (int i = 0; i < 5; ++i)
+    post(s2, bindns::bind(increment, &count));
+
+  ioc.restart();
+  ioc.run();
+
+  ASIO_CHECK(count == 10);
+  ASIO_CHECK(executions == 5);
+  ASIO_CHECK(continuations == 4);
+
+  strand<recording_executor>::statistics stats = s2.get_statistics();
+  ASIO_CHECK(stats.handlers_executed == 5);
+  ASIO_CHECK(stats.batches == 5);
+  ASIO_CHECK(stats.same_thread_resumptions == 4);
+  ASIO_CHECK(stats.thread_migrations == 0);
+}
+
 ASIO_TEST_SUITE
 (
   "strand",
   ASIO_TEST_CASE(strand_test)
+  ASIO_TEST_CASE(strand_ordering_test)
+  ASIO_TEST_CASE(strand_batch_budget_test)
+  ASIO_TEST_CASE(strand_sticky_test)
   ASIO_COMPILE_TEST_CASE(strand_conversion_test)
   ASIO_TEST_CASE(strand_query_test)
   ASIO_TEST_CASE(strand_execute_test)
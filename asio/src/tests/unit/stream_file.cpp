@@ -16,10 +16,20 @@
 // Test that header file is self-contained.
 #include "asio/stream_file.hpp"
 
+#include <cstdio>
+#include <cstring>
 #include "archetypes/async_result.hpp"
 #include "asio/io_context.hpp"
+#include "asio/read.hpp"
+#include "asio/write.hpp"
 #include "unit_test.hpp"
 
+#if defined(ASIO_HAS_BOOST_BIND)
+# include <boost/bind/bind.hpp>
+#else // defined(ASIO_HAS_BOOST_BIND)
+# include <functional>
+#endif // defined(ASIO_HAS_BOOST_BIND)
+
 // stream_file_compile test
 // ~~~~~~~~~~~~~~~~~~~~~~~~
 // The following test checks that all public member functions on the class
@@ -27,6 +37,28 @@
 
 namespace stream_file_compile {
 
+struct wait_handler
+{
+  wait_handler() {}
+  void operator()(const asio::error_code&) {}
+#if defined(ASIO_HAS_MOVE)
+  wait_handler(wait_handler&&) {}
+private:
+  wait_handler(const wait_handler&);
+#endif // defined(ASIO_HAS_MOVE)
+};
+
+struct size_handler
+{
+  size_handler() {}
+  void operator()(const asio::error_code&, asio::uint64_t) {}
+#if defined(ASIO_HAS_MOVE)
+  size_handler(size_handler&&) {}
+private:
+  size_handler(const size_handler&);
+#endif // defined(ASIO_HAS_MOVE)
+};
+
 struct write_some_handler
 {
   write_some_handler() {}
@@ -142,6 +174,37 @@ void test()
     file1.sync_data();
     file1.sync_data(ec);
 
+    file1.allocate(0, 0);
+    file1.allocate(0, 0, ec);
+
+    file1.async_open(path, stream_file::read_only, wait_handler());
+    int i4 = file1.async_open(path, stream_file::read_only, lazy);
+    (void)i4;
+
+    file1.async_close(wait_handler());
+    int i5 = file1.async_close(lazy);
+    (void)i5;
+
+    file1.async_size(size_handler());
+    int i6 = file1.async_size(lazy);
+    (void)i6;
+
+    file1.async_resize(0, wait_handler());
+    int i7 = file1.async_resize(0, lazy);
+    (void)i7;
+
+    file1.async_allocate(0, 0, wait_handler());
+    int i8 = file1.async_allocate(0, 0, lazy);
+    (void)i8;
+
+    file1.async_sync_all(wait_handler());
+    int i9 = file1.async_sync_all(lazy);
+    (void)i9;
+
+    file1.async_sync_data(wait_handler());
+    int i10 = file1.async_sync_data(lazy);
+    (void)i10;
+
     asio::uint64_t s3 = file1.seek(0, stream_file::seek_set);
     (void)s3;
     asio::uint64_t s4 = file1.seek(0, stream_file::seek_set, ec);
@@ -174,8 +237,94 @@ void test()
 
 } // namespace stream_file_compile
 
+//------------------------------------------------------------------------------
+
+// stream_file_runtime test
+// ~~~~~~~~~~~~~~~~~~~~~~~~
+// The following test checks the runtime operation of the stream_file class.
+
+namespace stream_file_runtime {
+
+void handle_transfer(const asio::error_code& err, std::size_t n,
+    asio::error_code* out_err, std::size_t* out_n)
+{
+  *out_err = err;
+  *out_n = n;
+}
+
+void test()
+{
+#if defined(ASIO_HAS_FILE)
+  using namespace asio;
+
+#if defined(ASIO_HAS_BOOST_BIND)
+  namespace bindns = boost;
+#else // defined(ASIO_HAS_BOOST_BIND)
+  namespace bindns = std;
+#endif // defined(ASIO_HAS_BOOST_BIND)
+  using bindns::placeholders::_1;
+  using bindns::placeholders::_2;
+
+  const char* path = "stream_file_runtime.tmp";
+  const char data[] = "0123456789abcdefghijklmnopqrstuv";
+  const std::size_t data_size = sizeof(data) - 1;
+
+  io_context ioc;
+  stream_file file(ioc, path, stream_file::read_write
+      | stream_file::create | stream_file::truncate);
+  asio::error_code err;
+  std::size_t n = 0;
+
+  // Each write continues from the position at which the last one finished.
+  async_write(file, buffer(data, data_size / 2),
+      bindns::bind(handle_transfer, _1, _2, &err, &n));
+  ioc.run();
+  ASIO_CHECK(!err);
+  ASIO_CHECK(n == data_size / 2);
+
+  ioc.restart();
+  async_write(file, buffer(data + data_size / 2, data_size - data_size / 2),
+      bindns::bind(handle_transfer, _1, _2, &err, &n));
+  ioc.run();
+  ASIO_CHECK(!err);
+  ASIO_CHECK(n == data_size - data_size / 2);
+  ASIO_CHECK(file.size() == data_size);
+
+  // Reads advance the position in the same way.
+  ASIO_CHECK(file.seek(0, stream_file::seek_set) == 0);
+  char read_data[sizeof(data)] = "";
+  ioc.restart();
+  async_read(file, buffer(read_data, 10),
+      bindns::bind(handle_transfer, _1, _2, &err, &n));
+  ioc.run();
+  ASIO_CHECK(!err);
+  ASIO_CHECK(n == 10);
+
+  ioc.restart();
+  async_read(file, buffer(read_data + 10, data_size - 10),
+      bindns::bind(handle_transfer, _1, _2, &err, &n));
+  ioc.run();
+  ASIO_CHECK(!err);
+  ASIO_CHECK(n == data_size - 10);
+  ASIO_CHECK(std::memcmp(read_data, data, data_size) == 0);
+
+  ioc.restart();
+  file.async_read_some(buffer(read_data),
+      bindns::bind(handle_transfer, _1, _2, &err, &n));
+  ioc.run();
+  ASIO_CHECK(err == asio::error::eof);
+  ASIO_CHECK(n == 0);
+
+  file.close();
+  std::remove(path);
+#endif // defined(ASIO_HAS_FILE)
+}
+
+} // namespace stream_file_runtime
+
 ASIO_TEST_SUITE
 (
   "stream_file",
   ASIO_COMPILE_TEST_CASE(stream_file_compile::test)
+  ASIO_TEST_CASE(stream_file_runtime::test)
 )